@@ -12,10 +12,11 @@
  *
  * How it works?
  *
- * It uses NodeJS packages to inline, minify and GZIP files. See writeHtmlGzipped and writeChunks invocations at the bottom of the page.
+ * It uses NodeJS packages to inline, minify and GZIP files. See writeHtmlGzipped, writeModulesGzipped and writeChunks invocations at the bottom of the page.
  */
 
 const fs = require("fs");
+const crypto = require("crypto");
 const packageJson = require("../package.json");
 
 /**
@@ -86,6 +87,7 @@ function writeHtmlGzipped(sourceFile, resultFile) {
 
       console.info("Compressed " + result.length + " bytes");
       const array = hexdump(result);
+      const etag = crypto.createHash("sha1").update(result).digest("hex").substring(0, 8);
       const src = `/*
  * Binary array for the Web UI.
  * gzip is used for smaller size and improved speeds.
@@ -96,6 +98,7 @@ function writeHtmlGzipped(sourceFile, resultFile) {
  
 // Autogenerated from ${sourceFile}, do not edit!!
 const uint16_t PAGE_index_L = ${result.length};
+#define PAGE_index_ETAG "${etag}"
 const uint8_t PAGE_index[] PROGMEM = {
 ${array}
 };
@@ -106,7 +109,84 @@ ${array}
   });
 }
 
+/**
+ * Gradient palette previews for the palette list of the UI, parsed from the PROGMEM arrays in palettes.h.
+ * Palettes 0-12 are built into FastLED or depend on the segment colors and are still served by /json/palx.
+ */
+function writePalettesGzipped(sourceFile, resultFile) {
+  console.info("Reading " + sourceFile);
+  const src = fs.readFileSync(sourceFile, "utf-8").replace(/\/\*[\s\S]*?\*\//g, "").replace(/\/\/.*$/gm, "");
+  const gradients = {};
+  for (const m of src.matchAll(/const\s+byte\s+(\w+)\[\]\s+PROGMEM\s*=\s*\{([^}]*)\}/g)) {
+    gradients[m[1]] = m[2].match(/\d+/g).map(Number);
+  }
+  const list = src.match(/gGradientPalettes\[\]\s+PROGMEM\s*=\s*\{([^}]*)\}/)[1].match(/\w+/g);
+  const palettes = {};
+  list.forEach((name, i) => {
+    const bytes = gradients[name];
+    if (!bytes) throw new Error("Unknown palette " + name);
+    const entries = [];
+    for (let j = 0; j + 3 < bytes.length; j += 4) {
+      entries.push(bytes.slice(j, j + 4));
+      if (bytes[j] == 255) break;
+    }
+    palettes[13 + i] = entries;
+  });
+  const json = JSON.stringify({ p: palettes });
+  console.info("Generated " + list.length + " palettes, " + json.length + " characters");
+
+  const result = zlib.gzipSync(json, { level: zlib.constants.Z_BEST_COMPRESSION });
+  console.info("Compressed " + result.length + " bytes");
+  const etag = crypto.createHash("sha1").update(result).digest("hex").substring(0, 8);
+  fs.writeFileSync(resultFile, `/*
+ * Binary array for the palette previews of the Web UI (/palettes.json).
+ * gzip is used for smaller size and improved speeds.
+ */
+
+// Autogenerated from ${sourceFile}, do not edit!!
+const uint16_t PAGE_palettes_L = ${result.length};
+#define PAGE_palettes_ETAG "${etag}"
+const uint8_t PAGE_palettes[] PROGMEM = {
+${hexdump(result)}
+};
+`);
+  console.info("Writing " + resultFile);
+}
+
+/**
+ * Parts of the UI loaded on first use by loadMod() in index.js, each minified and gzipped on its own.
+ * The page itself only has the core, so the first load transfers less.
+ */
+function writeModulesGzipped(srcDir, modules, resultFile) {
+  let src = `/*
+ * Binary arrays for the modules of the Web UI (/index_<m>.js).
+ * gzip is used for smaller size and improved speeds.
+ */
+`;
+  modules.forEach((m) => {
+    const file = srcDir + "/index_" + m + ".js";
+    console.info("Reading " + file);
+    const js = adoptVersionAndRepo(fs.readFileSync(file, "utf-8"));
+    const min = Terser.minify(js);
+    if (min.error) throw min.error;
+    const result = zlib.gzipSync(min.code, { level: zlib.constants.Z_BEST_COMPRESSION });
+    console.info("Compressed " + js.length + " characters to " + result.length + " bytes");
+    const etag = crypto.createHash("sha1").update(result).digest("hex").substring(0, 8);
+    src += `
+// Autogenerated from ${file}, do not edit!!
+const uint16_t PAGE_index_${m}_L = ${result.length};
+#define PAGE_index_${m}_ETAG "${etag}"
+const uint8_t PAGE_index_${m}[] PROGMEM = {
+${hexdump(result)}
+};
+`;
+  });
+  console.info("Writing " + resultFile);
+  fs.writeFileSync(resultFile, src);
+}
+
 const CleanCSS = require("clean-css");
+const Terser = require("terser");
 const MinifyHTML = require("html-minifier-terser").minify;
 
 function filter(str, type) {
@@ -195,6 +275,8 @@ function writeChunks(srcDir, specs, resultFile) {
 }
 
 writeHtmlGzipped("wled00/data/index.htm", "wled00/html_ui.h");
+writePalettesGzipped("wled00/palettes.h", "wled00/html_palettes.h");
+writeModulesGzipped("wled00/data", ["pe", "pp", "se"], "wled00/html_uimod.h");
 
 writeChunks(
   "wled00/data",
@@ -0,0 +1,77 @@
+#!/usr/bin/env python3
+# Realtime latency benchmark: streams DDP or E1.31 frames to a WLED device at the given rates and prints the
+# per-stage frame latency the device measured (first packet received -> show() -> busses done sending), in us.
+# Append the output of several firmware builds to one CSV file to compare them:
+#   python3 latency_test.py 192.168.1.50 --proto ddp --rates 30,60,120 --leds 300 >> latency.csv
+# For E1.31 the device must listen to --universe and the following ones, with as many LEDs as --leds.
+import argparse, json, socket, struct, sys, time, urllib.request
+
+STAGES = ("queue", "show", "latch", "total")
+
+def http_json(host, path, body=None):
+    data = json.dumps(body).encode() if body is not None else None
+    req = urllib.request.Request("http://%s%s" % (host, path), data=data, headers={"Content-Type": "application/json"})
+    with urllib.request.urlopen(req, timeout=5) as r:
+        return json.load(r)
+
+def ddp_packets(frame, seq):
+    # DDP: flags (version 1, push on the last packet), sequence, type, id, offset, length
+    out, chunk = [], 1440
+    for off in range(0, len(frame), chunk):
+        data = frame[off:off + chunk]
+        flags = 0x40 | (0x01 if off + chunk >= len(frame) else 0)
+        out.append((struct.pack(">BBBBIH", flags, seq & 0x0F, 0x0B, 1, off, len(data)) + data, 4048))
+    return out
+
+def e131_packets(frame, seq, universe):
+    # one universe of 170 RGB pixels per packet: root, framing and DMP layer, then the start code and the channels
+    out, chunk = [], 510
+    for n, off in enumerate(range(0, len(frame), chunk)):
+        data = frame[off:off + chunk]
+        size = 126 + len(data)
+        root = struct.pack(">HH12sHI16s", 0x0010, 0, b"ASC-E1.17\0\0\0", 0x7000 | (size - 16), 4, b"WLEDlatencytest!")
+        framing = struct.pack(">HI64sBHBBH", 0x7000 | (size - 38), 2, b"latency_test", 100, 0, seq & 0xFF, 0, universe + n)
+        dmp = struct.pack(">HBBHHHB", 0x7000 | (size - 115), 0x02, 0xA1, 0, 1, len(data) + 1, 0) + data
+        out.append((root + framing + dmp, 5568))
+    return out
+
+def run(host, proto, rate, leds, seconds, universe):
+    http_json(host, "/json/state", {"lat": True})
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    interval, start, seq, sent = 1.0 / rate, time.monotonic(), 1, 0
+    while time.monotonic() - start < seconds:
+        v = (seq * 7) & 0xFF  # changes every frame, so every frame is shown
+        frame = bytes([v, 255 - v, v >> 1]) * leds
+        packets = ddp_packets(frame, seq) if proto == "ddp" else e131_packets(frame, seq, universe)
+        for pkt, port in packets:
+            sock.sendto(pkt, (host, port))
+        seq, sent = seq + 1, sent + 1
+        time.sleep(max(0, start + sent * interval - time.monotonic()))
+    time.sleep(0.5)
+    return sent, http_json(host, "/json/perf").get("lat")
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__)
+    ap.add_argument("host")
+    ap.add_argument("--proto", choices=("ddp", "e131"), default="ddp")
+    ap.add_argument("--rates", default="30,60,120", help="frames per second, comma separated")
+    ap.add_argument("--leds", type=int, default=300)
+    ap.add_argument("--seconds", type=float, default=10)
+    ap.add_argument("--universe", type=int, default=1, help="first E1.31 universe")
+    ap.add_argument("--header", action="store_true", help="print the CSV header")
+    args = ap.parse_args()
+
+    info = http_json(args.host, "/json/info")
+    build = "%s-%s" % (info.get("ver"), info.get("vid"))
+    if args.header:
+        print("build,proto,rate,leds,sent,frames," + ",".join("%s_%s" % (s, k) for s in STAGES for k in ("min", "avg", "max")))
+    for rate in (int(r) for r in args.rates.split(",")):
+        sent, lat = run(args.host, args.proto, rate, args.leds, args.seconds, args.universe)
+        if not lat:
+            print("%s: no frames measured at %d fps" % (args.host, rate), file=sys.stderr)
+            continue
+        cols = [str(lat[s][k]) for s in STAGES for k in ("min", "avg", "max")]
+        print(",".join([build, args.proto, str(rate), str(args.leds), str(sent), str(lat["total"]["n"])] + cols))
+
+if __name__ == "__main__":
+    main()
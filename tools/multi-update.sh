@@ -1,4 +1,6 @@
 #!/bin/bash
+# Builds with WLED_ENABLE_FLEET_OTA (ESP32) can instead update one node with this script and let it update the rest
+# of its instance list, two at a time: curl "http://<node>/fleet?start=1&wave=2", progress: curl http://<node>/fleet
 FWPATH=/path/to/your/WLED/build_output/firmware
 
 update_one() {
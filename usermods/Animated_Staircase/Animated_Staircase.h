@@ -10,6 +10,20 @@
 #pragma once
 #include "wled.h"
 
+// Echo pulse of an ultrasonic sensor, timestamped by the pin change interrupt
+typedef struct EchoCapture {
+  int8_t pin;
+  volatile unsigned long rise;   // micros() of the rising edge, 0 = waiting for it
+  volatile unsigned long width;  // pulse length in us, 0 = no complete pulse yet
+} EchoCapture;
+
+static void IRAM_ATTR echoChange(void* arg) {
+  EchoCapture* e = (EchoCapture*)arg;
+  unsigned long now = micros();
+  if (digitalRead(e->pin)) e->rise = now | 1;  // never 0
+  else if (e->rise && !e->width) e->width = MAX(1UL, now - e->rise);
+}
+
 class Animated_Staircase : public Usermod {
   private:
 
@@ -53,6 +67,15 @@ class Animated_Staircase : public Usermod {
     // Time of the last sensor check
     unsigned long lastScanTime = 0;
 
+    // Ultrasonic sensors are pinged alternately every scanDelay/2, so their echoes can't mix up.
+    // The echo is measured in the background and read at the next ping.
+    EchoCapture topEcho    = { -1, 0, 0 };
+    EchoCapture bottomEcho = { -1, 0, 0 };
+    bool topUSDetected     = false;
+    bool bottomUSDetected  = false;
+    bool pingTop           = false;  // sensor pinged last
+    unsigned long lastPingTime = 0;
+
     // Last time the lights were switched on or off
     unsigned long lastSwitchTime = 0;
 
@@ -104,7 +127,7 @@ class Animated_Staircase : public Usermod {
     void updateSegments() {
       mainSegmentId = strip.getMainSegmentId();
       WS2812FX::Segment* segments = strip.getSegments();
-      for (int i = 0; i < MAX_NUM_SEGMENTS; i++, segments++) {
+      for (int i = 0; i < strip.getSegmentCount(); i++, segments++) {
         if (!segments->isActive()) {
           maxSegmentId = i - 1;
           break;
@@ -127,12 +150,11 @@ class Animated_Staircase : public Usermod {
     }
 
     /*
-    * Detects if an object is within ultrasound range.
-    * signalPin: The pin where the pulse is sent
-    * echoPin:   The pin where the echo is received
-    * maxTimeUs: Detection timeout in microseconds. If an echo is
-    *            received within this time, an object is detected
-    *            and the function will return true.
+    * Ultrasonic ranging without waiting for the echo.
+    * ping() sends the trigger pulse, the echo pin interrupt timestamps the pulse
+    * and echoInRange() evaluates it at the next ping of the sensor.
+    * maxTimeUs: Detection timeout in microseconds. If the echo pulse is
+    *            shorter, an object is detected.
     *
     * The speed of sound is 343 meters per second at 20 degress Celcius.
     * Since the sound has to travel back and forth, the detection
@@ -148,14 +170,44 @@ class Animated_Staircase : public Usermod {
     *    50 cm = 2915 uS
     *   100 cm = 5831 uS
     */
-    bool ultrasoundRead(int8_t signalPin, int8_t echoPin, unsigned int maxTimeUs) {
-      if (signalPin<0 || echoPin<0) return false;
+    void ping(int8_t signalPin, EchoCapture& echo) {
+      if (signalPin<0 || echo.pin<0) return;
+      echo.rise = 0;
+      echo.width = 0;
       digitalWrite(signalPin, LOW);
       delayMicroseconds(2);
       digitalWrite(signalPin, HIGH);
       delayMicroseconds(10);
       digitalWrite(signalPin, LOW);
-      return pulseIn(echoPin, HIGH, maxTimeUs) > 0;
+    }
+
+    bool echoInRange(const EchoCapture& echo, unsigned int maxTimeUs) {
+      unsigned long width = echo.width;
+      return width && width <= maxTimeUs;
+    }
+
+    void attachEcho(EchoCapture& echo, int8_t pin) {
+      echo.pin = pin;
+      echo.rise = echo.width = 0;
+      if (pin >= 0) attachInterruptArg(digitalPinToInterrupt(pin), echoChange, &echo, CHANGE);
+    }
+
+    void detachEcho(EchoCapture& echo) {
+      if (echo.pin >= 0) detachInterrupt(digitalPinToInterrupt(echo.pin));
+      echo.pin = -1;
+    }
+
+    void updateUltrasound() {
+      if (!useUSSensorTop && !useUSSensorBottom) return;
+      if ((millis() - lastPingTime) < scanDelay/2) return;
+      lastPingTime = millis();
+      // result of the previous ping (an HC-SR04 echo lasts at most 38ms)
+      if (pingTop) topUSDetected    = echoInRange(topEcho, topMaxDist*59);       // cm to us
+      else         bottomUSDetected = echoInRange(bottomEcho, bottomMaxDist*59); // cm to us
+      if (useUSSensorTop && useUSSensorBottom) pingTop = !pingTop;
+      else pingTop = useUSSensorTop;
+      if (pingTop) ping(topPIRorTriggerPin, topEcho);
+      else         ping(bottomPIRorTriggerPin, bottomEcho);
     }
 
     bool checkSensors() {
@@ -167,12 +219,12 @@ class Animated_Staircase : public Usermod {
         bottomSensorRead = bottomSensorWrite ||
           (!useUSSensorBottom ?
             (bottomPIRorTriggerPin<0 ? false : digitalRead(bottomPIRorTriggerPin)) :
-            ultrasoundRead(bottomPIRorTriggerPin, bottomEchoPin, bottomMaxDist*59)  // cm to us
+            bottomUSDetected
           );
         topSensorRead = topSensorWrite ||
           (!useUSSensorTop ?
             (topPIRorTriggerPin<0 ? false : digitalRead(topPIRorTriggerPin)) :
-            ultrasoundRead(topPIRorTriggerPin, topEchoPin, topMaxDist*59)   // cm to us
+            topUSDetected
           );
 
         if (bottomSensorRead != bottomSensorState) {
@@ -280,6 +332,7 @@ class Animated_Staircase : public Usermod {
         else {
           pinMode(bottomPIRorTriggerPin, OUTPUT);
           pinMode(bottomEchoPin, INPUT);
+          if (bottomEcho.pin < 0) attachEcho(bottomEcho, bottomEchoPin);
         }
 
         if (!useUSSensorTop)
@@ -287,11 +340,15 @@ class Animated_Staircase : public Usermod {
         else {
           pinMode(topPIRorTriggerPin, OUTPUT);
           pinMode(topEchoPin, INPUT);
+          if (topEcho.pin < 0) attachEcho(topEcho, topEchoPin);
         }
       } else {
+        detachEcho(topEcho);
+        detachEcho(bottomEcho);
+        topUSDetected = bottomUSDetected = false;
         // Restore segment options
         WS2812FX::Segment* segments = strip.getSegments();
-        for (int i = 0; i < MAX_NUM_SEGMENTS; i++, segments++) {
+        for (int i = 0; i < strip.getSegmentCount(); i++, segments++) {
           if (!segments->isActive()) {
             maxSegmentId = i - 1;
             break;
@@ -333,6 +390,7 @@ class Animated_Staircase : public Usermod {
 
     void loop() {
       if (!enabled || strip.isUpdating()) return;
+      updateUltrasound();
       checkSensors();
       autoPowerOff();
       updateSwipe();
@@ -484,6 +542,8 @@ class Animated_Staircase : public Usermod {
             (oldBottomAPin != bottomPIRorTriggerPin) ||
             (oldBottomBPin != bottomEchoPin)) {
           changed = true;
+          detachEcho(topEcho);
+          detachEcho(bottomEcho);
           pinManager.deallocatePin(oldTopAPin, PinOwner::UM_AnimatedStaircase);
           pinManager.deallocatePin(oldTopBPin, PinOwner::UM_AnimatedStaircase);
           pinManager.deallocatePin(oldBottomAPin, PinOwner::UM_AnimatedStaircase);
@@ -123,6 +123,8 @@ public:
     lux_json.add(F(" lx"));
   }
 
+  uint16_t getLoopInterval() { return MIN(minReadingInterval, 1000UL); } // nothing to do before the minimum reading interval has passed
+
   uint16_t getId()
   {
     return USERMOD_ID_BH1750;
@@ -213,4 +213,6 @@ public:
       }
     }
   }
+
+  uint16_t getLoopInterval() { return 1000; } // TemperatureInterval is in seconds
 };
\ No newline at end of file
@@ -76,6 +76,24 @@ class MyExampleUsermod : public Usermod {
     }
 
 
+    /*
+     * getLoopInterval() lets WLED call loop() only every so many ms instead of on every iteration.
+     * Usermods that poll sensors should use it, so they do not compete with the LED output.
+     * Scheduled loop() calls share a time budget per iteration and may be delayed by one iteration if it is used up.
+     * Calls taking longer than getLoopBudget() us are counted as overruns (info "umperf").
+     */
+    //uint16_t getLoopInterval() { return 1000; }
+
+
+    /*
+     * Instead of comparing globals like bri or effectCurrent in every loop(), subscribe to events:
+     * getEventMask() returns the UM_EVENT_* flags of interest, onEvent() is then called when one happens.
+     * onEvent() may run in a network callback, so only note what changed there and act on it in loop().
+     */
+    //uint8_t getEventMask() { return UM_EVENT_STATE | UM_EVENT_PRESET; }
+    //void onEvent(uint8_t event, uint8_t arg) { stateChanged = true; }
+
+
     /*
      * addToJsonInfo() can be used to add custom entries to the /json/info part of the JSON API.
      * Creating an "u" object allows you to add custom key/value pairs to the Info section of the WLED web UI.
@@ -5,44 +5,63 @@
 #include <FS.h>
 
 #include <TFT_eSPI.h>
+#include <soc/soc_memory_layout.h>
 #include "Hardware.h"
 #include "ChipSelect.h"
 
+#ifndef TFT_CACHE_SIZE
+  #define TFT_CACHE_SIZE 12       // decoded digit images kept in RAM (PSRAM if available)
+#endif
+#ifndef TFT_CACHE_MIN_HEAP
+  #define TFT_CACHE_MIN_HEAP 40000 // internal heap left free when caching without PSRAM
+#endif
+
 class TFTs : public TFT_eSPI {
 private:
   uint8_t digits[NUM_DIGITS];
 
-  // These read 16- and 32-bit types from the SD card file.
-  // BMP data is stored little-endian, Arduino is little-endian too.
-  // May need to reverse subscript order if porting elsewhere.
-
-  uint16_t read16(fs::File &f) {
-    uint16_t result;
-    ((uint8_t *)&result)[0] = f.read(); // LSB
-    ((uint8_t *)&result)[1] = f.read(); // MSB
-    return result;
+  uint16_t output_buffer[TFT_HEIGHT][TFT_WIDTH]; // decode target, and bounce buffer for DMA from PSRAM
+
+  // Decoded images, so a digit change neither reads the filesystem nor converts pixels.
+  // Pixels are stored in panel byte order, the DMA transfer then needs no swapping.
+  struct CachedImage {
+    uint16_t* pixels = nullptr;
+    uint8_t   value = 255;
+    uint8_t   w = 0, h = 0;
+    unsigned long lastUsed = 0;
+  };
+  CachedImage cache[TFT_CACHE_SIZE];
+  uint8_t cacheUploads = 0;    // fileUploadCount the cache was filled at
+  bool dmaReady = false;
+  bool dmaActive = false;
+
+  uint16_t swap16(uint16_t c) { return (c >> 8) | (c << 8); }
+
+  void clearCache() {
+    waitDMA();
+    for (uint8_t i = 0; i < TFT_CACHE_SIZE; i++) {
+      free(cache[i].pixels);
+      cache[i] = CachedImage();
+    }
   }
 
-  uint32_t read32(fs::File &f) {
-    uint32_t result;
-    ((uint8_t *)&result)[0] = f.read(); // LSB
-    ((uint8_t *)&result)[1] = f.read();
-    ((uint8_t *)&result)[2] = f.read();
-    ((uint8_t *)&result)[3] = f.read(); // MSB
-    return result;
+  // The panel must not be deselected (or written otherwise) before the transfer completed
+  void waitDMA() {
+    if (!dmaActive) return;
+    dmaWait();
+    endWrite();
+    dmaActive = false;
   }
 
-  uint16_t output_buffer[TFT_HEIGHT][TFT_WIDTH];
-  
-
   // These BMP functions are stolen directly from the TFT_SPIFFS_BMP example in the TFT_eSPI library.
   // Unfortunately, they aren't part of the library itself, so I had to copy them.
   // I've modified drawBmp to buffer the whole image at once instead of doing it line-by-line.
+  // They now decode into output_buffer (w*h pixels, panel byte order) and leave drawing to pushDecoded().
 
   //// BEGIN STOLEN CODE
 
-  // Draw directly from file stored in RGB565 format
-  bool drawBin(const char *filename) {
+  // Load directly from file stored in RGB565 format
+  bool loadBin(const char *filename, uint8_t &w, uint8_t &h) {
     fs::File bmpFS;
 
 
@@ -57,31 +76,23 @@ private:
     }
 
     size_t sz = bmpFS.size();
-    if (sz <= 64800)
+    bool ok = sz <= 64800;
+    if (ok)
     {
-      bool oldSwapBytes = getSwapBytes();
-      setSwapBytes(true);
-
-      int16_t h = sz / (135 * 2);
-
-      //draw img that is shorter than 240pix into the center
-      int16_t y = (height() - h) /2;
-
-      bmpFS.read((uint8_t *) output_buffer,sz);
-
-      if (!realtimeMode || realtimeOverride) strip.service();
-
-      pushImage(0, y, 135, h, (uint16_t *)output_buffer);
+      w = 135;
+      h = sz / (135 * 2);
 
-      setSwapBytes(oldSwapBytes);
+      bmpFS.read((uint8_t *) output_buffer, w * h * 2);
+      uint16_t *px = (uint16_t *) output_buffer;
+      for (uint16_t i = 0; i < w * h; i++) px[i] = swap16(px[i]);
     }
 
     bmpFS.close();
 
-    return(true);
+    return(ok);
   }
 
-  bool drawBmp(const char *filename) {
+  bool loadBmp(const char *filename, uint8_t &w, uint8_t &h) {
     fs::File bmpFS;
 
     // Open requested file on SD card
@@ -94,17 +105,15 @@ private:
       return(false);
     }
 
-    uint32_t seekOffset;
-    int16_t w, h, row;
-    uint8_t  r, g, b;
-
-    uint16_t magic = read16(bmpFS);
-    if (magic == 0xFFFF) {
+    // whole header at once rather than field by field
+    uint8_t hdr[34];
+    if (bmpFS.read(hdr, sizeof(hdr)) != sizeof(hdr)) {
       Serial.println(F("BMP not found!"));
       bmpFS.close();
       return(false);
     }
-    
+
+    uint16_t magic = hdr[0] | (hdr[1] << 8);
     if (magic != 0x4D42) {
       Serial.print(F("File not a BMP. Magic: "));
       Serial.println(magic);
@@ -112,53 +121,103 @@ private:
       return(false);
     }
 
-    read32(bmpFS);
-    read32(bmpFS);
-    seekOffset = read32(bmpFS);
-    read32(bmpFS);
-    w = read32(bmpFS);
-    h = read32(bmpFS);
+    uint32_t seekOffset = hdr[10] | (hdr[11] << 8) | (hdr[12] << 16) | (hdr[13] << 24);
+    int32_t bw = hdr[18] | (hdr[19] << 8) | (hdr[20] << 16) | (hdr[21] << 24);
+    int32_t bh = hdr[22] | (hdr[23] << 8) | (hdr[24] << 16) | (hdr[25] << 24);
+    uint16_t planes = hdr[26] | (hdr[27] << 8);
+    uint16_t depth  = hdr[28] | (hdr[29] << 8);
+    uint32_t compression = hdr[30] | (hdr[31] << 8) | (hdr[32] << 16) | (hdr[33] << 24);
 
-    if ((read16(bmpFS) != 1) || (read16(bmpFS) != 24) || (read32(bmpFS) != 0)) {
+    if (planes != 1 || depth != 24 || compression != 0 || bw < 1 || bw > TFT_WIDTH || bh < 1 || bh > TFT_HEIGHT) {
       Serial.println(F("BMP format not recognized."));
       bmpFS.close();
       return(false);
     }
+    w = bw; h = bh;
 
-    //draw img that is shorter than 240pix into the center
-    int16_t y = (height() - h) /2;
-
-    bool oldSwapBytes = getSwapBytes();
-    setSwapBytes(true);
     bmpFS.seek(seekOffset);
 
     uint16_t padding = (4 - ((w * 3) & 3)) & 3;
     uint8_t lineBuffer[w * 3 + padding];
-    
+    uint16_t *px = (uint16_t *) output_buffer;
+    uint8_t  r, g, b;
+
     uint8_t serviceStrip = (!realtimeMode || realtimeOverride) ? 7 : 0;
     // row is decremented as the BMP image is drawn bottom up
-    for (row = h-1; row >= 0; row--) {
+    for (int16_t row = h-1; row >= 0; row--) {
       if ((row & 0b00000111) == serviceStrip) strip.service(); //still refresh backlight to mitigate stutter every few rows
       bmpFS.read(lineBuffer, sizeof(lineBuffer));
       uint8_t*  bptr = lineBuffer;
-      
+      uint16_t* out = px + row * w;
+
       // Convert 24 to 16 bit colours while copying to output buffer.
       for (uint16_t col = 0; col < w; col++)
       {
         b = *bptr++;
         g = *bptr++;
         r = *bptr++;
-        output_buffer[row][col] = ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3);
+        out[col] = swap16(((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3));
       }
     }
-    
-    pushImage(0, y, w, h, (uint16_t *)output_buffer);
-    setSwapBytes(oldSwapBytes);
 
     bmpFS.close();
     return(true);
   }
 
+  //// END STOLEN CODE
+
+  // Decodes the image for value into output_buffer
+  bool loadImage(uint8_t value, uint8_t &w, uint8_t &h) {
+    // Filenames are no bigger than "255.bmp\0"
+    char file_name[10];
+    sprintf(file_name, "/%d.bmp", value);
+    if (WLED_FS.exists(file_name)) return loadBmp(file_name, w, h);
+    sprintf(file_name, "/%d.bin", value);
+    return loadBin(file_name, w, h);
+  }
+
+  // Cache slot for a freshly decoded image, evicting the least recently used one
+  CachedImage* storeImage(uint8_t value, uint8_t w, uint8_t h) {
+    CachedImage* slot = &cache[0];
+    for (uint8_t i = 1; i < TFT_CACHE_SIZE && slot->pixels; i++) {
+      if (!cache[i].pixels || cache[i].lastUsed < slot->lastUsed) slot = &cache[i];
+    }
+    free(slot->pixels);
+    *slot = CachedImage();
+
+    size_t len = w * h * 2;
+    if (psramFound()) {
+      slot->pixels = (uint16_t*) ps_malloc(len);
+    } else if (ESP.getFreeHeap() > len + TFT_CACHE_MIN_HEAP) {
+      slot->pixels = (uint16_t*) heap_caps_malloc(len, MALLOC_CAP_DMA);
+    }
+    if (!slot->pixels) return nullptr;
+    memcpy(slot->pixels, output_buffer, len);
+    slot->value = value;
+    slot->w = w; slot->h = h;
+    slot->lastUsed = millis();
+    return slot;
+  }
+
+  // Sends w*h pixels, the DMA transfer continues while loop() runs
+  void pushDecoded(const uint16_t* data, uint8_t w, uint8_t h) {
+    //draw img that is shorter than 240pix into the center
+    int16_t y = (height() - h) /2;
+    int16_t x = (width() - w) /2;
+
+    if (!dmaReady || !esp_ptr_dma_capable(output_buffer)) {
+      pushImage(x, y, w, h, (uint16_t *)data);
+      return;
+    }
+    if (!esp_ptr_dma_capable(data)) {
+      memcpy(output_buffer, data, w * h * 2); // SPI DMA cannot read PSRAM
+      data = (uint16_t *)output_buffer;
+    }
+    startWrite();
+    pushImageDMA(x, y, w, h, (uint16_t *)data);
+    dmaActive = true;
+  }
+
 public:
   TFTs() : TFT_eSPI(), chip_select()
     { for (uint8_t digit=0; digit < NUM_DIGITS; digit++) digits[digit] = 0; }
@@ -178,25 +237,34 @@ public:
 
     // Initialize the super class.
     init();
+    setSwapBytes(false); // cached pixels are already in panel byte order
+    dmaReady = initDMA();
   }
 
   void showDigit(uint8_t digit) {
+    waitDMA();
     chip_select.setDigit(digit);
 
     if (digits[digit] == blanked) {
       fillScreen(TFT_BLACK);
+      return;
     }
-    else {
-      // Filenames are no bigger than "255.bmp\0"
-      char file_name[10];
-      sprintf(file_name, "/%d.bmp", digits[digit]);
-      if (WLED_FS.exists(file_name)) {
-        drawBmp(file_name);
-      } else {
-        sprintf(file_name, "/%d.bin", digits[digit]);
-        drawBin(file_name);
+
+    if (fileUploadCount != cacheUploads) { clearCache(); cacheUploads = fileUploadCount; } // images may have been replaced
+
+    for (uint8_t i = 0; i < TFT_CACHE_SIZE; i++) {
+      if (cache[i].pixels && cache[i].value == digits[digit]) {
+        cache[i].lastUsed = millis();
+        pushDecoded(cache[i].pixels, cache[i].w, cache[i].h);
+        return;
       }
     }
+
+    uint8_t w, h;
+    if (!loadImage(digits[digit], w, h)) return;
+    if (!realtimeMode || realtimeOverride) strip.service();
+    CachedImage* img = storeImage(digits[digit], w, h);
+    pushDecoded(img ? img->pixels : (uint16_t *)output_buffer, w, h); // not cached, send the decode buffer itself
   }
 
   void setDigit(uint8_t digit, uint8_t value, show_t show=yes) {
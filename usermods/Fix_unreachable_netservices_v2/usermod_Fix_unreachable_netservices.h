@@ -159,6 +159,8 @@ Delay <input type=\"number\" min=\"5\" max=\"300\" value=\"";
     return true;
   }
 
+  uint16_t getLoopInterval() { return 1000; } // pings are m_pingDelayMs apart
+
   /**
    * getId() allows you to optionally give your V2 usermod an unique ID (please define it in const.h!).
    * This could be used in the future for the system to determine whether your usermod is installed.
@@ -79,6 +79,12 @@ private:
   // flag to enable triggering only if WLED is initially off (LEDs are not on, preventing running effect being overwritten by PIR)
   bool m_offOnly = false;
   bool PIRtriggered = false;
+  // react to sensor pin edges right away instead of polling the pin 4x/s
+  bool m_useInterrupt = true;
+  int8_t interruptPin = -1;   // pin the interrupt is attached to
+  // set by the pin interrupt, consumed in loop()
+  volatile bool edgePending = false;
+  volatile unsigned long edgeTime = 0;
 
   unsigned long lastLoop = 0;
 
@@ -91,6 +97,26 @@ private:
   static const char _nightTime[];
   static const char _mqttOnly[];
   static const char _offOnly[];
+  static const char _interrupt[];
+
+  static void IRAM_ATTR pinEdge(void* arg) {
+    PIRsensorSwitch* s = (PIRsensorSwitch*)arg;
+    s->edgeTime = millis();
+    s->edgePending = true;
+  }
+
+  void attachSensorInterrupt() {
+    if (interruptPin >= 0 || !m_useInterrupt || !enabled || PIRsensorPin < 0) return;
+    edgePending = false;
+    attachInterruptArg(digitalPinToInterrupt(PIRsensorPin), pinEdge, this, CHANGE);
+    interruptPin = PIRsensorPin;
+  }
+
+  void detachSensorInterrupt() {
+    if (interruptPin < 0) return;
+    detachInterrupt(digitalPinToInterrupt(interruptPin));
+    interruptPin = -1;
+  }
 
   /**
    * check if it is daytime
@@ -164,8 +190,8 @@ private:
         if (!m_mqttOnly && (!m_nightTimeOnly || (m_nightTimeOnly && !isDayTime()))) switchStrip(true);
         publishMqtt("on");
       } else /*if (bri != 0)*/ {
-        // start switch off timer
-        m_offTimerStart = millis();
+        // start switch off timer, from the moment the sensor went LOW
+        m_offTimerStart = interruptPin >= 0 ? edgeTime : millis();
       }
       return true;
     }
@@ -205,6 +231,7 @@ public:
         // PIR Sensor mode INPUT_PULLUP
         pinMode(PIRsensorPin, INPUT_PULLUP);
         sensorPinState = digitalRead(PIRsensorPin);
+        attachSensorInterrupt();
       } else {
         if (PIRsensorPin >= 0) {
           DEBUG_PRINTLN(F("PIRSensorSwitch pin allocation failed."));
@@ -229,11 +256,17 @@ public:
    */
   void loop()
   {
-    // only check sensors 4x/s
-    if (!enabled || millis() - lastLoop < 250 || strip.isUpdating()) return;
+    if (!enabled || strip.isUpdating()) return;
+    // sensor edges are handled on the next loop() pass
+    if (edgePending) {
+      edgePending = false;
+      if (updatePIRsensorState()) return;
+    }
+    // only poll sensors and check the off timer 4x/s
+    if (millis() - lastLoop < 250) return;
     lastLoop = millis();
 
-    if (!updatePIRsensorState()) {
+    if (interruptPin >= 0 || !updatePIRsensorState()) {
       handleOffTimer();
     }
   }
@@ -322,6 +355,7 @@ public:
     top[FPSTR(_nightTime)] = m_nightTimeOnly;
     top[FPSTR(_mqttOnly)]  = m_mqttOnly;
     top[FPSTR(_offOnly)]   = m_offOnly;
+    top[FPSTR(_interrupt)] = m_useInterrupt;
     DEBUG_PRINTLN(F("PIR config saved."));
   }
 
@@ -334,6 +368,7 @@ public:
   bool readFromConfig(JsonObject &root)
   {
     bool oldEnabled = enabled;
+    bool oldInterrupt = m_useInterrupt;
     int8_t oldPin = PIRsensorPin;
 
     JsonObject top = root[FPSTR(_name)];
@@ -358,13 +393,15 @@ public:
     m_nightTimeOnly = top[FPSTR(_nightTime)] | m_nightTimeOnly;
     m_mqttOnly      = top[FPSTR(_mqttOnly)] | m_mqttOnly;
     m_offOnly       = top[FPSTR(_offOnly)] | m_offOnly;
+    m_useInterrupt  = top[FPSTR(_interrupt)] | m_useInterrupt;
 
     DEBUG_PRINT(FPSTR(_name));
     if (!initDone) {
       // reading config prior to setup()
       DEBUG_PRINTLN(F(" config loaded."));
     } else {
-      if (oldPin != PIRsensorPin || oldEnabled != enabled) {
+      if (oldPin != PIRsensorPin || oldEnabled != enabled || oldInterrupt != m_useInterrupt) {
+        detachSensorInterrupt();
         // check if pin is OK
         if (oldPin != PIRsensorPin && oldPin >= 0) {
           // if we are changing pin in settings page
@@ -380,12 +417,13 @@ public:
         }
         if (enabled) {
           sensorPinState = digitalRead(PIRsensorPin);
+          attachSensorInterrupt();
         }
       }
       DEBUG_PRINTLN(F(" config (re)loaded."));
     }
     // use "return !top["newestParameter"].isNull();" when updating Usermod with new features
-    return !top[FPSTR(_offOnly)].isNull();
+    return !top[FPSTR(_interrupt)].isNull();
   }
 
   /**
@@ -407,3 +445,4 @@ const char PIRsensorSwitch::_offPreset[]      PROGMEM = "off-preset";
 const char PIRsensorSwitch::_nightTime[]      PROGMEM = "nighttime-only";
 const char PIRsensorSwitch::_mqttOnly[]       PROGMEM = "mqtt-only";
 const char PIRsensorSwitch::_offOnly[]        PROGMEM = "off-only";
+const char PIRsensorSwitch::_interrupt[]      PROGMEM = "interrupt";
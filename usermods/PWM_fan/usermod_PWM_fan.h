@@ -312,6 +312,8 @@ class PWMFanUsermod : public Usermod {
       return !top[FPSTR(_IRQperRotation)].isNull();
   }
 
+    uint16_t getLoopInterval() { return 1000; } // tachoUpdateSec is in seconds
+
     /*
      * getId() allows you to optionally give your V2 usermod an unique ID (please define it in const.h!).
      * This could be used in the future for the system to determine whether your usermod is installed.
@@ -144,6 +144,8 @@ public:
     lux.add(F(" lux"));
   }
 
+  uint16_t getLoopInterval() { return 1000; } // readingInterval is in whole seconds
+
   uint16_t getId()
   {
     return USERMOD_ID_SN_PHOTORESISTOR;
@@ -17,12 +17,73 @@
 #define USERMOD_DALLASTEMPERATURE_MEASUREMENT_INTERVAL 60000
 #endif
 
+// ESP32: define as a UART number (1 or 2) to run the 1-Wire bus on that UART instead of bit-banging it
+//#define USERMOD_DALLASTEMPERATURE_UART 1
+#if defined(USERMOD_DALLASTEMPERATURE_UART) && !defined(ARDUINO_ARCH_ESP32)
+  #undef USERMOD_DALLASTEMPERATURE_UART
+#endif
+
+#ifdef USERMOD_DALLASTEMPERATURE_UART
+#include "driver/gpio.h"
+#include "soc/gpio_struct.h"
+
+// 1-Wire over a UART with TX and RX on the sensor pin (open drain, the sensor pull-up keeps the line high).
+// Every bit slot is one UART character: at 115200 baud 0xFF is a write-1/read slot and 0x00 a write-0 slot,
+// a bit reads as 1 if the echo comes back unchanged. A reset is 0xF0 at 9600 baud, a presence pulse alters the echo.
+// The peripheral generates and samples the slots, so no interrupts are masked while talking to the sensor.
+class OneWireUart {
+  private:
+    HardwareSerial uart;
+    int8_t pin;
+
+    int readEcho() {
+      unsigned long start = millis();
+      while (!uart.available()) if (millis() - start > 5) return -1;
+      return uart.read();
+    }
+
+  public:
+    OneWireUart(uint8_t num, int8_t pin) : uart(num), pin(pin) {
+      uart.begin(115200, SERIAL_8N1, pin, pin);
+      GPIO.pin[pin].pad_driver = 1;              // open drain, the sensor must be able to pull the line low
+      PIN_INPUT_ENABLE(GPIO_PIN_MUX_REG[pin]);   // RX listens on the same pin
+    }
+    ~OneWireUart() { uart.end(); }
+
+    uint8_t reset() {
+      uart.updateBaudRate(9600);
+      while (uart.available()) uart.read();
+      uart.write(0xF0);
+      int echo = readEcho();
+      uart.updateBaudRate(115200);
+      return echo >= 0 && echo != 0xF0;          // some device answered with a presence pulse
+    }
+    // writes v LSB first and returns the bits seen on the line, write 0xFF to read a byte
+    uint8_t transfer(uint8_t v) {
+      uint8_t slots[8];
+      for (uint8_t i = 0; i < 8; i++) slots[i] = (v & (1 << i)) ? 0xFF : 0x00;
+      while (uart.available()) uart.read();
+      uart.write(slots, 8);
+      uint8_t r = 0;
+      for (uint8_t i = 0; i < 8; i++) if (readEcho() == 0xFF) r |= 1 << i;
+      return r;
+    }
+    void write(uint8_t v, uint8_t power = 0) { transfer(v); } // the line idles released, parasite power relies on the pull-up
+    uint8_t read() { return transfer(0xFF); }
+    void skip() { write(0xCC); }
+};
+#endif
+
 class UsermodTemperature : public Usermod {
 
   private:
 
     bool initDone = false;
-    OneWire *oneWire;
+    #ifdef USERMOD_DALLASTEMPERATURE_UART
+    OneWireUart *oneWire = nullptr;
+    #else
+    OneWire *oneWire = nullptr;
+    #endif
     // GPIO pin used for sensor (with a default compile-time fallback)
     int8_t temperaturePin = TEMPERATURE_PIN;
     // measurement unit (true==°C, false==°F)
@@ -55,18 +116,19 @@ class UsermodTemperature : public Usermod {
     //Dallas sensor quick (& dirty) reading. Credit to - Author: Peter Scargill, August 17th, 2013
     float readDallas() {
       byte i;
-      byte data[2];
+      byte data[9];
       int16_t result;                         // raw data from sensor
-      if (!oneWire->reset()) return -127.0f;  // send reset command and fail fast
+      if (!oneWire || !oneWire->reset()) return -127.0f;  // send reset command and fail fast
       oneWire->skip();                        // skip ROM
-      oneWire->write(0xBE);                   // read (temperature) from EEPROM
-      for (i=0; i < 2; i++) data[i] = oneWire->read();  // first 2 bytes contain temperature
-      for (i=2; i < 8; i++) oneWire->read();  // read unused bytes  
+      oneWire->write(0xBE);                   // read scratchpad
+      for (i=0; i < 9; i++) data[i] = oneWire->read();  // first 2 bytes contain temperature, the last one is the CRC
+      bool valid = OneWire::crc8(data, 8) == data[8];
       result = (data[1]<<4) | (data[0]>>4);   // we only need whole part, we will add fraction when returning
       if (data[1]&0x80) result |= 0xFF00;     // fix negative value
       oneWire->reset();
       oneWire->skip();                        // skip ROM
       oneWire->write(0x44,parasite);          // request new temperature reading (without parasite power)
+      if (!valid || (data[0] == 0 && data[8] == 0)) return -127.0f; // bad CRC or nobody driving the bus (all zeroes pass the CRC)
       return (float)result + ((data[0]&0x0008) ? 0.5f : 0.0f);
     }
 
@@ -86,27 +148,39 @@ class UsermodTemperature : public Usermod {
       DEBUG_PRINTLN(temperature);
     }
 
+    bool isDallasSensor(const uint8_t *deviceAddress) {
+      if (OneWire::crc8(deviceAddress, 7) != deviceAddress[7]) return false;
+      switch (deviceAddress[0]) {
+        case 0x10:  // DS18S20
+        case 0x22:  // DS18B20
+        case 0x28:  // DS1822
+        case 0x3B:  // DS1825
+        case 0x42:  // DS28EA00
+          DEBUG_PRINTLN(F("Sensor found."));
+          return true;
+      }
+      return false;
+    }
+
     bool findSensor() {
       DEBUG_PRINTLN(F("Searching for sensor..."));
       uint8_t deviceAddress[8] = {0,0,0,0,0,0,0,0};
       // find out if we have DS18xxx sensor attached
+      #ifdef USERMOD_DALLASTEMPERATURE_UART
+      // no search on the UART bus, a single sensor is read with skip ROM anyway
+      if (!oneWire->reset()) return false;
+      oneWire->write(0x33);                   // read ROM
+      for (byte i=0; i < 8; i++) deviceAddress[i] = oneWire->read();
+      return isDallasSensor(deviceAddress);
+      #else
       oneWire->reset_search();
       delay(10);
       while (oneWire->search(deviceAddress)) {
         DEBUG_PRINTLN(F("Found something..."));
-        if (oneWire->crc8(deviceAddress, 7) == deviceAddress[7]) {
-          switch (deviceAddress[0]) {
-            case 0x10:  // DS18S20
-            case 0x22:  // DS18B20
-            case 0x28:  // DS1822
-            case 0x3B:  // DS1825
-            case 0x42:  // DS28EA00
-              DEBUG_PRINTLN(F("Sensor found."));
-              return true;
-          }
-        }
+        if (isDallasSensor(deviceAddress)) return true;
       }
       return false;
+      #endif
     }
 
   public:
@@ -118,7 +192,11 @@ class UsermodTemperature : public Usermod {
         DEBUG_PRINTLN(F("Allocating temperature pin..."));
         // pin retrieved from cfg.json (readFromConfig()) prior to running setup()
         if (temperaturePin >= 0 && pinManager.allocatePin(temperaturePin, true, PinOwner::UM_Temperature)) {
+          #ifdef USERMOD_DALLASTEMPERATURE_UART
+          oneWire = new OneWireUart(USERMOD_DALLASTEMPERATURE_UART, temperaturePin);
+          #else
           oneWire = new OneWire(temperaturePin);
+          #endif
           if (!oneWire->reset()) {
             sensorFound = false;   // resetting 1-Wire bus yielded an error
           } else {
@@ -280,6 +358,7 @@ class UsermodTemperature : public Usermod {
           DEBUG_PRINTLN(F("Re-init temperature."));
           // deallocate pin and release memory
           delete oneWire;
+          oneWire = nullptr;
           pinManager.deallocatePin(temperaturePin, PinOwner::UM_Temperature);
           temperaturePin = newTemperaturePin;
           // initialise
@@ -290,6 +369,8 @@ class UsermodTemperature : public Usermod {
       return !top[FPSTR(_parasite)].isNull();
     }
 
+    uint16_t getLoopInterval() { return 100; } // a conversion takes about 94 ms
+
     uint16_t getId()
     {
       return USERMOD_ID_TEMPERATURE;
@@ -0,0 +1,282 @@
+#pragma once
+
+#ifndef ARDUINO_ARCH_ESP32
+#error The "Audio reactive" usermod requires an ESP32.
+#endif
+
+#include "wled.h"
+#include <driver/i2s.h>
+
+/*
+ * Sound analysis of an I2S MEMS microphone (INMP441, ICS-43434, SPH0645 and alike).
+ * A task on the core that does not render reads blocks of samples, computes a windowed fixed-point FFT
+ * and publishes band energies, volume and bass beats with publishAudio() (see FX.h) for the effects.
+ * The render core only copies the result once per frame.
+ */
+
+#define AUDIO_SAMPLE_RATE 22050
+#define AUDIO_FFT_SIZE    512    //samples per analysis, 43 Hz per bin and about 43 analyses per second
+#define AUDIO_FFT_BITS    9
+#define AUDIO_MIN_BIN     1
+#define AUDIO_MAX_BIN     232    //about 10 kHz
+#define AUDIO_BEAT_HOLD   250    //ms between beats
+
+class AudioReactiveUsermod : public Usermod {
+
+  private:
+
+    bool initDone = false;
+    bool enabled = true;
+    TaskHandle_t task = nullptr;
+
+    // configurable parameters
+    int8_t  sdPin   = -1;
+    int8_t  wsPin   = -1;
+    int8_t  sckPin  = -1;
+    uint8_t gain    = 100;   // percent
+    uint8_t squelch = 10;    // magnitudes below are silence
+
+    // analysis state, only touched by the audio task after setup
+    int32_t  samples[AUDIO_FFT_SIZE];
+    int32_t  re[AUDIO_FFT_SIZE], im[AUDIO_FFT_SIZE];
+    int16_t  window[AUDIO_FFT_SIZE];        // Hann, Q15
+    int16_t  cosT[AUDIO_FFT_SIZE/2], sinT[AUDIO_FFT_SIZE/2]; // twiddles, Q15
+    uint8_t  bandEnd[AUDIO_BANDS];          // first bin after each band
+    uint32_t levelPeak = 1024;              // gain control of the bands
+    uint32_t volumePeak = 1024;
+    uint32_t bassAvg = 0;
+    uint32_t lastBeat = 0;
+    uint8_t  volume = 0;                    // for info, written by the task
+
+    // strings to reduce flash memory usage (used more than twice)
+    static const char _name[];
+    static const char _enabled[];
+    static const char _sdPin[];
+    static const char _wsPin[];
+    static const char _sckPin[];
+    static const char _gain[];
+    static const char _squelch[];
+
+    static void audioTask(void* arg) {
+      ((AudioReactiveUsermod*)arg)->run();
+    }
+
+    void initTables() {
+      for (uint16_t i = 0; i < AUDIO_FFT_SIZE; i++) {
+        window[i] = 32767 * (0.5f - 0.5f * cosf(2.0f * M_PI * i / (AUDIO_FFT_SIZE -1)));
+      }
+      for (uint16_t k = 0; k < AUDIO_FFT_SIZE/2; k++) {
+        cosT[k] = 32767 * cosf(2.0f * M_PI * k / AUDIO_FFT_SIZE);
+        sinT[k] = 32767 * sinf(2.0f * M_PI * k / AUDIO_FFT_SIZE);
+      }
+      // logarithmic bands, at least one bin each
+      uint16_t end = AUDIO_MIN_BIN;
+      for (uint8_t b = 0; b < AUDIO_BANDS; b++) {
+        uint16_t e = AUDIO_MIN_BIN * powf((float)AUDIO_MAX_BIN / AUDIO_MIN_BIN, (float)(b +1) / AUDIO_BANDS);
+        end = MAX(end +1, e);
+        bandEnd[b] = MIN(end, AUDIO_FFT_SIZE/2);
+      }
+    }
+
+    bool initI2S() {
+      if (sdPin < 0 || wsPin < 0 || sckPin < 0) return false;
+      managed_pin_type pins[] = { {sdPin, false}, {wsPin, true}, {sckPin, true} };
+      if (!pinManager.allocateMultiplePins(pins, 3, PinOwner::UM_AudioReactive)) {
+        sdPin = wsPin = sckPin = -1;
+        return false;
+      }
+      i2s_config_t cfg = {};
+      cfg.mode = (i2s_mode_t)(I2S_MODE_MASTER | I2S_MODE_RX);
+      cfg.sample_rate = AUDIO_SAMPLE_RATE;
+      cfg.bits_per_sample = I2S_BITS_PER_SAMPLE_32BIT;
+      cfg.channel_format = I2S_CHANNEL_FMT_ONLY_LEFT;
+      cfg.communication_format = (i2s_comm_format_t)(I2S_COMM_FORMAT_I2S | I2S_COMM_FORMAT_I2S_MSB);
+      cfg.intr_alloc_flags = ESP_INTR_FLAG_LEVEL1;
+      cfg.dma_buf_count = 4;
+      cfg.dma_buf_len = AUDIO_FFT_SIZE / 2;
+      i2s_pin_config_t pinCfg = {};
+      pinCfg.bck_io_num = sckPin;
+      pinCfg.ws_io_num = wsPin;
+      pinCfg.data_out_num = I2S_PIN_NO_CHANGE;
+      pinCfg.data_in_num = sdPin;
+      if (i2s_driver_install(I2S_NUM_0, &cfg, 0, nullptr) != ESP_OK) {
+        deinitPins();
+        return false;
+      }
+      i2s_set_pin(I2S_NUM_0, &pinCfg);
+      return true;
+    }
+
+    void deinitPins() {
+      pinManager.deallocatePin(sdPin, PinOwner::UM_AudioReactive);
+      pinManager.deallocatePin(wsPin, PinOwner::UM_AudioReactive);
+      pinManager.deallocatePin(sckPin, PinOwner::UM_AudioReactive);
+    }
+
+    void stop() {
+      if (!task) return;
+      vTaskDelete(task);
+      task = nullptr;
+      i2s_driver_uninstall(I2S_NUM_0);
+      deinitPins();
+    }
+
+    // radix-2 in place, halved every stage so the values stay within 16 bit and products within 32 bit
+    void fft() {
+      for (uint16_t i = 1, j = 0; i < AUDIO_FFT_SIZE; i++) {
+        uint16_t bit = AUDIO_FFT_SIZE >> 1;
+        for (; j & bit; bit >>= 1) j ^= bit;
+        j ^= bit;
+        if (i < j) { int32_t t = re[i]; re[i] = re[j]; re[j] = t; }
+      }
+      for (uint16_t len = 2, step = AUDIO_FFT_SIZE / 2; len <= AUDIO_FFT_SIZE; len <<= 1, step >>= 1) {
+        uint16_t half = len >> 1;
+        for (uint16_t i = 0; i < AUDIO_FFT_SIZE; i += len) {
+          for (uint16_t k = 0; k < half; k++) {
+            int32_t wr = cosT[k * step], wi = -sinT[k * step];
+            int32_t* ar = re + i + k; int32_t* ai = im + i + k;
+            int32_t tr = (ar[half] * wr - ai[half] * wi) >> 15;
+            int32_t ti = (ar[half] * wi + ai[half] * wr) >> 15;
+            ar[half] = (*ar - tr) >> 1; ai[half] = (*ai - ti) >> 1;
+            *ar = (*ar + tr) >> 1;      *ai = (*ai + ti) >> 1;
+          }
+        }
+      }
+    }
+
+    void analyze() {
+      // DC offset of the block, INMP441 and alike deliver 24 bit left aligned
+      int32_t dc = 0;
+      for (uint16_t i = 0; i < AUDIO_FFT_SIZE; i++) dc += samples[i] >> 16;
+      dc /= AUDIO_FFT_SIZE;
+      uint32_t absSum = 0;
+      for (uint16_t i = 0; i < AUDIO_FFT_SIZE; i++) {
+        int32_t s = constrain((((samples[i] >> 16) - dc) * gain) / 100, -32767, 32767);
+        absSum += abs(s);
+        re[i] = (s * window[i]) >> 15;
+        im[i] = 0;
+      }
+      fft();
+
+      AudioData out = {};
+      uint32_t level[AUDIO_BANDS];
+      uint32_t maxLevel = 0;
+      uint16_t bin = AUDIO_MIN_BIN;
+      for (uint8_t b = 0; b < AUDIO_BANDS; b++) {
+        uint32_t sum = 0;
+        uint16_t first = bin;
+        for (; bin < bandEnd[b]; bin++) {
+          uint32_t r = abs(re[bin]), m = abs(im[bin]);
+          sum += (r > m) ? r + (m >> 1) : m + (r >> 1); // about the magnitude
+        }
+        level[b] = sum / MAX(1, bin - first);
+        if (level[b] < squelch) level[b] = 0;
+        if (level[b] > maxLevel) { maxLevel = level[b]; out.peakBand = b; }
+      }
+      // slow gain control, fast attack
+      levelPeak  = MAX(maxLevel, MAX(levelPeak - (levelPeak >> 9), (uint32_t)squelch * 4));
+      uint32_t vol = absSum / AUDIO_FFT_SIZE;
+      volumePeak = MAX(vol, MAX(volumePeak - (volumePeak >> 9), (uint32_t)squelch * 4));
+      for (uint8_t b = 0; b < AUDIO_BANDS; b++) out.bands[b] = MIN(255, level[b] * 255 / levelPeak);
+      out.volume = volume = (vol < squelch) ? 0 : MIN(255, vol * 255 / volumePeak);
+
+      // bass beat: energy of the lowest bands well above their running average
+      uint32_t now = millis();
+      uint32_t bass = level[0] + level[1] + level[2];
+      if (bass > squelch && bass > bassAvg + (bassAvg >> 1) && now - lastBeat > AUDIO_BEAT_HOLD) lastBeat = now;
+      bassAvg = bassAvg - (bassAvg >> 4) + (bass >> 4);
+      out.beatTime = lastBeat;
+      out.time = now;
+      publishAudio(out);
+    }
+
+    void run() {
+      for (;;) {
+        size_t got = 0;
+        i2s_read(I2S_NUM_0, samples, sizeof(samples), &got, portMAX_DELAY);
+        if (got == sizeof(samples)) analyze();
+      }
+    }
+
+  public:
+
+    void setup() {
+      initDone = true;
+      if (!enabled || !initI2S()) return;
+      initTables();
+      // the analysis runs next to loop() if it has its own render task, on the other core otherwise
+      #ifdef WLED_RENDER_TASK
+      BaseType_t core = xPortGetCoreID();
+      #else
+      BaseType_t core = 1 - xPortGetCoreID();
+      #endif
+      if (xTaskCreatePinnedToCore(audioTask, "audio", 3072, this, 1, &task, core) != pdPASS) {
+        task = nullptr;
+        i2s_driver_uninstall(I2S_NUM_0);
+        deinitPins();
+        return;
+      }
+      DEBUG_PRINTLN(F("Audio analysis started."));
+    }
+
+    void addToJsonInfo(JsonObject& root) {
+      JsonObject user = root["u"];
+      if (user.isNull()) user = root.createNestedObject("u");
+      JsonArray data = user.createNestedArray(FPSTR(_name));
+      if (!task) {
+        data.add(F("no microphone"));
+        return;
+      }
+      data.add(volume * 100 / 255);
+      data.add(F("% volume"));
+    }
+
+    void addToConfig(JsonObject& root) {
+      JsonObject top = root.createNestedObject(FPSTR(_name));
+      top[FPSTR(_enabled)] = enabled;
+      top[FPSTR(_sdPin)]   = sdPin;
+      top[FPSTR(_wsPin)]   = wsPin;
+      top[FPSTR(_sckPin)]  = sckPin;
+      top[FPSTR(_gain)]    = gain;
+      top[FPSTR(_squelch)] = squelch;
+    }
+
+    bool readFromConfig(JsonObject& root) {
+      JsonObject top = root[FPSTR(_name)];
+      DEBUG_PRINT(FPSTR(_name));
+      if (top.isNull()) {
+        DEBUG_PRINTLN(F(": No config found. (Using defaults.)"));
+        return false;
+      }
+      bool newEnabled = top[FPSTR(_enabled)] | enabled;
+      int8_t newSd    = top[FPSTR(_sdPin)]  | sdPin;
+      int8_t newWs    = top[FPSTR(_wsPin)]  | wsPin;
+      int8_t newSck   = top[FPSTR(_sckPin)] | sckPin;
+      gain    = top[FPSTR(_gain)]    | gain;
+      squelch = top[FPSTR(_squelch)] | squelch;
+
+      if (initDone && (newEnabled != enabled || newSd != sdPin || newWs != wsPin || newSck != sckPin)) {
+        DEBUG_PRINTLN(F(" config (re)loaded, restarting analysis."));
+        stop();
+        enabled = newEnabled; sdPin = newSd; wsPin = newWs; sckPin = newSck;
+        setup();
+      } else {
+        enabled = newEnabled; sdPin = newSd; wsPin = newWs; sckPin = newSck;
+        DEBUG_PRINTLN(F(" config loaded."));
+      }
+      return !top[FPSTR(_squelch)].isNull();
+    }
+
+    uint16_t getId() {
+      return USERMOD_ID_AUDIOREACTIVE;
+    }
+};
+
+// strings to reduce flash memory usage (used more than twice)
+const char AudioReactiveUsermod::_name[]    PROGMEM = "AudioReactive";
+const char AudioReactiveUsermod::_enabled[] PROGMEM = "enabled";
+const char AudioReactiveUsermod::_sdPin[]   PROGMEM = "sd-pin";
+const char AudioReactiveUsermod::_wsPin[]   PROGMEM = "ws-pin";
+const char AudioReactiveUsermod::_sckPin[]  PROGMEM = "sck-pin";
+const char AudioReactiveUsermod::_gain[]    PROGMEM = "gain";
+const char AudioReactiveUsermod::_squelch[] PROGMEM = "squelch";
@@ -383,6 +383,8 @@ class UsermodBatteryBasic : public Usermod
     }
 
    
+    uint16_t getLoopInterval() { return 1000; } // readings are USERMOD_BATTERY_MEASUREMENT_INTERVAL apart
+
     /*
      * getId() allows you to optionally give your V2 usermod an unique ID (please define it in const.h!).
      * This could be used in the future for the system to determine whether your usermod is installed.
@@ -281,4 +281,6 @@ public:
       }
     }
   }
+
+  uint16_t getLoopInterval() { return 1000; } // measured once a minute
 };
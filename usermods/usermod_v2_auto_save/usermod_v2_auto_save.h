@@ -218,6 +218,8 @@ class AutoSaveUsermod : public Usermod {
       return true;
   }
 
+    uint16_t getLoopInterval() { return 1000; } // autoSaveAfterSec is in seconds
+
     /*
      * getId() allows you to optionally give your V2 usermod an unique ID (please define it in const.h!).
      * This could be used in the future for the system to determine whether your usermod is installed.
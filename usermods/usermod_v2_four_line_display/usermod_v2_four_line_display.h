@@ -83,6 +83,17 @@
 // Extra char (+1) for null
 #define LINE_BUFFER_SIZE            16+1
 
+// Largest display in 8x8 tiles (128x64), for the tile cache
+#define FLD_MAX_COLS 16
+#define FLD_MAX_ROWS 8
+
+// ESP32: send display transfers from a background task, so the bus
+// transactions do not block loop()
+//#define FLD_ESP32_USE_THREADS
+#if defined(FLD_ESP32_USE_THREADS) && !defined(ARDUINO_ARCH_ESP32)
+  #undef FLD_ESP32_USE_THREADS
+#endif
+
 typedef enum {
   FLD_LINE_BRIGHTNESS = 0,
   FLD_LINE_EFFECT_SPEED,
@@ -103,6 +114,21 @@ typedef enum {
   SSD1306_SPI64 // U8X8_SSD1306_128X64_NONAME_HW_SPI
 } DisplayType;
 
+// one display operation, executed right away or by the draw task
+typedef struct {
+  uint8_t op;       // FLD_OP_*
+  uint8_t col, row;
+  uint8_t arg;      // glyph, contrast, flip or power save value
+  uint8_t scale;    // 0 1x1, 1 1x2, 2 2x2
+  const uint8_t *font;
+} DisplayOp;
+
+#define FLD_OP_GLYPH     0
+#define FLD_OP_CLEAR     1
+#define FLD_OP_POWERSAVE 2
+#define FLD_OP_CONTRAST  3
+#define FLD_OP_FLIP      4
+
 class FourLineDisplayUsermod : public Usermod {
 
   private:
@@ -148,6 +174,16 @@ class FourLineDisplayUsermod : public Usermod {
     // Set to 2 or 3 to mark lines 2 or 3. Other values ignored.
     byte markLineNum = 0;
 
+    // What each tile last showed (glyph, font slot, scale, part of the glyph),
+    // only tiles that change are sent to the display. 0 = unknown or cleared.
+    uint16_t tileCache[FLD_MAX_ROWS][FLD_MAX_COLS];
+    const uint8_t *cacheFonts[4] = {nullptr};
+
+    #ifdef FLD_ESP32_USE_THREADS
+    QueueHandle_t drawQueue = nullptr;
+    TaskHandle_t drawTask = nullptr;
+    #endif
+
     // strings to reduce flash memory usage (used more than twice)
     static const char _name[];
     static const char _contrast[];
@@ -252,6 +288,11 @@ class FourLineDisplayUsermod : public Usermod {
       DEBUG_PRINTLN(F("Starting display."));
       if (!(type == SSD1306_SPI || type == SSD1306_SPI64)) u8x8->setBusClock(ioFrequency);  // can be used for SPI too
       u8x8->begin();
+      memset(tileCache, 0, sizeof(tileCache));
+      #ifdef FLD_ESP32_USE_THREADS
+      if (!drawQueue) drawQueue = xQueueCreate(FLD_MAX_COLS * 4, sizeof(DisplayOp)); // a full redraw of the text lines
+      if (drawQueue && !drawTask) xTaskCreatePinnedToCore(drawTaskFn, "4LineDisplay", 3072, this, 1, &drawTask, 0); // core 0, next to WiFi
+      #endif
       setFlipMode(flip);
       setContrast(contrast); //Contrast setup will help to preserve OLED lifetime. In case OLED need to be brighter increase number up to 255
       setPowerSave(0);
@@ -272,33 +313,96 @@ class FourLineDisplayUsermod : public Usermod {
       redraw(false);
     }
 
+    /**
+     * Display operations go through submit(), which runs them right away
+     * or hands them to the draw task.
+     */
+    void execute(const DisplayOp &op) {
+      switch (op.op) {
+        case FLD_OP_GLYPH:
+          u8x8->setFont(op.font);
+          if      (op.scale == 2) u8x8->draw2x2Glyph(op.col, op.row, op.arg);
+          else if (op.scale == 1) u8x8->draw1x2Glyph(op.col, op.row, op.arg);
+          else                    u8x8->drawGlyph(op.col, op.row, op.arg);
+          break;
+        case FLD_OP_CLEAR:     u8x8->clear();                break;
+        case FLD_OP_POWERSAVE: u8x8->setPowerSave(op.arg);   break;
+        case FLD_OP_CONTRAST:  u8x8->setContrast(op.arg);    break;
+        case FLD_OP_FLIP:      u8x8->setFlipMode(op.arg);    break;
+      }
+    }
+    void submit(uint8_t o, uint8_t arg = 0, uint8_t col = 0, uint8_t row = 0, uint8_t scale = 0, const uint8_t *font = nullptr) {
+      DisplayOp op = {o, col, row, arg, scale, font};
+      #ifdef FLD_ESP32_USE_THREADS
+      if (drawQueue) { xQueueSend(drawQueue, &op, portMAX_DELAY); return; }
+      #endif
+      execute(op);
+    }
+    #ifdef FLD_ESP32_USE_THREADS
+    static void drawTaskFn(void *arg) {
+      FourLineDisplayUsermod *self = (FourLineDisplayUsermod*) arg;
+      DisplayOp op;
+      for (;;) {
+        // peek first, the op leaves the queue only when it is done (see waitIdle())
+        if (xQueuePeek(self->drawQueue, &op, portMAX_DELAY) != pdTRUE) continue;
+        self->execute(op);
+        xQueueReceive(self->drawQueue, &op, 0);
+      }
+    }
+    #endif
+    // returns once all submitted operations are on the display, the display object may be replaced then
+    void waitIdle() {
+      #ifdef FLD_ESP32_USE_THREADS
+      while (drawQueue && uxQueueMessagesWaiting(drawQueue)) delay(1);
+      #endif
+    }
+
+    /**
+     * Draws a glyph unless the tiles it covers already show it.
+     * scale: 0 1x1, 1 1x2, 2 2x2 (of the font's own tile size)
+     */
+    void drawCachedGlyph(uint8_t col, uint8_t row, uint8_t glyph, const uint8_t *font, uint8_t scale) {
+      uint8_t slot = 0;
+      while (slot < 4 && cacheFonts[slot] && cacheFonts[slot] != font) slot++;
+      bool changed = (slot == 4); // more fonts than slots, not cached
+      if (slot < 4) cacheFonts[slot] = font;
+      uint8_t w = pgm_read_byte(font + 2) * (scale == 2 ? 2 : 1); // u8x8 fonts: first, last, tile width, tile height
+      uint8_t h = pgm_read_byte(font + 3) * (scale ? 2 : 1);
+      for (uint8_t dy = 0; dy < h && row + dy < FLD_MAX_ROWS; dy++) {
+        for (uint8_t dx = 0; dx < w && col + dx < FLD_MAX_COLS; dx++) {
+          uint16_t code = glyph | ((slot & 0x03) << 8) | (scale << 10) | ((dx & 0x03) << 12) | ((dy & 0x03) << 14);
+          if (tileCache[row + dy][col + dx] == code) continue;
+          tileCache[row + dy][col + dx] = code;
+          changed = true;
+        }
+      }
+      if (changed) submit(FLD_OP_GLYPH, glyph, col, row, scale, font);
+    }
+
     /**
      * Wrappers for screen drawing
      */
     void setFlipMode(uint8_t mode) {
       if (type==NONE) return;
-      u8x8->setFlipMode(mode);
+      memset(tileCache, 0, sizeof(tileCache)); // content has to be redrawn the other way round
+      submit(FLD_OP_FLIP, mode);
     }
     void setContrast(uint8_t contrast) {
       if (type==NONE) return;
-      u8x8->setContrast(contrast);
+      submit(FLD_OP_CONTRAST, contrast);
     }
     void drawString(uint8_t col, uint8_t row, const char *string, bool ignoreLH=false) {
       if (type==NONE) return;
-      u8x8->setFont(u8x8_font_chroma48medium8_r);
-      if (!ignoreLH && lineHeight==2) u8x8->draw1x2String(col, row, string);
-      else                            u8x8->drawString(col, row, string);
+      uint8_t scale = (!ignoreLH && lineHeight==2) ? 1 : 0;
+      for (; *string && col < FLD_MAX_COLS; string++, col++) drawCachedGlyph(col, row, *string, u8x8_font_chroma48medium8_r, scale);
     }
     void draw2x2String(uint8_t col, uint8_t row, const char *string) {
       if (type==NONE) return;
-      u8x8->setFont(u8x8_font_chroma48medium8_r);
-      u8x8->draw2x2String(col, row, string);
+      for (; *string && col < FLD_MAX_COLS; string++, col += 2) drawCachedGlyph(col, row, *string, u8x8_font_chroma48medium8_r, 2);
     }
     void drawGlyph(uint8_t col, uint8_t row, char glyph, const uint8_t *font, bool ignoreLH=false) {
       if (type==NONE) return;
-      u8x8->setFont(font);
-      if (!ignoreLH && lineHeight==2) u8x8->draw1x2Glyph(col, row, glyph);
-      else                            u8x8->drawGlyph(col, row, glyph);
+      drawCachedGlyph(col, row, glyph, font, (!ignoreLH && lineHeight==2) ? 1 : 0);
     }
     uint8_t getCols() {
       if (type==NONE) return 0;
@@ -306,11 +410,12 @@ class FourLineDisplayUsermod : public Usermod {
     }
     void clear() {
       if (type==NONE) return;
-      u8x8->clear();
+      memset(tileCache, 0, sizeof(tileCache));
+      submit(FLD_OP_CLEAR);
     }
     void setPowerSave(uint8_t save) {
       if (type==NONE) return;
-      u8x8->setPowerSave(save);
+      submit(FLD_OP_POWERSAVE, save);
     }
 
     void center(String &line, uint8_t width) {
@@ -732,6 +837,7 @@ class FourLineDisplayUsermod : public Usermod {
         bool pinsChanged = false;
         for (byte i=0; i<5; i++) if (ioPin[i] != newPin[i]) { pinsChanged = true; break; }
         if (pinsChanged || type!=newType) {
+          waitIdle();
           if (type != NONE) delete u8x8;
           for (byte i=0; i<5; i++) {
             if (ioPin[i]>=0) pinManager.deallocatePin(ioPin[i], PinOwner::UM_FourLineDisplay);
@@ -744,6 +850,7 @@ class FourLineDisplayUsermod : public Usermod {
           setup();
           needsRedraw |= true;
         }
+        waitIdle();
         if (!(type == SSD1306_SPI || type == SSD1306_SPI64)) u8x8->setBusClock(ioFrequency); // can be used for SPI too
         setContrast(contrast);
         setFlipMode(flip);
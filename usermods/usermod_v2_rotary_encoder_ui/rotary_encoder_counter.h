@@ -0,0 +1,121 @@
+#pragma once
+
+#include "wled.h"
+#ifdef ARDUINO_ARCH_ESP32
+#include <driver/pcnt.h>
+#endif
+
+//
+// Quadrature step counter for the rotary encoder usermods.
+// Transitions of the encoder pins are counted independently of loop() timing,
+// by the PCNT unit on ESP32 (with its glitch filter) and by pin change interrupts on ESP8266.
+// loop() takes the detents turned since its last call with readSteps().
+// Clockwise is A falling while B is high.
+//
+
+#ifndef ENCODER_TRANSITIONS_PER_STEP
+#define ENCODER_TRANSITIONS_PER_STEP 4   // one full quadrature cycle per detent
+#endif
+
+#ifndef ENCODER_PCNT_UNIT
+#define ENCODER_PCNT_UNIT PCNT_UNIT_0
+#endif
+#define ENCODER_PCNT_LIMIT 32000         // the unit restarts from 0 at this count
+
+class RotaryEncoderCounter {
+private:
+  int8_t pinA = -1;
+  int8_t pinB = -1;
+  int32_t residual = 0;                  // transitions not making up a full step yet
+#ifdef ARDUINO_ARCH_ESP32
+  int16_t lastCount = 0;
+#else
+  volatile int32_t transitions = 0;
+  volatile uint8_t state = 0;            // A << 1 | B
+
+  static void IRAM_ATTR pinChange(void* arg) {
+    // +1 clockwise, -1 counter-clockwise, 0 for bounces and missed states
+    static const int8_t table[16] = { 0,-1, 1, 0, 1, 0, 0,-1,-1, 0, 0, 1, 0, 1,-1, 0 };
+    RotaryEncoderCounter* e = (RotaryEncoderCounter*)arg;
+    uint8_t s = (digitalRead(e->pinA) << 1) | digitalRead(e->pinB);
+    e->transitions += table[(e->state << 2) | s];
+    e->state = s;
+  }
+#endif
+
+  // transitions since the last call
+  int32_t readTransitions() {
+#ifdef ARDUINO_ARCH_ESP32
+    int16_t count = 0;
+    pcnt_get_counter_value(ENCODER_PCNT_UNIT, &count);
+    int32_t delta = count - lastCount;
+    lastCount = count;
+    if (delta >  ENCODER_PCNT_LIMIT/2) delta -= ENCODER_PCNT_LIMIT; // the unit restarted at a limit
+    if (delta < -ENCODER_PCNT_LIMIT/2) delta += ENCODER_PCNT_LIMIT;
+    return delta;
+#else
+    noInterrupts();
+    int32_t delta = transitions;
+    transitions = 0;
+    interrupts();
+    return delta;
+#endif
+  }
+
+public:
+  void begin(int8_t a, int8_t b) {
+    pinA = a; pinB = b;
+    residual = 0;
+#ifdef ARDUINO_ARCH_ESP32
+    // channel 0 counts the edges of A, channel 1 those of B, the other pin sets the direction
+    pcnt_config_t cfg = {};
+    cfg.unit = ENCODER_PCNT_UNIT;
+    cfg.counter_h_lim = ENCODER_PCNT_LIMIT;
+    cfg.counter_l_lim = -ENCODER_PCNT_LIMIT;
+    cfg.hctrl_mode = PCNT_MODE_KEEP;
+    cfg.lctrl_mode = PCNT_MODE_REVERSE;
+    cfg.channel = PCNT_CHANNEL_0;
+    cfg.pulse_gpio_num = pinA;
+    cfg.ctrl_gpio_num = pinB;
+    cfg.pos_mode = PCNT_COUNT_DEC;
+    cfg.neg_mode = PCNT_COUNT_INC;
+    pcnt_unit_config(&cfg);
+    cfg.channel = PCNT_CHANNEL_1;
+    cfg.pulse_gpio_num = pinB;
+    cfg.ctrl_gpio_num = pinA;
+    cfg.pos_mode = PCNT_COUNT_INC;
+    cfg.neg_mode = PCNT_COUNT_DEC;
+    pcnt_unit_config(&cfg);
+    pcnt_set_filter_value(ENCODER_PCNT_UNIT, 1023);              // ignore pulses shorter than ~13us
+    pcnt_filter_enable(ENCODER_PCNT_UNIT);
+    pcnt_counter_clear(ENCODER_PCNT_UNIT);
+    pcnt_counter_resume(ENCODER_PCNT_UNIT);
+    lastCount = 0;
+#else
+    state = (digitalRead(pinA) << 1) | digitalRead(pinB);
+    transitions = 0;
+    attachInterruptArg(digitalPinToInterrupt(pinA), pinChange, this, CHANGE);
+    attachInterruptArg(digitalPinToInterrupt(pinB), pinChange, this, CHANGE);
+#endif
+  }
+
+  void end() {
+    if (pinA < 0) return;
+#ifdef ARDUINO_ARCH_ESP32
+    pcnt_counter_pause(ENCODER_PCNT_UNIT);
+#else
+    detachInterrupt(digitalPinToInterrupt(pinA));
+    detachInterrupt(digitalPinToInterrupt(pinB));
+#endif
+    pinA = pinB = -1;
+  }
+
+  // detents turned since the last call, positive clockwise
+  int16_t readSteps() {
+    if (pinA < 0) return 0;
+    residual += readTransitions();
+    int16_t steps = residual / ENCODER_TRANSITIONS_PER_STEP;
+    residual -= steps * ENCODER_TRANSITIONS_PER_STEP;
+    return steps;
+  }
+};
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "wled.h"
+#include "rotary_encoder_counter.h"
 
 //
 // Inspired by the v1 usermods
@@ -72,9 +73,7 @@ private:
   byte *modes_alpha_indexes = nullptr;
   byte *palettes_alpha_indexes = nullptr;
 
-  unsigned char Enc_A;
-  unsigned char Enc_B;
-  unsigned char Enc_A_prev = 0;
+  RotaryEncoderCounter encoder;     // steps counted in the background
 
   bool currentEffectAndPaletteInitialized = false;
   uint8_t effectCurrentIndex = 0;
@@ -112,6 +111,7 @@ public:
     pinMode(pinA, INPUT_PULLUP);
     pinMode(pinB, INPUT_PULLUP);
     pinMode(pinC, INPUT_PULLUP);
+    encoder.begin(pinA, pinB);
     currentTime = millis();
     loopTime = currentTime;
 
@@ -205,56 +205,34 @@ public:
           prev_button_state = button_state;
         }
       }
-      int Enc_A = digitalRead(pinA); // Read encoder pins
-      int Enc_B = digitalRead(pinB);
-      if ((!Enc_A) && (Enc_A_prev))
-      { // A has gone from high to low
-        if (Enc_B == HIGH)
-        { // B is high so clockwise
-          switch(select_state) {
-            case 0:
-              changeBrightness(true);
-              break;
-            case 1:
-              changeEffect(true);
-              break;
-            case 2:
-              changeEffectSpeed(true);
-              break;
-            case 3:
-              changeEffectIntensity(true);
-              break;
-            case 4:
-              changePalette(true);
-              break;
-          }
-        }
-        else if (Enc_B == LOW)
-        { // B is low so counter-clockwise
-          switch(select_state) {
-            case 0:
-              changeBrightness(false);
-              break;
-            case 1:
-              changeEffect(false);
-              break;
-            case 2:
-              changeEffectSpeed(false);
-              break;
-            case 3:
-              changeEffectIntensity(false);
-              break;
-            case 4:
-              changePalette(false);
-              break;
-          }
-        }
+      // all steps turned since the last check, however long loop() took
+      for (int16_t steps = encoder.readSteps(); steps; steps += (steps > 0) ? -1 : 1) {
+        encoderStep(steps > 0);
       }
-      Enc_A_prev = Enc_A;     // Store value of A for next time
       loopTime = currentTime; // Updates loopTime
     }
   }
 
+  void encoderStep(bool clockwise) {
+    switch(select_state) {
+      case 0:
+        changeBrightness(clockwise);
+        break;
+      case 1:
+        changeEffect(clockwise);
+        break;
+      case 2:
+        changeEffectSpeed(clockwise);
+        break;
+      case 3:
+        changeEffectIntensity(clockwise);
+        break;
+      case 4:
+        changePalette(clockwise);
+        break;
+    }
+  }
+
   void findCurrentEffectAndPalette() {
     currentEffectAndPaletteInitialized = true;
     for (uint8_t i = 0; i < strip.getModeCount(); i++) {
@@ -463,6 +441,7 @@ public:
       DEBUG_PRINTLN(F(" config (re)loaded."));
       // changing parameters from settings page
       if (pinA!=newDTpin || pinB!=newCLKpin || pinC!=newSWpin) {
+        encoder.end();
         pinManager.deallocatePin(pinA, PinOwner::UM_RotaryEncoderUI);
         pinManager.deallocatePin(pinB, PinOwner::UM_RotaryEncoderUI);
         pinManager.deallocatePin(pinC, PinOwner::UM_RotaryEncoderUI);
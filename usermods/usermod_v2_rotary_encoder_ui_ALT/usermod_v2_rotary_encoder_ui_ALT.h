@@ -1,6 +1,7 @@
 #pragma once
 
 #include "wled.h"
+#include "../usermod_v2_rotary_encoder_ui/rotary_encoder_counter.h"
 
 //
 // Inspired by the original v2 usermods
@@ -75,9 +76,7 @@ private:
   byte *modes_alpha_indexes = nullptr;
   byte *palettes_alpha_indexes = nullptr;
 
-  unsigned char Enc_A;
-  unsigned char Enc_B;
-  unsigned char Enc_A_prev = 0;
+  RotaryEncoderCounter encoder;     // steps counted in the background
 
   bool currentEffectAndPaletteInitialized = false;
   uint8_t effectCurrentIndex = 0;
@@ -117,6 +116,7 @@ public:
     pinMode(pinA, INPUT_PULLUP);
     pinMode(pinB, INPUT_PULLUP);
     pinMode(pinC, INPUT_PULLUP);
+    encoder.begin(pinA, pinB);
     currentTime = millis();
     loopTime = currentTime;
 
@@ -134,9 +134,6 @@ public:
 #endif
 
     initDone = true;
-    Enc_A = digitalRead(pinA); // Read encoder pins
-    Enc_B = digitalRead(pinB);
-    Enc_A_prev = Enc_A;
   }
 
   /*
@@ -226,68 +223,40 @@ public:
       
       if (!prev_button_state && (millis()-buttonHoldTIme > 3000) && !networkShown) displayNetworkInfo(); //long press for network info
 
-      Enc_A = digitalRead(pinA); // Read encoder pins
-      Enc_B = digitalRead(pinB);
-      if ((Enc_A) && (!Enc_A_prev))
-      { // A has gone from high to low
-        if (Enc_B == LOW)    //changes to LOW so that then encoder registers a change at the very end of a pulse
-        { // B is high so clockwise
-          switch(select_state) {
-            case 0:
-              changeBrightness(true);
-              break;
-            case 1:
-              changeEffectSpeed(true);
-              break;
-            case 2:
-              changeEffectIntensity(true);
-              break;
-            case 3:
-              changePalette(true);
-              break;
-            case 4:
-              changeEffect(true);
-              break;
-            case 5:
-              changeHue(true);
-              break;
-            case 6:
-              changeSat(true);
-              break;
-          }
-        }
-        else if (Enc_B == HIGH)
-        { // B is low so counter-clockwise
-          switch(select_state) {
-            case 0:
-              changeBrightness(false);
-              break;
-            case 1:
-              changeEffectSpeed(false);
-              break;
-            case 2:
-              changeEffectIntensity(false);
-              break;
-            case 3:
-              changePalette(false);
-              break;
-            case 4:
-              changeEffect(false);
-              break;
-            case 5:
-              changeHue(false);
-              break;
-            case 6:
-              changeSat(false);
-              break;
-          }
-        }
+      // all steps turned since the last check, however long loop() took
+      for (int16_t steps = encoder.readSteps(); steps; steps += (steps > 0) ? -1 : 1) {
+        encoderStep(steps > 0);
       }
-      Enc_A_prev = Enc_A;     // Store value of A for next time
       loopTime = currentTime; // Updates loopTime
     }
   }
 
+  void encoderStep(bool clockwise) {
+    switch(select_state) {
+      case 0:
+        changeBrightness(clockwise);
+        break;
+      case 1:
+        changeEffectSpeed(clockwise);
+        break;
+      case 2:
+        changeEffectIntensity(clockwise);
+        break;
+      case 3:
+        changePalette(clockwise);
+        break;
+      case 4:
+        changeEffect(clockwise);
+        break;
+      case 5:
+        changeHue(clockwise);
+        break;
+      case 6:
+        changeSat(clockwise);
+        break;
+    }
+  }
+
   void displayNetworkInfo(){
     #ifdef USERMOD_FOUR_LINE_DISPLAY
     display->networkOverlay("  NETWORK INFO", 15000);
@@ -534,6 +503,7 @@ public:
       DEBUG_PRINTLN(F(" config (re)loaded."));
       // changing parameters from settings page
       if (pinA!=newDTpin || pinB!=newCLKpin || pinC!=newSWpin) {
+        encoder.end();
         pinManager.deallocatePin(pinA, PinOwner::UM_RotaryEncoderUI);
         pinManager.deallocatePin(pinB, PinOwner::UM_RotaryEncoderUI);
         pinManager.deallocatePin(pinC, PinOwner::UM_RotaryEncoderUI);
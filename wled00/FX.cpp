@@ -479,7 +479,7 @@ uint16_t WS2812FX::mode_twinkle(void) {
     if (SEGENV.aux0 >= maxOn)
     {
       SEGENV.aux0 = 0;
-      SEGENV.aux1 = random16(); //new seed for our PRNG
+      SEGENV.aux1 = SEGENV.rand16(); //new seed for our PRNG
     }
     SEGENV.aux0++;
     SEGENV.step = it;
@@ -1648,7 +1648,7 @@ uint16_t WS2812FX::mode_juggle(void){
   for ( byte i = 0; i < 8; i++) {
     uint16_t index = 0 + beatsin88((128 + SEGMENT.speed)*(i + 7), 0, SEGLEN -1);
     fastled_col = col_to_crgb(getPixelColor(index));
-    fastled_col |= (SEGMENT.palette==0)?CHSV(dothue, 220, 255):ColorFromPalette(currentPalette, dothue, 255);
+    fastled_col |= (SEGMENT.palette==0)?CHSV(dothue, 220, 255):palette_color(dothue, 255);
     setPixelColor(index, fastled_col.red, fastled_col.green, fastled_col.blue);
     dothue += 32;
   }
@@ -1720,9 +1720,13 @@ uint16_t WS2812FX::mode_fire_2012()
   {
     uint8_t ignition = max(7,SEGLEN/10);  // ignition area: 10% of segment length or minimum 7 pixels
     
-    // Step 1.  Cool down every cell a little
+    // Step 1.  Cool down every cell a little, one random number covers four cells
+    uint8_t coolMax = MIN((((20 + SEGMENT.speed /3) * 10) / SEGLEN) + 2, 255);
+    uint32_t r = 0;
     for (uint16_t i = 0; i < SEGLEN; i++) {
-      uint8_t temp = qsub8(heat[i], random8(0, (((20 + SEGMENT.speed /3) * 10) / SEGLEN) + 2));
+      if (!(i & 0x03)) r = SEGENV.rand32();
+      uint8_t temp = qsub8(heat[i], ((r & 0xFF) * coolMax) >> 8);
+      r >>= 8;
       heat[i] = (temp==0 && i<ignition) ? 16 : temp; // prevent ignition area from becoming black
     }
   
@@ -1732,16 +1736,16 @@ uint16_t WS2812FX::mode_fire_2012()
     }
     
     // Step 3.  Randomly ignite new 'sparks' of heat near the bottom
-    if (random8() <= SEGMENT.intensity) {
-      uint8_t y = random8(ignition);
-      if (y < SEGLEN) heat[y] = qadd8(heat[y], random8(160,255));
+    if (SEGENV.rand8() <= SEGMENT.intensity) {
+      uint8_t y = SEGENV.rand8(ignition);
+      if (y < SEGLEN) heat[y] = qadd8(heat[y], SEGENV.rand8(160,255));
     }
     SEGENV.step = it;
   }
 
   // Step 4.  Map from heat cells to LED colors
   for (uint16_t j = 0; j < SEGLEN; j++) {
-    CRGB color = ColorFromPalette(currentPalette, MIN(heat[j],240), 255, LINEARBLEND);
+    CRGB color = palette_color(MIN(heat[j],240), 255);
     setPixelColor(j, color.red, color.green, color.blue);
   }
   return FRAMETIME;
@@ -1787,7 +1791,7 @@ uint16_t WS2812FX::mode_colorwaves()
     uint8_t bri8 = (uint32_t)(((uint32_t)bri16) * brightdepth) / 65536;
     bri8 += (255 - brightdepth);
 
-    CRGB newcolor = ColorFromPalette(currentPalette, hue8, bri8);
+    CRGB newcolor = palette_color(hue8, bri8);
     fastled_col = col_to_crgb(getPixelColor(i));
 
     nblend(fastled_col, newcolor, 128);
@@ -1806,7 +1810,7 @@ uint16_t WS2812FX::mode_bpm()
   uint32_t stp = (now / 20) & 0xFF;
   uint8_t beat = beatsin8(SEGMENT.speed, 64, 255);
   for (uint16_t i = 0; i < SEGLEN; i++) {
-    fastled_col = ColorFromPalette(currentPalette, stp + (i * 2), beat - stp + (i * 10));
+    fastled_col = palette_color(stp + (i * 2), beat - stp + (i * 10));
     setPixelColor(i, fastled_col.red, fastled_col.green, fastled_col.blue);
   }
   return FRAMETIME;
@@ -1816,12 +1820,12 @@ uint16_t WS2812FX::mode_bpm()
 uint16_t WS2812FX::mode_fillnoise8()
 {
   if (SEGENV.call == 0) SEGENV.step = random16(12345);
-  CRGB fastled_col;
-  for (uint16_t i = 0; i < SEGLEN; i++) {
-    uint8_t index = inoise8(i * SEGLEN, SEGENV.step + i * SEGLEN);
-    fastled_col = ColorFromPalette(currentPalette, index, 255, LINEARBLEND);
+  uint16_t len = SEGLEN, stp = SEGENV.step;
+  forEachNoise([&](uint16_t i) -> int32_t { return inoise8(i * len, stp + i * len); },
+               [&](uint16_t i, int32_t index) {
+    CRGB fastled_col = palette_color(index, 255);
     setPixelColor(i, fastled_col.red, fastled_col.green, fastled_col.blue);
-  }
+  });
   SEGENV.step += beatsin8(SEGMENT.speed, 1, 6); //10,1,4
 
   return FRAMETIME;
@@ -1830,26 +1834,22 @@ uint16_t WS2812FX::mode_fillnoise8()
 uint16_t WS2812FX::mode_noise16_1()
 {
   uint16_t scale = 320;                                      // the "zoom factor" for the noise
-  CRGB fastled_col;
   SEGENV.step += (1 + SEGMENT.speed/16);
 
-  for (uint16_t i = 0; i < SEGLEN; i++) {
-
-    uint16_t shift_x = beatsin8(11);                           // the x position of the noise field swings @ 17 bpm
-    uint16_t shift_y = SEGENV.step/42;             // the y position becomes slowly incremented
-
-
-    uint16_t real_x = (i + shift_x) * scale;                  // the x position of the noise field swings @ 17 bpm
-    uint16_t real_y = (i + shift_y) * scale;                  // the y position becomes slowly incremented
-    uint32_t real_z = SEGENV.step;                          // the z position becomes quickly incremented
-
-    uint8_t noise = inoise16(real_x, real_y, real_z) >> 8;   // get the noise data and scale it down
+  uint16_t shift_x = beatsin8(11);                           // the x position of the noise field swings @ 17 bpm
+  uint16_t shift_y = SEGENV.step/42;                         // the y position becomes slowly incremented
+  uint32_t real_z = SEGENV.step;                             // the z position becomes quickly incremented
 
+  forEachNoise([&](uint16_t i) -> int32_t {
+    uint16_t real_x = (i + shift_x) * scale;
+    uint16_t real_y = (i + shift_y) * scale;
+    return inoise16(real_x, real_y, real_z) >> 8;            // get the noise data and scale it down
+  }, [&](uint16_t i, int32_t noise) {
     uint8_t index = sin8(noise * 3);                         // map LED color based on noise data
 
-    fastled_col = ColorFromPalette(currentPalette, index, 255, LINEARBLEND);   // With that value, look up the 8 bit colour palette value and assign it to the current LED.
+    CRGB fastled_col = palette_color(index, 255);   // With that value, look up the 8 bit colour palette value and assign it to the current LED.
     setPixelColor(i, fastled_col.red, fastled_col.green, fastled_col.blue);
-  }
+  });
 
   return FRAMETIME;
 }
@@ -1858,22 +1858,19 @@ uint16_t WS2812FX::mode_noise16_1()
 uint16_t WS2812FX::mode_noise16_2()
 {
   uint16_t scale = 1000;                                       // the "zoom factor" for the noise
-  CRGB fastled_col;
   SEGENV.step += (1 + (SEGMENT.speed >> 1));
 
-  for (uint16_t i = 0; i < SEGLEN; i++) {
-
-    uint16_t shift_x = SEGENV.step >> 6;                         // x as a function of time
+  uint16_t shift_x = SEGENV.step >> 6;                         // x as a function of time
 
+  forEachNoise([&](uint16_t i) -> int32_t {
     uint32_t real_x = (i + shift_x) * scale;                  // calculate the coordinates within the noise field
-
-    uint8_t noise = inoise16(real_x, 0, 4223) >> 8;    // get the noise data and scale it down
-
+    return inoise16(real_x, 0, 4223) >> 8;                     // get the noise data and scale it down
+  }, [&](uint16_t i, int32_t noise) {
     uint8_t index = sin8(noise * 3);                          // map led color based on noise data
 
-    fastled_col = ColorFromPalette(currentPalette, index, noise, LINEARBLEND);   // With that value, look up the 8 bit colour palette value and assign it to the current LED.
+    CRGB fastled_col = palette_color(index, noise);   // With that value, look up the 8 bit colour palette value and assign it to the current LED.
     setPixelColor(i, fastled_col.red, fastled_col.green, fastled_col.blue);
-  }
+  });
 
   return FRAMETIME;
 }
@@ -1882,25 +1879,22 @@ uint16_t WS2812FX::mode_noise16_2()
 uint16_t WS2812FX::mode_noise16_3()
 {
   uint16_t scale = 800;                                       // the "zoom factor" for the noise
-  CRGB fastled_col;
   SEGENV.step += (1 + SEGMENT.speed);
 
-  for (uint16_t i = 0; i < SEGLEN; i++) {
-
-    uint16_t shift_x = 4223;                                  // no movement along x and y
-    uint16_t shift_y = 1234;
+  uint16_t shift_x = 4223;                                    // no movement along x and y
+  uint16_t shift_y = 1234;
+  uint32_t real_z = SEGENV.step*8;
 
+  forEachNoise([&](uint16_t i) -> int32_t {
     uint32_t real_x = (i + shift_x) * scale;                  // calculate the coordinates within the noise field
     uint32_t real_y = (i + shift_y) * scale;                  // based on the precalculated positions
-    uint32_t real_z = SEGENV.step*8;  
-
-    uint8_t noise = inoise16(real_x, real_y, real_z) >> 8;    // get the noise data and scale it down
-
+    return inoise16(real_x, real_y, real_z) >> 8;             // get the noise data and scale it down
+  }, [&](uint16_t i, int32_t noise) {
     uint8_t index = sin8(noise * 3);                          // map led color based on noise data
 
-    fastled_col = ColorFromPalette(currentPalette, index, noise, LINEARBLEND);   // With that value, look up the 8 bit colour palette value and assign it to the current LED.
+    CRGB fastled_col = palette_color(index, noise);   // With that value, look up the 8 bit colour palette value and assign it to the current LED.
     setPixelColor(i, fastled_col.red, fastled_col.green, fastled_col.blue);
-  }
+  });
 
   return FRAMETIME;
 }
@@ -1909,13 +1903,12 @@ uint16_t WS2812FX::mode_noise16_3()
 //https://github.com/aykevl/ledstrip-spark/blob/master/ledstrip.ino
 uint16_t WS2812FX::mode_noise16_4()
 {
-  CRGB fastled_col;
   uint32_t stp = (now * SEGMENT.speed) >> 7;
-  for (uint16_t i = 0; i < SEGLEN; i++) {
-    int16_t index = inoise16(uint32_t(i) << 12, stp);
-    fastled_col = ColorFromPalette(currentPalette, index);
+  forEachNoise([&](uint16_t i) -> int32_t { return inoise16(uint32_t(i) << 12, stp); },
+               [&](uint16_t i, int32_t index) {
+    CRGB fastled_col = palette_color(index);
     setPixelColor(i, fastled_col.red, fastled_col.green, fastled_col.blue);
-  }
+  });
   return FRAMETIME;
 }
 
@@ -1986,7 +1979,7 @@ uint16_t WS2812FX::mode_lake() {
   {
     int index = cos8((i*15)+ wave1)/2 + cubicwave8((i*23)+ wave2)/2;           
     uint8_t lum = (index > wave3) ? index - wave3 : 0;
-    fastled_col = ColorFromPalette(currentPalette, map(index,0,255,0,240), lum, LINEARBLEND);
+    fastled_col = palette_color(map(index,0,255,0,240), lum);
     setPixelColor(i, fastled_col.red, fastled_col.green, fastled_col.blue);
   }
   return FRAMETIME;
@@ -2486,10 +2479,11 @@ uint16_t WS2812FX::mode_spots_fade()
 
 
 //each needs 12 bytes
+//velocity and height are 16.16 fixed point
 typedef struct Ball {
   unsigned long lastBounceTime;
-  float impactVelocity;
-  float height;
+  int32_t impactVelocity;
+  int32_t height;
 } ball;
 
 /*
@@ -2505,10 +2499,10 @@ uint16_t WS2812FX::mode_bouncing_balls(void) {
   
   // number of balls based on intensity setting to max of 7 (cycles colors)
   // non-chosen color is a random color
-  uint8_t numBalls = int(((SEGMENT.intensity * (maxNumBalls - 0.8f)) / 255) + 1);
+  uint8_t numBalls = (SEGMENT.intensity * (maxNumBalls * 10 - 8)) / 2550 + 1;
   
-  float gravity                           = -9.81; // standard value of gravity
-  float impactVelocityStart               = sqrt( -2 * gravity);
+  const int32_t halfGravity               = 321454; // 9.81 / 2, standard value of gravity
+  const int32_t impactVelocityStart       = 290263; // sqrt(2 * 9.81)
 
   unsigned long time = millis();
 
@@ -2520,17 +2514,18 @@ uint16_t WS2812FX::mode_bouncing_balls(void) {
   fill(hasCol2 ? BLACK : SEGCOLOR(1));
   
   for (uint8_t i = 0; i < numBalls; i++) {
-    float timeSinceLastBounce = (time - balls[i].lastBounceTime)/((255-SEGMENT.speed)*8/256 +1);
-    balls[i].height = 0.5 * gravity * pow(timeSinceLastBounce/1000 , 2.0) + balls[i].impactVelocity * timeSinceLastBounce/1000;
+    int32_t timeSinceLastBounce = (time - balls[i].lastBounceTime)/((255-SEGMENT.speed)*8/256 +1);
+    if (timeSinceLastBounce > 2000) timeSinceLastBounce = 2000; //long since hit the ground, keeps the math below in 32 bit
+    balls[i].height = timeSinceLastBounce * (balls[i].impactVelocity - halfGravity * timeSinceLastBounce / 1000) / 1000;
 
     if (balls[i].height < 0) { //start bounce
       balls[i].height = 0;
       //damping for better effect using multiple balls
-      float dampening = 0.90 - float(i)/pow(numBalls,2);
-      balls[i].impactVelocity = dampening * balls[i].impactVelocity;
+      uint32_t dampening = 58982 - (uint32_t(i) << 16) / (numBalls * numBalls); // 0.90 - i/numBalls^2
+      balls[i].impactVelocity = (uint32_t(balls[i].impactVelocity) * (dampening >> 4)) >> 12;
       balls[i].lastBounceTime = time;
 
-      if (balls[i].impactVelocity < 0.015) {
+      if (balls[i].impactVelocity < 983) { // 0.015
         balls[i].impactVelocity = impactVelocityStart;
       }
     }
@@ -2542,7 +2537,7 @@ uint16_t WS2812FX::mode_bouncing_balls(void) {
       color = SEGCOLOR(i % NUM_COLORS);
     }
 
-    uint16_t pos = round(balls[i].height * (SEGLEN - 1));
+    uint16_t pos = (uint32_t(balls[i].height) * (SEGLEN - 1) + 0x8000) >> 16;
     setPixelColor(pos, color);
   }
 
@@ -2614,14 +2609,71 @@ uint16_t WS2812FX::mode_glitter()
 
 
 
-//each needs 12 bytes
-//Spark type is used for popcorn, 1D fireworks, and drip
-typedef struct Spark {
-  float pos;
-  float vel;
-  uint16_t col;
-  uint8_t colIndex;
-} spark;
+/*
+ * Particles of the physics effects (popcorn, 1D fireworks, drip), kept in SEGENV.data as one array
+ * per field instead of an array of structs: no padding per particle and the bulk updates walk
+ * contiguous memory. pos and vel are 16.16 fixed point, in pixels and pixels per frame,
+ * a negative pos marks an inactive particle. col (brightness or heat) and state are up to the effect.
+ */
+#define PARTICLE_BYTES 11
+class Particles {
+  public:
+    int32_t*  pos;
+    int32_t*  vel;
+    uint16_t* col;
+    uint8_t*  state;
+    uint16_t  count;
+
+    static uint16_t dataSize(uint16_t n) { return n * PARTICLE_BYTES; }
+    //n must be the count the data was allocated for, the arrays follow each other
+    Particles(byte* data, uint16_t n) : count(n) {
+      pos = reinterpret_cast<int32_t*>(data);
+      vel = pos + n;
+      col = reinterpret_cast<uint16_t*>(vel + n);
+      state = reinterpret_cast<uint8_t*>(col + n);
+    }
+
+    inline bool active(uint16_t i) { return pos[i] >= 0; }
+    inline int16_t pixel(uint16_t i) { return pos[i] >> 16; }
+    void launch(uint16_t i, int32_t p, int32_t v, uint16_t c, uint8_t st) {
+      pos[i] = p; vel[i] = v; col[i] = c; state[i] = st;
+    }
+    //one frame of motion (gravity is negative)
+    inline void move(uint16_t i, int32_t gravity) {
+      pos[i] += vel[i];
+      vel[i] += gravity;
+    }
+    //moves the active particles first to last-1
+    void moveAll(int32_t gravity, uint16_t first, uint16_t last) {
+      for (uint16_t i = first; i < last; i++) if (pos[i] >= 0) move(i, gravity);
+    }
+    //dims particles first to last-1 that are at least amount bright
+    void fadeAll(uint16_t amount, uint16_t first, uint16_t last) {
+      for (uint16_t i = first; i < last; i++) if (col[i] >= amount) col[i] -= amount;
+    }
+};
+
+//integer square root, only used when a spark is launched
+static uint32_t isqrt64(uint64_t x) {
+  uint64_t res = 0;
+  uint64_t bit = 1ULL << 62;
+  while (bit > x) bit >>= 2;
+  while (bit) {
+    if (x >= res + bit) {
+      x -= res + bit;
+      res = (res >> 1) + bit;
+    } else {
+      res >>= 1;
+    }
+    bit >>= 2;
+  }
+  return res;
+}
+
+//(num / denom) * SEGLEN pixels per frame^2 in 16.16 fixed point, positive
+#define SPARK_GRAVITY(num, denom) int32_t(((uint64_t)(num) * SEGLEN << 16) / (denom))
+//launch velocity that lets a spark rise peakHeight pixels against gravity
+#define SPARK_LAUNCH_VEL(gravity, peakHeight) int32_t(isqrt64((uint64_t)(-(gravity)) * (peakHeight) << 17))
 
 /*
 *  POPCORN
@@ -2630,13 +2682,11 @@ typedef struct Spark {
 uint16_t WS2812FX::mode_popcorn(void) {
   //allocate segment data
   uint16_t maxNumPopcorn = 21; // max 21 on 16 segment ESP8266
-  uint16_t dataSize = sizeof(spark) * maxNumPopcorn;
-  if (!SEGENV.allocateData(dataSize)) return mode_static(); //allocation failed
+  if (!SEGENV.allocateData(Particles::dataSize(maxNumPopcorn))) return mode_static(); //allocation failed
   
-  Spark* popcorn = reinterpret_cast<Spark*>(SEGENV.data);
+  Particles popcorn(SEGENV.data, maxNumPopcorn);
 
-  float gravity = -0.0001 - (SEGMENT.speed/200000.0); // m/s/s
-  gravity *= SEGLEN;
+  int32_t gravity = -SPARK_GRAVITY(20 + SEGMENT.speed, 200000); // -0.0001 - speed/200000
 
   bool hasCol2 = SEGCOLOR(2);
   fill(hasCol2 ? BLACK : SEGCOLOR(1));
@@ -2645,32 +2695,28 @@ uint16_t WS2812FX::mode_popcorn(void) {
   if (numPopcorn == 0) numPopcorn = 1;
 
   for(uint8_t i = 0; i < numPopcorn; i++) {
-    bool isActive = popcorn[i].pos >= 0.0f;
-
-    if (isActive) { // if kernel is active, update its position
-      popcorn[i].pos += popcorn[i].vel;
-      popcorn[i].vel += gravity;
-      uint32_t col = color_wheel(popcorn[i].colIndex);
-      if (!SEGMENT.palette && popcorn[i].colIndex < NUM_COLORS) col = SEGCOLOR(popcorn[i].colIndex);
+    if (popcorn.active(i)) { // if kernel is active, update its position
+      popcorn.move(i, gravity);
+      uint8_t colIndex = popcorn.state[i];
+      uint32_t col = color_wheel(colIndex);
+      if (!SEGMENT.palette && colIndex < NUM_COLORS) col = SEGCOLOR(colIndex);
       
-      uint16_t ledIndex = popcorn[i].pos;
-      if (ledIndex < SEGLEN) setPixelColor(ledIndex, col);
+      int16_t ledIndex = popcorn.pixel(i);
+      if (ledIndex >= 0 && ledIndex < SEGLEN) setPixelColor(ledIndex, col);
     } else { // if kernel is inactive, randomly pop it
       if (random8() < 2) { // POP!!!
-        popcorn[i].pos = 0.01f;
-        
         uint16_t peakHeight = 128 + random8(128); //0-255
         peakHeight = (peakHeight * (SEGLEN -1)) >> 8;
-        popcorn[i].vel = sqrt(-2.0 * gravity * peakHeight);
         
+        byte col;
         if (SEGMENT.palette)
         {
-          popcorn[i].colIndex = random8();
+          col = random8();
         } else {
-          byte col = random8(0, NUM_COLORS);
+          col = random8(0, NUM_COLORS);
           if (!hasCol2 || !SEGCOLOR(col)) col = 0;
-          popcorn[i].colIndex = col;
         }
+        popcorn.launch(i, 655, SPARK_LAUNCH_VEL(gravity, peakHeight), 0, col); // 0.01
       }
     }
   }
@@ -2781,20 +2827,21 @@ uint16_t WS2812FX::mode_candle_multi()
   #define STARBURST_MAX_FRAG  10 //60 bytes / star
 #endif
 //each needs 20+STARBURST_MAX_FRAG*4 bytes
+//vel (pixels/s) and fragment positions are 24.8 fixed point
 typedef struct particle {
   CRGB     color;
   uint32_t birth  =0;
   uint32_t last   =0;
-  float    vel    =0;
+  int32_t  vel    =0;
   uint16_t pos    =-1;
-  float    fragment[STARBURST_MAX_FRAG];
+  int32_t  fragment[STARBURST_MAX_FRAG];
 } star;
 
 uint16_t WS2812FX::mode_starburst(void) {
   uint16_t maxData = FAIR_DATA_PER_SEG; //ESP8266: 256 ESP32: 640
   uint8_t segs = getActiveSegmentsNum();
-  if (segs <= (MAX_NUM_SEGMENTS /2)) maxData *= 2; //ESP8266: 512 if <= 8 segs ESP32: 1280 if <= 16 segs
-  if (segs <= (MAX_NUM_SEGMENTS /4)) maxData *= 2; //ESP8266: 1024 if <= 4 segs ESP32: 2560 if <= 8 segs
+  if (segs <= (FAIR_NUM_SEGMENTS /2)) maxData *= 2; //ESP8266: 512 if <= 8 segs ESP32: 1280 if <= 16 segs
+  if (segs <= (FAIR_NUM_SEGMENTS /4)) maxData *= 2; //ESP8266: 1024 if <= 4 segs ESP32: 2560 if <= 8 segs
   uint16_t maxStars = maxData / sizeof(star); //ESP8266: max. 4/9/19 stars/seg, ESP32: max. 10/21/42 stars/seg
 
   uint8_t numStars = 1 + (SEGLEN >> 3);
@@ -2807,29 +2854,29 @@ uint16_t WS2812FX::mode_starburst(void) {
   
   star* stars = reinterpret_cast<star*>(SEGENV.data);
   
-  float          maxSpeed                = 375.0f;  // Max velocity
-  float          particleIgnition        = 250.0f;  // How long to "flash"
-  float          particleFadeTime        = 1500.0f; // Fade out time
+  const uint32_t maxSpeed                = 375;  // Max velocity
+  const uint32_t particleIgnition        = 250;  // How long to "flash"
+  const uint32_t particleFadeTime        = 1500; // Fade out time
      
   for (int j = 0; j < numStars; j++)
   {
     // speed to adjust chance of a burst, max is nearly always.
-    if (random8((144-(SEGMENT.speed >> 1))) == 0 && stars[j].birth == 0)
+    if (SEGENV.rand8((144-(SEGMENT.speed >> 1))) == 0 && stars[j].birth == 0)
     {
       // Pick a random color and location.  
-      uint16_t startPos = random16(SEGLEN-1);
-      float multiplier = (float)(random8())/255.0 * 1.0;
+      uint16_t startPos = SEGENV.rand16(SEGLEN-1);
+      uint32_t multiplier = SEGENV.rand8();
 
-      stars[j].color = col_to_crgb(color_wheel(random8()));
+      stars[j].color = col_to_crgb(color_wheel(SEGENV.rand8()));
       stars[j].pos = startPos; 
-      stars[j].vel = maxSpeed * (float)(random8())/255.0 * multiplier;
+      stars[j].vel = maxSpeed * SEGENV.rand8() * multiplier / 254; // (random/255)^2, x256
       stars[j].birth = it;
       stars[j].last = it;
       // more fragments means larger burst effect
-      int num = random8(3,6 + (SEGMENT.intensity >> 5));
+      int num = SEGENV.rand8(3,6 + (SEGMENT.intensity >> 5));
 
       for (int i=0; i < STARBURST_MAX_FRAG; i++) {
-        if (i < num) stars[j].fragment[i] = startPos;
+        if (i < num) stars[j].fragment[i] = int32_t(startPos) << 8;
         else stars[j].fragment[i] = -1;
       }
     }
@@ -2840,54 +2887,56 @@ uint16_t WS2812FX::mode_starburst(void) {
   for (int j=0; j<numStars; j++)
   {
     if (stars[j].birth != 0) {
-      float dt = (it-stars[j].last)/1000.0;
+      uint32_t dt = it-stars[j].last; // ms
+      if (dt > 333) dt = 333; //velocity would have decayed to nothing anyway
 
       for (int i=0; i < STARBURST_MAX_FRAG; i++) {
         int var = i >> 1;
         
         if (stars[j].fragment[i] > 0) {
           //all fragments travel right, will be mirrored on other side
-          stars[j].fragment[i] += stars[j].vel * dt * (float)var/3.0;
+          stars[j].fragment[i] += stars[j].vel * dt * var / 3000;
         }
       }
       stars[j].last = it;
-      stars[j].vel -= 3*stars[j].vel*dt;
+      stars[j].vel -= 3*stars[j].vel*int32_t(dt) / 1000;
     }
   
     CRGB c = stars[j].color;
 
     // If the star is brand new, it flashes white briefly.  
     // Otherwise it just fades over time.
-    float fade = 0.0f;
-    float age = it-stars[j].birth;
+    uint32_t fade = 0; // 0-256
+    uint32_t age = it-stars[j].birth;
 
     if (age < particleIgnition) {
-      c = col_to_crgb(color_blend(WHITE, crgb_to_col(c), 254.5f*((age / particleIgnition))));
+      c = col_to_crgb(color_blend(WHITE, crgb_to_col(c), (age * 509) / (particleIgnition * 2)));
     } else {
       // Figure out how much to fade and shrink the star based on 
       // its age relative to its lifetime
       if (age > particleIgnition + particleFadeTime) {
-        fade = 1.0f;                  // Black hole, all faded out
+        fade = 256;                   // Black hole, all faded out
         stars[j].birth = 0;
         c = col_to_crgb(SEGCOLOR(1));
       } else {
         age -= particleIgnition;
-        fade = (age / particleFadeTime);  // Fading star
-        byte f = 254.5f*fade;
+        fade = (age << 8) / particleFadeTime;  // Fading star
+        byte f = (age * 509) / (particleFadeTime * 2);
         c = col_to_crgb(color_blend(crgb_to_col(c), SEGCOLOR(1), f));
       }
     }
     
-    float particleSize = (1.0 - fade) * 2;
+    int32_t particleSize = (256 - fade) * 2;
 
     for (uint8_t index=0; index < STARBURST_MAX_FRAG*2; index++) {
       bool mirrored = index & 0x1;
       uint8_t i = index >> 1;
       if (stars[j].fragment[i] > 0) {
-        float loc = stars[j].fragment[i];
-        if (mirrored) loc -= (loc-stars[j].pos)*2;
+        int32_t loc = stars[j].fragment[i];
+        if (mirrored) loc -= (loc - (int32_t(stars[j].pos) << 8))*2;
         int start = loc - particleSize;
-        int end = loc + particleSize;
+        start = (start < 0) ? 0 : start >> 8;
+        int end = (loc + particleSize) >> 8;
         if (start < 0) start = 0;
         if (start == end) end++;
         if (end > SEGLEN) end = SEGLEN;    
@@ -2911,12 +2960,12 @@ uint16_t WS2812FX::mode_exploding_fireworks(void)
   //allocate segment data
   uint16_t maxData = FAIR_DATA_PER_SEG; //ESP8266: 256 ESP32: 640
   uint8_t segs = getActiveSegmentsNum();
-  if (segs <= (MAX_NUM_SEGMENTS /2)) maxData *= 2; //ESP8266: 512 if <= 8 segs ESP32: 1280 if <= 16 segs
-  if (segs <= (MAX_NUM_SEGMENTS /4)) maxData *= 2; //ESP8266: 1024 if <= 4 segs ESP32: 2560 if <= 8 segs
-  int maxSparks = maxData / sizeof(spark); //ESP8266: max. 21/42/85 sparks/seg, ESP32: max. 53/106/213 sparks/seg
+  if (segs <= (FAIR_NUM_SEGMENTS /2)) maxData *= 2; //ESP8266: 512 if <= 8 segs ESP32: 1280 if <= 16 segs
+  if (segs <= (FAIR_NUM_SEGMENTS /4)) maxData *= 2; //ESP8266: 1024 if <= 4 segs ESP32: 2560 if <= 8 segs
+  int maxSparks = maxData / PARTICLE_BYTES; //ESP8266: max. 23/46/93 sparks/seg, ESP32: max. 58/116/232 sparks/seg
 
   uint16_t numSparks = min(2 + (SEGLEN >> 1), maxSparks);
-  uint16_t dataSize = sizeof(spark) * numSparks;
+  uint16_t dataSize = Particles::dataSize(numSparks);
   if (!SEGENV.allocateData(dataSize)) return mode_static(); //allocation failed
 
   if (dataSize != SEGENV.aux1) { //reset to flare if sparks were reallocated
@@ -2930,32 +2979,28 @@ uint16_t WS2812FX::mode_exploding_fireworks(void)
   //have fireworks start in either direction based on intensity
   SEGMENT.setOption(SEG_OPTION_REVERSED, SEGENV.step);
   
-  Spark* sparks = reinterpret_cast<Spark*>(SEGENV.data);
-  Spark* flare = sparks; //first spark is flare data
+  Particles sparks(SEGENV.data, numSparks); //first spark is the flare
 
-  float gravity = -0.0004 - (SEGMENT.speed/800000.0); // m/s/s
-  gravity *= SEGLEN;
+  int32_t gravity = -SPARK_GRAVITY(320 + SEGMENT.speed, 800000); // -0.0004 - speed/800000
   
   if (SEGENV.aux0 < 2) { //FLARE
     if (SEGENV.aux0 == 0) { //init flare
-      flare->pos = 0;
       uint16_t peakHeight = 75 + random8(180); //0-255
       peakHeight = (peakHeight * (SEGLEN -1)) >> 8;
-      flare->vel = sqrt(-2.0 * gravity * peakHeight);
-      flare->col = 255; //brightness
+      sparks.launch(0, 0, SPARK_LAUNCH_VEL(gravity, peakHeight), 255, 0); //col is the brightness
 
       SEGENV.aux0 = 1; 
     }
     
     // launch 
-    if (flare->vel > 12 * gravity) {
+    if (sparks.vel[0] > 12 * gravity) {
       // flare
-      setPixelColor(int(flare->pos),flare->col,flare->col,flare->col);
+      uint8_t b = sparks.col[0];
+      setPixelColor(sparks.pixel(0), b, b, b);
   
-      flare->pos += flare->vel;
-      flare->pos = constrain(flare->pos, 0, SEGLEN-1);
-      flare->vel += gravity;
-      flare->col -= 2;
+      sparks.move(0, gravity);
+      sparks.pos[0] = constrain(sparks.pos[0], 0, int32_t(SEGLEN-1) << 16);
+      sparks.col[0] -= 2;
     } else {
       SEGENV.aux0 = 2;  // ready to explode
     }
@@ -2966,35 +3011,32 @@ uint16_t WS2812FX::mode_exploding_fireworks(void)
      * Explosion happens where the flare ended.
      * Size is proportional to the height.
      */
-    int nSparks = flare->pos;
+    int nSparks = sparks.pixel(0);
     nSparks = constrain(nSparks, 0, numSparks);
-    static float dying_gravity;
+    static int32_t dying_gravity;
   
     // initialize sparks
     if (SEGENV.aux0 == 2) {
+      // proportional to height 
+      int32_t flarePos = sparks.pos[0];
+      int64_t velScale = ((int64_t)flarePos * -gravity / SEGLEN) >> 16;
       for (int i = 1; i < nSparks; i++) { 
-        sparks[i].pos = flare->pos; 
-        sparks[i].vel = (float(random16(0, 20000)) / 10000.0) - 0.9; // from -0.9 to 1.1
-        sparks[i].col = 345;//abs(sparks[i].vel * 750.0); // set colors before scaling velocity to keep them bright 
-        //sparks[i].col = constrain(sparks[i].col, 0, 345); 
-        sparks[i].colIndex = random8();
-        sparks[i].vel *= flare->pos/SEGLEN; // proportional to height 
-        sparks[i].vel *= -gravity *50;
+        int32_t vel = int32_t(random16(0, 20000)) - 9000; // from -0.9 to 1.1
+        // col set before scaling velocity to keep them bright, state is the color index
+        sparks.launch(i, flarePos, vel * velScale / 200, 345, random8()); // * 50 / 10000
       } 
-      //sparks[1].col = 345; // this will be our known spark 
       dying_gravity = gravity/2; 
       SEGENV.aux0 = 3;
     }
   
-    if (sparks[1].col > 4) {//&& sparks[1].pos > 0) { // as long as our known spark is lit, work with all the sparks
+    if (nSparks > 1 && sparks.col[1] > 4) { // as long as our known spark is lit, work with all the sparks
+      sparks.moveAll(dying_gravity, 1, nSparks);
+      sparks.fadeAll(4, 1, nSparks);
+      uint32_t spColor = SEGCOLOR(0);
       for (int i = 1; i < nSparks; i++) { 
-        sparks[i].pos += sparks[i].vel; 
-        sparks[i].vel += dying_gravity; 
-        if (sparks[i].col > 3) sparks[i].col -= 4; 
-
-        if (sparks[i].pos > 0 && sparks[i].pos < SEGLEN) {
-          uint16_t prog = sparks[i].col;
-          uint32_t spColor = (SEGMENT.palette) ? color_wheel(sparks[i].colIndex) : SEGCOLOR(0);
+        if (sparks.pos[i] > 0 && sparks.pixel(i) < SEGLEN) {
+          uint16_t prog = sparks.col[i];
+          if (SEGMENT.palette) spColor = color_wheel(sparks.state[i]);
           CRGB c = CRGB::Black; //HeatColor(sparks[i].col);
           if (prog > 300) { //fade from white to spark color
             c = col_to_crgb(color_blend(spColor, WHITE, (prog - 300)*5));
@@ -3004,10 +3046,10 @@ uint16_t WS2812FX::mode_exploding_fireworks(void)
             c.g = qsub8(c.g, cooling);
             c.b = qsub8(c.b, cooling * 2);
           }
-          setPixelColor(int(sparks[i].pos), c.red, c.green, c.blue);
+          setPixelColor(sparks.pixel(i), c.red, c.green, c.blue);
         }
       }
-      dying_gravity *= .99; // as sparks burn out they fall slower
+      dying_gravity -= dying_gravity / 100; // as sparks burn out they fall slower
     } else {
       SEGENV.aux0 = 6 + random8(10); //wait for this many frames
     }
@@ -3034,66 +3076,60 @@ uint16_t WS2812FX::mode_drip(void)
 {
   //allocate segment data
   uint8_t numDrops = 4; 
-  uint16_t dataSize = sizeof(spark) * numDrops;
-  if (!SEGENV.allocateData(dataSize)) return mode_static(); //allocation failed
+  if (!SEGENV.allocateData(Particles::dataSize(numDrops))) return mode_static(); //allocation failed
 
   fill(SEGCOLOR(1));
   
-  Spark* drops = reinterpret_cast<Spark*>(SEGENV.data);
+  Particles drops(SEGENV.data, numDrops); //col is the brightness, state the drop state
 
   numDrops = 1 + (SEGMENT.intensity >> 6); // 255>>6 = 3
 
-  float gravity = -0.0005 - (SEGMENT.speed/50000.0);
-  gravity *= SEGLEN;
+  int32_t gravity = -SPARK_GRAVITY(25 + SEGMENT.speed, 50000); // -0.0005 - speed/50000
   int sourcedrop = 12;
 
   for (uint8_t j=0;j<numDrops;j++) {
-    if (drops[j].colIndex == 0) { //init
-      drops[j].pos = SEGLEN-1;    // start at end
-      drops[j].vel = 0;           // speed
-      drops[j].col = sourcedrop;  // brightness
-      drops[j].colIndex = 1;      // drop state (0 init, 1 forming, 2 falling, 5 bouncing) 
+    if (drops.state[j] == 0) { //init, start at end
+      drops.launch(j, int32_t(SEGLEN-1) << 16, 0, sourcedrop, 1); // drop state (0 init, 1 forming, 2 falling, 5 bouncing) 
     }
     
     setPixelColor(SEGLEN-1,color_blend(BLACK,SEGCOLOR(0), sourcedrop));// water source
-    if (drops[j].colIndex==1) {
-      if (drops[j].col>255) drops[j].col=255;
-      setPixelColor(uint16_t(drops[j].pos),color_blend(BLACK,SEGCOLOR(0),drops[j].col));
+    if (drops.state[j]==1) {
+      if (drops.col[j]>255) drops.col[j]=255;
+      setPixelColor(uint16_t(drops.pixel(j)),color_blend(BLACK,SEGCOLOR(0),drops.col[j]));
       
-      drops[j].col += map(SEGMENT.speed, 0, 255, 1, 6); // swelling
+      drops.col[j] += map(SEGMENT.speed, 0, 255, 1, 6); // swelling
       
-      if (random8() < drops[j].col/10) {               // random drop
-        drops[j].colIndex=2;               //fall
-        drops[j].col=255;
+      if (random8() < drops.col[j]/10) {   // random drop
+        drops.state[j]=2;                  //fall
+        drops.col[j]=255;
       }
     }  
-    if (drops[j].colIndex > 1) {           // falling
-      if (drops[j].pos > 0) {              // fall until end of segment
-        drops[j].pos += drops[j].vel;
-        if (drops[j].pos < 0) drops[j].pos = 0;
-        drops[j].vel += gravity;           // gravity is negative
-
-        for (uint16_t i=1;i<7-drops[j].colIndex;i++) { // some minor math so we don't expand bouncing droplets
-          uint16_t pos = constrain(uint16_t(drops[j].pos) +i, 0, SEGLEN-1); //this is BAD, returns a pos >= SEGLEN occasionally
-          setPixelColor(pos,color_blend(BLACK,SEGCOLOR(0),drops[j].col/i)); //spread pixel with fade while falling
+    if (drops.state[j] > 1) {              // falling
+      if (drops.pos[j] > 0) {              // fall until end of segment
+        drops.move(j, gravity);            // gravity is negative
+        if (drops.pos[j] < 0) drops.pos[j] = 0;
+
+        for (uint16_t i=1;i<7-drops.state[j];i++) { // some minor math so we don't expand bouncing droplets
+          uint16_t pos = constrain(uint16_t(drops.pixel(j)) +i, 0, SEGLEN-1); //this is BAD, returns a pos >= SEGLEN occasionally
+          setPixelColor(pos,color_blend(BLACK,SEGCOLOR(0),drops.col[j]/i)); //spread pixel with fade while falling
         }
 
-        if (drops[j].colIndex > 2) {       // during bounce, some water is on the floor
-          setPixelColor(0,color_blend(SEGCOLOR(0),BLACK,drops[j].col));
+        if (drops.state[j] > 2) {          // during bounce, some water is on the floor
+          setPixelColor(0,color_blend(SEGCOLOR(0),BLACK,drops.col[j]));
         }
       } else {                             // we hit bottom
-        if (drops[j].colIndex > 2) {       // already hit once, so back to forming
-          drops[j].colIndex = 0;
-          drops[j].col = sourcedrop;
+        if (drops.state[j] > 2) {          // already hit once, so back to forming
+          drops.state[j] = 0;
+          drops.col[j] = sourcedrop;
           
         } else {
 
-          if (drops[j].colIndex==2) {      // init bounce
-            drops[j].vel = -drops[j].vel/4;// reverse velocity with damping 
-            drops[j].pos += drops[j].vel;
+          if (drops.state[j]==2) {         // init bounce
+            drops.vel[j] = -drops.vel[j]/4;// reverse velocity with damping 
+            drops.pos[j] += drops.vel[j];
           } 
-          drops[j].col = sourcedrop*2;
-          drops[j].colIndex = 5;           // bouncing
+          drops.col[j] = sourcedrop*2;
+          drops.state[j] = 5;              // bouncing
         }
       }
     }
@@ -3172,7 +3208,7 @@ uint16_t WS2812FX::mode_plasma(void) {
     uint8_t colorIndex = cubicwave8((i*(2+ 3*(SEGMENT.speed >> 5))+thisPhase) & 0xFF)/2   // factor=23 // Create a wave and add a phase change and add another wave with its own phase change.
                              + cos8((i*(1+ 2*(SEGMENT.speed >> 5))+thatPhase) & 0xFF)/2;  // factor=15 // Hey, you can even change the frequencies if you wish.
     uint8_t thisBright = qsub8(colorIndex, beatsin8(7,0, (128 - (SEGMENT.intensity>>1))));
-    CRGB color = ColorFromPalette(currentPalette, colorIndex, thisBright, LINEARBLEND);
+    CRGB color = palette_color(colorIndex, thisBright);
     setPixelColor(i, color.red, color.green, color.blue);
   }
 
@@ -3452,8 +3488,8 @@ uint16_t WS2812FX::phased_base(uint8_t moder) {                  // We're making
   phase += SEGMENT.speed/32.0;                                   // You can change the speed of the wave. AKA SPEED (was .4)
   //phasePtr[0] = phase; 
 
-  for (int i = 0; i < SEGLEN; i++) {
-    if (moder == 1) modVal = (inoise8(i*10 + i*10) /16);         // Let's randomize our mod length with some Perlin noise.
+  forEachNoise([&](uint16_t i) -> int32_t { return (moder == 1) ? inoise8(i*10 + i*10) : 0; }, [&](uint16_t i, int32_t noise) {
+    if (moder == 1) modVal = noise /16;                          // Let's randomize our mod length with some Perlin noise.
     uint16_t val = (i+1) * allfreq;                              // This sets the frequency of the waves. The +1 makes sure that leds[0] is used.
     if (modVal == 0) modVal = 1;
     val += phase * (i % modVal +1) /2;                           // This sets the varying phase change of the waves. By Andrew Tuline.
@@ -3462,7 +3498,7 @@ uint16_t WS2812FX::phased_base(uint8_t moder) {                  // We're making
     setPixelColor(i, color_blend(SEGCOLOR(1), color_from_palette(index, false, false, 0), b));
     index += 256 / SEGLEN;
     if (SEGLEN > 256) index ++;                                  // Correction for segments longer than 256 LEDs
-  }
+  });
 
   return FRAMETIME;
 }
@@ -3521,11 +3557,12 @@ uint16_t WS2812FX::mode_noisepal(void) {                                    // S
 
   if (SEGMENT.palette > 0) palettes[0] = currentPalette;
 
-  for(int i = 0; i < SEGLEN; i++) {
-    uint8_t index = inoise8(i*scale, SEGENV.aux0+i*scale);                // Get a value from the noise function. I'm using both x and y axis.
+  uint16_t aux0 = SEGENV.aux0;
+  forEachNoise([&](uint16_t i) -> int32_t { return inoise8(i*scale, aux0+i*scale); }, // Get a value from the noise function. I'm using both x and y axis.
+               [&](uint16_t i, int32_t index) {
     color = ColorFromPalette(palettes[0], index, 255, LINEARBLEND);       // Use the my own palette.
     setPixelColor(i, color.red, color.green, color.blue);
-  }
+  });
 
   SEGENV.aux0 += beatsin8(10,1,4);                                        // Moving along the distance. Vary it a bit with a sine wave.
 
@@ -3613,9 +3650,9 @@ uint16_t WS2812FX::mode_chunchun(void)
   return FRAMETIME;
 }
 
-//13 bytes
+//12 bytes
 typedef struct Spotlight {
-  float speed;
+  int8_t speed; //signed, moves one pixel every speed*100/(1+SEGMENT.speed) ms
   uint8_t colorIdx;
   int16_t position;
   unsigned long lastUpdateTime;
@@ -3661,31 +3698,31 @@ uint16_t WS2812FX::mode_dancing_shadows(void)
   for (uint8_t i = 0; i < numSpotlights; i++) {
     if (!initialize) {
       // advance the position of the spotlight
-      int16_t delta = (float)(time - spotlights[i].lastUpdateTime) *
-                  (spotlights[i].speed * ((1.0 + SEGMENT.speed)/100.0));
+      int16_t delta = int32_t(time - spotlights[i].lastUpdateTime) * (1 + SEGMENT.speed) /
+                  (100 * spotlights[i].speed);
 
       if (abs(delta) >= 1) {
         spotlights[i].position += delta;
         spotlights[i].lastUpdateTime = time;
       }
 
-      respawn = (spotlights[i].speed > 0.0 && spotlights[i].position > (SEGLEN + 2))
-             || (spotlights[i].speed < 0.0 && spotlights[i].position < -(spotlights[i].width + 2));
+      respawn = (spotlights[i].speed > 0 && spotlights[i].position > (SEGLEN + 2))
+             || (spotlights[i].speed < 0 && spotlights[i].position < -(spotlights[i].width + 2));
     }
 
     if (initialize || respawn) {
       spotlights[i].colorIdx = random8();
       spotlights[i].width = random8(1, 10);
 
-      spotlights[i].speed = 1.0/random8(4, 50);
+      spotlights[i].speed = random8(4, 50);
 
       if (initialize) {
         spotlights[i].position = random16(SEGLEN);
-        spotlights[i].speed *= random8(2) ? 1.0 : -1.0;
+        if (random8(2)) spotlights[i].speed = -spotlights[i].speed;
       } else {
         if (random8(2)) {
           spotlights[i].position = SEGLEN + spotlights[i].width;
-          spotlights[i].speed *= -1.0;
+          spotlights[i].speed = -spotlights[i].speed;
         }else {
           spotlights[i].position = -spotlights[i].width;
         }
@@ -4082,4 +4119,157 @@ uint16_t WS2812FX::mode_aurora(void) {
   }
   
   return FRAMETIME;
-}
\ No newline at end of file
+}
+
+
+/*
+ * Spectrum analyzer, the bands of the audio usermod spread over the segment and colored by the palette.
+ * Speed sets how fast the bars fall back, intensity how strongly a beat flashes the primary color.
+ */
+uint16_t WS2812FX::mode_audio_spectrum(void) {
+  if (!SEGENV.allocateData(AUDIO_BANDS)) return mode_static(); //allocation failed
+  AudioData audio;
+  if (!getAudio(audio)) memset(&audio, 0, sizeof(audio)); //no sound source, the bars fall back to the background
+  uint8_t* level = SEGENV.data;
+  uint8_t fall = 1 + (SEGMENT.speed >> 4);
+  for (uint8_t b = 0; b < AUDIO_BANDS; b++) {
+    level[b] = (audio.bands[b] > level[b]) ? audio.bands[b] : qsub8(level[b], fall);
+  }
+  uint8_t flash = (audio.beatTime && millis() - audio.beatTime < 100) ? SEGMENT.intensity >> 1 : 0;
+
+  for (uint16_t i = 0; i < SEGLEN; i++) {
+    uint8_t b = (i * AUDIO_BANDS) / SEGLEN;
+    uint32_t c = color_blend(SEGCOLOR(1), color_from_palette(b * 255 / (AUDIO_BANDS -1), false, PALETTE_SOLID_WRAP, 0), level[b]);
+    if (flash) c = color_blend(c, SEGCOLOR(0), flash);
+    setPixelColor(i, c);
+  }
+  return FRAMETIME;
+}
+
+
+/*
+ * Effect registry, one descriptor per FX_MODE_* in that order. Kept in flash, see getEffect().
+ * palette: palette used if the segment has palette 0 (default)
+ * FX_ENTRY() leaves the effect out of the build if the manifest in FX.h says so
+ */
+const WS2812FX::EffectDesc WS2812FX::_effects[MODE_COUNT] PROGMEM = {
+  { &WS2812FX::mode_static,                   0, FX_FLAG_STATIC | FX_FLAG_DIRECT }, //STATIC
+  FX_ENTRY(BLINK,               mode_blink,                       0, FX_FLAG_DIRECT),
+  FX_ENTRY(BREATH,              mode_breath,                      0, FX_FLAG_DIRECT),
+  FX_ENTRY(COLOR_WIPE,          mode_color_wipe,                  0, FX_FLAG_DIRECT),
+  FX_ENTRY(COLOR_WIPE_RANDOM,   mode_color_wipe_random,           0, FX_FLAG_DIRECT),
+  FX_ENTRY(RANDOM_COLOR,        mode_random_color,                0, 0),
+  FX_ENTRY(COLOR_SWEEP,         mode_color_sweep,                 0, FX_FLAG_DIRECT),
+  FX_ENTRY(DYNAMIC,             mode_dynamic,                     0, FX_FLAG_DIRECT),
+  FX_ENTRY(RAINBOW,             mode_rainbow,                     0, FX_FLAG_DIRECT),
+  FX_ENTRY(RAINBOW_CYCLE,       mode_rainbow_cycle,               0, FX_FLAG_DIRECT),
+  FX_ENTRY(SCAN,                mode_scan,                        0, FX_FLAG_DIRECT),
+  FX_ENTRY(DUAL_SCAN,           mode_dual_scan,                   0, FX_FLAG_DIRECT),
+  FX_ENTRY(FADE,                mode_fade,                        0, 0),
+  FX_ENTRY(THEATER_CHASE,       mode_theater_chase,               0, FX_FLAG_DIRECT),
+  FX_ENTRY(THEATER_CHASE_RAINBOW, mode_theater_chase_rainbow,       0, FX_FLAG_DIRECT),
+  FX_ENTRY(RUNNING_LIGHTS,      mode_running_lights,              0, FX_FLAG_DIRECT),
+  FX_ENTRY(SAW,                 mode_saw,                         0, FX_FLAG_DIRECT),
+  FX_ENTRY(TWINKLE,             mode_twinkle,                     0, FX_FLAG_DIRECT),
+  FX_ENTRY(DISSOLVE,            mode_dissolve,                    0, 0),
+  FX_ENTRY(DISSOLVE_RANDOM,     mode_dissolve_random,             0, 0),
+  FX_ENTRY(SPARKLE,             mode_sparkle,                     0, FX_FLAG_DIRECT),
+  FX_ENTRY(FLASH_SPARKLE,       mode_flash_sparkle,               0, FX_FLAG_DIRECT),
+  FX_ENTRY(HYPER_SPARKLE,       mode_hyper_sparkle,               0, FX_FLAG_DIRECT),
+  FX_ENTRY(STROBE,              mode_strobe,                      0, FX_FLAG_DIRECT),
+  FX_ENTRY(STROBE_RAINBOW,      mode_strobe_rainbow,              0, FX_FLAG_DIRECT),
+  FX_ENTRY(MULTI_STROBE,        mode_multi_strobe,                0, FX_FLAG_DIRECT),
+  FX_ENTRY(BLINK_RAINBOW,       mode_blink_rainbow,               0, FX_FLAG_DIRECT),
+  FX_ENTRY(ANDROID,             mode_android,                     0, FX_FLAG_DIRECT),
+  FX_ENTRY(CHASE_COLOR,         mode_chase_color,                 0, FX_FLAG_DIRECT),
+  FX_ENTRY(CHASE_RANDOM,        mode_chase_random,                0, FX_FLAG_DIRECT),
+  FX_ENTRY(CHASE_RAINBOW,       mode_chase_rainbow,               0, FX_FLAG_DIRECT),
+  FX_ENTRY(CHASE_FLASH,         mode_chase_flash,                 0, FX_FLAG_DIRECT),
+  FX_ENTRY(CHASE_FLASH_RANDOM,  mode_chase_flash_random,          0, FX_FLAG_DIRECT),
+  FX_ENTRY(CHASE_RAINBOW_WHITE, mode_chase_rainbow_white,         0, FX_FLAG_DIRECT),
+  FX_ENTRY(COLORFUL,            mode_colorful,                    0, FX_FLAG_DIRECT),
+  FX_ENTRY(TRAFFIC_LIGHT,       mode_traffic_light,               0, FX_FLAG_DIRECT),
+  FX_ENTRY(COLOR_SWEEP_RANDOM,  mode_color_sweep_random,          0, FX_FLAG_DIRECT),
+  FX_ENTRY(RUNNING_COLOR,       mode_running_color,               0, FX_FLAG_DIRECT),
+  FX_ENTRY(AURORA,              mode_aurora,                      0, FX_FLAG_DIRECT),
+  FX_ENTRY(RUNNING_RANDOM,      mode_running_random,              0, 0),
+  FX_ENTRY(LARSON_SCANNER,      mode_larson_scanner,              0, 0),
+  FX_ENTRY(COMET,               mode_comet,                       0, 0),
+  FX_ENTRY(FIREWORKS,           mode_fireworks,                   0, 0),
+  FX_ENTRY(RAIN,                mode_rain,                        0, 0),
+  FX_ENTRY(TETRIX,              mode_tetrix,                      0, FX_FLAG_DIRECT),
+  FX_ENTRY(FIRE_FLICKER,        mode_fire_flicker,                0, FX_FLAG_DIRECT),
+  FX_ENTRY(GRADIENT,            mode_gradient,                    0, FX_FLAG_DIRECT),
+  FX_ENTRY(LOADING,             mode_loading,                     0, FX_FLAG_DIRECT),
+  FX_ENTRY(POLICE,              mode_police,                      0, FX_FLAG_DIRECT),
+  FX_ENTRY(POLICE_ALL,          mode_police_all,                  0, FX_FLAG_DIRECT),
+  FX_ENTRY(TWO_DOTS,            mode_two_dots,                    0, FX_FLAG_DIRECT),
+  FX_ENTRY(TWO_AREAS,           mode_two_areas,                   0, FX_FLAG_DIRECT),
+  FX_ENTRY(RUNNING_DUAL,        mode_running_dual,                0, FX_FLAG_DIRECT),
+  FX_ENTRY(HALLOWEEN,           mode_halloween,                   0, FX_FLAG_DIRECT),
+  FX_ENTRY(TRICOLOR_CHASE,      mode_tricolor_chase,              0, FX_FLAG_DIRECT),
+  FX_ENTRY(TRICOLOR_WIPE,       mode_tricolor_wipe,               0, FX_FLAG_DIRECT),
+  FX_ENTRY(TRICOLOR_FADE,       mode_tricolor_fade,               0, 0),
+  FX_ENTRY(LIGHTNING,           mode_lightning,                   0, FX_FLAG_DIRECT),
+  FX_ENTRY(ICU,                 mode_icu,                         0, FX_FLAG_DIRECT),
+  FX_ENTRY(MULTI_COMET,         mode_multi_comet,                 0, 0),
+  FX_ENTRY(DUAL_LARSON_SCANNER, mode_dual_larson_scanner,         0, 0),
+  FX_ENTRY(RANDOM_CHASE,        mode_random_chase,                0, 0),
+  FX_ENTRY(OSCILLATE,           mode_oscillate,                   0, FX_FLAG_DIRECT),
+  FX_ENTRY(PRIDE_2015,          mode_pride_2015,                  0, 0),
+  FX_ENTRY(JUGGLE,              mode_juggle,                      0, 0),
+  FX_ENTRY(PALETTE,             mode_palette,                     0, FX_FLAG_DIRECT),
+  FX_ENTRY(FIRE_2012,           mode_fire_2012,                  35, FX_FLAG_DIRECT),
+  FX_ENTRY(COLORWAVES,          mode_colorwaves,                 26, 0),
+  FX_ENTRY(BPM,                 mode_bpm,                         0, FX_FLAG_DIRECT),
+  FX_ENTRY(FILLNOISE8,          mode_fillnoise8,                  9, FX_FLAG_DIRECT),
+  FX_ENTRY(NOISE16_1,           mode_noise16_1,                  20, FX_FLAG_DIRECT),
+  FX_ENTRY(NOISE16_2,           mode_noise16_2,                  43, FX_FLAG_DIRECT),
+  FX_ENTRY(NOISE16_3,           mode_noise16_3,                  35, FX_FLAG_DIRECT),
+  FX_ENTRY(NOISE16_4,           mode_noise16_4,                  26, FX_FLAG_DIRECT),
+  FX_ENTRY(COLORTWINKLE,        mode_colortwinkle,                0, 0),
+  FX_ENTRY(LAKE,                mode_lake,                        0, FX_FLAG_DIRECT),
+  FX_ENTRY(METEOR,              mode_meteor,                      4, 0),
+  FX_ENTRY(METEOR_SMOOTH,       mode_meteor_smooth,               4, 0),
+  FX_ENTRY(RAILWAY,             mode_railway,                     4, FX_FLAG_DIRECT),
+  FX_ENTRY(RIPPLE,              mode_ripple,                      4, 0),
+  FX_ENTRY(TWINKLEFOX,          mode_twinklefox,                  4, 0),
+  FX_ENTRY(TWINKLECAT,          mode_twinklecat,                  4, 0),
+  FX_ENTRY(HALLOWEEN_EYES,      mode_halloween_eyes,              4, 0),
+  FX_ENTRY(STATIC_PATTERN,      mode_static_pattern,              4, FX_FLAG_DIRECT),
+  FX_ENTRY(TRI_STATIC_PATTERN,  mode_tri_static_pattern,          4, FX_FLAG_STATIC | FX_FLAG_DIRECT),
+  FX_ENTRY(SPOTS,               mode_spots,                       4, 0),
+  FX_ENTRY(SPOTS_FADE,          mode_spots_fade,                  4, 0),
+  FX_ENTRY(GLITTER,             mode_glitter,                    11, 0),
+  FX_ENTRY(CANDLE,              mode_candle,                      4, 0),
+  FX_ENTRY(STARBURST,           mode_starburst,                   4, 0),
+  FX_ENTRY(EXPLODING_FIREWORKS, mode_exploding_fireworks,         4, 0),
+  FX_ENTRY(BOUNCINGBALLS,       mode_bouncing_balls,              4, FX_FLAG_DIRECT),
+  FX_ENTRY(SINELON,             mode_sinelon,                     4, 0),
+  FX_ENTRY(SINELON_DUAL,        mode_sinelon_dual,                4, 0),
+  FX_ENTRY(SINELON_RAINBOW,     mode_sinelon_rainbow,             4, 0),
+  FX_ENTRY(POPCORN,             mode_popcorn,                     4, FX_FLAG_DIRECT),
+  FX_ENTRY(DRIP,                mode_drip,                        4, 0),
+  FX_ENTRY(PLASMA,              mode_plasma,                      4, FX_FLAG_DIRECT),
+  FX_ENTRY(PERCENT,             mode_percent,                     4, FX_FLAG_DIRECT),
+  FX_ENTRY(RIPPLE_RAINBOW,      mode_ripple_rainbow,              4, 0),
+  FX_ENTRY(HEARTBEAT,           mode_heartbeat,                   4, FX_FLAG_DIRECT),
+  FX_ENTRY(PACIFICA,            mode_pacifica,                    4, FX_FLAG_DIRECT),
+  FX_ENTRY(CANDLE_MULTI,        mode_candle_multi,                4, 0),
+  FX_ENTRY(SOLID_GLITTER,       mode_solid_glitter,               4, FX_FLAG_DIRECT),
+  FX_ENTRY(SUNRISE,             mode_sunrise,                    35, FX_FLAG_DIRECT),
+  FX_ENTRY(PHASED,              mode_phased,                      4, FX_FLAG_DIRECT),
+  FX_ENTRY(TWINKLEUP,           mode_twinkleup,                   4, 0),
+  FX_ENTRY(NOISEPAL,            mode_noisepal,                    4, FX_FLAG_DIRECT),
+  FX_ENTRY(SINEWAVE,            mode_sinewave,                    4, FX_FLAG_DIRECT),
+  FX_ENTRY(PHASEDNOISE,         mode_phased_noise,                4, FX_FLAG_DIRECT),
+  FX_ENTRY(FLOW,                mode_flow,                        6, FX_FLAG_DIRECT),
+  FX_ENTRY(CHUNCHUN,            mode_chunchun,                    4, FX_FLAG_DIRECT),
+  FX_ENTRY(DANCING_SHADOWS,     mode_dancing_shadows,             4, 0),
+  FX_ENTRY(WASHING_MACHINE,     mode_washing_machine,             4, FX_FLAG_DIRECT),
+  FX_ENTRY(CANDY_CANE,          mode_candy_cane,                  4, FX_FLAG_DIRECT),
+  FX_ENTRY(BLENDS,              mode_blends,                      4, 0),
+  FX_ENTRY(TV_SIMULATOR,        mode_tv_simulator,                4, 0),
+  FX_ENTRY(DYNAMIC_SMOOTH,      mode_dynamic_smooth,              4, 0),
+  FX_ENTRY(AUDIO_SPECTRUM,      mode_audio_spectrum,             11, 0),
+};
@@ -47,40 +47,71 @@
 #endif
 
 /* Not used in all effects yet */
-#define WLED_FPS         42
-#define FRAMETIME        (1000/WLED_FPS)
+#define WLED_FPS         42              //default target frame rate, configurable at runtime via setTargetFps()
+#define FRAMETIME_FIXED  (1000/WLED_FPS)
+#define FRAMETIME        _frametime
 
-/* each segment uses 52 bytes of SRAM memory, so if you're application fails because of
-  insufficient memory, decreasing MAX_NUM_SEGMENTS may help */
+/* Expands the palette of each segment using one into a 256 entry color table (1kB of heap per segment),
+  so palette lookups of effects do not interpolate. Must be set as a build flag as it changes the palette cache. */
+//#define WLED_PALETTE_LUT
+
+/* segments are allocated as they are used, up to MAX_NUM_SEGMENTS (at most 64). Memory grows with
+  the highest segment id used since boot, about 100 bytes per segment */
 #ifdef ESP8266
-  #define MAX_NUM_SEGMENTS    16
-  /* How many color transitions can run at once */
+  #ifndef MAX_NUM_SEGMENTS
+    #define MAX_NUM_SEGMENTS  32
+  #endif
+  /* Number of segments the effect data budget is shared between fairly */
+  #define FAIR_NUM_SEGMENTS   16
+  /* How many color transitions the pool starts with and grows by, up to one per segment color */
   #define MAX_NUM_TRANSITIONS  8
   /* How much data bytes all segments combined may allocate */
   #define MAX_SEGMENT_DATA  4096
 #else
   #ifndef MAX_NUM_SEGMENTS
-    #define MAX_NUM_SEGMENTS  32
+    #define MAX_NUM_SEGMENTS  64
   #endif
+  #define FAIR_NUM_SEGMENTS   32
   #define MAX_NUM_TRANSITIONS 24
-  #define MAX_SEGMENT_DATA  20480
+  #ifdef WLED_ENABLE_LARGE_STRIP
+    #define MAX_SEGMENT_DATA  262144 //the arena is in PSRAM, room for the pixel buffers of large segments
+  #else
+    #define MAX_SEGMENT_DATA  20480
+  #endif
+#endif
+
+#if MAX_NUM_SEGMENTS > 64
+  #error "MAX_NUM_SEGMENTS must not exceed 64, color transitions store the segment in 6 bits"
 #endif
 
+#define MAX_SEGMENT_NAME_LEN 32
+/* The names of all segments share one buffer, grown in steps up to room for a full length name per segment */
+#define SEGMENT_NAME_POOL_STEP 64
+#define SEGMENT_NAME_POOL (MAX_NUM_SEGMENTS * (MAX_SEGMENT_NAME_LEN +1))
+
 /* How much data bytes each segment should max allocate to leave enough space for other segments,
   assuming each segment uses the same amount of data. 256 for ESP8266, 640 for ESP32. */
-#define FAIR_DATA_PER_SEG (MAX_SEGMENT_DATA / MAX_NUM_SEGMENTS)
+#define FAIR_DATA_PER_SEG (MAX_SEGMENT_DATA / FAIR_NUM_SEGMENTS)
+
+/* ms before a 2D lookup that did not fit is allocated again, XY() is computed meanwhile */
+#define XY_RETRY_DELAY 2000
 
 #define LED_SKIP_AMOUNT  1
 #define MIN_SHOW_DELAY  15
 
+/* The effect benchmark moves on to the next effect after this many ms even if fewer frames were rendered */
+#define BENCH_TIMEOUT  3000
+
 #define NUM_COLORS       3 /* number of colors per segment */
 #define SEGMENT          _segments[_segment_index]
 #define SEGCOLOR(x)      _colors_t[x]
 #define SEGENV           _segment_runtimes[_segment_index]
 #define SEGLEN           _virtualSegmentLength
+#define SEGW             _virtualWidth  /* 2D dimensions, SEGLEN x 1 for 1D segments */
+#define SEGH             _virtualHeight
 #define SEGACT           SEGMENT.stop
 #define SPEED_FORMULA_L  5U + (50U*(255U - SEGMENT.speed))/SEGLEN
-#define RESET_RUNTIME    memset(_segment_runtimes, 0, sizeof(_segment_runtimes))
+#define RESET_RUNTIME    memset(_segment_runtimes, 0, sizeof(segment_runtime) * _segCapacity)
 
 // some common colors
 #define RED        (uint32_t)0xFF0000
@@ -115,7 +146,29 @@
 #define IS_REVERSE      ((SEGMENT.options & REVERSE     ) == REVERSE     )
 #define IS_SELECTED     ((SEGMENT.options & SELECTED    ) == SELECTED    )
 
-#define MODE_COUNT  118
+// 2D layout
+// bits 4-7: TBD
+// bits 2-3: rotation clockwise in steps of 90 degrees (applied after transpose)
+// bit    1: transpose (swap x and y)
+// bit    0: serpentine, odd rows are wired right to left
+#define SEG_2D_SERPENTINE (uint8_t)0x01
+#define SEG_2D_TRANSPOSE  (uint8_t)0x02
+#define SEG_2D_ROTATION   (uint8_t)0x0C
+#define SEG_2D_MASK       (uint8_t)0x0F
+
+// segment blend modes, how a segment is composited onto the segments below it (lower ids)
+#define SEG_BLEND_NORMAL   0 //overwrite
+#define SEG_BLEND_ADD      1
+#define SEG_BLEND_MULTIPLY 2
+#define SEG_BLEND_MAX      3 //lighten
+#define SEG_BLEND_COUNT    4
+
+// noise effects sample the noise field on every (1 << Segment::noiseShift)th pixel and interpolate in between
+#define SEG_NOISE_MAX_SHIFT 3
+// effects of a 1D segment render up to every 8th pixel, the ones in between are interpolated (Segment::scale)
+#define SEG_MAX_RENDER_SCALE 8
+
+#define MODE_COUNT  119
 
 #define FX_MODE_STATIC                   0
 #define FX_MODE_BLINK                    1
@@ -235,11 +288,98 @@
 #define FX_MODE_BLENDS                 115
 #define FX_MODE_TV_SIMULATOR           116
 #define FX_MODE_DYNAMIC_SMOOTH         117
+#define FX_MODE_AUDIO_SPECTRUM         118
+
+// effect flags
+#define FX_FLAG_STATIC   0x01 //output only depends on colors, opacity, speed and intensity, not on time or palette
+#define FX_FLAG_UNUSED   0x02 //left out of the build, renders Solid
+#define FX_FLAG_DIRECT   0x04 //never reads pixels back, can draw straight to the busses (WLED_ENABLE_DIRECT_RENDER)
+
+/*
+ * Effects built in. All of them by default, -D WLED_FX_OFF_<name> leaves one out (e.g. -D WLED_FX_OFF_FIRE_2012).
+ * With -D WLED_FX_ONLY only the effects with -D WLED_FX_ON_<name> are built. Names are the FX_MODE_* ones without prefix.
+ * IDs don't change: a left out effect renders Solid and is named "RSVD" in the effect list, its code is not linked.
+ * Solid is always built.
+ */
+#define FX_CAT_(a, b) a##b
+#define FX_SECOND_(a, b, ...) b
+#define FX_SECOND(...) FX_SECOND_(__VA_ARGS__)
+#define FX_PROBE_1 ~, 1
+#define FX_IS_SET_(v) FX_SECOND(FX_CAT_(FX_PROBE_, v), 0, ~)
+#define FX_IS_SET(m) FX_IS_SET_(m) //1 if m is defined as 1 (what -D m gives), otherwise 0
+#define FX_NOT_0 1
+#define FX_NOT_1 0
+#define FX_NOT(v) FX_CAT_(FX_NOT_, v)
+#ifdef WLED_FX_ONLY
+  #define FX_BUILT(on, off) FX_IS_SET(on)
+#else
+  #define FX_BUILT(on, off) FX_NOT(FX_IS_SET(off))
+#endif
+#define FX_IF_1(a, b) a
+#define FX_IF_0(a, b) b
+#define FX_IF(c, a, b) FX_CAT_(FX_IF_, c)(a, b)
+//registry entry (FX.cpp) and name (JSON_mode_names) of FX_MODE_<name>
+#define FX_ENTRY(name, fn, pal, flags) FX_ENTRY_(FX_BUILT(WLED_FX_ON_##name, WLED_FX_OFF_##name), fn, pal, flags)
+#define FX_ENTRY_(c, fn, pal, flags) \
+  { FX_IF(c, &WS2812FX::fn, &WS2812FX::mode_static), FX_IF(c, pal, 0), FX_IF(c, flags, FX_FLAG_STATIC | FX_FLAG_UNUSED) }
+#define FX_NAME(name, str) FX_NAME_(FX_BUILT(WLED_FX_ON_##name, WLED_FX_OFF_##name), str)
+#define FX_NAME_(c, str) FX_IF(c, ",\"" str "\"", ",\"RSVD\"")
 
+/*
+ * Sound analysis published by an audio usermod (usermods/audio_reactive), read by effects once per frame.
+ * The writers run on another core or in loop(), readers copy it under a sequence counter instead of a lock.
+ */
+#define AUDIO_BANDS 16
+typedef struct AudioData {
+  uint8_t  bands[AUDIO_BANDS]; //energy per band from bass to treble, 0-255 after gain control
+  uint8_t  volume;             //overall level 0-255
+  uint8_t  peakBand;           //band with the most energy
+  uint32_t beatTime;           //millis() of the last bass beat
+  uint32_t time;               //millis() of the analysis
+  bool     remote;             //received from another node (audio sync), not analyzed here
+} AudioData;
+
+void publishAudio(const AudioData& data);
+bool getAudio(AudioData& data); //false if no analysis arrived recently
+
+
+class Bus; //bus_manager.h
+
+/*
+ * Fixed block all segment buffers (effect data, framebuffers, maps) are allocated from, so effect changes
+ * do not fragment the heap. First fit over an address ordered free list, freed blocks are merged with their neighbours.
+ * The block is allocated on first use, in PSRAM if available.
+ */
+class SegmentArena {
+  public:
+    void* alloc(uint32_t len, uint32_t limit); //fails if more than limit bytes would be in use afterwards
+    void release(void* p, uint32_t len);
+    uint32_t largestFree(void);
+    inline uint32_t size()  { return _size; }
+    inline uint32_t used()  { return _used; }
+    inline uint32_t peak()  { return _peak; }
+    inline uint32_t fails() { return _fails; }
+    static inline uint32_t blockSize(uint32_t len) { return (len + 7) & ~7; } //multiple of sizeof(FreeBlock)
+  private:
+    struct FreeBlock {
+      uint32_t size;
+      FreeBlock* next;
+    };
+    bool begin(void);
+    uint8_t* _mem = nullptr;
+    FreeBlock* _free = nullptr;
+    uint32_t _size = 0, _used = 0, _peak = 0, _fails = 0;
+};
 
 class WS2812FX {
   typedef uint16_t (WS2812FX::*mode_ptr)(void);
 
+  typedef struct EffectDesc {
+    mode_ptr fn;
+    uint8_t palette; //palette used if the segment has the default palette (0)
+    uint8_t flags;   //FX_FLAG_*
+  } EffectDesc;
+
   // pre show callback
   typedef void (*show_callback) (void);
 
@@ -247,6 +387,33 @@ class WS2812FX {
   
   // segment parameters
   public:
+    //timing statistics in microseconds, avg is smoothed over the last few samples
+    typedef struct PerfStat {
+      uint32_t min, max, avg, count;
+      void add(uint32_t us) {
+        if (!count || us < min) min = us;
+        if (us > max) max = us;
+        avg = count ? (avg * 7 + us) >> 3 : us;
+        count++;
+      }
+      void reset() { min = max = avg = count = 0; }
+    } PerfStat;
+
+    //effect render time of a segment, restarted whenever its effect changes
+    typedef struct SegmentPerf {
+      PerfStat fx;
+      uint32_t lastFrame;
+      uint16_t fps;
+      uint8_t mode;
+    } SegmentPerf;
+
+    //one effect of the benchmark, see startBenchmark()
+    typedef struct BenchResult {
+      uint32_t us;     //smoothed render time per frame
+      uint16_t data;   //bytes of segment data the effect allocated
+      uint16_t frames;
+    } BenchResult;
+
     typedef struct Segment { // 29 (32 in memory?) bytes
       uint16_t start;
       uint16_t stop; //segment invalid if stop == 0
@@ -259,7 +426,14 @@ class WS2812FX {
       uint8_t grouping, spacing;
       uint8_t opacity;
       uint32_t colors[NUM_COLORS];
-      char *name;
+      uint16_t width, height; //wiring of a 2D matrix segment in groups, row by row. 0 for 1D segments
+      uint8_t layout;         //SEG_2D_* bits
+      uint8_t blendMode;      //SEG_BLEND_*
+      uint8_t fps;            //frame rate cap of the segment, 0 to run at the strip target frame rate
+      uint8_t noiseShift;     //noise quality, 0 samples noise on every pixel, see forEachNoise()
+      uint8_t cloneSrc;       //1 + id of the segment whose frame this one shows instead of running its effect, 0 for none
+      uint8_t scale;          //1D effects render every scale-th virtual pixel, interpolated in between on output. 0/1 full resolution
+      bool live;              //shows realtime data instead of its effect while realtime mode is active, see WS2812FX::isLive()
       bool setColor(uint8_t slot, uint32_t c, uint8_t segn) { //returns true if changed
         if (slot >= NUM_COLORS || segn >= MAX_NUM_SEGMENTS) return false;
         if (c == colors[slot]) return false;
@@ -317,7 +491,25 @@ class WS2812FX {
       {
         return grouping + spacing;
       }
-      uint16_t virtualLength()
+      inline bool is2D()
+      {
+        return width && height && (uint32_t)width * height <= outputLength();
+      }
+      //dimensions effects see, rotation and transpose can swap them
+      inline bool swapsAxes()
+      {
+        return ((layout & SEG_2D_TRANSPOSE) != 0) != ((layout & 0x04) != 0);
+      }
+      inline uint16_t virtualWidth()
+      {
+        return swapsAxes() ? height : width;
+      }
+      inline uint16_t virtualHeight()
+      {
+        return swapsAxes() ? width : height;
+      }
+      //virtual pixels written to the segment, before the render scale
+      uint16_t outputLength()
       {
         uint16_t groupLen = groupLength();
         uint16_t vLength = (length() + groupLen - 1) / groupLen;
@@ -325,6 +517,16 @@ class WS2812FX {
           vLength = (vLength + 1) /2;  // divide by 2 if mirror, leave at least a single LED
         return vLength;
       }
+      inline uint8_t renderScale()
+      {
+        return (scale > 1 && !(width && height)) ? scale : 1; //not for 2D geometry
+      }
+      //pixels the effect renders
+      uint16_t virtualLength()
+      {
+        uint8_t k = renderScale();
+        return (outputLength() + k - 1) / k;
+      }
       uint8_t differs(Segment& b) {
         uint8_t d = 0;
         if (start != b.start)         d |= SEG_DIFFERS_BOUNDS;
@@ -332,13 +534,22 @@ class WS2812FX {
         if (offset != b.offset)       d |= SEG_DIFFERS_GSO;
         if (grouping != b.grouping)   d |= SEG_DIFFERS_GSO;
         if (spacing != b.spacing)     d |= SEG_DIFFERS_GSO;
+        if (scale != b.scale)         d |= SEG_DIFFERS_GSO;
+        if (width != b.width)         d |= SEG_DIFFERS_GSO;
+        if (height != b.height)       d |= SEG_DIFFERS_GSO;
+        if (layout != b.layout)       d |= SEG_DIFFERS_GSO;
+        if (blendMode != b.blendMode) d |= SEG_DIFFERS_OPT;
+        if (fps != b.fps)             d |= SEG_DIFFERS_FX;
+        if (noiseShift != b.noiseShift) d |= SEG_DIFFERS_FX;
+        if (cloneSrc != b.cloneSrc)   d |= SEG_DIFFERS_FX;
+        if (live != b.live)           d |= SEG_DIFFERS_OPT;
         if (opacity != b.opacity)     d |= SEG_DIFFERS_BRI;
         if (mode != b.mode)           d |= SEG_DIFFERS_FX;
         if (speed != b.speed)         d |= SEG_DIFFERS_FX;
         if (intensity != b.intensity) d |= SEG_DIFFERS_FX;
         if (palette != b.palette)     d |= SEG_DIFFERS_FX;
 
-        if ((options & 0b00101111) != (b.options & 0b00101111)) d |= SEG_DIFFERS_OPT;
+        if ((options & 0b01101111) != (b.options & 0b01101111)) d |= SEG_DIFFERS_OPT;
         for (uint8_t i = 0; i < NUM_COLORS; i++)
         {
           if (colors[i] != b.colors[i]) d |= SEG_DIFFERS_COL;
@@ -349,6 +560,20 @@ class WS2812FX {
     } segment;
 
   // segment runtime parameters
+    //palette of a segment, rebuilt only if the palette or the colors it is made of change
+    typedef struct PaletteCache {
+      CRGBPalette16 current;  //faded towards target if palette transitions are enabled
+      CRGBPalette16 target;
+      uint32_t key = 0;       //palette and colors target was built from
+      uint32_t lastChange = 0; //random palette
+      #ifdef WLED_PALETTE_LUT
+      uint32_t lut[256];      //current expanded, valid if lutBlend is the blend type it was built with
+      uint8_t lutBlend = 0xFF;
+      #endif
+    } PaletteCache;
+
+    struct EffectTransition;
+
     typedef struct Segment_runtime { // 28 bytes
       unsigned long next_time;  // millis() of next update
       uint32_t step;  // custom "step" var
@@ -358,27 +583,176 @@ class WS2812FX {
       byte* data = nullptr;
       bool allocateData(uint16_t len){
         if (data && _dataLen == len) return true; //already allocated
+        if (data && SegmentArena::blockSize(_dataLen) == SegmentArena::blockSize(len)) { //same block, no need to reallocate
+          _dataLen = len;
+          memset(data, 0, len);
+          return true;
+        }
         deallocateData();
-        if (WS2812FX::instance->_usedSegmentData + len > MAX_SEGMENT_DATA) return false; //not enough memory
-        // if possible use SPI RAM on ESP32
-        #if defined(ARDUINO_ARCH_ESP32) && defined(WLED_USE_PSRAM)
-        if (psramFound())
-          data = (byte*) ps_malloc(len);
-        else
-        #endif
-          data = (byte*) malloc(len);
-        if (!data) return false; //allocation failed
-        WS2812FX::instance->_usedSegmentData += len;
+        data = (byte*) WS2812FX::instance->_arena.alloc(len, MAX_SEGMENT_DATA);
+        if (!data) return false; //not enough memory
         _dataLen = len;
         memset(data, 0, len);
         return true;
       }
       void deallocateData(){
-        free(data);
+        WS2812FX::instance->_arena.release(data, _dataLen);
         data = nullptr;
-        WS2812FX::instance->_usedSegmentData -= _dataLen;
         _dataLen = 0;
       }
+      inline uint16_t dataSize() { return _dataLen; }
+
+      /** 
+       * Optional segment-local RGBW framebuffer (one uint32_t per virtual pixel).
+       * Effects render into it and it is flushed to the busses after the effect function,
+       * so getPixelColor() does not need to read back from the bus drivers.
+       * Shares the MAX_SEGMENT_DATA budget with the effect data and is only allocated
+       * if enough is left over for the fair share of the other active segments.
+       */
+      uint32_t* pixels = nullptr;
+      bool allocatePixels(uint16_t len, uint16_t reserve = 0){
+        if (pixels && _pixelsLen == len) return true; //already allocated
+        deallocatePixels();
+        uint32_t size = len * sizeof(uint32_t);
+        pixels = (uint32_t*) WS2812FX::instance->_arena.alloc(size, MAX_SEGMENT_DATA - reserve);
+        if (!pixels) return false; //not enough memory
+        _pixelsLen = len;
+        memset(pixels, 0, size);
+        dirty = true;
+        return true;
+      }
+      inline bool hasPixels(uint16_t len) { return pixels && _pixelsLen == len; }
+      void deallocatePixels(){
+        WS2812FX::instance->_arena.release(pixels, _pixelsLen * sizeof(uint32_t));
+        pixels = nullptr;
+        _pixelsLen = 0;
+      }
+
+      /** 
+       * Optional physical->virtual index map of the segment (one uint16_t per physical pixel, 0xFFFF if unused).
+       * Has grouping, spacing, reverse, mirror and offset baked in so flushing the framebuffer is a single table walk.
+       * Dropped by layoutChanged() whenever the segment layout changes.
+       */
+      uint16_t* map = nullptr;
+      bool allocateMap(Segment& seg, uint16_t reserve = 0){ //contents must be filled in by the caller
+        uint16_t len = seg.length();
+        if (!map || _mapLen != len) {
+          deallocateMap();
+          map = (uint16_t*) WS2812FX::instance->_arena.alloc(len * sizeof(uint16_t), MAX_SEGMENT_DATA - reserve);
+          if (!map) return false; //not enough memory
+          _mapLen = len;
+        }
+        return true;
+      }
+      void deallocateMap(){
+        WS2812FX::instance->_arena.release(map, _mapLen * sizeof(uint16_t));
+        map = nullptr;
+        _mapLen = 0;
+      }
+
+      /** 
+       * Optional 2D lookup of a matrix segment: virtual index for every x,y as seen by effects (row by row).
+       * Has serpentine wiring, rotation and transpose baked in. Built on first use after the geometry changed,
+       * setSegmentGeometry() resets the segment.
+       */
+      uint16_t* xy = nullptr;
+      bool allocateXY(uint16_t len, uint16_t reserve = 0){ //contents must be filled in by the caller
+        if (xy && _xyLen == len) return true;
+        if (!xy && _xyFailed && millis() - _xyFailed < XY_RETRY_DELAY) return false; //not every frame
+        deallocateXY();
+        xy = (uint16_t*) WS2812FX::instance->_arena.alloc(len * sizeof(uint16_t), MAX_SEGMENT_DATA - reserve);
+        if (!xy) { //not enough memory
+          _xyFailed = millis() | 1;
+          return false;
+        }
+        _xyFailed = 0;
+        _xyLen = len;
+        return true;
+      }
+      void deallocateXY(){
+        WS2812FX::instance->_arena.release(xy, _xyLen * sizeof(uint16_t));
+        xy = nullptr;
+        _xyLen = 0;
+      }
+
+      /** 
+       * Records the layout (bounds, grouping, spacing, offset, reverse, mirror) the framebuffer is flushed with.
+       * Offset and options are changed in place by the JSON API, so this is checked on every flush.
+       * Returns true if seg differs from the last recorded layout.
+       */
+      bool layoutChanged(Segment& seg) {
+        uint8_t opt = seg.options & (REVERSE | MIRROR);
+        if (_layoutStart == seg.start && _layoutStop == seg.stop && _layoutOffset == seg.offset
+          && _layoutGrouping == seg.grouping && _layoutSpacing == seg.spacing && _layoutOptions == opt
+          && _layoutScale == seg.renderScale()) return false;
+        _layoutStart = seg.start; _layoutStop = seg.stop; _layoutOffset = seg.offset;
+        _layoutGrouping = seg.grouping; _layoutSpacing = seg.spacing; _layoutOptions = opt;
+        _layoutScale = seg.renderScale();
+        deallocateMap(); //built for the old layout
+        return true;
+      }
+
+      bool dirty = true; //framebuffer content differs from what was last flushed to the busses
+
+      /**
+       * Previous effect frame of a SEG_OPTION_TWEEN segment. Between two effect calls the output
+       * blends from it to pixels, so the busses can be refreshed faster than the effect renders.
+       */
+      uint32_t* tweenPixels = nullptr;
+      uint32_t tweenStart = 0;
+      uint16_t tweenDur = 0;  //delay of the effect frame being blended to, 0 right after the effect call
+      bool allocateTween(uint16_t len, uint16_t reserve = 0){
+        if (tweenPixels && _tweenLen == len) return true;
+        deallocateTween();
+        tweenPixels = (uint32_t*) WS2812FX::instance->_arena.alloc(len * sizeof(uint32_t), MAX_SEGMENT_DATA - reserve);
+        if (!tweenPixels) return false; //not enough memory
+        _tweenLen = len;
+        return true;
+      }
+      inline bool hasTween(uint16_t len) { return tweenPixels && _tweenLen == len; }
+      void deallocateTween(){
+        WS2812FX::instance->_arena.release(tweenPixels, _tweenLen * sizeof(uint32_t));
+        tweenPixels = nullptr;
+        _tweenLen = 0;
+      }
+      uint16_t tweenProgress() { //0 - 0xFFFF
+        if (!tweenDur) return 0;
+        uint32_t elapsed = millis() - tweenStart;
+        if (elapsed >= tweenDur) return 0xFFFF;
+        return (elapsed * 0xFFFF) / tweenDur;
+      }
+
+      /** 
+       * Palette of the segment, kept on the heap outside the effect data budget.
+       * Freed on reset, like the effect state palette transitions do not cross effect changes.
+       */
+      PaletteCache* palette = nullptr;
+      void deallocatePalette(){
+        delete palette;
+        palette = nullptr;
+      }
+
+      //crossfade from the previous effect, see startEffectTransition()
+      EffectTransition* fxTransition = nullptr;
+      uint8_t fxFrom = 0xFF; //mode a pending reset changes from
+
+      //inputs and delay of the last call of a FX_FLAG_STATIC effect, it is not called again until they change
+      uint32_t staticKey = 0;
+      uint16_t staticDelay = 0;
+
+      /** 
+       * Random number stream of the segment (xorshift32), so effects on several segments are not correlated.
+       * Seeded by service() before the first effect call after a reset, see WS2812FX::setRandomSeed().
+       * The ranged variants scale like their FastLED counterparts, the upper bound is exclusive.
+       */
+      uint32_t rng = 0;
+      inline uint32_t rand32() { rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5; return rng; }
+      inline uint8_t  rand8()  { return rand32() >> 24; }
+      inline uint8_t  rand8(uint8_t lim) { return ((rand32() >> 24) * lim) >> 8; }
+      inline uint8_t  rand8(uint8_t min, uint8_t lim) { return min + rand8(lim - min); }
+      inline uint16_t rand16() { return rand32() >> 16; }
+      inline uint16_t rand16(uint16_t lim) { return ((rand32() >> 16) * lim) >> 16; }
+      inline uint16_t rand16(uint16_t min, uint16_t lim) { return min + rand16(lim - min); }
 
       /** 
        * If reset of this segment was request, clears runtime
@@ -389,8 +763,15 @@ class WS2812FX {
        */
       void resetIfRequired() {
         if (_requiresReset) {
-          next_time = 0; step = 0; call = 0; aux0 = 0; aux1 = 0; 
+          next_time = 0; step = 0; call = 0; aux0 = 0; aux1 = 0; rng = 0;
           deallocateData();
+          deallocatePixels(); //effect gets the first pick of the data budget, buffer is re-allocated after its first call
+          deallocateMap();
+          deallocateXY();
+          _xyFailed = 0; //the geometry may have changed
+          deallocatePalette();
+          deallocateTween();
+          dirty = true;
           _requiresReset = false;
         }
       }
@@ -401,11 +782,56 @@ class WS2812FX {
        * Call resetIfRequired before calling the next effect function.
        */
       inline void reset() { _requiresReset = true; }
+      inline bool resetPending() { return _requiresReset; }
+
+      /** 
+       * Moves the effect state (data, framebuffer, palette, counters) to to, this runtime keeps
+       * only the geometry lookups. Used to keep the outgoing effect running during a transition.
+       */
+      void handOver(Segment_runtime& to) {
+        to = *this;
+        to.map = nullptr; to._mapLen = 0;
+        to.xy = nullptr;  to._xyLen = 0;
+        to.fxTransition = nullptr;
+        to.tweenPixels = nullptr; to._tweenLen = 0;
+        data = nullptr;    _dataLen = 0;
+        pixels = nullptr;  _pixelsLen = 0;
+        palette = nullptr;
+      }
+      void deallocateAll() {
+        deallocateData();
+        deallocatePixels();
+        deallocateMap();
+        deallocateXY();
+        deallocatePalette();
+        deallocateTween();
+      }
       private:
         uint16_t _dataLen = 0;
+        uint16_t _pixelsLen = 0;
+        uint16_t _mapLen = 0;
+        uint16_t _xyLen = 0;
+        uint32_t _xyFailed = 0; //millis() of the last failed allocateXY(), 0 if none
+        uint16_t _tweenLen = 0;
+        //layout of the last flush
+        uint16_t _layoutStart = 0, _layoutStop = 0, _layoutOffset = 0;
+        uint8_t _layoutGrouping = 0, _layoutSpacing = 0, _layoutOptions = 0, _layoutScale = 0;
         bool _requiresReset = false;
     } segment_runtime;
 
+    //outgoing effect of a segment, rendered into its own framebuffer and crossfaded into the incoming one
+    struct EffectTransition {
+      Segment_runtime old;
+      uint32_t start;
+      uint16_t dur;
+      uint8_t mode;
+      uint16_t progress() { //0 - 0xFFFF
+        uint32_t elapsed = millis() - start;
+        if (elapsed >= dur) return 0xFFFF;
+        return (elapsed * 0xFFFF) / dur;
+      }
+    };
+
     typedef struct ColorTransition { // 12 bytes
       uint32_t colorOld = 0;
       uint32_t transitionStart;
@@ -413,33 +839,13 @@ class WS2812FX {
       uint8_t segment = 0xFF; //lower 6 bits: the segment this transition is for (255 indicates transition not in use/available) upper 2 bits: color channel
       uint8_t briOld = 0;
       static void startTransition(uint8_t oldBri, uint32_t oldCol, uint16_t dur, uint8_t segn, uint8_t slot) {
-        if (segn >= MAX_NUM_SEGMENTS || slot >= NUM_COLORS || dur == 0) return;
+        if (segn >= instance->_segCapacity || slot >= NUM_COLORS || dur == 0) return;
         if (instance->_brightness == 0) return; //do not need transitions if master bri is off
         if (!instance->_segments[segn].getOption(SEG_OPTION_ON)) return; //not if segment is off either
-        uint8_t tIndex = 0xFF; //none found
-        uint16_t tProgression = 0;
         uint8_t s = segn + (slot << 6); //merge slot and segment into one byte
-
-        for (uint8_t i = 0; i < MAX_NUM_TRANSITIONS; i++) {
-          uint8_t tSeg = instance->transitions[i].segment;
-          //see if this segment + color already has a running transition
-          if (tSeg == s) {
-            tIndex = i; break;
-          }
-          if (tSeg == 0xFF) { //free transition
-            tIndex = i; tProgression = 0xFFFF;
-          }
-        }
-
-        if (tIndex == 0xFF) { //no slot found yet
-          for (uint8_t i = 0; i < MAX_NUM_TRANSITIONS; i++) {
-            //find most progressed transition to overwrite
-            uint16_t prog = instance->transitions[i].progress();
-            if (prog > tProgression) {
-              tIndex = i; tProgression = prog;
-            }
-          }
-        }
+        uint8_t tIndex = instance->_transitionIndex[segn][slot];
+        if (tIndex == 0xFF) tIndex = instance->allocateTransition();
+        if (tIndex == 0xFF) return;
 
         ColorTransition& t = instance->transitions[tIndex];
         if (t.segment == s) //this is an active transition on the same segment+color
@@ -448,14 +854,14 @@ class WS2812FX {
           t.briOld = t.currentBri(wasTurningOff);
           t.colorOld = t.currentColor(oldCol);
         } else {
+          t.end(); //taken over from another segment color if the pool could not grow
           t.briOld = oldBri;
           t.colorOld = oldCol;
-          uint8_t prevSeg = t.segment & 0x3F;
-          if (prevSeg < MAX_NUM_SEGMENTS) instance->_segments[prevSeg].setOption(SEG_OPTION_TRANSITIONAL, false);
         }
         t.transitionDur = dur;
-        t.transitionStart = millis();
+        t.transitionStart = instance->_updateDepth ? instance->_updateTime : millis(); //restamped by endUpdate()
         t.segment = s;
+        instance->_transitionIndex[segn][slot] = tIndex;
         instance->_segments[segn].setOption(SEG_OPTION_TRANSITIONAL, true);
         //refresh immediately, required for Solid mode
         if (instance->_segment_runtimes[segn].next_time > t.transitionStart + 22) instance->_segment_runtimes[segn].next_time = t.transitionStart;
@@ -463,23 +869,28 @@ class WS2812FX {
       uint16_t progress(bool allowEnd = false) { //transition progression between 0-65535
         uint32_t timeNow = millis();
         if (timeNow - transitionStart > transitionDur) {
-          if (allowEnd) {
-            uint8_t segn = segment & 0x3F;
-            if (segn < MAX_NUM_SEGMENTS) instance->_segments[segn].setOption(SEG_OPTION_TRANSITIONAL, false);
-            segment = 0xFF;
-          }
+          if (allowEnd) end();
           return 0xFFFF;
         }
         uint32_t elapsed = timeNow - transitionStart;
         uint32_t prog = elapsed * 0xFFFF / transitionDur;
         return (prog > 0xFFFF) ? 0xFFFF : prog;
       }
+      void end() { //frees the slot, the segment stays transitional while another of its colors fades
+        uint8_t segn = segment & 0x3F;
+        if (segn < instance->_segCapacity) {
+          uint8_t* idx = instance->_transitionIndex[segn];
+          idx[segment >> 6] = 0xFF;
+          if (idx[0] == 0xFF && idx[1] == 0xFF && idx[2] == 0xFF) instance->_segments[segn].setOption(SEG_OPTION_TRANSITIONAL, false);
+        }
+        segment = 0xFF;
+      }
       uint32_t currentColor(uint32_t colorNew) {
         return instance->color_blend(colorOld, colorNew, progress(true), true);
       }
       uint8_t currentBri(bool turningOff = false) {
         uint8_t segn = segment & 0x3F;
-        if (segn >= MAX_NUM_SEGMENTS) return 0;
+        if (segn >= instance->_segCapacity) return 0;
         uint8_t briNew = instance->_segments[segn].opacity;
         if (!instance->_segments[segn].getOption(SEG_OPTION_ON) || turningOff) briNew = 0;
         uint32_t prog = progress() + 1;
@@ -489,167 +900,74 @@ class WS2812FX {
 
     WS2812FX() {
       WS2812FX::instance = this;
-      //assign each member of the _mode[] array to its respective function reference 
-      _mode[FX_MODE_STATIC]                  = &WS2812FX::mode_static;
-      _mode[FX_MODE_BLINK]                   = &WS2812FX::mode_blink;
-      _mode[FX_MODE_COLOR_WIPE]              = &WS2812FX::mode_color_wipe;
-      _mode[FX_MODE_COLOR_WIPE_RANDOM]       = &WS2812FX::mode_color_wipe_random;
-      _mode[FX_MODE_RANDOM_COLOR]            = &WS2812FX::mode_random_color;
-      _mode[FX_MODE_COLOR_SWEEP]             = &WS2812FX::mode_color_sweep;
-      _mode[FX_MODE_DYNAMIC]                 = &WS2812FX::mode_dynamic;
-      _mode[FX_MODE_RAINBOW]                 = &WS2812FX::mode_rainbow;
-      _mode[FX_MODE_RAINBOW_CYCLE]           = &WS2812FX::mode_rainbow_cycle;
-      _mode[FX_MODE_SCAN]                    = &WS2812FX::mode_scan;
-      _mode[FX_MODE_DUAL_SCAN]               = &WS2812FX::mode_dual_scan;
-      _mode[FX_MODE_FADE]                    = &WS2812FX::mode_fade;
-      _mode[FX_MODE_THEATER_CHASE]           = &WS2812FX::mode_theater_chase;
-      _mode[FX_MODE_THEATER_CHASE_RAINBOW]   = &WS2812FX::mode_theater_chase_rainbow;
-      _mode[FX_MODE_SAW]                     = &WS2812FX::mode_saw;
-      _mode[FX_MODE_TWINKLE]                 = &WS2812FX::mode_twinkle;
-      _mode[FX_MODE_DISSOLVE]                = &WS2812FX::mode_dissolve;
-      _mode[FX_MODE_DISSOLVE_RANDOM]         = &WS2812FX::mode_dissolve_random;
-      _mode[FX_MODE_SPARKLE]                 = &WS2812FX::mode_sparkle;
-      _mode[FX_MODE_FLASH_SPARKLE]           = &WS2812FX::mode_flash_sparkle;
-      _mode[FX_MODE_HYPER_SPARKLE]           = &WS2812FX::mode_hyper_sparkle;
-      _mode[FX_MODE_STROBE]                  = &WS2812FX::mode_strobe;
-      _mode[FX_MODE_STROBE_RAINBOW]          = &WS2812FX::mode_strobe_rainbow;
-      _mode[FX_MODE_MULTI_STROBE]            = &WS2812FX::mode_multi_strobe;
-      _mode[FX_MODE_BLINK_RAINBOW]           = &WS2812FX::mode_blink_rainbow;
-      _mode[FX_MODE_ANDROID]                 = &WS2812FX::mode_android;
-      _mode[FX_MODE_CHASE_COLOR]             = &WS2812FX::mode_chase_color;
-      _mode[FX_MODE_CHASE_RANDOM]            = &WS2812FX::mode_chase_random;
-      _mode[FX_MODE_CHASE_RAINBOW]           = &WS2812FX::mode_chase_rainbow;
-      _mode[FX_MODE_CHASE_FLASH]             = &WS2812FX::mode_chase_flash;
-      _mode[FX_MODE_CHASE_FLASH_RANDOM]      = &WS2812FX::mode_chase_flash_random;
-      _mode[FX_MODE_CHASE_RAINBOW_WHITE]     = &WS2812FX::mode_chase_rainbow_white;
-      _mode[FX_MODE_COLORFUL]                = &WS2812FX::mode_colorful;
-      _mode[FX_MODE_TRAFFIC_LIGHT]           = &WS2812FX::mode_traffic_light;
-      _mode[FX_MODE_COLOR_SWEEP_RANDOM]      = &WS2812FX::mode_color_sweep_random;
-      _mode[FX_MODE_RUNNING_COLOR]           = &WS2812FX::mode_running_color;
-      _mode[FX_MODE_AURORA]                  = &WS2812FX::mode_aurora;
-      _mode[FX_MODE_RUNNING_RANDOM]          = &WS2812FX::mode_running_random;
-      _mode[FX_MODE_LARSON_SCANNER]          = &WS2812FX::mode_larson_scanner;
-      _mode[FX_MODE_COMET]                   = &WS2812FX::mode_comet;
-      _mode[FX_MODE_FIREWORKS]               = &WS2812FX::mode_fireworks;
-      _mode[FX_MODE_RAIN]                    = &WS2812FX::mode_rain;
-      _mode[FX_MODE_TETRIX]                  = &WS2812FX::mode_tetrix;
-      _mode[FX_MODE_FIRE_FLICKER]            = &WS2812FX::mode_fire_flicker;
-      _mode[FX_MODE_GRADIENT]                = &WS2812FX::mode_gradient;
-      _mode[FX_MODE_LOADING]                 = &WS2812FX::mode_loading;
-      _mode[FX_MODE_POLICE]                  = &WS2812FX::mode_police;
-      _mode[FX_MODE_POLICE_ALL]              = &WS2812FX::mode_police_all;
-      _mode[FX_MODE_TWO_DOTS]                = &WS2812FX::mode_two_dots;
-      _mode[FX_MODE_TWO_AREAS]               = &WS2812FX::mode_two_areas;
-      _mode[FX_MODE_RUNNING_DUAL]            = &WS2812FX::mode_running_dual;
-      _mode[FX_MODE_HALLOWEEN]               = &WS2812FX::mode_halloween;
-      _mode[FX_MODE_TRICOLOR_CHASE]          = &WS2812FX::mode_tricolor_chase;
-      _mode[FX_MODE_TRICOLOR_WIPE]           = &WS2812FX::mode_tricolor_wipe;
-      _mode[FX_MODE_TRICOLOR_FADE]           = &WS2812FX::mode_tricolor_fade;
-      _mode[FX_MODE_BREATH]                  = &WS2812FX::mode_breath;
-      _mode[FX_MODE_RUNNING_LIGHTS]          = &WS2812FX::mode_running_lights;
-      _mode[FX_MODE_LIGHTNING]               = &WS2812FX::mode_lightning;
-      _mode[FX_MODE_ICU]                     = &WS2812FX::mode_icu;
-      _mode[FX_MODE_MULTI_COMET]             = &WS2812FX::mode_multi_comet;
-      _mode[FX_MODE_DUAL_LARSON_SCANNER]     = &WS2812FX::mode_dual_larson_scanner;
-      _mode[FX_MODE_RANDOM_CHASE]            = &WS2812FX::mode_random_chase;
-      _mode[FX_MODE_OSCILLATE]               = &WS2812FX::mode_oscillate;
-      _mode[FX_MODE_FIRE_2012]               = &WS2812FX::mode_fire_2012;
-      _mode[FX_MODE_PRIDE_2015]              = &WS2812FX::mode_pride_2015;
-      _mode[FX_MODE_BPM]                     = &WS2812FX::mode_bpm;
-      _mode[FX_MODE_JUGGLE]                  = &WS2812FX::mode_juggle;
-      _mode[FX_MODE_PALETTE]                 = &WS2812FX::mode_palette;
-      _mode[FX_MODE_COLORWAVES]              = &WS2812FX::mode_colorwaves;
-      _mode[FX_MODE_FILLNOISE8]              = &WS2812FX::mode_fillnoise8;
-      _mode[FX_MODE_NOISE16_1]               = &WS2812FX::mode_noise16_1;
-      _mode[FX_MODE_NOISE16_2]               = &WS2812FX::mode_noise16_2;
-      _mode[FX_MODE_NOISE16_3]               = &WS2812FX::mode_noise16_3;
-      _mode[FX_MODE_NOISE16_4]               = &WS2812FX::mode_noise16_4;
-      _mode[FX_MODE_COLORTWINKLE]            = &WS2812FX::mode_colortwinkle;
-      _mode[FX_MODE_LAKE]                    = &WS2812FX::mode_lake;
-      _mode[FX_MODE_METEOR]                  = &WS2812FX::mode_meteor;
-      _mode[FX_MODE_METEOR_SMOOTH]           = &WS2812FX::mode_meteor_smooth;
-      _mode[FX_MODE_RAILWAY]                 = &WS2812FX::mode_railway;
-      _mode[FX_MODE_RIPPLE]                  = &WS2812FX::mode_ripple;
-      _mode[FX_MODE_TWINKLEFOX]              = &WS2812FX::mode_twinklefox;
-      _mode[FX_MODE_TWINKLECAT]              = &WS2812FX::mode_twinklecat;
-      _mode[FX_MODE_HALLOWEEN_EYES]          = &WS2812FX::mode_halloween_eyes;
-      _mode[FX_MODE_STATIC_PATTERN]          = &WS2812FX::mode_static_pattern;
-      _mode[FX_MODE_TRI_STATIC_PATTERN]      = &WS2812FX::mode_tri_static_pattern;
-      _mode[FX_MODE_SPOTS]                   = &WS2812FX::mode_spots;
-      _mode[FX_MODE_SPOTS_FADE]              = &WS2812FX::mode_spots_fade;
-      _mode[FX_MODE_GLITTER]                 = &WS2812FX::mode_glitter;
-      _mode[FX_MODE_CANDLE]                  = &WS2812FX::mode_candle;
-      _mode[FX_MODE_STARBURST]               = &WS2812FX::mode_starburst;
-      _mode[FX_MODE_EXPLODING_FIREWORKS]     = &WS2812FX::mode_exploding_fireworks;
-      _mode[FX_MODE_BOUNCINGBALLS]           = &WS2812FX::mode_bouncing_balls;
-      _mode[FX_MODE_SINELON]                 = &WS2812FX::mode_sinelon;
-      _mode[FX_MODE_SINELON_DUAL]            = &WS2812FX::mode_sinelon_dual;
-      _mode[FX_MODE_SINELON_RAINBOW]         = &WS2812FX::mode_sinelon_rainbow;
-      _mode[FX_MODE_POPCORN]                 = &WS2812FX::mode_popcorn;
-      _mode[FX_MODE_DRIP]                    = &WS2812FX::mode_drip;
-      _mode[FX_MODE_PLASMA]                  = &WS2812FX::mode_plasma;
-      _mode[FX_MODE_PERCENT]                 = &WS2812FX::mode_percent;
-      _mode[FX_MODE_RIPPLE_RAINBOW]          = &WS2812FX::mode_ripple_rainbow;
-      _mode[FX_MODE_HEARTBEAT]               = &WS2812FX::mode_heartbeat;
-      _mode[FX_MODE_PACIFICA]                = &WS2812FX::mode_pacifica;
-      _mode[FX_MODE_CANDLE_MULTI]            = &WS2812FX::mode_candle_multi;
-      _mode[FX_MODE_SOLID_GLITTER]           = &WS2812FX::mode_solid_glitter;
-      _mode[FX_MODE_SUNRISE]                 = &WS2812FX::mode_sunrise;
-      _mode[FX_MODE_PHASED]                  = &WS2812FX::mode_phased;
-      _mode[FX_MODE_TWINKLEUP]               = &WS2812FX::mode_twinkleup;
-      _mode[FX_MODE_NOISEPAL]                = &WS2812FX::mode_noisepal;
-      _mode[FX_MODE_SINEWAVE]                = &WS2812FX::mode_sinewave;
-      _mode[FX_MODE_PHASEDNOISE]             = &WS2812FX::mode_phased_noise;
-      _mode[FX_MODE_FLOW]                    = &WS2812FX::mode_flow;
-      _mode[FX_MODE_CHUNCHUN]                = &WS2812FX::mode_chunchun;
-      _mode[FX_MODE_DANCING_SHADOWS]         = &WS2812FX::mode_dancing_shadows;
-      _mode[FX_MODE_WASHING_MACHINE]         = &WS2812FX::mode_washing_machine;
-      _mode[FX_MODE_CANDY_CANE]              = &WS2812FX::mode_candy_cane;
-      _mode[FX_MODE_BLENDS]                  = &WS2812FX::mode_blends;
-      _mode[FX_MODE_TV_SIMULATOR]            = &WS2812FX::mode_tv_simulator;
-      _mode[FX_MODE_DYNAMIC_SMOOTH]          = &WS2812FX::mode_dynamic_smooth;
-
       _brightness = DEFAULT_BRIGHTNESS;
       currentPalette = CRGBPalette16(CRGB::Black);
       targetPalette = CloudColors_p;
       ablMilliampsMax = 850;
       currentMilliamps = 0;
       timebase = 0;
+      for (uint8_t i = 0; i < WLED_LEDMAP_CACHE; i++) _ledmapCache[i] = {nullptr, nullptr, 0, 0, 255};
+      growSegments(1);
       resetSegments();
     }
 
     void
-      finalizeInit(),
+      finalizeInit(bool keepState = false),
       service(void),
       blur(uint8_t),
+      blur2d(uint8_t),
+      blurRows(uint8_t),
+      blurColumns(uint8_t),
       fill(uint32_t),
+      fillRect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint32_t c),
       fade_out(uint8_t r),
       setMode(uint8_t segid, uint8_t m),
       setColor(uint8_t slot, uint8_t r, uint8_t g, uint8_t b, uint8_t w = 0),
       setColor(uint8_t slot, uint32_t c),
       setBrightness(uint8_t b),
       setRange(uint16_t i, uint16_t i2, uint32_t col),
+      drawOverlayRange(uint16_t i, uint16_t i2, uint32_t col),
       setShowCallback(show_callback cb),
       setTransition(uint16_t t),
       setTransitionMode(bool t),
       calcGammaTable(float),
       trigger(void),
+      beginUpdate(void),
+      endUpdate(void),
+      prepareMorph(void),
+      startMorph(uint32_t dur),
+      stopMorph(void),
       setSegment(uint8_t n, uint16_t start, uint16_t stop, uint8_t grouping = 0, uint8_t spacing = 0),
+      setSegmentGeometry(uint8_t n, uint16_t width, uint16_t height, uint8_t layout),
+      setSegmentScale(uint8_t n, uint8_t scale),
       resetSegments(),
+      setRandomSeed(uint32_t seed),
       makeAutoSegments(),
       fixInvalidSegments(),
       setPixelColor(uint16_t n, uint32_t c),
       setPixelColor(uint16_t n, uint8_t r, uint8_t g, uint8_t b, uint8_t w = 0),
+      setPixelColorXY(uint16_t x, uint16_t y, uint32_t c),
+      setPixelSpan(uint16_t start, const uint32_t* colors, uint16_t len),
+      setRealtimeSpan(uint16_t start, const uint8_t* data, uint16_t len, bool rgbw, bool gamma),
       show(void),
+      setTargetFps(uint8_t fps),
       setPixelSegment(uint8_t n),
-      deserializeMap(uint8_t n=0);
+      deserializeMap(uint8_t n=0),
+      setLedmap(uint8_t n),
+      reloadLedmaps(void),
+      loadCustomPalettes(void);
 
     bool
       isRgbw = false,
       isOffRefreshRequred = false, //periodic refresh is required for the strip to remain off.
       gammaCorrectBri = false,
       gammaCorrectCol = true,
+      gammaCorrectOut = false, //color gamma by the busses, with 16 bit precision through brightness
       applyToAllSelected = true,
+      updateOutputGamma(void),
+      hasLiveSegments(void),
+      isLive(uint8_t n),
+      isRealtimePixel(uint16_t i),
       setEffectConfig(uint8_t m, uint8_t s, uint8_t i, uint8_t p),
       checkSegmentAlignment(void),
       // return true if the strip is being sent pixel updates
@@ -682,7 +1000,9 @@ class WS2812FX {
       ablMilliampsMax,
       currentMilliamps,
       triwave16(uint16_t),
+      XY(uint16_t x, uint16_t y),
       getLengthTotal(void),
+      getTargetFps(void),
       getLengthPhysical(void),
       getFps();
 
@@ -691,15 +1011,60 @@ class WS2812FX {
       timebase,
       color_wheel(uint8_t),
       color_from_palette(uint16_t, bool mapping, bool wrap, uint8_t mcol, uint8_t pbri = 255),
+      paletteLookup(uint8_t index, uint8_t pbri, TBlendType blendType),
       color_blend(uint32_t,uint32_t,uint16_t,bool b16=false),
       currentColor(uint32_t colorNew, uint8_t tNr),
       gamma32(uint32_t),
       getLastShow(void),
       getPixelColor(uint16_t),
+      getPixelColorXY(uint16_t x, uint16_t y),
       getColor(void);
 
     WS2812FX::Segment&
-      getSegment(uint8_t n);
+      getSegment(uint8_t n); //makes room for segment n if it was not used yet
+
+    //segments with id below this exist (active or not), loops over all segments should stop here
+    inline uint8_t getSegmentCount(void) { return _segCapacity; }
+
+    //all segment names share one buffer, nullptr if segment n has no name
+    const char*
+      getSegmentName(uint8_t n);
+
+    bool
+      setSegmentName(uint8_t n, const char* name); //false if it did not fit, nullptr or "" removes the name
+
+    SegmentArena&
+      getSegmentArena(void) { return _arena; }
+
+    //bytes of the LED maps (active and cached) and of the composite buffer (0 while no segment blends)
+    uint32_t getMappingMemory(void);
+    inline uint32_t getCompositeMemory(void) { return _compBuffer ? _length * sizeof(uint32_t) : 0; }
+    inline uint8_t getLedmap(void) { return _ledmapId; } //n of the active /ledmapN.json
+    inline uint8_t getCustomPaletteCount(void) { return _customPaletteCount; }
+    inline const CRGBPalette16& getCustomPalette(uint8_t n) { return _customPalettes[n]; } //n < getCustomPaletteCount()
+
+    inline uint16_t getFrameTime(void) { return _frametime; }
+
+    const SegmentPerf&
+      getSegmentPerf(uint8_t n) { return _segPerf[n < _segCapacity ? n : 0]; }
+
+    const PerfStat&
+      getShowPerf(void) { return _showPerf; },
+      getBusPerf(void) { return _busPerf; };
+
+    //results of the last benchmark, nullptr if none ran. Indexed by mode, count is MODE_COUNT
+    const BenchResult*
+      getBenchmark(void) { return _bench; }
+
+    void
+      startBenchmark(uint8_t frames);
+
+    inline bool isBenchmarkRunning(void) { return _benchFrames; }
+    inline bool inStateUpdate(void) { return _updateDepth; } //between beginUpdate() and endUpdate()
+    inline bool isMorphing(void) { return _morphDur; }
+    inline bool hasOutputGamma(void) { return _outputGamma; } //colors are written without gamma correction
+    inline uint8_t getBenchmarkMode(void) { return _benchMode; }
+    inline uint16_t getBenchmarkLength(void) { return _benchLen; }
 
     WS2812FX::Segment_runtime
       getSegmentRuntime(void);
@@ -827,7 +1192,8 @@ class WS2812FX {
       mode_candy_cane(void),
       mode_blends(void),
       mode_tv_simulator(void),
-      mode_dynamic_smooth(void);
+      mode_dynamic_smooth(void),
+      mode_audio_spectrum(void);
 
   private:
     uint32_t crgb_to_col(CRGB fastled);
@@ -836,17 +1202,48 @@ class WS2812FX {
     CRGBPalette16 targetPalette;
 
     uint16_t _length, _virtualSegmentLength;
-    uint16_t _rand16seed;
+    uint16_t _virtualWidth = 0, _virtualHeight = 0;
+    uint32_t _randomSeed = 0;
     uint8_t _brightness;
-    uint16_t _usedSegmentData = 0;
+    SegmentArena _arena;
     uint16_t _transitionDur = 750;
 
     uint16_t _cumulativeFps = 2;
 
+    SegmentPerf* _segPerf = nullptr;
+    PerfStat _showPerf = {}, _busPerf = {}; //whole show() and the bus transmit within it
+
+    BenchResult* _bench = nullptr;
+    uint32_t _benchStart = 0;
+    uint16_t _benchLen = 0;
+    uint8_t _benchFrames = 0, _benchMode = 0, _benchModePrev = 0;
+    void benchmarkMode(uint8_t m);
+    void handleBenchmark(uint32_t nowUp);
+    uint32_t segmentSeed(uint8_t n);
+
     bool
       _triggered;
 
-    mode_ptr _mode[MODE_COUNT]; // SRAM footprint: 4 bytes per element
+    volatile uint8_t _updateDepth = 0; //nesting of beginUpdate(), nothing is rendered while > 0
+    uint32_t _updateTime = 0;          //start time given to the transitions begun during the update
+
+    //values of a segment a preset morph interpolates between, see prepareMorph()
+    typedef struct SegmentMorph {
+      CRGBPalette16 palFrom;
+      uint32_t colFrom[NUM_COLORS], colTo[NUM_COLORS];
+      uint8_t speedFrom, speedTo, intensityFrom, intensityTo, opacityFrom, opacityTo;
+      bool active;  //on before and after, the other segments change at once
+      bool hasPal;  //palFrom holds the palette shown before
+    } SegmentMorph;
+    SegmentMorph* _morph = nullptr;  //one per segment id below _morphSegs
+    uint8_t _morphSegs = 0;
+    uint32_t _morphStart = 0;
+    uint32_t _morphDur = 0;          //0 while prepared but not started yet
+    uint16_t _morphProg = 0;         //0 - 0xFFFF, set once per frame
+    void handleMorph(uint32_t nowUp);
+
+    static const EffectDesc _effects[MODE_COUNT]; // in flash, FX.cpp
+    inline void getEffect(uint8_t m, EffectDesc& fx) { memcpy_P(&fx, &_effects[m < MODE_COUNT ? m : 0], sizeof(EffectDesc)); }
 
     show_callback _callback = nullptr;
 
@@ -871,35 +1268,145 @@ class WS2812FX {
       spots_base(uint16_t),
       phased_base(uint8_t);
 
+    CRGB palette_color(uint8_t index, uint8_t pbri = 255);
+
+    //calls draw(i, value) for every pixel of the segment with value = noise(i), where noise(i) is only evaluated
+    //on a lattice of 1 << SEGMENT.noiseShift pixels and linearly interpolated in between
+    template <typename N, typename D> void forEachNoise(N noise, D draw) {
+      uint8_t shift = MIN(SEGMENT.noiseShift, SEG_NOISE_MAX_SHIFT);
+      if (!shift) {
+        for (uint16_t i = 0; i < SEGLEN; i++) draw(i, noise(i));
+        return;
+      }
+      uint16_t step = 1 << shift;
+      int32_t a = noise(0);
+      for (uint16_t i = 0; i < SEGLEN; i += step) {
+        int32_t b = noise(i + step); //may lie past the end, the field is defined there too
+        for (uint16_t k = 0; k < step && i + k < SEGLEN; k++) draw(i + k, a + (((b - a) * k) >> shift));
+        a = b;
+      }
+    }
+
     CRGB twinklefox_one_twinkle(uint32_t ms, uint8_t salt, bool cat);
     CRGB pacifica_one_layer(uint16_t i, CRGBPalette16& p, uint16_t cistart, uint16_t wavescale, uint8_t bri, uint16_t ioff);
 
     void
       blendPixelColor(uint16_t n, uint32_t color, uint8_t blend),
+      setPixelColorMapped(uint16_t i, uint32_t col),
+      setOutputPixelMapped(uint16_t f, uint32_t col),
+      selectPixelWriter(void),
+      autoWhite(uint8_t &r, uint8_t &g, uint8_t &b, uint8_t &w),
+      writeSpan(uint16_t start, const uint32_t* colors, uint16_t len),
+      writeRealtimeSpan(uint16_t start, const uint8_t* data, uint16_t len, bool rgbw, bool gamma),
+      attachSegmentBuffer(uint8_t fxFlags),
+      flushSegmentBuffer(void),
+      buildSegmentMap(void),
+      buildXYMap(void),
+      blurLine(uint16_t x, uint16_t y, bool vertical, uint8_t blur_amount),
+      clearCustomMapping(void),
+      compressCustomMapping(void),
+      buildMatrixMapping(uint16_t w, uint16_t h, bool serpentine, bool vertical),
       startTransition(uint8_t oldBri, uint32_t oldCol, uint16_t dur, uint8_t segn, uint8_t slot),
       estimateCurrentAndLimitBri(void),
       load_gradient_palette(uint8_t),
-      handle_palette(void);
+      loadPalette(uint8_t index),
+      handle_palette(uint8_t defaultPalette);
+
+    bool segmentOverlaps(uint8_t n);
+    int16_t cloneSource(uint8_t n);
+    bool isCloneSource(uint8_t n);
+    uint32_t outputPixel(const uint32_t* buf, uint16_t f);
+    void renderClone(uint8_t src);
+    bool usesBlending(void);
+    void updateActiveSegments(void);
+    void startEffectTransition(void);
+    void endEffectTransition(void);
+    uint16_t renderOutgoingEffect(uint32_t nowUp);
+    void compositeSegments(void);
+    void compositeSegment(uint32_t* comp);
+    uint16_t segmentXY(uint16_t x, uint16_t y);
+    uint32_t busMilliamps(Bus* bus, uint8_t bri);
+
+    uint32_t* _segPixels = nullptr; //framebuffer of the segment currently being rendered, if any
+    uint32_t* directBuffer(void); //_segPixels if setPixelColor() would store colors unchanged, for the batched kernels
+    uint32_t* _compBuffer = nullptr; //output the segment framebuffers are blended into, only while a segment uses a blend mode
+    bool _compositing = false;
+
+    //compressed custom mapping: logical pixels start..start+len-1 map to base, base+stride, ...
+    typedef struct MapRun {
+      uint16_t start;
+      uint16_t len;
+      uint16_t base;
+      int16_t  stride;
+    } MapRun;
 
     uint16_t* customMappingTable = nullptr;
+    MapRun*   customMappingRuns  = nullptr; //used instead of the table if the map compresses well
+    uint16_t  customMappingRunCount = 0;
     uint16_t  customMappingSize  = 0;
+    uint16_t  _lastMapRun = 0;              //most lookups hit the same or the next run
+    uint8_t   _ledmapId = 0;
+
+    //maps used before, kept in memory so switching back to them does not read the file again. Most recent first, id 255 is a free slot
+    typedef struct CachedLedmap {
+      uint16_t* table;
+      MapRun*   runs;
+      uint16_t  runCount;
+      uint16_t  size;
+      uint8_t   id;
+    } CachedLedmap;
+    CachedLedmap _ledmapCache[WLED_LEDMAP_CACHE];
+    void clearLedmapCache(void);
+
+    CRGBPalette16* _customPalettes = nullptr; //expanded once on load, segments copy them into their palette cache
+    uint8_t _customPaletteCount = 0;
+    uint8_t _customPaletteVersion = 0;        //part of the palette cache key, so segments pick up a replaced file
+
+    //writes the physical pixels of an output pixel for one combination of segment options, see selectPixelWriter()
+    typedef void (WS2812FX::*PixelWriter)(uint16_t f, uint32_t col);
+    template<bool REV, bool MIR, bool GRP, bool MAP> void writeOutputPixel(uint16_t f, uint32_t col);
+    PixelWriter _pixelWriter = nullptr;
+    uint8_t _pixelWriterSeg = 0xFF; //segment _pixelWriter was picked for, 0xFF after the options or the mapping changed
+
+    uint16_t mapPixelRun(uint16_t i);
+    inline uint16_t mapPixel(uint16_t i) {
+      if (i >= customMappingSize) return i;
+      if (customMappingTable) return customMappingTable[i];
+      return mapPixelRun(i);
+    }
     
-    uint32_t _lastPaletteChange = 0;
     uint32_t _lastShow = 0;
 
+    bool _forceFlush = true; //busses were written outside of segment framebuffers, all segments must be flushed again
+    bool _outputGamma = false;
+    uint8_t _lastShowBri = 0;
+
+    uint16_t _frametime = FRAMETIME_FIXED;
+    uint8_t _targetFps = WLED_FPS;
+    bool _showPending = false; //a rendered frame is waiting for the busses to finish sending the previous one
+
     uint32_t _colors_t[3];
     uint8_t _bri_t;
     
     uint8_t _segment_index = 0;
-    uint8_t _segment_index_palette_last = 99;
-    segment _segments[MAX_NUM_SEGMENTS] = { // SRAM footprint: 24 bytes per element
-      // start, stop, offset, speed, intensity, palette, mode, options, grouping, spacing, opacity (unused), color[]
-      {0, 7, 0, DEFAULT_SPEED, 128, 0, DEFAULT_MODE, NO_OPTIONS, 1, 0, 255, {DEFAULT_COLOR}}
-    };
-    segment_runtime _segment_runtimes[MAX_NUM_SEGMENTS]; // SRAM footprint: 28 bytes per element
+    //per segment state for ids below _segCapacity, grown by growSegments() when a higher id is used
+    segment* _segments = nullptr;
+    segment_runtime* _segment_runtimes = nullptr;
+    uint8_t _segCapacity = 0;
+    bool growSegments(uint8_t n);
+    void initSegment(uint8_t n);
+    uint8_t _activeSegs[MAX_NUM_SEGMENTS]; //ids of the active segments in id order, see updateActiveSegments()
+    uint8_t _numActiveSegs = 0;
+    bool _activeSegsDirty = true;
+    char* _segNames = nullptr; //names in segment order, each terminated
+    uint16_t _segNamesSize = 0;
+    uint8_t _segNameLen[MAX_NUM_SEGMENTS] = {0}; //0 if the segment has no name
     friend class Segment_runtime;
 
-    ColorTransition transitions[MAX_NUM_TRANSITIONS]; //12 bytes per element
+    ColorTransition* transitions = nullptr; //pool, 12 bytes per element, grows as memory allows
+    uint8_t _numTransitions = 0;
+    uint8_t (*_transitionIndex)[NUM_COLORS] = nullptr; //pool index of the running transition of each segment color, 0xFF if none
+    uint8_t allocateTransition();
     friend class ColorTransition;
 
     uint16_t
@@ -908,20 +1415,38 @@ class WS2812FX {
 };
 
 //10 names per line
-const char JSON_mode_names[] PROGMEM = R"=====([
-"Solid","Blink","Breathe","Wipe","Wipe Random","Random Colors","Sweep","Dynamic","Colorloop","Rainbow",
-"Scan","Scan Dual","Fade","Theater","Theater Rainbow","Running","Saw","Twinkle","Dissolve","Dissolve Rnd",
-"Sparkle","Sparkle Dark","Sparkle+","Strobe","Strobe Rainbow","Strobe Mega","Blink Rainbow","Android","Chase","Chase Random",
-"Chase Rainbow","Chase Flash","Chase Flash Rnd","Rainbow Runner","Colorful","Traffic Light","Sweep Random","Running 2","Aurora","Stream",
-"Scanner","Lighthouse","Fireworks","Rain","Tetrix","Fire Flicker","Gradient","Loading","Police","Police All",
-"Two Dots","Two Areas","Running Dual","Halloween","Tri Chase","Tri Wipe","Tri Fade","Lightning","ICU","Multi Comet",
-"Scanner Dual","Stream 2","Oscillate","Pride 2015","Juggle","Palette","Fire 2012","Colorwaves","Bpm","Fill Noise",
-"Noise 1","Noise 2","Noise 3","Noise 4","Colortwinkles","Lake","Meteor","Meteor Smooth","Railway","Ripple",
-"Twinklefox","Twinklecat","Halloween Eyes","Solid Pattern","Solid Pattern Tri","Spots","Spots Fade","Glitter","Candle","Fireworks Starburst",
-"Fireworks 1D","Bouncing Balls","Sinelon","Sinelon Dual","Sinelon Rainbow","Popcorn","Drip","Plasma","Percent","Ripple Rainbow",
-"Heartbeat","Pacifica","Candle Multi", "Solid Glitter","Sunrise","Phased","Twinkleup","Noise Pal", "Sine","Phased Noise",
-"Flow","Chunchun","Dancing Shadows","Washing Machine","Candy Cane","Blends","TV Simulator","Dynamic Smooth"
-])=====";
+const char JSON_mode_names[] PROGMEM = "[\"Solid\""
+  FX_NAME(BLINK,"Blink") FX_NAME(BREATH,"Breathe") FX_NAME(COLOR_WIPE,"Wipe") FX_NAME(COLOR_WIPE_RANDOM,"Wipe Random")
+  FX_NAME(RANDOM_COLOR,"Random Colors") FX_NAME(COLOR_SWEEP,"Sweep") FX_NAME(DYNAMIC,"Dynamic") FX_NAME(RAINBOW,"Colorloop")
+  FX_NAME(RAINBOW_CYCLE,"Rainbow") FX_NAME(SCAN,"Scan") FX_NAME(DUAL_SCAN,"Scan Dual") FX_NAME(FADE,"Fade")
+  FX_NAME(THEATER_CHASE,"Theater") FX_NAME(THEATER_CHASE_RAINBOW,"Theater Rainbow") FX_NAME(RUNNING_LIGHTS,"Running") FX_NAME(SAW,"Saw")
+  FX_NAME(TWINKLE,"Twinkle") FX_NAME(DISSOLVE,"Dissolve") FX_NAME(DISSOLVE_RANDOM,"Dissolve Rnd") FX_NAME(SPARKLE,"Sparkle")
+  FX_NAME(FLASH_SPARKLE,"Sparkle Dark") FX_NAME(HYPER_SPARKLE,"Sparkle+") FX_NAME(STROBE,"Strobe") FX_NAME(STROBE_RAINBOW,"Strobe Rainbow")
+  FX_NAME(MULTI_STROBE,"Strobe Mega") FX_NAME(BLINK_RAINBOW,"Blink Rainbow") FX_NAME(ANDROID,"Android") FX_NAME(CHASE_COLOR,"Chase")
+  FX_NAME(CHASE_RANDOM,"Chase Random") FX_NAME(CHASE_RAINBOW,"Chase Rainbow") FX_NAME(CHASE_FLASH,"Chase Flash") FX_NAME(CHASE_FLASH_RANDOM,"Chase Flash Rnd")
+  FX_NAME(CHASE_RAINBOW_WHITE,"Rainbow Runner") FX_NAME(COLORFUL,"Colorful") FX_NAME(TRAFFIC_LIGHT,"Traffic Light") FX_NAME(COLOR_SWEEP_RANDOM,"Sweep Random")
+  FX_NAME(RUNNING_COLOR,"Running 2") FX_NAME(AURORA,"Aurora") FX_NAME(RUNNING_RANDOM,"Stream") FX_NAME(LARSON_SCANNER,"Scanner")
+  FX_NAME(COMET,"Lighthouse") FX_NAME(FIREWORKS,"Fireworks") FX_NAME(RAIN,"Rain") FX_NAME(TETRIX,"Tetrix")
+  FX_NAME(FIRE_FLICKER,"Fire Flicker") FX_NAME(GRADIENT,"Gradient") FX_NAME(LOADING,"Loading") FX_NAME(POLICE,"Police")
+  FX_NAME(POLICE_ALL,"Police All") FX_NAME(TWO_DOTS,"Two Dots") FX_NAME(TWO_AREAS,"Two Areas") FX_NAME(RUNNING_DUAL,"Running Dual")
+  FX_NAME(HALLOWEEN,"Halloween") FX_NAME(TRICOLOR_CHASE,"Tri Chase") FX_NAME(TRICOLOR_WIPE,"Tri Wipe") FX_NAME(TRICOLOR_FADE,"Tri Fade")
+  FX_NAME(LIGHTNING,"Lightning") FX_NAME(ICU,"ICU") FX_NAME(MULTI_COMET,"Multi Comet") FX_NAME(DUAL_LARSON_SCANNER,"Scanner Dual")
+  FX_NAME(RANDOM_CHASE,"Stream 2") FX_NAME(OSCILLATE,"Oscillate") FX_NAME(PRIDE_2015,"Pride 2015") FX_NAME(JUGGLE,"Juggle")
+  FX_NAME(PALETTE,"Palette") FX_NAME(FIRE_2012,"Fire 2012") FX_NAME(COLORWAVES,"Colorwaves") FX_NAME(BPM,"Bpm")
+  FX_NAME(FILLNOISE8,"Fill Noise") FX_NAME(NOISE16_1,"Noise 1") FX_NAME(NOISE16_2,"Noise 2") FX_NAME(NOISE16_3,"Noise 3")
+  FX_NAME(NOISE16_4,"Noise 4") FX_NAME(COLORTWINKLE,"Colortwinkles") FX_NAME(LAKE,"Lake") FX_NAME(METEOR,"Meteor")
+  FX_NAME(METEOR_SMOOTH,"Meteor Smooth") FX_NAME(RAILWAY,"Railway") FX_NAME(RIPPLE,"Ripple") FX_NAME(TWINKLEFOX,"Twinklefox")
+  FX_NAME(TWINKLECAT,"Twinklecat") FX_NAME(HALLOWEEN_EYES,"Halloween Eyes") FX_NAME(STATIC_PATTERN,"Solid Pattern") FX_NAME(TRI_STATIC_PATTERN,"Solid Pattern Tri")
+  FX_NAME(SPOTS,"Spots") FX_NAME(SPOTS_FADE,"Spots Fade") FX_NAME(GLITTER,"Glitter") FX_NAME(CANDLE,"Candle")
+  FX_NAME(STARBURST,"Fireworks Starburst") FX_NAME(EXPLODING_FIREWORKS,"Fireworks 1D") FX_NAME(BOUNCINGBALLS,"Bouncing Balls") FX_NAME(SINELON,"Sinelon")
+  FX_NAME(SINELON_DUAL,"Sinelon Dual") FX_NAME(SINELON_RAINBOW,"Sinelon Rainbow") FX_NAME(POPCORN,"Popcorn") FX_NAME(DRIP,"Drip")
+  FX_NAME(PLASMA,"Plasma") FX_NAME(PERCENT,"Percent") FX_NAME(RIPPLE_RAINBOW,"Ripple Rainbow") FX_NAME(HEARTBEAT,"Heartbeat")
+  FX_NAME(PACIFICA,"Pacifica") FX_NAME(CANDLE_MULTI,"Candle Multi") FX_NAME(SOLID_GLITTER,"Solid Glitter") FX_NAME(SUNRISE,"Sunrise")
+  FX_NAME(PHASED,"Phased") FX_NAME(TWINKLEUP,"Twinkleup") FX_NAME(NOISEPAL,"Noise Pal") FX_NAME(SINEWAVE,"Sine")
+  FX_NAME(PHASEDNOISE,"Phased Noise") FX_NAME(FLOW,"Flow") FX_NAME(CHUNCHUN,"Chunchun") FX_NAME(DANCING_SHADOWS,"Dancing Shadows")
+  FX_NAME(WASHING_MACHINE,"Washing Machine") FX_NAME(CANDY_CANE,"Candy Cane") FX_NAME(BLENDS,"Blends") FX_NAME(TV_SIMULATOR,"TV Simulator")
+  FX_NAME(DYNAMIC_SMOOTH,"Dynamic Smooth") FX_NAME(AUDIO_SPECTRUM,"Audio Spectrum")
+  "]";
 
 
 const char JSON_palette_names[] PROGMEM = R"=====([
@@ -27,6 +27,8 @@
 #include "FX.h"
 #include "palettes.h"
 
+extern byte gammaT[];
+
 /*
   Custom per-LED mapping has moved!
 
@@ -65,9 +67,11 @@
 #endif
 
 //do not call this method from system context (network callback)
-void WS2812FX::finalizeInit(void)
+//keepState: after a bus re-init, effect runtime data and the ledmap are kept if the total LED count did not change
+void WS2812FX::finalizeInit(bool keepState)
 {
-  RESET_RUNTIME;
+  uint16_t prevLength = _length;
+  _forceFlush = true;
   isRgbw = isOffRefreshRequred = false;
 
   //if busses failed to load, add default (fresh install, FS issue, ...)
@@ -86,8 +90,6 @@ void WS2812FX::finalizeInit(void)
       busses.add(defCfg);
     }
   }
-  
-  deserializeMap();
 
   _length = 0;
   for (uint8_t i=0; i<busses.getNumBusses(); i++) {
@@ -109,28 +111,92 @@ void WS2812FX::finalizeInit(void)
     #endif
   }
 
+  if (!keepState || _length != prevLength) {
+    for (uint8_t i = 0; i < _segCapacity; i++) {
+      _segment_index = i;
+      endEffectTransition();
+      _segment_runtimes[i].deallocateAll();
+    }
+    _segment_index = 0;
+    RESET_RUNTIME;
+    free(_compBuffer); //sized for the old LED count
+    _compBuffer = nullptr;
+    clearLedmapCache(); //the maps may be made for the old length
+    deserializeMap(_ledmapId);
+  }
+
   //segments are created in makeAutoSegments();
 
   setBrightness(_brightness);
 }
 
+#ifdef WLED_ENABLE_TRACE
+static bool traceBusSending = false; //the first poll that finds the busses done marks the end of the last frame
+#endif
+
 void WS2812FX::service() {
   uint32_t nowUp = millis(); // Be aware, millis() rolls over every 49 days
   now = nowUp + timebase;
-  if (nowUp - _lastShow < MIN_SHOW_DELAY) return;
+  // NeoPixelBus RMT/I2S methods are double buffered: the next frame is rendered into the back buffer
+  // while DMA still sends the previous one. Hand a finished frame over once the busses are ready
+  // instead of blocking in show(), and do not render another one on top of it in the meantime.
+  #ifdef WLED_ENABLE_TRACE
+  if (traceBusSending && busses.canAllShow()) { TRACE_INSTANT(TRACE_BUS_READY, 0); traceBusSending = false; }
+  #endif
+  updateOutputGamma();
+  if (_updateDepth) return; //state is being changed, the frame would show half of it
+  if (_showPending) {
+    if (busses.canAllShow()) show();
+    return;
+  }
+  if (nowUp - _lastShow < MIN(MIN_SHOW_DELAY, _frametime)) return;
   bool doShow = false;
+  if (_benchFrames) _triggered = true; //render every effect as often as possible
 
-  for(uint8_t i=0; i < MAX_NUM_SEGMENTS; i++)
+  if (_activeSegsDirty) updateActiveSegments();
+  handleMorph(nowUp);
+  if (_forceFlush || _triggered) {
+    for (uint8_t i = 0; i < _segCapacity; i++) _segment_runtimes[i].dirty = true;
+    _forceFlush = false;
+  }
+
+  //segments are composited into a buffer instead of written in turn while any of them is blended
+  _compositing = usesBlending();
+  if (_compositing && !_compBuffer) {
+    _compBuffer = (uint32_t*) malloc(_length * sizeof(uint32_t));
+    if (!_compBuffer) _compBuffer = (uint32_t*) allocLarge(_length * sizeof(uint32_t)); //large strips, PSRAM is slower but works
+    if (!_compBuffer) _compositing = false;
+  } else if (!_compositing && _compBuffer) {
+    free(_compBuffer);
+    _compBuffer = nullptr;
+    _forceFlush = true; //the busses hold the composite
+  }
+
+  //segments due within half a frame are rendered along with the ones that are due now,
+  //so segments at different rates share one show() instead of each causing their own
+  bool anyDue = _triggered;
+  for (uint8_t k = 0; k < _numActiveSegs && !anyDue; k++) {
+    if (nowUp > _segment_runtimes[_activeSegs[k]].next_time) anyDue = true;
+  }
+  uint32_t coalesceUntil = anyDue ? nowUp + (_frametime >> 1) : 0;
+  bool clones = false;
+
+  for(uint8_t k=0; k < _numActiveSegs; k++)
   {
+    uint8_t i = _activeSegs[k];
     _segment_index = i;
-
-    // reset the segment runtime data if needed, called before isActive to ensure deleted
-    // segment's buffers are cleared
+    selectPixelWriter();
+    if (cloneSource(i) >= 0) {clones = true; continue;} //copies its source once all segments rendered
+    if (isLive(i)) continue; //the busses hold the realtime data
+
+    // keep the outgoing effect for a crossfade, then
+    // reset the segment runtime data if needed (deleted segments are reset in updateActiveSegments())
+    if (SEGENV.resetPending() && SEGENV.fxFrom != 0xFF) startEffectTransition();
+    SEGENV.fxFrom = 0xFF;
     SEGENV.resetIfRequired();
+    if (!SEGENV.rng) SEGENV.rng = segmentSeed(i);
 
-    if (!SEGMENT.isActive()) continue;
-
-    if(nowUp > SEGENV.next_time || _triggered || (doShow && SEGMENT.mode == 0)) //last is temporary
+    if(nowUp > SEGENV.next_time || coalesceUntil >= SEGENV.next_time || _triggered || (doShow && SEGMENT.mode == 0)) //last is temporary
     {
       if (SEGMENT.grouping == 0) SEGMENT.grouping = 1; //sanity check
       doShow = true;
@@ -138,29 +204,173 @@ void WS2812FX::service() {
 
       if (!SEGMENT.getOption(SEG_OPTION_FREEZE)) { //only run effect function if not frozen
         _virtualSegmentLength = SEGMENT.virtualLength();
+        if (SEGMENT.is2D()) {
+          _virtualWidth = SEGMENT.virtualWidth(); _virtualHeight = SEGMENT.virtualHeight();
+          if (!SEGENV.xy) buildXYMap();
+        } else {
+          _virtualWidth = _virtualSegmentLength; _virtualHeight = 1;
+        }
         _bri_t = SEGMENT.opacity; _colors_t[0] = SEGMENT.colors[0]; _colors_t[1] = SEGMENT.colors[1]; _colors_t[2] = SEGMENT.colors[2];
         if (!IS_SEGMENT_ON) _bri_t = 0;
-        for (uint8_t t = 0; t < MAX_NUM_TRANSITIONS; t++) {
-          if ((transitions[t].segment & 0x3F) != i) continue;
-          uint8_t slot = transitions[t].segment >> 6;
+        for (uint8_t slot = 0; slot < NUM_COLORS; slot++) {
+          uint8_t t = _transitionIndex[i][slot];
+          if (t == 0xFF) continue;
           if (slot == 0) _bri_t = transitions[t].currentBri();
           _colors_t[slot] = transitions[t].currentColor(SEGMENT.colors[slot]);
         }
         for (uint8_t c = 0; c < 3; c++) _colors_t[c] = gamma32(_colors_t[c]);
-        handle_palette();
-        delay = (this->*_mode[SEGMENT.mode])(); //effect function
+        EffectDesc fx;
+        getEffect(SEGMENT.mode, fx);
+        uint16_t oldDelay = 0;
+        if (SEGENV.fxTransition) oldDelay = renderOutgoingEffect(nowUp);
+        attachSegmentBuffer(fx.flags);
+        if (SEGENV.fxTransition && !_segPixels) endEffectTransition(); //no buffer to crossfade into
+        //the output blends from the frame shown so far to the one about to be rendered
+        if (_segPixels && SEGMENT.getOption(SEG_OPTION_TWEEN) && !SEGENV.fxTransition
+            && SEGENV.allocateTween(SEGLEN, FAIR_DATA_PER_SEG * (getActiveSegmentsNum() -1))) {
+          memcpy(SEGENV.tweenPixels, _segPixels, SEGLEN * sizeof(uint32_t));
+          SEGENV.tweenStart = nowUp;
+          SEGENV.tweenDur = 0;
+        } else if (SEGENV.tweenPixels) {
+          SEGENV.deallocateTween();
+        }
+        uint32_t staticKey = 0;
+        if (fx.flags & FX_FLAG_STATIC) {
+          staticKey = _colors_t[0] ^ (_colors_t[1] << 7 | _colors_t[1] >> 25) ^ (_colors_t[2] << 14 | _colors_t[2] >> 18)
+                    ^ (_bri_t << 8 | SEGMENT.speed << 16 | (uint32_t)SEGMENT.intensity << 24) ^ SEGMENT.mode ^ (IS_TRANSITIONAL ? 0x80 : 0);
+        }
+        //the framebuffer still holds the output of a static effect if nothing it depends on changed
+        if (_segPixels && (fx.flags & FX_FLAG_STATIC) && SEGENV.call && SEGENV.staticDelay && SEGENV.staticKey == staticKey && !_triggered) {
+          delay = SEGENV.staticDelay;
+        } else {
+          handle_palette(fx.palette);
+          SegmentPerf& perf = _segPerf[i];
+          if (perf.mode != SEGMENT.mode || !perf.fx.count) {
+            perf.fx.reset(); perf.fps = 0; perf.mode = SEGMENT.mode;
+          } else {
+            uint32_t diff = nowUp - perf.lastFrame;
+            uint16_t fpsCurr = diff ? 1000 / diff : 200;
+            perf.fps = (3 * perf.fps + fpsCurr) >> 2;
+          }
+          perf.lastFrame = nowUp;
+          uint32_t fxStart = micros();
+          TRACE_BEGIN(TRACE_RENDER, i);
+          delay = (this->*fx.fn)(); //effect function
+          TRACE_END(TRACE_RENDER, i);
+          perf.fx.add(micros() - fxStart);
+          SEGENV.staticKey = staticKey;
+          SEGENV.staticDelay = (_segPixels && (fx.flags & FX_FLAG_STATIC)) ? delay : 0;
+        }
+        flushSegmentBuffer();
         if (SEGMENT.mode != FX_MODE_HALLOWEEN_EYES) SEGENV.call++;
+        if (SEGMENT.fps && delay < 1000 / SEGMENT.fps) delay = 1000 / SEGMENT.fps; //segment frame rate cap
+        if (SEGENV.fxTransition) delay = MIN(MIN(delay, oldDelay), FRAMETIME); //every frame while crossfading
+        if (SEGENV.tweenPixels) SEGENV.tweenDur = delay;
       }
 
       SEGENV.next_time = nowUp + delay;
+    } else if (SEGENV.tweenDur && nowUp - _lastShow >= _frametime && !SEGMENT.getOption(SEG_OPTION_FREEZE)
+               && nowUp - SEGENV.tweenStart < SEGENV.tweenDur + _frametime) { //in between two effect frames
+      _virtualSegmentLength = SEGMENT.virtualLength();
+      if (SEGENV.hasTween(SEGLEN) && SEGENV.hasPixels(SEGLEN)) {
+        _segPixels = SEGENV.pixels;
+        flushSegmentBuffer();
+        doShow = true;
+      }
+    }
+  }
+  if (clones && doShow) {
+    for (uint8_t k = 0; k < _numActiveSegs; k++) {
+      int16_t src = cloneSource(_activeSegs[k]);
+      if (src < 0) continue;
+      _segment_index = _activeSegs[k];
+      selectPixelWriter();
+      renderClone(src);
     }
   }
+  if (_compositing && doShow) compositeSegments();
   _virtualSegmentLength = 0;
+  _virtualWidth = 0; _virtualHeight = 0;
+  //dithering busses change their output every frame, also while the effects are idle
+  if (!doShow && nowUp - _lastShow >= _frametime && busses.isDithering()) doShow = true;
   if(doShow) {
     yield();
-    show();
+    if (busses.canAllShow()) show();
+    else _showPending = true;
   }
   _triggered = false;
+  if (_benchFrames) handleBenchmark(nowUp);
+}
+
+/*
+ * Runs every effect on the main segment in turn, for the given number of frames each, and records
+ * the render time from the profiler. 0 stops a running benchmark. The previous effect is restored when done.
+ */
+void WS2812FX::startBenchmark(uint8_t frames) {
+  if (!frames) {
+    if (_benchFrames) benchmarkMode(_benchModePrev);
+    _benchFrames = 0;
+    return;
+  }
+  if (!_bench) _bench = new BenchResult[MODE_COUNT];
+  if (!_bench) return;
+  mainSegment = getMainSegmentId(); //the benchmark indexes segment state with it
+  memset(_bench, 0, MODE_COUNT * sizeof(BenchResult));
+  if (!_benchFrames) _benchModePrev = _segments[mainSegment].mode;
+  _benchFrames = frames;
+  _benchLen = _segments[mainSegment].virtualLength();
+  benchmarkMode(0);
+}
+
+//switches the main segment without a crossfade
+void WS2812FX::benchmarkMode(uint8_t m) {
+  _benchMode = m;
+  _benchStart = millis();
+  _segment_runtimes[mainSegment].reset();
+  _segments[mainSegment].mode = m;
+  _segPerf[mainSegment].fx.reset();
+}
+
+//start of the random stream of segment n. Benchmarks always use the same streams, so their runs can be compared
+uint32_t WS2812FX::segmentSeed(uint8_t n) {
+  uint32_t s = _randomSeed;
+  if (!s) s = _benchFrames ? 1 : (((uint32_t)random16() << 16) | random16()) ^ micros();
+  s += n * 0x9E3779B9; //spread neighbouring ids, then mix (murmur3 finalizer)
+  s ^= s >> 16; s *= 0x85EBCA6B;
+  s ^= s >> 13; s *= 0xC2B2AE35;
+  s ^= s >> 16;
+  return s ? s : 1; //xorshift never leaves 0
+}
+
+//segment random streams start from seed (mixed with the segment id), 0 for a random start.
+//The effects start over, so nodes given the same seed run the same random sequence
+void WS2812FX::setRandomSeed(uint32_t seed) {
+  _randomSeed = seed;
+  for (uint8_t i = 0; i < _segCapacity; i++) {
+    if (_segments[i].isActive()) _segment_runtimes[i].reset();
+  }
+}
+
+void WS2812FX::handleBenchmark(uint32_t nowUp) {
+  SegmentPerf& perf = _segPerf[mainSegment];
+  if (_segments[mainSegment].mode != _benchMode) { //effect changed by the user, keep it
+    _benchFrames = 0;
+    return;
+  }
+  if (perf.fx.count < _benchFrames && nowUp - _benchStart < BENCH_TIMEOUT) return;
+  BenchResult& res = _bench[_benchMode];
+  res.us = perf.fx.avg;
+  res.frames = perf.fx.count;
+  res.data = _segment_runtimes[mainSegment].dataSize();
+  uint8_t next = _benchMode + 1;
+  EffectDesc fx;
+  for (; next < MODE_COUNT; next++) { getEffect(next, fx); if (!(fx.flags & FX_FLAG_UNUSED)) break; } //not built
+  if (next < MODE_COUNT) {
+    benchmarkMode(next);
+  } else {
+    benchmarkMode(_benchModePrev);
+    _benchFrames = 0;
+  }
 }
 
 void WS2812FX::setPixelColor(uint16_t n, uint32_t c) {
@@ -189,24 +399,27 @@ uint16_t WS2812FX::realPixelIndex(uint16_t i) {
   return realIndex;
 }
 
-void WS2812FX::setPixelColor(uint16_t i, byte r, byte g, byte b, byte w)
+//auto calculate white channel value if enabled
+void WS2812FX::autoWhite(byte &r, byte &g, byte &b, byte &w)
 {
-  //auto calculate white channel value if enabled
-  if (isRgbw) {
-    if (rgbwMode == RGBW_MODE_AUTO_BRIGHTER || (w == 0 && (rgbwMode == RGBW_MODE_DUAL || rgbwMode == RGBW_MODE_LEGACY)))
-    {
-      //white value is set to lowest RGB channel
-      //thank you to @Def3nder!
-      w = r < g ? (r < b ? r : b) : (g < b ? g : b);
-    } else if (rgbwMode == RGBW_MODE_AUTO_ACCURATE && w == 0)
-    {
-      w = r < g ? (r < b ? r : b) : (g < b ? g : b);
-      r -= w; g -= w; b -= w;
-    }
+  if (!isRgbw) return;
+  if (rgbwMode == RGBW_MODE_AUTO_BRIGHTER || (w == 0 && (rgbwMode == RGBW_MODE_DUAL || rgbwMode == RGBW_MODE_LEGACY)))
+  {
+    //white value is set to lowest RGB channel
+    //thank you to @Def3nder!
+    w = r < g ? (r < b ? r : b) : (g < b ? g : b);
+  } else if (rgbwMode == RGBW_MODE_AUTO_ACCURATE && w == 0)
+  {
+    w = r < g ? (r < b ? r : b) : (g < b ? g : b);
+    r -= w; g -= w; b -= w;
   }
+}
+
+void WS2812FX::setPixelColor(uint16_t i, byte r, byte g, byte b, byte w)
+{
+  autoWhite(r, g, b, w);
   
   if (SEGLEN) {//from segment
-    //color_blend(getpixel, col, _bri_t); (pseudocode for future blending of segments)
     if (_bri_t < 255) {  
       r = scale8(r, _bri_t);
       g = scale8(g, _bri_t);
@@ -215,34 +428,601 @@ void WS2812FX::setPixelColor(uint16_t i, byte r, byte g, byte b, byte w)
     }
     uint32_t col = ((w << 24) | (r << 16) | (g << 8) | (b));
 
-    /* Set all the pixels in the group */
-    uint16_t realIndex = realPixelIndex(i);
+    if (_segPixels) { //render into segment buffer, flushed to the busses after the effect function
+      if (i < SEGLEN && _segPixels[i] != col) {
+        _segPixels[i] = col;
+        SEGENV.dirty = true;
+      }
+      return;
+    }
+    setPixelColorMapped(i, col);
+    _forceFlush = true;
+  } else { //live data, etc.
+    _forceFlush = true;
+    i = mapPixel(i);
+    uint32_t col = ((w << 24) | (r << 16) | (g << 8) | (b));
+    busses.setPixelColor(i, col);
+  }
+}
+
+//sets all physical pixels of the group of virtual pixel i in the current segment. col has opacity applied already
+void WS2812FX::setPixelColorMapped(uint16_t i, uint32_t col)
+{
+  uint8_t k = SEGMENT.renderScale();
+  if (k > 1) { //block of output pixels, only without framebuffer (or map) which interpolate instead
+    uint16_t outLen = SEGMENT.outputLength();
+    for (uint16_t f = i * k; f < (i + 1) * k && f < outLen; f++) setOutputPixelMapped(f, col);
+    return;
+  }
+  setOutputPixelMapped(i, col);
+}
+
+//sets all physical pixels of the group of output pixel f (after the render scale) in the current segment
+void WS2812FX::setOutputPixelMapped(uint16_t f, uint32_t col)
+{
+  if (_pixelWriterSeg != _segment_index) selectPixelWriter();
+  (this->*_pixelWriter)(f, col);
+}
+
+//setOutputPixelMapped() for one combination of the segment options, the ones not used compile to nothing:
+//reverse, mirror, grouping or spacing, custom LED map
+template<bool REV, bool MIR, bool GRP, bool MAP>
+void WS2812FX::writeOutputPixel(uint16_t f, uint32_t col)
+{
+  const Segment& seg = SEGMENT;
+  uint16_t len = seg.stop - seg.start;
+  uint8_t grouping = GRP ? seg.grouping : 1;
+
+  /* reverse just an individual segment */
+  int16_t realIndex = GRP ? f * (seg.grouping + seg.spacing) : f;
+  if (REV) realIndex = (MIR ? (len - 1) / 2 : len - 1) - realIndex;
+  realIndex += seg.start;
+
+  /* Set all the pixels in the group */
+  for (uint8_t j = 0; j < grouping; j++) {
+    uint16_t indexSet = realIndex + (REV ? -j : j);
+    if (indexSet < seg.start || indexSet >= seg.stop) continue;
+    if (MIR) { //set the corresponding mirrored pixel
+      uint16_t indexMir = seg.stop - indexSet + seg.start - 1;
+      /* offset/phase */
+      indexMir += seg.offset;
+      if (indexMir >= seg.stop) indexMir -= len;
+      busses.setPixelColor(MAP ? mapPixel(indexMir) : indexMir, col);
+    }
+    /* offset/phase */
+    indexSet += seg.offset;
+    if (indexSet >= seg.stop) indexSet -= len;
+    busses.setPixelColor(MAP ? mapPixel(indexSet) : indexSet, col);
+  }
+}
+
+//picks the writer for the options of the current segment. Again for each segment every frame,
+//after setPixelSegment() and when the LED map changes, so an option set in between applies from the next frame
+void WS2812FX::selectPixelWriter()
+{
+  static const PixelWriter writers[16] = {
+    &WS2812FX::writeOutputPixel<false, false, false, false>, &WS2812FX::writeOutputPixel<true, false, false, false>,
+    &WS2812FX::writeOutputPixel<false, true,  false, false>, &WS2812FX::writeOutputPixel<true, true,  false, false>,
+    &WS2812FX::writeOutputPixel<false, false, true,  false>, &WS2812FX::writeOutputPixel<true, false, true,  false>,
+    &WS2812FX::writeOutputPixel<false, true,  true,  false>, &WS2812FX::writeOutputPixel<true, true,  true,  false>,
+    &WS2812FX::writeOutputPixel<false, false, false, true >, &WS2812FX::writeOutputPixel<true, false, false, true >,
+    &WS2812FX::writeOutputPixel<false, true,  false, true >, &WS2812FX::writeOutputPixel<true, true,  false, true >,
+    &WS2812FX::writeOutputPixel<false, false, true,  true >, &WS2812FX::writeOutputPixel<true, false, true,  true >,
+    &WS2812FX::writeOutputPixel<false, true,  true,  true >, &WS2812FX::writeOutputPixel<true, true,  true,  true >
+  };
+  if (SEGMENT.grouping == 0) SEGMENT.grouping = 1; //sanity check
+  uint8_t w = (IS_REVERSE ? 1 : 0) | (IS_MIRROR ? 2 : 0) | (SEGMENT.groupLength() > 1 ? 4 : 0) | (customMappingSize ? 8 : 0);
+  _pixelWriter = writers[w];
+  _pixelWriterSeg = _segment_index;
+}
+
+//color of output pixel f of the current segment from its framebuffer, interpolated between the rendered pixels if scaled
+uint32_t WS2812FX::outputPixel(const uint32_t* buf, uint16_t f)
+{
+  uint8_t k = SEGMENT.renderScale();
+  if (k == 1) return buf[f];
+  uint16_t i = f / k;
+  uint8_t frac = (f - i * k) * 255 / k;
+  if (!frac || i + 1 >= SEGLEN) return buf[i];
+  return color_blend(buf[i], buf[i + 1], frac);
+}
+
+//segment whose frame segment n shows instead of running its own effect, -1 if it renders itself
+int16_t WS2812FX::cloneSource(uint8_t n)
+{
+  uint8_t src = _segments[n].cloneSrc;
+  if (!src--) return -1;
+  if (src == n || src >= _segCapacity || !_segments[src].isActive() || _segments[src].cloneSrc) return -1; //no chains
+  if (!_segment_runtimes[src].hasPixels(_segments[src].virtualLength())) return -1; //source has no framebuffer (yet)
+  return src;
+}
+
+//whether an active segment shows the frame of segment n
+bool WS2812FX::isCloneSource(uint8_t n)
+{
+  for (uint8_t k = 0; k < _numActiveSegs; k++) {
+    if (_segments[_activeSegs[k]].cloneSrc == n +1) return true;
+  }
+  return false;
+}
+
+/*
+ * Copies the framebuffer of segment src into the one of the current segment, stretched to its length,
+ * and writes it out. Offset, reverse, mirror and grouping of the clone apply as for any segment,
+ * its brightness on top of the one of the source.
+ */
+void WS2812FX::renderClone(uint8_t src)
+{
+  if (SEGMENT.getOption(SEG_OPTION_FREEZE)) return;
+  if (SEGMENT.grouping == 0) SEGMENT.grouping = 1; //sanity check
+  _virtualSegmentLength = SEGMENT.virtualLength();
+  if (!SEGLEN) return;
+  if (SEGENV.fxTransition) endEffectTransition();
+  SEGENV.call = 0; //its own effect starts over once the segment stops cloning
+  if (SEGENV.data) SEGENV.deallocateData();
+  if (!SEGENV.hasPixels(SEGLEN)) {
+    uint16_t reserve = FAIR_DATA_PER_SEG * (getActiveSegmentsNum() -1);
+    if (!SEGENV.allocatePixels(SEGLEN, reserve)) return;
+  }
+
+  uint8_t bri = IS_SEGMENT_ON ? SEGMENT.opacity : 0;
+  uint8_t t = _transitionIndex[_segment_index][0];
+  if (t != 0xFF) bri = transitions[t].currentBri();
+  const uint32_t* from = _segment_runtimes[src].pixels;
+  uint16_t srcLen = _segments[src].virtualLength();
+  uint32_t* to = SEGENV.pixels;
+  for (uint16_t i = 0; i < SEGLEN; i++) {
+    uint32_t c = from[(srcLen == SEGLEN) ? i : (uint32_t)i * srcLen / SEGLEN];
+    if (bri < 255) c = color_blend(0, c, bri);
+    if (to[i] == c) continue;
+    to[i] = c;
+    SEGENV.dirty = true;
+  }
+  _segPixels = to;
+  flushSegmentBuffer();
+}
+
+/*
+ * Makes effects of the current segment render into its framebuffer.
+ * The buffer is (re-)allocated after the first call of an effect so the effect's own data allocation
+ * is not starved, and seeded with the current bus contents so effects reading back pixels are not disturbed.
+ * With WLED_ENABLE_DIRECT_RENDER, effects that do not read pixels back draw straight into the bus buffers
+ * instead, unless the framebuffer is needed for a crossfade, tweening, blending or a clone.
+ */
+void WS2812FX::attachSegmentBuffer(uint8_t fxFlags)
+{
+  _segPixels = nullptr;
+  if (!SEGLEN || (SEGENV.call == 0 && !SEGENV.fxTransition)) return; //a crossfade needs the buffer right away
+  #ifdef WLED_ENABLE_DIRECT_RENDER
+  if ((fxFlags & FX_FLAG_DIRECT) && !SEGENV.fxTransition && !SEGMENT.getOption(SEG_OPTION_TWEEN) && !_compositing && !isCloneSource(_segment_index)) {
+    if (SEGENV.pixels) SEGENV.deallocatePixels();
+    return;
+  }
+  #endif
+  if (!SEGENV.hasPixels(SEGLEN)) {
+    //leave the fair share of data for all other active segments
+    uint16_t reserve = FAIR_DATA_PER_SEG * (getActiveSegmentsNum() -1);
+    if (!SEGENV.allocatePixels(SEGLEN, reserve)) return;
+    for (uint16_t i = 0; i < SEGLEN; i++) SEGENV.pixels[i] = getPixelColor(i);
+  }
+  _segPixels = SEGENV.pixels;
+}
+
+//writes the framebuffer of the current segment to the busses
+void WS2812FX::flushSegmentBuffer()
+{
+  uint32_t* buf = _segPixels;
+  _segPixels = nullptr;
+  if (!buf || _compositing) return; //compositeSegments() writes all framebuffers at once
+  if (SEGENV.layoutChanged(SEGMENT)) SEGENV.dirty = true;
+  EffectTransition* t = SEGENV.fxTransition;
+  uint32_t* old = t ? t->old.pixels : (SEGENV.hasTween(SEGLEN) ? SEGENV.tweenPixels : nullptr);
+  if (old) { //crossfade from the outgoing effect or the previous frame, the output changes every frame
+    uint16_t prog = t ? t->progress() : SEGENV.tweenProgress();
+    if (!SEGENV.map) buildSegmentMap();
+    if (SEGENV.map) {
+      uint16_t* map = SEGENV.map;
+      uint16_t len = SEGMENT.length();
+      for (uint16_t j = 0; j < len; j++) {
+        if (map[j] == 0xFFFF) continue; //gap (spacing)
+        busses.setPixelColor(mapPixel(SEGMENT.start + j), color_blend(outputPixel(old, map[j]), outputPixel(buf, map[j]), prog, true));
+      }
+    } else {
+      uint16_t outLen = SEGMENT.outputLength();
+      for (uint16_t f = 0; f < outLen; f++) setOutputPixelMapped(f, color_blend(outputPixel(old, f), outputPixel(buf, f), prog, true));
+    }
+    SEGENV.dirty = true; //the next frame without crossfade must be written again
+    return;
+  }
+  //the busses still hold the last flush unless another segment may have drawn over it
+  if (!SEGENV.dirty && !segmentOverlaps(_segment_index)) return;
+  SEGENV.dirty = false;
+  //plain segments map 1:1 onto physical pixels (apart from the offset wrap) and can be written as spans
+  if (SEGMENT.grouping == 1 && SEGMENT.spacing == 0 && !IS_MIRROR && !IS_REVERSE && SEGMENT.renderScale() == 1 && customMappingSize <= SEGMENT.start) {
+    uint16_t len = SEGMENT.length();
+    uint16_t off = SEGMENT.offset % len;
+    busses.setPixelSpan(SEGMENT.start + off, buf, len - off);
+    if (off) busses.setPixelSpan(SEGMENT.start, buf + (len - off), off);
+    return;
+  }
+  if (!SEGENV.map) buildSegmentMap();
+  if (SEGENV.map) {
+    uint16_t* map = SEGENV.map;
     uint16_t len = SEGMENT.length();
+    for (uint16_t j = 0; j < len; j++) {
+      if (map[j] == 0xFFFF) continue; //gap (spacing)
+      busses.setPixelColor(mapPixel(SEGMENT.start + j), outputPixel(buf, map[j]));
+    }
+    return;
+  }
+  uint16_t outLen = SEGMENT.outputLength();
+  for (uint16_t f = 0; f < outLen; f++) setOutputPixelMapped(f, outputPixel(buf, f));
+}
 
+/*
+ * Builds the physical->virtual index map of the current segment.
+ * Walks the virtual pixels exactly like setPixelColorMapped() does, so later writes win just like on the bus.
+ */
+void WS2812FX::buildSegmentMap()
+{
+  uint16_t reserve = FAIR_DATA_PER_SEG * (getActiveSegmentsNum() -1);
+  if (!SEGENV.allocateMap(SEGMENT, reserve)) return;
+  uint16_t* map = SEGENV.map;
+  uint16_t len = SEGMENT.length();
+  memset(map, 0xFF, len * sizeof(uint16_t));
+
+  uint16_t outLen = SEGMENT.outputLength(); //the map holds output pixels, see outputPixel()
+  for (uint16_t i = 0; i < outLen; i++) {
+    uint16_t realIndex = realPixelIndex(i);
     for (uint16_t j = 0; j < SEGMENT.grouping; j++) {
       uint16_t indexSet = realIndex + (IS_REVERSE ? -j : j);
-      if (indexSet >= SEGMENT.start && indexSet < SEGMENT.stop) {
-        if (IS_MIRROR) { //set the corresponding mirrored pixel
-          uint16_t indexMir = SEGMENT.stop - indexSet + SEGMENT.start - 1;
-          /* offset/phase */
-          indexMir += SEGMENT.offset;
-          if (indexMir >= SEGMENT.stop) indexMir -= len;
-
-          if (indexMir < customMappingSize) indexMir = customMappingTable[indexMir];
-          busses.setPixelColor(indexMir, col);
-        }
-        /* offset/phase */
-        indexSet += SEGMENT.offset;
-        if (indexSet >= SEGMENT.stop) indexSet -= len;
+      if (indexSet < SEGMENT.start || indexSet >= SEGMENT.stop) continue;
+      if (IS_MIRROR) {
+        uint16_t indexMir = SEGMENT.stop - indexSet + SEGMENT.start - 1;
+        indexMir += SEGMENT.offset;
+        if (indexMir >= SEGMENT.stop) indexMir -= len;
+        if (indexMir - SEGMENT.start < len) map[indexMir - SEGMENT.start] = i;
+      }
+      indexSet += SEGMENT.offset;
+      if (indexSet >= SEGMENT.stop) indexSet -= len;
+      if (indexSet - SEGMENT.start < len) map[indexSet - SEGMENT.start] = i;
+    }
+  }
+}
 
-        if (indexSet < customMappingSize) indexSet = customMappingTable[indexSet];
-        busses.setPixelColor(indexSet, col);
+//virtual index of x,y in the current 2D segment, computed from its geometry
+uint16_t WS2812FX::segmentXY(uint16_t x, uint16_t y)
+{
+  if (!SEGMENT.is2D()) return x; //1D segments are a single row
+  uint16_t w = SEGMENT.width, h = SEGMENT.height;
+  if (SEGMENT.layout & SEG_2D_TRANSPOSE) { uint16_t t = x; x = y; y = t; }
+  uint16_t px, py;
+  switch ((SEGMENT.layout & SEG_2D_ROTATION) >> 2) {
+    case 1:  px = y;         py = h -1 - x; break;
+    case 2:  px = w -1 - x;  py = h -1 - y; break;
+    case 3:  px = w -1 - y;  py = x;        break;
+    default: px = x;         py = y;
+  }
+  if ((SEGMENT.layout & SEG_2D_SERPENTINE) && (py & 0x01)) px = w -1 - px;
+  return py * w + px;
+}
+
+//caches segmentXY() for every pixel of the current 2D segment, effects then address pixels with a single lookup
+void WS2812FX::buildXYMap()
+{
+  uint16_t vw = SEGMENT.virtualWidth(), vh = SEGMENT.virtualHeight();
+  uint16_t reserve = FAIR_DATA_PER_SEG * (getActiveSegmentsNum() -1);
+  if (!SEGENV.allocateXY(vw * vh, reserve)) return; //XY() falls back to computing every lookup
+  uint16_t* xy = SEGENV.xy;
+  for (uint16_t y = 0; y < vh; y++)
+    for (uint16_t x = 0; x < vw; x++) *xy++ = segmentXY(x, y);
+}
+
+uint16_t WS2812FX::XY(uint16_t x, uint16_t y)
+{
+  if (x >= SEGW || y >= SEGH) return 0xFFFF;
+  if (SEGENV.xy) return SEGENV.xy[y * SEGW + x];
+  return segmentXY(x, y);
+}
+
+void WS2812FX::setPixelColorXY(uint16_t x, uint16_t y, uint32_t c)
+{
+  uint16_t i = XY(x, y);
+  if (i != 0xFFFF) setPixelColor(i, c);
+}
+
+uint32_t WS2812FX::getPixelColorXY(uint16_t x, uint16_t y)
+{
+  uint16_t i = XY(x, y);
+  return (i != 0xFFFF) ? getPixelColor(i) : 0;
+}
+
+/*
+ * Called when the effect of the current segment is about to be reset for a mode change.
+ * Keeps the state of the outgoing effect alive for _transitionDur so both can be crossfaded.
+ * Needs the framebuffer of the outgoing effect, the incoming one gets its own on its first call.
+ */
+void WS2812FX::startEffectTransition()
+{
+  endEffectTransition(); //crossfading from a crossfade is not supported, start from the current effect
+  if (!_transitionDur || !SEGMENT.isActive() || !SEGENV.hasPixels(SEGMENT.virtualLength())) return;
+  EffectTransition* t = new EffectTransition();
+  if (!t) return;
+  SEGENV.handOver(t->old);
+  t->mode = SEGENV.fxFrom;
+  t->start = millis();
+  t->dur = _transitionDur;
+  SEGENV.fxTransition = t;
+}
+
+void WS2812FX::endEffectTransition()
+{
+  EffectTransition* t = SEGENV.fxTransition;
+  if (!t) return;
+  t->old.deallocateAll();
+  delete t;
+  SEGENV.fxTransition = nullptr;
+  SEGENV.dirty = true;
+}
+
+//runs the outgoing effect of the current segment if it is due, returns its delay
+uint16_t WS2812FX::renderOutgoingEffect(uint32_t nowUp)
+{
+  EffectTransition* t = SEGENV.fxTransition;
+  if (t->progress() == 0xFFFF || !t->old.hasPixels(SEGLEN)) { //done, or the segment changed
+    endEffectTransition();
+    return FRAMETIME;
+  }
+  if (nowUp <= t->old.next_time) return t->old.next_time - nowUp;
+
+  EffectDesc fx;
+  getEffect(t->mode, fx);
+  Segment_runtime cur = SEGENV;
+  SEGENV = t->old; //effects work on SEGENV
+  SEGENV.fxTransition = nullptr;
+  uint8_t mode = SEGMENT.mode;
+  SEGMENT.mode = t->mode;
+  _segPixels = SEGENV.pixels;
+  handle_palette(fx.palette);
+  uint16_t delay = (this->*fx.fn)();
+  _segPixels = nullptr;
+  if (t->mode != FX_MODE_HALLOWEEN_EYES) SEGENV.call++;
+  SEGENV.next_time = nowUp + delay;
+  SEGMENT.mode = mode;
+  t->old = SEGENV;
+  SEGENV = cur;
+  return delay;
+}
+
+/*
+ * Rebuilds the ids of the active segments, which the per frame loops go through instead of all segments.
+ * Marked for rebuilding whenever a segment is added, moved or removed (setSegment(), resetSegments()).
+ */
+void WS2812FX::updateActiveSegments()
+{
+  uint8_t segIndex = _segment_index;
+  _numActiveSegs = 0;
+  for (uint8_t i = 0; i < _segCapacity; i++) {
+    if (_segments[i].isActive()) {
+      _activeSegs[_numActiveSegs++] = i;
+      continue;
+    }
+    //deleted segments release their effect data and framebuffers now, as service() no longer visits them
+    _segment_index = i;
+    SEGENV.fxFrom = 0xFF;
+    SEGENV.resetIfRequired();
+    if (!SEGENV.rng) SEGENV.rng = segmentSeed(i);
+  }
+  _segment_index = segIndex;
+  _activeSegsDirty = false;
+}
+
+//true if an active segment is not simply drawn over the ones below it
+bool WS2812FX::usesBlending()
+{
+  for (uint8_t k = 0; k < _numActiveSegs; k++) {
+    if (_segments[_activeSegs[k]].blendMode != SEG_BLEND_NORMAL) return true;
+  }
+  return false;
+}
+
+static inline uint32_t blendColor(uint32_t below, uint32_t c, uint8_t mode)
+{
+  switch (mode) {
+    case SEG_BLEND_ADD:
+      return ((uint32_t)qadd8(below >> 24, c >> 24) << 24) | ((uint32_t)qadd8(below >> 16, c >> 16) << 16)
+           | ((uint32_t)qadd8(below >> 8, c >> 8) << 8) | qadd8(below, c);
+    case SEG_BLEND_MULTIPLY:
+      return ((uint32_t)scale8(below >> 24, c >> 24) << 24) | ((uint32_t)scale8(below >> 16, c >> 16) << 16)
+           | ((uint32_t)scale8(below >> 8, c >> 8) << 8) | scale8(below, c);
+    case SEG_BLEND_MAX:
+      return (MAX(below & 0xFF000000, c & 0xFF000000)) | (MAX(below & 0x00FF0000, c & 0x00FF0000))
+           | (MAX(below & 0x0000FF00, c & 0x0000FF00)) | (MAX(below & 0x000000FF, c & 0x000000FF));
+  }
+  return c;
+}
+
+/*
+ * Blends the framebuffers of all active segments into _compBuffer in id order and writes the result.
+ * Segments that could not get a framebuffer have drawn straight to the busses and are overwritten where
+ * they overlap one that has.
+ */
+void WS2812FX::compositeSegments()
+{
+  uint8_t segIndex = _segment_index;
+  memset(_compBuffer, 0, _length * sizeof(uint32_t));
+  for (uint8_t k = 0; k < _numActiveSegs; k++) {
+    _segment_index = _activeSegs[k];
+    _virtualSegmentLength = SEGMENT.virtualLength();
+    if (!SEGENV.hasPixels(SEGLEN) || isLive(_segment_index)) continue;
+    compositeSegment(_compBuffer);
+  }
+  for (uint8_t k = 0; k < _numActiveSegs; k++) {
+    _segment_index = _activeSegs[k];
+    _virtualSegmentLength = SEGMENT.virtualLength();
+    if (!SEGENV.hasPixels(SEGLEN) || isLive(_segment_index)) continue;
+    writeSpan(SEGMENT.start, _compBuffer + SEGMENT.start, SEGMENT.length());
+    SEGENV.dirty = false;
+  }
+  _segment_index = segIndex;
+}
+
+//blends the framebuffer of the current segment into comp, indexed by physical pixel
+void WS2812FX::compositeSegment(uint32_t* comp)
+{
+  uint32_t* buf = SEGENV.pixels;
+  EffectTransition* t = SEGENV.fxTransition;
+  uint32_t* old = t ? t->old.pixels : (SEGENV.hasTween(SEGLEN) ? SEGENV.tweenPixels : nullptr); //crossfade from the outgoing effect or the previous frame
+  uint16_t prog = t ? t->progress() : SEGENV.tweenProgress();
+  uint8_t mode = SEGMENT.blendMode;
+  uint16_t len = SEGMENT.length();
+  SEGENV.layoutChanged(SEGMENT);
+  if (!SEGENV.map) buildSegmentMap();
+  if (SEGENV.map) {
+    uint16_t* map = SEGENV.map;
+    for (uint16_t j = 0; j < len; j++) {
+      if (map[j] == 0xFFFF) continue; //gap (spacing)
+      uint16_t p = SEGMENT.start + j;
+      uint32_t c = old ? color_blend(outputPixel(old, map[j]), outputPixel(buf, map[j]), prog, true) : outputPixel(buf, map[j]);
+      comp[p] = blendColor(comp[p], c, mode);
+    }
+    return;
+  }
+  //no memory for the map, walk the output pixels like setPixelColorMapped() does
+  uint16_t outLen = SEGMENT.outputLength();
+  for (uint16_t i = 0; i < outLen; i++) {
+    uint16_t realIndex = realPixelIndex(i);
+    uint32_t c = old ? color_blend(outputPixel(old, i), outputPixel(buf, i), prog, true) : outputPixel(buf, i);
+    for (uint16_t j = 0; j < SEGMENT.grouping; j++) {
+      uint16_t indexSet = realIndex + (IS_REVERSE ? -j : j);
+      if (indexSet < SEGMENT.start || indexSet >= SEGMENT.stop) continue;
+      if (IS_MIRROR) {
+        uint16_t indexMir = SEGMENT.stop - indexSet + SEGMENT.start - 1;
+        indexMir += SEGMENT.offset;
+        if (indexMir >= SEGMENT.stop) indexMir -= len;
+        if (indexMir - SEGMENT.start < len) comp[indexMir] = blendColor(comp[indexMir], c, mode);
       }
+      indexSet += SEGMENT.offset;
+      if (indexSet >= SEGMENT.stop) indexSet -= len;
+      if (indexSet - SEGMENT.start < len) comp[indexSet] = blendColor(comp[indexSet], c, mode);
     }
-  } else { //live data, etc.
-    if (i < customMappingSize) i = customMappingTable[i];
-    uint32_t col = ((w << 24) | (r << 16) | (g << 8) | (b));
-    busses.setPixelColor(i, col);
+  }
+}
+
+//true if another active segment shares physical pixels with segment n
+bool WS2812FX::segmentOverlaps(uint8_t n)
+{
+  Segment& seg = _segments[n];
+  for (uint8_t i = 0; i < _segCapacity; i++) {
+    if (i == n || !_segments[i].isActive()) continue;
+    if (_segments[i].start < seg.stop && seg.start < _segments[i].stop) return true;
+  }
+  return false;
+}
+
+//sets len consecutive physical pixels outside of segment context (live data), applying auto white and ledmap
+void WS2812FX::setPixelSpan(uint16_t start, const uint32_t* colors, uint16_t len)
+{
+  _forceFlush = true;
+  if (!isRgbw || rgbwMode == RGBW_MODE_MANUAL_ONLY) { //nothing to convert
+    writeSpan(start, colors, len);
+    return;
+  }
+  uint32_t chunk[32];
+  while (len) {
+    uint16_t n = (len > 32) ? 32 : len;
+    for (uint16_t i = 0; i < n; i++) {
+      uint32_t c = colors[i];
+      byte w = c >> 24, r = c >> 16, g = c >> 8, b = c;
+      autoWhite(r, g, b, w);
+      chunk[i] = ((w << 24) | (r << 16) | (g << 8) | (b));
+    }
+    writeSpan(start, chunk, n);
+    start += n; colors += n; len -= n;
+  }
+}
+
+/*
+ * Segments marked live show realtime data while realtime mode is active, the others go on with their effects.
+ * Without live segments realtime data takes over the whole strip.
+ */
+bool WS2812FX::hasLiveSegments()
+{
+  for (uint8_t i = 0; i < _segCapacity; i++) {
+    if (_segments[i].live && _segments[i].isActive()) return true;
+  }
+  return false;
+}
+
+//segment n is not rendered, because realtime data is shown on it
+bool WS2812FX::isLive(uint8_t n)
+{
+  return _segments[n].live && realtimeMode && !realtimeOverride;
+}
+
+//pixel i takes realtime data
+bool WS2812FX::isRealtimePixel(uint16_t i)
+{
+  bool any = false;
+  for (uint8_t s = 0; s < _segCapacity; s++) {
+    Segment& seg = _segments[s];
+    if (!seg.live || !seg.isActive()) continue;
+    if (i >= seg.start && i < seg.stop) return true;
+    any = true;
+  }
+  return !any;
+}
+
+//live data straight from a packet buffer (packed RGB or RGBW channels), only the part on live segments if there are any
+void WS2812FX::setRealtimeSpan(uint16_t start, const uint8_t* data, uint16_t len, bool rgbw, bool gamma)
+{
+  if (!hasLiveSegments()) {
+    writeRealtimeSpan(start, data, len, rgbw, gamma);
+    return;
+  }
+  const uint8_t stride = rgbw ? 4 : 3;
+  for (uint8_t s = 0; s < _segCapacity; s++) {
+    Segment& seg = _segments[s];
+    if (!seg.live || !seg.isActive()) continue;
+    uint16_t from = MAX(start, seg.start);
+    uint16_t to = MIN((uint32_t)start + len, (uint32_t)seg.stop);
+    if (from < to) writeRealtimeSpan(from, data + (from - start) * stride, to - from, rgbw, gamma);
+  }
+}
+
+//gamma table lookup, auto white and packing are done in a single pass per chunk
+void WS2812FX::writeRealtimeSpan(uint16_t start, const uint8_t* data, uint16_t len, bool rgbw, bool gamma)
+{
+  _forceFlush = true;
+  const uint8_t stride = rgbw ? 4 : 3;
+  const bool calcWhite = isRgbw && rgbwMode != RGBW_MODE_MANUAL_ONLY;
+  if (updateOutputGamma()) gamma = false; //the busses do it
+  uint32_t chunk[32];
+  while (len) {
+    uint16_t n = (len > 32) ? 32 : len;
+    for (uint16_t i = 0; i < n; i++) {
+      byte r = data[0], g = data[1], b = data[2], w = rgbw ? data[3] : 0;
+      if (gamma) {
+        r = gammaT[r]; g = gammaT[g]; b = gammaT[b]; w = gammaT[w];
+      }
+      if (calcWhite) autoWhite(r, g, b, w);
+      chunk[i] = ((uint32_t)w << 24) | ((uint32_t)r << 16) | ((uint16_t)g << 8) | b;
+      data += stride;
+    }
+    writeSpan(start, chunk, n);
+    start += n; len -= n;
+  }
+}
+
+//writes final colors to the busses, scattered through the custom mapping where one applies
+void WS2812FX::writeSpan(uint16_t start, const uint32_t* colors, uint16_t len)
+{
+  if (start + len <= customMappingSize && customMappingTable) { //mapped pixels are scattered
+    for (uint16_t i = 0; i < len; i++) busses.setPixelColor(customMappingTable[start + i], colors[i]);
+  } else if (start < customMappingSize) {
+    for (uint16_t i = 0; i < len; i++) busses.setPixelColor(mapPixel(start + i), colors[i]);
+  } else {
+    busses.setPixelSpan(start, colors, len);
   }
 }
 
@@ -263,71 +1043,79 @@ void WS2812FX::estimateCurrentAndLimitBri() {
   //each LED can draw up 195075 "power units" (approx. 53mA)
   //one PU is the power it takes to have 1 channel 1 step brighter per brightness step
   //so A=2,R=255,G=0,B=0 would use 510 PU per LED (1mA is about 3700 PU)
-  bool useWackyWS2815PowerModel = false;
-  byte actualMilliampsPerLed = milliampsPerLed;
-
-  if(milliampsPerLed == 255) {
-    useWackyWS2815PowerModel = true;
-    actualMilliampsPerLed = 12; // from testing an actual strip
+  //busses with their own budget (BusConfig::milliAmpsMax) are limited independently,
+  //all others share ablMilliampsMax and are dimmed together
+  bool globalLimit = (ablMilliampsMax >= 150 && milliampsPerLed > 0); //0 mA per LED and too low numbers turn off calculation
+  bool busLimit = false;
+  for (uint8_t b = 0; b < busses.getNumBusses(); b++) {
+    Bus *bus = busses.getBus(b);
+    if (bus->milliAmpsMax >= 150 && bus->getType() < TYPE_NET_DDP_RGB) busLimit = true;
   }
 
-  if (ablMilliampsMax < 150 || actualMilliampsPerLed == 0) { //0 mA per LED and too low numbers turn off calculation
+  if (!globalLimit && !busLimit) {
     currentMilliamps = 0;
+    busses.setPowerTracking(false);
     busses.setBrightness(_brightness);
     return;
   }
 
-  uint16_t pLen = getLengthPhysical();
-  uint32_t puPerMilliamp = 195075 / actualMilliampsPerLed;
-  uint32_t powerBudget = (ablMilliampsMax - MA_FOR_ESP) * puPerMilliamp; //100mA for ESP power
-  if (powerBudget > puPerMilliamp * pLen) { //each LED uses about 1mA in standby, exclude that from power budget
-    powerBudget -= puPerMilliamp * pLen;
-  } else {
-    powerBudget = 0;
-  }
+  //channel sums are kept up to date by the busses on every pixel write
+  busses.setPowerTracking(true, milliampsPerLed == 255);
 
-  uint32_t powerSum = 0;
+  uint32_t poolMilliamps = 0; //at current brightness, without standby current
+  uint16_t poolLen = 0;
+  uint8_t newBri = _brightness;
 
   for (uint8_t b = 0; b < busses.getNumBusses(); b++) {
     Bus *bus = busses.getBus(b);
     if (bus->getType() >= TYPE_NET_DDP_RGB) continue; //exclude non-physical network busses
-    uint16_t len = bus->getLength();
-    uint32_t busPowerSum = 0;
-    for (uint16_t i = 0; i < len; i++) { //sum up the usage of each LED
-      uint32_t c = bus->getPixelColor(i);
-      byte r = c >> 16, g = c >> 8, b = c, w = c >> 24;
-
-      if(useWackyWS2815PowerModel) { //ignore white component on WS2815 power calculation
-        busPowerSum += (MAX(MAX(r,g),b)) * 3;
-      } else {
-        busPowerSum += (r + g + b + w);
-      }
-    }
+    bus->milliamps = busMilliamps(bus, _brightness);
+    if (bus->milliAmpsMax >= 150) continue;
+    poolMilliamps += bus->milliamps;
+    poolLen += bus->getLength();
+  }
+
+  if (globalLimit) {
+    //each LED uses about 1mA in standby, exclude that from power budget
+    uint32_t budget = ablMilliampsMax - MA_FOR_ESP; //100mA for ESP power
+    budget = (budget > poolLen) ? budget - poolLen : 0;
+    if (poolMilliamps > budget) newBri = (_brightness * budget) / poolMilliamps; //scale brightness down to stay in current limit
+  }
 
-    if (bus->isRgbw()) { //RGBW led total output with white LEDs enabled is still 50mA, so each channel uses less
-      busPowerSum *= 3;
-      busPowerSum = busPowerSum >> 2; //same as /= 4
+  currentMilliamps = MA_FOR_ESP; //add power of ESP back to estimate
+  for (uint8_t b = 0; b < busses.getNumBusses(); b++) {
+    Bus *bus = busses.getBus(b);
+    if (bus->getType() >= TYPE_NET_DDP_RGB || bus->milliAmpsMax < 150) {
+      busses.setBrightness(b, newBri); //to keep brightness uniform, sets virtual busses too
+      if (bus->getType() >= TYPE_NET_DDP_RGB) continue;
+      if (newBri != _brightness) bus->milliamps = busMilliamps(bus, newBri);
+    } else {
+      uint8_t busBri = _brightness;
+      uint16_t budget = bus->milliAmpsMax;
+      budget = (budget > bus->getLength()) ? budget - bus->getLength() : 0;
+      if (bus->milliamps > budget) {
+        busBri = (_brightness * (uint32_t)budget) / bus->milliamps;
+        bus->milliamps = busMilliamps(bus, busBri);
+      }
+      busses.setBrightness(b, busBri);
     }
-    powerSum += busPowerSum;
+    bus->milliamps += bus->getLength(); //add standby power back to estimate
+    currentMilliamps += bus->milliamps;
   }
+}
 
-  uint32_t powerSum0 = powerSum;
-  powerSum *= _brightness;
-  
-  if (powerSum > powerBudget) //scale brightness down to stay in current limit
-  {
-    float scale = (float)powerBudget / (float)powerSum;
-    uint16_t scaleI = scale * 255;
-    uint8_t scaleB = (scaleI > 255) ? 255 : scaleI;
-    uint8_t newBri = scale8(_brightness, scaleB);
-    busses.setBrightness(newBri); //to keep brightness uniform, sets virtual busses too
-    currentMilliamps = (powerSum0 * newBri) / puPerMilliamp;
-  } else {
-    currentMilliamps = powerSum / puPerMilliamp;
-    busses.setBrightness(_brightness);
+//current drawn by the pixels of a bus at brightness bri, without standby current
+uint32_t WS2812FX::busMilliamps(Bus* bus, uint8_t bri) {
+  uint8_t ma = bus->milliAmpsPerLed ? bus->milliAmpsPerLed : milliampsPerLed;
+  if (ma == 255) ma = 12; //WS2815 power model, from testing an actual strip
+  if (ma == 0) return 0;
+  uint32_t puPerMilliamp = 195075 / ma;
+  uint64_t busPowerSum = bus->powerSum;
+  if (bus->isRgbw()) { //RGBW led total output with white LEDs enabled is still 50mA, so each channel uses less
+    busPowerSum *= 3;
+    busPowerSum = busPowerSum >> 2; //same as /= 4
   }
-  currentMilliamps += MA_FOR_ESP; //add power of ESP back to estimate
-  currentMilliamps += pLen; //add standby power back to estimate
+  return (busPowerSum * bri) / puPerMilliamp;
 }
 
 void WS2812FX::show(void) {
@@ -336,12 +1124,30 @@ void WS2812FX::show(void) {
   show_callback callback = _callback;
   if (callback) callback();
 
+  // nothing was written and brightness is unchanged, the busses already show this frame
+  // (LED types that need refreshing while off are always sent)
+  _showPending = false;
+  if (!isOffRefreshRequred && _brightness == _lastShowBri && !busses.isDirty()) return;
+  _lastShowBri = _brightness;
+  uint32_t showStart = micros();
+
+  TRACE_BEGIN(TRACE_ABL, 0);
   estimateCurrentAndLimitBri();
+  TRACE_END(TRACE_ABL, 0);
   
   // some buses send asynchronously and this method will return before
   // all of the data has been sent.
   // See https://github.com/Makuna/NeoPixelBus/wiki/ESP32-NeoMethods#neoesp32rmt-methods
-  busses.show();
+  uint32_t busStart = micros();
+  TRACE_BEGIN(TRACE_BUS_SHOW, 0);
+  busses.show(isOffRefreshRequred);
+  TRACE_END(TRACE_BUS_SHOW, 0);
+  #ifdef WLED_ENABLE_TRACE
+  traceBusSending = true;
+  #endif
+  uint32_t showEnd = micros();
+  _busPerf.add(showEnd - busStart);
+  _showPerf.add(showEnd - showStart);
   unsigned long now = millis();
   unsigned long diff = now - _lastShow;
   uint16_t fpsCurr = 200;
@@ -350,6 +1156,20 @@ void WS2812FX::show(void) {
   _lastShow = now;
 }
 
+/**
+ * Sets the frame rate effects are paced at. Effects returning FRAMETIME run at this rate,
+ * the MIN_SHOW_DELAY cap is only lifted if a higher rate is requested.
+ */
+void WS2812FX::setTargetFps(uint8_t fps) {
+  if (fps == 0) fps = WLED_FPS;
+  _targetFps = fps;
+  _frametime = 1000 / fps;
+}
+
+uint16_t WS2812FX::getTargetFps() {
+  return _targetFps;
+}
+
 /**
  * Returns a true value if any of the strips are still being updated.
  * On some hardware (ESP32), strip updates are done asynchronously.
@@ -358,29 +1178,142 @@ bool WS2812FX::isUpdating() {
   return !busses.canAllShow();
 }
 
-/**
- * Returns the refresh rate of the LED strip. Useful for finding out whether a given setup is fast enough.
- * Only updates on show() or is set to 0 fps if last show is more than 2 secs ago, so accurary varies
- */
-uint16_t WS2812FX::getFps() {
-  if (millis() - _lastShow > 2000) return 0;
-  return _cumulativeFps +1;
+/**
+ * Returns the refresh rate of the LED strip. Useful for finding out whether a given setup is fast enough.
+ * Only updates on show() or is set to 0 fps if last show is more than 2 secs ago, so accurary varies
+ */
+uint16_t WS2812FX::getFps() {
+  if (millis() - _lastShow > 2000) return 0;
+  return _cumulativeFps +1;
+}
+
+/**
+ * Forces the next frame to be computed on all active segments.
+ */
+void WS2812FX::trigger() {
+  _triggered = true;
+}
+
+/**
+ * Changes made until the matching endUpdate() land in one frame: no frame is rendered in between,
+ * and the color transitions they start share one start time, that of endUpdate(). Nestable.
+ */
+void WS2812FX::beginUpdate() {
+  if (!_updateDepth) _updateTime = millis();
+  _updateDepth++;
+}
+
+void WS2812FX::endUpdate() {
+  if (!_updateDepth || --_updateDepth) return;
+  uint32_t now = millis();
+  for (uint8_t i = 0; i < _numTransitions; i++) {
+    if (transitions[i].segment != 0xFF && transitions[i].transitionStart == _updateTime) transitions[i].transitionStart = now;
+  }
+}
+
+/*
+ * Preset morph: a preset applied between prepareMorph() and startMorph() does not change colors, speed, intensity,
+ * opacity and palette at once, they are interpolated from the values before over dur ms, once per frame in service().
+ * Only segments that are on before and after morph, effects and geometry change at once.
+ */
+void WS2812FX::prepareMorph() {
+  if (_morph && _morphSegs != _segCapacity) stopMorph();
+  if (!_morph) {
+    _morph = new SegmentMorph[_segCapacity];
+    if (!_morph) return;
+    _morphSegs = _segCapacity;
+  }
+  for (uint8_t i = 0; i < _morphSegs; i++) {
+    SegmentMorph& m = _morph[i];
+    Segment& seg = _segments[i];
+    bool running = _morphDur && m.active;
+    for (uint8_t s = 0; s < NUM_COLORS; s++) m.colFrom[s] = seg.colors[s];
+    m.speedFrom = seg.speed; m.intensityFrom = seg.intensity; m.opacityFrom = seg.opacity;
+    PaletteCache* pc = _segment_runtimes[i].palette;
+    m.hasPal = pc;
+    if (pc) m.palFrom = pc->current;
+    m.active = seg.isActive() && seg.getOption(SEG_OPTION_ON);
+    if (running) { //a new morph starts from where the running one is, segments the preset leaves alone go on to its targets
+      for (uint8_t s = 0; s < NUM_COLORS; s++) seg.colors[s] = m.colTo[s];
+      seg.speed = m.speedTo; seg.intensity = m.intensityTo; seg.opacity = m.opacityTo;
+    }
+  }
+  _morphDur = 0;
+}
+
+void WS2812FX::startMorph(uint32_t dur) {
+  if (!_morph || _morphDur) return; //not prepared
+  bool any = false;
+  for (uint8_t i = 0; i < _morphSegs && dur; i++) {
+    SegmentMorph& m = _morph[i];
+    Segment& seg = _segments[i];
+    m.active = m.active && seg.isActive() && seg.getOption(SEG_OPTION_ON);
+    if (!m.active) continue;
+    for (uint8_t s = 0; s < NUM_COLORS; s++) { m.colTo[s] = seg.colors[s]; seg.colors[s] = m.colFrom[s]; }
+    m.speedTo = seg.speed;         seg.speed = m.speedFrom;
+    m.intensityTo = seg.intensity; seg.intensity = m.intensityFrom;
+    m.opacityTo = seg.opacity;     seg.opacity = m.opacityFrom;
+    any = true;
+  }
+  if (!any) { stopMorph(); return; }
+  _morphStart = millis();
+  _morphDur = dur;
+  _morphProg = 0;
+}
+
+//ends a running morph on its target values and frees a prepared one
+void WS2812FX::stopMorph() {
+  if (!_morph) return;
+  for (uint8_t i = 0; i < _morphSegs && _morphDur; i++) {
+    SegmentMorph& m = _morph[i];
+    if (!m.active) continue;
+    Segment& seg = _segments[i];
+    for (uint8_t s = 0; s < NUM_COLORS; s++) seg.colors[s] = m.colTo[s];
+    seg.speed = m.speedTo; seg.intensity = m.intensityTo; seg.opacity = m.opacityTo;
+  }
+  delete[] _morph;
+  _morph = nullptr;
+  _morphSegs = 0;
+  _morphDur = 0;
 }
 
-/**
- * Forces the next frame to be computed on all active segments.
- */
-void WS2812FX::trigger() {
-  _triggered = true;
+static inline uint8_t morph8(uint8_t from, uint8_t to, uint32_t prog) { //prog 1 - 0x10000
+  return ((to * prog) + (from * (0x10000 - prog))) >> 16;
+}
+
+void WS2812FX::handleMorph(uint32_t nowUp) {
+  if (!_morphDur) return;
+  uint32_t elapsed = nowUp - _morphStart;
+  if (elapsed >= _morphDur) { stopMorph(); return; }
+  _morphProg = ((uint64_t)elapsed * 0xFFFF) / _morphDur;
+  uint32_t prog = _morphProg + 1;
+  for (uint8_t i = 0; i < _morphSegs; i++) {
+    SegmentMorph& m = _morph[i];
+    Segment& seg = _segments[i];
+    if (!m.active || !seg.isActive()) continue;
+    for (uint8_t s = 0; s < NUM_COLORS; s++) seg.colors[s] = color_blend(m.colFrom[s], m.colTo[s], _morphProg, true);
+    seg.speed     = morph8(m.speedFrom, m.speedTo, prog);
+    seg.intensity = morph8(m.intensityFrom, m.intensityTo, prog);
+    seg.opacity   = morph8(m.opacityFrom, m.opacityTo, prog);
+    for (uint8_t s = 0; s < NUM_COLORS; s++) { //replaces the color transitions of the preset and of colorUpdated() after it
+      uint8_t t = _transitionIndex[i][s];
+      if (t != 0xFF) transitions[t].end();
+    }
+    EffectDesc fx;
+    getEffect(seg.mode, fx);
+    if (fx.flags & FX_FLAG_STATIC) _segment_runtimes[i].next_time = nowUp; //would wait for its delay otherwise
+  }
 }
 
 void WS2812FX::setMode(uint8_t segid, uint8_t m) {
-  if (segid >= MAX_NUM_SEGMENTS) return;
+  if (segid >= _segCapacity && !growSegments(segid +1)) return;
    
   if (m >= MODE_COUNT) m = MODE_COUNT - 1;
 
   if (_segments[segid].mode != m) 
   {
+    //crossfade from the effect that last ran, not from one that was set without ever running
+    if (!_segment_runtimes[segid].resetPending()) _segment_runtimes[segid].fxFrom = _segments[segid].mode;
     _segment_runtimes[segid].reset();
     _segments[segid].mode = m;
   }
@@ -393,7 +1326,7 @@ uint8_t WS2812FX::getModeCount()
 
 uint8_t WS2812FX::getPaletteCount()
 {
-  return 13 + GRADIENT_PALETTE_COUNT;
+  return 13 + GRADIENT_PALETTE_COUNT + _customPaletteCount;
 }
 
 //TODO effect transitions
@@ -406,7 +1339,7 @@ bool WS2812FX::setEffectConfig(uint8_t m, uint8_t s, uint8_t in, uint8_t p) {
   bool applied = false;
   
   if (applyToAllSelected) {
-    for (uint8_t i = 0; i < MAX_NUM_SEGMENTS; i++)
+    for (uint8_t i = 0; i < _segCapacity; i++)
     {
       if (_segments[i].isSelected())
       {
@@ -440,7 +1373,7 @@ void WS2812FX::setColor(uint8_t slot, uint32_t c) {
   bool applied = false;
   
   if (applyToAllSelected) {
-    for (uint8_t i = 0; i < MAX_NUM_SEGMENTS; i++)
+    for (uint8_t i = 0; i < _segCapacity; i++)
     {
       if (_segments[i].isSelected()) {
         _segments[i].setColor(slot, c, i);
@@ -461,7 +1394,7 @@ void WS2812FX::setBrightness(uint8_t b) {
   _brightness = b;
   _segment_index = 0;
   if (_brightness == 0) { //unfreeze all segments on power off
-    for (uint8_t i = 0; i < MAX_NUM_SEGMENTS; i++)
+    for (uint8_t i = 0; i < _segCapacity; i++)
     {
       _segments[i].setOption(SEG_OPTION_FREEZE, false);
     }
@@ -487,11 +1420,11 @@ uint8_t WS2812FX::getMaxSegments(void) {
 
 /*uint8_t WS2812FX::getFirstSelectedSegment(void)
 {
-  for (uint8_t i = 0; i < MAX_NUM_SEGMENTS; i++)
+  for (uint8_t i = 0; i < _segCapacity; i++)
   {
     if (_segments[i].isActive() && _segments[i].isSelected()) return i;
   }
-  for (uint8_t i = 0; i < MAX_NUM_SEGMENTS; i++) //if none selected, get first active
+  for (uint8_t i = 0; i < _segCapacity; i++) //if none selected, get first active
   {
     if (_segments[i].isActive()) return i;
   }
@@ -499,9 +1432,9 @@ uint8_t WS2812FX::getMaxSegments(void) {
 }*/
 
 uint8_t WS2812FX::getMainSegmentId(void) {
-  if (mainSegment >= MAX_NUM_SEGMENTS) return 0;
+  if (mainSegment >= _segCapacity) return 0;
   if (_segments[mainSegment].isActive()) return mainSegment;
-  for (uint8_t i = 0; i < MAX_NUM_SEGMENTS; i++) //get first active
+  for (uint8_t i = 0; i < _segCapacity; i++) //get first active
   {
     if (_segments[i].isActive()) return i;
   }
@@ -510,7 +1443,7 @@ uint8_t WS2812FX::getMainSegmentId(void) {
 
 uint8_t WS2812FX::getActiveSegmentsNum(void) {
   uint8_t c = 0;
-  for (uint8_t i = 0; i < MAX_NUM_SEGMENTS; i++)
+  for (uint8_t i = 0; i < _segCapacity; i++)
   {
     if (_segments[i].isActive()) c++;
   }
@@ -523,6 +1456,9 @@ uint32_t WS2812FX::getColor(void) {
 
 uint32_t WS2812FX::getPixelColor(uint16_t i)
 {
+  if (_segPixels) return (i < SEGLEN) ? _segPixels[i] : 0;
+
+  if (SEGLEN) i *= SEGMENT.renderScale();
   i = realPixelIndex(i);
 
   if (SEGLEN) {
@@ -531,17 +1467,99 @@ uint32_t WS2812FX::getPixelColor(uint16_t i)
     if (i >= SEGMENT.stop) i -= SEGMENT.length();
   }
   
-  if (i < customMappingSize) i = customMappingTable[i];
+  i = mapPixel(i);
   if (i >= _length) return 0;
   
   return busses.getPixelColor(i);
 }
 
+//a free slot of the transition pool, growing it while enough heap is left
+uint8_t WS2812FX::allocateTransition() {
+  for (uint8_t i = 0; i < _numTransitions; i++) {
+    if (transitions[i].segment == 0xFF) return i;
+  }
+
+  uint8_t n = MIN(_numTransitions + MAX_NUM_TRANSITIONS, _segCapacity * NUM_COLORS);
+  if (n > _numTransitions && ESP.getFreeHeap() > n * sizeof(ColorTransition) + JSON_BUFFER_SIZE + 2048) {
+    ColorTransition* pool = (ColorTransition*) realloc(transitions, n * sizeof(ColorTransition));
+    if (pool) {
+      transitions = pool;
+      for (uint8_t i = _numTransitions; i < n; i++) {
+        transitions[i].segment = 0xFF;
+        transitions[i].colorOld = 0;
+        transitions[i].briOld = 0;
+      }
+      uint8_t i = _numTransitions;
+      _numTransitions = n;
+      return i;
+    }
+  }
+
+  //out of memory, the most progressed transition ends early
+  uint8_t tIndex = 0xFF;
+  uint16_t tProgression = 0;
+  for (uint8_t i = 0; i < _numTransitions; i++) {
+    uint16_t prog = transitions[i].progress();
+    if (prog >= tProgression) {
+      tIndex = i; tProgression = prog;
+    }
+  }
+  DEBUG_PRINTLN(F("Transition pool full"));
+  return tIndex;
+}
+
 WS2812FX::Segment& WS2812FX::getSegment(uint8_t id) {
-  if (id >= MAX_NUM_SEGMENTS) return _segments[0];
+  if (id >= _segCapacity && !growSegments(id +1)) { //no memory, writes go to a segment that is never rendered
+    static segment scratch;
+    memset(&scratch, 0, sizeof(segment));
+    return scratch;
+  }
   return _segments[id];
 }
 
+//makes segments 0 to n-1 available. Capacity only grows, so references to segments stay valid until the next growth
+bool WS2812FX::growSegments(uint8_t n) {
+  if (n <= _segCapacity) return true;
+  if (n > MAX_NUM_SEGMENTS) return false;
+  segment*         segs = (segment*)         malloc(n * sizeof(segment));
+  segment_runtime* envs = (segment_runtime*) malloc(n * sizeof(segment_runtime));
+  SegmentPerf*     perf = (SegmentPerf*)     malloc(n * sizeof(SegmentPerf));
+  uint8_t (*tIndex)[NUM_COLORS] = (uint8_t (*)[NUM_COLORS]) malloc(n * NUM_COLORS);
+  if (!segs || !envs || !perf || !tIndex) {
+    free(segs); free(envs); free(perf); free(tIndex);
+    DEBUG_PRINTLN(F("Not enough memory for segments"));
+    return false;
+  }
+  uint8_t old = _segCapacity;
+  if (old) {
+    memcpy(segs, _segments, old * sizeof(segment));
+    memcpy(envs, _segment_runtimes, old * sizeof(segment_runtime)); //buffers are owned by the arena, moving the pointers is enough
+    memcpy(perf, _segPerf, old * sizeof(SegmentPerf));
+    memcpy(tIndex, _transitionIndex, old * NUM_COLORS);
+  }
+  free(_segments); free(_segment_runtimes); free(_segPerf); free(_transitionIndex);
+  _segments = segs; _segment_runtimes = envs; _segPerf = perf; _transitionIndex = tIndex;
+  _segCapacity = n;
+  for (uint8_t i = old; i < n; i++) {
+    _segment_runtimes[i] = segment_runtime();
+    memset(&_segPerf[i], 0, sizeof(SegmentPerf));
+    memset(_transitionIndex[i], 0xFF, NUM_COLORS);
+    initSegment(i);
+  }
+  return true;
+}
+
+//defaults of an unused segment, it stays inactive until it gets a stop position
+void WS2812FX::initSegment(uint8_t n) {
+  memset(&_segments[n], 0, sizeof(segment));
+  _segments[n].colors[0] = color_wheel(n*51);
+  _segments[n].grouping = 1;
+  _segments[n].setOption(SEG_OPTION_ON, 1);
+  _segments[n].opacity = 255;
+  _segments[n].speed = DEFAULT_SPEED;
+  _segments[n].intensity = DEFAULT_INTENSITY;
+}
+
 WS2812FX::Segment_runtime WS2812FX::getSegmentRuntime(void) {
   return SEGENV;
 }
@@ -569,23 +1587,22 @@ uint16_t WS2812FX::getLengthPhysical(void) {
 }
 
 void WS2812FX::setSegment(uint8_t n, uint16_t i1, uint16_t i2, uint8_t grouping, uint8_t spacing) {
-  if (n >= MAX_NUM_SEGMENTS) return;
+  if (n >= _segCapacity && (i2 <= i1 || !growSegments(n +1))) return; //an unused segment is already disabled
   Segment& seg = _segments[n];
 
   //return if neither bounds nor grouping have changed
   if (seg.start == i1 && seg.stop == i2 && (!grouping || (seg.grouping == grouping && seg.spacing == spacing))) return;
 
   if (seg.stop) setRange(seg.start, seg.stop -1, 0); //turn old segment range off
+  _activeSegsDirty = true;
   if (i2 <= i1) //disable segment
   {
     seg.stop = 0;
-    if (seg.name) {
-      delete[] seg.name;
-      seg.name = nullptr;
-    }
+    setSegmentName(n, nullptr);
+    _segment_runtimes[n].reset(); //its buffers are released by updateActiveSegments()
     if (n == mainSegment) //if main segment is deleted, set first active as main segment
     {
-      for (uint8_t i = 0; i < MAX_NUM_SEGMENTS; i++)
+      for (uint8_t i = 0; i < _segCapacity; i++)
       {
         if (_segments[i].isActive()) {
           mainSegment = i;
@@ -606,40 +1623,88 @@ void WS2812FX::setSegment(uint8_t n, uint16_t i1, uint16_t i2, uint8_t grouping,
   _segment_runtimes[n].reset();
 }
 
+const char* WS2812FX::getSegmentName(uint8_t n) {
+  if (n >= _segCapacity || !_segNameLen[n]) return nullptr;
+  uint16_t ofs = 0;
+  for (uint8_t i = 0; i < n; i++) if (_segNameLen[i]) ofs += _segNameLen[i] +1;
+  return _segNames + ofs;
+}
+
+//the names after segment n are moved to make room, so a name is never allocated on its own
+bool WS2812FX::setSegmentName(uint8_t n, const char* name) {
+  size_t len = name ? strlen(name) : 0;
+  if (n >= _segCapacity && (!len || !growSegments(n +1))) return !len;
+  if (len > MAX_SEGMENT_NAME_LEN) return false;
+  uint16_t ofs = 0, used = 0;
+  for (uint8_t i = 0; i < _segCapacity; i++) {
+    if (!_segNameLen[i]) continue;
+    if (i < n) ofs += _segNameLen[i] +1;
+    used += _segNameLen[i] +1;
+  }
+  uint16_t oldSize = _segNameLen[n] ? _segNameLen[n] +1 : 0;
+  uint16_t newSize = len ? len +1 : 0;
+  if (!oldSize && !newSize) return true;
+  if (oldSize == newSize && !strcmp(_segNames + ofs, name)) return true;
+  uint16_t need = used - oldSize + newSize;
+  if (need > _segNamesSize) {
+    uint16_t size = MIN((need + SEGMENT_NAME_POOL_STEP -1) / SEGMENT_NAME_POOL_STEP * SEGMENT_NAME_POOL_STEP, SEGMENT_NAME_POOL);
+    char* names = (char*)realloc(_segNames, size);
+    if (!names) {
+      DEBUG_PRINTLN(F("Not enough memory for segment names"));
+      return false;
+    }
+    _segNames = names;
+    _segNamesSize = size;
+  }
+  memmove(_segNames + ofs + newSize, _segNames + ofs + oldSize, used - ofs - oldSize);
+  if (len) memcpy(_segNames + ofs, name, newSize);
+  _segNameLen[n] = len;
+  return true;
+}
+
+//sets the 2D matrix wiring of segment n, width 0 or height 0 make it a 1D segment again
+void WS2812FX::setSegmentGeometry(uint8_t n, uint16_t width, uint16_t height, uint8_t layout) {
+  if (n >= _segCapacity && !growSegments(n +1)) return;
+  Segment& seg = _segments[n];
+  if (!width || !height) width = height = 0;
+  layout &= SEG_2D_MASK;
+  if (seg.width == width && seg.height == height && seg.layout == layout) return;
+  seg.width = width;
+  seg.height = height;
+  seg.layout = layout;
+  _segment_runtimes[n].reset(); //effect state and XY lookup are for the old geometry
+}
+
+//effects of segment n render every scale-th output pixel, 0 or 1 for all of them
+void WS2812FX::setSegmentScale(uint8_t n, uint8_t scale) {
+  if (n >= _segCapacity && !growSegments(n +1)) return;
+  if (scale > SEG_MAX_RENDER_SCALE) scale = SEG_MAX_RENDER_SCALE;
+  if (scale < 2) scale = 0;
+  if (_segments[n].scale == scale) return;
+  _segments[n].scale = scale;
+  _segment_runtimes[n].reset(); //effect state is sized for the old length
+}
+
 void WS2812FX::resetSegments() {
-  for (uint8_t i = 0; i < MAX_NUM_SEGMENTS; i++) if (_segments[i].name) delete _segments[i].name;
+  memset(_segNameLen, 0, sizeof(_segNameLen));
+  _activeSegsDirty = true;
   mainSegment = 0;
-  memset(_segments, 0, sizeof(_segments));
-  //memset(_segment_runtimes, 0, sizeof(_segment_runtimes));
   _segment_index = 0;
+  for (uint8_t i = 0; i < _segCapacity; i++)
+  {
+    initSegment(i);
+    _segment_runtimes[i].reset();
+  }
   _segments[0].mode = DEFAULT_MODE;
   _segments[0].colors[0] = DEFAULT_COLOR;
-  _segments[0].start = 0;
-  _segments[0].speed = DEFAULT_SPEED;
-  _segments[0].intensity = DEFAULT_INTENSITY;
   _segments[0].stop = _length;
-  _segments[0].grouping = 1;
   _segments[0].setOption(SEG_OPTION_SELECTED, 1);
-  _segments[0].setOption(SEG_OPTION_ON, 1);
-  _segments[0].opacity = 255;
-
-  for (uint16_t i = 1; i < MAX_NUM_SEGMENTS; i++)
-  {
-    _segments[i].colors[0] = color_wheel(i*51);
-    _segments[i].grouping = 1;
-    _segments[i].setOption(SEG_OPTION_ON, 1);
-    _segments[i].opacity = 255;
-    _segments[i].speed = DEFAULT_SPEED;
-    _segments[i].intensity = DEFAULT_INTENSITY;
-    _segment_runtimes[i].reset();
-  }
-  _segment_runtimes[0].reset();
 }
 
 void WS2812FX::makeAutoSegments() {
   if (autoSegments) { //make one segment per bus
-    uint16_t segStarts[MAX_NUM_SEGMENTS] = {0};
-    uint16_t segStops [MAX_NUM_SEGMENTS] = {0};
+    uint16_t segStarts[WLED_MAX_BUSSES] = {0};
+    uint16_t segStops [WLED_MAX_BUSSES] = {0};
     uint8_t s = 0;
     for (uint8_t i = 0; i < busses.getNumBusses(); i++) {
       Bus* b = busses.getBus(i);
@@ -658,8 +1723,10 @@ void WS2812FX::makeAutoSegments() {
       }
       s++;
     }
-    for (uint8_t i = 0; i < MAX_NUM_SEGMENTS; i++) {
-      setSegment(i, segStarts[i], segStops[i]);
+    uint8_t n = MAX(s, _segCapacity);
+    for (uint8_t i = 0; i < n; i++) {
+      if (i < s) setSegment(i, segStarts[i], segStops[i]);
+      else       setSegment(i, 0, 0);
     }
   } else {
     //expand the main seg to the entire length, but only if there are no other segments
@@ -675,7 +1742,7 @@ void WS2812FX::makeAutoSegments() {
 
 void WS2812FX::fixInvalidSegments() {
   //make sure no segment is longer than total (sanity check)
-  for (uint8_t i = 0; i < MAX_NUM_SEGMENTS; i++)
+  for (uint8_t i = 0; i < _segCapacity; i++)
   {
     if (_segments[i].start >= _length) setSegment(i, 0, 0); 
     if (_segments[i].stop  >  _length) setSegment(i, _segments[i].start, _length);
@@ -684,7 +1751,7 @@ void WS2812FX::fixInvalidSegments() {
 
 //true if all segments align with a bus, or if a segment covers the total length
 bool WS2812FX::checkSegmentAlignment() {
-  for (uint8_t i = 0; i < MAX_NUM_SEGMENTS; i++)
+  for (uint8_t i = 0; i < _segCapacity; i++)
   {
     if (_segments[i].start >= _segments[i].stop) continue; //inactive segment
     bool aligned = false;
@@ -701,13 +1768,15 @@ bool WS2812FX::checkSegmentAlignment() {
 //After this function is called, setPixelColor() will use that segment (offsets, grouping, ... will apply)
 void WS2812FX::setPixelSegment(uint8_t n)
 {
-  if (n < MAX_NUM_SEGMENTS) {
+  if (n < _segCapacity) {
     _segment_index = n;
     _virtualSegmentLength = SEGMENT.length();
   } else {
     _segment_index = 0;
     _virtualSegmentLength = 0;
   }
+  _pixelWriterSeg = 0xFF;
+  _virtualWidth = _virtualSegmentLength; _virtualHeight = _virtualSegmentLength ? 1 : 0;
 }
 
 void WS2812FX::setRange(uint16_t i, uint16_t i2, uint32_t col)
@@ -721,6 +1790,20 @@ void WS2812FX::setRange(uint16_t i, uint16_t i2, uint32_t col)
   }
 }
 
+/*
+ * Writes pixels i to i2 of the output directly, from the show callback.
+ * The segment framebuffers stay valid, since overlays are drawn again over the flushed segments on every show().
+ */
+void WS2812FX::drawOverlayRange(uint16_t i, uint16_t i2, uint32_t col)
+{
+  if (i2 < i) { uint16_t t = i; i = i2; i2 = t; }
+  if (i2 >= _length) i2 = _length -1;
+  byte w = col >> 24, r = col >> 16, g = col >> 8, b = col;
+  autoWhite(r, g, b, w);
+  col = ((uint32_t)w << 24) | ((uint32_t)r << 16) | ((uint32_t)g << 8) | b;
+  for (uint32_t x = i; x <= i2; x++) busses.setPixelColor(mapPixel(x), col);
+}
+
 void WS2812FX::setShowCallback(show_callback cb)
 {
   _callback = cb;
@@ -734,7 +1817,7 @@ void WS2812FX::setTransition(uint16_t t)
 void WS2812FX::setTransitionMode(bool t)
 {
   unsigned long waitMax = millis() + 20; //refresh after 20 ms if transition enabled
-  for (uint16_t i = 0; i < MAX_NUM_SEGMENTS; i++)
+  for (uint8_t i = 0; i < _segCapacity; i++)
   {
     _segment_index = i;
     SEGMENT.setOption(SEG_OPTION_TRANSITIONAL, t);
@@ -743,6 +1826,14 @@ void WS2812FX::setTransitionMode(bool t)
   }
 }
 
+//without opacity scaling or automatic white, buffer kernels may work on the framebuffer in place
+uint32_t* WS2812FX::directBuffer()
+{
+  if (!_segPixels || _bri_t < 255) return nullptr;
+  if (isRgbw && rgbwMode != RGBW_MODE_MANUAL_ONLY) return nullptr;
+  return _segPixels;
+}
+
 /*
  * color blend function
  */
@@ -750,7 +1841,12 @@ uint32_t WS2812FX::color_blend(uint32_t color1, uint32_t color2, uint16_t blend,
   if(blend == 0)   return color1;
   uint16_t blendmax = b16 ? 0xFFFF : 0xFF;
   if(blend == blendmax) return color2;
-  uint8_t shift = b16 ? 16 : 8;
+  if (!b16) { //two 16 bit lanes per word, no channel can overflow into the next one
+    uint32_t inv = 255 - blend;
+    return ((((color2 & 0x00FF00FF) * blend + (color1 & 0x00FF00FF) * inv) >> 8) & 0x00FF00FF) |
+           ((((color2 >> 8) & 0x00FF00FF) * blend + ((color1 >> 8) & 0x00FF00FF) * inv) & 0xFF00FF00);
+  }
+  uint8_t shift = 16;
 
   uint32_t w1 = (color1 >> 24) & 0xFF;
   uint32_t r1 = (color1 >> 16) & 0xFF;
@@ -774,6 +1870,16 @@ uint32_t WS2812FX::color_blend(uint32_t color1, uint32_t color2, uint16_t blend,
  * Fills segment with color
  */
 void WS2812FX::fill(uint32_t c) {
+  if (_segPixels && SEGLEN) { //compute the color once, the buffer is written out as spans
+    setPixelColor(0, c);
+    uint32_t col = _segPixels[0];
+    for (uint16_t i = 1; i < SEGLEN; i++) {
+      if (_segPixels[i] == col) continue;
+      _segPixels[i] = col;
+      SEGENV.dirty = true;
+    }
+    return;
+  }
   for(uint16_t i = 0; i < SEGLEN; i++) {
     setPixelColor(i, c);
   }
@@ -784,6 +1890,12 @@ void WS2812FX::fill(uint32_t c) {
  */
 void WS2812FX::blendPixelColor(uint16_t n, uint32_t color, uint8_t blend)
 {
+  if (uint32_t* buf = directBuffer()) {
+    if (n >= SEGLEN) return;
+    uint32_t c = color_blend(buf[n], color, blend);
+    if (c != buf[n]) { buf[n] = c; SEGENV.dirty = true; }
+    return;
+  }
   setPixelColor(n, color_blend(getPixelColor(n), color, blend));
 }
 
@@ -792,33 +1904,15 @@ void WS2812FX::blendPixelColor(uint16_t n, uint32_t color, uint8_t blend)
  */
 void WS2812FX::fade_out(uint8_t rate) {
   rate = (255-rate) >> 1;
-  float mappedRate = float(rate) +1.1;
-
-  uint32_t color = SEGCOLOR(1); // target color
-  int w2 = (color >> 24) & 0xff;
-  int r2 = (color >> 16) & 0xff;
-  int g2 = (color >>  8) & 0xff;
-  int b2 =  color        & 0xff;
+  uint32_t inv = (1UL << 24) / (10 * rate + 11) + 1; //reciprocal of rate + 1.1, see fadeColor()
+  uint32_t target = SEGCOLOR(1);
 
+  if (uint32_t* buf = directBuffer()) {
+    if (fadeBuffer(buf, SEGLEN, target, inv)) SEGENV.dirty = true;
+    return;
+  }
   for(uint16_t i = 0; i < SEGLEN; i++) {
-    color = getPixelColor(i);
-    int w1 = (color >> 24) & 0xff;
-    int r1 = (color >> 16) & 0xff;
-    int g1 = (color >>  8) & 0xff;
-    int b1 =  color        & 0xff;
-
-    int wdelta = (w2 - w1) / mappedRate;
-    int rdelta = (r2 - r1) / mappedRate;
-    int gdelta = (g2 - g1) / mappedRate;
-    int bdelta = (b2 - b1) / mappedRate;
-
-    // if fade isn't complete, make sure delta is at least 1 (fixes rounding issues)
-    wdelta += (w2 == w1) ? 0 : (w2 > w1) ? 1 : -1;
-    rdelta += (r2 == r1) ? 0 : (r2 > r1) ? 1 : -1;
-    gdelta += (g2 == g1) ? 0 : (g2 > g1) ? 1 : -1;
-    bdelta += (b2 == b1) ? 0 : (b2 > b1) ? 1 : -1;
-
-    setPixelColor(i, r1 + rdelta, g1 + gdelta, b1 + bdelta, w1 + wdelta);
+    setPixelColor(i, fadeColor(getPixelColor(i), target, inv));
   }
 }
 
@@ -827,6 +1921,10 @@ void WS2812FX::fade_out(uint8_t rate) {
  */
 void WS2812FX::blur(uint8_t blur_amount)
 {
+  if (uint32_t* buf = directBuffer()) {
+    if (blurBuffer(buf, SEGLEN, blur_amount)) SEGENV.dirty = true;
+    return;
+  }
   uint8_t keep = 255 - blur_amount;
   uint8_t seep = blur_amount >> 1;
   CRGB carryover = CRGB::Black;
@@ -849,6 +1947,69 @@ void WS2812FX::blur(uint8_t blur_amount)
   }
 }
 
+/*
+ * 2D variants, rows and columns as seen by the effect. Like blur(), they read and write the segment framebuffer if there is one.
+ */
+void WS2812FX::blurLine(uint16_t x, uint16_t y, bool vertical, uint8_t blur_amount)
+{
+  uint8_t keep = 255 - blur_amount;
+  uint8_t seep = blur_amount >> 1;
+  CRGB carryover = CRGB::Black;
+  uint16_t count = vertical ? SEGH : SEGW;
+  uint16_t prev = 0xFFFF;
+  for (uint16_t j = 0; j < count; j++) {
+    uint16_t i = vertical ? XY(x, j) : XY(j, y);
+    CRGB cur = col_to_crgb(getPixelColor(i));
+    CRGB part = cur;
+    part.nscale8(seep);
+    cur.nscale8(keep);
+    cur += carryover;
+    if (prev != 0xFFFF) {
+      uint32_t c = getPixelColor(prev);
+      setPixelColor(prev, qadd8(c >> 16 & 0xFF, part.red), qadd8(c >> 8 & 0xFF, part.green), qadd8(c & 0xFF, part.blue));
+    }
+    setPixelColor(i, cur.red, cur.green, cur.blue);
+    carryover = part;
+    prev = i;
+  }
+}
+
+void WS2812FX::blurRows(uint8_t blur_amount)
+{
+  for (uint16_t y = 0; y < SEGH; y++) blurLine(0, y, false, blur_amount);
+}
+
+void WS2812FX::blurColumns(uint8_t blur_amount)
+{
+  for (uint16_t x = 0; x < SEGW; x++) blurLine(x, 0, true, blur_amount);
+}
+
+void WS2812FX::blur2d(uint8_t blur_amount)
+{
+  blurRows(blur_amount);
+  blurColumns(blur_amount);
+}
+
+void WS2812FX::fillRect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint32_t c)
+{
+  if (x >= SEGW || y >= SEGH) return;
+  if (w > SEGW - x) w = SEGW - x;
+  if (h > SEGH - y) h = SEGH - y;
+  if (!w || !h) return;
+  setPixelColor(XY(x, y), c);
+  //with a framebuffer the color (opacity and white applied) is copied instead of recomputed per pixel
+  uint32_t col = _segPixels ? _segPixels[XY(x, y)] : c;
+  for (uint16_t j = y; j < y + h; j++) {
+    for (uint16_t i = x; i < x + w; i++) {
+      uint16_t p = XY(i, j);
+      if (!_segPixels) { setPixelColor(p, c); continue; }
+      if (_segPixels[p] == col) continue;
+      _segPixels[p] = col;
+      SEGENV.dirty = true;
+    }
+  }
+}
+
 uint16_t WS2812FX::triwave16(uint16_t in)
 {
   if (in < 0x8000) return in *2;
@@ -947,51 +2108,20 @@ void WS2812FX::load_gradient_palette(uint8_t index)
 }
 
 
-/*
- * FastLED palette modes helper function. Limitation: Due to memory reasons, multiple active segments with FastLED will disable the Palette transitions
- */
-void WS2812FX::handle_palette(void)
+//builds palette index into targetPalette
+void WS2812FX::loadPalette(uint8_t paletteIndex)
 {
-  bool singleSegmentMode = (_segment_index == _segment_index_palette_last);
-  _segment_index_palette_last = _segment_index;
-
-  byte paletteIndex = SEGMENT.palette;
-  if (paletteIndex == 0) //default palette. Differs depending on effect
-  {
-    switch (SEGMENT.mode)
-    {
-      case FX_MODE_FIRE_2012  : paletteIndex = 35; break; //heat palette
-      case FX_MODE_COLORWAVES : paletteIndex = 26; break; //landscape 33
-      case FX_MODE_FILLNOISE8 : paletteIndex =  9; break; //ocean colors
-      case FX_MODE_NOISE16_1  : paletteIndex = 20; break; //Drywet
-      case FX_MODE_NOISE16_2  : paletteIndex = 43; break; //Blue cyan yellow
-      case FX_MODE_NOISE16_3  : paletteIndex = 35; break; //heat palette
-      case FX_MODE_NOISE16_4  : paletteIndex = 26; break; //landscape 33
-      case FX_MODE_GLITTER    : paletteIndex = 11; break; //rainbow colors
-      case FX_MODE_SUNRISE    : paletteIndex = 35; break; //heat palette
-      case FX_MODE_FLOW       : paletteIndex =  6; break; //party
-    }
-  }
-  if (SEGMENT.mode >= FX_MODE_METEOR && paletteIndex == 0) paletteIndex = 4;
-  
   switch (paletteIndex)
   {
-    case 0: //default palette. Exceptions for specific effects above
+    case 0: //default palette. Exceptions for specific effects in the effect descriptions
       targetPalette = PartyColors_p; break;
-    case 1: {//periodically replace palette with a random one. Doesn't work with multiple FastLED segments
-      if (!singleSegmentMode)
-      {
-        targetPalette = PartyColors_p; break; //fallback
-      }
-      if (millis() - _lastPaletteChange > 1000 + ((uint32_t)(255-SEGMENT.intensity))*100)
-      {
-        targetPalette = CRGBPalette16(
-                        CHSV(random8(), 255, random8(128, 255)),
-                        CHSV(random8(), 255, random8(128, 255)),
-                        CHSV(random8(), 192, random8(128, 255)),
-                        CHSV(random8(), 255, random8(128, 255)));
-        _lastPaletteChange = millis();
-      } break;}
+    case 1: //random palette, handle_palette() decides when to replace it
+      targetPalette = CRGBPalette16(
+                      CHSV(random8(), 255, random8(128, 255)),
+                      CHSV(random8(), 255, random8(128, 255)),
+                      CHSV(random8(), 192, random8(128, 255)),
+                      CHSV(random8(), 255, random8(128, 255)));
+      break;
     case 2: {//primary color only
       CRGB prim = col_to_crgb(SEGCOLOR(0));
       targetPalette = CRGBPalette16(prim); break;}
@@ -1028,17 +2158,93 @@ void WS2812FX::handle_palette(void)
       targetPalette = RainbowColors_p; break;
     case 12: //Rainbow stripe colors
       targetPalette = RainbowStripeColors_p; break;
-    default: //progmem palettes
-      load_gradient_palette(paletteIndex -13);
+    default:
+      if (paletteIndex < 13 + GRADIENT_PALETTE_COUNT) load_gradient_palette(paletteIndex -13); //progmem palettes
+      else if (paletteIndex - 13 - GRADIENT_PALETTE_COUNT < _customPaletteCount) targetPalette = _customPalettes[paletteIndex - 13 - GRADIENT_PALETTE_COUNT];
+      else targetPalette = PartyColors_p; //custom palette file removed
   }
-  
-  if (singleSegmentMode && paletteFade && SEGENV.call > 0) //only blend if just one segment uses FastLED mode
-  {
-    nblendPaletteTowardPalette(currentPalette, targetPalette, 48);
-  } else
-  {
+}
+
+/*
+ * Sets currentPalette for the effect of the current segment.
+ * Each segment keeps its own palette, which is only rebuilt when the palette or its colors change
+ * and fades towards a new palette independently of the other segments.
+ * defaultPalette: palette of the effect description, used if the segment has palette 0
+ */
+void WS2812FX::handle_palette(uint8_t defaultPalette)
+{
+  byte paletteIndex = SEGMENT.palette;
+  if (paletteIndex == 0) paletteIndex = defaultPalette; //default palette. Differs depending on effect
+
+  uint32_t key = paletteIndex;
+  if (paletteIndex >= 2 && paletteIndex <= 5) { //made of the segment colors
+    key ^= _colors_t[0] << 8;
+    key ^= _colors_t[1] << 3 | _colors_t[1] >> 29;
+    if (paletteIndex != 2) key ^= _colors_t[2] << 13 | _colors_t[2] >> 19;
+  } else if (paletteIndex >= 13 + GRADIENT_PALETTE_COUNT) {
+    key ^= _customPaletteVersion << 8;
+  }
+
+  PaletteCache* pc = SEGENV.palette;
+  bool rebuild = (SEGENV.call == 0 || !pc || key != pc->key);
+  if (!pc) pc = SEGENV.palette = new PaletteCache();
+  if (!pc) { //out of memory, build into the shared palette without transition
+    loadPalette(paletteIndex);
     currentPalette = targetPalette;
+    return;
+  }
+
+  if (paletteIndex == 1 && millis() - pc->lastChange > 1000 + ((uint32_t)(255-SEGMENT.intensity))*100) {
+    rebuild = true; //periodically replace palette with a random one
+    pc->lastChange = millis();
+  }
+  if (rebuild) {
+    loadPalette(paletteIndex);
+    pc->target = targetPalette;
+    pc->key = key;
+  }
+
+  if (_morphDur && _segment_index < _morphSegs && _morph[_segment_index].active && _morph[_segment_index].hasPal) {
+    blend(_morph[_segment_index].palFrom.entries, pc->target.entries, pc->current.entries, 16, _morphProg >> 8); //crossfade
+    #ifdef WLED_PALETTE_LUT
+    pc->lutBlend = 0xFF;
+    #endif
+  } else if (pc->current != pc->target) {
+    if (paletteFade && SEGENV.call > 0) nblendPaletteTowardPalette(pc->current, pc->target, 48);
+    else pc->current = pc->target;
+    #ifdef WLED_PALETTE_LUT
+    pc->lutBlend = 0xFF; //expanded again on the next lookup
+    #endif
   }
+  currentPalette = pc->current;
+}
+
+/*
+ * Color at index of the palette of the current segment, as ColorFromPalette(currentPalette, ...) would return it.
+ * With WLED_PALETTE_LUT the palette is expanded once after each change and this is a single table read.
+ */
+uint32_t WS2812FX::paletteLookup(uint8_t index, uint8_t pbri, TBlendType blendType)
+{
+  #ifdef WLED_PALETTE_LUT
+  PaletteCache* pc = SEGENV.palette;
+  if (pc) {
+    if (pc->lutBlend != blendType) {
+      for (uint16_t i = 0; i < 256; i++) pc->lut[i] = crgb_to_col(ColorFromPalette(pc->current, i, 255, blendType));
+      pc->lutBlend = blendType;
+    }
+    uint32_t c = pc->lut[index];
+    if (pbri == 255) return c;
+    if (pbri == 0) return 0;
+    uint8_t s = pbri +1; //same rounding as ColorFromPalette()
+    return ((uint32_t)scale8(c >> 16, s) << 16) | ((uint32_t)scale8(c >> 8, s) << 8) | scale8(c, s);
+  }
+  #endif
+  return crgb_to_col(ColorFromPalette(currentPalette, index, pbri, blendType));
+}
+
+CRGB WS2812FX::palette_color(uint8_t index, uint8_t pbri)
+{
+  return col_to_crgb(paletteLookup(index, pbri, LINEARBLEND));
 }
 
 
@@ -1067,52 +2273,364 @@ uint32_t WS2812FX::color_from_palette(uint16_t i, bool mapping, bool wrap, uint8
   uint8_t paletteIndex = i;
   if (mapping && SEGLEN > 1) paletteIndex = (i*255)/(SEGLEN -1);
   if (!wrap) paletteIndex = scale8(paletteIndex, 240); //cut off blend at palette "end"
-  CRGB fastled_col;
-  fastled_col = ColorFromPalette( currentPalette, paletteIndex, pbri, (paletteBlend == 3)? NOBLEND:LINEARBLEND);
+  return paletteLookup(paletteIndex, pbri, (paletteBlend == 3)? NOBLEND:LINEARBLEND);
+}
+
+
+/*
+ * LED maps: /ledmapN.bin holds the map behind a small header, so loading is a single read.
+ * Version 1 stores one raw little endian uint16 per LED, version 2 the runs of a compressed map.
+ * /ledmapN.json is converted to it on first load and again whenever the JSON file changes. Besides
+ * the plain "map" array it may describe the map as "runs":[[start,len,stride],...] or as
+ * "matrix":{"w":16,"h":16,"serp":true,"vert":false}.
+ */
+#define LEDMAP_BIN_MAGIC   0x50414D4C //"LMAP"
+#define LEDMAP_BIN_TABLE   1
+#define LEDMAP_BIN_RUNS    2
+
+typedef struct LedmapHeader {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t count;   //number of mapped LEDs
+  uint32_t srcSize; //size and modification time of the JSON file it was converted from
+  uint32_t srcTime;
+} __attribute__((packed)) LedmapHeader;
+
+//reads the "map" array of a JSON ledmap without a JSON document, so the map size is not limited by JSON_BUFFER_SIZE
+//counts the entries only if table is a nullptr
+static uint16_t parseLedmapJson(File& f, uint16_t* table, uint16_t maxLen)
+{
+  const char* key = "\"map\"";
+  uint8_t keyPos = 0;
+  bool inArray = false, inNumber = false, negative = false;
+  int32_t value = 0;
+  uint16_t count = 0;
+  byte buf[256];
+
+  f.seek(0, SeekSet);
+  while (f.available()) {
+    uint16_t len = f.read(buf, sizeof(buf));
+    for (uint16_t i = 0; i < len; i++) {
+      char c = buf[i];
+      if (!inArray) {
+        if (key[keyPos]) keyPos = (c == key[keyPos]) ? keyPos +1 : (c == key[0]);
+        else if (c == '[') inArray = true;
+        continue;
+      }
+      if (c >= '0' && c <= '9') {
+        value = value*10 + (c - '0');
+        inNumber = true;
+      } else if (c == '-') {
+        negative = true;
+      } else if (c == ',' || c == ']') {
+        if (inNumber) {
+          if (count < maxLen && table) table[count] = (uint16_t)(negative ? -value : value); //-1 (no LED) wraps as before
+          if (count < maxLen) count++;
+        }
+        if (c == ']') return count;
+        value = 0; inNumber = false; negative = false;
+      }
+    }
+  }
+  return count;
+}
+
+uint16_t WS2812FX::mapPixelRun(uint16_t i)
+{
+  const MapRun* r = &customMappingRuns[_lastMapRun];
+  if (i < r->start || i >= r->start + r->len) {
+    uint16_t next = _lastMapRun +1;
+    if (next < customMappingRunCount && i >= customMappingRuns[next].start && i < customMappingRuns[next].start + customMappingRuns[next].len) {
+      _lastMapRun = next;
+    } else { //binary search, the runs are sorted by start
+      uint16_t lo = 0, hi = customMappingRunCount;
+      while (hi - lo > 1) {
+        uint16_t mid = (lo + hi) >> 1;
+        if (customMappingRuns[mid].start <= i) lo = mid;
+        else hi = mid;
+      }
+      _lastMapRun = lo;
+    }
+    r = &customMappingRuns[_lastMapRun];
+    if (i < r->start || i >= r->start + r->len) return i; //not covered by the map
+  }
+  return r->base + (i - r->start) * r->stride;
+}
+
+void WS2812FX::clearCustomMapping()
+{
+  free(customMappingTable);
+  customMappingTable = nullptr;
+  free(customMappingRuns);
+  customMappingRuns = nullptr;
+  customMappingRunCount = 0;
+  customMappingSize = 0;
+  _lastMapRun = 0;
+  _pixelWriterSeg = 0xFF;
+}
+
+//replaces the table by runs of constant stride if that needs at most half the memory
+void WS2812FX::compressCustomMapping()
+{
+  if (!customMappingTable || customMappingSize < 2) return;
+  uint16_t runs = 1;
+  for (uint16_t i = 2; i < customMappingSize; i++) {
+    //a new run starts where the stride changes, the entry after it decides the stride of the new run
+    if ((uint16_t)(customMappingTable[i] - customMappingTable[i-1]) != (uint16_t)(customMappingTable[i-1] - customMappingTable[i-2])) {
+      runs++;
+      i++;
+    }
+  }
+  if (runs * sizeof(MapRun) > customMappingSize) return; //table is smaller
+  MapRun* r = (MapRun*) allocLarge(runs * sizeof(MapRun));
+  if (!r) return;
+  uint16_t n = 0;
+  for (uint16_t i = 0; i < customMappingSize; n++) {
+    r[n].start = i;
+    r[n].base = customMappingTable[i];
+    r[n].stride = (i +1 < customMappingSize) ? (int16_t)(customMappingTable[i+1] - customMappingTable[i]) : 1;
+    r[n].len = 1;
+    while (i + r[n].len < customMappingSize && (uint16_t)(r[n].base + r[n].len * r[n].stride) == customMappingTable[i + r[n].len]) r[n].len++;
+    i += r[n].len;
+  }
+  free(customMappingTable);
+  customMappingTable = nullptr;
+  customMappingRuns = r;
+  customMappingRunCount = n;
+  DEBUG_PRINTF("LED map compressed to %d runs\n", n);
+}
+
+//logical pixels are addressed row by row, the LEDs wired in rows or columns, optionally serpentine
+void WS2812FX::buildMatrixMapping(uint16_t w, uint16_t h, bool serpentine, bool vertical)
+{
+  if (!w || !h || (uint32_t)w * h > MAX_LEDS) return;
+  _pixelWriterSeg = 0xFF;
+  customMappingSize = w * h;
+  if (!vertical || !serpentine) { //one run per row
+    customMappingRuns = (MapRun*) allocLarge(h * sizeof(MapRun));
+    if (!customMappingRuns) { customMappingSize = 0; return; }
+    customMappingRunCount = h;
+    for (uint16_t y = 0; y < h; y++) {
+      MapRun& r = customMappingRuns[y];
+      r.start = y * w;
+      r.len = w;
+      if (vertical)                     { r.base = y;         r.stride = h;  }
+      else if (serpentine && (y & 0x01)) { r.base = y * w + w -1; r.stride = -1; }
+      else                              { r.base = y * w;     r.stride = 1;  }
+    }
+    return;
+  }
+  //serpentine columns do not form runs along the rows
+  customMappingTable = (uint16_t*) allocLarge(customMappingSize * sizeof(uint16_t));
+  if (!customMappingTable) { customMappingSize = 0; return; }
+  for (uint16_t y = 0; y < h; y++)
+    for (uint16_t x = 0; x < w; x++) customMappingTable[y * w + x] = x * h + ((x & 0x01) ? h -1 - y : y);
+}
+
+uint32_t WS2812FX::getMappingMemory()
+{
+  uint32_t mem = customMappingSize * (customMappingTable ? sizeof(uint16_t) : 0) + customMappingRunCount * sizeof(MapRun);
+  for (uint8_t i = 0; i < WLED_LEDMAP_CACHE; i++) {
+    const CachedLedmap& c = _ledmapCache[i];
+    mem += c.size * (c.table ? sizeof(uint16_t) : 0) + c.runCount * sizeof(MapRun);
+  }
+  return mem;
+}
 
-  return crgb_to_col(fastled_col);
+void WS2812FX::clearLedmapCache()
+{
+  for (uint8_t i = 0; i < WLED_LEDMAP_CACHE; i++) {
+    free(_ledmapCache[i].table);
+    free(_ledmapCache[i].runs);
+    _ledmapCache[i] = {nullptr, nullptr, 0, 0, 255};
+  }
+}
+
+//makes /ledmapN.json the active map. The previous one is kept in the cache, a cached map is taken from there without reading the file
+void WS2812FX::setLedmap(uint8_t n)
+{
+  if (n == _ledmapId) return;
+  uint8_t hit = WLED_LEDMAP_CACHE;
+  for (uint8_t i = 0; i < WLED_LEDMAP_CACHE; i++) if (_ledmapCache[i].id == n) hit = i;
+  CachedLedmap next = {nullptr, nullptr, 0, 0, 255};
+  if (hit < WLED_LEDMAP_CACHE) next = _ledmapCache[hit];
+  else {
+    hit = WLED_LEDMAP_CACHE -1; //least recently used one goes
+    free(_ledmapCache[hit].table);
+    free(_ledmapCache[hit].runs);
+  }
+  memmove(&_ledmapCache[1], &_ledmapCache[0], hit * sizeof(CachedLedmap));
+  _ledmapCache[0] = {customMappingTable, customMappingRuns, customMappingRunCount, customMappingSize, _ledmapId};
+  customMappingTable = next.table;
+  customMappingRuns = next.runs;
+  customMappingRunCount = next.runCount;
+  customMappingSize = next.size;
+  _lastMapRun = 0;
+  _pixelWriterSeg = 0xFF;
+  _ledmapId = n;
+  if (next.id == 255) deserializeMap(n);
+  _forceFlush = true; //pixels not written by the next frame would stay where the old map put them
+  DEBUG_PRINTF("LED map %d active%s\n", n, next.id == 255 ? "" : " (cached)");
+}
+
+//drops the cached maps and reads the active one again, after a ledmap file changed
+void WS2812FX::reloadLedmaps()
+{
+  clearLedmapCache();
+  clearCustomMapping();
+  deserializeMap(_ledmapId);
+  _forceFlush = true;
 }
 
+/*
+ * Reads the user palettes /palette0.bin, /palette1.bin ... up to the first one missing or invalid.
+ * Each is a gradient as in palettes.h: 2 to 18 entries of index, r, g, b, the first index 0 and the last 255.
+ * They are expanded here once, rendering copies them from RAM into the segment palette cache.
+ */
+void WS2812FX::loadCustomPalettes()
+{
+  delete[] _customPalettes;
+  _customPalettes = nullptr;
+  _customPaletteCount = 0;
+  _customPaletteVersion++;
+
+  char fileName[16];
+  uint8_t count = 0;
+  while (count < WLED_MAX_CUSTOM_PALETTES) {
+    sprintf_P(fileName, PSTR("/palette%d.bin"), count);
+    if (!mediaFileExists(fileName)) break;
+    count++;
+  }
+  if (!count) return;
+  _customPalettes = new CRGBPalette16[count];
+  if (!_customPalettes) return;
+
+  for (uint8_t n = 0; n < count; n++) {
+    sprintf_P(fileName, PSTR("/palette%d.bin"), n);
+    File f = openMediaFile(fileName);
+    byte tcp[72];
+    size_t len = f ? f.read(tcp, sizeof(tcp)) : 0;
+    if (f) f.close();
+    bool valid = len >= 8 && !(len & 3) && tcp[0] == 0 && tcp[len -4] == 255;
+    for (size_t i = 4; valid && i < len; i += 4) valid = tcp[i] >= tcp[i -4]; //a repeated index is a hard stop
+    _customPaletteCount++; //an invalid file keeps its number, so the palettes after it do not move
+    if (!valid) {
+      DEBUG_PRINT(F("Invalid palette ")); DEBUG_PRINTLN(fileName);
+      _customPalettes[n] = CRGBPalette16(CRGB::Black);
+      continue;
+    }
+    _customPalettes[n].loadDynamicGradientPalette(tcp);
+  }
+  DEBUG_PRINTF("%d custom palettes\n", _customPaletteCount);
+}
 
-//load custom mapping table from JSON file
+//load custom mapping table from binary or JSON file
 void WS2812FX::deserializeMap(uint8_t n) {
-  char fileName[32];
-  strcpy_P(fileName, PSTR("/ledmap"));
-  if (n) sprintf(fileName +7, "%d", n);
+  char fileName[36], binName[36];
+  strcpy_P(fileName, PSTR("/sd/ledmap"));
+  if (n) sprintf(fileName +10, "%d", n);
+  strcpy(binName, fileName);
   strcat(fileName, ".json");
-  bool isFile = WLED_FS.exists(fileName);
+  strcat(binName, ".bin");
+  //a ledmap on the SD card takes precedence, the flash copy is used otherwise
+  if (!mediaFileExists(fileName) && !mediaFileExists(binName)) {
+    memmove(fileName, fileName +3, strlen(fileName) -2);
+    memmove(binName, binName +3, strlen(binName) -2);
+  }
+
+  File jf = openMediaFile(fileName);
+  File bf = openMediaFile(binName);
 
-  if (!isFile) {
+  if (!jf && !bf) {
     // erase custom mapping if selecting nonexistent ledmap.json (n==0)
-    if (!n && customMappingTable != nullptr) {
-      customMappingSize = 0;
-      delete[] customMappingTable;
-      customMappingTable = nullptr;
-    }
+    if (!n) clearCustomMapping();
     return;
   }
 
-  DynamicJsonDocument doc(JSON_BUFFER_SIZE);  // full sized buffer for larger maps
-  DEBUG_PRINT(F("Reading LED map from "));
-  DEBUG_PRINTLN(fileName);
-
-  if (!readObjectFromFile(fileName, nullptr, &doc)) return; //if file does not exist just exit
+  uint32_t srcSize = jf ? jf.size() : 0;
+  uint32_t srcTime = jf ? (uint32_t)jf.getLastWrite() : 0;
+  LedmapHeader h;
+  bool useBin = bf && bf.read((uint8_t*)&h, sizeof(h)) == sizeof(h)
+             && h.magic == LEDMAP_BIN_MAGIC && (h.version == LEDMAP_BIN_TABLE || h.version == LEDMAP_BIN_RUNS) && h.count <= MAX_LEDS
+             && (!jf || (h.srcSize == srcSize && h.srcTime == srcTime)); //stale if the JSON was edited
 
   // erase old custom ledmap
-  if (customMappingTable != nullptr) {
-    customMappingSize = 0;
-    delete[] customMappingTable;
-    customMappingTable = nullptr;
-  }
-
-  JsonArray map = doc[F("map")];
-  if (!map.isNull() && map.size()) {  // not an empty map
-    customMappingSize  = map.size();
-    customMappingTable = new uint16_t[customMappingSize];
-    for (uint16_t i=0; i<customMappingSize; i++) {
-      customMappingTable[i] = (uint16_t) map[i];
+  clearCustomMapping();
+
+  if (useBin) {
+    DEBUG_PRINT(F("Reading LED map from "));
+    DEBUG_PRINTLN(binName);
+    //ESP8266 and ESP32 are little endian, entries and runs are read in place
+    if (h.version == LEDMAP_BIN_RUNS) {
+      uint16_t runs = (bf.size() - sizeof(h)) / sizeof(MapRun);
+      if (runs) customMappingRuns = (MapRun*) allocLarge(runs * sizeof(MapRun));
+      if (customMappingRuns && bf.read((uint8_t*)customMappingRuns, runs * sizeof(MapRun)) == runs * sizeof(MapRun)) {
+        customMappingRunCount = runs;
+        customMappingSize = h.count;
+      } else clearCustomMapping();
+    } else if (h.count) {
+      customMappingTable = (uint16_t*) allocLarge(h.count * sizeof(uint16_t));
+      if (customMappingTable && bf.read((uint8_t*)customMappingTable, h.count *2) == h.count *2u) {
+        customMappingSize = h.count;
+      } else clearCustomMapping();
+    }
+    bf.close();
+    jf.close();
+    return;
+  }
+  if (bf) bf.close();
+  if (!jf) return; //unusable binary map without its source
+
+  DEBUG_PRINT(F("Converting LED map from "));
+  DEBUG_PRINTLN(fileName);
+  uint16_t count = parseLedmapJson(jf, nullptr, MAX_LEDS);
+  if (count) {
+    customMappingTable = (uint16_t*) allocLarge(count * sizeof(uint16_t));
+    if (customMappingTable) {
+      parseLedmapJson(jf, customMappingTable, count);
+      customMappingSize = count;
+      compressCustomMapping();
+    }
+  } else if (srcSize < JSON_BUFFER_SIZE) { //no plain map, small descriptions are read as a document
+    JsonArenaDoc doc(JSON_LOCK_LEDMAP);
+    jf.seek(0, SeekSet);
+    StaticJsonDocument<64> filter; //a description may come along with a name or other keys of the editor
+    filter[F("runs")] = true; filter[F("matrix")] = true;
+    if (doc && !deserializeJson(*doc, jf, DeserializationOption::Filter(filter))) {
+      JsonArray runs = (*doc)[F("runs")];
+      JsonObject matrix = (*doc)[F("matrix")];
+      if (!runs.isNull() && runs.size()) {
+        customMappingRuns = (MapRun*) allocLarge(runs.size() * sizeof(MapRun));
+        if (customMappingRuns) {
+          for (JsonArray run : runs) {
+            MapRun& r = customMappingRuns[customMappingRunCount];
+            r.start  = customMappingSize;
+            r.base   = run[0];
+            r.len    = run[1] | 1;
+            r.stride = run[2] | 1;
+            if (r.len > MAX_LEDS - customMappingSize) r.len = MAX_LEDS - customMappingSize;
+            customMappingSize += r.len;
+            if (++customMappingRunCount == runs.size() || customMappingSize >= MAX_LEDS) break;
+          }
+        }
+      } else if (!matrix.isNull()) {
+        buildMatrixMapping(matrix["w"] | 0, matrix["h"] | 0, matrix[F("serp")] | false, matrix[F("vert")] | false);
+      }
     }
   }
+  jf.close();
+
+  bf = openMediaFile(binName, "w");
+  if (!bf) return;
+  h.magic = LEDMAP_BIN_MAGIC;
+  h.version = customMappingRuns ? LEDMAP_BIN_RUNS : LEDMAP_BIN_TABLE;
+  h.count = customMappingSize;
+  h.srcSize = srcSize;
+  h.srcTime = srcTime;
+  bf.write((uint8_t*)&h, sizeof(h));
+  if (customMappingRuns)       bf.write((uint8_t*)customMappingRuns, customMappingRunCount * sizeof(MapRun));
+  else if (customMappingTable) bf.write((uint8_t*)customMappingTable, customMappingSize *2);
+  bf.close();
 }
 
 //gamma 2.8 lookup table used for color correction
@@ -1150,9 +2668,16 @@ uint8_t WS2812FX::gamma8(uint8_t b)
   return gammaT[b];
 }
 
+//the busses take over color gamma if enabled and all of them can, not for realtime data that is sent without it
+bool WS2812FX::updateOutputGamma()
+{
+  _outputGamma = busses.setOutputGamma(gammaCorrectCol && gammaCorrectOut && !(realtimeMode && arlsDisableGammaCorrection));
+  return _outputGamma;
+}
+
 uint32_t WS2812FX::gamma32(uint32_t color)
 {
-  if (!gammaCorrectCol) return color;
+  if (!gammaCorrectCol || _outputGamma) return color;
   uint8_t w = (color >> 24);
   uint8_t r = (color >> 16);
   uint8_t g = (color >>  8);
@@ -1164,4 +2689,126 @@ uint32_t WS2812FX::gamma32(uint32_t color)
   return ((w << 24) | (r << 16) | (g << 8) | (b));
 }
 
-WS2812FX* WS2812FX::instance = nullptr;
\ No newline at end of file
+WS2812FX* WS2812FX::instance = nullptr;
+
+bool SegmentArena::begin()
+{
+  uint32_t size = SegmentArena::blockSize(MAX_SEGMENT_DATA);
+  #if defined(ARDUINO_ARCH_ESP32) && defined(WLED_USE_PSRAM)
+  if (psramFound())
+    _mem = (uint8_t*) ps_malloc(size);
+  else
+  #endif
+    _mem = (uint8_t*) malloc(size);
+  if (!_mem) return false;
+  _size = size;
+  _free = (FreeBlock*)_mem;
+  _free->size = size;
+  _free->next = nullptr;
+  return true;
+}
+
+void* SegmentArena::alloc(uint32_t len, uint32_t limit)
+{
+  if (!len) return nullptr;
+  len = blockSize(len);
+  if (_used + len > limit || (!_mem && !begin())) {
+    _fails++;
+    return nullptr;
+  }
+  FreeBlock** link = &_free;
+  for (FreeBlock* b = _free; b; link = &b->next, b = b->next) {
+    if (b->size < len) continue;
+    uint8_t* p;
+    if (b->size == len) { //exact fit
+      *link = b->next;
+      p = (uint8_t*)b;
+    } else { //take the end of the block, the rest stays in the list
+      b->size -= len;
+      p = (uint8_t*)b + b->size;
+    }
+    _used += len;
+    if (_used > _peak) _peak = _used;
+    return p;
+  }
+  _fails++; //fragmented
+  return nullptr;
+}
+
+void SegmentArena::release(void* p, uint32_t len)
+{
+  if (!p || !_mem) return;
+  len = blockSize(len);
+  FreeBlock* blk = (FreeBlock*)p;
+  FreeBlock* prev = nullptr;
+  FreeBlock* next = _free;
+  while (next && next < blk) { prev = next; next = next->next; }
+  blk->size = len;
+  blk->next = next;
+  if (next && (uint8_t*)blk + blk->size == (uint8_t*)next) { //merge with the following block
+    blk->size += next->size;
+    blk->next = next->next;
+  }
+  if (prev && (uint8_t*)prev + prev->size == (uint8_t*)blk) { //merge into the preceding block
+    prev->size += blk->size;
+    prev->next = blk->next;
+  } else if (prev) {
+    prev->next = blk;
+  } else {
+    _free = blk;
+  }
+  _used -= len;
+}
+
+uint32_t SegmentArena::largestFree()
+{
+  if (!_mem) return blockSize(MAX_SEGMENT_DATA);
+  uint32_t largest = 0;
+  for (FreeBlock* b = _free; b; b = b->next) if (b->size > largest) largest = b->size;
+  return largest;
+}
+/*
+ * Audio analysis shared with the effects: the writer makes the sequence odd while it copies,
+ * a reader retries if the sequence was odd or changed during its copy.
+ * There are two writers, the microphone task and audio sync in loop(), so writers hold a lock.
+ */
+#define AUDIO_STALE_MS 500 //analysis older than this means the sound source stopped
+
+static AudioData audioShared;
+static volatile uint32_t audioSeq = 0;
+#ifdef ARDUINO_ARCH_ESP32
+static portMUX_TYPE audioMux = portMUX_INITIALIZER_UNLOCKED;
+#endif
+
+void publishAudio(const AudioData& data)
+{
+  #ifdef ARDUINO_ARCH_ESP32
+  portENTER_CRITICAL(&audioMux);
+  #endif
+  //a received analysis never replaces a recent local one, checked here so the local writer cannot slip in between
+  bool keepLocal = data.remote && audioSeq && !audioShared.remote && millis() - audioShared.time < AUDIO_STALE_MS;
+  if (!keepLocal) {
+    audioSeq++; //odd
+    __sync_synchronize();
+    memcpy((void*)&audioShared, &data, sizeof(AudioData));
+    __sync_synchronize();
+    audioSeq++;
+  }
+  #ifdef ARDUINO_ARCH_ESP32
+  portEXIT_CRITICAL(&audioMux);
+  #endif
+}
+
+bool getAudio(AudioData& data)
+{
+  for (uint8_t tries = 0; tries < 4; tries++) {
+    uint32_t seq = audioSeq;
+    if (!seq) return false; //nothing published yet
+    if (seq & 1) continue;
+    __sync_synchronize();
+    memcpy(&data, (const void*)&audioShared, sizeof(AudioData));
+    __sync_synchronize();
+    if (audioSeq == seq) return millis() - data.time < AUDIO_STALE_MS;
+  }
+  return false;
+}
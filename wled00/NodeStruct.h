@@ -5,30 +5,128 @@
 * NodeStruct from the ESP Easy project (https://github.com/letscontrolit/ESPEasy)
 \*********************************************************************************************/
 
-#include <map>
 #include <IPAddress.h>
 
 #define NODE_TYPE_ID_UNDEFINED        0
 #define NODE_TYPE_ID_ESP8266         82
 #define NODE_TYPE_ID_ESP32           32
 
+#define NODE_FLAG_VSTRIP_FOLLOWER   0x01 //takes a slice of the virtual strip of a leader
+
 /*********************************************************************************************\
 * NodeStruct
 \*********************************************************************************************/
 struct NodeStruct
 {
-  String    nodeName;
+  char      nodeName[33];
   IPAddress ip;
   uint8_t   unit;
   uint8_t   age;
   uint8_t   nodeType;
   uint32_t  build;
+  uint16_t  leds;     //LED count, 0 if not announced
+  uint8_t   flags;    //NODE_FLAG_*
+  bool      used;
 
-  NodeStruct() : age(0), nodeType(0), build(0)
+  NodeStruct() : unit(0), age(0), nodeType(0), build(0), leds(0), flags(0), used(false)
   {
+    nodeName[0] = 0;
     for (uint8_t i = 0; i < 4; ++i) { ip[i] = 0; }
   }
+
+  //copies a name field of up to 32 chars that is not necessarily terminated, without surrounding spaces
+  void setName(const char* name)
+  {
+    uint8_t start = 0, len = 0;
+    while (len < 32 && name[len]) len++;
+    while (start < len && isspace(name[start])) start++;
+    while (len > start && isspace(name[len-1])) len--;
+    memcpy(nodeName, name + start, len - start);
+    nodeName[len - start] = 0;
+  }
+};
+
+/*********************************************************************************************\
+* Fixed size table of nodes keyed by unit (last IP octet), open addressed with linear probing.
+* Nothing is allocated when nodes come and go. If it is full, the node not heard from the longest is replaced
+\*********************************************************************************************/
+class NodesMap
+{
+  private:
+    NodeStruct _slots[WLED_MAX_NODES];
+    uint16_t _count = 0;
+
+    static uint16_t home(uint8_t unit) { return unit % WLED_MAX_NODES; }
+
+    //backward shift deletion, keeps every probe sequence free of holes
+    void removeAt(uint16_t i)
+    {
+      _slots[i].used = false;
+      _count--;
+      uint16_t j = i;
+      for (;;) {
+        j = (j + 1) % WLED_MAX_NODES;
+        if (!_slots[j].used) return;
+        uint16_t h = home(_slots[j].unit);
+        bool stays = (i <= j) ? (i < h && h <= j) : (i < h || h <= j);
+        if (stays) continue;
+        _slots[i] = _slots[j];
+        _slots[j].used = false;
+        i = j;
+      }
+    }
+
+  public:
+    uint16_t size() const { return _count; }
+    uint16_t capacity() const { return WLED_MAX_NODES; }
+    NodeStruct& operator[](uint16_t i) { return _slots[i]; } //slot i, check used
+
+    NodeStruct* find(uint8_t unit)
+    {
+      uint16_t i = home(unit);
+      for (uint16_t n = 0; n < WLED_MAX_NODES && _slots[i].used; n++) {
+        if (_slots[i].unit == unit) return &_slots[i];
+        i = (i + 1) % WLED_MAX_NODES;
+      }
+      return nullptr;
+    }
+
+    //returns the node of unit, a new one if it is not in the table yet
+    NodeStruct* insert(uint8_t unit)
+    {
+      NodeStruct* node = find(unit);
+      if (node) return node;
+      if (_count >= WLED_MAX_NODES) { //evict the stalest node
+        uint16_t oldest = 0;
+        for (uint16_t i = 1; i < WLED_MAX_NODES; i++) if (_slots[i].age > _slots[oldest].age) oldest = i;
+        removeAt(oldest);
+      }
+      uint16_t i = home(unit);
+      while (_slots[i].used) i = (i + 1) % WLED_MAX_NODES;
+      _slots[i] = NodeStruct();
+      _slots[i].unit = unit;
+      _slots[i].used = true;
+      _count++;
+      return &_slots[i];
+    }
+
+    //ages all nodes by one refresh period and drops those older than maxAge
+    void age(uint8_t maxAge)
+    {
+      for (uint16_t i = 0; i < WLED_MAX_NODES; i++) {
+        if (_slots[i].used && _slots[i].age < 255) _slots[i].age++;
+      }
+      for (uint16_t i = 0; i < WLED_MAX_NODES; i++) {
+        //a node shifted into slot i may be stale as well
+        while (_slots[i].used && (_slots[i].age > maxAge || _slots[i].ip[0] == 0)) removeAt(i);
+      }
+    }
+
+    void clear()
+    {
+      for (uint16_t i = 0; i < WLED_MAX_NODES; i++) _slots[i].used = false;
+      _count = 0;
+    }
 };
-typedef std::map<uint8_t, NodeStruct> NodesMap;
 
 #endif // WLED_NODESTRUCT_H
@@ -9,6 +9,9 @@
 #include "pin_manager.h"
 #include "bus_wrapper.h"
 #include <Arduino.h>
+#if defined(ARDUINO_ARCH_ESP32) && !defined(WLED_DISABLE_PWM_HW_FADE)
+#include "driver/ledc.h"
+#endif
 
 // enable additional debug output
 #ifdef WLED_DEBUG
@@ -24,6 +27,19 @@
   #define DEBUG_PRINTF(x...)
 #endif
 
+//network busses resend unchanged frames at this interval (ms)
+#define BUS_NETWORK_KEEPALIVE 1000
+//packets all network busses together send per loop pass, in turns (see BusManager::handleNetworkSend())
+#ifndef BUS_NETWORK_PACKETS_PER_PASS
+  #define BUS_NETWORK_PACKETS_PER_PASS 4
+#endif
+//running power sums are recalculated from all pixels at this interval (ms) to get rid of drift
+#define BUS_POWER_RESYNC 5000
+//digital busses dither in time below this brightness, if enabled (see BusManager::setDithering())
+#ifndef BUS_DITHER_BRIGHTNESS
+  #define BUS_DITHER_BRIGHTNESS 64
+#endif
+
 #define GET_BIT(var,bit)    (((var)>>(bit))&0x01)
 #define SET_BIT(var,bit)    ((var)|=(uint16_t)(0x0001<<(bit)))
 #define UNSET_BIT(var,bit)  ((var)&=(~(uint16_t)(0x0001<<(bit))))
@@ -38,6 +54,13 @@ struct BusConfig {
   uint8_t skipAmount;
   bool refreshReq;
   uint8_t pins[5] = {LEDPIN, 255, 255, 255, 255};
+  uint16_t milliAmpsMax = 0;   //own current budget of this output (0 = shares the global ABL budget)
+  uint8_t milliAmpsPerLed = 0; //power model of this output (0 = global setting, 255 = WS2815)
+  //color correction of this output, rows (output) x columns (input) in B,G,R,W order, 256 = 1.0
+  int16_t matrix[16] = {256, 0, 0, 0,  0, 256, 0, 0,  0, 0, 256, 0,  0, 0, 0, 256};
+  bool rgbw = false;   //network busses: send 4 channels per pixel
+  uint8_t maxFps = 0;  //frames per second shown at most (0 = every frame)
+  uint8_t priority = 0; //busses with a higher priority are shown first
   BusConfig(uint8_t busType, uint8_t* ppins, uint16_t pstart, uint16_t len = 1, uint8_t pcolorOrder = COL_ORDER_GRB, bool rev = false, uint8_t skip = 0) {
     refreshReq = (bool) GET_BIT(busType,7);
     type = busType & 0x7F;  // bit 7 may be/is hacked to include refresh info (1=refresh in off state, 0=no refresh)
@@ -52,7 +75,8 @@ struct BusConfig {
   //validates start and length and extends total if needed
   bool adjustBounds(uint16_t& total) {
     if (!count) count = 1;
-    if (count > MAX_LEDS_PER_BUS) count = MAX_LEDS_PER_BUS;
+    uint16_t maxCount = (type >= TYPE_NET_DDP_RGB && type < 96) ? MAX_LEDS_PER_NETWORK_BUS : MAX_LEDS_PER_BUS;
+    if (count > maxCount) count = maxCount;
     if (start >= MAX_LEDS) return false;
     //limit length of strip if it would exceed total permissible LEDs
     if (start + count > MAX_LEDS) count = MAX_LEDS - start;
@@ -72,19 +96,58 @@ class Bus {
   
   virtual void show() {}
   virtual bool canShow() { return true; }
+  //show() holds the CPU until the whole frame is sent
+  virtual bool isBlocking() { return false; }
+  //sends the next packet of a frame queued by show(), false if there is none
+  virtual bool sendNext() { return false; }
 
   virtual void setPixelColor(uint16_t pix, uint32_t c) {};
 
+  //sets len consecutive pixels starting at pix. Busses should override this if they can do better than one call per pixel
+  virtual void setPixelSpan(uint16_t pix, const uint32_t* colors, uint16_t len) {
+    for (uint16_t i = 0; i < len; i++) setPixelColor(pix + i, colors[i]);
+  }
+
   virtual void setBrightness(uint8_t b) {};
 
+  //gain of each channel (B,G,R,W), 255 is neutral
+  virtual void setWhiteBalance(const uint8_t* wb) {};
+
+  //cold white share (0-255) for each cctIndex(), see BusManager::setWhitePoints()
+  virtual void setCctLut(const uint8_t* lut) {};
+
+  //color temperature of a color from its red to blue ratio: 0 warmest (no blue), 128 for r == b, 255 coldest (no red)
+  static inline uint8_t cctIndex(uint32_t r, uint32_t b) {
+    if (!r && !b) return 128;
+    if (r >= b) return (b * 128) / r;
+    return 255 - (r * 127) / b;
+  }
+
+  //spreads the fraction lost by brightness scaling over consecutive frames
+  virtual void setDithering(bool enable) {};
+  virtual bool isDithering() { return false; }
+
+  //lut (8 to 16 bit, see BusManager::setOutputGamma()) is applied to the colors on output instead of before they are written.
+  //false if the bus can't
+  virtual bool setOutputGamma(const uint16_t* lut) { return !lut; }
+
+  //see BusConfig::matrix, false if the bus does not correct colors
+  virtual bool getColorMatrix(int16_t* m) { return false; }
+
+  //the next show() ramps to the new output within ms instead of switching, if the hardware can do that on its own
+  virtual bool setFadeTime(uint16_t ms) { return false; }
+
   virtual uint32_t getPixelColor(uint16_t pix) { return 0; };
 
   virtual void cleanup() {};
 
   virtual ~Bus() { //throw the bus under the bus
+    free(powerCache);
   }
 
   virtual uint8_t getPins(uint8_t* pinArray) { return 0; }
+  //PolyBus driver index (I_XX_XXX_X), I_NONE if not a digital bus
+  virtual uint8_t getDriver() { return I_NONE; }
 
   inline uint16_t getStart() {
     return _start;
@@ -108,6 +171,19 @@ class Bus {
     return false;
   }
 
+  inline uint8_t getMaxFps() {
+    return _maxFps;
+  }
+
+  inline void setMaxFps(uint8_t fps) {
+    _maxFps = fps;
+  }
+
+  //false while the max. frame rate holds the next frame back, the bus stays dirty until BusManager shows it
+  virtual bool isShowDue(unsigned long now) {
+    return !_maxFps || now - lastShow >= 1000u / _maxFps;
+  }
+
   virtual uint8_t skippedLeds() {
     return 0;
   }
@@ -130,14 +206,37 @@ class Bus {
     return _needsRefresh;
   }
 
+  //pixels or brightness changed since the last show()
+  virtual bool isDirty() {
+    return _dirty;
+  }
+
+  inline void setDirty(bool dirty = true) {
+    _dirty = dirty;
+  }
+
   bool reversed = false;
+  uint32_t powerSum = 0;  //sum of the channel values of all pixels, see BusManager::setPowerTracking()
+  uint8_t* powerCache = nullptr; //channel value sum / 4 of each pixel while power is tracked
+  uint16_t milliamps = 0; //last current estimate of this bus
+  uint32_t showMicros = 0; //average time show() took to return
+  unsigned long lastShow = 0;
+  uint8_t priority = 0;    //see BusConfig
+  uint16_t milliAmpsMax = 0;   //see BusConfig
+  uint8_t milliAmpsPerLed = 0;
+
+  inline uint8_t getBrightness() {
+    return _bri;
+  }
 
   protected:
   uint8_t _type = TYPE_NONE;
   uint8_t _bri = 255;
+  uint8_t _maxFps = 0;
   uint16_t _start = 0;
   bool _valid = false;
   bool _needsRefresh = false;
+  bool _dirty = true;
 };
 
 
@@ -159,20 +258,41 @@ class BusDigital : public Bus {
     _len = bc.count + _skip;
     _iType = PolyBus::getI(bc.type, _pins, nr);
     if (_iType == I_NONE) return;
+    _hd = (_iType == I_HS_DOT_4 || _iType == I_SS_DOT_4);
     _busPtr = PolyBus::create(_iType, _pins, _len, nr);
     _valid = (_busPtr != nullptr);
     _colorOrder = bc.colorOrder;
+    setColorMatrix(bc.matrix);
+    buildLut();
+    updateSource();
     DEBUG_PRINTF("Successfully inited strip %u (len %u) with type %u and pins %u,%u (itype %u)\n",nr, _len, bc.type, _pins[0],_pins[1],_iType);
   };
 
-  inline void show() {
+  void show() {
+    if (_deferred) {
+      if (_dithering) _ditherPhase++;
+      for (uint16_t p = 0; p < _len; p++) PolyBus::setPixelColor(_busPtr, _iType, p, applyOutput(applyMatrix(_src[p]), p), _colorOrder);
+    }
     PolyBus::show(_busPtr, _iType);
   }
 
+  //every frame differs while dithering
+  bool isDirty() {
+    return _dirty || _dithering;
+  }
+
   inline bool canShow() {
     return PolyBus::canShow(_busPtr, _iType);
   }
 
+  inline bool isBlocking() {
+    return PolyBus::isBlocking(_iType);
+  }
+
+  inline uint8_t getDriver() {
+    return _iType;
+  }
+
   void setBrightness(uint8_t b) {
     //Fix for turning off onboard LED breaking bus
     #ifdef LED_BUILTIN
@@ -180,20 +300,86 @@ class BusDigital : public Bus {
       if (_pins[0] == LED_BUILTIN || _pins[1] == LED_BUILTIN) PolyBus::begin(_busPtr, _iType, _pins); 
     }
     #endif
+    if (b == _bri) return;
+    uint32_t restore[4];
+    memcpy(restore, _restore, sizeof(_restore));
     _bri = b;
-    PolyBus::setBrightness(_busPtr, _iType, b);
+    buildLut();
+    rescale(restore);
+    updateSource();
+  }
+
+  void setWhiteBalance(const uint8_t* wb) {
+    if (!memcmp(wb, _wb, 4)) return;
+    uint32_t restore[4];
+    memcpy(restore, _restore, sizeof(_restore));
+    memcpy(_wb, wb, 4);
+    buildLut();
+    rescale(restore);
+  }
+
+  void setDithering(bool enable) {
+    _ditherEnabled = enable;
+    updateSource();
+  }
+
+  inline bool isDithering() {
+    return _dithering;
+  }
+
+  bool setOutputGamma(const uint16_t* lut) {
+    if (lut == _gamma16) return true;
+    _gamma16 = lut;
+    updateSource();
+    if (lut && !_deferred) { //no memory for the written colors
+      _gamma16 = nullptr;
+      updateSource();
+      return false;
+    }
+    _dirty = true;
+    return true;
+  }
+
+  //m is filled with the color correction of this bus, returns false if it is the identity
+  bool getColorMatrix(int16_t* m) {
+    for (uint8_t i = 0; i < 16; i++) m[i] = _matrix ? _matrix[i] : ((i % 5) ? 0 : _gain[i / 5]);
+    for (uint8_t i = 0; i < 16; i++) {
+      if (m[i] != ((i % 5) ? 0 : 256)) return true;
+    }
+    return false;
   }
 
   void setPixelColor(uint16_t pix, uint32_t c) {
     if (reversed) pix = _len - pix -1;
     else pix += _skip;
-    PolyBus::setPixelColor(_busPtr, _iType, pix, c, _colorOrder);
+    if (_src) _src[pix] = c;
+    if (!_deferred) PolyBus::setPixelColor(_busPtr, _iType, pix, applyLut(applyMatrix(c)), _colorOrder); //otherwise written by show()
+  }
+
+  void setPixelSpan(uint16_t pix, const uint32_t* colors, uint16_t len) {
+    if (_src) {
+      for (uint16_t i = 0; i < len; i++) _src[reversed ? _len - pix - i -1 : pix + _skip + i] = colors[i];
+      if (_deferred) return;
+    }
+    uint32_t out[32];
+    while (len) {
+      uint16_t n = (len > 32) ? 32 : len;
+      if (_matrix) {
+        for (uint16_t i = 0; i < n; i++) out[i] = applyLut(applyMatrix(colors[i]));
+      } else {
+        for (uint16_t i = 0; i < n; i++) out[i] = applyLut(colors[i]);
+      }
+      if (reversed) PolyBus::setPixelSpan(_busPtr, _iType, _len - pix -1, -1, out, n, _colorOrder);
+      else          PolyBus::setPixelSpan(_busPtr, _iType, pix + _skip,    1, out, n, _colorOrder);
+      pix += n; colors += n; len -= n;
+    }
   }
 
   uint32_t getPixelColor(uint16_t pix) {
     if (reversed) pix = _len - pix -1;
     else pix += _skip;
-    return PolyBus::getPixelColor(_busPtr, _iType, pix, _colorOrder);
+    if (_src) return _src[pix];
+    return restoreColor(readPixel(pix), _restore);
   }
 
   inline uint8_t getColorOrder() {
@@ -239,9 +425,198 @@ class BusDigital : public Bus {
 
   ~BusDigital() {
     cleanup();
+    if (_lut != _lutMono) free(_lut);
+    free(_src);
+    free(_matrix);
   }
 
   private: 
+  /*
+   * Brightness, white balance and the gains of a diagonal color matrix are applied through an output table
+   * per channel when pixels are written, so the pixel buffer holds what is sent. Without any of them all channels share one table.
+   */
+  uint8_t _lutMono[256];
+  uint8_t* _lut = _lutMono;
+  uint16_t _lutStride = 0;    //distance between the B,G,R,W tables, 0 if shared
+  uint32_t _restore[4];       //16.16 factor from output back to the written value, per channel
+  uint8_t _wb[4] = {255, 255, 255, 255};
+  uint16_t _scale[4];         //output per 256 of the written value, per channel
+  uint16_t _gain[4] = {256, 256, 256, 256}; //diagonal of the color matrix, 256 = 1.0
+  int16_t* _matrix = nullptr; //full color matrix (B,G,R,W rows x columns), only if it mixes channels
+
+  /*
+   * Below BUS_DITHER_BRIGHTNESS the written colors are kept unscaled and show() rounds each channel up or down
+   * against a threshold that rotates every frame, so the average over 16 frames keeps the fraction the table drops.
+   * A mixing color matrix cannot be undone on readback, so the written colors are kept with it as well.
+   * With output gamma (_gamma16) show() also computes the output from them, brightness is applied to the 16 bit value.
+   */
+  uint32_t* _src = nullptr;
+  const uint16_t* _gamma16 = nullptr;
+  bool _ditherEnabled = false;
+  bool _dithering = false;
+  bool _deferred = false;     //the output is written by show() from _src
+  bool _hd = false;           //APA102 with the 5-bit brightness field
+  uint8_t _ditherPhase = 0;
+
+  //a diagonal matrix only scales the channels and is folded into the output tables
+  void setColorMatrix(const int16_t* m) {
+    bool mixing = false;
+    for (uint8_t i = 0; i < 16; i++) {
+      if ((i % 5) && m[i]) mixing = true;
+    }
+    if (!mixing) {
+      for (uint8_t c = 0; c < 4; c++) _gain[c] = constrain((int)m[c * 5], 0, 1024);
+      return;
+    }
+    _matrix = (int16_t*) malloc(16 * sizeof(int16_t));
+    if (!_matrix) return; //no color correction without memory for it
+    memcpy(_matrix, m, 16 * sizeof(int16_t));
+  }
+
+  inline uint32_t applyMatrix(uint32_t c) {
+    if (!_matrix) return c;
+    int32_t in[4] = {(int32_t)(c & 0xFF), (int32_t)((c >> 8) & 0xFF), (int32_t)((c >> 16) & 0xFF), (int32_t)(c >> 24)};
+    const int16_t* m = _matrix;
+    uint32_t out = 0;
+    for (uint8_t i = 0; i < 4; i++, m += 4) {
+      int32_t v = (m[0] * in[0] + m[1] * in[1] + m[2] * in[2] + m[3] * in[3] + 128) >> 8;
+      out |= (uint32_t)((v < 0) ? 0 : (v > 255) ? 255 : v) << (i*8);
+    }
+    return out;
+  }
+
+  void buildLut() {
+    uint16_t gain[4];
+    bool split = false;
+    for (uint8_t c = 0; c < 4; c++) {
+      gain[c] = ((_wb[c] +1) * _gain[c]) >> 8; //0-1024, 256 is neutral
+      if (gain[c] != 256) split = true;
+    }
+    if (split && _lut == _lutMono) {
+      uint8_t* lut = (uint8_t*) malloc(1024);
+      if (lut) _lut = lut; //white balance is ignored if there is no memory for it
+    } else if (!split && _lut != _lutMono) {
+      free(_lut);
+      _lut = _lutMono;
+    }
+    _lutStride = (_lut == _lutMono) ? 0 : 256;
+    for (uint8_t c = 0; c < 4; c++) {
+      uint16_t scale = ((_bri +1) * (_lutStride ? gain[c] : 256)) >> 8; //0-1024
+      _restore[c] = scale ? 0x1000000UL / scale : 0;
+      _scale[c] = scale;
+      if (c && !_lutStride) continue;
+      uint8_t* lut = _lut + c * _lutStride;
+      for (uint16_t i = 0; i < 256; i++) {
+        uint32_t v = (i * scale) >> 8;
+        lut[i] = (v > 255) ? 255 : v;
+      }
+    }
+  }
+
+  inline uint32_t applyLut(uint32_t c) {
+    if (_hd) return applyHd(c);
+    const uint8_t* lut = _lut;
+    uint32_t out = lut[c & 0xFF];                     lut += _lutStride;
+    out |= (uint32_t)lut[(c >>  8) & 0xFF] <<  8;     lut += _lutStride;
+    out |= (uint32_t)lut[(c >> 16) & 0xFF] << 16;     lut += _lutStride;
+    return out | ((uint32_t)lut[c >> 24] << 24);
+  }
+
+  /*
+   * APA102 HD: instead of scaling the 8-bit PWM value down, the 5-bit brightness field of each pixel is set
+   * as low as its brightest channel allows and the PWM values are scaled up to match, so dim colors keep their resolution.
+   * The field goes out in the W byte.
+   */
+  inline uint32_t applyHd(uint32_t c) {
+    uint32_t t[3], m = 0;
+    for (uint8_t i = 0; i < 3; i++) {
+      t[i] = output16(c, i); //output in 1/256
+      if (t[i] > 65280) t[i] = 65280;
+      if (t[i] > m) m = t[i];
+    }
+    if (!m) return 0;
+    uint32_t l = (m * 31 + 65279) / 65280; //1-31
+    uint32_t out = l << 24;
+    for (uint8_t i = 0; i < 3; i++) {
+      uint32_t v = (t[i] * 31 / l + 128) >> 8;
+      out |= ((v > 255) ? 255 : v) << (i*8);
+    }
+    return out;
+  }
+
+  //color as sent, with the 5-bit field of APA102 HD folded into the channels
+  uint32_t readPixel(uint16_t p) {
+    uint32_t c = PolyBus::getPixelColor(_busPtr, _iType, p, _colorOrder);
+    if (!_hd) return c;
+    uint32_t l = c >> 24, out = 0;
+    for (uint8_t i = 0; i < 3; i++) out |= ((((c >> (i*8)) & 0xFF) * l + 15) / 31) << (i*8);
+    return out;
+  }
+
+  //channel i of c after gamma (if at output) and brightness, in 1/256 of the output
+  inline uint32_t output16(uint32_t c, uint8_t i) {
+    uint32_t v = (c >> (i*8)) & 0xFF;
+    return _gamma16 ? (_gamma16[v] * _scale[i]) >> 8 : v * _scale[i];
+  }
+
+  //output written by show(). While dithering, the threshold rotates per frame and neighbours are out of step
+  //so the strip does not flicker as a whole, otherwise the 16 bit value is rounded
+  inline uint32_t applyOutput(uint32_t c, uint16_t p) {
+    static const uint8_t order[16] = {0, 8, 4, 12, 2, 10, 6, 14, 1, 9, 5, 13, 3, 11, 7, 15};
+    if (_hd) return applyHd(c);
+    uint32_t t = _dithering ? (order[(_ditherPhase + p * 7) & 0x0F] << 4) + 8 : 128;
+    uint32_t out = 0;
+    for (uint8_t i = 0; i < 4; i++) {
+      uint32_t v = (output16(c, i) + t) >> 8;
+      out |= ((v > 255) ? 255 : v) << (i*8);
+    }
+    return out;
+  }
+
+  //keeps the written colors while they are needed and switches dithering on or off
+  void updateSource() {
+    bool dither = _ditherEnabled && _valid && !_hd && _bri && _bri < BUS_DITHER_BRIGHTNESS; //the 5-bit field already keeps the depth
+    bool defer = _valid && (dither || _gamma16);
+    bool keep = _valid && (defer || _matrix);
+    if (keep && !_src) {
+      _src = (uint32_t*) malloc(_len * sizeof(uint32_t));
+      if (!_src) { //no dithering without memory for it, and the matrix is reapplied on readback
+        _dithering = false;
+        _deferred = false;
+        return;
+      }
+      for (uint16_t p = 0; p < _len; p++) _src[p] = restoreColor(readPixel(p), _restore);
+    }
+    if (_src && _deferred && !defer) {
+      //bring the buffer back to the output of the tables
+      for (uint16_t p = 0; p < _len; p++) PolyBus::setPixelColor(_busPtr, _iType, p, applyLut(applyMatrix(_src[p])), _colorOrder);
+    }
+    _deferred = defer && _src;
+    _dithering = dither && _src;
+    if (!keep && _src) {
+      free(_src);
+      _src = nullptr;
+    }
+  }
+
+  static uint32_t restoreColor(uint32_t c, const uint32_t* restore) {
+    uint32_t out = 0;
+    for (uint8_t i = 0; i < 4; i++) {
+      uint32_t v = (((c >> (i*8)) & 0xFF) * restore[i] + 0x8000) >> 16;
+      out |= ((v > 255) ? 255 : v) << (i*8);
+    }
+    return out;
+  }
+
+  //pixels written with the previous tables are brought to the current ones
+  void rescale(const uint32_t* restore) {
+    if (!_valid || _deferred) return; //show() redoes the output from the written colors
+    for (uint16_t p = 0; p < _len; p++) {
+      uint32_t c = _src ? applyMatrix(_src[p]) : restoreColor(readPixel(p), restore);
+      PolyBus::setPixelColor(_busPtr, _iType, p, applyLut(c), _colorOrder);
+    }
+  }
+
   uint8_t _colorOrder = COL_ORDER_GRB;
   uint8_t _pins[2] = {255, 255};
   uint8_t _iType = I_NONE;
@@ -259,13 +634,18 @@ class BusPwm : public Bus {
     uint8_t numPins = NUM_PWM_PINS(bc.type);
 
     #ifdef ESP8266
-    analogWriteRange(255);  //same range as one RGB channel
+    analogWriteRange(WLED_PWM_MAX_DUTY);
     analogWriteFreq(WLED_PWM_FREQ);
     #else
     _ledcStart = pinManager.allocateLedc(numPins);
     if (_ledcStart == 255) { //no more free LEDC channels
       deallocatePins(); return;
     }
+    #ifndef WLED_DISABLE_PWM_HW_FADE
+    static bool fadeInstalled = false;
+    if (!fadeInstalled) fadeInstalled = (ledc_fade_func_install(0) == ESP_OK);
+    _canFade = fadeInstalled;
+    #endif
     #endif
 
     for (uint8_t i = 0; i < numPins; i++) {
@@ -277,7 +657,7 @@ class BusPwm : public Bus {
       #ifdef ESP8266
       pinMode(_pins[i], OUTPUT);
       #else
-      ledcSetup(_ledcStart + i, WLED_PWM_FREQ, 8);
+      ledcSetup(_ledcStart + i, WLED_PWM_FREQ, WLED_PWM_RESOLUTION);
       ledcAttachPin(_pins[i], _ledcStart + i);
       #endif
     }
@@ -291,45 +671,98 @@ class BusPwm : public Bus {
     uint8_t g = c >>  8;
     uint8_t b = c      ;
     uint8_t w = c >> 24;
+    _color = c;
 
     switch (_type) {
       case TYPE_ANALOG_1CH: //one channel (white), use highest RGBW value
         _data[0] = max(r, max(g, max(b, w))); break;
-      
-      case TYPE_ANALOG_2CH: //warm white + cold white, we'll need some nice handling here, for now just R+G channels
+
+      case TYPE_ANALOG_2CH: { //warm white + cold white, mixed to the color temperature of the color
+        uint16_t level = max(r, max(g, b)) + w;
+        mixWhite(level > 255 ? 255 : level, r + w, b + w, _data[0], _data[1]);
+        break; }
+
       case TYPE_ANALOG_3CH: //standard dumb RGB
       case TYPE_ANALOG_4CH: //RGBW
-      case TYPE_ANALOG_5CH: //we'll want the white handling from 2CH here + RGB
         _data[0] = r; _data[1] = g; _data[2] = b; _data[3] = w; _data[4] = 0; break;
 
+      case TYPE_ANALOG_5CH: //RGB + the white channel mixed from warm and cold white as for 2CH
+        _data[0] = r; _data[1] = g; _data[2] = b;
+        mixWhite(w, r + w, b + w, _data[3], _data[4]);
+        break;
+
       default: return;
     }
   }
 
+  void setCctLut(const uint8_t* lut) {
+    if (lut != _cctLut) _dirty = true;
+    _cctLut = lut;
+  }
+
+  void setPixelSpan(uint16_t pix, const uint32_t* colors, uint16_t len) {
+    if (pix == 0 && len) setPixelColor(0, colors[0]); //only first pixel is used
+  }
+
   //does no index check
   uint32_t getPixelColor(uint16_t pix) {
     if (!_valid) return 0;
-    return ((_data[3] << 24) | (_data[0] << 16) | (_data[1] << 8) | (_data[2]));
+    return _color;
   }
 
   void show() {
     if (!_valid) return;
     uint8_t numPins = NUM_PWM_PINS(_type);
     for (uint8_t i = 0; i < numPins; i++) {
-      uint8_t scaled = (_data[i] * _bri) / 255;
-      if (reversed) scaled = 255 - scaled;
+      //color x brightness as 0-65536 instead of dropping the low byte
+      uint32_t in = _gamma16 ? _gamma16[_data[i]] : _data[i] * 257UL;
+      uint32_t level = (in * (_bri * 257UL +1)) >> 16;
+      level += level >> 15;
+      //integer duty plus 16 bits of fraction, which is accumulated so that
+      //the average duty over a few frames matches the full precision
+      uint32_t scaled = level * WLED_PWM_MAX_DUTY;
+      uint32_t duty = scaled >> 16;
+      uint32_t dither = _dither[i] + (scaled & 0xFFFF);
+      if (dither > 0xFFFF) duty++;
+      _dither[i] = dither;
+      if (reversed) duty = WLED_PWM_MAX_DUTY - duty;
       #ifdef ESP8266
-      analogWrite(_pins[i], scaled);
+      analogWrite(_pins[i], duty);
       #else
-      ledcWrite(_ledcStart + i, scaled);
+      #ifndef WLED_DISABLE_PWM_HW_FADE
+      if (_fadeTime) { //Arduino channels 0-7 are in the first LEDC group, 8-15 in the second
+        ledc_mode_t group = (ledc_mode_t)((_ledcStart + i) >> 3);
+        ledc_channel_t channel = (ledc_channel_t)((_ledcStart + i) & 7);
+        ledc_set_fade_with_time(group, channel, duty, _fadeTime);
+        ledc_fade_start(group, channel, LEDC_FADE_NO_WAIT);
+        continue;
+      }
+      #endif
+      ledcWrite(_ledcStart + i, duty);
       #endif
     }
+    #if defined(ARDUINO_ARCH_ESP32) && !defined(WLED_DISABLE_PWM_HW_FADE)
+    _fadeTime = 0;
+    #endif
+  }
+
+  #if defined(ARDUINO_ARCH_ESP32) && !defined(WLED_DISABLE_PWM_HW_FADE)
+  bool setFadeTime(uint16_t ms) {
+    _fadeTime = _canFade ? ms : 0;
+    return _canFade;
   }
+  #endif
 
   inline void setBrightness(uint8_t b) {
     _bri = b;
   }
 
+  bool setOutputGamma(const uint16_t* lut) {
+    if (lut != _gamma16) _dirty = true;
+    _gamma16 = lut;
+    return true;
+  }
+
   uint8_t getPins(uint8_t* pinArray) {
     if (!_valid) return 0;
     uint8_t numPins = NUM_PWM_PINS(_type);
@@ -352,8 +785,24 @@ class BusPwm : public Bus {
   private: 
   uint8_t _pins[5] = {255, 255, 255, 255, 255};
   uint8_t _data[5] = {255, 255, 255, 255, 255};
+  uint32_t _color = 0xFFFFFFFF; //as written, the channels can't be turned back into it for CCT
+  uint16_t _dither[5] = {0}; //fractional duty carried to the next show()
+  const uint16_t* _gamma16 = nullptr;
+  const uint8_t* _cctLut = nullptr;
+
+  //splits white level between warm (ww) and cold white (cw) by the color temperature of r and b, the sum stays level
+  inline void mixWhite(uint8_t level, uint16_t r, uint16_t b, uint8_t &ww, uint8_t &cw) {
+    uint8_t t = cctIndex(r, b);
+    uint8_t share = _cctLut ? _cctLut[t] : t;
+    cw = (level * share + 127) / 255;
+    ww = level - cw;
+  }
   #ifdef ARDUINO_ARCH_ESP32
   uint8_t _ledcStart = 255;
+  #ifndef WLED_DISABLE_PWM_HW_FADE
+  bool _canFade = false;
+  uint16_t _fadeTime = 0; //ms, for the next show() only
+  #endif
   #endif
 
   void deallocatePins() {
@@ -392,16 +841,19 @@ class BusNetwork : public Bus {
 //          _UDPtype = 0;
 //          break;
 //        default:
-          _rgbw = false;
+          _rgbw = bc.rgbw && bc.type != TYPE_NET_VSTRIP; //followers are sent RGB
           _UDPtype = bc.type - TYPE_NET_DDP_RGB;
 //          break;
 //      }
       _UDPchannels = _rgbw ? 4 : 3;
       //_rgbw |= bc.rgbwOverride;  // RGBW override in bit 7 or can have a special type
-      _data = (byte *)malloc(bc.count * _UDPchannels);
+      _data = (byte *)allocLarge(bc.count * _UDPchannels); //only read when sending, PSRAM is fine
       if (_data == nullptr) return;
       memset(_data, 0, bc.count * _UDPchannels);
+      //frames are sent from a copy, so the effects can render the next one meanwhile. Without it show() sends at once
+      if (bc.type != TYPE_NET_VSTRIP) _sendData = (byte *)allocLarge(bc.count * _UDPchannels);
       _len = bc.count;
+      _maxFps = bc.maxFps;
       //_colorOrder = bc.colorOrder;
       _client = IPAddress(bc.pins[0],bc.pins[1],bc.pins[2],bc.pins[3]);
       _broadcastLock = false;
@@ -410,16 +862,29 @@ class BusNetwork : public Bus {
 
   void setPixelColor(uint16_t pix, uint32_t c) {
     if (!_valid || pix >= _len) return;
-    uint16_t offset = pix * _UDPchannels;
+    uint32_t offset = pix * _UDPchannels; //above 16 bits with large strips
     _data[offset]   = 0xFF & (c >> 16);
     _data[offset+1] = 0xFF & (c >>  8);
     _data[offset+2] = 0xFF & (c      );
     if (_rgbw) _data[offset+3] = 0xFF & (c >> 24);
   }
 
+  void setPixelSpan(uint16_t pix, const uint32_t* colors, uint16_t len) {
+    if (!_valid || pix >= _len) return;
+    if (pix + len > _len) len = _len - pix;
+    byte* d = _data + pix * _UDPchannels;
+    for (uint16_t i = 0; i < len; i++) {
+      uint32_t c = colors[i];
+      *d++ = c >> 16;
+      *d++ = c >>  8;
+      *d++ = c;
+      if (_rgbw) *d++ = c >> 24;
+    }
+  }
+
   uint32_t getPixelColor(uint16_t pix) {
     if (!_valid || pix >= _len) return 0;
-    uint16_t offset = pix * _UDPchannels;
+    uint32_t offset = pix * _UDPchannels;
     return (
       (_rgbw ? (_data[offset+3] << 24) : 0)
       | (_data[offset]   << 16)
@@ -428,11 +893,54 @@ class BusNetwork : public Bus {
     );
   }
 
+  //queues the frame, its packets go out from BusManager::handleNetworkSend() in turns with the other network busses.
+  //A frame shown while the previous one is still being sent, or earlier than the max. frame rate allows, is sent after it
   void show() {
     if (!_valid || !canShow()) return;
-    _broadcastLock = true;
-    realtimeBroadcast(_UDPtype, _client, _len, _data, _bri, _rgbw);
-    _broadcastLock = false;
+    if (_sendPackets || (_maxFps && millis() - _lastSend < 1000 / _maxFps)) {
+      _deferred = true;
+      return;
+    }
+    _lastSend = millis();
+    _deferred = false;
+    if (!_sendData) {
+      _broadcastLock = true;
+      if (_type == TYPE_NET_VSTRIP) vstripShow(_data, _len, _bri, &_udp);
+      else realtimeBroadcast(_UDPtype, _client, _len, _data, _bri, _rgbw, &_udp, &_seq);
+      _broadcastLock = false;
+      return;
+    }
+    if (_gamma16) {
+      for (uint32_t i = 0; i < (uint32_t)_len * _UDPchannels; i++) {
+        uint32_t v = (_gamma16[_data[i]] + 128) >> 8;
+        _sendData[i] = (v > 255) ? 255 : v;
+      }
+    } else memcpy(_sendData, _data, _len * _UDPchannels);
+    _sendBri = _bri;
+    _sendPacket = 0;
+    _sendPackets = realtimePacketCount(_UDPtype, _len, _rgbw);
+  }
+
+  bool sendNext() {
+    if (!_sendPackets) {
+      if (!_deferred) return false;
+      show();
+      if (!_sendPackets) return false;
+    }
+    //a failed packet is dropped, the receiver gets the rest of the frame
+    realtimeSendPacket(_UDPtype, _client, _len, _sendData, _sendBri, _rgbw, &_udp, _sendPacket, _seq);
+    if (++_sendPacket >= _sendPackets) _sendPackets = 0;
+    return true;
+  }
+
+  //show() defers a frame that comes too early itself, so it can queue the latest one
+  bool isShowDue(unsigned long now) {
+    return true;
+  }
+
+  //unchanged frames are still resent periodically so receivers do not time out of realtime mode
+  bool isDirty() {
+    return _dirty || millis() - _lastSend > BUS_NETWORK_KEEPALIVE;
   }
 
   inline bool canShow() {
@@ -444,6 +952,14 @@ class BusNetwork : public Bus {
     _bri = b;
   }
 
+  //applied to the copy that is sent, so not without one (virtual strips)
+  bool setOutputGamma(const uint16_t* lut) {
+    if (lut && !_sendData) return false;
+    if (lut != _gamma16) _dirty = true;
+    _gamma16 = lut;
+    return true;
+  }
+
   uint8_t getPins(uint8_t* pinArray) {
     for (uint8_t i = 0; i < 4; i++) {
       pinArray[i] = _client[i];
@@ -462,8 +978,13 @@ class BusNetwork : public Bus {
   void cleanup() {
     _type = I_NONE;
     _valid = false;
+    _sendPackets = 0;
+    _deferred = false;
     if (_data != nullptr) free(_data);
     _data = nullptr;
+    if (_sendData != nullptr) free(_sendData);
+    _sendData = nullptr;
+    _udp.stop();
   }
 
   ~BusNetwork() {
@@ -472,14 +993,22 @@ class BusNetwork : public Bus {
 
   private:
     IPAddress _client;
+    WiFiUDP   _udp; //kept open across frames
     uint16_t  _len = 0;
     //uint8_t   _colorOrder;
-    uint8_t   _bri = 255;
     uint8_t   _UDPtype;
     uint8_t   _UDPchannels;
     bool      _rgbw;
     bool      _broadcastLock;
     byte     *_data;
+    byte     *_sendData = nullptr; //frame being sent
+    const uint16_t* _gamma16 = nullptr;
+    uint8_t   _sendBri = 255;
+    uint16_t  _sendPacket = 0;     //next packet of the frame
+    uint16_t  _sendPackets = 0;    //packets of the frame, 0 if none is being sent
+    bool      _deferred = false;   //a newer frame waits for the current one
+    uint8_t   _seq = 0;            //sequence number of this target
+    unsigned long _lastSend = 0;   //start of the last frame
 };
 
 
@@ -508,21 +1037,92 @@ class BusManager {
     }
     if (type > 31 && type < 48)   return 5;
     if (type == 44 || type == 45) return len*4; //RGBW
+    if (type == TYPE_APA102_HD) return len*4;   //brightness byte
     return len*3; //RGB
   }
   
   int add(BusConfig &bc) {
     if (numBusses >= WLED_MAX_BUSSES) return -1;
-    if (bc.type >= TYPE_NET_DDP_RGB && bc.type < 96) {
-      busses[numBusses] = new BusNetwork(bc);
-    } else if (IS_DIGITAL(bc.type)) {
-      busses[numBusses] = new BusDigital(bc, numBusses);
-    } else {
-      busses[numBusses] = new BusPwm(bc);
+    busses[numBusses] = create(bc, numBusses);
+    //the cached lookup in setPixelColor() can only be used if every pixel belongs to a single bus
+    uint16_t start = busses[numBusses]->getStart(), end = start + busses[numBusses]->getLength();
+    for (uint8_t i = 0; i < numBusses; i++) {
+      uint16_t bstart = busses[i]->getStart();
+      if (start < bstart + busses[i]->getLength() && bstart < end) overlapping = true;
     }
+    orderValid = false;
     return numBusses++;
   }
 
+  //true if the running bus b would be created the same from bc (current budgets aside, they are applied in place)
+  static bool matches(Bus* b, BusConfig &bc) {
+    if (!b->isOk() || b->getType() != bc.type || b->getStart() != bc.start) return false;
+    uint8_t pins[5];
+    uint8_t numPins = b->getPins(pins);
+    if (!numPins || memcmp(pins, bc.pins, numPins)) return false;
+    if (bc.type >= TYPE_NET_DDP_RGB && bc.type < 96) { //network bus, the "pins" are the IP
+      return b->getLength() == bc.count && b->isRgbw() == (bc.rgbw && bc.type != TYPE_NET_VSTRIP);
+    }
+    if (b->reversed != bc.reversed) return false;
+    if (!IS_DIGITAL(bc.type)) return true;
+    if (b->getLength() != bc.count || b->skippedLeds() != bc.skipAmount || b->getColorOrder() != bc.colorOrder) return false;
+    if (b->isOffRefreshRequired() != (bc.refreshReq || bc.type == TYPE_TM1814)) return false;
+    int16_t matrix[16];
+    b->getColorMatrix(matrix);
+    return !memcmp(matrix, bc.matrix, sizeof(matrix));
+  }
+
+  /*
+   * Re-init from new configs without tearing down every bus: a bus whose config did not change keeps running
+   * with its pixel data, the others are removed first (so their pins are free) and then recreated in their slot.
+   * Returns false if all busses were kept.
+   * do not call this method from system context (network callback)
+   */
+  bool reconfigure(BusConfig** configs, uint8_t count) {
+    if (count > WLED_MAX_BUSSES) count = WLED_MAX_BUSSES;
+    bool keep[WLED_MAX_BUSSES] = {false};
+    bool changed = count != numBusses;
+    for (uint8_t i = 0; i < numBusses; i++) {
+      keep[i] = i < count && matches(busses[i], *configs[i]);
+      if (!keep[i]) changed = true;
+    }
+    for (uint8_t i = 0; i < count && i < numBusses; i++) {
+      if (!keep[i]) continue;
+      busses[i]->milliAmpsMax = configs[i]->milliAmpsMax;
+      busses[i]->milliAmpsPerLed = configs[i]->milliAmpsPerLed;
+      busses[i]->setMaxFps(configs[i]->maxFps);
+      if (busses[i]->priority != configs[i]->priority) orderValid = false;
+      busses[i]->priority = configs[i]->priority;
+    }
+    if (!changed) return false;
+
+    DEBUG_PRINTLN(F("Reconfiguring busses."));
+    //prevents crashes due to deleting busses while in use.
+    while (!canAllShow()) yield();
+    for (uint8_t i = 0; i < numBusses; i++) {
+      if (keep[i]) continue;
+      delete busses[i];
+      busses[i] = nullptr;
+    }
+    for (uint8_t i = 0; i < count; i++) {
+      if (!keep[i]) busses[i] = create(*configs[i], i);
+    }
+    numBusses = count;
+    overlapping = false;
+    for (uint8_t i = 0; i < numBusses; i++) {
+      uint16_t start = busses[i]->getStart(), end = start + busses[i]->getLength();
+      for (uint8_t j = 0; j < i; j++) {
+        uint16_t bstart = busses[j]->getStart();
+        if (start < bstart + busses[j]->getLength() && bstart < end) overlapping = true;
+      }
+    }
+    powerTracking = false; //new busses are resynced on the next estimate
+    orderValid = false;
+    lastBus = nullptr;
+    lastStart = lastEnd = 0;
+    return true;
+  }
+
   //do not call this method from system context (network callback)
   void removeAll() {
     DEBUG_PRINTLN(F("Removing all."));
@@ -530,29 +1130,219 @@ class BusManager {
     while (!canAllShow()) yield();
     for (uint8_t i = 0; i < numBusses; i++) delete busses[i];
     numBusses = 0;
+    overlapping = false;
+    powerTracking = false; //new busses are resynced on the next estimate
+    gammaChecked = false;
+    outputGamma = false;
+    orderValid = false;
+    lastBus = nullptr;
+    lastStart = lastEnd = 0;
   }
 
-  void show() {
+  /*
+   * Only busses with changed content are sent, unless forced (LED types that need refreshing while off).
+   * Higher priority busses go first, within a priority the ones sending in the background (DMA, RMT, I2S)
+   * are started first, so they transmit while the blocking ones hold the CPU.
+   * A bus with a max. frame rate skips frames that come too early, handleNetworkSend() shows the last one when it is due.
+   */
+  void show(bool force = false) {
+    if (!orderValid) buildShowOrder();
+    unsigned long now = millis();
+    heldBack = false;
     for (uint8_t i = 0; i < numBusses; i++) {
-      busses[i]->show();
+      Bus* b = busses[showOrder[i]];
+      if (!force && !b->isDirty()) continue;
+      if (!b->isShowDue(now)) { heldBack = true; continue; }
+      showBus(b, now);
     }
+    handleNetworkSend(); //the first packets go out right away
+    #if defined(ARDUINO_ARCH_ESP32) && !defined(WLED_DISABLE_PWM_HW_FADE)
+    for (uint8_t i = 0; i < numBusses; i++) busses[i]->setFadeTime(0); //a fade only applies to the first frame after it was set
+    #endif
+  }
+
+  bool isDirty() {
+    for (uint8_t i = 0; i < numBusses; i++) {
+      if (busses[i]->isDirty()) return true;
+    }
+    return false;
+  }
+
+  //sends up to BUS_NETWORK_PACKETS_PER_PASS queued packets, one bus after the other, so large frames to several
+  //targets are interleaved and spread over the loop passes instead of holding the loop for all of them at once
+  void handleNetworkSend() {
+    if (heldBack) { //frames held back by a max. frame rate
+      unsigned long now = millis();
+      heldBack = false;
+      for (uint8_t i = 0; i < numBusses; i++) {
+        Bus* b = busses[showOrder[i]];
+        if (!b->isDirty()) continue;
+        if (b->isShowDue(now)) showBus(b, now);
+        else heldBack = true;
+      }
+    }
+    uint8_t budget = BUS_NETWORK_PACKETS_PER_PASS;
+    for (uint8_t idle = 0; budget && idle < numBusses; ) {
+      if (nextSend >= numBusses) nextSend = 0;
+      if (busses[nextSend++]->sendNext()) { budget--; idle = 0; }
+      else idle++;
+    }
+  }
+
+  //true if all busses will fade to their next output by themselves (ESP32 PWM), busses without it are left alone
+  bool setFadeTime(uint16_t ms) {
+    bool all = numBusses;
+    for (uint8_t i = 0; i < numBusses; i++) {
+      if (!busses[i]->setFadeTime(ms)) all = false;
+    }
+    return all;
   }
 
   void setPixelColor(uint16_t pix, uint32_t c) {
+    //consecutive calls almost always hit the same bus
+    if (lastBus && pix >= lastStart && pix < lastEnd) {
+      if (powerTracking) trackPower(lastBus, pix - lastStart, c);
+      lastBus->setPixelColor(pix - lastStart, c);
+      lastBus->setDirty();
+      return;
+    }
     for (uint8_t i = 0; i < numBusses; i++) {
       Bus* b = busses[i];
       uint16_t bstart = b->getStart();
-      if (pix < bstart || pix >= bstart + b->getLength()) continue;
-      busses[i]->setPixelColor(pix - bstart, c);
+      uint16_t bend = bstart + b->getLength();
+      if (pix < bstart || pix >= bend) continue;
+      if (powerTracking) trackPower(b, pix - bstart, c);
+      b->setPixelColor(pix - bstart, c);
+      b->setDirty();
+      if (!overlapping) {
+        lastBus = b; lastStart = bstart; lastEnd = bend;
+        return;
+      }
+    }
+  }
+
+  //sets len consecutive pixels starting at pix, split at bus boundaries
+  void setPixelSpan(uint16_t pix, const uint32_t* colors, uint16_t len) {
+    uint32_t end = pix + len;
+    for (uint8_t i = 0; i < numBusses; i++) {
+      Bus* b = busses[i];
+      uint16_t bstart = b->getStart();
+      uint32_t bend = bstart + b->getLength();
+      uint16_t from = (pix > bstart) ? pix : bstart;
+      uint32_t to   = (end < bend)   ? end : bend;
+      if (from >= to) continue;
+      if (powerTracking) {
+        for (uint32_t p = from; p < to; p++) trackPower(b, p - bstart, colors[p - pix]);
+      }
+      b->setPixelSpan(from - bstart, colors + (from - pix), to - from);
+      b->setDirty();
     }
   }
 
   void setBrightness(uint8_t b) {
+    for (uint8_t i = 0; i < numBusses; i++) setBrightness(i, b);
+  }
+
+  void setBrightness(uint8_t busNr, uint8_t b) {
+    if (busNr >= numBusses) return;
+    Bus* bus = busses[busNr];
+    if (b != bus->getBrightness()) bus->setDirty();
+    bus->setBrightness(b);
+  }
+
+  //B,G,R,W gains applied by the busses on output
+  void setWhiteBalance(const uint8_t* wb) {
+    if (!memcmp(wb, whiteBalance, 4)) return;
+    memcpy(whiteBalance, wb, 4);
     for (uint8_t i = 0; i < numBusses; i++) {
-      busses[i]->setBrightness(b);
+      busses[i]->setWhiteBalance(wb);
+      busses[i]->setDirty();
     }
   }
 
+  inline const uint8_t* getWhiteBalance() {
+    return whiteBalance;
+  }
+
+  /*
+   * Color temperatures (K) of the warm and cold white channels of CCT busses (2 and 5 channel PWM).
+   * The table from cctIndex() to the cold white share is built here once, mixed in mireds
+   * along the white spectrum of colorKtoRGB(), so the busses mix with a single lookup.
+   */
+  void setWhitePoints(uint16_t warmK, uint16_t coldK) {
+    if (warmK < 1000) warmK = 1000;
+    if (coldK < warmK + 100) coldK = warmK + 100;
+    if (cctBuilt && warmK == cctWarm && coldK == cctCold) return;
+    cctWarm = warmK; cctCold = coldK;
+    float mw = 1000000.0f / warmK, mc = 1000000.0f / coldK;
+    int16_t last = -1;
+    for (uint16_t k = 1000; k <= 40000 && last < 255; k += 50) {
+      byte rgb[4];
+      colorKtoRGB(k, rgb);
+      uint8_t t = cctIndex(rgb[0], rgb[2]);
+      if (t <= last) continue;
+      float share = (mw - 1000000.0f / k) / (mw - mc);
+      uint8_t v = share <= 0.0f ? 0 : (share >= 1.0f ? 255 : share * 255.0f + 0.5f);
+      while (last < t) cctLut[++last] = v; //indices in between get the value of the next temperature found
+    }
+    while (last < 255) cctLut[++last] = 255;
+    cctBuilt = true;
+    for (uint8_t i = 0; i < numBusses; i++) busses[i]->setCctLut(cctLut);
+  }
+
+  inline uint16_t getWhitePointWarm() {
+    return cctWarm;
+  }
+
+  inline uint16_t getWhitePointCold() {
+    return cctCold;
+  }
+
+  void setDithering(bool enable) {
+    dithering = enable;
+    for (uint8_t i = 0; i < numBusses; i++) busses[i]->setDithering(enable);
+  }
+
+  inline bool getDithering() {
+    return dithering;
+  }
+
+  /*
+   * Color gamma applied by the busses on output from an 8 to 16 bit table, instead of 8 to 8 bit before the colors are written.
+   * Digital busses round the 16 bit value after brightness (dithered if enabled), PWM uses it at its resolution.
+   * Only if all busses can, returns whether it is on.
+   */
+  bool setOutputGamma(bool enable) {
+    if (enable == gammaWanted && gammaChecked) return outputGamma;
+    gammaWanted = enable;
+    gammaChecked = true;
+    if (enable && !gammaLut16) {
+      gammaLut16 = (uint16_t*) malloc(256 * sizeof(uint16_t));
+      if (gammaLut16) for (uint16_t i = 0; i < 256; i++) gammaLut16[i] = powf(i / 255.0f, 2.8f) * 65535.0f + 0.5f;
+    }
+    const uint16_t* lut = enable ? gammaLut16 : nullptr;
+    bool ok = true;
+    for (uint8_t i = 0; i < numBusses; i++) ok &= busses[i]->setOutputGamma(lut);
+    if (lut && !ok) {
+      for (uint8_t i = 0; i < numBusses; i++) busses[i]->setOutputGamma(nullptr);
+      lut = nullptr;
+    }
+    outputGamma = lut != nullptr;
+    return outputGamma;
+  }
+
+  inline bool getOutputGamma() {
+    return outputGamma;
+  }
+
+  //a dithering bus needs a new frame sent regularly even if nothing changed
+  bool isDithering() {
+    for (uint8_t i = 0; i < numBusses; i++) {
+      if (busses[i]->isDithering()) return true;
+    }
+    return false;
+  }
+
   uint32_t getPixelColor(uint16_t pix) {
     for (uint8_t i = 0; i < numBusses; i++) {
       Bus* b = busses[i];
@@ -563,6 +1353,38 @@ class BusManager {
     return 0;
   }
 
+  /*
+   * While enabled, Bus::powerSum of every physical bus is kept up to date on each pixel write,
+   * so the ABL current estimate does not need to read back all pixels on every show().
+   * The power of each pixel is cached (1 byte per pixel), so a write does not need to read back the old color either.
+   * ws2815 selects the WS2815 power model (white ignored, max channel counts thrice) for busses using the global model.
+   */
+  void setPowerTracking(bool enable, bool ws2815 = false) {
+    if (enable == powerTracking && ws2815 == ws2815Power) {
+      if (enable && millis() - lastPowerResync > BUS_POWER_RESYNC) resyncPower();
+      return;
+    }
+    powerTracking = enable;
+    ws2815Power = ws2815;
+    if (enable) resyncPower();
+    else for (uint8_t i = 0; i < numBusses; i++) { free(busses[i]->powerCache); busses[i]->powerCache = nullptr; }
+  }
+
+  void resyncPower() {
+    for (uint8_t i = 0; i < numBusses; i++) {
+      Bus* b = busses[i];
+      b->powerSum = 0;
+      if (b->getType() >= TYPE_NET_DDP_RGB) continue; //exclude non-physical network busses
+      uint16_t len = b->getLength();
+      if (!b->powerCache) b->powerCache = (uint8_t*) malloc(len); //without it, writes read back the old color
+      for (uint16_t p = 0; p < len; p++) {
+        uint32_t pp = pixelPower(b, b->getPixelColor(p));
+        if (b->powerCache) pp = (b->powerCache[p] = (pp + 2) >> 2) << 2;
+        b->powerSum += pp;
+      }
+    }
+    lastPowerResync = millis();
+  }
   bool canAllShow() {
     for (uint8_t i = 0; i < numBusses; i++) {
       if (!busses[i]->canShow()) return false;
@@ -587,6 +1409,90 @@ class BusManager {
 
   private:
   uint8_t numBusses = 0;
+  uint8_t nextSend = 0; //bus sending the next network packet
+  uint8_t showOrder[WLED_MAX_BUSSES]; //see show()
+  bool orderValid = false;
+  bool heldBack = false; //a dirty bus waits for its max. frame rate
+
+  inline void showBus(Bus* b, unsigned long now) {
+    uint32_t start = micros();
+    b->show();
+    b->showMicros = (b->showMicros * 7 + (micros() - start)) >> 3; // running average
+    b->lastShow = now;
+    b->setDirty(false);
+  }
+
+  //by priority, then background before blocking busses, then bus number
+  void buildShowOrder() {
+    for (uint8_t i = 0; i < numBusses; i++) {
+      uint8_t j = i;
+      for (; j > 0; j--) {
+        Bus* p = busses[showOrder[j-1]];
+        Bus* b = busses[i];
+        if (p->priority > b->priority || (p->priority == b->priority && p->isBlocking() <= b->isBlocking())) break;
+        showOrder[j] = showOrder[j-1];
+      }
+      showOrder[j] = i;
+    }
+    orderValid = true;
+  }
   Bus* busses[WLED_MAX_BUSSES];
+
+  Bus* create(BusConfig &bc, uint8_t nr) {
+    Bus* bus;
+    if (bc.type >= TYPE_NET_DDP_RGB && bc.type < 96) {
+      bus = new BusNetwork(bc);
+    } else if (IS_DIGITAL(bc.type)) {
+      bus = new BusDigital(bc, nr);
+    } else {
+      bus = new BusPwm(bc);
+    }
+    bus->setWhiteBalance(whiteBalance);
+    if (!cctBuilt) setWhitePoints(cctWarm, cctCold);
+    bus->setCctLut(cctLut);
+    bus->setDithering(dithering);
+    gammaChecked = false;
+    bus->milliAmpsMax = bc.milliAmpsMax;
+    bus->milliAmpsPerLed = bc.milliAmpsPerLed;
+    bus->setMaxFps(bc.maxFps);
+    bus->priority = bc.priority;
+    return bus;
+  }
+  bool powerTracking = false, ws2815Power = false;
+  bool dithering = false;
+  bool outputGamma = false, gammaWanted = false;
+  bool gammaChecked = false; //the busses were asked, again after they changed
+  uint16_t* gammaLut16 = nullptr;
+  uint8_t whiteBalance[4] = {255, 255, 255, 255};
+  uint16_t cctWarm = WLED_CCT_WARM_K, cctCold = WLED_CCT_COLD_K;
+  bool cctBuilt = false;
+  uint8_t cctLut[256];
+  unsigned long lastPowerResync = 0;
+
+  inline uint32_t pixelPower(Bus* bus, uint32_t c) {
+    uint8_t r = c >> 16, g = c >> 8, b = c, w = c >> 24;
+    if (bus->milliAmpsPerLed ? bus->milliAmpsPerLed == 255 : ws2815Power) { //ignore white component on WS2815 power calculation
+      uint8_t m = (r > g) ? r : g;
+      return ((m > b) ? m : b) * 3;
+    }
+    return r + g + b + w;
+  }
+
+  //replaces the contribution of the pixel's current color with c (before c is written)
+  inline void trackPower(Bus* b, uint16_t pix, uint32_t c) {
+    if (b->getType() >= TYPE_NET_DDP_RGB) return;
+    uint32_t p = pixelPower(b, c);
+    if (b->powerCache) { //max. 1020, stored / 4
+      uint8_t q = (p + 2) >> 2;
+      b->powerSum = b->powerSum - (b->powerCache[pix] << 2) + (q << 2);
+      b->powerCache[pix] = q;
+      return;
+    }
+    b->powerSum = b->powerSum - pixelPower(b, b->getPixelColor(pix)) + p;
+  }
+  //last bus hit by setPixelColor()
+  Bus* lastBus = nullptr;
+  uint16_t lastStart = 0, lastEnd = 0;
+  bool overlapping = false;
 };
 #endif
@@ -1,7 +1,10 @@
 #ifndef BusWrapper_h
 #define BusWrapper_h
 
-#include "NeoPixelBrightnessBus.h"
+#include "NeoPixelBus.h"
+#ifdef CONFIG_IDF_TARGET_ESP32C3
+#include "spi_ws281x.h"
+#endif
 
 //Hardware SPI Pins
 #define P_8266_HS_MOSI 13
@@ -69,79 +72,142 @@
 #define I_HS_P98_3 35
 #define I_SS_P98_3 36
 
+//ESP32 parallel output: up to WLED_PARALLEL_I2S_LANES strips clocked out by one DMA transfer (I2S or LCD_CAM)
+#define I_32_PI_NEO_3 37
+#define I_32_PI_NEO_4 38
+#define I_32_PI_400_3 39
+#define I_32_PI_TM1_4 40
+
+//APA102/SK9822 with the 5-bit global brightness field, set per pixel (see BusDigital::applyHd())
+#define I_HS_DOT_4 41 //hardware SPI
+#define I_SS_DOT_4 42 //soft SPI
+
 
 /*** ESP8266 Neopixel methods ***/
 #ifdef ESP8266
 //RGB
-#define B_8266_U0_NEO_3 NeoPixelBrightnessBus<NeoGrbFeature, NeoEsp8266Uart0Ws2813Method> //3 chan, esp8266, gpio1
-#define B_8266_U1_NEO_3 NeoPixelBrightnessBus<NeoGrbFeature, NeoEsp8266Uart1Ws2813Method> //3 chan, esp8266, gpio2
-#define B_8266_DM_NEO_3 NeoPixelBrightnessBus<NeoGrbFeature, NeoEsp8266Dma800KbpsMethod>  //3 chan, esp8266, gpio3
-#define B_8266_BB_NEO_3 NeoPixelBrightnessBus<NeoGrbFeature, NeoEsp8266BitBang800KbpsMethod> //3 chan, esp8266, bb (any pin but 16)
+#define B_8266_U0_NEO_3 NeoPixelBus<NeoGrbFeature, NeoEsp8266Uart0Ws2813Method> //3 chan, esp8266, gpio1
+#define B_8266_U1_NEO_3 NeoPixelBus<NeoGrbFeature, NeoEsp8266Uart1Ws2813Method> //3 chan, esp8266, gpio2
+#define B_8266_DM_NEO_3 NeoPixelBus<NeoGrbFeature, NeoEsp8266Dma800KbpsMethod>  //3 chan, esp8266, gpio3
+#define B_8266_BB_NEO_3 NeoPixelBus<NeoGrbFeature, NeoEsp8266BitBang800KbpsMethod> //3 chan, esp8266, bb (any pin but 16)
 //RGBW
-#define B_8266_U0_NEO_4 NeoPixelBrightnessBus<NeoGrbwFeature, NeoEsp8266Uart0Ws2813Method>   //4 chan, esp8266, gpio1
-#define B_8266_U1_NEO_4 NeoPixelBrightnessBus<NeoGrbwFeature, NeoEsp8266Uart1Ws2813Method>   //4 chan, esp8266, gpio2
-#define B_8266_DM_NEO_4 NeoPixelBrightnessBus<NeoGrbwFeature, NeoEsp8266Dma800KbpsMethod>    //4 chan, esp8266, gpio3
-#define B_8266_BB_NEO_4 NeoPixelBrightnessBus<NeoGrbwFeature, NeoEsp8266BitBang800KbpsMethod> //4 chan, esp8266, bb (any pin)
+#define B_8266_U0_NEO_4 NeoPixelBus<NeoGrbwFeature, NeoEsp8266Uart0Ws2813Method>   //4 chan, esp8266, gpio1
+#define B_8266_U1_NEO_4 NeoPixelBus<NeoGrbwFeature, NeoEsp8266Uart1Ws2813Method>   //4 chan, esp8266, gpio2
+#define B_8266_DM_NEO_4 NeoPixelBus<NeoGrbwFeature, NeoEsp8266Dma800KbpsMethod>    //4 chan, esp8266, gpio3
+#define B_8266_BB_NEO_4 NeoPixelBus<NeoGrbwFeature, NeoEsp8266BitBang800KbpsMethod> //4 chan, esp8266, bb (any pin)
 //400Kbps
-#define B_8266_U0_400_3 NeoPixelBrightnessBus<NeoGrbFeature, NeoEsp8266Uart0400KbpsMethod>   //3 chan, esp8266, gpio1
-#define B_8266_U1_400_3 NeoPixelBrightnessBus<NeoGrbFeature, NeoEsp8266Uart1400KbpsMethod>   //3 chan, esp8266, gpio2
-#define B_8266_DM_400_3 NeoPixelBrightnessBus<NeoGrbFeature, NeoEsp8266Dma400KbpsMethod>     //3 chan, esp8266, gpio3
-#define B_8266_BB_400_3 NeoPixelBrightnessBus<NeoGrbFeature, NeoEsp8266BitBang400KbpsMethod> //3 chan, esp8266, bb (any pin)
+#define B_8266_U0_400_3 NeoPixelBus<NeoGrbFeature, NeoEsp8266Uart0400KbpsMethod>   //3 chan, esp8266, gpio1
+#define B_8266_U1_400_3 NeoPixelBus<NeoGrbFeature, NeoEsp8266Uart1400KbpsMethod>   //3 chan, esp8266, gpio2
+#define B_8266_DM_400_3 NeoPixelBus<NeoGrbFeature, NeoEsp8266Dma400KbpsMethod>     //3 chan, esp8266, gpio3
+#define B_8266_BB_400_3 NeoPixelBus<NeoGrbFeature, NeoEsp8266BitBang400KbpsMethod> //3 chan, esp8266, bb (any pin)
 //TM1814 (RGBW)
-#define B_8266_U0_TM1_4 NeoPixelBrightnessBus<NeoWrgbTm1814Feature, NeoEsp8266Uart0Tm1814Method>
-#define B_8266_U1_TM1_4 NeoPixelBrightnessBus<NeoWrgbTm1814Feature, NeoEsp8266Uart1Tm1814Method>
-#define B_8266_DM_TM1_4 NeoPixelBrightnessBus<NeoWrgbTm1814Feature, NeoEsp8266DmaTm1814Method>
-#define B_8266_BB_TM1_4 NeoPixelBrightnessBus<NeoWrgbTm1814Feature, NeoEsp8266BitBangTm1814Method>
+#define B_8266_U0_TM1_4 NeoPixelBus<NeoWrgbTm1814Feature, NeoEsp8266Uart0Tm1814Method>
+#define B_8266_U1_TM1_4 NeoPixelBus<NeoWrgbTm1814Feature, NeoEsp8266Uart1Tm1814Method>
+#define B_8266_DM_TM1_4 NeoPixelBus<NeoWrgbTm1814Feature, NeoEsp8266DmaTm1814Method>
+#define B_8266_BB_TM1_4 NeoPixelBus<NeoWrgbTm1814Feature, NeoEsp8266BitBangTm1814Method>
 #endif
 
 /*** ESP32 Neopixel methods ***/
 #ifdef ARDUINO_ARCH_ESP32
 //RGB
-#define B_32_RN_NEO_3 NeoPixelBrightnessBus<NeoGrbFeature, NeoEsp32RmtNWs2812xMethod>
-#define B_32_I0_NEO_3 NeoPixelBrightnessBus<NeoGrbFeature, NeoEsp32I2s0800KbpsMethod>
-#ifndef CONFIG_IDF_TARGET_ESP32S2
-#define B_32_I1_NEO_3 NeoPixelBrightnessBus<NeoGrbFeature, NeoEsp32I2s1800KbpsMethod>
+#define B_32_RN_NEO_3 NeoPixelBus<NeoGrbFeature, NeoEsp32RmtNWs2812xMethod>
+#ifdef CONFIG_IDF_TARGET_ESP32C3 //no I2S output in NeoPixelBus, the DMA output after RMT is SPI
+#define B_32_I0_NEO_3 NeoPixelBus<NeoGrbFeature, NeoEsp32SpiWs2812xMethod>
+#else
+#define B_32_I0_NEO_3 NeoPixelBus<NeoGrbFeature, NeoEsp32I2s0800KbpsMethod>
+#endif
+#if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
+#define B_32_I1_NEO_3 NeoPixelBus<NeoGrbFeature, NeoEsp32I2s1800KbpsMethod>
 #endif
 //RGBW
-#define B_32_RN_NEO_4 NeoPixelBrightnessBus<NeoGrbwFeature, NeoEsp32RmtNWs2812xMethod>
-#define B_32_I0_NEO_4 NeoPixelBrightnessBus<NeoGrbwFeature, NeoEsp32I2s0800KbpsMethod>
-#ifndef CONFIG_IDF_TARGET_ESP32S2
-#define B_32_I1_NEO_4 NeoPixelBrightnessBus<NeoGrbwFeature, NeoEsp32I2s1800KbpsMethod>
+#define B_32_RN_NEO_4 NeoPixelBus<NeoGrbwFeature, NeoEsp32RmtNWs2812xMethod>
+#ifdef CONFIG_IDF_TARGET_ESP32C3
+#define B_32_I0_NEO_4 NeoPixelBus<NeoGrbwFeature, NeoEsp32SpiWs2812xMethod>
+#else
+#define B_32_I0_NEO_4 NeoPixelBus<NeoGrbwFeature, NeoEsp32I2s0800KbpsMethod>
+#endif
+#if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
+#define B_32_I1_NEO_4 NeoPixelBus<NeoGrbwFeature, NeoEsp32I2s1800KbpsMethod>
 #endif
 //400Kbps
-#define B_32_RN_400_3 NeoPixelBrightnessBus<NeoGrbFeature, NeoEsp32RmtN400KbpsMethod>
-#define B_32_I0_400_3 NeoPixelBrightnessBus<NeoGrbFeature, NeoEsp32I2s0400KbpsMethod>
-#ifndef CONFIG_IDF_TARGET_ESP32S2
-#define B_32_I1_400_3 NeoPixelBrightnessBus<NeoGrbFeature, NeoEsp32I2s1400KbpsMethod>
+#define B_32_RN_400_3 NeoPixelBus<NeoGrbFeature, NeoEsp32RmtN400KbpsMethod>
+#ifdef CONFIG_IDF_TARGET_ESP32C3
+#define B_32_I0_400_3 NeoPixelBus<NeoGrbFeature, NeoEsp32Spi400KbpsMethod>
+#else
+#define B_32_I0_400_3 NeoPixelBus<NeoGrbFeature, NeoEsp32I2s0400KbpsMethod>
+#endif
+#if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
+#define B_32_I1_400_3 NeoPixelBus<NeoGrbFeature, NeoEsp32I2s1400KbpsMethod>
 #endif
 //TM1814 (RGBW)
-#define B_32_RN_TM1_4 NeoPixelBrightnessBus<NeoWrgbTm1814Feature, NeoEsp32RmtNTm1814Method>
-#define B_32_I0_TM1_4 NeoPixelBrightnessBus<NeoWrgbTm1814Feature, NeoEsp32I2s0Tm1814Method>
-#ifndef CONFIG_IDF_TARGET_ESP32S2
-#define B_32_I1_TM1_4 NeoPixelBrightnessBus<NeoWrgbTm1814Feature, NeoEsp32I2s1Tm1814Method>
+#define B_32_RN_TM1_4 NeoPixelBus<NeoWrgbTm1814Feature, NeoEsp32RmtNTm1814Method>
+#ifndef CONFIG_IDF_TARGET_ESP32C3 //TM1814 is inverted, there is no SPI version
+#define B_32_I0_TM1_4 NeoPixelBus<NeoWrgbTm1814Feature, NeoEsp32I2s0Tm1814Method>
+#endif
+#if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
+#define B_32_I1_TM1_4 NeoPixelBus<NeoWrgbTm1814Feature, NeoEsp32I2s1Tm1814Method>
 #endif
 //Bit Bang theoratically possible, but very undesirable and not needed (no pin restrictions on RMT and I2S)
 
+//parallel output (NeoPixelBus 2.7+), all busses of one of these types share one DMA buffer and are sent together:
+//I2S1 on ESP32, I2S0 on S2 and LCD_CAM on S3 (the NeoEsp32Lcd methods need NeoPixelBus 2.7.7+)
+#ifdef WLED_USE_PARALLEL_I2S
+#if defined(CONFIG_IDF_TARGET_ESP32S3)
+  #define WLED_PI_METHOD(x) NeoEsp32LcdX8##x##Method
+  #define WLED_PI16_METHOD(x) NeoEsp32LcdX16##x##Method
+#elif defined(CONFIG_IDF_TARGET_ESP32S2)
+  #define WLED_PI_METHOD(x) NeoEsp32I2s0X8##x##Method
+  #define WLED_PI16_METHOD(x) NeoEsp32I2s0X16##x##Method
+#else
+  #define WLED_PI_METHOD(x) NeoEsp32I2s1X8##x##Method
+  #define WLED_PI16_METHOD(x) NeoEsp32I2s1X16##x##Method
+#endif
+#if WLED_PARALLEL_I2S_LANES > 8
+#define B_32_PI_NEO_3 NeoPixelBus<NeoGrbFeature, WLED_PI16_METHOD(Ws2812x)>
+#define B_32_PI_NEO_4 NeoPixelBus<NeoGrbwFeature, WLED_PI16_METHOD(800Kbps)>
+#define B_32_PI_400_3 NeoPixelBus<NeoGrbFeature, WLED_PI16_METHOD(400Kbps)>
+#define B_32_PI_TM1_4 NeoPixelBus<NeoWrgbTm1814Feature, WLED_PI16_METHOD(Tm1814)>
+#else
+#define B_32_PI_NEO_3 NeoPixelBus<NeoGrbFeature, WLED_PI_METHOD(Ws2812x)>
+#define B_32_PI_NEO_4 NeoPixelBus<NeoGrbwFeature, WLED_PI_METHOD(800Kbps)>
+#define B_32_PI_400_3 NeoPixelBus<NeoGrbFeature, WLED_PI_METHOD(400Kbps)>
+#define B_32_PI_TM1_4 NeoPixelBus<NeoWrgbTm1814Feature, WLED_PI_METHOD(Tm1814)>
+#endif
+#endif
+
+#endif
+
 #endif
 
 //APA102
-#define B_HS_DOT_3 NeoPixelBrightnessBus<DotStarBgrFeature, DotStarSpiMethod> //hardware SPI
-#define B_SS_DOT_3 NeoPixelBrightnessBus<DotStarBgrFeature, DotStarMethod>    //soft SPI
+#if defined(ARDUINO_ARCH_ESP32) && !defined(WLED_DISABLE_SPI_DMA)
+//hardware SPI by DMA, Show() returns right away. Another DotStarEsp32Dma method of NeoPixelBus can be set for a higher clock
+#ifndef WLED_SPI_DMA_METHOD
+  #define WLED_SPI_DMA_METHOD DotStarEsp32DmaVspiMethod
+#endif
+#define B_HS_DOT_3 NeoPixelBus<DotStarBgrFeature, WLED_SPI_DMA_METHOD>
+#define B_HS_DOT_4 NeoPixelBus<DotStarLbgrFeature, WLED_SPI_DMA_METHOD>
+#else
+#define B_HS_DOT_3 NeoPixelBus<DotStarBgrFeature, DotStarSpiMethod> //hardware SPI
+#define B_HS_DOT_4 NeoPixelBus<DotStarLbgrFeature, DotStarSpiMethod>
+#endif
+#define B_SS_DOT_3 NeoPixelBus<DotStarBgrFeature, DotStarMethod>    //soft SPI
+#define B_SS_DOT_4 NeoPixelBus<DotStarLbgrFeature, DotStarMethod>   //W of the color is the 5-bit brightness
 
 //LPD8806
-#define B_HS_LPD_3 NeoPixelBrightnessBus<Lpd8806GrbFeature, Lpd8806SpiMethod>
-#define B_SS_LPD_3 NeoPixelBrightnessBus<Lpd8806GrbFeature, Lpd8806Method>
+#define B_HS_LPD_3 NeoPixelBus<Lpd8806GrbFeature, Lpd8806SpiMethod>
+#define B_SS_LPD_3 NeoPixelBus<Lpd8806GrbFeature, Lpd8806Method>
 
 //WS2801
-//#define B_HS_WS1_3 NeoPixelBrightnessBus<NeoRbgFeature, NeoWs2801Spi40MhzMethod>
-//#define B_HS_WS1_3 NeoPixelBrightnessBus<NeoRbgFeature, NeoWs2801Spi20MhzMethod>
-//#define B_HS_WS1_3 NeoPixelBrightnessBus<NeoRbgFeature, NeoWs2801SpiMethod>     // 10MHz
-#define B_HS_WS1_3 NeoPixelBrightnessBus<NeoRbgFeature, NeoWs2801Spi2MhzMethod> //slower, more compatible
-#define B_SS_WS1_3 NeoPixelBrightnessBus<NeoRbgFeature, NeoWs2801Method>
+//#define B_HS_WS1_3 NeoPixelBus<NeoRbgFeature, NeoWs2801Spi40MhzMethod>
+//#define B_HS_WS1_3 NeoPixelBus<NeoRbgFeature, NeoWs2801Spi20MhzMethod>
+//#define B_HS_WS1_3 NeoPixelBus<NeoRbgFeature, NeoWs2801SpiMethod>     // 10MHz
+#define B_HS_WS1_3 NeoPixelBus<NeoRbgFeature, NeoWs2801Spi2MhzMethod> //slower, more compatible
+#define B_SS_WS1_3 NeoPixelBus<NeoRbgFeature, NeoWs2801Method>
 
 //P9813
-#define B_HS_P98_3 NeoPixelBrightnessBus<P9813BgrFeature, P9813SpiMethod>
-#define B_SS_P98_3 NeoPixelBrightnessBus<P9813BgrFeature, P9813Method>
+#define B_HS_P98_3 NeoPixelBus<P9813BgrFeature, P9813SpiMethod>
+#define B_SS_P98_3 NeoPixelBus<P9813BgrFeature, P9813Method>
 
 //handles pointer type conversion for all possible bus types
 class PolyBus {
@@ -175,6 +241,7 @@ class PolyBus {
       case I_8266_DM_TM1_4: beginTM1814<B_8266_DM_TM1_4*>(busPtr); break;
       case I_8266_BB_TM1_4: beginTM1814<B_8266_BB_TM1_4*>(busPtr); break;
       case I_HS_DOT_3: (static_cast<B_HS_DOT_3*>(busPtr))->Begin(); break;
+      case I_HS_DOT_4: (static_cast<B_HS_DOT_4*>(busPtr))->Begin(); break;
       case I_HS_LPD_3: (static_cast<B_HS_LPD_3*>(busPtr))->Begin(); break;
       case I_HS_WS1_3: (static_cast<B_HS_WS1_3*>(busPtr))->Begin(); break;
       case I_HS_P98_3: (static_cast<B_HS_P98_3*>(busPtr))->Begin(); break;
@@ -182,31 +249,41 @@ class PolyBus {
     #ifdef ARDUINO_ARCH_ESP32
       case I_32_RN_NEO_3: (static_cast<B_32_RN_NEO_3*>(busPtr))->Begin(); break;
       case I_32_I0_NEO_3: (static_cast<B_32_I0_NEO_3*>(busPtr))->Begin(); break;
-      #ifndef CONFIG_IDF_TARGET_ESP32S2
+      #if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
       case I_32_I1_NEO_3: (static_cast<B_32_I1_NEO_3*>(busPtr))->Begin(); break;
       #endif
       case I_32_RN_NEO_4: (static_cast<B_32_RN_NEO_4*>(busPtr))->Begin(); break;
       case I_32_I0_NEO_4: (static_cast<B_32_I0_NEO_4*>(busPtr))->Begin(); break;
-      #ifndef CONFIG_IDF_TARGET_ESP32S2
+      #if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
       case I_32_I1_NEO_4: (static_cast<B_32_I1_NEO_4*>(busPtr))->Begin(); break;
       #endif
       case I_32_RN_400_3: (static_cast<B_32_RN_400_3*>(busPtr))->Begin(); break;
       case I_32_I0_400_3: (static_cast<B_32_I0_400_3*>(busPtr))->Begin(); break;
-      #ifndef CONFIG_IDF_TARGET_ESP32S2
+      #if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
       case I_32_I1_400_3: (static_cast<B_32_I1_400_3*>(busPtr))->Begin(); break;
       #endif
       case I_32_RN_TM1_4: beginTM1814<B_32_RN_TM1_4*>(busPtr); break;
+      #ifndef CONFIG_IDF_TARGET_ESP32C3
       case I_32_I0_TM1_4: beginTM1814<B_32_I0_TM1_4*>(busPtr); break;
-      #ifndef CONFIG_IDF_TARGET_ESP32S2
+      #endif
+      #if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
       case I_32_I1_TM1_4: beginTM1814<B_32_I1_TM1_4*>(busPtr); break;
       #endif
+      #ifdef WLED_USE_PARALLEL_I2S
+      case I_32_PI_NEO_3: (static_cast<B_32_PI_NEO_3*>(busPtr))->Begin(); break;
+      case I_32_PI_NEO_4: (static_cast<B_32_PI_NEO_4*>(busPtr))->Begin(); break;
+      case I_32_PI_400_3: (static_cast<B_32_PI_400_3*>(busPtr))->Begin(); break;
+      case I_32_PI_TM1_4: beginTM1814<B_32_PI_TM1_4*>(busPtr); break;
+      #endif
       // ESP32 can (and should, to avoid inadvertantly driving the chip select signal) specify the pins used for SPI, but only in begin()
       case I_HS_DOT_3: (static_cast<B_HS_DOT_3*>(busPtr))->Begin(pins[1], -1, pins[0], -1); break;
+      case I_HS_DOT_4: (static_cast<B_HS_DOT_4*>(busPtr))->Begin(pins[1], -1, pins[0], -1); break;
       case I_HS_LPD_3: (static_cast<B_HS_LPD_3*>(busPtr))->Begin(pins[1], -1, pins[0], -1); break;
       case I_HS_WS1_3: (static_cast<B_HS_WS1_3*>(busPtr))->Begin(pins[1], -1, pins[0], -1); break;
       case I_HS_P98_3: (static_cast<B_HS_P98_3*>(busPtr))->Begin(pins[1], -1, pins[0], -1); break;
     #endif
       case I_SS_DOT_3: (static_cast<B_SS_DOT_3*>(busPtr))->Begin(); break;
+      case I_SS_DOT_4: (static_cast<B_SS_DOT_4*>(busPtr))->Begin(); break;
       case I_SS_LPD_3: (static_cast<B_SS_LPD_3*>(busPtr))->Begin(); break;
       case I_SS_WS1_3: (static_cast<B_SS_WS1_3*>(busPtr))->Begin(); break;
       case I_SS_P98_3: (static_cast<B_SS_P98_3*>(busPtr))->Begin(); break;
@@ -214,6 +291,9 @@ class PolyBus {
   };
   static void* create(uint8_t busType, uint8_t* pins, uint16_t len, uint8_t channel) {
     void* busPtr = nullptr;
+    #ifdef WLED_USE_PARALLEL_I2S
+    if (channel >= WLED_PARALLEL_I2S_LANES) channel -= WLED_PARALLEL_I2S_LANES; //RMT channels follow the parallel lanes
+    #endif
     switch (busType) {
       case I_NONE: break;
     #ifdef ESP8266
@@ -237,28 +317,38 @@ class PolyBus {
     #ifdef ARDUINO_ARCH_ESP32
       case I_32_RN_NEO_3: busPtr = new B_32_RN_NEO_3(len, pins[0], (NeoBusChannel)channel); break;
       case I_32_I0_NEO_3: busPtr = new B_32_I0_NEO_3(len, pins[0]); break;
-      #ifndef CONFIG_IDF_TARGET_ESP32S2
+      #if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
       case I_32_I1_NEO_3: busPtr = new B_32_I1_NEO_3(len, pins[0]); break;
       #endif
       case I_32_RN_NEO_4: busPtr = new B_32_RN_NEO_4(len, pins[0], (NeoBusChannel)channel); break;
       case I_32_I0_NEO_4: busPtr = new B_32_I0_NEO_4(len, pins[0]); break;
-      #ifndef CONFIG_IDF_TARGET_ESP32S2
+      #if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
       case I_32_I1_NEO_4: busPtr = new B_32_I1_NEO_4(len, pins[0]); break;
       #endif
       case I_32_RN_400_3: busPtr = new B_32_RN_400_3(len, pins[0], (NeoBusChannel)channel); break;
       case I_32_I0_400_3: busPtr = new B_32_I0_400_3(len, pins[0]); break;
-      #ifndef CONFIG_IDF_TARGET_ESP32S2
+      #if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
       case I_32_I1_400_3: busPtr = new B_32_I1_400_3(len, pins[0]); break;
       #endif
       case I_32_RN_TM1_4: busPtr = new B_32_RN_TM1_4(len, pins[0], (NeoBusChannel)channel); break;
+      #ifndef CONFIG_IDF_TARGET_ESP32C3
       case I_32_I0_TM1_4: busPtr = new B_32_I0_TM1_4(len, pins[0]); break;
-      #ifndef CONFIG_IDF_TARGET_ESP32S2
+      #endif
+      #if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
       case I_32_I1_TM1_4: busPtr = new B_32_I1_TM1_4(len, pins[0]); break;
       #endif
+      #ifdef WLED_USE_PARALLEL_I2S
+      case I_32_PI_NEO_3: busPtr = new B_32_PI_NEO_3(len, pins[0]); break;
+      case I_32_PI_NEO_4: busPtr = new B_32_PI_NEO_4(len, pins[0]); break;
+      case I_32_PI_400_3: busPtr = new B_32_PI_400_3(len, pins[0]); break;
+      case I_32_PI_TM1_4: busPtr = new B_32_PI_TM1_4(len, pins[0]); break;
+      #endif
     #endif
       // for 2-wire: pins[1] is clk, pins[0] is dat.  begin expects (len, clk, dat)
       case I_HS_DOT_3: busPtr = new B_HS_DOT_3(len, pins[1], pins[0]); break;
+      case I_HS_DOT_4: busPtr = new B_HS_DOT_4(len, pins[1], pins[0]); break;
       case I_SS_DOT_3: busPtr = new B_SS_DOT_3(len, pins[1], pins[0]); break;
+      case I_SS_DOT_4: busPtr = new B_SS_DOT_4(len, pins[1], pins[0]); break;
       case I_HS_LPD_3: busPtr = new B_HS_LPD_3(len, pins[1], pins[0]); break;
       case I_SS_LPD_3: busPtr = new B_SS_LPD_3(len, pins[1], pins[0]); break;
       case I_HS_WS1_3: busPtr = new B_HS_WS1_3(len, pins[1], pins[0]); break;
@@ -293,27 +383,37 @@ class PolyBus {
     #ifdef ARDUINO_ARCH_ESP32
       case I_32_RN_NEO_3: (static_cast<B_32_RN_NEO_3*>(busPtr))->Show(); break;
       case I_32_I0_NEO_3: (static_cast<B_32_I0_NEO_3*>(busPtr))->Show(); break;
-      #ifndef CONFIG_IDF_TARGET_ESP32S2
+      #if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
       case I_32_I1_NEO_3: (static_cast<B_32_I1_NEO_3*>(busPtr))->Show(); break;
       #endif
       case I_32_RN_NEO_4: (static_cast<B_32_RN_NEO_4*>(busPtr))->Show(); break;
       case I_32_I0_NEO_4: (static_cast<B_32_I0_NEO_4*>(busPtr))->Show(); break;
-      #ifndef CONFIG_IDF_TARGET_ESP32S2
+      #if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
       case I_32_I1_NEO_4: (static_cast<B_32_I1_NEO_4*>(busPtr))->Show(); break;
       #endif
       case I_32_RN_400_3: (static_cast<B_32_RN_400_3*>(busPtr))->Show(); break;
       case I_32_I0_400_3: (static_cast<B_32_I0_400_3*>(busPtr))->Show(); break;
-      #ifndef CONFIG_IDF_TARGET_ESP32S2
+      #if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
       case I_32_I1_400_3: (static_cast<B_32_I1_400_3*>(busPtr))->Show(); break;
       #endif
       case I_32_RN_TM1_4: (static_cast<B_32_RN_TM1_4*>(busPtr))->Show(); break;
+      #ifndef CONFIG_IDF_TARGET_ESP32C3
       case I_32_I0_TM1_4: (static_cast<B_32_I0_TM1_4*>(busPtr))->Show(); break;
-      #ifndef CONFIG_IDF_TARGET_ESP32S2
+      #endif
+      #if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
       case I_32_I1_TM1_4: (static_cast<B_32_I1_TM1_4*>(busPtr))->Show(); break;
       #endif
+      #ifdef WLED_USE_PARALLEL_I2S
+      case I_32_PI_NEO_3: (static_cast<B_32_PI_NEO_3*>(busPtr))->Show(); break;
+      case I_32_PI_NEO_4: (static_cast<B_32_PI_NEO_4*>(busPtr))->Show(); break;
+      case I_32_PI_400_3: (static_cast<B_32_PI_400_3*>(busPtr))->Show(); break;
+      case I_32_PI_TM1_4: (static_cast<B_32_PI_TM1_4*>(busPtr))->Show(); break;
+      #endif
     #endif
       case I_HS_DOT_3: (static_cast<B_HS_DOT_3*>(busPtr))->Show(); break;
+      case I_HS_DOT_4: (static_cast<B_HS_DOT_4*>(busPtr))->Show(); break;
       case I_SS_DOT_3: (static_cast<B_SS_DOT_3*>(busPtr))->Show(); break;
+      case I_SS_DOT_4: (static_cast<B_SS_DOT_4*>(busPtr))->Show(); break;
       case I_HS_LPD_3: (static_cast<B_HS_LPD_3*>(busPtr))->Show(); break;
       case I_SS_LPD_3: (static_cast<B_SS_LPD_3*>(busPtr))->Show(); break;
       case I_HS_WS1_3: (static_cast<B_HS_WS1_3*>(busPtr))->Show(); break;
@@ -322,6 +422,13 @@ class PolyBus {
       case I_SS_P98_3: (static_cast<B_SS_P98_3*>(busPtr))->Show(); break;
     }
   };
+  //Show() only returns once the frame is out: ESP8266 bitbang (interrupts off) and UART (until the FIFO takes the rest)
+  static bool isBlocking(uint8_t busType) {
+    #ifdef ESP8266
+    if (busType >= I_8266_U0_NEO_3 && busType <= I_8266_BB_TM1_4) return (busType & 0x03) != 0x03; //all but DMA
+    #endif
+    return false;
+  }
   static bool canShow(void* busPtr, uint8_t busType) {
     switch (busType) {
       case I_NONE: return true;
@@ -346,27 +453,37 @@ class PolyBus {
     #ifdef ARDUINO_ARCH_ESP32
       case I_32_RN_NEO_3: return (static_cast<B_32_RN_NEO_3*>(busPtr))->CanShow(); break;
       case I_32_I0_NEO_3: return (static_cast<B_32_I0_NEO_3*>(busPtr))->CanShow(); break;
-      #ifndef CONFIG_IDF_TARGET_ESP32S2
+      #if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
       case I_32_I1_NEO_3: return (static_cast<B_32_I1_NEO_3*>(busPtr))->CanShow(); break;
       #endif
       case I_32_RN_NEO_4: return (static_cast<B_32_RN_NEO_4*>(busPtr))->CanShow(); break;
       case I_32_I0_NEO_4: return (static_cast<B_32_I0_NEO_4*>(busPtr))->CanShow(); break;
-      #ifndef CONFIG_IDF_TARGET_ESP32S2
+      #if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
       case I_32_I1_NEO_4: return (static_cast<B_32_I1_NEO_4*>(busPtr))->CanShow(); break;
       #endif
       case I_32_RN_400_3: return (static_cast<B_32_RN_400_3*>(busPtr))->CanShow(); break;
       case I_32_I0_400_3: return (static_cast<B_32_I0_400_3*>(busPtr))->CanShow(); break;
-      #ifndef CONFIG_IDF_TARGET_ESP32S2
+      #if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
       case I_32_I1_400_3: return (static_cast<B_32_I1_400_3*>(busPtr))->CanShow(); break;
       #endif
       case I_32_RN_TM1_4: return (static_cast<B_32_RN_TM1_4*>(busPtr))->CanShow(); break;
+      #ifndef CONFIG_IDF_TARGET_ESP32C3
       case I_32_I0_TM1_4: return (static_cast<B_32_I0_TM1_4*>(busPtr))->CanShow(); break;
-      #ifndef CONFIG_IDF_TARGET_ESP32S2
+      #endif
+      #if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
       case I_32_I1_TM1_4: return (static_cast<B_32_I1_TM1_4*>(busPtr))->CanShow(); break;
       #endif
+      #ifdef WLED_USE_PARALLEL_I2S
+      case I_32_PI_NEO_3: return (static_cast<B_32_PI_NEO_3*>(busPtr))->CanShow(); break;
+      case I_32_PI_NEO_4: return (static_cast<B_32_PI_NEO_4*>(busPtr))->CanShow(); break;
+      case I_32_PI_400_3: return (static_cast<B_32_PI_400_3*>(busPtr))->CanShow(); break;
+      case I_32_PI_TM1_4: return (static_cast<B_32_PI_TM1_4*>(busPtr))->CanShow(); break;
+      #endif
     #endif
       case I_HS_DOT_3: return (static_cast<B_HS_DOT_3*>(busPtr))->CanShow(); break;
+      case I_HS_DOT_4: return (static_cast<B_HS_DOT_4*>(busPtr))->CanShow(); break;
       case I_SS_DOT_3: return (static_cast<B_SS_DOT_3*>(busPtr))->CanShow(); break;
+      case I_SS_DOT_4: return (static_cast<B_SS_DOT_4*>(busPtr))->CanShow(); break;
       case I_HS_LPD_3: return (static_cast<B_HS_LPD_3*>(busPtr))->CanShow(); break;
       case I_SS_LPD_3: return (static_cast<B_SS_LPD_3*>(busPtr))->CanShow(); break;
       case I_HS_WS1_3: return (static_cast<B_HS_WS1_3*>(busPtr))->CanShow(); break;
@@ -376,29 +493,33 @@ class PolyBus {
     }
     return true;
   };
+  //position in a WRGB color of the channel that goes into the R, G and B slots of the driver color, per color order
+  static const uint8_t* orderShifts(uint8_t co) {
+    static const uint8_t shifts[6][3] = {
+      //R   G   B
+      {16,  8,  0}, //0 = GRB, default
+      { 8, 16,  0}, //1 = RGB, common for WS2811
+      {16,  0,  8}, //2 = BRG
+      { 0, 16,  8}, //3 = RBG
+      { 8,  0, 16}, //4 = BGR
+      { 0,  8, 16}  //5 = GBR
+    };
+    return shifts[co > 5 ? 5 : co];
+  }
+  //reorders the channels of a WRGB color to the selected color order
+  static inline RgbwColor orderColor(uint32_t c, const uint8_t* s) {
+    return RgbwColor(c >> s[0], c >> s[1], c >> s[2], c >> 24);
+  }
+  static inline RgbwColor orderColor(uint32_t c, uint8_t co) {
+    return orderColor(c, orderShifts(co));
+  }
   static void setPixelColor(void* busPtr, uint8_t busType, uint16_t pix, uint32_t c, uint8_t co) {
-    uint8_t r = c >> 16;
-    uint8_t g = c >> 8;
-    uint8_t b = c >> 0;
-    uint8_t w = c >> 24;
-    RgbwColor col;
-
     //TODO make color order override possible on a per-strip basis
     #ifdef COLOR_ORDER_OVERRIDE
     if (pix >= COO_MIN && pix < COO_MAX) co = COO_ORDER;
     #endif
 
-    //reorder channels to selected order
-    switch (co)
-    {
-      case  0: col.G = g; col.R = r; col.B = b; break; //0 = GRB, default
-      case  1: col.G = r; col.R = g; col.B = b; break; //1 = RGB, common for WS2811
-      case  2: col.G = b; col.R = r; col.B = g; break; //2 = BRG
-      case  3: col.G = r; col.R = b; col.B = g; break; //3 = RBG
-      case  4: col.G = b; col.R = g; col.B = r; break; //4 = BGR
-      default: col.G = g; col.R = b; col.B = r; break; //5 = GBR
-    }
-    col.W = w;
+    RgbwColor col = orderColor(c, co);
 
     switch (busType) {
       case I_NONE: break;
@@ -423,27 +544,37 @@ class PolyBus {
     #ifdef ARDUINO_ARCH_ESP32
       case I_32_RN_NEO_3: (static_cast<B_32_RN_NEO_3*>(busPtr))->SetPixelColor(pix, RgbColor(col.R,col.G,col.B)); break;
       case I_32_I0_NEO_3: (static_cast<B_32_I0_NEO_3*>(busPtr))->SetPixelColor(pix, RgbColor(col.R,col.G,col.B)); break;
-      #ifndef CONFIG_IDF_TARGET_ESP32S2
+      #if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
       case I_32_I1_NEO_3: (static_cast<B_32_I1_NEO_3*>(busPtr))->SetPixelColor(pix, RgbColor(col.R,col.G,col.B)); break;
       #endif
       case I_32_RN_NEO_4: (static_cast<B_32_RN_NEO_4*>(busPtr))->SetPixelColor(pix, col); break;
       case I_32_I0_NEO_4: (static_cast<B_32_I0_NEO_4*>(busPtr))->SetPixelColor(pix, col); break;
-      #ifndef CONFIG_IDF_TARGET_ESP32S2
+      #if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
       case I_32_I1_NEO_4: (static_cast<B_32_I1_NEO_4*>(busPtr))->SetPixelColor(pix, col); break;
       #endif
       case I_32_RN_400_3: (static_cast<B_32_RN_400_3*>(busPtr))->SetPixelColor(pix, RgbColor(col.R,col.G,col.B)); break;
       case I_32_I0_400_3: (static_cast<B_32_I0_400_3*>(busPtr))->SetPixelColor(pix, RgbColor(col.R,col.G,col.B)); break;
-      #ifndef CONFIG_IDF_TARGET_ESP32S2
+      #if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
       case I_32_I1_400_3: (static_cast<B_32_I1_400_3*>(busPtr))->SetPixelColor(pix, RgbColor(col.R,col.G,col.B)); break;
       #endif
       case I_32_RN_TM1_4: (static_cast<B_32_RN_TM1_4*>(busPtr))->SetPixelColor(pix, col); break;
+      #ifndef CONFIG_IDF_TARGET_ESP32C3
       case I_32_I0_TM1_4: (static_cast<B_32_I0_TM1_4*>(busPtr))->SetPixelColor(pix, col); break;
-      #ifndef CONFIG_IDF_TARGET_ESP32S2
+      #endif
+      #if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
       case I_32_I1_TM1_4: (static_cast<B_32_I1_TM1_4*>(busPtr))->SetPixelColor(pix, col); break;
       #endif
+      #ifdef WLED_USE_PARALLEL_I2S
+      case I_32_PI_NEO_3: (static_cast<B_32_PI_NEO_3*>(busPtr))->SetPixelColor(pix, RgbColor(col.R,col.G,col.B)); break;
+      case I_32_PI_NEO_4: (static_cast<B_32_PI_NEO_4*>(busPtr))->SetPixelColor(pix, col); break;
+      case I_32_PI_400_3: (static_cast<B_32_PI_400_3*>(busPtr))->SetPixelColor(pix, RgbColor(col.R,col.G,col.B)); break;
+      case I_32_PI_TM1_4: (static_cast<B_32_PI_TM1_4*>(busPtr))->SetPixelColor(pix, col); break;
+      #endif
     #endif
       case I_HS_DOT_3: (static_cast<B_HS_DOT_3*>(busPtr))->SetPixelColor(pix, RgbColor(col.R,col.G,col.B)); break;
+      case I_HS_DOT_4: (static_cast<B_HS_DOT_4*>(busPtr))->SetPixelColor(pix, col); break;
       case I_SS_DOT_3: (static_cast<B_SS_DOT_3*>(busPtr))->SetPixelColor(pix, RgbColor(col.R,col.G,col.B)); break;
+      case I_SS_DOT_4: (static_cast<B_SS_DOT_4*>(busPtr))->SetPixelColor(pix, col); break;
       case I_HS_LPD_3: (static_cast<B_HS_LPD_3*>(busPtr))->SetPixelColor(pix, RgbColor(col.R,col.G,col.B)); break;
       case I_SS_LPD_3: (static_cast<B_SS_LPD_3*>(busPtr))->SetPixelColor(pix, RgbColor(col.R,col.G,col.B)); break;
       case I_HS_WS1_3: (static_cast<B_HS_WS1_3*>(busPtr))->SetPixelColor(pix, RgbColor(col.R,col.G,col.B)); break;
@@ -452,57 +583,116 @@ class PolyBus {
       case I_SS_P98_3: (static_cast<B_SS_P98_3*>(busPtr))->SetPixelColor(pix, RgbColor(col.R,col.G,col.B)); break;
     }
   };
-  static void setBrightness(void* busPtr, uint8_t busType, uint8_t b) {
+  //write len consecutive colors to a bus, starting at driver pixel pix and advancing by dir (1 or -1)
+  //the color order is resolved to channel shifts once per span
+  template <class T>
+  static void setSpan3(void* busPtr, uint16_t pix, int8_t dir, const uint32_t* colors, uint16_t len, uint8_t co) {
+    T* bus = static_cast<T*>(busPtr);
+    const uint8_t* s = orderShifts(co);
+    for (uint16_t i = 0; i < len; i++, pix += dir) {
+      #ifdef COLOR_ORDER_OVERRIDE
+      if (pix >= COO_MIN && pix < COO_MAX) { RgbwColor col = orderColor(colors[i], (uint8_t)COO_ORDER); bus->SetPixelColor(pix, RgbColor(col.R,col.G,col.B)); continue; }
+      #endif
+      uint32_t c = colors[i];
+      bus->SetPixelColor(pix, RgbColor(c >> s[0], c >> s[1], c >> s[2]));
+    }
+  }
+  template <class T>
+  static void setSpan4(void* busPtr, uint16_t pix, int8_t dir, const uint32_t* colors, uint16_t len, uint8_t co) {
+    T* bus = static_cast<T*>(busPtr);
+    const uint8_t* s = orderShifts(co);
+    for (uint16_t i = 0; i < len; i++, pix += dir) {
+      #ifdef COLOR_ORDER_OVERRIDE
+      if (pix >= COO_MIN && pix < COO_MAX) { bus->SetPixelColor(pix, orderColor(colors[i], (uint8_t)COO_ORDER)); continue; }
+      #endif
+      bus->SetPixelColor(pix, orderColor(colors[i], s));
+    }
+  }
+  //one-wire GRB(W) busses: the reordered bytes are stored straight into the NeoPixelBus pixel buffer (wire format),
+  //without the color objects and the per pixel bounds check of SetPixelColor()
+  template <class T, uint8_t C>
+  static void setSpanWire(void* busPtr, uint16_t pix, int8_t dir, const uint32_t* colors, uint16_t len, uint8_t co) {
+    #ifdef COLOR_ORDER_OVERRIDE
+    if (C == 3) setSpan3<T>(busPtr, pix, dir, colors, len, co); else setSpan4<T>(busPtr, pix, dir, colors, len, co);
+    #else
+    T* bus = static_cast<T*>(busPtr);
+    uint16_t count = bus->PixelCount();
+    if (pix >= count) return;
+    uint16_t room = (dir > 0) ? count - pix : pix + 1;
+    if (len > room) len = room;
+    const uint8_t* s = orderShifts(co);
+    uint8_t* p = bus->Pixels() + pix * C;
+    const int16_t step = dir * C;
+    for (uint16_t i = 0; i < len; i++, p += step) {
+      uint32_t c = colors[i];
+      p[0] = c >> s[1]; p[1] = c >> s[0]; p[2] = c >> s[2]; //G, R, B
+      if (C == 4) p[3] = c >> 24;
+    }
+    bus->Dirty();
+    #endif
+  }
+  //same as setPixelColor() for a run of pixels, but only resolves the bus type once
+  static void setPixelSpan(void* busPtr, uint8_t busType, uint16_t pix, int8_t dir, const uint32_t* colors, uint16_t len, uint8_t co) {
     switch (busType) {
       case I_NONE: break;
     #ifdef ESP8266
-      case I_8266_U0_NEO_3: (static_cast<B_8266_U0_NEO_3*>(busPtr))->SetBrightness(b); break;
-      case I_8266_U1_NEO_3: (static_cast<B_8266_U1_NEO_3*>(busPtr))->SetBrightness(b); break;
-      case I_8266_DM_NEO_3: (static_cast<B_8266_DM_NEO_3*>(busPtr))->SetBrightness(b); break;
-      case I_8266_BB_NEO_3: (static_cast<B_8266_BB_NEO_3*>(busPtr))->SetBrightness(b); break;
-      case I_8266_U0_NEO_4: (static_cast<B_8266_U0_NEO_4*>(busPtr))->SetBrightness(b); break;
-      case I_8266_U1_NEO_4: (static_cast<B_8266_U1_NEO_4*>(busPtr))->SetBrightness(b); break;
-      case I_8266_DM_NEO_4: (static_cast<B_8266_DM_NEO_4*>(busPtr))->SetBrightness(b); break;
-      case I_8266_BB_NEO_4: (static_cast<B_8266_BB_NEO_4*>(busPtr))->SetBrightness(b); break;
-      case I_8266_U0_400_3: (static_cast<B_8266_U0_400_3*>(busPtr))->SetBrightness(b); break;
-      case I_8266_U1_400_3: (static_cast<B_8266_U1_400_3*>(busPtr))->SetBrightness(b); break;
-      case I_8266_DM_400_3: (static_cast<B_8266_DM_400_3*>(busPtr))->SetBrightness(b); break;
-      case I_8266_BB_400_3: (static_cast<B_8266_BB_400_3*>(busPtr))->SetBrightness(b); break;
-      case I_8266_U0_TM1_4: (static_cast<B_8266_U0_TM1_4*>(busPtr))->SetBrightness(b); break;
-      case I_8266_U1_TM1_4: (static_cast<B_8266_U1_TM1_4*>(busPtr))->SetBrightness(b); break;
-      case I_8266_DM_TM1_4: (static_cast<B_8266_DM_TM1_4*>(busPtr))->SetBrightness(b); break;
-      case I_8266_BB_TM1_4: (static_cast<B_8266_BB_TM1_4*>(busPtr))->SetBrightness(b); break;
+      case I_8266_U0_NEO_3: setSpanWire<B_8266_U0_NEO_3, 3>(busPtr, pix, dir, colors, len, co); break;
+      case I_8266_U1_NEO_3: setSpanWire<B_8266_U1_NEO_3, 3>(busPtr, pix, dir, colors, len, co); break;
+      case I_8266_DM_NEO_3: setSpanWire<B_8266_DM_NEO_3, 3>(busPtr, pix, dir, colors, len, co); break;
+      case I_8266_BB_NEO_3: setSpanWire<B_8266_BB_NEO_3, 3>(busPtr, pix, dir, colors, len, co); break;
+      case I_8266_U0_NEO_4: setSpanWire<B_8266_U0_NEO_4, 4>(busPtr, pix, dir, colors, len, co); break;
+      case I_8266_U1_NEO_4: setSpanWire<B_8266_U1_NEO_4, 4>(busPtr, pix, dir, colors, len, co); break;
+      case I_8266_DM_NEO_4: setSpanWire<B_8266_DM_NEO_4, 4>(busPtr, pix, dir, colors, len, co); break;
+      case I_8266_BB_NEO_4: setSpanWire<B_8266_BB_NEO_4, 4>(busPtr, pix, dir, colors, len, co); break;
+      case I_8266_U0_400_3: setSpanWire<B_8266_U0_400_3, 3>(busPtr, pix, dir, colors, len, co); break;
+      case I_8266_U1_400_3: setSpanWire<B_8266_U1_400_3, 3>(busPtr, pix, dir, colors, len, co); break;
+      case I_8266_DM_400_3: setSpanWire<B_8266_DM_400_3, 3>(busPtr, pix, dir, colors, len, co); break;
+      case I_8266_BB_400_3: setSpanWire<B_8266_BB_400_3, 3>(busPtr, pix, dir, colors, len, co); break;
+      case I_8266_U0_TM1_4: setSpan4<B_8266_U0_TM1_4>(busPtr, pix, dir, colors, len, co); break;
+      case I_8266_U1_TM1_4: setSpan4<B_8266_U1_TM1_4>(busPtr, pix, dir, colors, len, co); break;
+      case I_8266_DM_TM1_4: setSpan4<B_8266_DM_TM1_4>(busPtr, pix, dir, colors, len, co); break;
+      case I_8266_BB_TM1_4: setSpan4<B_8266_BB_TM1_4>(busPtr, pix, dir, colors, len, co); break;
     #endif
     #ifdef ARDUINO_ARCH_ESP32
-      case I_32_RN_NEO_3: (static_cast<B_32_RN_NEO_3*>(busPtr))->SetBrightness(b); break;
-      case I_32_I0_NEO_3: (static_cast<B_32_I0_NEO_3*>(busPtr))->SetBrightness(b); break;
-      #ifndef CONFIG_IDF_TARGET_ESP32S2
-      case I_32_I1_NEO_3: (static_cast<B_32_I1_NEO_3*>(busPtr))->SetBrightness(b); break;
-      #endif
-      case I_32_RN_NEO_4: (static_cast<B_32_RN_NEO_4*>(busPtr))->SetBrightness(b); break;
-      case I_32_I0_NEO_4: (static_cast<B_32_I0_NEO_4*>(busPtr))->SetBrightness(b); break;
-      #ifndef CONFIG_IDF_TARGET_ESP32S2
-      case I_32_I1_NEO_4: (static_cast<B_32_I1_NEO_4*>(busPtr))->SetBrightness(b); break;
-      #endif
-      case I_32_RN_400_3: (static_cast<B_32_RN_400_3*>(busPtr))->SetBrightness(b); break;
-      case I_32_I0_400_3: (static_cast<B_32_I0_400_3*>(busPtr))->SetBrightness(b); break;
-      #ifndef CONFIG_IDF_TARGET_ESP32S2
-      case I_32_I1_400_3: (static_cast<B_32_I1_400_3*>(busPtr))->SetBrightness(b); break;
-      #endif
-      case I_32_RN_TM1_4: (static_cast<B_32_RN_TM1_4*>(busPtr))->SetBrightness(b); break;
-      case I_32_I0_TM1_4: (static_cast<B_32_I0_TM1_4*>(busPtr))->SetBrightness(b); break;
-      #ifndef CONFIG_IDF_TARGET_ESP32S2
-      case I_32_I1_TM1_4: (static_cast<B_32_I1_TM1_4*>(busPtr))->SetBrightness(b); break;
+      case I_32_RN_NEO_3: setSpanWire<B_32_RN_NEO_3, 3>(busPtr, pix, dir, colors, len, co); break;
+      case I_32_I0_NEO_3: setSpanWire<B_32_I0_NEO_3, 3>(busPtr, pix, dir, colors, len, co); break;
+      #if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
+      case I_32_I1_NEO_3: setSpanWire<B_32_I1_NEO_3, 3>(busPtr, pix, dir, colors, len, co); break;
+      #endif
+      case I_32_RN_NEO_4: setSpanWire<B_32_RN_NEO_4, 4>(busPtr, pix, dir, colors, len, co); break;
+      case I_32_I0_NEO_4: setSpanWire<B_32_I0_NEO_4, 4>(busPtr, pix, dir, colors, len, co); break;
+      #if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
+      case I_32_I1_NEO_4: setSpanWire<B_32_I1_NEO_4, 4>(busPtr, pix, dir, colors, len, co); break;
+      #endif
+      case I_32_RN_400_3: setSpanWire<B_32_RN_400_3, 3>(busPtr, pix, dir, colors, len, co); break;
+      case I_32_I0_400_3: setSpanWire<B_32_I0_400_3, 3>(busPtr, pix, dir, colors, len, co); break;
+      #if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
+      case I_32_I1_400_3: setSpanWire<B_32_I1_400_3, 3>(busPtr, pix, dir, colors, len, co); break;
+      #endif
+      case I_32_RN_TM1_4: setSpan4<B_32_RN_TM1_4>(busPtr, pix, dir, colors, len, co); break;
+      #ifndef CONFIG_IDF_TARGET_ESP32C3
+      case I_32_I0_TM1_4: setSpan4<B_32_I0_TM1_4>(busPtr, pix, dir, colors, len, co); break;
+      #endif
+      #if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
+      case I_32_I1_TM1_4: setSpan4<B_32_I1_TM1_4>(busPtr, pix, dir, colors, len, co); break;
+      #endif
+      #ifdef WLED_USE_PARALLEL_I2S
+      case I_32_PI_NEO_3: setSpanWire<B_32_PI_NEO_3, 3>(busPtr, pix, dir, colors, len, co); break;
+      case I_32_PI_NEO_4: setSpanWire<B_32_PI_NEO_4, 4>(busPtr, pix, dir, colors, len, co); break;
+      case I_32_PI_400_3: setSpanWire<B_32_PI_400_3, 3>(busPtr, pix, dir, colors, len, co); break;
+      case I_32_PI_TM1_4: setSpan4<B_32_PI_TM1_4>(busPtr, pix, dir, colors, len, co); break;
       #endif
     #endif
-      case I_HS_DOT_3: (static_cast<B_HS_DOT_3*>(busPtr))->SetBrightness(b); break;
-      case I_SS_DOT_3: (static_cast<B_SS_DOT_3*>(busPtr))->SetBrightness(b); break;
-      case I_HS_LPD_3: (static_cast<B_HS_LPD_3*>(busPtr))->SetBrightness(b); break;
-      case I_SS_LPD_3: (static_cast<B_SS_LPD_3*>(busPtr))->SetBrightness(b); break;
-      case I_HS_WS1_3: (static_cast<B_HS_WS1_3*>(busPtr))->SetBrightness(b); break;
-      case I_SS_WS1_3: (static_cast<B_SS_WS1_3*>(busPtr))->SetBrightness(b); break;
-      case I_HS_P98_3: (static_cast<B_HS_P98_3*>(busPtr))->SetBrightness(b); break;
-      case I_SS_P98_3: (static_cast<B_SS_P98_3*>(busPtr))->SetBrightness(b); break;
+      case I_HS_DOT_3: setSpan3<B_HS_DOT_3>(busPtr, pix, dir, colors, len, co); break;
+      case I_HS_DOT_4: setSpan4<B_HS_DOT_4>(busPtr, pix, dir, colors, len, co); break;
+      case I_SS_DOT_3: setSpan3<B_SS_DOT_3>(busPtr, pix, dir, colors, len, co); break;
+      case I_SS_DOT_4: setSpan4<B_SS_DOT_4>(busPtr, pix, dir, colors, len, co); break;
+      case I_HS_LPD_3: setSpan3<B_HS_LPD_3>(busPtr, pix, dir, colors, len, co); break;
+      case I_SS_LPD_3: setSpan3<B_SS_LPD_3>(busPtr, pix, dir, colors, len, co); break;
+      case I_HS_WS1_3: setSpan3<B_HS_WS1_3>(busPtr, pix, dir, colors, len, co); break;
+      case I_SS_WS1_3: setSpan3<B_SS_WS1_3>(busPtr, pix, dir, colors, len, co); break;
+      case I_HS_P98_3: setSpan3<B_HS_P98_3>(busPtr, pix, dir, colors, len, co); break;
+      case I_SS_P98_3: setSpan3<B_SS_P98_3>(busPtr, pix, dir, colors, len, co); break;
     }
   };
   static uint32_t getPixelColor(void* busPtr, uint8_t busType, uint16_t pix, uint8_t co) {
@@ -530,27 +720,37 @@ class PolyBus {
     #ifdef ARDUINO_ARCH_ESP32
       case I_32_RN_NEO_3: col = (static_cast<B_32_RN_NEO_3*>(busPtr))->GetPixelColor(pix); break;
       case I_32_I0_NEO_3: col = (static_cast<B_32_I0_NEO_3*>(busPtr))->GetPixelColor(pix); break;
-      #ifndef CONFIG_IDF_TARGET_ESP32S2
+      #if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
       case I_32_I1_NEO_3: col = (static_cast<B_32_I1_NEO_3*>(busPtr))->GetPixelColor(pix); break;
       #endif
       case I_32_RN_NEO_4: col = (static_cast<B_32_RN_NEO_4*>(busPtr))->GetPixelColor(pix); break;
       case I_32_I0_NEO_4: col = (static_cast<B_32_I0_NEO_4*>(busPtr))->GetPixelColor(pix); break;
-      #ifndef CONFIG_IDF_TARGET_ESP32S2
+      #if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
       case I_32_I1_NEO_4: col = (static_cast<B_32_I1_NEO_4*>(busPtr))->GetPixelColor(pix); break;
       #endif
       case I_32_RN_400_3: col = (static_cast<B_32_RN_400_3*>(busPtr))->GetPixelColor(pix); break;
       case I_32_I0_400_3: col = (static_cast<B_32_I0_400_3*>(busPtr))->GetPixelColor(pix); break;
-      #ifndef CONFIG_IDF_TARGET_ESP32S2
+      #if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
       case I_32_I1_400_3: col = (static_cast<B_32_I1_400_3*>(busPtr))->GetPixelColor(pix); break;
       #endif
       case I_32_RN_TM1_4: col = (static_cast<B_32_RN_TM1_4*>(busPtr))->GetPixelColor(pix); break;
+      #ifndef CONFIG_IDF_TARGET_ESP32C3
       case I_32_I0_TM1_4: col = (static_cast<B_32_I0_TM1_4*>(busPtr))->GetPixelColor(pix); break;
-      #ifndef CONFIG_IDF_TARGET_ESP32S2
+      #endif
+      #if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
       case I_32_I1_TM1_4: col = (static_cast<B_32_I1_TM1_4*>(busPtr))->GetPixelColor(pix); break;
       #endif
+      #ifdef WLED_USE_PARALLEL_I2S
+      case I_32_PI_NEO_3: col = (static_cast<B_32_PI_NEO_3*>(busPtr))->GetPixelColor(pix); break;
+      case I_32_PI_NEO_4: col = (static_cast<B_32_PI_NEO_4*>(busPtr))->GetPixelColor(pix); break;
+      case I_32_PI_400_3: col = (static_cast<B_32_PI_400_3*>(busPtr))->GetPixelColor(pix); break;
+      case I_32_PI_TM1_4: col = (static_cast<B_32_PI_TM1_4*>(busPtr))->GetPixelColor(pix); break;
+      #endif
     #endif
       case I_HS_DOT_3: col = (static_cast<B_HS_DOT_3*>(busPtr))->GetPixelColor(pix); break;
+      case I_HS_DOT_4: col = (static_cast<B_HS_DOT_4*>(busPtr))->GetPixelColor(pix); break;
       case I_SS_DOT_3: col = (static_cast<B_SS_DOT_3*>(busPtr))->GetPixelColor(pix); break;
+      case I_SS_DOT_4: col = (static_cast<B_SS_DOT_4*>(busPtr))->GetPixelColor(pix); break;
       case I_HS_LPD_3: col = (static_cast<B_HS_LPD_3*>(busPtr))->GetPixelColor(pix); break;
       case I_SS_LPD_3: col = (static_cast<B_SS_LPD_3*>(busPtr))->GetPixelColor(pix); break;
       case I_HS_WS1_3: col = (static_cast<B_HS_WS1_3*>(busPtr))->GetPixelColor(pix); break;
@@ -563,17 +763,8 @@ class PolyBus {
     if (pix >= COO_MIN && pix < COO_MAX) co = COO_ORDER;
     #endif
 
-    switch (co)
-    {
-      //                    W               G              R               B
-      case  0: return ((col.W << 24) | (col.G << 8) | (col.R << 16) | (col.B)); //0 = GRB, default
-      case  1: return ((col.W << 24) | (col.R << 8) | (col.G << 16) | (col.B)); //1 = RGB, common for WS2811
-      case  2: return ((col.W << 24) | (col.B << 8) | (col.R << 16) | (col.G)); //2 = BRG
-      case  3: return ((col.W << 24) | (col.B << 8) | (col.G << 16) | (col.R)); //3 = RBG
-      case  4: return ((col.W << 24) | (col.R << 8) | (col.B << 16) | (col.G)); //4 = BGR
-      case  5: return ((col.W << 24) | (col.G << 8) | (col.B << 16) | (col.R)); //5 = GBR
-    }
-    return 0;
+    const uint8_t* s = orderShifts(co);
+    return ((uint32_t)col.W << 24) | ((uint32_t)col.R << s[0]) | ((uint32_t)col.G << s[1]) | ((uint32_t)col.B << s[2]);
   }
 
   static void cleanup(void* busPtr, uint8_t busType) {
@@ -601,27 +792,37 @@ class PolyBus {
     #ifdef ARDUINO_ARCH_ESP32
       case I_32_RN_NEO_3: delete (static_cast<B_32_RN_NEO_3*>(busPtr)); break;
       case I_32_I0_NEO_3: delete (static_cast<B_32_I0_NEO_3*>(busPtr)); break;
-      #ifndef CONFIG_IDF_TARGET_ESP32S2
+      #if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
       case I_32_I1_NEO_3: delete (static_cast<B_32_I1_NEO_3*>(busPtr)); break;
       #endif
       case I_32_RN_NEO_4: delete (static_cast<B_32_RN_NEO_4*>(busPtr)); break;
       case I_32_I0_NEO_4: delete (static_cast<B_32_I0_NEO_4*>(busPtr)); break;
-      #ifndef CONFIG_IDF_TARGET_ESP32S2
+      #if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
       case I_32_I1_NEO_4: delete (static_cast<B_32_I1_NEO_4*>(busPtr)); break;
       #endif
       case I_32_RN_400_3: delete (static_cast<B_32_RN_400_3*>(busPtr)); break;
       case I_32_I0_400_3: delete (static_cast<B_32_I0_400_3*>(busPtr)); break;
-      #ifndef CONFIG_IDF_TARGET_ESP32S2
+      #if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
       case I_32_I1_400_3: delete (static_cast<B_32_I1_400_3*>(busPtr)); break;
       #endif
       case I_32_RN_TM1_4: delete (static_cast<B_32_RN_TM1_4*>(busPtr)); break;
+      #ifndef CONFIG_IDF_TARGET_ESP32C3
       case I_32_I0_TM1_4: delete (static_cast<B_32_I0_TM1_4*>(busPtr)); break;
-      #ifndef CONFIG_IDF_TARGET_ESP32S2
+      #endif
+      #if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
       case I_32_I1_TM1_4: delete (static_cast<B_32_I1_TM1_4*>(busPtr)); break;
       #endif
+      #ifdef WLED_USE_PARALLEL_I2S
+      case I_32_PI_NEO_3: delete (static_cast<B_32_PI_NEO_3*>(busPtr)); break;
+      case I_32_PI_NEO_4: delete (static_cast<B_32_PI_NEO_4*>(busPtr)); break;
+      case I_32_PI_400_3: delete (static_cast<B_32_PI_400_3*>(busPtr)); break;
+      case I_32_PI_TM1_4: delete (static_cast<B_32_PI_TM1_4*>(busPtr)); break;
+      #endif
     #endif
       case I_HS_DOT_3: delete (static_cast<B_HS_DOT_3*>(busPtr)); break;
+      case I_HS_DOT_4: delete (static_cast<B_HS_DOT_4*>(busPtr)); break;
       case I_SS_DOT_3: delete (static_cast<B_SS_DOT_3*>(busPtr)); break;
+      case I_SS_DOT_4: delete (static_cast<B_SS_DOT_4*>(busPtr)); break;
       case I_HS_LPD_3: delete (static_cast<B_HS_LPD_3*>(busPtr)); break;
       case I_SS_LPD_3: delete (static_cast<B_SS_LPD_3*>(busPtr)); break;
       case I_HS_WS1_3: delete (static_cast<B_HS_WS1_3*>(busPtr)); break;
@@ -644,6 +845,7 @@ class PolyBus {
       uint8_t t = I_NONE;
       switch (busType) {
         case TYPE_APA102:  t = I_SS_DOT_3; break;
+        case TYPE_APA102_HD: t = I_SS_DOT_4; break;
         case TYPE_LPD8806: t = I_SS_LPD_3; break;
         case TYPE_WS2801:  t = I_SS_WS1_3; break;
         case TYPE_P9813:   t = I_SS_P98_3; break;
@@ -667,13 +869,30 @@ class PolyBus {
           return I_8266_U0_TM1_4 + offset;
       }
       #else //ESP32
-      uint8_t offset = 0; //0 = RMT (num 0-7) 8 = I2S0 9 = I2S1
-      #ifndef CONFIG_IDF_TARGET_ESP32S2
-      if (num > 9) return I_NONE;
-      if (num > 7) offset = num -7;
-      #else //ESP32 S2 only has 4 RMT channels
-      if (num > 5) return I_NONE;
-      if (num > 4) offset = num -4;
+      uint8_t offset = 0; //0 = RMT, 1 = I2S0 (SPI on C3), 2 = I2S1
+      #if defined(WLED_USE_PARALLEL_I2S)
+      //the first busses are lanes of the parallel output, then RMT. The other DMA outputs are not used
+      if (num >= WLED_PARALLEL_I2S_LANES + WLED_RMT_CHANNELS) return I_NONE;
+      if (num < WLED_PARALLEL_I2S_LANES) {
+        switch (busType) {
+          case TYPE_WS2812_RGB:
+          case TYPE_WS2812_WWA:
+            return I_32_PI_NEO_3;
+          case TYPE_SK6812_RGBW:
+            return I_32_PI_NEO_4;
+          case TYPE_WS2811_400KHZ:
+            return I_32_PI_400_3;
+          case TYPE_TM1814:
+            return I_32_PI_TM1_4;
+        }
+        return I_NONE;
+      }
+      #else
+      if (num >= WLED_RMT_CHANNELS + WLED_DMA_CHANNELS) return I_NONE;
+      if (num >= WLED_RMT_CHANNELS) offset = num - WLED_RMT_CHANNELS +1;
+      #ifdef CONFIG_IDF_TARGET_ESP32C3
+      if (offset && busType == TYPE_TM1814) return I_NONE;
+      #endif
       #endif
       switch (busType) {
         case TYPE_WS2812_RGB:
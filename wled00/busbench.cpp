@@ -0,0 +1,136 @@
+#include "wled.h"
+
+/*
+ * Bus driver benchmark: times each configured bus with its driver (PolyBus::getI()) on the device: how long show()
+ * blocks the loop, how long until canShow() is true again (the frame is on the wire) and the frame rate both allow.
+ * Started with {"busbench":n} (frames per bus, 1-250), results are part of /json/perf.
+ * One frame of one bus is sent per loop pass. Realtime packets lost (udpInLost) while a bus was tested show how much
+ * its output disturbs WiFi, if a stream is received during the run.
+ * Suggested driver per bus ("rec"): "ok", "dma" (ESP8266: GPIO3, or GPIO1/2 for UART), "hwspi" (hardware SPI pins),
+ * "split" (one frame takes longer than the frame time, use shorter busses on more outputs).
+ */
+#ifdef WLED_ENABLE_BUSBENCH
+
+#define BUSBENCH_MAX      250
+#define BUSBENCH_WAIT_US  100000 //longest transfer waited for
+
+typedef struct BusBenchResult {
+  WS2812FX::PerfStat show; //us show() blocked
+  WS2812FX::PerfStat wait; //us until canShow() after show()
+  uint32_t lost;           //realtime packets lost while the bus was tested
+} BusBenchResult;
+
+static volatile int16_t bbRequest = -1; //set by the JSON API, started by loop()
+static uint8_t bbFrames = 0;
+static uint8_t bbBusCount = 0;
+static uint8_t bbBus = 0;
+static uint8_t bbStep = 0;
+static bool bbRunning = false;
+static uint32_t bbLostStart = 0;
+static BusBenchResult bbResults[WLED_MAX_BUSSES];
+
+void startBusBenchmark(uint8_t frames)
+{
+  bbRequest = MIN(frames, BUSBENCH_MAX);
+}
+
+static const char* bbDriverName(uint8_t iType)
+{
+  if (iType == I_NONE) return "none";
+  #ifdef ESP8266
+  if (iType <= I_8266_BB_TM1_4) {
+    static const char* const names[4] = {"uart0", "uart1", "dma", "bitbang"};
+    return names[(iType -1) & 0x03];
+  }
+  #else
+  if (iType >= I_32_RN_NEO_3 && iType <= I_32_I1_TM1_4) {
+    static const char* const names[3] = {"rmt", "i2s0", "i2s1"};
+    return names[(iType - I_32_RN_NEO_3) % 3];
+  }
+  if (iType >= I_32_PI_NEO_3 && iType <= I_32_PI_TM1_4) return "i2s par";
+  #endif
+  if (iType == I_HS_DOT_4 || (iType >= I_HS_DOT_3 && iType <= I_SS_P98_3 && (iType & 1))) return "hwspi";
+  return "swspi";
+}
+
+static const char* bbRecommend(uint8_t iType, const BusBenchResult& r, uint16_t fps)
+{
+  #ifdef ESP8266
+  if (iType >= I_8266_U0_NEO_3 && iType <= I_8266_BB_TM1_4) {
+    uint8_t d = (iType -1) & 0x03;
+    if (d == 3) return "dma";                       //bitbang keeps the interrupts off for the whole frame
+    if (d < 2 && r.show.avg > 1000) return "dma";   //the UART FIFO is refilled from show()
+  }
+  #endif
+  if (iType == I_SS_DOT_4 || (iType >= I_HS_DOT_3 && iType <= I_SS_P98_3 && !(iType & 1))) return "hwspi";
+  if (fps < strip.getTargetFps()) return "split";
+  return "ok";
+}
+
+void handleBusBenchmark()
+{
+  if (bbRequest >= 0) {
+    bbFrames = bbRequest;
+    bbRequest = -1;
+    bbBusCount = MIN(busses.getNumBusses(), WLED_MAX_BUSSES);
+    for (uint8_t i = 0; i < WLED_MAX_BUSSES; i++) {
+      bbResults[i].show.reset(); bbResults[i].wait.reset(); bbResults[i].lost = 0;
+    }
+    bbBus = bbStep = 0;
+    bbLostStart = udpInLost;
+    bbRunning = (bbFrames && bbBusCount);
+  }
+  if (!bbRunning) return;
+
+  RENDER_LOCK(); //the strip does not show the busses meanwhile
+  Bus* bus = busses.getBus(bbBus);
+  BusBenchResult& r = bbResults[bbBus];
+  if (bus) {
+    uint32_t start = micros();
+    while (!bus->canShow() && micros() - start < BUSBENCH_WAIT_US) yield(); //the frame the strip sent before
+    start = micros();
+    bus->show();
+    uint32_t shown = micros();
+    r.show.add(shown - start);
+    while (!bus->canShow() && micros() - shown < BUSBENCH_WAIT_US) yield();
+    r.wait.add(micros() - shown);
+  }
+  if (++bbStep < bbFrames) return;
+  bbStep = 0;
+  r.lost = udpInLost - bbLostStart;
+  bbLostStart = udpInLost;
+  if (++bbBus < bbBusCount) return;
+  bbRunning = false;
+  DEBUG_PRINTF("Bus benchmark done, %u busses\n", bbBusCount);
+}
+
+void serializeBusBenchmark(JsonObject root)
+{
+  if (!bbFrames) return;
+  JsonObject bench = root.createNestedObject(F("busbench"));
+  bench[F("run")] = bbRunning;
+  bench["n"]      = bbFrames;
+  JsonArray res = bench.createNestedArray(F("res"));
+  for (uint8_t i = 0; i < bbBusCount; i++) {
+    Bus* bus = busses.getBus(i);
+    if (!bus) break;
+    const BusBenchResult& r = bbResults[i];
+    JsonObject b = res.createNestedObject();
+    b[F("type")] = bus->getType();
+    b[F("len")]  = bus->getLength();
+    uint8_t iType = bus->getDriver();
+    b[F("drv")]  = bbDriverName(iType);
+    serializePerfStat(b.createNestedObject(F("show")), r.show);
+    serializePerfStat(b.createNestedObject(F("wait")), r.wait);
+    uint32_t frame = r.show.avg + r.wait.avg;
+    uint16_t fps = frame ? MIN(1000000 / frame, 1000) : 0;
+    b[F("fps")]  = fps;
+    b[F("lost")] = r.lost;
+    if (r.show.count && iType != I_NONE) b[F("rec")] = bbRecommend(iType, r, fps);
+  }
+}
+#else
+void startBusBenchmark(uint8_t frames) {}
+void handleBusBenchmark() {}
+void serializeBusBenchmark(JsonObject root) {}
+#endif
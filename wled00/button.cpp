@@ -160,7 +160,7 @@ void handleAnalog(uint8_t b)
       // effect speed
       effectSpeed = aRead;
       effectChanged = true;
-      for (uint8_t i = 0; i < strip.getMaxSegments(); i++) {
+      for (uint8_t i = 0; i < strip.getSegmentCount(); i++) {
         WS2812FX::Segment& seg = strip.getSegment(i);
         if (!seg.isSelected()) continue;
         seg.speed = effectSpeed;
@@ -169,7 +169,7 @@ void handleAnalog(uint8_t b)
       // effect intensity
       effectIntensity = aRead;
       effectChanged = true;
-      for (uint8_t i = 0; i < strip.getMaxSegments(); i++) {
+      for (uint8_t i = 0; i < strip.getSegmentCount(); i++) {
         WS2812FX::Segment& seg = strip.getSegment(i);
         if (!seg.isSelected()) continue;
         seg.intensity = effectIntensity;
@@ -178,7 +178,7 @@ void handleAnalog(uint8_t b)
       // selected palette
       effectPalette = map(aRead, 0, 252, 0, strip.getPaletteCount()-1);
       effectChanged = true;
-      for (uint8_t i = 0; i < strip.getMaxSegments(); i++) {
+      for (uint8_t i = 0; i < strip.getSegmentCount(); i++) {
         WS2812FX::Segment& seg = strip.getSegment(i);
         if (!seg.isSelected()) continue;
         seg.palette = effectPalette;
@@ -207,6 +207,132 @@ void handleAnalog(uint8_t b)
   colorUpdated(CALL_MODE_BUTTON);
 }
 
+// feeds one level change of a momentary button, t is when it happened
+static void handleButtonEdge(uint8_t b, bool pressed, unsigned long t)
+{
+  //if 350ms elapsed between last short press release and this edge it was a short press
+  if (buttonWaitTime[b] && !buttonPressedBefore[b] && t - buttonWaitTime[b] > WLED_DOUBLE_PRESS) {
+    buttonWaitTime[b] = 0;
+    shortPressAction(b);
+  }
+
+  if (pressed) {
+    powerWake();
+    if (!buttonPressedBefore[b]) buttonPressedTime[b] = t;
+    buttonPressedBefore[b] = true;
+    return;
+  }
+  if (!buttonPressedBefore[b]) return;
+
+  //released
+  long dur = t - buttonPressedTime[b];
+  buttonPressedBefore[b] = false;
+  if (dur < WLED_DEBOUNCE_THRESHOLD) return; //too short "press", debounce
+  bool doublePress = buttonWaitTime[b]; //did we have a short press before?
+  buttonWaitTime[b] = 0;
+
+  if (b == 0 && dur > WLED_LONG_AP) { //long press on button 0 (when released)
+    WLED::instance().initAP(true);
+  } else if (!buttonLongPressed[b]) {
+    if (dur > WLED_LONG_PRESS) { //press and release both happened since the last loop()
+      longPressAction(b);
+    } else if (b == 0 && !macroDoublePress[b]) { //don't wait for double press on button 0 if no double press macro set
+      shortPressAction(b);
+    } else { //double press if less than 350 ms between current press and previous short press release (buttonWaitTime!=0)
+      if (doublePress) {
+        doublePressAction(b);
+      } else {
+        buttonWaitTime[b] = t;
+      }
+    }
+  }
+  buttonLongPressed[b] = false;
+}
+
+// long press and pending short press, which fire while no edge happens
+static void handleButtonTimers(uint8_t b, unsigned long now)
+{
+  if (buttonPressedBefore[b] && now - buttonPressedTime[b] > WLED_LONG_PRESS) { //long press
+    if (!buttonLongPressed[b]) longPressAction(b);
+    else if (b) { //repeatable action (~3 times per s) on button > 0
+      longPressAction(b);
+      buttonPressedTime[b] = millis() - WLED_LONG_REPEATED_ACTION; //300ms
+    }
+    buttonLongPressed[b] = true;
+  }
+
+  //if 350ms elapsed since last short press release it is a short press
+  if (buttonWaitTime[b] && now - buttonWaitTime[b] > WLED_DOUBLE_PRESS && !buttonPressedBefore[b]) {
+    buttonWaitTime[b] = 0;
+    shortPressAction(b);
+  }
+}
+
+#ifndef WLED_DISABLE_BUTTON_ISR
+/*
+ * Edges of momentary buttons are captured by GPIO interrupt together with their time,
+ * so press, long press and double press timing do not depend on how long loop() takes.
+ */
+#define WLED_BUTTON_EDGES 8 //per button, power of 2
+
+typedef struct ButtonEdge {
+  uint32_t us;   //micros() at the edge
+  bool level;
+} ButtonEdge;
+
+static volatile ButtonEdge btnEdges[WLED_MAX_BUTTONS][WLED_BUTTON_EDGES];
+static volatile uint8_t btnEdgeHead[WLED_MAX_BUTTONS];
+static volatile uint8_t btnEdgeTail[WLED_MAX_BUTTONS];
+static volatile bool btnEdgeOverflow[WLED_MAX_BUTTONS];
+static uint8_t btnIsrPin[WLED_MAX_BUTTONS]; //pin +1 the interrupt is attached to, 0 if polled
+
+static void IRAM_ATTR buttonISR(void* arg)
+{
+  uint8_t b = (uintptr_t)arg;
+  uint8_t head = btnEdgeHead[b];
+  uint8_t next = (head + 1) & (WLED_BUTTON_EDGES -1);
+  if (next == btnEdgeTail[b]) {btnEdgeOverflow[b] = true; return;}
+  btnEdges[b][head].us = micros();
+  btnEdges[b][head].level = digitalRead(btnIsrPin[b] -1);
+  btnEdgeHead[b] = next;
+}
+
+//(re)attach interrupts after the button configuration changed. Touch, switch and analog inputs stay polled
+void attachButtonInterrupts()
+{
+  for (uint8_t b=0; b<WLED_MAX_BUTTONS; b++) {
+    if (btnIsrPin[b]) detachInterrupt(digitalPinToInterrupt(btnIsrPin[b] -1));
+    btnIsrPin[b] = 0;
+    btnEdgeTail[b] = btnEdgeHead[b];
+    btnEdgeOverflow[b] = false;
+    if (btnPin[b]<0 || (buttonType[b] != BTN_TYPE_PUSH && buttonType[b] != BTN_TYPE_PUSH_ACT_HIGH)) continue;
+    if (digitalPinToInterrupt(btnPin[b]) < 0) continue; //e.g. GPIO16 on ESP8266
+    btnIsrPin[b] = btnPin[b] +1;
+    attachInterruptArg(digitalPinToInterrupt(btnPin[b]), buttonISR, (void*)(uintptr_t)b, CHANGE);
+  }
+}
+
+static void handleButtonEdges(uint8_t b)
+{
+  bool activeLevel = (buttonType[b] == BTN_TYPE_PUSH_ACT_HIGH);
+  uint8_t head = btnEdgeHead[b]; //edges up to here happened before the timestamps below
+  unsigned long now = millis();
+  uint32_t us = micros();
+  for (uint8_t i = btnEdgeTail[b]; i != head; i = (i + 1) & (WLED_BUTTON_EDGES -1)) {
+    handleButtonEdge(b, btnEdges[b][i].level == activeLevel, now - (us - btnEdges[b][i].us) / 1000);
+    btnEdgeTail[b] = (i + 1) & (WLED_BUTTON_EDGES -1);
+  }
+  if (btnEdgeOverflow[b]) { //edges were lost, continue from the current level
+    btnEdgeTail[b] = btnEdgeHead[b];
+    btnEdgeOverflow[b] = false;
+    handleButtonEdge(b, isButtonPressed(b), now);
+  }
+  handleButtonTimers(b, now);
+}
+#else
+void attachButtonInterrupts() {}
+#endif
+
 void handleButton()
 {
   static unsigned long lastRead = 0UL;
@@ -231,49 +357,12 @@ void handleButton()
     }
 
     //momentary button logic
-    if (isButtonPressed(b)) { //pressed
-
-      if (!buttonPressedBefore[b]) buttonPressedTime[b] = millis();
-      buttonPressedBefore[b] = true;
-
-      if (millis() - buttonPressedTime[b] > WLED_LONG_PRESS) { //long press
-        if (!buttonLongPressed[b]) longPressAction(b);
-        else if (b) { //repeatable action (~3 times per s) on button > 0
-          longPressAction(b);
-          buttonPressedTime[b] = millis() - WLED_LONG_REPEATED_ACTION; //300ms
-        }
-        buttonLongPressed[b] = true;
-      }
-
-    } else if (!isButtonPressed(b) && buttonPressedBefore[b]) { //released
-
-      long dur = millis() - buttonPressedTime[b];
-      if (dur < WLED_DEBOUNCE_THRESHOLD) {buttonPressedBefore[b] = false; continue;} //too short "press", debounce
-      bool doublePress = buttonWaitTime[b]; //did we have a short press before?
-      buttonWaitTime[b] = 0;
-
-      if (b == 0 && dur > WLED_LONG_AP) { //long press on button 0 (when released)
-        WLED::instance().initAP(true);
-      } else if (!buttonLongPressed[b]) { //short press
-        if (b == 0 && !macroDoublePress[b]) { //don't wait for double press on button 0 if no double press macro set
-          shortPressAction(b);
-        } else { //double press if less than 350 ms between current press and previous short press release (buttonWaitTime!=0)
-          if (doublePress) {
-            doublePressAction(b);
-          } else {
-            buttonWaitTime[b] = millis();
-          }
-        }
-      }
-      buttonPressedBefore[b] = false;
-      buttonLongPressed[b] = false;
-    }
-
-    //if 350ms elapsed since last short press release it is a short press
-    if (buttonWaitTime[b] && millis() - buttonWaitTime[b] > WLED_DOUBLE_PRESS && !buttonPressedBefore[b]) {
-      buttonWaitTime[b] = 0;
-      shortPressAction(b);
-    }
+    #ifndef WLED_DISABLE_BUTTON_ISR
+    if (btnIsrPin[b]) {handleButtonEdges(b); continue;}
+    #endif
+    unsigned long now = millis();
+    handleButtonEdge(b, isButtonPressed(b), now);
+    handleButtonTimers(b, now);
   }
 }
 
@@ -9,6 +9,9 @@
 //simple macro for ArduinoJSON's or syntax
 #define CJSON(a,b) a = b | a
 
+//bus channel (B,G,R,W) of each R,G,B,W entry in the config
+static const uint8_t busChannel[4] = {2, 1, 0, 3};
+
 void getStringFromJson(char* dest, const char* src, size_t len) {
   if (src != nullptr) strlcpy(dest, src, len);
 }
@@ -22,6 +25,7 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
   #ifdef WLED_USE_ETHERNET
   JsonObject ethernet = doc[F("eth")];
   CJSON(ethernetType, ethernet["type"]);
+  CJSON(ethernetOnly, ethernet[F("only")]);
   // NOTE: Ethernet configuration takes priority over other use of pins
   WLED::instance().initEthernet();
   #endif
@@ -81,6 +85,17 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
   CJSON(strip.ablMilliampsMax, hw_led[F("maxpwr")]);
   CJSON(strip.milliampsPerLed, hw_led[F("ledma")]);
   CJSON(strip.rgbwMode, hw_led[F("rgbwm")]);
+  JsonArray hw_led_wb = hw_led[F("wb")]; //white balance R,G,B,W
+  if (!hw_led_wb.isNull()) {
+    uint8_t wb[4]; //bus order B,G,R,W
+    for (uint8_t i = 0; i < 4; i++) wb[i < 3 ? 2-i : 3] = hw_led_wb[i] | 255;
+    busses.setWhiteBalance(wb);
+  }
+  JsonArray hw_led_cct = hw_led[F("cct")]; //white points of CCT busses, warm and cold white in K
+  if (!hw_led_cct.isNull()) busses.setWhitePoints(hw_led_cct[0] | WLED_CCT_WARM_K, hw_led_cct[1] | WLED_CCT_COLD_K);
+  busses.setDithering(hw_led[F("dith")] | busses.getDithering());
+  uint8_t fps = hw_led[F("fps")] | strip.getTargetFps();
+  strip.setTargetFps(fps);
 
   JsonArray ins = hw_led["ins"];
   
@@ -111,6 +126,16 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
       ledType |= refresh << 7;  // hack bit 7 to indicate strip requires off refresh
       s++;
       BusConfig bc = BusConfig(ledType, pins, start, length, colorOrder, reversed, skipFirst);
+      bc.milliAmpsMax = elm[F("maxpwr")] | 0;
+      bc.milliAmpsPerLed = elm[F("ledma")] | 0;
+      bc.rgbw = elm[F("rgbw")] | false; //only network busses take it from here
+      bc.maxFps = elm[F("fps")] | 0;
+      bc.priority = elm[F("prio")] | 0;
+      JsonArray cal = elm[F("cal")]; //color correction, rows R,G,B(,W) of 3 or 4 factors each
+      uint8_t n = (cal.size() == 16) ? 4 : (cal.size() == 9) ? 3 : 0;
+      for (uint8_t i = 0; i < n*n; i++) {
+        bc.matrix[busChannel[i / n] * 4 + busChannel[i % n]] = constrain((int)roundf(cal[i].as<float>() * 256.0f), -1024, 1024);
+      }
       mem += BusManager::memUsage(bc);
       if (mem <= MAX_LED_MEMORY && busses.getNumBusses() <= WLED_MAX_BUSSES) busses.add(bc);  // finalization will be done in WLED::beginStrip()
     }
@@ -164,6 +189,7 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
     }
   }
   CJSON(touchThreshold,btn_obj[F("tt")]);
+  attachButtonInterrupts();
   CJSON(buttonPublishMqtt,btn_obj["mqtt"]);
 
   int hw_ir_pin = hw["ir"]["pin"] | -2; // 4
@@ -192,6 +218,9 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
 
   //int hw_status_pin = hw[F("status")]["pin"]; // -1
 
+  CJSON(serialBaud, hw[F("baud")]);
+  updateBaudRate(serialBaud);
+
   JsonObject light = doc[F("light")];
   CJSON(briMultiplier, light[F("scale-bri")]);
   CJSON(strip.paletteBlend, light[F("pal-mode")]);
@@ -203,6 +232,7 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
   else if (light_gc_bri > 0.5) strip.gammaCorrectBri = false;
   if (light_gc_col > 1.5) strip.gammaCorrectCol = true;
   else if (light_gc_col > 0.5) strip.gammaCorrectCol = false;
+  CJSON(strip.gammaCorrectOut, light["gc"][F("out")]);
 
   JsonObject light_tr = light[F("tr")];
   CJSON(fadeTransition, light_tr[F("mode")]);
@@ -229,12 +259,19 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
   JsonObject if_sync = interfaces[F("sync")];
   CJSON(udpPort, if_sync[F("port0")]); // 21324
   CJSON(udpPort2, if_sync[F("port1")]); // 65506
+  CJSON(syncMulticast, if_sync[F("mc")]);
+  #ifdef WLED_ENABLE_ESPNOW
+  JsonObject if_espnow = if_sync[F("espnow")];
+  CJSON(enableESPNow, if_espnow["en"]);
+  getStringFromJson(linkedRemote, if_espnow[F("remote")], 13);
+  #endif
 
   JsonObject if_sync_recv = if_sync["recv"];
   CJSON(receiveNotificationBrightness, if_sync_recv["bri"]);
   CJSON(receiveNotificationColor, if_sync_recv["col"]);
   CJSON(receiveNotificationEffects, if_sync_recv["fx"]);
   CJSON(receiveGroups, if_sync_recv["grp"]);
+  CJSON(receiveAudioSync, if_sync_recv[F("audio")]);
   //! following line might be a problem if called after boot
   receiveNotifications = (receiveNotificationBrightness || receiveNotificationColor || receiveNotificationEffects);
 
@@ -247,11 +284,15 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
   CJSON(notifyHue, if_sync_send["hue"]);
   CJSON(notifyMacro, if_sync_send["macro"]);
   CJSON(notifyTwice, if_sync_send[F("twice")]);
+  CJSON(syncPresetIds, if_sync_send[F("pid")]);
+  CJSON(sendAudioSync, if_sync_send[F("audio")]);
+  CJSON(notifyMinInterval, if_sync_send[F("ival")]);
   CJSON(syncGroups, if_sync_send["grp"]);
 
   JsonObject if_nodes = interfaces["nodes"];
   CJSON(nodeListEnabled, if_nodes[F("list")]);
   CJSON(nodeBroadcastEnabled, if_nodes[F("bcast")]);
+  CJSON(vstripFollow, if_nodes[F("vsf")]);
 
   JsonObject if_live = interfaces["live"];
   CJSON(receiveDirect, if_live["en"]);
@@ -264,6 +305,15 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
   CJSON(e131SkipOutOfSequence, if_live_dmx[F("seqskip")]);
   CJSON(DMXAddress, if_live_dmx[F("addr")]);
   CJSON(DMXMode, if_live_dmx[F("mode")]);
+  CJSON(e131MergeMode, if_live_dmx[F("merge")]);
+  JsonArray if_live_dmx_routes = if_live_dmx[F("routes")];
+  if (!if_live_dmx_routes.isNull()) deserializeE131Routes(if_live_dmx_routes);
+  e131RoutesDirty = true;
+
+  JsonObject if_live_out = if_live[F("out")];
+  CJSON(e131OutUniverse, if_live_out[F("uni")]);
+  CJSON(e131OutAddress, if_live_out[F("addr")]);
+  CJSON(artnetOutSync, if_live_out[F("sync")]);
 
   tdd = if_live[F("timeout")] | -1;
   if (tdd >= 0) realtimeTimeoutMs = tdd * 100;
@@ -295,6 +345,7 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
   getStringFromJson(mqttUser, if_mqtt[F("user")], 41);
   getStringFromJson(mqttPass, if_mqtt["psk"], 65); //normally not present due to security
   getStringFromJson(mqttClientID, if_mqtt[F("cid")], 41);
+  CJSON(mqttPublishInterval, if_mqtt[F("ival")]);
 
   getStringFromJson(mqttDeviceTopic, if_mqtt[F("topics")][F("device")], 33); // "wled/test"
   getStringFromJson(mqttGroupTopic, if_mqtt[F("topics")][F("group")], 33); // ""
@@ -304,6 +355,7 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
   JsonObject if_hue = interfaces["hue"];
   CJSON(huePollingEnabled, if_hue["en"]);
   CJSON(huePollLightId, if_hue["id"]);
+  CJSON(hueStreamEnabled, if_hue[F("stream")]);
   tdd = if_hue[F("iv")] | -1;
   if (tdd >= 2) huePollIntervalMs = tdd * 100;
 
@@ -374,6 +426,7 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
 
     it++;
   }
+  invalidateTimers();
 
   JsonObject ota = doc["ota"];
   const char* pwd = ota["psk"]; //normally not present due to security
@@ -394,6 +447,7 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
   CJSON(DMXGap,dmx[F("gap")]);
   CJSON(DMXStart, dmx["start"]);
   CJSON(DMXStartLED,dmx[F("start-led")]);
+  CJSON(DMXFps, dmx[F("fps")]);
 
   JsonArray dmx_fixmap = dmx[F("fixmap")];
   it = 0;
@@ -402,6 +456,7 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
     CJSON(DMXFixtureMap[i],dmx_fixmap[i]);
     it++;
   }
+  doBuildDMXMap = true;
   #endif
 
   DEBUG_PRINTLN(F("Starting usermod config."));
@@ -416,6 +471,105 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
   return (doc["sv"] | true);
 }
 
+#ifndef WLED_DISABLE_BINARY_CONFIG
+/*
+ * /cfg.bin is a MessagePack copy of the last written configuration, parsed at boot instead of /cfg.json.
+ * It is only used if it was written by this build along with a cfg.json of the current size and its checksum matches,
+ * so an uploaded or edited cfg.json and firmware updates fall back to the JSON file.
+ */
+#define CFG_BIN_FILE  "/cfg.bin"
+#define CFG_BIN_MAGIC 0x31434257 //"WBC1"
+
+typedef struct CfgBinHeader {
+  uint32_t magic;
+  uint32_t build;    //VERSION
+  uint32_t jsonSize; //size of the cfg.json written along with it
+  uint32_t docSize;  //memory usage of the document it was serialized from
+  uint32_t len;      //MessagePack data following the header
+  uint32_t crc;      //FNV-1a of the MessagePack data
+} CfgBinHeader;
+
+static uint32_t cfgBinCrc = 0; //checksum of the configuration currently on FS, 0 if unknown
+
+static uint32_t cfgChecksum(const uint8_t* data, size_t len)
+{
+  uint32_t h = 2166136261UL;
+  for (size_t i = 0; i < len; i++) h = (h ^ data[i]) * 16777619UL;
+  return h;
+}
+
+static size_t cfgJsonSize()
+{
+  File f = WLED_FS.open("/cfg.json", "r");
+  size_t size = f ? f.size() : 0;
+  f.close();
+  return size;
+}
+
+static bool readConfigSnapshot()
+{
+  File f = WLED_FS.open(CFG_BIN_FILE, "r");
+  if (!f) return false;
+  CfgBinHeader hdr;
+  bool valid = f.read((uint8_t*)&hdr, sizeof(hdr)) == sizeof(hdr) && hdr.magic == CFG_BIN_MAGIC && hdr.build == VERSION
+            && hdr.len == f.size() - sizeof(hdr) && hdr.jsonSize == cfgJsonSize();
+  uint8_t* data = valid ? (uint8_t*) malloc(hdr.len) : nullptr;
+  if (data && (f.read(data, hdr.len) != hdr.len || cfgChecksum(data, hdr.len) != hdr.crc)) valid = false;
+  f.close();
+  if (!data || !valid) {free(data); return false;}
+
+  DEBUG_PRINTLN(F("Reading settings from /cfg.bin..."));
+  bool success;
+  { //sized for this configuration instead of JSON_BUFFER_SIZE, strings stay in the data buffer (zero-copy)
+    PSRAMDynamicJsonDocument doc(hdr.docSize + 64);
+    success = !deserializeMsgPack(doc, (char*)data, hdr.len);
+    if (success) {
+      cfgBinCrc = hdr.crc;
+      deserializeConfig(doc.as<JsonObject>(), true);
+    }
+  }
+  free(data);
+  return success;
+}
+
+//cfg.json was replaced by other means than serializeConfig()
+void invalidateConfigSnapshot()
+{
+  WLED_FS.remove(CFG_BIN_FILE);
+  cfgBinCrc = 0;
+}
+
+//MessagePack copy of the document being saved, also tells whether the configuration changed at all
+class ConfigSnapshot {
+  public:
+    ConfigSnapshot(JsonDocument& doc) {
+      hdr.magic = CFG_BIN_MAGIC;
+      hdr.build = VERSION;
+      hdr.docSize = doc.memoryUsage();
+      hdr.len = measureMsgPack(doc);
+      data = (uint8_t*) malloc(hdr.len);
+      if (!data) return;
+      serializeMsgPack(doc, data, hdr.len);
+      hdr.crc = cfgChecksum(data, hdr.len);
+    }
+    ~ConfigSnapshot() { free(data); }
+    bool unchanged() { return data && cfgBinCrc && hdr.crc == cfgBinCrc && cfgJsonSize(); }
+    void save(size_t jsonSize) {
+      hdr.jsonSize = jsonSize;
+      File f;
+      if (data) f = WLED_FS.open(CFG_BIN_FILE, "w");
+      bool ok = f && f.write((uint8_t*)&hdr, sizeof(hdr)) == sizeof(hdr) && f.write(data, hdr.len) == hdr.len;
+      f.close();
+      if (ok) cfgBinCrc = hdr.crc;
+      else invalidateConfigSnapshot(); //boot must not pick up an older one
+    }
+  private:
+    CfgBinHeader hdr;
+    uint8_t* data = nullptr;
+};
+
+#endif
+
 void deserializeConfigFromFS() {
   bool success = deserializeConfigSec();
   if (!success) { //if file does not exist, try reading from EEPROM
@@ -423,7 +577,11 @@ void deserializeConfigFromFS() {
     return;
   }
 
-  DynamicJsonDocument doc(JSON_BUFFER_SIZE);
+  #ifndef WLED_DISABLE_BINARY_CONFIG
+  if (readConfigSnapshot()) return;
+  #endif
+
+  PSRAMDynamicJsonDocument doc(JSON_BUFFER_SIZE);
 
   DEBUG_PRINTLN(F("Reading settings from /cfg.json..."));
 
@@ -436,6 +594,10 @@ void deserializeConfigFromFS() {
   // NOTE: This routine deserializes *and* applies the configuration
   //       Therefore, must also initialize ethernet from this function
   deserializeConfig(doc.as<JsonObject>(), true);  
+
+  #ifndef WLED_DISABLE_BINARY_CONFIG
+  if (!cfgBinCrc) ConfigSnapshot(doc).save(cfgJsonSize()); //next boot can skip the JSON, unless usermods saved already
+  #endif
 }
 
 void serializeConfig() {
@@ -443,7 +605,7 @@ void serializeConfig() {
 
   DEBUG_PRINTLN(F("Writing settings to /cfg.json..."));
 
-  DynamicJsonDocument doc(JSON_BUFFER_SIZE);
+  PSRAMDynamicJsonDocument doc(JSON_BUFFER_SIZE);
 
   JsonArray rev = doc.createNestedArray("rev");
   rev.add(1); //major settings revision
@@ -494,6 +656,7 @@ void serializeConfig() {
   #ifdef WLED_USE_ETHERNET
   JsonObject ethernet = doc.createNestedObject("eth");
   ethernet["type"] = ethernetType;
+  ethernet[F("only")] = ethernetOnly;
   if (ethernetType != WLED_ETH_NONE && ethernetType < WLED_NUM_ETH_TYPES) {
     JsonArray pins = ethernet.createNestedArray("pin");
     for (uint8_t p=0; p<WLED_ETH_RSVD_PINS_COUNT; p++) pins.add(esp32_nonconfigurable_ethernet_pins[p].pin);
@@ -522,6 +685,13 @@ void serializeConfig() {
   hw_led[F("maxpwr")] = strip.ablMilliampsMax;
   hw_led[F("ledma")] = strip.milliampsPerLed;
   hw_led[F("rgbwm")] = strip.rgbwMode;
+  JsonArray hw_led_wb = hw_led.createNestedArray(F("wb"));
+  const uint8_t* wb = busses.getWhiteBalance();
+  hw_led_wb.add(wb[2]); hw_led_wb.add(wb[1]); hw_led_wb.add(wb[0]); hw_led_wb.add(wb[3]);
+  JsonArray hw_led_cct = hw_led.createNestedArray(F("cct"));
+  hw_led_cct.add(busses.getWhitePointWarm()); hw_led_cct.add(busses.getWhitePointCold());
+  hw_led[F("dith")] = busses.getDithering();
+  hw_led[F("fps")] = strip.getTargetFps();
 
   JsonArray hw_led_ins = hw_led.createNestedArray("ins");
 
@@ -541,6 +711,15 @@ void serializeConfig() {
     ins["type"] = bus->getType() & 0x7F;;
     ins["ref"] = bus->isOffRefreshRequired();
     ins[F("rgbw")] = bus->isRgbw();
+    if (bus->milliAmpsMax) ins[F("maxpwr")] = bus->milliAmpsMax;
+    if (bus->milliAmpsPerLed) ins[F("ledma")] = bus->milliAmpsPerLed;
+    if (bus->getMaxFps()) ins[F("fps")] = bus->getMaxFps();
+    if (bus->priority) ins[F("prio")] = bus->priority;
+    int16_t m[16];
+    if (bus->getColorMatrix(m)) {
+      JsonArray cal = ins.createNestedArray(F("cal"));
+      for (uint8_t i = 0; i < 16; i++) cal.add(m[busChannel[i / 4] * 4 + busChannel[i % 4]] / 256.0f);
+    }
   }
 
   // button(s)
@@ -571,6 +750,8 @@ void serializeConfig() {
   hw_relay["pin"] = rlyPin;
   hw_relay["rev"] = !rlyMde;
 
+  hw[F("baud")] = serialBaud;
+
   //JsonObject hw_status = hw.createNestedObject("status");
   //hw_status["pin"] = -1;
 
@@ -582,6 +763,7 @@ void serializeConfig() {
   JsonObject light_gc = light.createNestedObject("gc");
   light_gc["bri"] = (strip.gammaCorrectBri) ? 2.8 : 1.0;
   light_gc["col"] = (strip.gammaCorrectCol) ? 2.8 : 1.0;
+  light_gc[F("out")] = strip.gammaCorrectOut;
 
   JsonObject light_tr = light.createNestedObject("tr");
   light_tr[F("mode")] = fadeTransition;
@@ -604,12 +786,19 @@ void serializeConfig() {
   JsonObject if_sync = interfaces.createNestedObject("sync");
   if_sync[F("port0")] = udpPort;
   if_sync[F("port1")] = udpPort2;
+  if_sync[F("mc")] = syncMulticast;
+  #ifdef WLED_ENABLE_ESPNOW
+  JsonObject if_espnow = if_sync.createNestedObject(F("espnow"));
+  if_espnow["en"] = enableESPNow;
+  if_espnow[F("remote")] = linkedRemote;
+  #endif
 
   JsonObject if_sync_recv = if_sync.createNestedObject("recv");
   if_sync_recv["bri"] = receiveNotificationBrightness;
   if_sync_recv["col"] = receiveNotificationColor;
   if_sync_recv["fx"] = receiveNotificationEffects;
   if_sync_recv["grp"] = receiveGroups;
+  if_sync_recv[F("audio")] = receiveAudioSync;
 
   JsonObject if_sync_send = if_sync.createNestedObject("send");
   if_sync_send[F("dir")] = notifyDirect;
@@ -618,11 +807,15 @@ void serializeConfig() {
   if_sync_send["hue"] = notifyHue;
   if_sync_send["macro"] = notifyMacro;
   if_sync_send[F("twice")] = notifyTwice;
+  if_sync_send[F("pid")] = syncPresetIds;
+  if_sync_send[F("audio")] = sendAudioSync;
+  if_sync_send[F("ival")] = notifyMinInterval;
   if_sync_send["grp"] = syncGroups;
 
   JsonObject if_nodes = interfaces.createNestedObject("nodes");
   if_nodes[F("list")] = nodeListEnabled;
   if_nodes[F("bcast")] = nodeBroadcastEnabled;
+  if_nodes[F("vsf")] = vstripFollow;
 
   JsonObject if_live = interfaces.createNestedObject("live");
   if_live["en"] = receiveDirect;
@@ -634,6 +827,13 @@ void serializeConfig() {
   if_live_dmx[F("seqskip")] = e131SkipOutOfSequence;
   if_live_dmx[F("addr")] = DMXAddress;
   if_live_dmx[F("mode")] = DMXMode;
+  if_live_dmx[F("merge")] = e131MergeMode;
+  serializeE131Routes(if_live_dmx.createNestedArray(F("routes")));
+
+  JsonObject if_live_out = if_live.createNestedObject("out");
+  if_live_out[F("uni")] = e131OutUniverse;
+  if_live_out[F("addr")] = e131OutAddress;
+  if_live_out[F("sync")] = artnetOutSync;
 
   if_live[F("timeout")] = realtimeTimeoutMs / 100;
   if_live[F("maxbri")] = arlsForceMaxBri;
@@ -662,6 +862,7 @@ void serializeConfig() {
   if_mqtt[F("user")] = mqttUser;
   if_mqtt[F("pskl")] = strlen(mqttPass);
   if_mqtt[F("cid")] = mqttClientID;
+  if_mqtt[F("ival")] = mqttPublishInterval;
 
   JsonObject if_mqtt_topics = if_mqtt.createNestedObject(F("topics"));
   if_mqtt_topics[F("device")] = mqttDeviceTopic;
@@ -672,6 +873,7 @@ void serializeConfig() {
   JsonObject if_hue = interfaces.createNestedObject("hue");
   if_hue["en"] = huePollingEnabled;
   if_hue["id"] = huePollLightId;
+  if_hue[F("stream")] = hueStreamEnabled;
   if_hue[F("iv")] = huePollIntervalMs / 100;
 
   JsonObject if_hue_recv = if_hue.createNestedObject("recv");
@@ -736,6 +938,7 @@ void serializeConfig() {
   dmx[F("gap")] = DMXGap;
   dmx["start"] = DMXStart;
   dmx[F("start-led")] = DMXStartLED;
+  dmx[F("fps")] = DMXFps;
 
   JsonArray dmx_fixmap = dmx.createNestedArray(F("fixmap"));
   for (byte i = 0; i < 15; i++)
@@ -745,16 +948,27 @@ void serializeConfig() {
   JsonObject usermods_settings = doc.createNestedObject("um");
   usermods.addToConfig(usermods_settings);
 
+  #ifndef WLED_DISABLE_BINARY_CONFIG
+  ConfigSnapshot snapshot(doc);
+  //e.g. after a bus re-init that ended up with the same configuration
+  if (snapshot.unchanged()) {DEBUG_PRINTLN(F("Settings unchanged")); return;}
+  #endif
+
   File f = WLED_FS.open("/cfg.json", "w");
-  if (f) serializeJson(doc, f);
+  size_t jsonSize = 0;
+  if (f) jsonSize = serializeJson(doc, f);
   f.close();
+
+  #ifndef WLED_DISABLE_BINARY_CONFIG
+  snapshot.save(jsonSize);
+  #endif
 }
 
 //settings in /wsec.json, not accessible via webserver, for passwords and tokens
 bool deserializeConfigSec() {
   DEBUG_PRINTLN(F("Reading settings from /wsec.json..."));
 
-  DynamicJsonDocument doc(JSON_BUFFER_SIZE);
+  PSRAMDynamicJsonDocument doc(JSON_BUFFER_SIZE);
 
   bool success = readObjectFromFile("/wsec.json", nullptr, &doc);
   if (!success) return false;
@@ -795,7 +1009,7 @@ bool deserializeConfigSec() {
 void serializeConfigSec() {
   DEBUG_PRINTLN(F("Writing settings to /wsec.json..."));
 
-  DynamicJsonDocument doc(JSON_BUFFER_SIZE);
+  PSRAMDynamicJsonDocument doc(JSON_BUFFER_SIZE);
 
   JsonObject nw = doc.createNestedObject("nw");
 
@@ -115,70 +115,69 @@ void colorCTtoRGB(uint16_t mired, byte* rgb) //white spectrum to rgb, bins
 }
 
 #ifndef WLED_DISABLE_HUESYNC
-void colorXYtoRGB(float x, float y, byte* rgb) //coordinates to rgb (https://www.developers.meethue.com/documentation/color-conversions-rgb-xy)
+//sRGB encoding: linear level (1/65536) from which each 8 bit output value 1-255 is reached
+static const uint16_t srgbThresholds[255] PROGMEM = {
+     20,    40,    60,    80,   100,   120,   140,   160,   180,   199,   220,   241,   264,   288,   314,
+    340,   368,   397,   427,   459,   492,   526,   562,   599,   638,   677,   719,   762,   806,   851,
+    898,   947,   997,  1049,  1102,  1157,  1213,  1271,  1330,  1391,  1454,  1518,  1584,  1651,  1720,
+   1791,  1863,  1938,  2013,  2091,  2170,  2251,  2334,  2418,  2504,  2592,  2682,  2773,  2867,  2962,
+   3059,  3157,  3258,  3360,  3465,  3571,  3679,  3789,  3901,  4014,  4130,  4247,  4367,  4488,  4612,
+   4737,  4864,  4993,  5125,  5258,  5393,  5530,  5669,  5811,  5954,  6099,  6247,  6396,  6547,  6701,
+   6857,  7014,  7174,  7336,  7500,  7666,  7835,  8005,  8178,  8352,  8529,  8708,  8889,  9073,  9258,
+   9446,  9636,  9828, 10023, 10219, 10418, 10619, 10823, 11028, 11236, 11446, 11659, 11873, 12090, 12310,
+  12531, 12755, 12981, 13210, 13441, 13674, 13909, 14147, 14387, 14630, 14875, 15122, 15372, 15624, 15879,
+  16136, 16395, 16657, 16921, 17187, 17456, 17728, 18002, 18278, 18557, 18838, 19122, 19408, 19697, 19988,
+  20282, 20578, 20877, 21178, 21482, 21788, 22097, 22408, 22722, 23039, 23358, 23679, 24003, 24330, 24659,
+  24991, 25326, 25663, 26002, 26345, 26689, 27037, 27387, 27740, 28095, 28453, 28814, 29177, 29543, 29912,
+  30283, 30657, 31034, 31413, 31795, 32180, 32568, 32958, 33351, 33746, 34144, 34546, 34949, 35356, 35765,
+  36177, 36592, 37009, 37430, 37853, 38279, 38707, 39139, 39573, 40010, 40450, 40892, 41338, 41786, 42237,
+  42691, 43148, 43607, 44070, 44535, 45003, 45474, 45948, 46425, 46904, 47387, 47872, 48360, 48851, 49345,
+  49842, 50342, 50845, 51350, 51859, 52370, 52885, 53402, 53923, 54446, 54972, 55501, 56033, 56568, 57106,
+  57647, 58191, 58738, 59288, 59841, 60397, 60956, 61518, 62083, 62651, 63222, 63796, 64373, 64953, 65535
+};
+
+//linear 0-1 in 1/65536 to the sRGB encoded 8 bit value, by binary search of the thresholds
+static uint8_t linearToSrgb8(int32_t v)
 {
-  float z = 1.0f - x - y;
-  float X = (1.0f / y) * x;
-  float Z = (1.0f / y) * z;
-  float r = (int)255*(X * 1.656492f - 0.354851f - Z * 0.255038f);
-  float g = (int)255*(-X * 0.707196f + 1.655397f + Z * 0.036152f);
-  float b = (int)255*(X * 0.051713f - 0.121364f + Z * 1.011530f);
-  if (r > b && r > g && r > 1.0f) {
-    // red is too big
-    g = g / r;
-    b = b / r;
-    r = 1.0f;
-  } else if (g > b && g > r && g > 1.0f) {
-    // green is too big
-    r = r / g;
-    b = b / g;
-    g = 1.0f;
-  } else if (b > r && b > g && b > 1.0f) {
-    // blue is too big
-    r = r / b;
-    g = g / b;
-    b = 1.0f;
+  if (v <= 0) return 0;
+  uint8_t out = 0;
+  for (uint8_t step = 128; step; step >>= 1) {
+    if (v >= (int32_t)pgm_read_word(&srgbThresholds[out + step - 1])) out += step;
   }
-  // Apply gamma correction
-  r = r <= 0.0031308f ? 12.92f * r : (1.0f + 0.055f) * pow(r, (1.0f / 2.4f)) - 0.055f;
-  g = g <= 0.0031308f ? 12.92f * g : (1.0f + 0.055f) * pow(g, (1.0f / 2.4f)) - 0.055f;
-  b = b <= 0.0031308f ? 12.92f * b : (1.0f + 0.055f) * pow(b, (1.0f / 2.4f)) - 0.055f;
-
-  if (r > b && r > g) {
-    // red is biggest
-    if (r > 1.0f) {
-      g = g / r;
-      b = b / r;
-      r = 1.0f;
-    }
-  } else if (g > b && g > r) {
-    // green is biggest
-    if (g > 1.0f) {
-      r = r / g;
-      b = b / g;
-      g = 1.0f;
-    }
-  } else if (b > r && b > g) {
-    // blue is biggest
-    if (b > 1.0f) {
-      r = r / b;
-      g = g / b;
-      b = 1.0f;
-    }
+  return out;
+}
+
+void colorXYtoRGB(float x, float y, byte* rgb) //coordinates to rgb (https://www.developers.meethue.com/documentation/color-conversions-rgb-xy)
+{
+  //fixed point in 1/65536, the brightest channel is scaled to full
+  if (y <= 0.0f) return;
+  int32_t xq = x * 65536.0f, yq = y * 65536.0f;
+  int64_t X = ((int64_t)xq << 16) / yq;
+  int64_t Z = ((int64_t)(65536 - xq - yq) << 16) / yq;
+  int64_t c[3];
+  c[0] = ( X * 108560 - 23256 * 65536LL - Z * 16714) >> 16;
+  c[1] = (-X * 46347 + 108488 * 65536LL + Z * 2369) >> 16;
+  c[2] = ( X * 3389 - 7954 * 65536LL + Z * 66292) >> 16;
+  int64_t m = c[0] > c[1] ? c[0] : c[1];
+  if (c[2] > m) m = c[2];
+  for (uint8_t i = 0; i < 3; i++) {
+    int64_t v = (m * 255 > 65536) ? c[i] * 65536 / m : c[i] * 255; //as the float version, which scaled by 255 first
+    rgb[i] = linearToSrgb8(v > 65536 ? 65536 : v);
   }
-  rgb[0] = 255.0*r;
-  rgb[1] = 255.0*g;
-  rgb[2] = 255.0*b;
   if (strip.isRgbw && strip.rgbwMode == RGBW_MODE_LEGACY) colorRGBtoRGBW(col);
 }
 
 void colorRGBtoXY(byte* rgb, float* xy) //rgb to coordinates (https://www.developers.meethue.com/documentation/color-conversions-rgb-xy)
 {
-  float X = rgb[0] * 0.664511f + rgb[1] * 0.154324f + rgb[2] * 0.162028f;
-  float Y = rgb[0] * 0.283881f + rgb[1] * 0.668433f + rgb[2] * 0.047685f;
-  float Z = rgb[0] * 0.000088f + rgb[1] * 0.072310f + rgb[2] * 0.986039f;
-  xy[0] = X / (X + Y + Z);
-  xy[1] = Y / (X + Y + Z);
+  //coefficients in 1/65536
+  uint32_t X = rgb[0] * 43549UL + rgb[1] * 10114UL + rgb[2] * 10619UL;
+  uint32_t Y = rgb[0] * 18604UL + rgb[1] * 43806UL + rgb[2] *  3125UL;
+  uint32_t Z = rgb[0] *     6UL + rgb[1] *  4739UL + rgb[2] * 64621UL;
+  uint32_t sum = X + Y + Z;
+  if (!sum) { xy[0] = xy[1] = 0.0f; return; }
+  float f = 1.0f / sum;
+  xy[0] = X * f;
+  xy[1] = Y * f;
 }
 #endif // WLED_DISABLE_HUESYNC
 
@@ -244,3 +243,76 @@ void colorRGBtoRGBW(byte* rgb) //rgb to rgbw (http://codewelt.com/rgbw). (RGBW_M
   float sat = 100.0f * ((high - low) / high);;   // maximum saturation is 100  (corrected from 255)
   rgb[3] = (byte)((255.0f - sat) / 255.0f * (rgb[0] + rgb[1] + rgb[2]) / 3);
 }
+
+/*
+ * Batched kernels for segment framebuffers (packed WRGB, one uint32_t per pixel)
+ * Red/blue and white/green are processed as two 16 bit lanes per 32 bit word (SWAR).
+ * Buffer kernels return true if any pixel changed.
+ */
+
+//scale8() on all four channels, (c * (scale+1)) >> 8 like FastLED's fixed scale8
+static inline uint32_t swarScale8(uint32_t c, uint16_t scale)
+{
+  return ((((c & 0x00FF00FF) * scale) >> 8) & 0x00FF00FF) | (((c >> 8) & 0x00FF00FF) * scale & 0xFF00FF00);
+}
+
+//qadd8() on all four channels
+static inline uint32_t swarAdd8(uint32_t a, uint32_t b)
+{
+  uint32_t rb = (a & 0x00FF00FF) + (b & 0x00FF00FF);
+  uint32_t wg = ((a >> 8) & 0x00FF00FF) + ((b >> 8) & 0x00FF00FF);
+  rb |= ((rb >> 8) & 0x00010001) * 0xFF; //saturate lanes that overflowed
+  wg |= ((wg >> 8) & 0x00010001) * 0xFF;
+  return (rb & 0x00FF00FF) | ((wg & 0x00FF00FF) << 8);
+}
+
+//one step of fade_out(): every channel moves towards target by diff / (rate + 1.1), at least by 1
+//inv is the reciprocal (1<<24) / (10*rate + 11) + 1, which is exact for 8 bit channel differences
+uint32_t fadeColor(uint32_t c, uint32_t target, uint32_t inv)
+{
+  uint32_t out = 0;
+  for (uint8_t s = 0; s < 32; s += 8) {
+    int c1 = (c >> s) & 0xFF;
+    int diff = int((target >> s) & 0xFF) - c1;
+    if (diff) {
+      int q = (uint32_t(abs(diff) * 10) * inv) >> 24;
+      c1 += (diff < 0) ? -q - 1 : q + 1;
+    }
+    out |= uint32_t(c1) << s;
+  }
+  return out;
+}
+
+bool fadeBuffer(uint32_t* buf, uint16_t len, uint32_t target, uint32_t inv)
+{
+  bool changed = false;
+  for (uint16_t i = 0; i < len; i++) {
+    uint32_t c = buf[i];
+    if (c == target) continue; //already faded, the common case on mostly dark strips
+    buf[i] = fadeColor(c, target, inv);
+    changed = true;
+  }
+  return changed;
+}
+
+//FastLED blur1d(), anything that is not RGB is dropped
+bool blurBuffer(uint32_t* buf, uint16_t len, uint8_t amount)
+{
+  uint16_t keep = 256 - amount; //(255 - amount) + 1
+  uint16_t seep = (amount >> 1) + 1;
+  uint32_t carryover = 0;
+  bool changed = false;
+  for (uint16_t i = 0; i < len; i++) {
+    uint32_t orig = buf[i];
+    uint32_t cur = orig & 0x00FFFFFF;
+    uint32_t part = swarScale8(cur, seep);
+    cur = swarAdd8(swarScale8(cur, keep), carryover);
+    if (i > 0) {
+      uint32_t prev = swarAdd8(buf[i-1], part);
+      if (prev != buf[i-1]) { buf[i-1] = prev; changed = true; }
+    }
+    if (cur != orig) { buf[i] = cur; changed = true; }
+    carryover = part;
+  }
+  return changed;
+}
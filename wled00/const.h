@@ -10,6 +10,16 @@
 #define DEFAULT_AP_PASS     "wled1234"
 #define DEFAULT_OTA_PASS    "wledota"
 
+#ifndef WLED_OTA_FPS
+  #define WLED_OTA_FPS     20     //frame rate limit while a firmware update is written
+#endif
+#ifndef WLED_OTA_BUFFER
+  #define WLED_OTA_BUFFER  16384  //ESP32: bytes of the uploaded image buffered for writing from loop()
+#endif
+#ifndef WLED_OTA_SLICE
+  #define WLED_OTA_SLICE   4096   //ESP32: bytes written to flash per loop() pass, one sector
+#endif
+
 //increase if you need more
 #ifndef WLED_MAX_USERMODS
   #ifdef ESP8266
@@ -19,15 +29,65 @@
   #endif
 #endif
 
+//usermod events, a usermod receives those set in getEventMask() through onEvent()
+#define UM_EVENT_STATE            0x01         //colorUpdated() changed color, brightness or effect (arg: call mode)
+#define UM_EVENT_PRESET           0x02         //a preset was applied (arg: preset id)
+#define UM_EVENT_REALTIME         0x04         //realtime mode started, changed or ended (arg: REALTIME_MODE_*)
+#define UM_EVENT_CONNECTED        0x08         //network connected (arg: 0)
+
+//time in us per loop iteration for usermods that declare a loop interval, see UsermodManager::loop()
+#ifndef USERMOD_LOOP_BUDGET
+  #define USERMOD_LOOP_BUDGET 2000
+#endif
+
+//parallel output (needs NeoPixelBus 2.7+): the first 8 or 16 digital busses share one DMA transfer,
+//of I2S1 on ESP32, I2S0 on S2 and the LCD_CAM peripheral on S3. C3 has no parallel capable peripheral
+#if defined(WLED_USE_PARALLEL_I2S) && (defined(ESP8266) || defined(CONFIG_IDF_TARGET_ESP32C3))
+  #undef WLED_USE_PARALLEL_I2S
+#endif
+#ifdef WLED_USE_PARALLEL_I2S
+  #ifndef WLED_PARALLEL_I2S_LANES
+    #define WLED_PARALLEL_I2S_LANES 8
+  #endif
+#endif
+
+//RMT transmit channels, and the DMA outputs following them (I2S, SPI on C3) if not parallel
+//with WLED_USE_IR_RMT the IR receiver takes an RMT channel, the last one where they are shared with transmit
+#ifdef ARDUINO_ARCH_ESP32
+  #if defined(CONFIG_IDF_TARGET_ESP32C3)
+    #define WLED_RMT_CHANNELS 2
+    #define WLED_DMA_CHANNELS 1 //WS281x by SPI2 DMA, see spi_ws281x.h
+    #define WLED_IR_RMT_CHANNEL 2 //receive only
+  #elif defined(CONFIG_IDF_TARGET_ESP32S2)
+    #ifdef WLED_USE_IR_RMT
+    #define WLED_RMT_CHANNELS 3
+    #else
+    #define WLED_RMT_CHANNELS 4
+    #endif
+    #define WLED_DMA_CHANNELS 1
+    #define WLED_IR_RMT_CHANNEL 3
+  #elif defined(CONFIG_IDF_TARGET_ESP32S3)
+    #define WLED_RMT_CHANNELS 4
+    #define WLED_DMA_CHANNELS 2
+    #define WLED_IR_RMT_CHANNEL 4 //receive only
+  #else
+    #ifdef WLED_USE_IR_RMT
+    #define WLED_RMT_CHANNELS 7
+    #else
+    #define WLED_RMT_CHANNELS 8
+    #endif
+    #define WLED_DMA_CHANNELS 2
+    #define WLED_IR_RMT_CHANNEL 7
+  #endif
+#endif
+
 #ifndef WLED_MAX_BUSSES
   #ifdef ESP8266
     #define WLED_MAX_BUSSES 3
+  #elif defined(WLED_USE_PARALLEL_I2S)
+    #define WLED_MAX_BUSSES (WLED_PARALLEL_I2S_LANES + WLED_RMT_CHANNELS) //parallel lanes + RMT
   #else
-    #ifdef CONFIG_IDF_TARGET_ESP32S2
-      #define WLED_MAX_BUSSES 5
-    #else
-      #define WLED_MAX_BUSSES 10
-    #endif
+    #define WLED_MAX_BUSSES (WLED_RMT_CHANNELS + WLED_DMA_CHANNELS)
   #endif
 #endif
 
@@ -64,6 +124,7 @@
 #define USERMOD_ID_SEVEN_SEGMENT_DISPLAY 21     //Usermod "usermod_v2_seven_segment_display.h"
 #define USERMOD_RGB_ROTARY_ENCODER       22     //Usermod "rgb-rotary-encoder.h"
 #define USERMOD_ID_QUINLED_AN_PENTA      23     //Usermod "quinled-an-penta.h"
+#define USERMOD_ID_AUDIOREACTIVE         24     //Usermod "usermod_audio_reactive.h"
 
 //Access point behavior
 #define AP_BEHAVIOR_BOOT_NO_CONN          0     //Open AP when no connection after boot
@@ -102,12 +163,51 @@
 #define REALTIME_MODE_ARTNET      6
 #define REALTIME_MODE_TPM2NET     7
 #define REALTIME_MODE_DDP         8
+#define REALTIME_MODE_FSEQ        9            //sequence played from the filesystem
 
 //realtime override modes
 #define REALTIME_OVERRIDE_NONE    0
 #define REALTIME_OVERRIDE_ONCE    1
 #define REALTIME_OVERRIDE_ALWAYS  2
 
+//loop subsystems timed per call, see WLED::loop()
+#define LOOP_PERF_UDP             0            //handleNotifications()
+#define LOOP_PERF_IR              1
+#define LOOP_PERF_HUE             2
+#define LOOP_PERF_USERMODS        3
+#define LOOP_PERF_SERVICE         4            //strip.service()
+#define LOOP_PERF_WS              5
+#define LOOP_PERF_COUNT           6
+//further loop stages the stall watchdog tells apart (watchdog.cpp), the LOOP_PERF_* parts are stages too
+#define WDT_STAGE_LOOP            LOOP_PERF_COUNT //none of the others
+#define WDT_STAGE_WIFI            7
+#define WDT_STAGE_BUSSES          8            //re-init after the LED settings changed
+#define WDT_STAGE_SEND            9            //queued network bus frames
+#define WDT_STAGE_OTA             10
+#define WDT_STAGE_MQTT            11           //MQTT, node list and info broadcast every 30s
+#define WDT_STAGE_CONFIG          12           //cfg.json write
+#define WDT_STAGE_PRESETS         13
+#define WDT_STAGE_COUNT           14
+#define LOOP_HIST_BINS            8            //loop time histogram, bin n counts iterations below 2^n ms (last bin: all longer)
+
+//stages of the realtime frame latency, see realtimeShow()
+#define LATENCY_QUEUE             0            //first packet of the frame received -> show() called
+#define LATENCY_SHOW              1            //show() call
+#define LATENCY_LATCH             2            //show() returned -> busses done sending (polled)
+#define LATENCY_TOTAL             3            //first packet received -> busses done sending
+#define LATENCY_STAGES            4
+
+//frame pipeline trace events, see trace.cpp
+#define TRACE_E131_RX             0            //E1.31/ArtNet packet arrived (arg: protocol)
+#define TRACE_E131                1            //packet parsed into the pixels (arg: universe)
+#define TRACE_RENDER              2            //effect function (arg: segment)
+#define TRACE_ABL                 3            //estimateCurrentAndLimitBri()
+#define TRACE_BUS_SHOW            4            //busses.show()
+#define TRACE_BUS_READY           5            //busses finished sending the previous frame (polled)
+#define TRACE_WS                  6            //websocket event (arg: event type)
+#define TRACE_HTTP                7            //JSON API request
+#define TRACE_EVENT_COUNT         8
+
 //E1.31 DMX modes
 #define DMX_MODE_DISABLED         0            //not used
 #define DMX_MODE_SINGLE_RGB       1            //all LEDs same RGB color (3 channels)
@@ -116,6 +216,12 @@
 #define DMX_MODE_MULTIPLE_RGB     4            //every LED is addressed with its own RGB (ledCount * 3 channels)
 #define DMX_MODE_MULTIPLE_DRGB    5            //every LED is addressed with its own RGB and share a master dimmer (ledCount * 3 + 1 channels)
 #define DMX_MODE_MULTIPLE_RGBW    6            //every LED is addressed with its own RGBW (ledCount * 4 channels)
+#define DMX_MODE_ROUTED           7            //universes and channels mapped to LEDs by the routes of the config (mixed RGB/RGBW)
+
+//pixel format of an E1.31 route
+#define E131_ROUTE_RGB            0
+#define E131_ROUTE_RGBW           1
+#define E131_ROUTE_DIMMER         2            //one channel, sets the master brightness
 
 //Light capability byte (unused) 0bRCCCTTTT
 //bits 0/1/2/3: specifies a type of LED driver. A single "driver" may have different chip models but must have the same protocol/behavior
@@ -151,10 +257,12 @@
 #define TYPE_APA102              51
 #define TYPE_LPD8806             52
 #define TYPE_P9813               53
+#define TYPE_APA102_HD           54            //APA102/SK9822 using the 5-bit brightness field for more depth at low brightness
 //Network types (master broadcast) (80-95)
 #define TYPE_NET_DDP_RGB         80            //network DDP RGB bus (master broadcast bus)
 #define TYPE_NET_E131_RGB        81            //network E131 RGB bus (master broadcast bus)
 #define TYPE_NET_ARTNET_RGB      82            //network ArtNet RGB bus (master broadcast bus)
+#define TYPE_NET_VSTRIP          83            //network DDP RGB bus split among the follower nodes of the instance list, see vstrip.cpp
 
 #define IS_DIGITAL(t) ((t) & 0x10) //digital are 16-31 and 48-63
 #define IS_PWM(t)     ((t) > 40 && (t) < 46)
@@ -201,6 +309,13 @@
 #define HUE_ERROR_TIMEOUT       251
 #define HUE_ERROR_ACTIVE        255
 
+//Hue Entertainment stream input (HueStream packets without DTLS)
+#ifndef HUE_STREAM_PORT
+  #define HUE_STREAM_PORT        2100
+#endif
+#define HUE_STREAM_TIMEOUT       2000    //ms without a packet after which polling resumes
+#define HUE_STREAM_TRANSITION      40    //ms, one frame of a 25 Hz stream
+
 //Segment option byte bits
 #define SEG_OPTION_SELECTED       0
 #define SEG_OPTION_REVERSED       1
@@ -208,6 +323,7 @@
 #define SEG_OPTION_MIRROR         3            //Indicates that the effect will be mirrored within the segment
 #define SEG_OPTION_NONUNITY       4            //Indicates that the effect does not use FRAMETIME or needs getPixelColor
 #define SEG_OPTION_FREEZE         5            //Segment contents will not be refreshed
+#define SEG_OPTION_TWEEN          6            //Output is interpolated between the last two effect frames
 #define SEG_OPTION_TRANSITIONAL   7
 
 //Segment differs return byte
@@ -220,10 +336,37 @@
 
 //Playlist option byte
 #define PL_OPTION_SHUFFLE      0x01
+#define PL_OPTION_PRELOAD      0x02 //keep the next entry read and parsed ahead of time
+#define PL_OPTION_PRELOAD_ALL  0x04 //keep all entries parsed, as far as PLAYLIST_PRELOAD_BUDGET allows
+#define PL_OPTION_MORPH        0x08 //entries morph to their preset over their transition time
+#define PL_OPTION_SYNC         0x10 //conductor: entries are broadcast ahead and applied by all nodes at the same time
+
+//users of the shared JSON arena (JsonArenaDoc)
+#define JSON_LOCK_WS          1
+#define JSON_LOCK_WS_SEND     2
+#define JSON_LOCK_HTTP        3
+#define JSON_LOCK_SERVE       4
+#define JSON_LOCK_SERIAL      5
+#define JSON_LOCK_PRESET_LOAD 6
+#define JSON_LOCK_PRESET_SAVE 7
+#define JSON_LOCK_LEDMAP      8
+#define JSON_LOCK_MQTT        9
+#define JSON_LOCK_IR         10
+#define JSON_LOCK_TIMERS     11
+#define JSON_LOCK_STATE      12
+
+// Boot phases, setup() only runs the first, the others are brought up one per loop() (bootPhase)
+#define BOOT_PHASE_FAST       0 //config, busses and boot preset, first frame
+#define BOOT_PHASE_FS         1 //preset migration, FS usage
+#define BOOT_PHASE_USERMODS   2
+#define BOOT_PHASE_NETWORK    3 //module IDs, OTA, DMX, web server. WiFi connects once this is done
+#define BOOT_PHASE_DONE       4
 
 // WLED Error modes
 #define ERR_NONE         0  // All good :)
 #define ERR_EEP_COMMIT   2  // Could not commit to EEPROM (wrong flash layout?)
+#define ERR_NOBUF        3  // No JSON buffer available (shared arena busy and out of heap)
+#define ERR_NOMEM        4  // Not enough memory for a segment name
 #define ERR_JSON         9  // JSON parsing failed (input too large?)
 #define ERR_FS_BEGIN    10  // Could not init filesystem (no partition?)
 #define ERR_FS_QUOTA    11  // The FS is full or the maximum file size is reached
@@ -243,39 +386,196 @@
 
 #define NTP_PACKET_SIZE 48
 
+//WLED_ENABLE_LARGE_STRIP: ESP32 with PSRAM driving mostly network busses, tens of thousands of rendered LEDs.
+//Segment, bus and LED map buffers go to PSRAM, pixel indices stay 16-bit (up to 65535 LEDs)
+#if defined(WLED_ENABLE_LARGE_STRIP) && !(defined(ARDUINO_ARCH_ESP32) && defined(WLED_USE_PSRAM))
+  #error "WLED_ENABLE_LARGE_STRIP needs an ESP32 build with WLED_USE_PSRAM"
+#endif
+
 //maximum number of rendered LEDs - this does not have to match max. physical LEDs, e.g. if there are virtual busses 
 #ifndef MAX_LEDS
 #ifdef ESP8266
 #define MAX_LEDS 1664 //can't rely on memory limit to limit this to 1600 LEDs
+#elif defined(WLED_ENABLE_LARGE_STRIP)
+#define MAX_LEDS 32768
 #else
 #define MAX_LEDS 8192
 #endif
 #endif
+#if MAX_LEDS > 65535
+  #error "MAX_LEDS must not exceed 65535, pixel indices are 16-bit"
+#endif
 
 #ifndef MAX_LED_MEMORY
 #ifdef ESP8266
 #define MAX_LED_MEMORY 4000
+#elif defined(WLED_ENABLE_LARGE_STRIP)
+#define MAX_LED_MEMORY 262144 //network bus buffers are in PSRAM
 #else
 #define MAX_LED_MEMORY 64000
 #endif
 #endif
 
+//LED maps kept in memory besides the active one, for switching with "ledmap" in the JSON API (presets)
+#ifndef WLED_LEDMAP_CACHE
+  #ifdef ESP8266
+    #define WLED_LEDMAP_CACHE 1
+  #else
+    #define WLED_LEDMAP_CACHE 4
+  #endif
+#endif
+#if WLED_LEDMAP_CACHE < 1
+  #error "WLED_LEDMAP_CACHE must be at least 1"
+#endif
+
+//user palettes /palette0.bin ... read at boot, ids follow the gradient palettes
+#ifndef WLED_MAX_CUSTOM_PALETTES
+  #ifdef ESP8266
+    #define WLED_MAX_CUSTOM_PALETTES 4
+  #else
+    #define WLED_MAX_CUSTOM_PALETTES 10
+  #endif
+#endif
+
 #ifndef MAX_LEDS_PER_BUS
 #define MAX_LEDS_PER_BUS 4096
 #endif
+//network busses are not limited by their output hardware, only by the total
+#ifndef MAX_LEDS_PER_NETWORK_BUS
+#ifdef WLED_ENABLE_LARGE_STRIP
+#define MAX_LEDS_PER_NETWORK_BUS MAX_LEDS
+#else
+#define MAX_LEDS_PER_NETWORK_BUS MAX_LEDS_PER_BUS
+#endif
+#endif
 
 // string temp buffer (now stored in stack locally)
 #define OMAX 2048
 
+// live LED JSON buffer (/json/live and WebSocket live view)
+#define LIVE_LEDS_JSON_SIZE 2000
+
 #ifdef WLED_USE_ETHERNET
 #define E131_MAX_UNIVERSE_COUNT 20
 #else
 #define E131_MAX_UNIVERSE_COUNT 10
 #endif
 
+#ifndef E131_MAX_ROUTES
+  #ifdef ESP8266
+  #define E131_MAX_ROUTES 16 // at least E131_MAX_UNIVERSE_COUNT +1, DMX_MODE_MULTIPLE_* compile to one route per universe
+  #else
+  #define E131_MAX_ROUTES 32
+  #endif
+#endif
+
+//merging of several E1.31/Art-Net senders, e131MergeMode
+#define E131_MERGE_OFF 0 // the last packet wins
+#define E131_MERGE_HTP 1 // highest takes precedence, of the sources with the highest priority
+#define E131_MERGE_LTP 2 // latest takes precedence
+
+#ifndef E131_MAX_SOURCES
+#define E131_MAX_SOURCES 2 // senders tracked at once, each needs 512 bytes per merged universe
+#endif
+#ifndef E131_MERGE_UNIVERSES
+  #ifdef ESP8266
+  #define E131_MERGE_UNIVERSES 4
+  #else
+  #define E131_MERGE_UNIVERSES E131_MAX_UNIVERSE_COUNT
+  #endif
+#endif
+#define E131_SOURCE_TIMEOUT   2500 // ms, a source that sent nothing for this long is lost (E1.31 network data loss)
+#define E131_DEFAULT_PRIORITY 100  // of Art-Net sources
+
+#ifndef E131_FRAME_TIMEOUT
+#define E131_FRAME_TIMEOUT 25 // ms to wait for the remaining universes of a frame before showing it anyway
+#endif
+
+//SPI SD card pins (VSPI defaults) and clock
+#ifndef WLED_SD_CS
+  #define WLED_SD_CS   5
+#endif
+#ifndef WLED_SD_SCK
+  #define WLED_SD_SCK  18
+#endif
+#ifndef WLED_SD_MISO
+  #define WLED_SD_MISO 19
+#endif
+#ifndef WLED_SD_MOSI
+  #define WLED_SD_MOSI 23
+#endif
+#ifndef WLED_SD_FREQ
+  #define WLED_SD_FREQ 20000000
+#endif
+#define WLED_SD_SECTOR 512 //card block size, media reads are aligned to it
+
+#ifndef WLED_ETH_ONLY_FALLBACK
+#define WLED_ETH_ONLY_FALLBACK 60000 // ms without an Ethernet link after boot before WiFi starts despite Ethernet only mode
+#endif
+
+#ifndef WLED_FAST_CONNECT_TIMEOUT
+#define WLED_FAST_CONNECT_TIMEOUT 3000 // ms to wait for the cached AP before falling back to a scanning connect
+#endif
+
+#ifndef WLED_TIMESYNC_INTERVAL
+#define WLED_TIMESYNC_INTERVAL 10000 // ms between timebase sync requests to the node our notifications come from
+#endif
+#define WLED_TIMESYNC_MAX_RTT  40    // ms, slower answers were queued somewhere and would skew the offset
+#define WLED_TIMESYNC_MAX_STEP 4     // ms the timebase is slewed per answer, larger errors than WLED_TIMESYNC_JUMP are set at once
+#define WLED_TIMESYNC_JUMP     250
+#ifndef WLED_PLAYLIST_SYNC_LEAD
+#define WLED_PLAYLIST_SYNC_LEAD 300  // ms a synced playlist entry is sent ahead, followers read the preset meanwhile
+#endif
+
+// shortest time in ms between two MQTT state publishes, changes in between (slider drags) are coalesced
+#ifndef WLED_MQTT_PUBLISH_INTERVAL
+  #define WLED_MQTT_PUBLISH_INTERVAL 200
+#endif
+
+// MQTT payloads up to this size are assembled in a buffer that is kept, larger ones are allocated per message
+#ifndef WLED_MQTT_PAYLOAD_MAX
+  #ifdef ESP8266
+    #define WLED_MQTT_PAYLOAD_MAX 1024
+  #else
+    #define WLED_MQTT_PAYLOAD_MAX 2048
+  #endif
+#endif
+
+#ifndef WLED_SYNC_MULTICAST_IP
+#define WLED_SYNC_MULTICAST_IP 239,255,82,76 // group of the notifier and node list if multicast sync is enabled
+#endif
+
+#ifndef WLED_SERIAL_RX_BUFFER
+  #ifdef ESP8266
+    #define WLED_SERIAL_RX_BUFFER 1024 // bytes, holds about 10ms of Adalight data at 921600 baud
+  #else
+    #define WLED_SERIAL_RX_BUFFER 2048
+  #endif
+#endif
+
+#ifndef E131_QUEUE_SLOTS
+#define E131_QUEUE_SLOTS 8 // ESP32: realtime packets buffered between the network task and loop(), power of 2
+#endif
+
+#ifndef DDP_TIMECODE_LATENCY
+#define DDP_TIMECODE_LATENCY 20 // ESP32: ms DDP frames with a timecode are held after the fastest transit to absorb network jitter
+#endif
+
+#ifndef E131_SYNC_TIMEOUT
+#define E131_SYNC_TIMEOUT 4000 // ms without sync packets before falling back to showing frames as they arrive
+#endif
+
 #define ABL_MILLIAMPS_DEFAULT 850  // auto lower brightness to stay close to milliampere limit
 
 // PWM settings
+// default white points of warm and cold white channels (K), for the CCT mix of 2 and 5 channel PWM
+#ifndef WLED_CCT_WARM_K
+  #define WLED_CCT_WARM_K 2700
+#endif
+#ifndef WLED_CCT_COLD_K
+  #define WLED_CCT_COLD_K 6500
+#endif
+
 #ifndef WLED_PWM_FREQ
 #ifdef ESP8266
   #define WLED_PWM_FREQ    880 //PWM frequency proven as good for LEDs
@@ -284,6 +584,31 @@
 #endif
 #endif
 
+// PWM duty resolution in bits (8-16), the precision below it is dithered over successive frames
+// ESP32 LEDC needs WLED_PWM_FREQ * 2^bits <= 80MHz
+#ifndef WLED_PWM_RESOLUTION
+#ifdef ESP8266
+  #define WLED_PWM_RESOLUTION 10
+#else
+  #define WLED_PWM_RESOLUTION 12
+#endif
+#endif
+#define WLED_PWM_MAX_DUTY ((1UL << WLED_PWM_RESOLUTION) -1)
+
+// seconds browsers may use the built-in UI without asking, 0 = revalidate on every load
+// "/" does not change with the firmware, so a long time keeps showing the old UI after an update until it expires
+#ifndef WLED_UI_MAX_AGE
+  #define WLED_UI_MAX_AGE 0
+#endif
+// the UI requests /palettes.json with the build id in the query, so it can be cached for good
+#ifndef WLED_PALETTES_MAX_AGE
+  #define WLED_PALETTES_MAX_AGE 31536000
+#endif
+// same for the UI modules loaded on first use (/index_<m>.js)
+#ifndef WLED_UI_MODULES_MAX_AGE
+  #define WLED_UI_MODULES_MAX_AGE 31536000
+#endif
+
 #define TOUCH_THRESHOLD 32 // limit to recognize a touch, higher value means more sensitive
 
 // Size of buffer for API JSON object (increase for more segments)
@@ -293,11 +618,40 @@
   #define JSON_BUFFER_SIZE 20480
 #endif
 
-// Maximum size of node map (list of other WLED instances)
-#ifdef ESP8266
-  #define WLED_MAX_NODES 24
-#else
-  #define WLED_MAX_NODES 150
+// new JSON API requests (HTTP and websocket) are answered with 503 while the largest free block is smaller
+#ifndef WLED_HEAP_WATERMARK
+  #ifdef ESP8266
+    #define WLED_HEAP_WATERMARK 4096
+  #else
+    #define WLED_HEAP_WATERMARK 8192
+  #endif
+#endif
+
+//timers of the time settings page and /timers.json
+#ifndef WLED_MAX_TIMERS
+  #ifdef ESP8266
+    #define WLED_MAX_TIMERS 64
+  #else
+    #define WLED_MAX_TIMERS 256
+  #endif
+#endif
+
+#define TIMER_HOUR_EVERY    24 //fire every hour at the given minute
+#define TIMER_HOUR_SUNSET  254 //min is the offset to sunset
+#define TIMER_HOUR_SUNRISE 255
+
+// Maximum size of node map (list of other WLED instances), the table is allocated statically
+#ifndef VSTRIP_MAX_FOLLOWERS
+  #define VSTRIP_MAX_FOLLOWERS 32
+#endif
+#define VSTRIP_ASSIGN_INTERVAL 1000 //ms between checks of the instance list for followers
+
+#ifndef WLED_MAX_NODES
+  #ifdef ESP8266
+    #define WLED_MAX_NODES 24
+  #else
+    #define WLED_MAX_NODES 150
+  #endif
 #endif
 
 //this is merely a default now and can be changed at runtime
@@ -321,4 +675,9 @@
   #define DEFAULT_LED_COUNT 30
 #endif
 
+//buffers of at least this size that allocLarge() is asked for go to PSRAM, if there is some
+#ifndef WLED_PSRAM_MIN_ALLOC
+  #define WLED_PSRAM_MIN_ALLOC 512
+#endif
+
 #endif
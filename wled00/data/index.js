@@ -63,6 +63,38 @@ var cpick = new iro.ColorPicker("#picker", {
   ]
 });
 
+//parts of the UI that are loaded on first use, /index_<m>.js (built and served like the main page)
+var mods = {};
+function loadMod(m, callback)
+{
+	if (mods[m]) { mods[m].push(callback); return; }
+	mods[m] = [callback];
+	var s = d.createElement('script');
+	s.src = (loc?`http://${locip}`:'') + `/index_${m}.js?v=${lastinfo.vid}`;
+	s.onload = function() { for (var cb of mods[m]) cb(true); mods[m] = []; };
+	s.onerror = function() { var cbs = mods[m]; delete mods[m]; showErrorToast(); for (var cb of cbs) cb(false); };
+	d.head.appendChild(s);
+}
+
+//placeholders for the functions of a module, they load it and call the function it declares instead
+//if the module is not available, a callback passed as first argument is still called
+function lazy(m, fns)
+{
+	for (let f of fns) {
+		let stub = function() {
+			var a = arguments;
+			loadMod(m, (ok)=>{
+				if (ok && window[f] !== stub) window[f].apply(null, a);
+				else if (typeof a[0] === 'function') a[0]();
+			});
+		};
+		window[f] = stub;
+	}
+}
+lazy('pe', ['editP', 'makePUtil', 'makePlUtil']); //preset and playlist editor
+lazy('pp', ['loadPalettesData']);                 //palette previews
+lazy('se', ['makeSeg']);                          //new segment form
+
 function handleVisibilityChange() {
 	if (!d.hidden && new Date () - lastUpdate > 3000) {
 		requestJson(null);
@@ -657,6 +689,7 @@ function populateEffects(effects)
 	for (let i = 0; i < effects.length; i++) {
 		effects[i] = {id: parseInt(i)+1, name:effects[i]};
 	}
+	effects = effects.filter((e)=>e.name !== "RSVD"); //not built in
 	effects.sort(compare);
 
 	effects.unshift({
@@ -679,9 +712,10 @@ function populateEffects(effects)
 	fxlist.innerHTML=html;
 }
 
-function populatePalettes(palettes)
+function populatePalettes(palettes, custom = 0)
 {
 	palettes.shift(); //remove default
+	for (let i = 0; i < custom; i++) palettes.push(`~ Custom ${i} ~`); //ids after the built-in ones
 	for (let i = 0; i < palettes.length; i++) {
 		palettes[i] = {
 			"id": parseInt(i)+1,
@@ -704,7 +738,7 @@ function populatePalettes(palettes)
 		    palettes[i].id,
             palettes[i].name,
             'setPalette',
-			`<div class="lstIprev" style="${genPalPrevCss(palettes[i].id)}"></div>`,
+			`<div class="lstIprev" style="${palettesData?genPalPrevCss(palettes[i].id):''}"></div>`,
 			palettes[i].class,
         );
 	}
@@ -712,72 +746,6 @@ function populatePalettes(palettes)
 	pallist.innerHTML=html;
 }
 
-function redrawPalPrev()
-{
-	let palettes = d.querySelectorAll('#pallist .lstI');
-	for (let i = 0; i < palettes.length; i++) {
-		let id = palettes[i].dataset.id;
-		let lstPrev = palettes[i].querySelector('.lstIprev');
-		if (lstPrev) {
-			lstPrev.style = genPalPrevCss(id);
-		}
-	}
-}
-
-function genPalPrevCss(id)
-{
-	if (!palettesData) {
-		return;
-	}
-	var paletteData = palettesData[id];
-
-	if (!paletteData) {
-		return 'display: none';
-	}
-
-	// We need at least two colors for a gradient
-	if (paletteData.length == 1) {
-		paletteData[1] = paletteData[0];
-		if (Array.isArray(paletteData[1])) {
-			paletteData[1][0] = 255;
-		}
-	}
-
-	var gradient = [];
-	for (let j = 0; j < paletteData.length; j++) {
-		const element = paletteData[j];
-		let r;
-		let g;
-		let b;
-		let index = false;
-		if (Array.isArray(element)) {
-			index = element[0]/255*100;
-			r = element[1];
-			g = element[2];
-			b = element[3];
-		} else if (element == 'r') {
-			r = Math.random() * 255;
-			g = Math.random() * 255;
-			b = Math.random() * 255;
-		} else {
-			if (selColors) {
-				let pos = element[1] - 1;
-				r = selColors[pos][0];
-				g = selColors[pos][1];
-				b = selColors[pos][2];
-			}
-		}
-		if (index === false) {
-			index = j / paletteData.length * 100;
-		}
-		
-		gradient.push(`rgb(${r},${g},${b}) ${index}%`);
-	}
-
-	return `background: linear-gradient(to right,${gradient.join()});`;
-}
-
-function generateListItemHtml(listName, id, name, clickAction, extraHtml = '', extraClass = '')
 {
     return `<div class="lstI btn fxbtn ${extraClass}" data-id="${id}" onClick="${clickAction}(${id})">
 			<label class="radio fxchkl">
@@ -968,6 +936,7 @@ function makeWS() {
   if (ws) return;
   ws = new WebSocket('ws://'+(loc?locip:window.location.hostname)+'/ws');
   ws.onmessage = function(event) {
+    if (typeof event.data !== "string") return; //binary liveview packet
     var json = JSON.parse(event.data);
     if (json.leds) return; //liveview packet
     clearTimeout(jsonTimeout);
@@ -1142,14 +1111,14 @@ function requestJson(command, rinfo = true) {
 		if (!command || rinfo) { //we have info object
 			if (!rinfo) { //entire JSON (on load)
 				populateEffects(json.effects);
-				populatePalettes(json.palettes);
+				populatePalettes(json.palettes, json.info.cpalcount);
 
-				//load palette previews, presets, and open websocket sequentially
+				//load presets, open websocket and load palette previews sequentially
+				//the websocket does not depend on the palette preview module
 				setTimeout(function(){
 					loadPresets(function(){
-						loadPalettesData(function(){
-							if (!ws && json.info.ws > -1) makeWS();
-						});
+						if (!ws && json.info.ws > -1) makeWS();
+						setTimeout(loadPalettesData, 99);
 					});
 				},25);
 				
@@ -1251,243 +1220,17 @@ function toggleNodes() {
   if (isNodes) loadNodes();
 }
 
-function makeSeg() {
-	var ns = 0;
-	if (lowestUnused > 0) {
-		var pend = parseInt(d.getElementById(`seg${lowestUnused -1}e`).value,10) + (cfg.comp.seglen?parseInt(d.getElementById(`seg${lowestUnused -1}s`).value,10):0);
-		if (pend < ledCount) ns = pend;
-	}
-	var cn = `<div class="seg">
-			<div class="segname newseg">
-				New segment ${lowestUnused}
-        <i class="icons edit-icon expanded" onclick="tglSegn(${lowestUnused})">&#xe2c6;</i>
-			</div>
-			<br>
-			<div class="segin expanded">
-        <input type="text" class="ptxt stxt noslide" id="seg${lowestUnused}t" autocomplete="off" maxlength=32 value="" placeholder="Enter name..."/>
-				<table class="segt">
-					<tr>
-						<td class="segtd">Start LED</td>
-						<td class="segtd">${cfg.comp.seglen?"Length":"Stop LED"}</td>
-					</tr>
-					<tr>
-						<td class="segtd"><input class="noslide segn" id="seg${lowestUnused}s" type="number" min="0" max="${ledCount-1}" value="${ns}" oninput="updateLen(${lowestUnused})"></td>
-						<td class="segtd"><input class="noslide segn" id="seg${lowestUnused}e" type="number" min="0" max="${ledCount-(cfg.comp.seglen?ns:0)}" value="${ledCount-(cfg.comp.seglen?ns:0)}" oninput="updateLen(${lowestUnused})"></td>
-					</tr>
-				</table>
-				<div class="h" id="seg${lowestUnused}len">${ledCount - ns} LED${ledCount - ns >1 ? "s":""}</div>
-				<i class="icons e-icon cnf cnf-s half" id="segc${lowestUnused}" onclick="setSeg(${lowestUnused}); resetUtil();">&#xe390;</i>
-			</div>
-		</div>`;
-	d.getElementById('segutil').innerHTML = cn;
-}
-
 function resetUtil() {
 	var cn = `<button class="btn btn-s btn-i" onclick="makeSeg()"><i class="icons btn-icon">&#xe18a;</i>Add segment</button><br>`;
 	d.getElementById('segutil').innerHTML = cn;
 }
 
-var plJson = {"0":{
-	"ps": [0],	
-	"dur": [100],	
-	"transition": [-1],	//to be inited to default transition dur
-	"repeat": 0,
-	"r": false,
-	"end": 0	
-}};
-
-function makePlSel(incPl=false) {
-	var plSelContent = "";
-	delete pJson["0"];	// remove filler preset
-	var arr = Object.entries(pJson);
-	for (var i = 0; i < arr.length; i++) {
-		var n = arr[i][1].n ? arr[i][1].n : "Preset " + arr[i][0];
-		if (!incPl && arr[i][1].playlist && arr[i][1].playlist.ps) continue; //remove playlists, sub-playlists not yet supported
-		plSelContent += `<option value=${arr[i][0]}>${n}</option>`
-	}
-	return plSelContent;
-}
-
-function refreshPlE(p) {
-	var plEDiv = d.getElementById(`ple${p}`);
-	if (!plEDiv) return;
-	var content = "";
-	for (var i = 0; i < plJson[p].ps.length; i++) {
-		content += makePlEntry(p,i);
-	}
-	plEDiv.innerHTML = content;
-	var dels = plEDiv.getElementsByClassName("btn-pl-del");
-	if (dels.length < 2) dels[0].style.display = "none";
-
-	var sels = d.getElementById(`seg${p+100}`).getElementsByClassName("sel");
-	for (var i of sels) {
-		if (i.dataset.val) {
-			if (parseInt(i.dataset.val) > 0) i.value = i.dataset.val;
-			else plJson[p].ps[i.dataset.index] = parseInt(i.value);
-		}
-	}
-}
-
-//p: preset ID, i: ps index
-function addPl(p,i) {
-	plJson[p].ps.splice(i+1,0,0);
-	plJson[p].dur.splice(i+1,0,plJson[p].dur[i]);
-	plJson[p].transition.splice(i+1,0,plJson[p].transition[i]);
-	refreshPlE(p);
-}
-
-function delPl(p,i) {
-	if (plJson[p].ps.length < 2) return;
-	plJson[p].ps.splice(i,1);
-	plJson[p].dur.splice(i,1);
-	plJson[p].transition.splice(i,1);
-	refreshPlE(p);
-}
-
-function plePs(p,i,field) {
-	plJson[p].ps[i] = parseInt(field.value);
-}
-
-function pleDur(p,i,field) {
-	if (field.validity.valid)
-		plJson[p].dur[i] = Math.floor(field.value*10);
-}
-
-function pleTr(p,i,field) {
-	if (field.validity.valid)
-		plJson[p].transition[i] = Math.floor(field.value*10);
-}
-
-function plR(p) {
-	var pl = plJson[p];
-	pl.r = d.getElementById(`pl${p}rtgl`).checked;
-	if (d.getElementById(`pl${p}rptgl`).checked) { //infinite
-		pl.repeat = 0;
-		delete pl.end;
-		d.getElementById(`pl${p}o1`).style.display = "none";
-	} else {
-		pl.repeat = parseInt(d.getElementById(`pl${p}rp`).value);
-		pl.end = parseInt(d.getElementById(`pl${p}selEnd`).value);
-		d.getElementById(`pl${p}o1`).style.display = "block";
-	}
-}
-
-function makeP(i,pl) {
-  var content = "";
-  if (pl) {
-		var rep = plJson[i].repeat ? plJson[i].repeat : 0;
-		content = `
-  <div class="first c">Playlist Entries</div>
-  <div id="ple${i}"></div><label class="check revchkl">
-    Shuffle
-    <input type="checkbox" id="pl${i}rtgl" onchange="plR(${i})" ${plJson[i].r?"checked":""}>
-    <span class="checkmark schk"></span>
-  </label>
-  <label class="check revchkl">
-    Repeat indefinitely
-    <input type="checkbox" id="pl${i}rptgl" onchange="plR(${i})" ${rep?"":"checked"}>
-    <span class="checkmark schk"></span>
-  </label>
-	<div id="pl${i}o1" style="display:${rep?"block":"none"}">
-  <div class="c">Repeat <input class="noslide" type="number" id="pl${i}rp" oninput="plR(${i})" max=127 min=0 value=${rep>0?rep:1}> times</div>
-  End preset:<br>
-  <select class="btn sel sel-ple" id="pl${i}selEnd" onchange="plR(${i})" data-val=${plJson[i].end?plJson[i].end:0}>
-		<option value=0>None</option>
-    ${makePlSel(true)}
-  </select>
-	</div>
-  <button class="btn btn-i btn-p" onclick="testPl(${i}, this)"><i class='icons btn-icon'>&#xe139;</i>Test</button>`;
-	}
-  else content = `<label class="check revchkl">
-		Include brightness
-		<input type="checkbox" id="p${i}ibtgl" checked>
-		<span class="checkmark schk"></span>
-	</label>
-	<label class="check revchkl">
-		Save segment bounds
-		<input type="checkbox" id="p${i}sbtgl" checked>
-		<span class="checkmark schk"></span>
-	</label>`;
-
-	return `
-	<input type="text" class="ptxt noslide" id="p${i}txt" autocomplete="off" maxlength=32 value="${(i>0)?pName(i):""}" placeholder="Enter name..."/><br>
-	<div class="c">Quick load label: <input type="text" class="qltxt noslide" maxlength=2 value="${qlName(i)}" id="p${i}ql" autocomplete="off"/></div>
-	<div class="h">(leave empty for no Quick load button)</div>
-	<div ${pl&&i==0?"style='display:none'":""}>
-	<label class="check revchkl">
-    ${pl?"Show playlist editor":(i>0)?"Overwrite with state":"Use current state"}
-    <input type="checkbox" id="p${i}cstgl" onchange="tglCs(${i})" ${(i==0||pl)?"checked":""}>
-    <span class="checkmark schk"></span>
-  </label><br>
-	</div>
-  <div class="po2" id="p${i}o2">
-    API command<br>
-    <textarea class="noslide" id="p${i}api"></textarea>
-  </div>
-  <div class="po1" id="p${i}o1">
-		${content}
-  </div>
-	<div class="c">Save to ID <input class="noslide" id="p${i}id" type="number" oninput="checkUsed(${i})" max=250 min=1 value=${(i>0)?i:getLowestUnusedP()}></div>
-	<div class="c">
-		<button class="btn btn-i btn-p" onclick="saveP(${i},${pl})"><i class="icons btn-icon">&#xe390;</i>Save ${(pl)?"playlist":(i>0)?"changes":"preset"}</button>
-		${(i>0)?'<button class="btn btn-i btn-p" id="p'+i+'del" onclick="delP('+i+')"><i class="icons btn-icon">&#xe037;</i>Delete '+(pl?"playlist":"preset"):
-						'<button class="btn btn-p" onclick="resetPUtil()">Cancel'}</button>
-	</div>
-	<div class="pwarn ${(i>0)?"bp":""} c" id="p${i}warn">
-
-	</div>
-	${(i>0)? ('<div class="h">ID ' +i+ '</div>'):""}`;
-}
-
-function makePUtil() {
-	d.getElementById('putil').innerHTML = `<div class="seg pres">
-		<div class="segname newseg">
-			New preset</div>
-		<div class="segin expanded">
-		${makeP(0)}</div></div>`;
-}
-
-function makePlEntry(p,i) {
-  return `
-  <div class="plentry">
-    <select class="btn sel sel-pl" onchange="plePs(${p},${i},this)" data-val=${plJson[p].ps[i]} data-index=${i}>
-		${makePlSel()}
-    </select>
-		<button class="btn btn-i btn-xs btn-pl-del" onclick="delPl(${p},${i})"><i class="icons btn-icon">&#xe037;</i></button>
-		<div class="h plnl">Duration</div><div class="h plnl">Transition</div><div class="h pli">#${i+1}</div><br>
-		<input class="noslide pln" type="number" max=6553.0 min=0.2 step=0.1 oninput="pleDur(${p},${i},this)" value=${plJson[p].dur[i]/10.0}>
-		<input class="noslide pln" type="number" max=65.0 min=0.0 step=0.1 oninput="pleTr(${p},${i},this)" value=${plJson[p].transition[i]/10.0}> s
-		<button class="btn btn-i btn-xs btn-pl-add" onclick="addPl(${p},${i})"><i class="icons btn-icon">&#xe18a;</i></button>
-    <div class="hrz"></div>
-  </div>`;
-}
-
-function makePlUtil() {
-  if (pNum < 2) {
-    showToast("You need at least 2 presets to make a playlist!"); return;
-  }
-	if (plJson[0].transition[0] < 0) plJson[0].transition[0] = tr;
-  d.getElementById('putil').innerHTML = `<div class="seg pres">
-  <div class="segname newseg">
-    New playlist</div>
-  <div class="segin expanded" id="seg100">
-  ${makeP(0,true)}</div></div>`;
-	
-	refreshPlE(0);
-}
-
 function resetPUtil() {
 	var cn = `<button class="btn btn-s btn-i" onclick="makePUtil()"><i class="icons btn-icon">&#xe18a;</i>Create preset</button><br>
             <button class="btn btn-s btn-i" onclick="makePlUtil()"><i class='icons btn-icon'>&#xe139;</i>Create playlist</button><br>`;
 	d.getElementById('putil').innerHTML = cn;
 }
 
-function tglCs(i){
-	var pss = d.getElementById(`p${i}cstgl`).checked;
-	d.getElementById(`p${i}o1`).style.display = pss? "block" : "none";
-	d.getElementById(`p${i}o2`).style.display = !pss? "block" : "none";
-}
-
 function tglSegn(s)
 {
   d.getElementById(`seg${s}t`).style.display =
@@ -1619,97 +1362,6 @@ function setPreset(i) {
 	requestJson(obj);
 }
 
-function saveP(i,pl) {
-	pI = parseInt(d.getElementById(`p${i}id`).value);
-	if (!pI || pI < 1) pI = (i>0) ? i : getLowestUnusedP();
-	pN = d.getElementById(`p${i}txt`).value;
-
-	if (pN == "") pN = (pl?"Playlist ":"Preset ") + pI;
-	var obj = {};
-
-	if (!d.getElementById(`p${i}cstgl`).checked) {
-		var raw = d.getElementById(`p${i}api`).value;
-		try {
-			obj = JSON.parse(raw);
-		} catch (e) {
-			obj.win = raw;
-			if (raw.length < 2) {
-				d.getElementById(`p${i}warn`).innerHTML = "&#9888; Please enter your API command first";
-				return;
-			} else if (raw.indexOf('{') > -1) {
-				d.getElementById(`p${i}warn`).innerHTML = "&#9888; Syntax error in custom JSON API command";
-				return;
-			} else if (raw.indexOf("Please") == 0) {
-				d.getElementById(`p${i}warn`).innerHTML = "&#9888; Please refresh the page before modifying this preset";
-				return;
-			}
-		}
-		obj.o = true;
-	} else {
-		if (pl) {
-			obj.playlist = plJson[i];
-			obj.on = true;
-			obj.o = true;
-		} else {
-			obj.ib = d.getElementById(`p${i}ibtgl`).checked;
-			obj.sb = d.getElementById(`p${i}sbtgl`).checked;
-		}
-	}
-
-	obj.psave = pI; obj.n = pN;
-	var pQN = d.getElementById(`p${i}ql`).value;
-	if (pQN.length > 0) obj.ql = pQN;
-
-  showToast("Saving " + pN +" (" + pI + ")");
-	requestJson(obj);
-	if (obj.o) {
-		pJson[pI] = obj;
-		delete pJson[pI].psave;
-		delete pJson[pI].o;
-		delete pJson[pI].v;
-		delete pJson[pI].time;
-	} else {
-		pJson[pI] = {"n":pN, "win":"Please refresh the page to see this newly saved command."};
-		if (obj.win) pJson[pI].win = obj.win;
-		if (obj.ql)  pJson[pI].ql = obj.ql;
-	}
-	populatePresets();
-	resetPUtil();
-}
-
-function testPl(i,bt) {
-	if (bt.dataset.test == 1) {
-		bt.dataset.test = 0;
-		bt.innerHTML = "<i class='icons btn-icon'>&#xe139;</i>Test";
-		stopPl();
-		return;
-	}
-	bt.dataset.test = 1;
-	bt.innerHTML = "<i class='icons btn-icon'>&#xe38f;</i>Stop";
-	var obj = {};
-	obj.playlist = plJson[i];
-	obj.on = true;
-	requestJson(obj);
-}
-
-function stopPl() {
-	requestJson({playlist:{}})
-}
-
-function delP(i) {
-	var bt = d.getElementById(`p${i}del`);
-	if (bt.dataset.cnf == 1) {
-		var obj = {"pdel": i};
-		requestJson(obj);
-		delete pJson[i];
-		populatePresets();
-	} else {
-		bt.style.color = "#f00";
-		bt.innerHTML = "<i class='icons btn-icon'>&#xe037;</i>Confirm delete";
-		bt.dataset.cnf = 1;
-	}
-}
-
 function selectSlot(b) {
 	csel = b;
 	var cd = d.getElementById('csl').children;
@@ -1726,7 +1378,7 @@ function selectSlot(b) {
 	updateTrail(d.getElementById('sliderW'));
 	updateHex();
 	updateRgb();
-	redrawPalPrev();
+	if (palettesData) redrawPalPrev();
 }
 
 var lasth = 0;
@@ -1852,68 +1504,6 @@ function rSegs()
 	requestJson(obj);
 }
 
-function loadPalettesData(callback = null)
-{
-	if (palettesData) return;
-	const lsKey = "wledPalx";
-	var palettesDataJson = localStorage.getItem(lsKey);
-	if (palettesDataJson) {
-		try {
-			palettesDataJson = JSON.parse(palettesDataJson);
-			var d = new Date();
-			if (palettesDataJson && palettesDataJson.vid == lastinfo.vid) {
-				palettesData = palettesDataJson.p;
-				//redrawPalPrev() //?
-				if (callback) callback();
-				return;
-			}
-		} catch (e) {}
-	}
-
-	palettesData = {};
-	getPalettesData(0, function() {
-		localStorage.setItem(lsKey, JSON.stringify({
-			p: palettesData,
-			vid: lastinfo.vid
-		}));
-		redrawPalPrev();
-		if (callback) setTimeout(callback, 99); //go on to connect websocket
-	});
-}
-
-function getPalettesData(page, callback)
-{
-	var url = `/json/palx?page=${page}`;
-	if (loc) {
-		url = `http://${locip}${url}`;
-	}
-
-	fetch(url, {
-		method: 'get',
-		headers: {
-			"Content-type": "application/json; charset=UTF-8"
-		}
-	})
-	.then(res => {
-		if (!res.ok) {
-			showErrorToast();
-		}
-		return res.json();
-	})
-	.then(json => {
-		palettesData = Object.assign({}, palettesData, json.p);
-		if (page < json.m) {
-			getPalettesData(page + 1, callback);
-		} else {
-			callback();
-		}
-	})
-	.catch(function (error) {
-		showToast(error, true);
-		console.log(error);
-	});
-}
-
 function search(searchField) {
 	var searchText = searchField.value.toUpperCase();
   searchField.parentElement.getElementsByClassName('search-cancel-icon')[0].style.display = (searchText.length < 1)?"none":"inline";
@@ -1936,34 +1526,6 @@ function cancelSearch(ic) {
   searchField.focus();
 }
 
-//make sure "dur" and "transition" are arrays with at least the length of "ps"
-function formatArr(pl) {
-	var l = pl.ps.length;
-	if (!Array.isArray(pl.dur)) {
-		var v = pl.dur;
-		if (isNaN(v)) v = 100;
-		pl.dur = [v];
-	}
-	var l2 = pl.dur.length;
-	if (l2 < l)
-	{
-		for (var i = 0; i < l - l2; i++)
-			pl.dur.push(pl.dur[l2-1]);
-	}
-
-	if (!Array.isArray(pl.transition)) {
-		var v = pl.transition;
-		if (isNaN(v)) v = tr;
-		pl.transition = [v];
-	}
-	var l2 = pl.transition.length;
-	if (l2 < l)
-	{
-		for (var i = 0; i < l - l2; i++)
-			pl.transition.push(pl.transition[l2-1]);
-	}
-}
-
 function expand(i,a)
 {
 	if (!a) expanded[i] = !expanded[i];
@@ -1977,23 +1539,7 @@ function expand(i,a)
 	var p = i-100;
 	d.getElementById(`p${p}o`).style.background = (expanded[i] || p != currentPreset)?"var(--c-2)":"var(--c-6)";
 	if (d.getElementById('seg' +i).innerHTML != "") return;
-	if (isPlaylist(p)) {
-		plJson[p] = pJson[p].playlist;
-		//make sure all keys are present in plJson[p]
-		formatArr(plJson[p]);
-		if (isNaN(plJson[p].repeat)) plJson[p].repeat = 0;
-		if (!plJson[p].r) plJson[p].r = false;
-		if (isNaN(plJson[p].end)) plJson[p].end = 0;
-
-		d.getElementById('seg' +i).innerHTML = makeP(p,true);
-		refreshPlE(p);
-	} else {
-		d.getElementById('seg' +i).innerHTML = makeP(p);
-	}
-	var papi = papiVal(p);
-	d.getElementById(`p${p}api`).value = papi;
-	if (papi.indexOf("Please") == 0) d.getElementById(`p${p}cstgl`).checked = true;
-	tglCs(p);
+	editP(i,p);
 }
 
 function unfocusSliders() {
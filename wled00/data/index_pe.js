@@ -0,0 +1,337 @@
+//WLED UI module: preset and playlist editor, loaded by the first expanded preset or "Create preset" (see loadMod())
+
+var plJson = {"0":{
+	"ps": [0],	
+	"dur": [100],	
+	"transition": [-1],	//to be inited to default transition dur
+	"repeat": 0,
+	"r": false,
+	"end": 0	
+}};
+
+function makePlSel(incPl=false) {
+	var plSelContent = "";
+	delete pJson["0"];	// remove filler preset
+	var arr = Object.entries(pJson);
+	for (var i = 0; i < arr.length; i++) {
+		var n = arr[i][1].n ? arr[i][1].n : "Preset " + arr[i][0];
+		if (!incPl && arr[i][1].playlist && arr[i][1].playlist.ps) continue; //remove playlists, sub-playlists not yet supported
+		plSelContent += `<option value=${arr[i][0]}>${n}</option>`
+	}
+	return plSelContent;
+}
+
+function refreshPlE(p) {
+	var plEDiv = d.getElementById(`ple${p}`);
+	if (!plEDiv) return;
+	var content = "";
+	for (var i = 0; i < plJson[p].ps.length; i++) {
+		content += makePlEntry(p,i);
+	}
+	plEDiv.innerHTML = content;
+	var dels = plEDiv.getElementsByClassName("btn-pl-del");
+	if (dels.length < 2) dels[0].style.display = "none";
+
+	var sels = d.getElementById(`seg${p+100}`).getElementsByClassName("sel");
+	for (var i of sels) {
+		if (i.dataset.val) {
+			if (parseInt(i.dataset.val) > 0) i.value = i.dataset.val;
+			else plJson[p].ps[i.dataset.index] = parseInt(i.value);
+		}
+	}
+}
+
+//p: preset ID, i: ps index
+function addPl(p,i) {
+	plJson[p].ps.splice(i+1,0,0);
+	plJson[p].dur.splice(i+1,0,plJson[p].dur[i]);
+	plJson[p].transition.splice(i+1,0,plJson[p].transition[i]);
+	refreshPlE(p);
+}
+
+function delPl(p,i) {
+	if (plJson[p].ps.length < 2) return;
+	plJson[p].ps.splice(i,1);
+	plJson[p].dur.splice(i,1);
+	plJson[p].transition.splice(i,1);
+	refreshPlE(p);
+}
+
+function plePs(p,i,field) {
+	plJson[p].ps[i] = parseInt(field.value);
+}
+
+function pleDur(p,i,field) {
+	if (field.validity.valid)
+		plJson[p].dur[i] = Math.floor(field.value*10);
+}
+
+function pleTr(p,i,field) {
+	if (field.validity.valid)
+		plJson[p].transition[i] = Math.floor(field.value*10);
+}
+
+function plR(p) {
+	var pl = plJson[p];
+	pl.r = d.getElementById(`pl${p}rtgl`).checked;
+	if (d.getElementById(`pl${p}rptgl`).checked) { //infinite
+		pl.repeat = 0;
+		delete pl.end;
+		d.getElementById(`pl${p}o1`).style.display = "none";
+	} else {
+		pl.repeat = parseInt(d.getElementById(`pl${p}rp`).value);
+		pl.end = parseInt(d.getElementById(`pl${p}selEnd`).value);
+		d.getElementById(`pl${p}o1`).style.display = "block";
+	}
+}
+
+function makeP(i,pl) {
+  var content = "";
+  if (pl) {
+		var rep = plJson[i].repeat ? plJson[i].repeat : 0;
+		content = `
+  <div class="first c">Playlist Entries</div>
+  <div id="ple${i}"></div><label class="check revchkl">
+    Shuffle
+    <input type="checkbox" id="pl${i}rtgl" onchange="plR(${i})" ${plJson[i].r?"checked":""}>
+    <span class="checkmark schk"></span>
+  </label>
+  <label class="check revchkl">
+    Repeat indefinitely
+    <input type="checkbox" id="pl${i}rptgl" onchange="plR(${i})" ${rep?"":"checked"}>
+    <span class="checkmark schk"></span>
+  </label>
+	<div id="pl${i}o1" style="display:${rep?"block":"none"}">
+  <div class="c">Repeat <input class="noslide" type="number" id="pl${i}rp" oninput="plR(${i})" max=127 min=0 value=${rep>0?rep:1}> times</div>
+  End preset:<br>
+  <select class="btn sel sel-ple" id="pl${i}selEnd" onchange="plR(${i})" data-val=${plJson[i].end?plJson[i].end:0}>
+		<option value=0>None</option>
+    ${makePlSel(true)}
+  </select>
+	</div>
+  <button class="btn btn-i btn-p" onclick="testPl(${i}, this)"><i class='icons btn-icon'>&#xe139;</i>Test</button>`;
+	}
+  else content = `<label class="check revchkl">
+		Include brightness
+		<input type="checkbox" id="p${i}ibtgl" checked>
+		<span class="checkmark schk"></span>
+	</label>
+	<label class="check revchkl">
+		Save segment bounds
+		<input type="checkbox" id="p${i}sbtgl" checked>
+		<span class="checkmark schk"></span>
+	</label>`;
+
+	return `
+	<input type="text" class="ptxt noslide" id="p${i}txt" autocomplete="off" maxlength=32 value="${(i>0)?pName(i):""}" placeholder="Enter name..."/><br>
+	<div class="c">Quick load label: <input type="text" class="qltxt noslide" maxlength=2 value="${qlName(i)}" id="p${i}ql" autocomplete="off"/></div>
+	<div class="h">(leave empty for no Quick load button)</div>
+	<div ${pl&&i==0?"style='display:none'":""}>
+	<label class="check revchkl">
+    ${pl?"Show playlist editor":(i>0)?"Overwrite with state":"Use current state"}
+    <input type="checkbox" id="p${i}cstgl" onchange="tglCs(${i})" ${(i==0||pl)?"checked":""}>
+    <span class="checkmark schk"></span>
+  </label><br>
+	</div>
+  <div class="po2" id="p${i}o2">
+    API command<br>
+    <textarea class="noslide" id="p${i}api"></textarea>
+  </div>
+  <div class="po1" id="p${i}o1">
+		${content}
+  </div>
+	<div class="c">Save to ID <input class="noslide" id="p${i}id" type="number" oninput="checkUsed(${i})" max=250 min=1 value=${(i>0)?i:getLowestUnusedP()}></div>
+	<div class="c">
+		<button class="btn btn-i btn-p" onclick="saveP(${i},${pl})"><i class="icons btn-icon">&#xe390;</i>Save ${(pl)?"playlist":(i>0)?"changes":"preset"}</button>
+		${(i>0)?'<button class="btn btn-i btn-p" id="p'+i+'del" onclick="delP('+i+')"><i class="icons btn-icon">&#xe037;</i>Delete '+(pl?"playlist":"preset"):
+						'<button class="btn btn-p" onclick="resetPUtil()">Cancel'}</button>
+	</div>
+	<div class="pwarn ${(i>0)?"bp":""} c" id="p${i}warn">
+
+	</div>
+	${(i>0)? ('<div class="h">ID ' +i+ '</div>'):""}`;
+}
+
+function makePUtil() {
+	d.getElementById('putil').innerHTML = `<div class="seg pres">
+		<div class="segname newseg">
+			New preset</div>
+		<div class="segin expanded">
+		${makeP(0)}</div></div>`;
+}
+
+function makePlEntry(p,i) {
+  return `
+  <div class="plentry">
+    <select class="btn sel sel-pl" onchange="plePs(${p},${i},this)" data-val=${plJson[p].ps[i]} data-index=${i}>
+		${makePlSel()}
+    </select>
+		<button class="btn btn-i btn-xs btn-pl-del" onclick="delPl(${p},${i})"><i class="icons btn-icon">&#xe037;</i></button>
+		<div class="h plnl">Duration</div><div class="h plnl">Transition</div><div class="h pli">#${i+1}</div><br>
+		<input class="noslide pln" type="number" max=6553.0 min=0.2 step=0.1 oninput="pleDur(${p},${i},this)" value=${plJson[p].dur[i]/10.0}>
+		<input class="noslide pln" type="number" max=65.0 min=0.0 step=0.1 oninput="pleTr(${p},${i},this)" value=${plJson[p].transition[i]/10.0}> s
+		<button class="btn btn-i btn-xs btn-pl-add" onclick="addPl(${p},${i})"><i class="icons btn-icon">&#xe18a;</i></button>
+    <div class="hrz"></div>
+  </div>`;
+}
+
+function makePlUtil() {
+  if (pNum < 2) {
+    showToast("You need at least 2 presets to make a playlist!"); return;
+  }
+	if (plJson[0].transition[0] < 0) plJson[0].transition[0] = tr;
+  d.getElementById('putil').innerHTML = `<div class="seg pres">
+  <div class="segname newseg">
+    New playlist</div>
+  <div class="segin expanded" id="seg100">
+  ${makeP(0,true)}</div></div>`;
+	
+	refreshPlE(0);
+}
+
+function tglCs(i){
+	var pss = d.getElementById(`p${i}cstgl`).checked;
+	d.getElementById(`p${i}o1`).style.display = pss? "block" : "none";
+	d.getElementById(`p${i}o2`).style.display = !pss? "block" : "none";
+}
+
+function saveP(i,pl) {
+	pI = parseInt(d.getElementById(`p${i}id`).value);
+	if (!pI || pI < 1) pI = (i>0) ? i : getLowestUnusedP();
+	pN = d.getElementById(`p${i}txt`).value;
+
+	if (pN == "") pN = (pl?"Playlist ":"Preset ") + pI;
+	var obj = {};
+
+	if (!d.getElementById(`p${i}cstgl`).checked) {
+		var raw = d.getElementById(`p${i}api`).value;
+		try {
+			obj = JSON.parse(raw);
+		} catch (e) {
+			obj.win = raw;
+			if (raw.length < 2) {
+				d.getElementById(`p${i}warn`).innerHTML = "&#9888; Please enter your API command first";
+				return;
+			} else if (raw.indexOf('{') > -1) {
+				d.getElementById(`p${i}warn`).innerHTML = "&#9888; Syntax error in custom JSON API command";
+				return;
+			} else if (raw.indexOf("Please") == 0) {
+				d.getElementById(`p${i}warn`).innerHTML = "&#9888; Please refresh the page before modifying this preset";
+				return;
+			}
+		}
+		obj.o = true;
+	} else {
+		if (pl) {
+			obj.playlist = plJson[i];
+			obj.on = true;
+			obj.o = true;
+		} else {
+			obj.ib = d.getElementById(`p${i}ibtgl`).checked;
+			obj.sb = d.getElementById(`p${i}sbtgl`).checked;
+		}
+	}
+
+	obj.psave = pI; obj.n = pN;
+	var pQN = d.getElementById(`p${i}ql`).value;
+	if (pQN.length > 0) obj.ql = pQN;
+
+  showToast("Saving " + pN +" (" + pI + ")");
+	requestJson(obj);
+	if (obj.o) {
+		pJson[pI] = obj;
+		delete pJson[pI].psave;
+		delete pJson[pI].o;
+		delete pJson[pI].v;
+		delete pJson[pI].time;
+	} else {
+		pJson[pI] = {"n":pN, "win":"Please refresh the page to see this newly saved command."};
+		if (obj.win) pJson[pI].win = obj.win;
+		if (obj.ql)  pJson[pI].ql = obj.ql;
+	}
+	populatePresets();
+	resetPUtil();
+}
+
+function testPl(i,bt) {
+	if (bt.dataset.test == 1) {
+		bt.dataset.test = 0;
+		bt.innerHTML = "<i class='icons btn-icon'>&#xe139;</i>Test";
+		stopPl();
+		return;
+	}
+	bt.dataset.test = 1;
+	bt.innerHTML = "<i class='icons btn-icon'>&#xe38f;</i>Stop";
+	var obj = {};
+	obj.playlist = plJson[i];
+	obj.on = true;
+	requestJson(obj);
+}
+
+function stopPl() {
+	requestJson({playlist:{}})
+}
+
+function delP(i) {
+	var bt = d.getElementById(`p${i}del`);
+	if (bt.dataset.cnf == 1) {
+		var obj = {"pdel": i};
+		requestJson(obj);
+		delete pJson[i];
+		populatePresets();
+	} else {
+		bt.style.color = "#f00";
+		bt.innerHTML = "<i class='icons btn-icon'>&#xe037;</i>Confirm delete";
+		bt.dataset.cnf = 1;
+	}
+}
+
+//make sure "dur" and "transition" are arrays with at least the length of "ps"
+function formatArr(pl) {
+	var l = pl.ps.length;
+	if (!Array.isArray(pl.dur)) {
+		var v = pl.dur;
+		if (isNaN(v)) v = 100;
+		pl.dur = [v];
+	}
+	var l2 = pl.dur.length;
+	if (l2 < l)
+	{
+		for (var i = 0; i < l - l2; i++)
+			pl.dur.push(pl.dur[l2-1]);
+	}
+
+	if (!Array.isArray(pl.transition)) {
+		var v = pl.transition;
+		if (isNaN(v)) v = tr;
+		pl.transition = [v];
+	}
+	var l2 = pl.transition.length;
+	if (l2 < l)
+	{
+		for (var i = 0; i < l - l2; i++)
+			pl.transition.push(pl.transition[l2-1]);
+	}
+}
+
+//fills the editor of preset p into element seg<i>, called by expand()
+function editP(i,p)
+{
+	if (isPlaylist(p)) {
+		plJson[p] = pJson[p].playlist;
+		//make sure all keys are present in plJson[p]
+		formatArr(plJson[p]);
+		if (isNaN(plJson[p].repeat)) plJson[p].repeat = 0;
+		if (!plJson[p].r) plJson[p].r = false;
+		if (isNaN(plJson[p].end)) plJson[p].end = 0;
+
+		d.getElementById('seg' +i).innerHTML = makeP(p,true);
+		refreshPlE(p);
+	} else {
+		d.getElementById('seg' +i).innerHTML = makeP(p);
+	}
+	var papi = papiVal(p);
+	d.getElementById(`p${p}api`).value = papi;
+	if (papi.indexOf("Please") == 0) d.getElementById(`p${p}cstgl`).checked = true;
+	tglCs(p);
+}
@@ -0,0 +1,156 @@
+//WLED UI module: palette previews, loaded after the presets (see loadMod())
+
+function redrawPalPrev()
+{
+	let palettes = d.querySelectorAll('#pallist .lstI');
+	for (let i = 0; i < palettes.length; i++) {
+		let id = palettes[i].dataset.id;
+		let lstPrev = palettes[i].querySelector('.lstIprev');
+		if (lstPrev) {
+			lstPrev.style = genPalPrevCss(id);
+		}
+	}
+}
+
+function genPalPrevCss(id)
+{
+	if (!palettesData) {
+		return;
+	}
+	var paletteData = palettesData[id];
+
+	if (!paletteData) {
+		return 'display: none';
+	}
+
+	// We need at least two colors for a gradient
+	if (paletteData.length == 1) {
+		paletteData[1] = paletteData[0];
+		if (Array.isArray(paletteData[1])) {
+			paletteData[1][0] = 255;
+		}
+	}
+
+	var gradient = [];
+	for (let j = 0; j < paletteData.length; j++) {
+		const element = paletteData[j];
+		let r;
+		let g;
+		let b;
+		let index = false;
+		if (Array.isArray(element)) {
+			index = element[0]/255*100;
+			r = element[1];
+			g = element[2];
+			b = element[3];
+		} else if (element == 'r') {
+			r = Math.random() * 255;
+			g = Math.random() * 255;
+			b = Math.random() * 255;
+		} else {
+			if (selColors) {
+				let pos = element[1] - 1;
+				r = selColors[pos][0];
+				g = selColors[pos][1];
+				b = selColors[pos][2];
+			}
+		}
+		if (index === false) {
+			index = j / paletteData.length * 100;
+		}
+		
+		gradient.push(`rgb(${r},${g},${b}) ${index}%`);
+	}
+
+	return `background: linear-gradient(to right,${gradient.join()});`;
+}
+
+
+function loadPalettesData(callback = null)
+{
+	if (palettesData) return;
+	const lsKey = "wledPalx";
+	var palettesDataJson = localStorage.getItem(lsKey);
+	if (palettesDataJson) {
+		try {
+			palettesDataJson = JSON.parse(palettesDataJson);
+			var d = new Date();
+			if (palettesDataJson && palettesDataJson.vid == lastinfo.vid && palettesDataJson.cpal == lastinfo.cpalcount) {
+				palettesData = palettesDataJson.p;
+				//redrawPalPrev() //?
+				if (callback) callback();
+				return;
+			}
+		} catch (e) {}
+	}
+
+	palettesData = {};
+	getStaticPalettesData(function(ok) {
+		getPalettesData(0, ok, function() {
+			localStorage.setItem(lsKey, JSON.stringify({
+				p: palettesData,
+				vid: lastinfo.vid,
+				cpal: lastinfo.cpalcount
+			}));
+			redrawPalPrev();
+			if (callback) setTimeout(callback, 99); //go on to connect websocket
+		});
+	});
+}
+
+//gradient palettes are a static file, only the others need to be generated by /json/palx
+function getStaticPalettesData(callback)
+{
+	var url = `/palettes.json?v=${lastinfo.vid}`;
+	if (loc) {
+		url = `http://${locip}${url}`;
+	}
+
+	fetch(url, {
+		method: 'get'
+	})
+	.then(res => {
+		if (!res.ok) throw new Error(res.status);
+		return res.json();
+	})
+	.then(json => {
+		palettesData = Object.assign({}, palettesData, json.p);
+		callback(true);
+	})
+	.catch(function (error) {
+		callback(false); //older firmware, get all of them from /json/palx
+	});
+}
+
+function getPalettesData(page, rt, callback)
+{
+	var url = `/json/palx?page=${page}${rt ? '&rt' : ''}`;
+	if (loc) {
+		url = `http://${locip}${url}`;
+	}
+
+	fetch(url, {
+		method: 'get',
+		headers: {
+			"Content-type": "application/json; charset=UTF-8"
+		}
+	})
+	.then(res => {
+		if (!res.ok) {
+			showErrorToast();
+		}
+		return res.json();
+	})
+	.then(json => {
+		palettesData = Object.assign({}, palettesData, json.p);
+		if (page < json.m) {
+			getPalettesData(page + 1, rt, callback);
+		} else {
+			callback();
+		}
+	})
+	.catch(function (error) {
+		showToast(error, true);
+		console.log(error);
+	});
+}
@@ -0,0 +1,32 @@
+//WLED UI module: new segment form, loaded by "Add segment" (see loadMod())
+
+function makeSeg() {
+	var ns = 0;
+	if (lowestUnused > 0) {
+		var pend = parseInt(d.getElementById(`seg${lowestUnused -1}e`).value,10) + (cfg.comp.seglen?parseInt(d.getElementById(`seg${lowestUnused -1}s`).value,10):0);
+		if (pend < ledCount) ns = pend;
+	}
+	var cn = `<div class="seg">
+			<div class="segname newseg">
+				New segment ${lowestUnused}
+        <i class="icons edit-icon expanded" onclick="tglSegn(${lowestUnused})">&#xe2c6;</i>
+			</div>
+			<br>
+			<div class="segin expanded">
+        <input type="text" class="ptxt stxt noslide" id="seg${lowestUnused}t" autocomplete="off" maxlength=32 value="" placeholder="Enter name..."/>
+				<table class="segt">
+					<tr>
+						<td class="segtd">Start LED</td>
+						<td class="segtd">${cfg.comp.seglen?"Length":"Stop LED"}</td>
+					</tr>
+					<tr>
+						<td class="segtd"><input class="noslide segn" id="seg${lowestUnused}s" type="number" min="0" max="${ledCount-1}" value="${ns}" oninput="updateLen(${lowestUnused})"></td>
+						<td class="segtd"><input class="noslide segn" id="seg${lowestUnused}e" type="number" min="0" max="${ledCount-(cfg.comp.seglen?ns:0)}" value="${ledCount-(cfg.comp.seglen?ns:0)}" oninput="updateLen(${lowestUnused})"></td>
+					</tr>
+				</table>
+				<div class="h" id="seg${lowestUnused}len">${ledCount - ns} LED${ledCount - ns >1 ? "s":""}</div>
+				<i class="icons e-icon cnf cnf-s half" id="segc${lowestUnused}" onclick="setSeg(${lowestUnused}); resetUtil();">&#xe390;</i>
+			</div>
+		</div>`;
+	d.getElementById('segutil').innerHTML = cn;
+}
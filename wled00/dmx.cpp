@@ -9,61 +9,127 @@
 
 #ifdef WLED_ENABLE_DMX
 
+#ifndef WLED_DMX_REFRESH_INTERVAL
+  #define WLED_DMX_REFRESH_INTERVAL 500 //resend an unchanged frame after this many ms, many fixtures black out without frames for ~1s
+#endif
+
+//what a fixture channel is filled with, 0-3 select a byte of the pixel color (B,G,R,W)
+#define DMX_SRC_BRI  4
+#define DMX_SRC_ZERO 5
+#define DMX_SRC_FULL 6
+
+static uint8_t dmxChannelSrc[15];   //DMXFixtureMap compiled to DMX_SRC_* or a color byte
+static uint16_t dmxFixtures = 0;    //fixtures that fit into the universe
+static uint16_t dmxMapLeds = 0;     //LED count the map was built for
+static bool dmxForce = true;        //send a full frame with the next update
+static bool dmxProxyActive = false; //bus is set up for a full proxied universe
+static bool dmxProxyDirty = false;  //proxied universe received since the last frame was sent
+
+static void buildDMXMap()
+{
+  for (uint8_t j = 0; j < 15; j++) {
+    switch (DMXFixtureMap[j]) {
+      case 1:  dmxChannelSrc[j] = 2; break;            // Red
+      case 2:  dmxChannelSrc[j] = 1; break;            // Green
+      case 3:  dmxChannelSrc[j] = 0; break;            // Blue
+      case 4:  dmxChannelSrc[j] = 3; break;            // White
+      case 5:  dmxChannelSrc[j] = DMX_SRC_BRI; break;  // Shutter channel. Controls the brightness.
+      case 6:  dmxChannelSrc[j] = DMX_SRC_FULL; break; // Sets this channel to 255. Like 0, but more wholesome.
+      default: dmxChannelSrc[j] = DMX_SRC_ZERO; break; // Set this channel to 0. Good way to tell strobe- and fade-functions to fuck right off.
+    }
+  }
+
+  // uses the amount of LEDs as fixture count, fixtures not fitting into the universe are dropped
+  dmxMapLeds = strip.getLengthTotal();
+  dmxFixtures = 0;
+  uint16_t lastChannel = 0;
+  if (DMXStart > 0 && DMXChannels > 0) {
+    for (uint16_t i = DMXStartLED; i < dmxMapLeds; i++) {
+      uint32_t end = DMXStart + (uint32_t)DMXGap * dmxFixtures + DMXChannels - 1;
+      if (end > 512) break;
+      if (end > lastChannel) lastChannel = end;
+      dmxFixtures++;
+    }
+  }
+
+  dmx.init(lastChannel + 1);   // only send the channels in use (+ start code), a full universe takes 23ms
+  doBuildDMXMap = false;
+  dmxForce = true;
+}
+
+//called for every packet of e131ProxyUniverse, data[0] is channel 1
+void handleDMXProxy(const uint8_t* data, uint16_t len)
+{
+  if (!dmxProxyActive) return;
+  dmx.write(1, data, len);
+  dmxProxyDirty = true;
+}
+
 void handleDMX()
 {
-  // don't act, when in DMX Proxy mode
-  if (e131ProxyUniverse != 0) return;
+  if (dmx.continueUpdate()) return; // last frame is still being sent
+
+  // in DMX Proxy mode, send the latest proxied universe whenever the bus is free
+  if (e131ProxyUniverse != 0) {
+    if (!dmxProxyActive) {
+      dmx.init(513);
+      dmxProxyActive = true;
+      dmxProxyDirty = false;
+    }
+    if (!dmxProxyDirty) return;
+    dmxProxyDirty = false;
+    dmx.beginUpdate();
+    return;
+  }
+  if (dmxProxyActive) {
+    dmxProxyActive = false;
+    doBuildDMXMap = true;
+  }
+
+  if (doBuildDMXMap || strip.getLengthTotal() != dmxMapLeds) buildDMXMap();
+
+  static uint32_t lastShow = 0;
+  static unsigned long lastUpdate = 0;
+  static uint8_t lastBri = 0;
 
   // TODO: calculate brightness manually if no shutter channel is set
 
   uint8_t brightness = strip.getBrightness();
+  bool changed = dmxForce;
 
-  uint16_t len = strip.getLengthTotal();
-  for (int i = DMXStartLED; i < len; i++) {        // uses the amount of LEDs as fixture count
-
-    uint32_t in = strip.getPixelColor(i);     // get the colors for the individual fixtures as suggested by Aircoookie in issue #462
-    byte w = in >> 24 & 0xFF;
-    byte r = in >> 16 & 0xFF;
-    byte g = in >> 8 & 0xFF;
-    byte b = in & 0xFF;
-
-    int DMXFixtureStart = DMXStart + (DMXGap * (i - DMXStartLED));
-    for (int j = 0; j < DMXChannels; j++) {
-      int DMXAddr = DMXFixtureStart + j;
-      switch (DMXFixtureMap[j]) {
-        case 0:        // Set this channel to 0. Good way to tell strobe- and fade-functions to fuck right off.
-          dmx.write(DMXAddr, 0);
-          break;
-        case 1:        // Red
-          dmx.write(DMXAddr, r);
-          break;
-        case 2:        // Green
-          dmx.write(DMXAddr, g);
-          break;
-        case 3:        // Blue
-          dmx.write(DMXAddr, b);
-          break;
-        case 4:        // White
-          dmx.write(DMXAddr, w);
-          break;
-        case 5:        // Shutter channel. Controls the brightness.
-          dmx.write(DMXAddr, brightness);
-          break;
-        case 6:        // Sets this channel to 255. Like 0, but more wholesome.
-          dmx.write(DMXAddr, 255);
-          break;
+  // the frame only needs to be refilled when the strip showed a new one, the DMX rate may be lower than the strip's
+  bool due = !DMXFps || millis() - lastUpdate >= 1000u / DMXFps;
+  if (dmxForce || (due && (strip.getLastShow() != lastShow || brightness != lastBri))) {
+    lastShow = strip.getLastShow();
+    lastBri = brightness;
+    uint16_t addr = DMXStart;
+    for (uint16_t f = 0; f < dmxFixtures; f++, addr += DMXGap) {
+      uint32_t in = busses.getPixelColor(DMXStartLED + f);
+      for (uint8_t j = 0; j < DMXChannels; j++) {
+        uint8_t src = dmxChannelSrc[j], val;
+        if      (src < 4)              val = in >> (src * 8);
+        else if (src == DMX_SRC_BRI)   val = brightness;
+        else if (src == DMX_SRC_FULL)  val = 255;
+        else                           val = 0;
+        if (dmx.read(addr + j) == val) continue;
+        dmx.write(addr + j, val);
+        changed = true;
       }
     }
   }
 
-  dmx.update();        // update the DMX bus
+  if (!changed && millis() - lastUpdate < WLED_DMX_REFRESH_INTERVAL) return;
+  dmx.beginUpdate();   // update the DMX bus, the frame is sent from the next handleDMX() calls
+  lastUpdate = millis();
+  dmxForce = false;
 }
 
 void initDMX() {
-  dmx.init(512);        // initialize with bus length
+  buildDMXMap();
 }
 
 #else
 void handleDMX() {}
+void handleDMXProxy(const uint8_t* data, uint16_t len) {}
 void initDMX() {}
 #endif
@@ -8,10 +8,201 @@
  * E1.31 handler
  */
 
+#if E131_MAX_ROUTES <= E131_MAX_UNIVERSE_COUNT
+  #error "E131_MAX_ROUTES must be larger than E131_MAX_UNIVERSE_COUNT"
+#endif
+
+// universes the sender transmits per frame in DMX_MODE_MULTIPLE_* modes (bit n = e131Universe + n)
+static uint32_t e131UniverseMask = 0;
+static uint32_t e131LastPartialMask = 0;
+#if E131_MAX_UNIVERSE_COUNT > 32
+  #error "E131_MAX_UNIVERSE_COUNT must not exceed 32, the universes of a frame are tracked in a 32 bit mask"
+#endif
+
+/*
+ * Routing table: a packet of universe e131Universe + n is copied to the LEDs by the routes
+ * e131RouteFirst[n] to e131RouteFirst[n+1] -1. Compiled from the DMX mode (DMX_MODE_MULTIPLE_*) or from the
+ * configured routes (DMX_MODE_ROUTED) when the settings or the LED count change, not per packet.
+ */
+typedef struct E131Route {
+  uint16_t channel;  // first DMX channel, 1-512
+  uint16_t start;    // first LED
+  uint16_t len;      // LEDs
+  uint16_t universe; // absolute in the config, offset from e131Universe once compiled
+  uint8_t type;      // E131_ROUTE_*
+} E131Route;
+
+static E131Route e131UserRoutes[E131_MAX_ROUTES]; // DMX_MODE_ROUTED, as configured
+static uint8_t e131UserRouteCount = 0;
+static E131Route e131Routes[E131_MAX_ROUTES];     // compiled, ordered by universe
+static uint8_t e131RouteFirst[E131_MAX_UNIVERSE_COUNT +1];
+static uint32_t e131RouteMask = 0;                // universes with routes to LEDs of the strip
+static uint16_t e131RouteLeds = 0;                // LED count the table was compiled for
+
+// DMX_MODE_EFFECT: dimmer, effect, speed, intensity, palette, primary and secondary RGB, primary and secondary white
+#define E131_EFFECT_CHANNELS 13
+static uint8_t e131EffectLast[E131_EFFECT_CHANNELS]; // channels of the last packet
+static uint8_t e131EffectLen = 0;                    // 0 until the first packet
+
+// {"uni":universe,"addr":first channel,"start":first LED,"len":LEDs,"type":E131_ROUTE_*}
+void deserializeE131Routes(JsonArray routes)
+{
+  e131UserRouteCount = 0;
+  for (JsonObject r : routes) {
+    if (e131UserRouteCount >= E131_MAX_ROUTES) break;
+    E131Route& rt = e131UserRoutes[e131UserRouteCount];
+    rt.universe = r[F("uni")] | e131Universe;
+    rt.channel  = constrain(r[F("addr")] | 1, 1, MAX_CHANNELS_PER_UNIVERSE);
+    rt.start    = r["start"] | 0;
+    rt.len      = r["len"] | 0;
+    rt.type     = r["type"] | E131_ROUTE_RGB;
+    if (rt.type > E131_ROUTE_DIMMER) continue;
+    e131UserRouteCount++;
+  }
+  e131RoutesDirty = true;
+}
+
+void serializeE131Routes(JsonArray routes)
+{
+  for (uint8_t i = 0; i < e131UserRouteCount; i++) {
+    const E131Route& rt = e131UserRoutes[i];
+    JsonObject r = routes.createNestedObject();
+    r[F("uni")]  = rt.universe;
+    r[F("addr")] = rt.channel;
+    r["start"]   = rt.start;
+    r["len"]     = rt.len;
+    r["type"]    = rt.type;
+  }
+}
+
+static void addE131Route(uint8_t& n, uint8_t universe, uint16_t channel, uint16_t start, uint16_t len, uint8_t type)
+{
+  if (n >= E131_MAX_ROUTES || channel < 1 || channel > MAX_CHANNELS_PER_UNIVERSE) return;
+  uint8_t bpp = (type == E131_ROUTE_RGBW) ? 4 : 3;
+  if (type == E131_ROUTE_DIMMER) len = 1;
+  else len = MIN(len, (MAX_CHANNELS_PER_UNIVERSE - channel + 1) / bpp);
+  if (!len) return;
+  e131Routes[n++] = {channel, start, len, universe, type};
+  if (type == E131_ROUTE_DIMMER || start < e131RouteLeds) e131RouteMask |= 1UL << universe;
+}
+
+static void compileE131Routes()
+{
+  uint8_t n = 0;
+  e131RouteLeds = strip.getLengthTotal();
+  e131RouteMask = 0;
+  if (DMXMode == DMX_MODE_ROUTED) {
+    for (uint8_t u = 0; u < E131_MAX_UNIVERSE_COUNT; u++) { // in universe order
+      for (uint8_t i = 0; i < e131UserRouteCount; i++) {
+        const E131Route& rt = e131UserRoutes[i];
+        if (rt.universe == e131Universe + u) addE131Route(n, u, rt.channel, rt.start, rt.len, rt.type);
+      }
+    }
+  } else if (DMXMode >= DMX_MODE_MULTIPLE_RGB && DMXMode <= DMX_MODE_MULTIPLE_RGBW) {
+    // the layouts of the fixed modes: first universe from DMXAddress, the following ones full, up to E131_MAX_UNIVERSE_COUNT
+    bool is4Chan = (DMXMode == DMX_MODE_MULTIPLE_RGBW);
+    uint8_t type = is4Chan ? E131_ROUTE_RGBW : E131_ROUTE_RGB;
+    uint16_t channel = MAX(DMXAddress, (uint16_t)1);
+    uint16_t len = (MAX_CHANNELS_PER_UNIVERSE - DMXAddress) / (is4Chan ? 4 : 3);
+    if (DMXMode == DMX_MODE_MULTIPLE_DRGB) addE131Route(n, 0, channel++, 0, 1, E131_ROUTE_DIMMER);
+    uint16_t led = 0;
+    for (uint8_t u = 0; u < E131_MAX_UNIVERSE_COUNT; u++) {
+      addE131Route(n, u, channel, led, len, type);
+      led += len;
+      channel = 1;
+      len = is4Chan ? MAX_4_CH_LEDS_PER_UNIVERSE : MAX_3_CH_LEDS_PER_UNIVERSE;
+    }
+  }
+  // index of the first route of each universe, the routes are in universe order
+  uint8_t r = 0;
+  for (uint8_t u = 0; u <= E131_MAX_UNIVERSE_COUNT; u++) {
+    while (r < n && e131Routes[r].universe < u) r++;
+    e131RouteFirst[u] = r;
+  }
+  e131RoutesDirty = false;
+  DEBUG_PRINTF("E1.31 routing table: %u routes\n", n);
+}
+
+// synchronous output is active while the sender keeps sending ArtSync / E1.31 sync packets
+static bool e131SyncActive()
+{
+  return e131LastSync && millis() - e131LastSync < E131_SYNC_TIMEOUT;
+}
+
+// hand the assembled frame over to handleNotifications() for showing
+void e131FinishFrame(bool partial)
+{
+  if (e131NewData || e131SyncPending) e131DroppedFrames++; // previous frame was never shown
+  if (partial) {
+    e131PartialFrames++;
+    // the sender consistently transmits fewer universes than we expect, adopt its set
+    if (e131UniversesReceived && e131UniversesReceived == e131LastPartialMask) e131UniverseMask = e131UniversesReceived;
+    e131LastPartialMask = e131UniversesReceived;
+  }
+  e131UniversesReceived = 0;
+  if (e131SyncActive()) { // latched by the next sync packet
+    e131SyncPending = true;
+    return;
+  }
+  e131NewData = true;
+  e131FrameComplete = true;
+}
+
+// ArtSync or E1.31 sync packet: show the frame received since the last sync
+static void handleE131Sync()
+{
+  e131LastSync = millis();
+  if (e131UniversesReceived) e131FinishFrame((e131UniversesReceived & e131UniverseMask) != e131UniverseMask);
+  if (!e131SyncPending) return;
+  e131SyncPending = false;
+  e131NewData = true;
+  e131FrameComplete = true;
+}
+
+#ifdef ARDUINO_ARCH_ESP32
+#define DDP_TIMECODE_WINDOW 64 // frames over which the smallest transit time is tracked
+
+//the timecode (16.16 seconds) is on the sender's clock. Frames are presented DDP_TIMECODE_LATENCY after the fastest
+//transit seen recently, measured on the synced node clock (millis() + timebase), so nodes sharing a timebase show frames
+//together and WiFi jitter up to the latency is absorbed. The next frame waits in the receive queue meanwhile, see handleE131Queue()
+static void scheduleDDPFrame(uint32_t timecode)
+{
+  static int32_t offset = 0;        // smallest node clock minus sender clock, i.e. fastest transit
+  static int32_t windowOffset = 0;  // smallest one in the current window, becomes offset to follow clock drift
+  static uint8_t windowFrames = 0;
+  static bool synced = false;
+  uint32_t t = ((uint64_t)timecode * 1000) >> 16;
+  uint32_t now = millis() + strip.timebase;
+  int32_t o = now - t;
+  if (!synced || (int32_t)(t + offset + DDP_TIMECODE_LATENCY - now) > 4*DDP_TIMECODE_LATENCY) { // start or sender clock went back
+    offset = windowOffset = o;
+    windowFrames = 0;
+    synced = true;
+  }
+  if (o < offset) offset = o;
+  if (!windowFrames || o < windowOffset) windowOffset = o;
+  if (++windowFrames >= DDP_TIMECODE_WINDOW) {
+    offset = windowOffset;
+    windowFrames = 0;
+  }
+  int32_t due = t + offset + DDP_TIMECODE_LATENCY - now; // late frames are shown right away
+  e131ShowAt = (millis() + (due > 0 ? due : 0)) | 1;      // 0 means show now
+}
+#endif
+
 //DDP protocol support, called by handleE131Packet
-//handles RGB data only
+//handles 8 and 16 bit RGB and RGBW data
 void handleDDPPacket(e131_packet_t* p) {
+  static uint8_t lastSeq = 0;
   int lastPushSeq = e131LastSequenceNumber[0];
+
+  //sequence numbers run from 1 to 15, 0 means the sender does not use them
+  uint8_t seq = p->sequenceNum & 0xF;
+  if (seq && lastSeq) {
+    uint8_t gap = (seq + 15 - lastSeq -1) % 15;
+    if (gap < 8) udpInLost += gap; //larger gaps are late or repeated packets
+  }
+  if (seq) lastSeq = seq;
   
   //reject late packets belonging to previous frame (assuming 4 packets max. before push)
   if (e131SkipOutOfSequence && lastPushSeq) {
@@ -25,44 +216,188 @@ void handleDDPPacket(e131_packet_t* p) {
     }
   }
 
-  uint32_t start = htonl(p->channelOffset) /3;
-  start += DMXAddress /3;
-  uint16_t stop = start + htons(p->dataLen) /3;
+  //undefined type and size are sent by older senders and mean 8 bit RGB
+  uint8_t format = DDP_TYPE_FORMAT(p->dataType);
+  uint8_t size = DDP_TYPE_SIZE(p->dataType);
+  if (format == DDP_FORMAT_UNDEFINED) format = DDP_FORMAT_RGB;
+  if (size == DDP_SIZE_UNDEFINED) size = DDP_SIZE_8BIT;
+  if ((format != DDP_FORMAT_RGB && format != DDP_FORMAT_RGBW) || (size != DDP_SIZE_8BIT && size != DDP_SIZE_16BIT)) return;
+  bool rgbw = (format == DDP_FORMAT_RGBW);
+  uint8_t channels = rgbw ? 4 : 3;
+  uint8_t bytesPerPixel = channels * (size == DDP_SIZE_16BIT ? 2 : 1);
+
   uint8_t* data = p->data;
-  uint16_t c = 0;
-  if (p->flags & DDP_TIMECODE_FLAG) c = 4; //packet has timecode flag, we do not support it, but data starts 4 bytes later
+  uint32_t timecode = 0;
+  if (p->flags & DDP_TIMECODE_FLAG) { //pixel data starts after the timecode
+    timecode = (data[0] << 24) | (data[1] << 16) | (data[2] << 8) | data[3];
+    data += 4;
+  }
+
+  uint32_t start = htonl(p->channelOffset) / bytesPerPixel;
+  start += DMXAddress / channels;
+  uint16_t len = htons(p->dataLen) / bytesPerPixel;
+
+  //16 bit elements are big endian, keep the high bytes in place for the 8 bit ingest path
+  if (size == DDP_SIZE_16BIT) for (uint16_t i = 0; i < len * channels; i++) data[i] = data[i*2];
 
   realtimeLock(realtimeTimeoutMs, REALTIME_MODE_DDP);
   
-  for (uint16_t i = start; i < stop; i++) {
-    setRealtimePixel(i, data[c], data[c+1], data[c+2], 0);
-    c+=3;
-  }
+  if (len) setRealtimePixels(start, data, len, rgbw);
 
   bool push = p->flags & DDP_PUSH_FLAG;
   if (push) {
     e131NewData = true;
+    e131FrameComplete = true; // push marks the end of a frame
     byte sn = p->sequenceNum & 0xF;
     if (sn) e131LastSequenceNumber[0] = sn;
+    #ifdef ARDUINO_ARCH_ESP32
+    if (p->flags & DDP_TIMECODE_FLAG) scheduleDDPFrame(timecode);
+    #endif
   }
 }
 
 //E1.31 and Art-Net protocol support
-void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
+// true if the packet is to be skipped as out of sequence, counts the packets lost before it otherwise
+static bool e131SequenceSkipped(uint8_t seq, uint8_t lastSeq, byte protocol, byte mde)
+{
+  if (e131SkipOutOfSequence && seq < lastSeq && seq > 20 && lastSeq < 250) return true;
+  //count packets lost on the network or in full receive queues (Art-Net: 0 = sequence numbers not used)
+  if (realtimeMode == mde && (protocol == P_E131 || (seq && lastSeq))) {
+    uint8_t gap = seq - lastSeq -1;
+    if (protocol == P_ARTNET && seq < lastSeq && gap) gap--; //Art-Net skips 0 when wrapping
+    if (gap < 128) udpInLost += gap;
+  }
+  return false;
+}
+
+/*
+ * Merging of several senders (E131_MAX_SOURCES) of the first E131_MERGE_UNIVERSES universes.
+ * Only the sources of the highest E1.31 priority seen within E131_SOURCE_TIMEOUT are shown (Art-Net: E131_DEFAULT_PRIORITY),
+ * several of them are merged highest takes precedence (HTP) or latest takes precedence (LTP, per packet).
+ * The last data of each source is kept, so when the active one stops or times out the next one takes over with its
+ * next packet, without a gap.
+ */
+typedef struct E131Source {
+  uint8_t cid[16];                              // E1.31 CID, the IP address for Art-Net
+  uint32_t seen[E131_MERGE_UNIVERSES];          // millis() of the last packet per universe, 0 for none
+  uint16_t len[E131_MERGE_UNIVERSES];           // channels
+  uint8_t seq[E131_MERGE_UNIVERSES];
+  uint8_t priority[E131_MERGE_UNIVERSES];
+} E131Source;
+
+static E131Source e131Sources[E131_MAX_SOURCES];
+static uint32_t* e131SourceData = nullptr; // 512 channels per source and universe, word aligned for the merge, then the merge result
+
+static inline uint8_t* e131SourceBuf(uint8_t s, uint8_t u)
+{
+  return (uint8_t*)(e131SourceData + ((uint16_t)s * E131_MERGE_UNIVERSES + u) * (MAX_CHANNELS_PER_UNIVERSE / 4));
+}
+
+static inline bool e131SourceLive(uint8_t s, uint8_t u, uint32_t now)
+{
+  return e131Sources[s].seen[u] && now - e131Sources[s].seen[u] < E131_SOURCE_TIMEOUT;
+}
+
+static void e131ReleaseSource(const uint8_t* cid)
+{
+  for (uint8_t s = 0; s < E131_MAX_SOURCES; s++) {
+    if (!memcmp(e131Sources[s].cid, cid, sizeof(e131Sources[s].cid))) memset(e131Sources[s].seen, 0, sizeof(e131Sources[s].seen));
+  }
+}
+
+// bytewise maximum of 4 channels at once
+static inline uint32_t e131MaxBytes(uint32_t x, uint32_t y)
+{
+  const uint32_t H = 0x80808080;
+  uint32_t d = (x | H) - (y & ~H);                 // high bit of each byte: low 7 bits of x >= those of y
+  uint32_t ge = ((x & ~y) | (~(x ^ y) & d)) & H;   // x >= y
+  uint32_t mask = (ge >> 7) * 0xFF;
+  return (x & mask) | (y & ~mask);
+}
+
+// keeps the packet of a source and replaces its channels by what is to be shown, false if it is not to be shown
+static bool e131Merge(const uint8_t* cid, uint8_t priority, uint8_t u, uint8_t seq, byte protocol, byte mde, uint8_t* channels, uint16_t& len)
+{
+  if (u >= E131_MERGE_UNIVERSES || len > MAX_CHANNELS_PER_UNIVERSE) return true; // not merged, the last packet wins
+  const size_t bufLen = ((size_t)E131_MAX_SOURCES * E131_MERGE_UNIVERSES + 1) * MAX_CHANNELS_PER_UNIVERSE;
+  if (!e131SourceData) {
+    e131SourceData = (uint32_t*)allocLarge(bufLen);
+    if (!e131SourceData) return true;
+    memset(e131SourceData, 0, bufLen);
+    memset(e131Sources, 0, sizeof(e131Sources));
+  }
+  uint32_t now = millis();
+  int8_t s = -1, unused = -1;
+  for (uint8_t i = 0; i < E131_MAX_SOURCES && s < 0; i++) {
+    if (!memcmp(e131Sources[i].cid, cid, sizeof(e131Sources[i].cid))) s = i;
+    else if (unused < 0) {
+      bool live = false;
+      for (uint8_t j = 0; j < E131_MERGE_UNIVERSES && !live; j++) live = e131SourceLive(i, j, now);
+      if (!live) unused = i;
+    }
+  }
+  if (s < 0) { // new source
+    if (unused < 0) return false; // as many as we can track are sending
+    s = unused;
+    memcpy(e131Sources[s].cid, cid, sizeof(e131Sources[s].cid));
+    memset(e131Sources[s].seen, 0, sizeof(e131Sources[s].seen));
+  }
+  E131Source& src = e131Sources[s];
+  if (src.seen[u] && e131SequenceSkipped(seq, src.seq[u], protocol, mde)) return false;
+  uint8_t* buf = e131SourceBuf(s, u);
+  memcpy(buf, channels, len);
+  if (len < src.len[u]) memset(buf + len, 0, src.len[u] - len); // the rest of the buffer stays zero for the merge
+  src.seq[u] = seq; src.seen[u] = now; src.priority[u] = priority; src.len[u] = len;
 
+  uint8_t top = 0, tops = 0;
+  for (uint8_t i = 0; i < E131_MAX_SOURCES; i++) {
+    if (!e131SourceLive(i, u, now)) continue;
+    uint8_t prio = e131Sources[i].priority[u];
+    if (prio > top) { top = prio; tops = 1; }
+    else if (prio == top) tops++;
+  }
+  if (priority < top) return false;                             // kept for a failover
+  if (tops == 1 || e131MergeMode == E131_MERGE_LTP) return true; // the packet is shown as it is
+
+  uint32_t* out = e131SourceData + (size_t)E131_MAX_SOURCES * E131_MERGE_UNIVERSES * (MAX_CHANNELS_PER_UNIVERSE / 4);
+  memcpy(out, buf, MAX_CHANNELS_PER_UNIVERSE);
+  for (uint8_t i = 0; i < E131_MAX_SOURCES; i++) {
+    if (i == s || !e131SourceLive(i, u, now) || e131Sources[i].priority[u] != top) continue;
+    const uint32_t* other = (const uint32_t*)e131SourceBuf(i, u);
+    uint16_t words = (e131Sources[i].len[u] + 3) >> 2;
+    for (uint16_t w = 0; w < words; w++) out[w] = e131MaxBytes(out[w], other[w]);
+    if (e131Sources[i].len[u] > len) len = e131Sources[i].len[u];
+  }
+  memcpy(channels, out, len);
+  return true;
+}
+
+static void parseE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
   uint16_t uni = 0, dmxChannels = 0;
   uint8_t* e131_data = nullptr;
   uint8_t seq = 0, mde = REALTIME_MODE_E131;
 
   if (protocol == P_ARTNET)
   {
+    if (p->art_opcode == ARTNET_OPCODE_OPSYNC) {
+      if (realtimeMode == REALTIME_MODE_ARTNET && clientIP == realtimeIP) handleE131Sync();
+      return;
+    }
     uni = p->art_universe;
     dmxChannels = htons(p->art_length);
     e131_data = p->art_data;
     seq = p->art_sequence_number;
     mde = REALTIME_MODE_ARTNET;
   } else if (protocol == P_E131) {
+    if (htonl(p->root_vector) == E131_VECTOR_ROOT_EXTENDED) { // sync packet
+      uint16_t syncUni = (p->raw[E131_SYNC_ADDR] << 8) | p->raw[E131_SYNC_ADDR +1];
+      if (realtimeMode == REALTIME_MODE_E131 && syncUni && syncUni == e131SyncUniverse) handleE131Sync();
+      return;
+    }
     uni = htons(p->universe);
+    // data that does not ask for synchronization is shown right away
+    e131SyncUniverse = htons(p->sync_address);
+    if (!e131SyncUniverse) e131LastSync = 0;
     dmxChannels = htons(p->property_value_count) -1;
     e131_data = p->property_values;
     seq = p->sequence_number;
@@ -75,29 +410,44 @@ void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
   #ifdef WLED_ENABLE_DMX
   // does not act on out-of-order packets yet
   if (e131ProxyUniverse > 0 && uni == e131ProxyUniverse) {
-    for (uint16_t i = 1; i <= dmxChannels; i++)
-      dmx.write(i, e131_data[i]);
-    dmx.update();
+    // E1.31 data starts with the start code, Art-Net data with channel 1
+    handleDMXProxy(protocol == P_ARTNET ? e131_data : e131_data +1, dmxChannels);
   }
   #endif
 
   // only listen for universes we're handling & allocated memory
-  if (uni >= (e131Universe + E131_MAX_UNIVERSE_COUNT)) return;
+  if (uni < e131Universe || uni >= (e131Universe + E131_MAX_UNIVERSE_COUNT)) return;
 
   uint8_t previousUniverses = uni - e131Universe;
 
-  if (e131SkipOutOfSequence)
-    if (seq < e131LastSequenceNumber[uni-e131Universe] && seq > 20 && e131LastSequenceNumber[uni-e131Universe] < 250){
-      DEBUG_PRINT("skipping E1.31 frame (last seq=");
-      DEBUG_PRINT(e131LastSequenceNumber[uni-e131Universe]);
-      DEBUG_PRINT(", current seq=");
-      DEBUG_PRINT(seq);
-      DEBUG_PRINT(", universe=");
-      DEBUG_PRINT(uni);
-      DEBUG_PRINTLN(")");
+  if (e131MergeMode != E131_MERGE_OFF) {
+    // sources are told apart by their CID, Art-Net ones by their IP address
+    uint8_t cid[16] = {0};
+    uint8_t priority = E131_DEFAULT_PRIORITY;
+    if (protocol == P_E131) {
+      if (p->options & 0x80) return; // preview data
+      memcpy(cid, p->cid, sizeof(cid));
+      priority = p->priority;
+    } else {
+      uint32_t ip = clientIP;
+      memcpy(cid, &ip, sizeof(ip));
+    }
+    if (protocol == P_E131 && (p->options & 0x40)) { // stream terminated, the next source takes over right away
+      e131ReleaseSource(cid);
       return;
     }
-  e131LastSequenceNumber[uni-e131Universe] = seq;
+    if (!e131Merge(cid, priority, previousUniverses, seq, protocol, mde, e131_data + (protocol == P_ARTNET ? 0 : 1), dmxChannels)) return;
+  } else {
+    if (e131SourceData) { // merging was turned off
+      free(e131SourceData);
+      e131SourceData = nullptr;
+    }
+    if (e131SequenceSkipped(seq, e131LastSequenceNumber[previousUniverses], protocol, mde)) {
+      DEBUG_PRINTF("skipping E1.31 frame (last seq=%u, current seq=%u, universe=%u)\n", e131LastSequenceNumber[previousUniverses], seq, uni);
+      return;
+    }
+    e131LastSequenceNumber[previousUniverses] = seq;
+  }
 
   // update status info
   realtimeIP = clientIP;
@@ -135,70 +485,90 @@ void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
       break;
 
     case DMX_MODE_EFFECT:
-      if (uni != e131Universe) return;
-      if (dmxChannels-DMXAddress+1 < 11) return;
-      if (DMXOldDimmer != e131_data[DMXAddress+0]) {
-        DMXOldDimmer = e131_data[DMXAddress+0];
-        bri = e131_data[DMXAddress+0];
-      }
-      if (e131_data[DMXAddress+1] < MODE_COUNT)
-        effectCurrent = e131_data[DMXAddress+ 1];
-      effectSpeed     = e131_data[DMXAddress+ 2];  // flickers
-      effectIntensity = e131_data[DMXAddress+ 3];
-      effectPalette   = e131_data[DMXAddress+ 4];
-      col[0]          = e131_data[DMXAddress+ 5];
-      col[1]          = e131_data[DMXAddress+ 6];
-      col[2]          = e131_data[DMXAddress+ 7];
-      colSec[0]       = e131_data[DMXAddress+ 8];
-      colSec[1]       = e131_data[DMXAddress+ 9];
-      colSec[2]       = e131_data[DMXAddress+10];
-      if (dmxChannels-DMXAddress+1 > 11)
       {
-        col[3]        = e131_data[DMXAddress+11]; //white
-        colSec[3]     = e131_data[DMXAddress+12];
+        if (uni != e131Universe) return;
+        if (dmxChannels-DMXAddress+1 < 11) return;
+        if (e131RoutesDirty) { // settings changed, apply the whole next frame
+          compileE131Routes();
+          e131EffectLen = 0;
+        }
+        // only the channels that changed since the last packet are applied, an unchanged frame does nothing
+        uint8_t len = MIN(dmxChannels-DMXAddress+1, E131_EFFECT_CHANNELS);
+        const uint8_t* ch = e131_data + DMXAddress;
+        if (len == e131EffectLen && !memcmp(ch, e131EffectLast, len)) return;
+        bool all = (len != e131EffectLen);
+        uint16_t changed = 0; // bit n: channel n
+        for (uint8_t i = 0; i < len; i++) if (all || ch[i] != e131EffectLast[i]) changed |= 1 << i;
+        memcpy(e131EffectLast, ch, len);
+        e131EffectLen = len;
+
+        if ((changed & 0x0001) && DMXOldDimmer != ch[0]) {
+          DMXOldDimmer = ch[0];
+          bri = ch[0];
+        }
+        if ((changed & 0x0002) && ch[1] < MODE_COUNT) effectCurrent = ch[1];
+        if (changed & 0x0004) effectSpeed     = ch[ 2];
+        if (changed & 0x0008) effectIntensity = ch[ 3];
+        if (changed & 0x0010) effectPalette   = ch[ 4];
+        if (changed & 0x0020) col[0]          = ch[ 5];
+        if (changed & 0x0040) col[1]          = ch[ 6];
+        if (changed & 0x0080) col[2]          = ch[ 7];
+        if (changed & 0x0100) colSec[0]       = ch[ 8];
+        if (changed & 0x0200) colSec[1]       = ch[ 9];
+        if (changed & 0x0400) colSec[2]       = ch[10];
+        if (changed & 0x0800) col[3]          = ch[11]; //white
+        if (changed & 0x1000) colSec[3]       = ch[12];
+        transitionDelayTemp = 0;               // act fast
+        colorUpdated(CALL_MODE_NOTIFICATION);  // don't send UDP
+        return;                                // don't activate realtime live mode
       }
-      transitionDelayTemp = 0;               // act fast
-      colorUpdated(CALL_MODE_NOTIFICATION);  // don't send UDP
-      return;                                // don't activate realtime live mode
-      break;
 
     case DMX_MODE_MULTIPLE_DRGB:
     case DMX_MODE_MULTIPLE_RGB:
     case DMX_MODE_MULTIPLE_RGBW:
+    case DMX_MODE_ROUTED:
       {
+        if (e131RoutesDirty || strip.getLengthTotal() != e131RouteLeds) compileE131Routes();
+        uint8_t routeEnd = e131RouteFirst[previousUniverses +1];
+        if (e131RouteFirst[previousUniverses] == routeEnd) return; // universe is not mapped
+        if (realtimeMode != mde) { // new session, start over with the universes our LEDs need
+          e131UniverseMask = e131RouteMask;
+          e131LastPartialMask = 0;
+          e131UniversesReceived = 0;
+          e131SyncPending = false;
+        }
         realtimeLock(realtimeTimeoutMs, mde);
-        bool is4Chan = (DMXMode == DMX_MODE_MULTIPLE_RGBW);
-        const uint16_t dmxChannelsPerLed = is4Chan ? 4 : 3;
-        const uint16_t ledsPerUniverse = is4Chan ? MAX_4_CH_LEDS_PER_UNIVERSE : MAX_3_CH_LEDS_PER_UNIVERSE;
         if (realtimeOverride) return;
-        uint16_t previousLeds, dmxOffset;
-        if (previousUniverses == 0) {
-          if (dmxChannels-DMXAddress < 1) return;
-          dmxOffset = DMXAddress;
-          previousLeds = 0;
-          // First DMX address is dimmer in DMX_MODE_MULTIPLE_DRGB mode.
-          if (DMXMode == DMX_MODE_MULTIPLE_DRGB) {
-            strip.setBrightness(e131_data[dmxOffset++]);
+        uint32_t universeBit = 1UL << previousUniverses;
+        // universe repeats before the frame was complete: a new frame started, show what we have
+        if (e131UniversesReceived & universeBit) e131FinishFrame(true);
+        // channel n is at channels[n]: E1.31 data starts with the start code, Art-Net data with channel 1
+        const uint8_t* channels = (protocol == P_ARTNET) ? e131_data -1 : e131_data;
+        unsigned long ingestStart = micros();
+        for (uint8_t r = e131RouteFirst[previousUniverses]; r < routeEnd; r++) {
+          const E131Route& rt = e131Routes[r];
+          if (rt.channel > dmxChannels) continue;
+          if (rt.type == E131_ROUTE_DIMMER) {
+            strip.setBrightness(channels[rt.channel]);
+            continue;
           }
-        } else {
-          // All subsequent universes start at the first channel.
-          dmxOffset = (protocol == P_ARTNET) ? 0 : 1;
-          uint16_t ledsInFirstUniverse = (MAX_CHANNELS_PER_UNIVERSE - DMXAddress) / dmxChannelsPerLed;
-          previousLeds = ledsInFirstUniverse + (previousUniverses - 1) * ledsPerUniverse;
+          bool rgbw = (rt.type == E131_ROUTE_RGBW);
+          uint16_t len = MIN(rt.len, (uint16_t)((dmxChannels - rt.channel +1) / (rgbw ? 4 : 3)));
+          if (len) setRealtimePixels(rt.start, channels + rt.channel, len, rgbw);
         }
-        uint16_t ledsTotal = previousLeds + (dmxChannels - dmxOffset +1) / dmxChannelsPerLed;
-        if (!is4Chan) {
-          for (uint16_t i = previousLeds; i < ledsTotal; i++) {
-            setRealtimePixel(i, e131_data[dmxOffset], e131_data[dmxOffset+1], e131_data[dmxOffset+2], 0);
-            dmxOffset+=3;
-          }
-        } else {
-          for (uint16_t i = previousLeds; i < ledsTotal; i++) {
-            setRealtimePixel(i, e131_data[dmxOffset], e131_data[dmxOffset+1], e131_data[dmxOffset+2], e131_data[dmxOffset+3]);
-            dmxOffset+=4;
+        e131IngestMicros = (e131IngestMicros * 7 + (micros() - ingestStart)) >> 3; // running average
+
+        if (!(e131UniverseMask & universeBit)) {
+          e131UniverseMask |= universeBit; // sender transmits more universes than expected
+          if (!e131UniversesReceived) { // late part of the frame that was just completed
+            e131FinishFrame(false);
+            return;
           }
         }
-        break;
+        if (!e131UniversesReceived) e131FrameStart = millis();
+        e131UniversesReceived |= universeBit;
+        if ((e131UniversesReceived & e131UniverseMask) == e131UniverseMask) e131FinishFrame(false);
+        return;
       }
     default:
       DEBUG_PRINTLN(F("unknown E1.31 DMX mode"));
@@ -206,5 +576,81 @@ void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
       break;
   }
 
-  e131NewData = true;
+  if (e131SyncActive()) e131SyncPending = true;
+  else                  e131NewData = true;
+}
+
+static void processE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
+  TRACE_SCOPE(TRACE_E131, protocol == P_ARTNET ? p->art_universe : (protocol == P_E131 ? htons(p->universe) : 0));
+  unsigned long packetStart = micros();
+  parseE131Packet(p, clientIP, protocol);
+
+  //only time packets of the protocol that is streaming, not the ones dropped early
+  byte md = REALTIME_MODE_DDP;
+  if      (protocol == P_ARTNET) md = REALTIME_MODE_ARTNET;
+  else if (protocol == P_E131)   md = REALTIME_MODE_E131;
+  if (realtimeMode == md) realtimePerfAdd(md, packetStart);
+}
+
+#ifdef ARDUINO_ARCH_ESP32
+/*
+ * AsyncUDP calls handleE131Packet() from its network task, which may run on the other core while the strip renders.
+ * Packets are copied into preallocated slots there (single producer) and parsed by handleNotifications() in loop() (single consumer),
+ * so pixel buffers are only written between frames. A full queue drops the packet, it shows up as a sequence gap in udpInLost.
+ */
+#if (E131_QUEUE_SLOTS & (E131_QUEUE_SLOTS -1)) || E131_QUEUE_SLOTS > 128
+  #error "E131_QUEUE_SLOTS must be a power of 2, 128 at most"
+#endif
+
+typedef struct E131QueueSlot {
+  uint32_t ip;
+  uint32_t rx;      // micros the network task received the packet
+  uint8_t protocol;
+  e131_packet_t packet;
+} E131QueueSlot;
+
+static E131QueueSlot* e131Queue = nullptr; // allocated by the network task on the first packet
+static volatile uint8_t e131QueueHead = 0; // written by the network task only
+static volatile uint8_t e131QueueTail = 0; // written by loop() only
+#endif
+
+void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol, uint16_t len){
+  TRACE_INSTANT(TRACE_E131_RX, protocol);
+  #ifdef ARDUINO_ARCH_ESP32
+  if (!e131Queue) {
+    e131Queue = (E131QueueSlot*)allocLarge(E131_QUEUE_SLOTS * sizeof(E131QueueSlot));
+    if (!e131Queue) return;
+  }
+  uint8_t head = e131QueueHead;
+  uint8_t next = (head + 1) & (E131_QUEUE_SLOTS -1);
+  if (next == e131QueueTail) return; // loop() is behind
+  E131QueueSlot* slot = &e131Queue[head];
+  slot->ip = clientIP;
+  slot->rx = micros();
+  slot->protocol = protocol;
+  memcpy(slot->packet.raw, p->raw, len); // bytes past len keep old data, they are within the slot
+  __sync_synchronize(); // slot contents are visible before the new head
+  e131QueueHead = next;
+  #else
+  realtimePacketRx = micros();
+  processE131Packet(p, clientIP, protocol); // network callbacks do not preempt loop() on ESP8266
+  realtimePacketRx = 0;
+  #endif
+}
+
+//parse queued packets up to the end of the next frame, so a frame is never overwritten by the following one before it is shown
+void handleE131Queue()
+{
+  #ifdef ARDUINO_ARCH_ESP32
+  if (!e131Queue) return;
+  uint8_t head = e131QueueHead;
+  __sync_synchronize();
+  for (uint8_t i = e131QueueTail; i != head && !e131FrameComplete; i = e131QueueTail) {
+    realtimePacketRx = e131Queue[i].rx;
+    processE131Packet(&e131Queue[i].packet, IPAddress(e131Queue[i].ip), e131Queue[i].protocol);
+    realtimePacketRx = 0;
+    __sync_synchronize(); // done with the slot before handing it back
+    e131QueueTail = (i + 1) & (E131_QUEUE_SLOTS -1);
+  }
+  #endif
 }
@@ -0,0 +1,160 @@
+#include "wled.h"
+
+/*
+ * ESP-NOW transport: notifier packets (see notify()) are also broadcast to the nodes in range without an access point,
+ * and a remote sends compact commands. Packets arrive in the WiFi task and are queued for loop().
+ * ESP-NOW only reaches nodes on the same WiFi channel: the channel of the AP, or apChannel while none is connected.
+ * Notifications larger than an ESP-NOW frame (250 bytes) carry the first segments only.
+ *
+ * Remote command: token ESPNOW_CMD_TOKEN, command, argument, sequence number (4, repeats of a press share it).
+ * Only taken from the MAC in linkedRemote.
+ */
+#ifdef WLED_ENABLE_ESPNOW
+#ifdef ESP8266
+  #include <espnow.h>
+#else
+  #include <esp_now.h>
+#endif
+
+#define ESPNOW_MAX_LEN   250
+#define ESPNOW_QUEUE     4    //packets received but not handled yet
+#define ESPNOW_CMD_TOKEN 0xC8
+#define ESPNOW_CMD_SIZE  7
+
+#define ESPNOW_CMD_ON         1
+#define ESPNOW_CMD_OFF        2
+#define ESPNOW_CMD_TOGGLE     3
+#define ESPNOW_CMD_BRI_UP     4
+#define ESPNOW_CMD_BRI_DOWN   5
+#define ESPNOW_CMD_BRI        6   //argument: brightness
+#define ESPNOW_CMD_PRESET     7   //argument: preset id
+#define ESPNOW_CMD_NIGHTLIGHT 8
+
+typedef struct EspNowPacket {
+  uint8_t mac[6];
+  uint8_t len;
+  uint8_t data[ESPNOW_MAX_LEN];
+} EspNowPacket;
+
+static EspNowPacket espNowQueue[ESPNOW_QUEUE];
+static volatile uint8_t espNowHead = 0, espNowTail = 0; //written by the receive callback / loop() only
+static bool espNowStarted = false;
+static uint8_t espNowMode = WIFI_OFF; //WiFi mode ESP-NOW was started in, the broadcast peer is bound to its interface
+static uint32_t espNowRemoteSeq = 0;
+static const uint8_t espNowBroadcast[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+
+#ifdef ESP8266
+static void espNowReceive(uint8_t* mac, uint8_t* data, uint8_t len)
+#else
+static void espNowReceive(const uint8_t* mac, const uint8_t* data, int len)
+#endif
+{
+  if (len < 1 || len > ESPNOW_MAX_LEN) return;
+  uint8_t next = (espNowHead + 1) % ESPNOW_QUEUE;
+  if (next == espNowTail) return; //full, loop() is busy
+  EspNowPacket& p = espNowQueue[espNowHead];
+  memcpy(p.mac, mac, 6);
+  memcpy(p.data, data, len);
+  p.len = len;
+  espNowHead = next;
+}
+
+static bool startEspNow()
+{
+  if (esp_now_init() != 0) return false;
+  #ifdef ESP8266
+  esp_now_set_self_role(ESP_NOW_ROLE_COMBO);
+  esp_now_add_peer((uint8_t*)espNowBroadcast, ESP_NOW_ROLE_COMBO, 0, nullptr, 0);
+  #else
+  esp_now_peer_info_t peer = {};
+  memcpy(peer.peer_addr, espNowBroadcast, 6);
+  peer.channel = 0; //the current one
+  peer.ifidx = (WiFi.getMode() == WIFI_AP) ? WIFI_IF_AP : WIFI_IF_STA;
+  esp_now_add_peer(&peer);
+  #endif
+  esp_now_register_recv_cb(espNowReceive);
+  DEBUG_PRINTLN(F("ESP-NOW started."));
+  return true;
+}
+
+static void stopEspNow()
+{
+  esp_now_unregister_recv_cb();
+  esp_now_deinit();
+  espNowStarted = false;
+  DEBUG_PRINTLN(F("ESP-NOW stopped."));
+}
+
+static bool isLinkedRemote(const uint8_t* mac)
+{
+  if (strlen(linkedRemote) != 12) return false;
+  char hex[13];
+  sprintf_P(hex, PSTR("%02x%02x%02x%02x%02x%02x"), mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+  return !strcasecmp(hex, linkedRemote);
+}
+
+static void handleRemoteCommand(const EspNowPacket& p)
+{
+  if (p.len < ESPNOW_CMD_SIZE || !isLinkedRemote(p.mac)) return;
+  uint32_t seq = (p.data[3] << 24) | (p.data[4] << 16) | (p.data[5] << 8) | p.data[6];
+  if (seq == espNowRemoteSeq) return; //the same press sent again
+  espNowRemoteSeq = seq;
+  uint8_t arg = p.data[2];
+  switch (p.data[1]) {
+    case ESPNOW_CMD_ON:         if (!bri) toggleOnOff(); break;
+    case ESPNOW_CMD_OFF:        if (bri) toggleOnOff(); break;
+    case ESPNOW_CMD_TOGGLE:     toggleOnOff(); break;
+    case ESPNOW_CMD_BRI_UP:     bri = (bri > 255 - 16) ? 255 : bri + 16; break;
+    case ESPNOW_CMD_BRI_DOWN:   bri = (bri < 16 + 5) ? 5 : bri - 16; break;
+    case ESPNOW_CMD_BRI:        bri = arg; break;
+    case ESPNOW_CMD_PRESET:     applyPreset(arg, CALL_MODE_BUTTON); return;
+    case ESPNOW_CMD_NIGHTLIGHT: nightlightActive = !nightlightActive; nightlightStartTime = millis(); break;
+    default: return;
+  }
+  colorUpdated(CALL_MODE_BUTTON);
+}
+
+void handleEspNow()
+{
+  uint8_t mode = enableESPNow ? WiFi.getMode() : WIFI_OFF;
+  if (espNowStarted && mode != espNowMode) stopEspNow(); //e.g. the AP was shut down after STA connected
+  if (!espNowStarted) {
+    if (mode == WIFI_OFF) return;
+    espNowStarted = startEspNow();
+    espNowMode = mode;
+    return;
+  }
+  while (espNowTail != espNowHead) {
+    const EspNowPacket& p = espNowQueue[espNowTail];
+    if (p.data[0] == ESPNOW_CMD_TOKEN) handleRemoteCommand(p);
+    else if (p.data[0] == 0) handleEspNowNotification(p.data, p.len);
+    espNowTail = (espNowTail + 1) % ESPNOW_QUEUE;
+  }
+}
+
+bool espNowActive()
+{
+  return enableESPNow && espNowStarted;
+}
+
+//notification of notify(), the seq record is moved after the segments that fit
+void espNowSendNotification(const uint8_t* packet, uint16_t len, uint16_t segOffset, uint8_t segSize, uint8_t seqSize)
+{
+  if (!espNowActive()) return;
+  if (len <= ESPNOW_MAX_LEN) {
+    esp_now_send((uint8_t*)espNowBroadcast, (uint8_t*)packet, len);
+    return;
+  }
+  uint8_t out[ESPNOW_MAX_LEN];
+  uint8_t segs = (ESPNOW_MAX_LEN - segOffset - seqSize) / segSize;
+  uint16_t segLen = segOffset + segs * segSize;
+  memcpy(out, packet, segLen);
+  out[segOffset -1] = segs;
+  memcpy(out + segLen, packet + len - seqSize, seqSize);
+  esp_now_send((uint8_t*)espNowBroadcast, out, segLen + seqSize);
+}
+#else
+void handleEspNow() {}
+bool espNowActive() { return false; }
+void espNowSendNotification(const uint8_t* packet, uint16_t len, uint16_t segOffset, uint8_t segSize, uint8_t seqSize) {}
+#endif
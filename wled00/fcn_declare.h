@@ -23,6 +23,7 @@ void updateBlynk();
 void shortPressAction(uint8_t b=0);
 bool isButtonPressed(uint8_t b=0);
 void handleButton();
+void attachButtonInterrupts();
 void handleIO();
 
 //cfg.cpp
@@ -30,6 +31,7 @@ bool deserializeConfig(JsonObject doc, bool fromFS = false);
 void deserializeConfigFromFS();
 bool deserializeConfigSec();
 void serializeConfig();
+void invalidateConfigSnapshot();
 void serializeConfigSec();
 
 template<typename DestType>
@@ -68,13 +70,71 @@ void colorRGBtoXY(byte* rgb, float* xy); // only defined if huesync disabled TOD
 void colorFromDecOrHexString(byte* rgb, char* in);
 bool colorFromHexString(byte* rgb, const char* in);
 void colorRGBtoRGBW(byte* rgb); //rgb to rgbw (http://codewelt.com/rgbw). (RGBW_MODE_LEGACY)
+uint32_t fadeColor(uint32_t c, uint32_t target, uint32_t inv);
+bool fadeBuffer(uint32_t* buf, uint16_t len, uint32_t target, uint32_t inv);
+bool blurBuffer(uint32_t* buf, uint16_t len, uint8_t amount);
 
 //dmx.cpp
 void initDMX();
 void handleDMX();
+void handleDMXProxy(const uint8_t* data, uint16_t len);
 
 //e131.cpp
-void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol);
+void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol, uint16_t len);
+void handleE131Queue();
+void e131FinishFrame(bool partial);
+void deserializeE131Routes(JsonArray routes);
+void serializeE131Routes(JsonArray routes);
+
+//busbench.cpp
+void startBusBenchmark(uint8_t frames);
+void handleBusBenchmark();
+void serializeBusBenchmark(JsonObject root);
+
+//fleet_ota.cpp
+void initFleetOTA();
+void handleFleetOTA();
+
+//fsbench.cpp
+void startFsBenchmark(uint16_t presets);
+void handleFsBenchmark();
+void restoreFsBenchmark();
+void serializeFsBenchmark(JsonObject root);
+
+//jsonbench.cpp
+void startJsonBenchmark(uint8_t runs);
+void handleJsonBenchmark();
+void serializeJsonBenchmark(JsonObject root);
+
+//fseq.cpp
+void queueFseq(const char* fileName, bool loop = false);
+void handleFseq();
+bool fseqPlaying();
+
+//recorder.cpp
+void queueRecording(const char* fileName);
+void recordPixel(uint16_t pix, byte r, byte g, byte b, byte w);
+void recordPixels(uint16_t pix, const byte* data, uint16_t len, bool rgbw);
+void recordShow();
+void handleRecorder();
+bool recording();
+void serializeRecorderInfo(JsonObject root);
+
+//trace.cpp
+void traceEvent(uint8_t ev, char phase, uint16_t arg);
+void serveTrace(AsyncWebServerRequest* request);
+bool traceRecent(uint8_t back, uint32_t& us, uint8_t& ev, char& phase, uint16_t& arg);
+
+//watchdog.cpp
+void initWatchdog();
+void watchdogLoop();
+void watchdogStage(uint8_t stage);
+void watchdogRenderBeat();
+void serializeWatchdog(JsonObject root);
+
+//power.cpp
+void powerWake();
+void handlePowerSave();
 
 //file.cpp
 bool handleFileRead(AsyncWebServerRequest*, String path);
@@ -82,8 +142,17 @@ bool writeObjectToFileUsingId(const char* file, uint16_t id, JsonDocument* conte
 bool writeObjectToFile(const char* file, const char* key, JsonDocument* content);
 bool readObjectFromFileUsingId(const char* file, uint16_t id, JsonDocument* dest);
 bool readObjectFromFile(const char* file, const char* key, JsonDocument* dest);
+void invalidatePresetIndex();
+bool presetInFile(uint16_t id);
+void handlePresetCompaction();
+void restorePresetCompaction();
 void updateFSInfo();
 void closeFile();
+void initSD();
+bool isSDPath(const char* path);
+File openMediaFile(const char* path, const char* mode = "r");
+bool mediaFileExists(const char* path);
+void* allocMediaBuffer(const char* path, size_t size);
 
 //hue.cpp
 void handleHue();
@@ -109,6 +178,7 @@ void decodeIR21(uint32_t code);
 void decodeIR6(uint32_t code);
 void decodeIR9(uint32_t code);
 void decodeIRJson(uint32_t code);
+void invalidateIrJson();
 
 void initIR();
 void handleIR();
@@ -119,12 +189,18 @@ void handleIR();
 #include "src/dependencies/json/AsyncJson-v6.h"
 #include "FX.h"
 
-void deserializeSegment(JsonObject elem, byte it, byte presetId = 0);
+bool deserializeSegment(JsonObject elem, byte it, byte presetId = 0);
+bool handlePixelUpload(uint32_t owner, const uint8_t* data, size_t len, bool first, bool last);
+bool pixelUploadSucceeded(uint32_t owner);
 bool deserializeState(JsonObject root, byte callMode = CALL_MODE_DIRECT_CHANGE, byte presetId = 0);
 void serializeSegment(JsonObject& root, WS2812FX::Segment& seg, byte id, bool forPreset = false, bool segmentBounds = true);
-void serializeState(JsonObject root, bool forPreset = false, bool includeBri = true, bool segmentBounds = true);
+void serializeState(JsonObject root, bool forPreset = false, bool includeBri = true, bool segmentBounds = true, bool includeSegments = true);
 void serializeInfo(JsonObject root);
+void serializePerfStat(JsonObject obj, const WS2812FX::PerfStat& perf);
+void serializePerf(JsonObject root, bool includeBench = true);
+std::shared_ptr<String> getStateText(uint32_t* hash = nullptr);
 void serveJson(AsyncWebServerRequest* request);
+uint16_t serializeLiveLeds(char* buffer);
 bool serveLiveLeds(AsyncWebServerRequest* request, uint32_t wsClient = 0);
 
 //led.cpp
@@ -134,7 +210,9 @@ void toggleOnOff();
 void setAllLeds();
 void setLedsStandard();
 bool colorChanged();
-void colorUpdated(int callMode);
+void colorUpdated(int callMode, bool segmentsSet = false);
+void beginStateUpdate();
+void endStateUpdate();
 void updateInterfaces(uint8_t callMode);
 void handleTransitions();
 void handleNightlight();
@@ -147,6 +225,7 @@ void parseLxJson(int lxValue, byte segId, bool secondary);
 //mqtt.cpp
 bool initMqtt();
 void publishMqtt();
+void publishMqttPerf();
 
 //ntp.cpp
 void handleTime();
@@ -159,6 +238,7 @@ bool checkCountdown();
 void setCountdown();
 byte weekdayMondayFirst();
 void checkTimers();
+void invalidateTimers();
 void calculateSunriseAndSunset();
 void setTimeFromAPI(uint32_t timein);
 
@@ -179,12 +259,41 @@ void shufflePlaylist();
 void unloadPlaylist();
 int16_t loadPlaylist(JsonObject playlistObject, byte presetId = 0);
 void handlePlaylist();
+void schedulePlaylistSync(byte preset, uint16_t tr, bool morph, uint32_t at);
+
+//vstrip.cpp
+void vstripShow(uint8_t* data, uint16_t len, uint8_t bri, WiFiUDP* udp);
+void serializeVStrip(JsonObject root);
+
+//planner.cpp
+void stageLedPlan(JsonArray ins);
+void serializeLedPlan(JsonObject root);
 
 //presets.cpp
+uint32_t presetsChecksum();
+void invalidatePresetsChecksum();
+bool readPreset(byte index, JsonDocument* dest);
+void writePreset(byte index, JsonDocument* content);
+void handlePresetQueue();
+void flushPresetQueue();
+void clearPresetQueue();
 bool applyPreset(byte index, byte callMode = CALL_MODE_DIRECT_CHANGE);
+bool morphToPreset(byte index, uint32_t dur, byte callMode = CALL_MODE_DIRECT_CHANGE);
 void savePreset(byte index, bool persist = true, const char* pname = nullptr, JsonObject saveobj = JsonObject());
 void deletePreset(byte index);
 
+//presets_bin.cpp
+#ifdef WLED_ENABLE_BINARY_PRESETS
+bool binPresetLoad(byte id, JsonDocument* dest);
+bool binPresetExists(byte id);
+bool binPresetSave(byte id, JsonObject obj);
+void binPresetDelete(byte id);
+void convertPresetsToBinary();
+void reloadBinPresets();
+void clearBinPresets();
+bool serveBinPresets(AsyncWebServerRequest* request);
+#endif
+
 //set.cpp
 void _setRandomColor(bool _sec,bool fromButton=false);
 bool isAsterisksOnly(const char* str, byte maxLen);
@@ -195,18 +304,39 @@ void parseNumber(const char* str, byte* val, byte minv=0, byte maxv=255);
 bool updateVal(const String* req, const char* key, byte* val, byte minv=0, byte maxv=255);
 
 //udp.cpp
+bool beginSyncUdp(WiFiUDP& udp, uint16_t port);
 void notify(byte callMode, bool followUp=false);
-uint8_t realtimeBroadcast(uint8_t type, IPAddress client, uint16_t length, byte *buffer, uint8_t bri=255, bool isRGBW=false);
+uint8_t realtimeBroadcast(uint8_t type, IPAddress client, uint16_t length, byte *buffer, uint8_t bri=255, bool isRGBW=false, WiFiUDP* udp=nullptr, uint8_t* seq=nullptr);
+uint16_t realtimePacketCount(uint8_t type, uint16_t length, bool isRGBW);
+bool realtimeSendPacket(uint8_t type, IPAddress client, uint16_t length, const byte* buffer, uint8_t bri, bool isRGBW, WiFiUDP* udp, uint16_t n, uint8_t& seq);
+void e131OutCid(uint8_t* cid);
 void realtimeLock(uint32_t timeoutMs, byte md = REALTIME_MODE_GENERIC);
+bool realtimeExclusive();
+void realtimeShow();
+void handleRealtimeLatency();
+void resetRealtimeLatency();
+void realtimePerfAdd(byte md, unsigned long startMicros);
 void handleNotifications();
 void setRealtimePixel(uint16_t i, byte r, byte g, byte b, byte w);
+void setRealtimePixels(uint16_t i, const byte* data, uint16_t len, bool rgbw);
 void refreshNodeList();
 void sendSysInfoUDP();
+void sendPlaylistSync(byte preset, uint16_t tr, bool morph, uint32_t at, bool repeat);
+void handleEspNowNotification(const byte* data, uint16_t len);
+
+//espnow.cpp
+void handleEspNow();
+bool espNowActive();
+void espNowSendNotification(const uint8_t* packet, uint16_t len, uint16_t segOffset, uint8_t segSize, uint8_t seqSize);
 
 //um_manager.cpp
 class Usermod {
   public:
     virtual void loop() {}
+    virtual uint16_t getLoopInterval() { return 0; } // ms between loop() calls, 0 = every loop iteration
+    virtual uint32_t getLoopBudget() { return USERMOD_LOOP_BUDGET; } // us, longer loop() calls are counted as overruns
+    virtual uint8_t getEventMask() { return 0; } // UM_EVENT_* this usermod wants to receive
+    virtual void onEvent(uint8_t event, uint8_t arg) {} // may be called from network callbacks, keep it short
     virtual void handleOverlayDraw() {}
     virtual bool handleButton(uint8_t b) { return false; }
     virtual void setup() {}
@@ -225,6 +355,11 @@ class UsermodManager {
   private:
     Usermod* ums[WLED_MAX_USERMODS];
     byte numMods = 0;
+    unsigned long lastLoop[WLED_MAX_USERMODS] = {0};
+    uint32_t loopAvg[WLED_MAX_USERMODS] = {0}; // us
+    uint32_t loopMax[WLED_MAX_USERMODS] = {0}; // us
+    uint16_t overruns[WLED_MAX_USERMODS] = {0};
+    uint32_t deferred = 0; // usermods that were due but skipped because the budget was used up
 
   public:
     void loop();
@@ -239,6 +374,7 @@ class UsermodManager {
     bool readFromConfig(JsonObject& obj);
     void onMqttConnect(bool sessionPresent);
     bool onMqttMessage(char* topic, char* payload);
+    void publish(uint8_t event, uint8_t arg = 0);
     bool add(Usermod* um);
     Usermod* lookup(uint16_t mod_id);
     byte getModCount();
@@ -252,6 +388,12 @@ void userSetup();
 void userConnected();
 void userLoop();
 
+//wled.cpp
+void* allocLarge(size_t size);
+uint32_t heapLargestBlock();
+uint8_t heapFragmentation();
+bool heapLow();
+
 //wled_eeprom.cpp
 void applyMacro(byte index);
 void deEEP();
@@ -260,6 +402,7 @@ void clearEEPROM();
 
 //wled_serial.cpp
 void handleSerial();
+void updateBaudRate(uint32_t rate);
 
 //wled_server.cpp
 bool isIp(String str);
@@ -267,11 +410,15 @@ bool captivePortal(AsyncWebServerRequest *request);
 void initServer();
 void serveIndexOrWelcome(AsyncWebServerRequest *request);
 void serveIndex(AsyncWebServerRequest* request);
+void serveUiModule(AsyncWebServerRequest* request, const uint8_t* page, uint16_t len, const char* etag);
+bool handleIfNoneMatchCacheHeader(AsyncWebServerRequest* request, const char* etag);
 String msgProcessor(const String& var);
 void serveMessage(AsyncWebServerRequest* request, uint16_t code, const String& headl, const String& subl="", byte optionT=255);
-String settingsProcessor(const String& var);
 String dmxProcessor(const String& var);
 void serveSettings(AsyncWebServerRequest* request, bool post = false);
+void serveMetrics(AsyncWebServerRequest* request);
+void otaThrottleFps(bool ota);
+void handleOTAWrite();
 
 //ws.cpp
 void handleWs();
@@ -283,6 +430,6 @@ void XML_response(AsyncWebServerRequest *request, char* dest = nullptr);
 void URL_response(AsyncWebServerRequest *request);
 void sappend(char stype, const char* key, int val);
 void sappends(char stype, const char* key, char* val);
-void getSettingsJS(byte subPage, char* dest);
+void getSettingsJS(byte subPage);
 
 #endif
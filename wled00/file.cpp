@@ -25,10 +25,6 @@
  *    The reason for it is that deleting the first preset would require special code to handle commas between it and the 2nd preset
  */
 
-// There are no consecutive spaces longer than this in the file, so if more space is required, findSpace() can return false immediately
-// Actual space may be lower
-uint16_t knownLargestSpace = UINT16_MAX;
-
 File f;
 
 //wrapper to find out how long closing takes
@@ -42,6 +38,331 @@ void closeFile() {
   doCloseFile = false;
 }
 
+/*
+ * Optional SD card for large media (sequences, ledmaps), files below /sd/ are on the card.
+ * Without WLED_ENABLE_SD such paths are ordinary paths on WLED_FS.
+ */
+void initSD()
+{
+  #ifdef WLED_ENABLE_SD
+  #ifdef WLED_USE_SD_MMC
+  sdMounted = WLED_SD.begin("/sdcard", true); //1-bit mode leaves IO4 and IO12 free
+  #else
+  managed_pin_type pins[] = { {WLED_SD_CS, true}, {WLED_SD_SCK, true}, {WLED_SD_MISO, false}, {WLED_SD_MOSI, true} };
+  if (!pinManager.allocateMultiplePins(pins, 4, PinOwner::SD_Card)) return;
+  SPI.begin(WLED_SD_SCK, WLED_SD_MISO, WLED_SD_MOSI, WLED_SD_CS);
+  sdMounted = WLED_SD.begin(WLED_SD_CS, SPI, WLED_SD_FREQ);
+  if (!sdMounted) for (uint8_t i = 0; i < 4; i++) pinManager.deallocatePin(pins[i].pin, PinOwner::SD_Card);
+  #endif
+  DEBUG_PRINTLN(sdMounted ? F("SD card mounted") : F("No SD card"));
+  #endif
+}
+
+bool isSDPath(const char* path)
+{
+  #ifdef WLED_ENABLE_SD
+  return path && !strncmp_P(path, PSTR("/sd/"), 4);
+  #else
+  return false;
+  #endif
+}
+
+File openMediaFile(const char* path, const char* mode)
+{
+  #ifdef WLED_ENABLE_SD
+  if (isSDPath(path)) return sdMounted ? WLED_SD.open(path +3, mode) : File();
+  #endif
+  return WLED_FS.open(path, mode);
+}
+
+bool mediaFileExists(const char* path)
+{
+  #ifdef WLED_ENABLE_SD
+  if (isSDPath(path)) return sdMounted && WLED_SD.exists(path +3);
+  #endif
+  return WLED_FS.exists(path);
+}
+
+//buffer for sequential reads of path, internal DMA capable RAM for the card so blocks go straight into it
+void* allocMediaBuffer(const char* path, size_t size)
+{
+  #ifdef WLED_ENABLE_SD
+  if (isSDPath(path)) {
+    void* buf = heap_caps_malloc(size, MALLOC_CAP_DMA | MALLOC_CAP_8BIT);
+    if (buf) return buf;
+  }
+  #endif
+  return allocLarge(size);
+}
+
+/*
+ * Preset index: file offset of every preset object in /presets.json, so a recall is a single seek
+ * instead of a scan through the whole file. Built on first use after the file was replaced,
+ * afterwards kept up to date by writeObjectToFile() together with the free space map.
+ */
+#define PRESET_INDEX_SIZE 251 //preset ids 0-250
+
+/*
+ * Free space map: the runs of spaces replaced and deleted presets leave between the root level objects.
+ * A save takes the first run that fits instead of searching the file, and once too much of the file
+ * is free space the file is compacted in the background.
+ */
+#ifndef PRESET_FREE_EXTENTS
+  #define PRESET_FREE_EXTENTS 32 //if there are more runs, the smallest are not tracked
+#endif
+#define PRESET_FREE_MIN         16    //shorter runs are not worth tracking
+#ifndef PRESET_COMPACT_THRESHOLD
+  #define PRESET_COMPACT_THRESHOLD 30 //percent of the file that may be free space
+#endif
+#define PRESET_COMPACT_MIN      2048  //don't bother compacting less free space than this
+#define PRESET_COMPACT_DELAY    10000 //ms without preset writes before compaction starts
+#define PRESET_COMPACT_TMP      "/presets.tmp"
+
+typedef struct FreeExtent {
+  uint32_t pos;
+  uint16_t len;
+} FreeExtent;
+
+uint32_t* presetIndex = nullptr; //0 = preset does not exist
+bool presetIndexValid = false;
+FreeExtent presetFree[PRESET_FREE_EXTENTS];
+uint8_t presetFreeCount = 0;
+uint32_t presetFreeBytes = 0;    //also counts the runs too small or too many to track
+int16_t presetWriteId = -1;      //preset being written while index and map are maintained, -1 otherwise
+uint32_t presetWriteTime = 0;
+bool presetCompactPending = false;
+File compactSrc, compactDst;
+
+void cancelPresetCompaction()
+{
+  if (!compactSrc) return;
+  DEBUGFS_PRINTLN(F("Compaction cancelled"));
+  compactSrc.close();
+  compactDst.close();
+  WLED_FS.remove(PRESET_COMPACT_TMP);
+}
+
+void invalidatePresetIndex()
+{
+  presetIndexValid = false;
+  presetCompactPending = false;
+  cancelPresetCompaction();
+}
+
+//adds a run of spaces written at pos, merging it with adjacent runs
+void freeMapAdd(uint32_t pos, uint16_t len)
+{
+  presetFreeBytes += len;
+  for (uint8_t i = 0; i < presetFreeCount; i++) {
+    FreeExtent& e = presetFree[i];
+    if (e.pos + e.len == pos && e.len + len <= UINT16_MAX) {
+      e.len += len;
+      for (uint8_t j = 0; j < presetFreeCount; j++) { //may also close the gap to the following run
+        if (presetFree[j].pos != e.pos + e.len || e.len + presetFree[j].len > UINT16_MAX) continue;
+        e.len += presetFree[j].len;
+        presetFree[j] = presetFree[--presetFreeCount];
+        break;
+      }
+      return;
+    }
+    if (pos + len == e.pos && e.len + len <= UINT16_MAX) {
+      e.pos = pos; e.len += len;
+      return;
+    }
+  }
+  if (len < PRESET_FREE_MIN) return;
+  if (presetFreeCount < PRESET_FREE_EXTENTS) {
+    presetFree[presetFreeCount++] = {pos, len};
+    return;
+  }
+  uint8_t smallest = 0;
+  for (uint8_t i = 1; i < PRESET_FREE_EXTENTS; i++) if (presetFree[i].len < presetFree[smallest].len) smallest = i;
+  if (presetFree[smallest].len < len) presetFree[smallest] = {pos, len};
+}
+
+//removes len bytes at pos, which have been overwritten with content, from the map
+void freeMapTake(uint32_t pos, uint16_t len)
+{
+  presetFreeBytes = (presetFreeBytes > len) ? presetFreeBytes - len : 0;
+  for (uint8_t i = 0; i < presetFreeCount; i++) {
+    FreeExtent& e = presetFree[i];
+    if (pos < e.pos || pos >= e.pos + e.len) continue;
+    uint32_t end = e.pos + e.len;
+    e.len = pos - e.pos;
+    if (pos + len < end && end - (pos + len) >= PRESET_FREE_MIN) { //remainder after the taken bytes
+      if (!e.len) { e.pos = pos + len; e.len = end - e.pos; return; }
+      if (presetFreeCount < PRESET_FREE_EXTENTS) presetFree[presetFreeCount++] = {pos + len, (uint16_t)(end - (pos + len))};
+    }
+    if (e.len < PRESET_FREE_MIN) presetFree[i] = presetFree[--presetFreeCount];
+    return;
+  }
+}
+
+//single pass over the file, records where the object of each numeric root level key starts
+//and where the runs of spaces between the objects are
+bool buildPresetIndex()
+{
+  #ifdef WLED_DEBUG_FS
+    uint32_t s = millis();
+  #endif
+  if (!presetIndex) presetIndex = (uint32_t*) malloc(PRESET_INDEX_SIZE * sizeof(uint32_t));
+  if (!presetIndex) return false;
+  memset(presetIndex, 0, PRESET_INDEX_SIZE * sizeof(uint32_t));
+  presetFreeCount = 0;
+  presetFreeBytes = 0;
+
+  File pf = WLED_FS.open("/presets.json", "r");
+  if (!pf) return true; //no presets
+
+  byte buf[FS_BUFSIZE];
+  uint32_t pos = 0, runStart = 0;
+  uint16_t runLen = 0;
+  uint8_t depth = 0;
+  bool inString = false, escaped = false, isKey = false;
+  uint16_t key = 0;
+  while (pf.available()) {
+    uint16_t bufsize = pf.read(buf, FS_BUFSIZE);
+    for (uint16_t i = 0; i < bufsize; i++, pos++) {
+      char c = buf[i];
+      if (inString) {
+        if (escaped)        escaped  = false;
+        else if (c == '\\') escaped  = true;
+        else if (c == '"')  inString = false;
+        else if (c >= '0' && c <= '9' && key < PRESET_INDEX_SIZE) key = key*10 + (c - '0');
+        else                isKey    = false; //not a preset id
+        continue;
+      }
+      if (c == ' ' && depth == 1) {
+        if (!runLen) runStart = pos;
+        if (runLen < UINT16_MAX) runLen++;
+        continue;
+      }
+      if (runLen) {
+        freeMapAdd(runStart, runLen);
+        runLen = 0;
+      }
+      if (c == '"') {
+        inString = true;
+        isKey = (depth == 1); //root level strings are keys, their values are objects
+        key = 0;
+      } else if (c == '{') {
+        if (depth == 1 && isKey && key < PRESET_INDEX_SIZE && !presetIndex[key]) presetIndex[key] = pos;
+        isKey = false;
+        depth++;
+      } else if (c == '}') {
+        if (depth) depth--;
+      } else if (c != ':' && c != ' ' && c != '\n' && c != '\r' && c != '\t') {
+        isKey = false;
+      }
+    }
+  }
+  pf.close();
+  DEBUGFS_PRINTF("Preset index built, %d free bytes, took %d ms\n", presetFreeBytes, millis() - s);
+  return true;
+}
+
+//returns 1 if the preset was read, 0 if it does not exist and -1 if the index cannot be used
+int8_t readPresetUsingIndex(uint16_t id, JsonDocument* dest)
+{
+  if (id >= PRESET_INDEX_SIZE) return -1;
+  if (doCloseFile) closeFile();
+  if (!presetIndexValid) presetIndexValid = buildPresetIndex();
+  if (!presetIndexValid) return -1;
+  if (!presetIndex[id]) {
+    dest->clear();
+    return 0;
+  }
+
+  f = WLED_FS.open("/presets.json", "r");
+  if (!f) return -1;
+  f.seek(presetIndex[id], SeekSet);
+  bool ok = (f.peek() == '{' && deserializeJson(*dest, f) == DeserializationError::Ok);
+  f.close();
+  if (ok) return 1;
+  invalidatePresetIndex(); //file changed behind our back, search it instead
+  return -1;
+}
+
+//true unless the index knows the preset is not in the file
+bool presetInFile(uint16_t id)
+{
+  if (id >= PRESET_INDEX_SIZE) return true;
+  if (doCloseFile) closeFile();
+  if (!presetIndexValid) presetIndexValid = buildPresetIndex();
+  return !presetIndexValid || presetIndex[id];
+}
+
+//rewrites presets.json without the free space, a few blocks per call so the LEDs keep running
+void handlePresetCompaction()
+{
+  if (!compactSrc) {
+    if (!presetCompactPending || millis() - presetWriteTime < PRESET_COMPACT_DELAY) return;
+    presetCompactPending = false;
+    if (doCloseFile) closeFile();
+    compactSrc = WLED_FS.open("/presets.json", "r");
+    if (!compactSrc) return;
+    updateFSInfo();
+    if (compactSrc.size() + 9000 > (fsBytesTotal - fsBytesUsed)) { //no room for the copy
+      compactSrc.close();
+      return;
+    }
+    compactDst = WLED_FS.open(PRESET_COMPACT_TMP, "w");
+    if (!compactDst) {
+      compactSrc.close();
+      return;
+    }
+    DEBUGFS_PRINTF("Compacting presets, %d of %d bytes free\n", presetFreeBytes, compactSrc.size());
+    return;
+  }
+
+  static uint8_t depth = 0;
+  static bool inString = false, escaped = false;
+  if (!compactSrc.position()) { depth = 0; inString = false; escaped = false; }
+
+  byte buf[FS_BUFSIZE];
+  for (uint8_t b = 0; b < 4 && compactSrc.available(); b++) {
+    uint16_t bufsize = compactSrc.read(buf, FS_BUFSIZE);
+    uint16_t len = 0;
+    for (uint16_t i = 0; i < bufsize; i++) {
+      char c = buf[i];
+      if (inString) {
+        if (escaped)        escaped  = false;
+        else if (c == '\\') escaped  = true;
+        else if (c == '"')  inString = false;
+      } else if (c == '"') {
+        inString = true;
+      } else if (c == '{') {
+        depth++;
+      } else if (c == '}') {
+        if (depth) depth--;
+      } else if (depth <= 1 && (c == ' ' || c == '\n' || c == '\r' || c == '\t')) {
+        continue; //whitespace between the presets
+      }
+      buf[len++] = c;
+    }
+    if (compactDst.write(buf, len) != len) { //file system full
+      cancelPresetCompaction();
+      return;
+    }
+  }
+  if (compactSrc.available()) return;
+
+  compactSrc.close();
+  compactDst.close();
+  if (doCloseFile) closeFile();
+  WLED_FS.remove("/presets.json");
+  WLED_FS.rename(PRESET_COMPACT_TMP, "/presets.json");
+  invalidatePresetIndex(); //offsets have moved
+  updateFSInfo();
+  DEBUGFS_PRINTLN(F("Presets compacted"));
+}
+
+//finishes a compaction interrupted between removing the old and renaming the new file
+void restorePresetCompaction()
+{
+  if (WLED_FS.exists(PRESET_COMPACT_TMP) && !WLED_FS.exists("/presets.json")) WLED_FS.rename(PRESET_COMPACT_TMP, "/presets.json");
+}
+
 //find() that reads and buffers data from file stream in 256-byte blocks.
 //Significantly faster, f.find(key) can take SECONDS for multi-kB files
 bool bufferedFind(const char *target, bool fromStart = true) {
@@ -60,6 +381,7 @@ bool bufferedFind(const char *target, bool fromStart = true) {
 
   while (f.position() < f.size() -1) {
     uint16_t bufsize = f.read(buf, FS_BUFSIZE);
+    fsBytesScanned += bufsize;
     uint16_t count = 0;
     while (count < bufsize) {
       if(buf[count] != target[index])
@@ -80,6 +402,7 @@ bool bufferedFind(const char *target, bool fromStart = true) {
 }
 
 //find empty spots in file stream in 256-byte blocks.
+//searching from the start takes the free space map of presets.json instead of reading the file
 bool bufferedFindSpace(uint16_t targetLen, bool fromStart = true) {
 
   #ifdef WLED_DEBUG_FS
@@ -87,38 +410,38 @@ bool bufferedFindSpace(uint16_t targetLen, bool fromStart = true) {
     uint32_t s = millis();
   #endif
 
-  if (knownLargestSpace < targetLen) {
-    DEBUGFS_PRINT(F("No match, KLS "));
-    DEBUGFS_PRINTLN(knownLargestSpace);
+  if (!f || !f.size()) return false;
+
+  if (fromStart && presetWriteId >= 0) {
+    for (uint8_t i = 0; i < presetFreeCount; i++) {
+      if (presetFree[i].len < targetLen) continue;
+      f.seek(presetFree[i].pos, SeekSet);
+      DEBUGFS_PRINTF("Found at pos %d in map\n", f.position());
+      return true;
+    }
+    DEBUGFS_PRINTLN(F("No match in map"));
     return false;
   }
 
-  if (!f || !f.size()) return false;
-
   uint16_t index = 0;
   byte buf[FS_BUFSIZE];
   if (fromStart) f.seek(0);
 
   while (f.position() < f.size() -1) {
     uint16_t bufsize = f.read(buf, FS_BUFSIZE);
+    fsBytesScanned += bufsize;
     uint16_t count = 0;
     
     while (count < bufsize) {
       if(buf[count] == ' ') {
         if(++index >= targetLen) { // return true if space long enough
-          if (fromStart) {
-            f.seek((f.position() - bufsize) + count +1 - targetLen);
-            knownLargestSpace = UINT16_MAX; //there may be larger spaces after, so we don't know
-          }
+          if (fromStart) f.seek((f.position() - bufsize) + count +1 - targetLen);
           DEBUGFS_PRINTF("Found at pos %d, took %d ms", f.position(), millis() - s);
           return true;
         }
       } else {
         if (!fromStart) return false;
-        if (index) {
-          if (knownLargestSpace < index || knownLargestSpace == UINT16_MAX) knownLargestSpace = index;
-          index = 0; // reset index if not space
-        }
+        index = 0; // reset index if not space
       }
 
       count++;
@@ -143,6 +466,7 @@ bool bufferedFindObjectEnd() {
 
   while (f.position() < f.size() -1) {
     uint16_t bufsize = f.read(buf, FS_BUFSIZE);
+    fsBytesScanned += bufsize;
     uint16_t count = 0;
     
     while (count < bufsize) {
@@ -165,14 +489,13 @@ void writeSpace(uint16_t l)
 {
   byte buf[FS_BUFSIZE];
   memset(buf, ' ', FS_BUFSIZE);
+  if (presetWriteId >= 0) freeMapAdd(f.position(), l);
 
   while (l > 0) {
     uint16_t block = (l>FS_BUFSIZE) ? FS_BUFSIZE : l;
     f.write(buf, block);
     l -= block;
   }
-
-  if (knownLargestSpace < l) knownLargestSpace = l;
 }
 
 bool appendObjectToFile(const char* key, JsonDocument* content, uint32_t s, uint32_t contentLen = 0)
@@ -188,6 +511,7 @@ bool appendObjectToFile(const char* key, JsonDocument* content, uint32_t s, uint
     char init[10];
     strcpy_P(init, PSTR("{\"0\":{}}"));
     f.print(init);
+    if (presetWriteId >= 0) presetIndex[0] = 5;
   }
 
   if (content->isNull()) {
@@ -199,9 +523,12 @@ bool appendObjectToFile(const char* key, JsonDocument* content, uint32_t s, uint
   if (!contentLen) contentLen = measureJson(*content);
   DEBUGFS_PRINTF("CLen %d\n", contentLen);
   if (bufferedFindSpace(contentLen + strlen(key) + 1)) {
+    pos = f.position();
     if (f.position() > 2) f.write(','); //add comma if not first object
     f.print(key);
+    if (presetWriteId >= 0) presetIndex[presetWriteId] = f.position();
     serializeJson(*content, f);
+    if (presetWriteId >= 0) freeMapTake(pos, f.position() - pos);
     DEBUGFS_PRINTF("Inserted, took %d ms (total %d)", millis() - s1, millis() - s);
     doCloseFile = true;
     return true;
@@ -244,6 +571,7 @@ bool appendObjectToFile(const char* key, JsonDocument* content, uint32_t s, uint
   }
 
   f.print(key);
+  if (presetWriteId >= 0) presetIndex[presetWriteId] = f.position();
 
   //Append object
   serializeJson(*content, f);
@@ -261,7 +589,7 @@ bool writeObjectToFileUsingId(const char* file, uint16_t id, JsonDocument* conte
   return writeObjectToFile(file, objKey, content);
 }
 
-bool writeObjectToFile(const char* file, const char* key, JsonDocument* content)
+static bool writeObjectToFileInternal(const char* file, const char* key, JsonDocument* content)
 {
   uint32_t s = 0; //timing
   #ifdef WLED_DEBUG_FS
@@ -278,7 +606,12 @@ bool writeObjectToFile(const char* file, const char* key, JsonDocument* content)
     return false;
   }
   
-  if (!bufferedFind(key)) //key does not exist in file
+  bool exists;
+  if (presetWriteId >= 0) {
+    exists = presetIndex[presetWriteId];
+    if (exists) f.seek(presetIndex[presetWriteId], SeekSet);
+  } else exists = bufferedFind(key);
+  if (!exists) //key does not exist in file
   {
     return appendObjectToFile(key, content, s);
   } 
@@ -310,11 +643,13 @@ bool writeObjectToFile(const char* file, const char* key, JsonDocument* content)
     DEBUGFS_PRINTLN(F("replace (trailing)"));
     f.seek(pos);
     serializeJson(*content, f);
+    if (presetWriteId >= 0) freeMapTake(pos2, contentLen - oldLen);
   } else {
     DEBUGFS_PRINTLN(F("delete"));
     pos -= strlen(key);
     if (pos > 3) pos--; //also delete leading comma if not first object
     f.seek(pos);
+    if (presetWriteId >= 0) presetIndex[presetWriteId] = 0;
     writeSpace(pos2 - pos);
     if (contentLen) return appendObjectToFile(key, content, s, contentLen);
   }
@@ -324,8 +659,33 @@ bool writeObjectToFile(const char* file, const char* key, JsonDocument* content)
   return true;
 }
 
+bool writeObjectToFile(const char* file, const char* key, JsonDocument* content)
+{
+  presetWriteId = -1;
+  if (!strcmp(file, "/presets.json")) {
+    cancelPresetCompaction();
+    if (doCloseFile) closeFile();
+    uint16_t id = (key && key[0] == '"') ? atoi(key +1) : PRESET_INDEX_SIZE;
+    if (id < PRESET_INDEX_SIZE && !presetIndexValid) presetIndexValid = buildPresetIndex();
+    if (id < PRESET_INDEX_SIZE && presetIndexValid) presetWriteId = id;
+    else invalidatePresetIndex();
+  }
+  bool ok = writeObjectToFileInternal(file, key, content);
+  if (presetWriteId >= 0) {
+    presetWriteTime = millis();
+    uint32_t fileSize = f.size();
+    if (presetFreeBytes > PRESET_COMPACT_MIN && presetFreeBytes * 100 > fileSize * PRESET_COMPACT_THRESHOLD) presetCompactPending = true;
+  }
+  presetWriteId = -1;
+  return ok;
+}
+
 bool readObjectFromFileUsingId(const char* file, uint16_t id, JsonDocument* dest)
 {
+  if (!strcmp(file, "/presets.json")) {
+    int8_t found = readPresetUsingIndex(id, dest);
+    if (found >= 0) return found;
+  }
   char objKey[10];
   sprintf(objKey, "\"%d\":", id);
   return readObjectFromFile(file, objKey, dest);
@@ -397,7 +757,17 @@ bool handleFileRead(AsyncWebServerRequest* request, String path){
   DEBUG_PRINTLN("FileRead: " + path);
   if(path.endsWith("/")) path += "index.htm";
   if(path.indexOf("sec") > -1) return false;
+  #ifdef WLED_ENABLE_BINARY_PRESETS
+  if (path == "/presets.json" && serveBinPresets(request)) return true;
+  #endif
   String contentType = getContentType(request, path);
+  #ifdef WLED_ENABLE_SD
+  if (isSDPath(path.c_str())) {
+    if (!mediaFileExists(path.c_str())) return false;
+    request->send(WLED_SD, path.substring(3), contentType);
+    return true;
+  }
+  #endif
   /*String pathWithGz = path + ".gz";
   if(WLED_FS.exists(pathWithGz)){
     request->send(WLED_FS, pathWithGz, contentType);
@@ -0,0 +1,161 @@
+#include "wled.h"
+
+/*
+ * Fleet update: one updated node hands its own firmware to the other nodes in its instance list.
+ * Peers of the same type running a different build are told to pull /fw.bin from this node a few at a time (a wave),
+ * the next wave starts once the previous one shows up with our build in the node list or timed out.
+ * The image is uploaded from the PC once, and at most fleetWaveSize copies cross the access point at a time.
+ * All nodes must run the same build environment, the node type only tells ESP32 from ESP8266.
+ */
+#if defined(WLED_ENABLE_FLEET_OTA) && defined(ARDUINO_ARCH_ESP32) && !defined(WLED_DISABLE_OTA)
+#include <HTTPUpdate.h>
+#include "esp_ota_ops.h"
+
+#define FLEET_MAX_PEERS     64
+#define FLEET_WAVE_TIMEOUT  180000 //ms for a wave to download, reboot and announce itself
+#define FLEET_TRIGGER_TIMEOUT 1500 //ms to connect to a peer
+
+enum class FleetState : uint8_t { Idle, Running, Done };
+
+static FleetState fleetState = FleetState::Idle;
+static IPAddress fleetPeers[FLEET_MAX_PEERS];
+static uint8_t fleetPeerCount = 0;
+static uint8_t fleetNext = 0;        // first peer of the next wave
+static uint8_t fleetWaveStart = 0;   // first peer of the current wave
+static uint8_t fleetWaveSize = 2;
+static uint8_t fleetUpdated = 0;
+static uint8_t fleetFailed = 0;
+static unsigned long fleetWaveTime = 0;
+static uint8_t fleetStartRequest = 0; // wave size of a start requested over HTTP, handled in loop() which owns Nodes
+static IPAddress fleetPullFrom;      // peer role: coordinator to pull the image from
+
+static NodeStruct* fleetNode(IPAddress ip)
+{
+  NodeStruct* node = Nodes.find(ip[3]);
+  return (node && node->ip == ip) ? node : nullptr;
+}
+
+static void startFleetUpdate(uint8_t waveSize)
+{
+  if (fleetState == FleetState::Running) return;
+  fleetPeerCount = 0;
+  for (uint16_t i = 0; i < Nodes.capacity() && fleetPeerCount < FLEET_MAX_PEERS; i++) {
+    NodeStruct& node = Nodes[i];
+    if (!node.used || node.nodeType != NODE_TYPE_ID_ESP32 || node.build == VERSION) continue;
+    fleetPeers[fleetPeerCount++] = node.ip;
+  }
+  fleetWaveSize = waveSize;
+  fleetNext = fleetWaveStart = fleetUpdated = fleetFailed = 0;
+  fleetWaveTime = 0;
+  fleetState = FleetState::Running;
+  DEBUG_PRINTF("Fleet update of %u nodes\n", fleetPeerCount);
+}
+
+//asks a peer to pull our image, true if it accepted
+static bool triggerPeer(IPAddress peer)
+{
+  WiFiClient client;
+  if (!client.connect(peer, 80, FLEET_TRIGGER_TIMEOUT)) return false;
+  IPAddress me = Network.localIP();
+  client.printf_P(PSTR("GET /fleet?pull=%u.%u.%u.%u HTTP/1.1\r\nHost: %u.%u.%u.%u\r\nConnection: close\r\n\r\n"),
+    me[0], me[1], me[2], me[3], peer[0], peer[1], peer[2], peer[3]);
+  client.setTimeout(FLEET_TRIGGER_TIMEOUT / 1000 +1);
+  String status = client.readStringUntil('\n'); // "HTTP/1.1 200 OK"
+  client.stop();
+  return status.indexOf(F(" 200")) > 0;
+}
+
+static void handleFleetWave()
+{
+  uint8_t waveEnd = MIN(fleetWaveStart + fleetWaveSize, fleetPeerCount);
+  if (fleetNext < waveEnd) { // one trigger per loop() pass
+    if (!triggerPeer(fleetPeers[fleetNext])) {
+      fleetFailed++;
+      fleetPeers[fleetNext] = IPAddress(); //nothing to wait for
+    }
+    fleetNext++;
+    fleetWaveTime = millis();
+    return;
+  }
+  //wave complete when every peer announced our build, the rest fails on timeout
+  bool timeout = millis() - fleetWaveTime > FLEET_WAVE_TIMEOUT;
+  uint8_t pending = 0;
+  for (uint8_t i = fleetWaveStart; i < waveEnd; i++) {
+    if (!uint32_t(fleetPeers[i])) continue;
+    NodeStruct* node = fleetNode(fleetPeers[i]);
+    if (node && node->build == VERSION) {
+      fleetUpdated++;
+      fleetPeers[i] = IPAddress();
+    } else if (timeout) {
+      fleetFailed++;
+      fleetPeers[i] = IPAddress();
+    } else pending++;
+  }
+  if (pending) return;
+  fleetWaveStart = waveEnd;
+  if (fleetWaveStart >= fleetPeerCount) fleetState = FleetState::Done;
+}
+
+//peer role, blocks loop() until the image is written
+static void pullFirmware()
+{
+  IPAddress from = fleetPullFrom;
+  fleetPullFrom = IPAddress();
+  char url[40];
+  snprintf_P(url, sizeof(url), PSTR("http://%u.%u.%u.%u/fw.bin"), from[0], from[1], from[2], from[3]);
+  DEBUG_PRINT(F("Fleet update from ")); DEBUG_PRINTLN(url);
+  flushPresetQueue();
+  WiFiClient client;
+  httpUpdate.rebootOnUpdate(false);
+  if (httpUpdate.update(client, url) == HTTP_UPDATE_OK) doReboot = true;
+  else DEBUG_PRINTLN(httpUpdate.getLastErrorString());
+}
+
+//called by initServer() if OTA is unlocked
+void initFleetOTA()
+{
+  //the running image, as long as the build it was written from
+  server.on("/fw.bin", HTTP_GET, [](AsyncWebServerRequest *request){
+    const esp_partition_t* running = esp_ota_get_running_partition();
+    size_t size = ESP.getSketchSize();
+    if (!running || !size) {request->send(500); return;}
+    request->send("application/octet-stream", size, [running, size](uint8_t *buffer, size_t maxLen, size_t index) -> size_t {
+      size_t len = MIN(maxLen, size - index);
+      if (esp_partition_read(running, index, buffer, len) != ESP_OK) return 0;
+      return len;
+    });
+  });
+
+  //?start=1&wave=n: update the instance list n nodes at a time, ?pull=ip: update from that node, status otherwise
+  server.on("/fleet", HTTP_GET, [](AsyncWebServerRequest *request){
+    if (request->hasArg(F("pull"))) {
+      IPAddress from;
+      if (!from.fromString(request->arg(F("pull"))) || uint32_t(fleetPullFrom)) {request->send(400); return;}
+      fleetPullFrom = from;
+      request->send(200, "text/plain", F("Updating"));
+      return;
+    }
+    if (request->hasArg(F("start"))) {
+      fleetStartRequest = request->hasArg(F("wave")) ? constrain(request->arg(F("wave")).toInt(), 1, 16) : 2;
+    }
+    static const char* states[] = {"idle", "running", "done"};
+    char buf[96];
+    snprintf_P(buf, sizeof(buf), PSTR("{\"state\":\"%s\",\"total\":%u,\"updated\":%u,\"failed\":%u,\"waves\":%u}"),
+      states[(uint8_t)fleetState], fleetPeerCount, fleetUpdated, fleetFailed, fleetWaveStart / fleetWaveSize);
+    request->send(200, "application/json", buf);
+  });
+}
+
+void handleFleetOTA()
+{
+  if (uint32_t(fleetPullFrom)) {pullFirmware(); return;}
+  if (fleetStartRequest) {
+    startFleetUpdate(fleetStartRequest);
+    fleetStartRequest = 0;
+  }
+  if (fleetState == FleetState::Running && WLED_CONNECTED) handleFleetWave();
+}
+#else
+void initFleetOTA() {}
+void handleFleetOTA() {}
+#endif
@@ -0,0 +1,172 @@
+#include "wled.h"
+
+/*
+ * Preset storage benchmark: times readPreset() and writePreset() on the device filesystem, against a synthetic
+ * presets.json of n presets, so the preset index, the free space map and the binary store are all part of it.
+ * Started with {"fsbench":n} (1-250), results are part of /json/perf.
+ * The own preset files are moved aside while it runs (a few seconds) and restored after it, or on the next boot.
+ * One file operation runs per loop pass, so the LEDs keep running.
+ * Saves alternate between the same size (replaced in place) and a larger object (spaces or append).
+ */
+#ifdef WLED_ENABLE_FSBENCH
+
+#define FSBENCH_BACKUP     "/fsbench.json" //presets.json while the benchmark runs
+#define FSBENCH_BIN_BACKUP "/fsbench.bin"  //presets.bin while the benchmark runs
+#define FSBENCH_MAX       250
+#define FSBENCH_SAMPLES   20   //presets recalled and saved, spread over the file
+#define FSBENCH_GEN_STEP  10   //presets written per loop pass while generating the file
+
+enum { FSB_IDLE, FSB_GENERATE, FSB_RECALL, FSB_SAVE };
+
+static volatile int16_t fsbRequest = -1;  //set by the JSON API, started by loop()
+static uint16_t fsbPresets = 0;
+static uint8_t fsbPhase = FSB_IDLE;
+static uint16_t fsbStep = 0;
+static WS2812FX::PerfStat fsbRecall, fsbSave; //us per operation
+static uint32_t fsbRecallBytes = 0, fsbSaveBytes = 0; //bytes scanned in total
+static uint32_t fsbFileSize = 0;
+
+void startFsBenchmark(uint16_t presets)
+{
+  fsbRequest = MIN(presets, FSBENCH_MAX);
+}
+
+//similar in size and shape to a preset saved from the UI, the name is longer for larger objects
+static size_t fsbPreset(char* buf, size_t len, uint16_t id, uint8_t extra)
+{
+  return snprintf_P(buf, len, PSTR("{\"on\":true,\"bri\":%u,\"transition\":7,\"mainseg\":0,\"seg\":[{\"id\":0,\"start\":0,\"stop\":150,"
+    "\"grp\":1,\"spc\":0,\"on\":true,\"bri\":255,\"col\":[[255,%u,0],[0,0,0],[0,0,0]],\"fx\":%u,\"sx\":128,\"ix\":128,\"pal\":%u,"
+    "\"sel\":true,\"rev\":false,\"mi\":false}],\"n\":\"Benchmark preset %u%.*s\"}"),
+    id & 0xFF, (id * 7) & 0xFF, id % 100, id % 50, id, extra, "........................................");
+}
+
+static uint16_t fsbSampleId(uint16_t i)
+{
+  uint16_t samples = MIN(fsbPresets, FSBENCH_SAMPLES);
+  return samples > 1 ? 1 + (uint32_t)i * (fsbPresets -1) / (samples -1) : 1;
+}
+
+//the synthetic presets take the place of the own ones, the index and the binary store start over
+static bool fsbSwapIn()
+{
+  flushPresetQueue();
+  if (doCloseFile) closeFile();
+  if (!WLED_FS.exists("/presets.json")) {
+    File pf = WLED_FS.open("/presets.json", "w");
+    if (!pf) return false;
+    pf.print(F("{\"0\":{}}"));
+    pf.close();
+  }
+  if (!WLED_FS.rename("/presets.json", FSBENCH_BACKUP)) return false;
+  if (WLED_FS.exists("/presets.bin") && !WLED_FS.rename("/presets.bin", FSBENCH_BIN_BACKUP)) {
+    WLED_FS.rename(FSBENCH_BACKUP, "/presets.json");
+    return false;
+  }
+  invalidatePresetIndex();
+  #ifdef WLED_ENABLE_BINARY_PRESETS
+  reloadBinPresets();
+  #endif
+  return true;
+}
+
+//puts the own presets back, also called at boot after a benchmark was interrupted
+void restoreFsBenchmark()
+{
+  if (!WLED_FS.exists(FSBENCH_BACKUP)) return;
+  if (doCloseFile) closeFile();
+  WLED_FS.remove("/presets.json");
+  WLED_FS.remove("/presets.bin");
+  WLED_FS.rename(FSBENCH_BACKUP, "/presets.json");
+  if (WLED_FS.exists(FSBENCH_BIN_BACKUP)) WLED_FS.rename(FSBENCH_BIN_BACKUP, "/presets.bin");
+  invalidatePresetIndex();
+  invalidatePresetsChecksum();
+  #ifdef WLED_ENABLE_BINARY_PRESETS
+  reloadBinPresets();
+  #endif
+  updateFSInfo();
+}
+
+//writes FSBENCH_GEN_STEP presets, in the layout writeObjectToFile() produces
+static void fsbGenerate()
+{
+  char buf[400];
+  File bf = WLED_FS.open("/presets.json", fsbStep ? "a" : "w");
+  if (!bf) { fsbPhase = FSB_IDLE; restoreFsBenchmark(); return; }
+  if (!fsbStep) bf.print(F("{\"0\":{}"));
+  for (uint8_t i = 0; i < FSBENCH_GEN_STEP && fsbStep < fsbPresets; i++) {
+    fsbStep++;
+    char key[10];
+    snprintf_P(key, sizeof(key), PSTR(",\"%u\":"), fsbStep);
+    bf.print(key);
+    bf.write((const uint8_t*)buf, fsbPreset(buf, sizeof(buf), fsbStep, 0));
+  }
+  if (fsbStep == fsbPresets) {
+    bf.write('}');
+    fsbFileSize = bf.size();
+    fsbPhase = FSB_RECALL;
+    fsbStep = 0;
+  }
+  bf.close();
+}
+
+void handleFsBenchmark()
+{
+  if (fsbRequest >= 0) {
+    fsbPresets = fsbRequest;
+    fsbRequest = -1;
+    fsbRecall.reset(); fsbSave.reset();
+    fsbRecallBytes = fsbSaveBytes = 0;
+    fsbStep = 0;
+    if (fsbPhase == FSB_IDLE && fsbPresets && !fsbSwapIn()) fsbPresets = 0;
+    fsbPhase = fsbPresets ? FSB_GENERATE : FSB_IDLE;
+    if (!fsbPresets) restoreFsBenchmark();
+  }
+  if (fsbPhase == FSB_IDLE) return;
+  if (doCloseFile) closeFile();
+  if (fsbPhase == FSB_GENERATE) { fsbGenerate(); return; }
+
+  PSRAMDynamicJsonDocument doc(1024);
+  uint16_t id = fsbSampleId(fsbStep);
+  uint32_t scanned = fsBytesScanned;
+  uint32_t start = micros();
+  if (fsbPhase == FSB_RECALL) {
+    readPreset(id, &doc);
+    fsbRecall.add(micros() - start);
+    fsbRecallBytes += fsBytesScanned - scanned;
+  } else {
+    char buf[400];
+    fsbPreset(buf, sizeof(buf), id, (fsbStep & 1) ? 40 : 0);
+    deserializeJson(doc, buf);
+    start = micros(); //the save is timed from the serialized document on
+    writePreset(id, &doc);
+    closeFile(); //flushing is part of the save
+    fsbSave.add(micros() - start);
+    fsbSaveBytes += fsBytesScanned - scanned;
+  }
+  if (++fsbStep < MIN(fsbPresets, FSBENCH_SAMPLES)) return;
+  fsbStep = 0;
+  if (fsbPhase == FSB_RECALL) { fsbPhase = FSB_SAVE; return; }
+  fsbPhase = FSB_IDLE;
+  restoreFsBenchmark();
+  DEBUG_PRINTF("FS benchmark, %u presets: recall %u us, save %u us\n", fsbPresets, fsbRecall.avg, fsbSave.avg);
+}
+
+void serializeFsBenchmark(JsonObject root)
+{
+  if (!fsbPresets) return;
+  JsonObject bench = root.createNestedObject(F("fsbench"));
+  bench[F("run")]  = fsbPhase != FSB_IDLE;
+  bench["n"]       = fsbPresets;
+  bench[F("size")] = fsbFileSize;
+  serializePerfStat(bench.createNestedObject(F("rcl")), fsbRecall);
+  serializePerfStat(bench.createNestedObject(F("sav")), fsbSave);
+  //bytes the searches read per operation
+  bench[F("rclb")] = fsbRecall.count ? fsbRecallBytes / fsbRecall.count : 0;
+  bench[F("savb")] = fsbSave.count ? fsbSaveBytes / fsbSave.count : 0;
+}
+#else
+void startFsBenchmark(uint16_t presets) {}
+void handleFsBenchmark() {}
+void restoreFsBenchmark() {}
+void serializeFsBenchmark(JsonObject root) {}
+#endif
@@ -0,0 +1,269 @@
+#include "wled.h"
+
+/*
+ * Standalone playback of xLights .fseq sequences (v2, uncompressed) from the filesystem.
+ * Frames are read ahead in chunks and shown through the realtime path at the step time of the file.
+ * Started with {"fseq":{"file":"/show.fseq","loop":true}} in the JSON API, so presets and playlist entries can run a show.
+ * Applying a preset without "fseq", {"fseq":{}}, {"live":false} or another realtime source ends playback.
+ * Requests from the JSON API (possibly a network callback) are queued and carried out in loop(), which owns the file.
+ * Sequences below /sd/ are read from the SD card in whole blocks (WLED_ENABLE_SD).
+ * Recordings of the realtime recorder (.wrec, see recorder.cpp) are played the same way, frame by frame.
+ */
+#ifdef WLED_ENABLE_FSEQ
+
+#define FSEQ_HEADER_SIZE 32
+#define FSEQ_MAX_RANGES  16
+#define FSEQ_REC_HEADER_SIZE 12
+#define FSEQ_REC_CHUNK   1536 //bytes of a recording read at once, whole RGB and RGBW pixels
+
+#ifndef FSEQ_READ_AHEAD
+  #ifdef ESP8266
+  #define FSEQ_READ_AHEAD 4096  //bytes of frame data read at once
+  #else
+  #define FSEQ_READ_AHEAD 16384
+  #endif
+#endif
+
+struct FseqRange { uint32_t start, count; }; //channels stored in the file, all channels if not sparse
+
+static File fseqFile;
+static uint8_t* fseqBuffer = nullptr;  //whole frames read ahead
+static uint16_t fseqAlign = 1;         //reads start on a multiple of this, the card block size for SD
+static uint16_t fseqLead = 0;          //bytes in the buffer before fseqBufFirst
+static FseqRange fseqRanges[FSEQ_MAX_RANGES];
+static uint8_t  fseqRangeCount = 0;
+static uint32_t fseqFrameSize = 0;     //bytes per frame in the file
+static uint32_t fseqFrameCount = 0;
+static uint32_t fseqDataOffset = 0;
+static uint8_t  fseqStep = 50;         //ms per frame
+static uint16_t fseqBufFrames = 0;     //capacity of the buffer
+static uint32_t fseqBufFirst = 0;      //first frame in the buffer
+static uint16_t fseqBufCount = 0;      //frames in the buffer
+static uint32_t fseqNext = 0;          //first frame not shown yet
+static unsigned long fseqStart = 0;    //time of frame 0
+static bool fseqLoop = false;
+static bool fseqShown = false;         //realtime mode was entered by the player
+static char fseqRequestFile[33];
+static int8_t fseqRequest = 0;         //1: start fseqRequestFile, -1: stop
+static bool fseqRequestLoop = false;
+static bool fseqRec = false;           //playing a recording
+static uint8_t  fseqRecChannels = 3;
+static uint32_t fseqRecNext = 0;       //ms after fseqStart the frame whose header was read is due
+static uint16_t fseqRecRuns = 0;       //runs of that frame
+
+static uint32_t fseqRead24(const uint8_t* p) { return p[0] | (p[1] << 8) | (p[2] << 16); }
+static uint32_t fseqRead32(const uint8_t* p) { return fseqRead24(p) | (p[3] << 24); }
+
+//fileName nullptr stops playback
+void queueFseq(const char* fileName, bool loop)
+{
+  if (fileName) {
+    strlcpy(fseqRequestFile, fileName, sizeof(fseqRequestFile));
+    fseqRequestLoop = loop;
+  }
+  fseqRequest = fileName ? 1 : -1;
+}
+
+static void stopFseq()
+{
+  if (!fseqBuffer) return;
+  fseqFile.close();
+  free(fseqBuffer);
+  fseqBuffer = nullptr;
+  if (fseqShown && realtimeMode == REALTIME_MODE_FSEQ) realtimeTimeout = 0; //exit realtime mode right away
+  fseqShown = false;
+  DEBUG_PRINTLN(F("FSEQ stopped"));
+}
+
+//reads the header of the next frame of a recording, false at the end
+static bool readRecHeader()
+{
+  uint16_t hdr[2];
+  if (fseqFile.read((uint8_t*)hdr, 4) != 4) return false;
+  fseqRecNext += hdr[0];
+  fseqRecRuns = hdr[1];
+  return true;
+}
+
+static bool rewindRec()
+{
+  fseqRecNext = 0;
+  fseqStart = millis();
+  return fseqFile.seek(FSEQ_REC_HEADER_SIZE) && readRecHeader();
+}
+
+static bool startRecPlayback(const uint8_t* h)
+{
+  fseqRecChannels = (h[5] == 4) ? 4 : 3;
+  fseqBuffer = (uint8_t*) allocLarge(FSEQ_REC_CHUNK);
+  if (!fseqBuffer) {fseqFile.close(); return false;}
+  fseqShown = false;
+  if (!rewindRec()) {stopFseq(); return false;}
+  DEBUG_PRINTF("Recording playback: %u channels per pixel\n", fseqRecChannels);
+  return true;
+}
+
+//applies the runs of the frame whose header was read, every frame builds on the previous one
+static bool showRecFrame()
+{
+  uint16_t totalLen = strip.getLengthTotal();
+  bool gamma = !arlsDisableGammaCorrection && strip.gammaCorrectCol; //recorded before gamma correction
+  for (uint16_t r = 0; r < fseqRecRuns; r++) {
+    uint16_t run[2];
+    if (fseqFile.read((uint8_t*)run, 4) != 4) return false;
+    uint32_t bytes = run[1] * fseqRecChannels;
+    if (realtimeOverride) {fseqFile.seek(bytes, SeekCur); continue;}
+    uint16_t pix = run[0];
+    while (bytes) {
+      uint16_t n = MIN(bytes, (uint32_t)FSEQ_REC_CHUNK);
+      if (fseqFile.read(fseqBuffer, n) != n) return false;
+      uint16_t len = n / fseqRecChannels;
+      if (pix < totalLen) strip.setRealtimeSpan(pix, fseqBuffer, MIN(len, (uint16_t)(totalLen - pix)), fseqRecChannels == 4, gamma);
+      pix += len; bytes -= n;
+    }
+  }
+  return true;
+}
+
+static void handleRecPlayback()
+{
+  if (millis() - fseqStart < fseqRecNext) return;
+  RENDER_LOCK();
+  realtimeLock(realtimeTimeoutMs, REALTIME_MODE_FSEQ);
+  fseqShown = true;
+  //late frames can't be skipped, they are applied together and shown once
+  for (uint8_t i = 0; i < 8 && millis() - fseqStart >= fseqRecNext; i++) {
+    bool more = showRecFrame() && readRecHeader();
+    if (!more && !(fseqLoop && rewindRec())) {
+      if (!realtimeOverride) strip.show();
+      stopFseq(); return;
+    }
+  }
+  if (!realtimeOverride) strip.show();
+}
+
+static bool startFseq(const char* fileName, bool loop)
+{
+  stopFseq();
+  fseqFile = openMediaFile(fileName);
+  if (!fseqFile) return false;
+
+  uint8_t h[FSEQ_HEADER_SIZE];
+  size_t hLen = fseqFile.read(h, FSEQ_HEADER_SIZE);
+  fseqLoop = loop;
+  fseqRec = hLen >= FSEQ_REC_HEADER_SIZE && !memcmp_P(h, PSTR("WREC"), 4);
+  if (fseqRec) return startRecPlayback(h);
+  if (hLen != FSEQ_HEADER_SIZE || memcmp_P(h, PSTR("PSEQ"), 4) || h[7] != 2) {
+    DEBUG_PRINTLN(F("FSEQ: not a v2 sequence"));
+    fseqFile.close(); return false;
+  }
+  if (h[20] & 0x0F) { //there is no zstd/zlib decoder in the firmware, save the sequence uncompressed in xLights
+    DEBUG_PRINTLN(F("FSEQ: compressed sequences are not supported"));
+    fseqFile.close(); return false;
+  }
+  fseqDataOffset = h[4] | (h[5] << 8);
+  uint32_t channels = fseqRead32(h +10);
+  fseqFrameCount = fseqRead32(h +14);
+  fseqStep = h[18] ? h[18] : 50;
+  uint16_t compBlocks = ((h[20] >> 4) << 8) | h[21];
+  uint8_t sparse = h[22];
+
+  //sparse ranges follow the compression block index
+  fseqRangeCount = 0;
+  fseqFrameSize = 0;
+  if (sparse) {
+    fseqFile.seek(FSEQ_HEADER_SIZE + compBlocks * 8);
+    for (uint8_t i = 0; i < sparse; i++) {
+      uint8_t r[6];
+      if (fseqFile.read(r, 6) != 6) break;
+      uint32_t count = fseqRead24(r +3);
+      fseqFrameSize += count;
+      if (fseqRangeCount < FSEQ_MAX_RANGES) fseqRanges[fseqRangeCount++] = {fseqRead24(r), count};
+    }
+  } else {
+    fseqRanges[fseqRangeCount++] = {0, channels};
+    fseqFrameSize = channels;
+  }
+  if (!fseqFrameSize || !fseqFrameCount || fseqDataOffset + fseqFrameSize * fseqFrameCount > fseqFile.size()) {
+    DEBUG_PRINTLN(F("FSEQ: invalid size"));
+    fseqFile.close(); return false;
+  }
+
+  fseqAlign = isSDPath(fileName) ? WLED_SD_SECTOR : 1;
+  fseqBufFrames = MAX(1, MIN(FSEQ_READ_AHEAD / fseqFrameSize, fseqFrameCount));
+  fseqBuffer = (uint8_t*) allocMediaBuffer(fileName, fseqBufFrames * fseqFrameSize + fseqAlign -1);
+  if (!fseqBuffer && fseqBufFrames > 1) {
+    fseqBufFrames = 1;
+    fseqBuffer = (uint8_t*) allocMediaBuffer(fileName, fseqFrameSize + fseqAlign -1);
+  }
+  if (!fseqBuffer) {fseqFile.close(); return false;}
+
+  fseqBufCount = 0;
+  fseqNext = 0;
+  fseqShown = false;
+  fseqStart = millis();
+  DEBUG_PRINTF("FSEQ %s: %u channels, %u frames, %u ms\n", fileName, fseqFrameSize, fseqFrameCount, fseqStep);
+  return true;
+}
+
+static bool loadFseqFrames(uint32_t first)
+{
+  uint32_t n = MIN((uint32_t)fseqBufFrames, fseqFrameCount - first);
+  fseqBufFirst = first;
+  fseqBufCount = 0;
+  uint32_t pos = fseqDataOffset + first * fseqFrameSize;
+  fseqLead = pos % fseqAlign;
+  if (!fseqFile.seek(pos - fseqLead)) return false;
+  size_t len = fseqFile.read(fseqBuffer, fseqLead + n * fseqFrameSize);
+  fseqBufCount = (len > fseqLead) ? (len - fseqLead) / fseqFrameSize : 0;
+  return fseqBufCount;
+}
+
+void handleFseq()
+{
+  if (fseqRequest) {
+    if (fseqRequest > 0) startFseq(fseqRequestFile, fseqRequestLoop);
+    else                 stopFseq();
+    fseqRequest = 0;
+  }
+  if (!fseqBuffer) return;
+  //realtime ended or taken over by a network source
+  if (fseqShown && realtimeMode != REALTIME_MODE_FSEQ) {stopFseq(); return;}
+  if (fseqRec) {handleRecPlayback(); return;}
+
+  uint32_t due = (millis() - fseqStart) / fseqStep;
+  if (due < fseqNext) return;
+  if (due >= fseqFrameCount) {
+    if (!fseqLoop) {stopFseq(); return;}
+    fseqStart += fseqFrameCount * fseqStep;
+    due = (millis() - fseqStart) / fseqStep;
+    if (due >= fseqFrameCount) {fseqStart = millis(); due = 0;} //far behind, restart
+    fseqNext = 0;
+  }
+  //frames that are late are skipped to stay on time
+  if (due < fseqBufFirst || due >= fseqBufFirst + fseqBufCount) {
+    if (!loadFseqFrames(due)) {stopFseq(); return;}
+  }
+
+  RENDER_LOCK();
+  realtimeLock(realtimeTimeoutMs, REALTIME_MODE_FSEQ);
+  fseqShown = true;
+  if (!realtimeOverride) {
+    const uint8_t* data = fseqBuffer + fseqLead + (due - fseqBufFirst) * fseqFrameSize;
+    for (uint8_t r = 0; r < fseqRangeCount; r++) {
+      //ranges are expected to start on a pixel
+      setRealtimePixels(fseqRanges[r].start / 3, data, fseqRanges[r].count / 3, false);
+      data += fseqRanges[r].count;
+    }
+    recordShow();
+    strip.show();
+  }
+  fseqNext = due +1;
+}
+
+bool fseqPlaying() { return fseqBuffer; }
+#else
+void queueFseq(const char* fileName, bool loop) {}
+void handleFseq() {}
+bool fseqPlaying() { return false; }
+#endif
@@ -0,0 +1,157 @@
+/*
+ * Binary array for the palette previews of the Web UI (/palettes.json).
+ * gzip is used for smaller size and improved speeds.
+ */
+
+// Autogenerated from wled00/palettes.h, do not edit!!
+const uint16_t PAGE_palettes_L = 2350;
+#define PAGE_palettes_ETAG "36195e9c"
+const uint8_t PAGE_palettes[] PROGMEM = {
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x85, 0x59, 0x49, 0x92, 0x23, 0x39,
+  0x0e, 0xfc, 0x4b, 0x9d, 0x71, 0x20, 0x16, 0x6e, 0xfd, 0x95, 0xb2, 0xfc, 0xc3, 0xdc, 0xdb, 0xfa,
+  0xef, 0x63, 0xee, 0x00, 0x19, 0x21, 0xd5, 0x2c, 0xa6, 0x8b, 0xa0, 0x60, 0x90, 0x20, 0x16, 0x87,
+  0x03, 0xfa, 0xfb, 0xd7, 0xbf, 0x7e, 0xfd, 0xf5, 0xf7, 0x2f, 0xf5, 0x5f, 0x7f, 0xfd, 0xfe, 0xdd,
+  0x44, 0xad, 0x49, 0x93, 0xf6, 0x23, 0xbf, 0xcd, 0x44, 0xe7, 0x16, 0x33, 0x4a, 0x5d, 0xc5, 0x7a,
+  0x17, 0x6d, 0x41, 0x71, 0x75, 0xd1, 0x31, 0xf1, 0x50, 0xd7, 0x8f, 0xfc, 0x56, 0xc7, 0x23, 0xbc,
+  0xa9, 0xcd, 0x21, 0xef, 0x25, 0x3a, 0x20, 0x3a, 0xb7, 0xea, 0x5d, 0xf8, 0x70, 0xb4, 0x9f, 0x1f,
+  0xf9, 0xa5, 0x51, 0x67, 0x89, 0x86, 0x74, 0x2c, 0x6f, 0x8a, 0xe5, 0x3e, 0x44, 0x03, 0xe2, 0xe8,
+  0xd2, 0x87, 0x8c, 0x25, 0xf9, 0x76, 0x98, 0x68, 0x6f, 0xa2, 0x7d, 0xc8, 0xde, 0xb5, 0xdd, 0xeb,
+  0x07, 0xec, 0xd8, 0xcf, 0x8e, 0x43, 0x26, 0xd4, 0xdb, 0xa2, 0xb2, 0xb7, 0xa8, 0x2a, 0xf6, 0xeb,
+  0x2e, 0x1a, 0x21, 0xd6, 0x36, 0x2e, 0x71, 0x15, 0x9a, 0x2e, 0xcb, 0xf8, 0xfa, 0xc8, 0xd7, 0x43,
+  0x54, 0x26, 0x8e, 0x74, 0x15, 0x9c, 0x91, 0xe7, 0x0f, 0xe7, 0xd5, 0x83, 0x3b, 0xef, 0x2e, 0x7d,
+  0x8b, 0x89, 0x41, 0x11, 0xb5, 0x29, 0xaa, 0xe2, 0xd2, 0x1b, 0x8f, 0xd9, 0xe2, 0x5b, 0x96, 0x0c,
+  0x4a, 0x5b, 0x45, 0xd5, 0x44, 0xb7, 0x44, 0x9a, 0xd3, 0x65, 0x2e, 0x2e, 0x3f, 0x77, 0x30, 0x2c,
+  0xee, 0x79, 0x81, 0x59, 0x17, 0x58, 0x4b, 0x68, 0xcc, 0x5a, 0x12, 0x43, 0xa6, 0x28, 0x57, 0xac,
+  0x5c, 0xe1, 0xd2, 0xea, 0x12, 0xd0, 0xeb, 0x91, 0xa0, 0xcb, 0x98, 0x8f, 0x88, 0xe3, 0xc3, 0xa4,
+  0x49, 0x9c, 0x0b, 0x97, 0x17, 0xb8, 0xd9, 0x3e, 0xde, 0x1e, 0xd0, 0xe8, 0xd9, 0x41, 0xf7, 0x14,
+  0x15, 0x33, 0x88, 0xb3, 0x8b, 0x29, 0xac, 0x3c, 0x45, 0xa7, 0xf1, 0x0a, 0x4a, 0xc9, 0x71, 0xb1,
+  0xeb, 0x87, 0x23, 0xff, 0xc8, 0x2f, 0x6b, 0xb5, 0x6d, 0x93, 0x61, 0xa2, 0x86, 0x50, 0xf0, 0x01,
+  0x5f, 0xaa, 0x9f, 0xd0, 0x58, 0x53, 0xe0, 0x0f, 0xb3, 0x2e, 0x2b, 0x7d, 0xdf, 0x44, 0xf7, 0x16,
+  0xd3, 0x29, 0x83, 0xb1, 0xd4, 0x26, 0x55, 0xb5, 0x36, 0xa5, 0x33, 0x1c, 0xb4, 0x8b, 0x05, 0x5e,
+  0x33, 0xe9, 0x93, 0x8a, 0x36, 0x31, 0xdf, 0x82, 0x95, 0x83, 0x0e, 0xb6, 0xf5, 0xb5, 0x62, 0xb5,
+  0xcf, 0x3d, 0x60, 0x7d, 0xfe, 0x60, 0x53, 0x62, 0xbd, 0x0c, 0x62, 0xb1, 0x24, 0x52, 0x79, 0x2d,
+  0xe5, 0xb5, 0x49, 0x20, 0x74, 0xb0, 0x6a, 0x23, 0x0e, 0x3c, 0x44, 0x19, 0x08, 0x0b, 0x01, 0x6f,
+  0x26, 0xbb, 0x04, 0xe8, 0x60, 0x21, 0xd8, 0x6f, 0x23, 0x19, 0x32, 0x24, 0x2d, 0x75, 0x44, 0xbc,
+  0xb9, 0xe8, 0xf6, 0xd2, 0x71, 0x2e, 0x71, 0x97, 0xee, 0xd2, 0xc7, 0x8d, 0x40, 0x95, 0x9e, 0x67,
+  0x5b, 0x9e, 0x9d, 0x5a, 0x99, 0x58, 0xe6, 0x81, 0x7d, 0xfd, 0x60, 0x7f, 0xfc, 0x30, 0x44, 0x37,
+  0xec, 0x87, 0x58, 0xa3, 0x9f, 0x11, 0x3e, 0x53, 0x34, 0xb8, 0x73, 0xca, 0x67, 0x9b, 0x86, 0x05,
+  0xbd, 0x09, 0x52, 0x39, 0x46, 0xed, 0x30, 0x55, 0x74, 0x8a, 0x39, 0x4c, 0x03, 0xbd, 0xb6, 0x8b,
+  0x51, 0x69, 0xdd, 0xbb, 0x4c, 0x9d, 0xb7, 0xd2, 0x49, 0x95, 0xdc, 0x91, 0xb6, 0xed, 0x9c, 0xa7,
+  0xc8, 0x59, 0x64, 0xc4, 0xd4, 0x92, 0xa6, 0xa8, 0x63, 0x4f, 0xc6, 0x7c, 0x5b, 0xc8, 0x43, 0x6c,
+  0xa0, 0xf7, 0xce, 0x8c, 0x06, 0xe7, 0xad, 0xfd, 0x49, 0x3b, 0x4d, 0x8c, 0x49, 0xd0, 0x80, 0x5e,
+  0x43, 0x10, 0x8a, 0x2d, 0xc4, 0x0b, 0x20, 0x18, 0x6d, 0xd8, 0x7a, 0x3f, 0xd1, 0xbe, 0x25, 0x4e,
+  0x7e, 0x9f, 0x17, 0xcd, 0xf6, 0xdd, 0x30, 0xd3, 0x56, 0x33, 0x81, 0xac, 0x50, 0x67, 0x21, 0x85,
+  0x7e, 0xe4, 0x77, 0x18, 0xd2, 0x67, 0x4a, 0xa5, 0xf8, 0xec, 0xe2, 0x4b, 0x60, 0x82, 0x15, 0xa2,
+  0x63, 0x03, 0x3e, 0x3c, 0xe3, 0x11, 0xb6, 0x72, 0xfe, 0xa6, 0x79, 0xb8, 0x0e, 0xb9, 0xf1, 0x93,
+  0xa9, 0xe3, 0x99, 0xb6, 0xa9, 0x23, 0xdf, 0x8a, 0x0c, 0x16, 0x86, 0x18, 0xdd, 0xdf, 0x32, 0x37,
+  0xe5, 0x80, 0x03, 0xc0, 0x71, 0x24, 0xd2, 0x2a, 0xf2, 0xb4, 0x1e, 0x95, 0x91, 0x7a, 0x26, 0xaa,
+  0x15, 0xb0, 0x1d, 0x50, 0xf6, 0x09, 0xec, 0xe9, 0xc7, 0x44, 0xda, 0xe1, 0x07, 0x39, 0xd9, 0x0b,
+  0xb8, 0x86, 0xa6, 0x95, 0x12, 0xc8, 0x6e, 0x53, 0x95, 0x60, 0x40, 0x7a, 0xa2, 0x0b, 0x41, 0x30,
+  0x7f, 0x29, 0x58, 0xd4, 0x65, 0x15, 0x1c, 0xd6, 0x02, 0xbe, 0x54, 0x44, 0x44, 0x3f, 0xca, 0xa8,
+  0x20, 0xa0, 0x76, 0xc6, 0xe9, 0x38, 0x38, 0x7b, 0xee, 0x21, 0x4e, 0x33, 0xe2, 0x48, 0xd8, 0x60,
+  0x24, 0x70, 0x16, 0x3a, 0xd9, 0xce, 0x03, 0x20, 0x0e, 0x60, 0x23, 0x10, 0x89, 0x71, 0x94, 0x1b,
+  0x47, 0x79, 0x66, 0x3e, 0xd1, 0xef, 0x4e, 0x97, 0x46, 0xa6, 0x2b, 0x92, 0x0c, 0x8a, 0xad, 0x34,
+  0xf8, 0x4c, 0x09, 0x57, 0x85, 0xb8, 0xec, 0x94, 0x9b, 0xd9, 0x1e, 0x87, 0x04, 0xe3, 0xbe, 0x6d,
+  0x89, 0x32, 0xff, 0x81, 0xaa, 0x95, 0x6f, 0x8d, 0xce, 0x33, 0x0b, 0x4e, 0x09, 0x1b, 0x73, 0x94,
+  0x49, 0xe0, 0x34, 0xba, 0x70, 0x94, 0x63, 0xd7, 0x66, 0x5a, 0xdb, 0xae, 0xf4, 0xd0, 0xd1, 0x64,
+  0xf2, 0xe0, 0x49, 0x14, 0x51, 0x84, 0x3f, 0x72, 0x5d, 0xdb, 0xad, 0x4c, 0x57, 0xc6, 0x31, 0xfb,
+  0x96, 0xba, 0xbb, 0x68, 0xe0, 0x9d, 0xed, 0x32, 0x19, 0x4b, 0x30, 0xb9, 0xc9, 0x48, 0xa3, 0xd1,
+  0x49, 0x70, 0x2a, 0xa0, 0x98, 0x2e, 0x6a, 0xaf, 0xa7, 0x86, 0xb4, 0x93, 0x35, 0x24, 0xd1, 0xd8,
+  0x77, 0x06, 0x4a, 0xf4, 0x77, 0xd8, 0x04, 0xaf, 0xe7, 0x85, 0xc4, 0x31, 0xc5, 0x9b, 0x58, 0x85,
+  0x3b, 0x62, 0x23, 0x66, 0x06, 0x24, 0xa2, 0xbc, 0xb9, 0x98, 0xee, 0x44, 0x0a, 0x1c, 0x99, 0xa2,
+  0xb5, 0x59, 0x36, 0x55, 0x81, 0x41, 0x12, 0x69, 0x50, 0xca, 0xf0, 0x51, 0xbd, 0xf7, 0x9c, 0x92,
+  0x79, 0xec, 0x07, 0x39, 0xf7, 0x49, 0x3c, 0x7e, 0x81, 0xf7, 0x93, 0x1c, 0x00, 0x95, 0x99, 0xbb,
+  0x76, 0xa0, 0x57, 0xd5, 0x4f, 0x5e, 0xfa, 0xc1, 0xbe, 0x83, 0x02, 0x2e, 0x0a, 0xd8, 0x68, 0x65,
+  0x9d, 0xb1, 0xb9, 0xd3, 0xcd, 0xf3, 0x99, 0x05, 0xb2, 0x3d, 0x15, 0xb2, 0x0f, 0x09, 0xee, 0x74,
+  0x38, 0x8c, 0xba, 0xb0, 0xfc, 0xe1, 0x1e, 0xd3, 0x58, 0xa3, 0xd6, 0x12, 0x7a, 0x0c, 0x0e, 0x6d,
+  0x4b, 0x16, 0x22, 0xed, 0x5d, 0x6c, 0x0a, 0xf0, 0x01, 0x9c, 0x00, 0x50, 0x7f, 0x95, 0x69, 0x94,
+  0x75, 0x97, 0x45, 0x7f, 0x7a, 0x9c, 0x7c, 0xd4, 0xa7, 0x0a, 0x3b, 0xe2, 0x34, 0x6e, 0x64, 0xfa,
+  0x47, 0x9a, 0xa3, 0xbe, 0x8d, 0x75, 0xe1, 0xa8, 0x02, 0x9f, 0x7b, 0x7d, 0xe5, 0x76, 0x0c, 0x5c,
+  0x3c, 0xbf, 0xef, 0xc1, 0x5b, 0xb4, 0xb2, 0xc2, 0x62, 0xe6, 0x54, 0x66, 0xeb, 0x16, 0xd4, 0x66,
+  0xad, 0x10, 0x89, 0x84, 0x27, 0xf0, 0x1b, 0xba, 0x2d, 0x4e, 0x6e, 0x10, 0x76, 0x56, 0x45, 0xb4,
+  0x76, 0xca, 0xd6, 0x32, 0x29, 0x94, 0x36, 0x83, 0x5b, 0x57, 0x15, 0x87, 0xcc, 0x3b, 0xf3, 0xb8,
+  0x99, 0x44, 0x39, 0x1e, 0x79, 0xbe, 0xef, 0x70, 0xb0, 0x0f, 0xf7, 0x18, 0x9f, 0xf7, 0xe8, 0x88,
+  0xcb, 0x5d, 0x06, 0x51, 0x08, 0xbe, 0x0e, 0x4e, 0xc6, 0xc6, 0x2d, 0xda, 0x65, 0x29, 0xa8, 0xd3,
+  0x9e, 0xf5, 0x3f, 0x89, 0x19, 0x6e, 0x85, 0xc7, 0xde, 0x5f, 0x54, 0xed, 0xfb, 0xc0, 0x79, 0x69,
+  0xc6, 0x4a, 0xf0, 0xb3, 0xf4, 0x60, 0xab, 0x88, 0x1b, 0x8d, 0x30, 0xe6, 0x2c, 0xed, 0xac, 0x69,
+  0xcb, 0x81, 0xe7, 0x19, 0xe8, 0x6d, 0xb0, 0xc6, 0x8f, 0x21, 0x83, 0x26, 0xc2, 0x5b, 0xe6, 0xa8,
+  0xf9, 0x23, 0x55, 0x76, 0x51, 0xdf, 0xe2, 0x5d, 0xc6, 0x28, 0xb4, 0xd7, 0x6d, 0x44, 0xc5, 0xbd,
+  0x4e, 0x69, 0x3f, 0xae, 0x74, 0xe6, 0x0a, 0x1c, 0x0c, 0x1e, 0xb3, 0x50, 0xea, 0xae, 0xd6, 0xa0,
+  0x40, 0xca, 0xc2, 0x09, 0xa5, 0xd7, 0x49, 0x12, 0xb1, 0x13, 0x5b, 0x62, 0x43, 0x22, 0x0d, 0xd5,
+  0x15, 0x41, 0x36, 0x52, 0xc5, 0x49, 0xf2, 0x4b, 0x0a, 0x95, 0x14, 0x09, 0xa7, 0x2f, 0x51, 0x20,
+  0x58, 0xb4, 0xa3, 0x33, 0x10, 0x36, 0xa9, 0x11, 0xb5, 0x0c, 0x52, 0xa8, 0x72, 0x18, 0xd5, 0x44,
+  0xe4, 0x03, 0x73, 0x01, 0x5e, 0x5a, 0xd6, 0xc7, 0xed, 0x40, 0x43, 0x17, 0x6f, 0xb2, 0x5c, 0x50,
+  0x28, 0x90, 0x9d, 0x57, 0x6d, 0x04, 0x54, 0x34, 0xb2, 0x37, 0xa8, 0x5d, 0x00, 0x66, 0xe3, 0x29,
+  0xd2, 0x63, 0x4a, 0x82, 0x3a, 0x30, 0x04, 0x7a, 0xa5, 0x84, 0x64, 0x25, 0xf9, 0x00, 0x0b, 0xa3,
+  0xa5, 0x81, 0x19, 0xea, 0x17, 0xdc, 0xa0, 0x10, 0xf8, 0x43, 0x6c, 0xb0, 0xde, 0x34, 0xe4, 0xe7,
+  0x0b, 0xde, 0x3f, 0x5e, 0x00, 0xf1, 0x47, 0xd5, 0xe8, 0x21, 0x91, 0xe8, 0xeb, 0x89, 0x1c, 0x5e,
+  0x78, 0x18, 0xa4, 0x67, 0x29, 0xe0, 0x72, 0xf3, 0x55, 0xf8, 0x4b, 0xf8, 0x91, 0x5f, 0xd1, 0xbe,
+  0x12, 0xcd, 0xf8, 0x95, 0x76, 0x5f, 0x21, 0xed, 0x83, 0x43, 0xf3, 0x61, 0x89, 0x55, 0x56, 0xda,
+  0x0d, 0xce, 0x4c, 0x9e, 0xfe, 0x3f, 0x62, 0x33, 0xf4, 0xf3, 0xac, 0xe1, 0xf2, 0xb0, 0xf0, 0x53,
+  0xb8, 0xde, 0x24, 0x3d, 0xe5, 0xff, 0x44, 0xd2, 0xc3, 0xfe, 0x50, 0x3b, 0x35, 0x4f, 0xb5, 0xcf,
+  0xca, 0xf7, 0xb6, 0xf1, 0x7f, 0xd4, 0x8e, 0x6f, 0xad, 0xf3, 0x20, 0x7f, 0x0e, 0xba, 0xa0, 0xd6,
+  0x9e, 0x6b, 0x62, 0xff, 0xf6, 0x66, 0x3b, 0x5b, 0x4f, 0x71, 0xfd, 0x2f, 0x1b, 0x3e, 0x28, 0xd9,
+  0x9b, 0x6c, 0xb8, 0x36, 0xe9, 0xee, 0x91, 0x2c, 0x11, 0x40, 0xa6, 0x5d, 0xce, 0x73, 0x45, 0xbc,
+  0x7f, 0xdb, 0x39, 0xcb, 0x8e, 0xd0, 0xc1, 0x4a, 0xbb, 0xf8, 0x6d, 0x18, 0x9c, 0x45, 0x60, 0x5b,
+  0x51, 0xd4, 0xa2, 0x0b, 0xba, 0x89, 0xe9, 0x91, 0x65, 0x1d, 0xc9, 0xb0, 0xab, 0x66, 0x93, 0xd1,
+  0x4e, 0x40, 0x7f, 0xa1, 0x8e, 0xef, 0xc2, 0xc1, 0x28, 0x75, 0x82, 0x28, 0x6a, 0x4e, 0x72, 0x6e,
+  0xb5, 0x00, 0xf1, 0xc7, 0x1b, 0x46, 0x6e, 0xc1, 0x25, 0xdd, 0x3f, 0xfa, 0x87, 0x7d, 0x5d, 0xff,
+  0x22, 0x47, 0xe9, 0x88, 0xd7, 0x77, 0xeb, 0xd2, 0x93, 0x42, 0x4e, 0x88, 0xf1, 0x7a, 0x34, 0xf4,
+  0xf9, 0x3e, 0x87, 0x44, 0x27, 0xbc, 0x3b, 0xeb, 0xe8, 0xeb, 0x11, 0xb3, 0xe9, 0x0a, 0xc6, 0xdb,
+  0xd1, 0xa2, 0x09, 0xac, 0xfe, 0x7a, 0x38, 0xde, 0x2b, 0x67, 0x22, 0xfc, 0xb6, 0x2a, 0x49, 0xaf,
+  0x85, 0x86, 0xcc, 0xbd, 0x02, 0x49, 0x8e, 0xe3, 0xfc, 0xe4, 0x17, 0xf1, 0x7e, 0xc8, 0xb2, 0x75,
+  0xd8, 0x45, 0xbc, 0x08, 0xdb, 0xee, 0x92, 0x7d, 0x5e, 0x3b, 0x75, 0xa7, 0x25, 0x02, 0x63, 0x2f,
+  0xf5, 0x6c, 0x8e, 0x1a, 0x79, 0xe0, 0x29, 0x51, 0xd6, 0xaa, 0x26, 0x35, 0xd1, 0x59, 0x2c, 0x87,
+  0xcc, 0x6c, 0xa7, 0x8a, 0x44, 0xd1, 0x45, 0x27, 0x33, 0x99, 0x15, 0xfe, 0xd4, 0x64, 0x5d, 0xc7,
+  0xf4, 0xea, 0xa0, 0xa5, 0x44, 0xd6, 0x38, 0xc8, 0xba, 0x42, 0xe2, 0x9c, 0xfe, 0x12, 0xfa, 0xe7,
+  0xe1, 0x9f, 0xa2, 0xc3, 0xf3, 0x7b, 0xa4, 0xb0, 0x3f, 0x04, 0xf0, 0x4d, 0x10, 0x87, 0x3a, 0xb2,
+  0x04, 0x1c, 0x78, 0x48, 0x1d, 0xaa, 0xf4, 0xae, 0xde, 0xb0, 0x9f, 0x2b, 0xa4, 0xd5, 0xbd, 0x7d,
+  0x18, 0x13, 0xbb, 0x7d, 0x50, 0xd6, 0x2c, 0x10, 0x09, 0x65, 0x13, 0x9b, 0xf6, 0xf6, 0x15, 0x3d,
+  0x03, 0xc8, 0xc4, 0x44, 0xf1, 0xe2, 0xf3, 0xaf, 0xfe, 0x21, 0xbb, 0x89, 0xf0, 0xf2, 0x4e, 0x8e,
+  0x5e, 0xbc, 0xcb, 0xfc, 0xc3, 0x57, 0xfd, 0x02, 0x52, 0xf6, 0x82, 0xd9, 0x03, 0xba, 0xf1, 0x9e,
+  0xfd, 0x24, 0xd4, 0x6b, 0x33, 0x4e, 0x56, 0x0c, 0x7e, 0x5d, 0x4f, 0xaa, 0xb2, 0xcd, 0xdc, 0x27,
+  0x12, 0x10, 0xbd, 0xb3, 0xc9, 0x62, 0xb2, 0xf6, 0x82, 0xa9, 0x91, 0xfd, 0x06, 0x82, 0xbb, 0x7f,
+  0x0a, 0x21, 0xa4, 0xb5, 0x91, 0x91, 0xf0, 0x29, 0x11, 0x98, 0xf2, 0x4e, 0xd5, 0x3f, 0x3d, 0x12,
+  0xec, 0xdb, 0x67, 0x7a, 0x63, 0xb5, 0x3f, 0x44, 0x9f, 0x28, 0xff, 0x77, 0x10, 0x71, 0x44, 0xa8,
+  0xe4, 0x4f, 0x7c, 0xf6, 0x1b, 0x8f, 0x6f, 0xe1, 0xbd, 0x97, 0xfd, 0x21, 0x3e, 0xda, 0xe3, 0xa0,
+  0x4f, 0xe9, 0xa5, 0x7e, 0xb6, 0x97, 0x25, 0xe2, 0xd8, 0x3b, 0xd7, 0x02, 0x7d, 0x6f, 0x99, 0x97,
+  0x60, 0x7b, 0x30, 0xe8, 0xac, 0x6e, 0x5c, 0xc0, 0xab, 0x39, 0xe8, 0x40, 0x75, 0x43, 0x5a, 0xea,
+  0xc6, 0xb3, 0xce, 0x02, 0xab, 0xa7, 0x56, 0x4f, 0x4c, 0x7a, 0xd8, 0x0e, 0xf4, 0xaa, 0xb4, 0x08,
+  0x16, 0x2c, 0x22, 0xa6, 0xed, 0x8d, 0x2a, 0x8c, 0xce, 0x2d, 0x5d, 0xca, 0xaa, 0x68, 0x2a, 0x68,
+  0x11, 0x2e, 0x9d, 0x47, 0xfd, 0xe4, 0x0c, 0xe2, 0x30, 0x5b, 0x03, 0x73, 0xa9, 0x6e, 0x4d, 0x6b,
+  0x90, 0x40, 0x52, 0x71, 0xaa, 0x06, 0x9a, 0xa1, 0x28, 0x5e, 0xc9, 0x23, 0x27, 0xba, 0x26, 0xad,
+  0x89, 0x1e, 0x5b, 0xeb, 0xaa, 0xb6, 0xe0, 0x03, 0x13, 0xf8, 0x6c, 0x05, 0x8f, 0xc0, 0x54, 0x39,
+  0x91, 0x5d, 0x02, 0x6c, 0x72, 0xa0, 0x1c, 0x6d, 0x16, 0xa8, 0x7b, 0x46, 0x36, 0x75, 0x0d, 0xab,
+  0xce, 0x75, 0x31, 0xc2, 0x26, 0xaf, 0xc0, 0xb3, 0x50, 0x5c, 0x9a, 0x60, 0xbd, 0xdd, 0x88, 0x9e,
+  0x39, 0x77, 0x80, 0x79, 0xb0, 0x6f, 0x81, 0xad, 0xd1, 0xd4, 0x9a, 0x53, 0x02, 0x1c, 0x82, 0xd6,
+  0x63, 0xe5, 0x90, 0xa0, 0x60, 0x6f, 0x9d, 0xee, 0xb5, 0x1f, 0xd8, 0x22, 0xd2, 0x9d, 0x0e, 0xeb,
+  0x73, 0x0b, 0x14, 0x59, 0x78, 0x70, 0xb5, 0x33, 0xc6, 0x04, 0x8d, 0x98, 0xfb, 0x35, 0xc5, 0xac,
+  0xbc, 0x5a, 0xd7, 0xd9, 0xa6, 0x72, 0x6b, 0xc2, 0x44, 0x3b, 0x80, 0xe6, 0x10, 0x4b, 0xf6, 0x03,
+  0x4c, 0x68, 0x00, 0xd7, 0x29, 0x46, 0x59, 0x8e, 0x32, 0xbd, 0x00, 0x20, 0x9c, 0x87, 0x41, 0xf7,
+  0xf6, 0x9f, 0x49, 0xc5, 0xf8, 0x22, 0x30, 0xd5, 0x8b, 0x79, 0x76, 0x4b, 0xeb, 0x4c, 0xec, 0x18,
+  0x9d, 0x03, 0x9d, 0x4a, 0x12, 0x6f, 0x4e, 0x0a, 0x4c, 0xc9, 0x9c, 0x00, 0x44, 0x20, 0xcc, 0x39,
+  0xd5, 0x59, 0x1c, 0x1d, 0x58, 0x16, 0x19, 0x63, 0x75, 0x55, 0xe9, 0xaf, 0x3b, 0x32, 0xb3, 0x87,
+  0xbe, 0xa7, 0x52, 0xa7, 0xfa, 0xe7, 0x4e, 0x76, 0xc0, 0x03, 0xdf, 0x8c, 0x54, 0x2b, 0xe7, 0x5e,
+  0xdf, 0x72, 0x7c, 0xbf, 0xaf, 0x35, 0x86, 0xbb, 0x2b, 0x76, 0xd6, 0xbc, 0x67, 0xb6, 0xfb, 0x7d,
+  0x7b, 0x3b, 0x93, 0x4f, 0xb4, 0x39, 0x5e, 0x4c, 0x13, 0x24, 0x16, 0x21, 0x9d, 0x7c, 0xb8, 0xda,
+  0x9c, 0xf6, 0xd0, 0x89, 0x75, 0xd8, 0xdf, 0xf0, 0x2f, 0x46, 0x96, 0xa9, 0xce, 0x4e, 0xcd, 0xb3,
+  0xd5, 0x3a, 0x07, 0x7e, 0xb3, 0xfb, 0xa3, 0xb0, 0x7f, 0xae, 0x58, 0xeb, 0x73, 0x87, 0x4f, 0xa3,
+  0xc5, 0x19, 0x6a, 0xe5, 0x9c, 0xb0, 0xd7, 0x24, 0x3c, 0x59, 0x3a, 0x46, 0x42, 0xc1, 0x49, 0x38,
+  0x37, 0x5e, 0xac, 0x45, 0xd5, 0xdd, 0x82, 0x8c, 0xcf, 0x4d, 0x5b, 0x54, 0x60, 0x70, 0xa2, 0xa8,
+  0x71, 0x31, 0x8e, 0xdd, 0x99, 0xd7, 0x40, 0x78, 0x7c, 0xb5, 0x8f, 0x3b, 0xfb, 0xf3, 0x24, 0x17,
+  0x80, 0xba, 0x51, 0x97, 0xad, 0xaf, 0x1c, 0xda, 0xe5, 0x24, 0xe2, 0x0f, 0x9d, 0xbf, 0x3a, 0xb8,
+  0xbd, 0x8f, 0x87, 0x4e, 0x29, 0x03, 0xd5, 0xd8, 0x3b, 0x2b, 0xc0, 0xcb, 0x81, 0x7f, 0x6c, 0x34,
+  0xef, 0xb8, 0x23, 0x35, 0xf1, 0x9c, 0xbf, 0x9d, 0x71, 0x55, 0xab, 0xa8, 0xcd, 0xfe, 0x05, 0x03,
+  0xa0, 0x3b, 0x47, 0xa7, 0x75, 0x47, 0x0d, 0x8d, 0xf1, 0x0f, 0x00, 0x2b, 0xf5, 0xe0, 0x7f, 0x06,
+  0x49, 0xf5, 0x51, 0x11, 0x90, 0x28, 0xc7, 0xe4, 0x68, 0x5d, 0xd1, 0xef, 0xe1, 0xdc, 0x33, 0x1c,
+  0x57, 0x82, 0x6f, 0x46, 0xa9, 0xf3, 0xe8, 0x91, 0xf7, 0x41, 0x79, 0xe8, 0x74, 0x08, 0xc6, 0x11,
+  0x9c, 0x84, 0x20, 0x44, 0x5a, 0x0d, 0xba, 0xd9, 0x81, 0xda, 0x33, 0x65, 0xc1, 0x5d, 0x65, 0xdc,
+  0x62, 0xda, 0xca, 0xe4, 0xfb, 0x19, 0x1a, 0xd5, 0xb4, 0x2e, 0xe3, 0x6e, 0xcc, 0x73, 0x5d, 0xb8,
+  0x08, 0x33, 0x7c, 0x4d, 0xd7, 0x43, 0xc4, 0x78, 0xe9, 0x82, 0x38, 0xa0, 0x67, 0x55, 0x1f, 0x1f,
+  0xd9, 0xcc, 0x58, 0x35, 0x3b, 0x95, 0x28, 0xd6, 0x25, 0xe2, 0x34, 0x95, 0xaf, 0xe7, 0x88, 0xd3,
+  0xfa, 0x13, 0x63, 0x9d, 0xd9, 0xd3, 0x89, 0xf4, 0x33, 0xa9, 0xb8, 0x43, 0x95, 0x59, 0x88, 0xe1,
+  0x9c, 0x5d, 0x78, 0x56, 0x2b, 0xa2, 0x03, 0xc7, 0xb6, 0x18, 0x7a, 0xef, 0x9c, 0x6a, 0xc1, 0x33,
+  0xce, 0xca, 0x40, 0x00, 0xae, 0x3f, 0x4f, 0xe6, 0x84, 0xb9, 0xfb, 0x65, 0x48, 0xf5, 0x9e, 0xd6,
+  0x7f, 0x21, 0xd0, 0x7d, 0x14, 0x90, 0xbc, 0x5f, 0x35, 0xfe, 0xbd, 0xf1, 0x3a, 0xb2, 0x57, 0x28,
+  0xfc, 0xfc, 0xf3, 0xcf, 0xbf, 0x01, 0x1b, 0x4b, 0x3c, 0xad, 0x69, 0x1a, 0x00, 0x00
+};
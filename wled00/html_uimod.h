@@ -0,0 +1,317 @@
+/*
+ * Binary arrays for the modules of the Web UI (/index_<m>.js).
+ * gzip is used for smaller size and improved speeds.
+ */
+
+// Autogenerated from wled00/data/index_pe.js, do not edit!!
+const uint16_t PAGE_index_pe_L = 3023;
+#define PAGE_index_pe_ETAG "680f1a8b"
+const uint8_t PAGE_index_pe[] PROGMEM = {
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xad, 0x5a, 0xff, 0x73, 0xda, 0x38,
+  0x16, 0xff, 0x39, 0xfe, 0x2b, 0xb4, 0x6a, 0xa6, 0xd8, 0x47, 0xe2, 0x18, 0x3a, 0xbd, 0xed, 0x02,
+  0x26, 0xb3, 0xdb, 0x66, 0xe6, 0xd8, 0xd9, 0xa5, 0x69, 0xd3, 0xde, 0xcc, 0x4d, 0x86, 0x19, 0x84,
+  0x2d, 0x40, 0x8d, 0x90, 0x15, 0x49, 0x40, 0x38, 0xea, 0xff, 0xfd, 0x46, 0x92, 0x6d, 0x64, 0x02,
+  0x4d, 0xb2, 0x7b, 0x3f, 0x94, 0x82, 0xf4, 0xa4, 0xf7, 0x79, 0x4f, 0xef, 0x9b, 0x9e, 0xb2, 0x42,
+  0x02, 0x70, 0xfa, 0xbb, 0xcc, 0x58, 0xbc, 0x85, 0x11, 0xec, 0x6c, 0x3d, 0xc8, 0x25, 0xec, 0xdc,
+  0x46, 0xa3, 0x33, 0x0f, 0xa6, 0x4b, 0x01, 0x3b, 0xb7, 0xad, 0xc8, 0xfc, 0x50, 0x02, 0x31, 0x49,
+  0x14, 0xc9, 0x18, 0xec, 0xdc, 0x9e, 0xb7, 0xf4, 0x90, 0xc0, 0x1c, 0x23, 0x05, 0x3b, 0x91, 0xfe,
+  0x0e, 0x3b, 0x53, 0x44, 0x25, 0x3e, 0xf3, 0x20, 0x66, 0x29, 0xec, 0x44, 0x5e, 0x9e, 0x77, 0xbd,
+  0xe9, 0x92, 0x25, 0x7a, 0x09, 0x58, 0xa0, 0x3b, 0x7c, 0x4d, 0x6f, 0x30, 0xf5, 0x09, 0x4b, 0xae,
+  0x69, 0x6c, 0x68, 0x83, 0xad, 0xb7, 0x32, 0xfc, 0x6f, 0x30, 0x7d, 0x9f, 0x31, 0x85, 0x99, 0x8a,
+  0x21, 0xec, 0x7a, 0x29, 0xa6, 0x58, 0x61, 0xc0, 0x35, 0xac, 0x5b, 0x18, 0xc1, 0x51, 0xd7, 0xd0,
+  0x21, 0x21, 0xe2, 0x8f, 0x93, 0x6f, 0x38, 0x51, 0x21, 0x66, 0x4a, 0x10, 0x2c, 0x7d, 0x43, 0x12,
+  0x74, 0xbd, 0x69, 0x26, 0x7c, 0x4d, 0x42, 0xe2, 0xa8, 0x4b, 0x7a, 0x48, 0x88, 0x90, 0x62, 0x36,
+  0x53, 0xf3, 0x2e, 0x69, 0x36, 0x0b, 0x2e, 0x2c, 0x46, 0x42, 0xdc, 0x92, 0xd1, 0x6d, 0x6b, 0x14,
+  0xb2, 0x4b, 0xe7, 0x7b, 0x07, 0x5e, 0x0b, 0x2c, 0xb1, 0x02, 0xb0, 0x59, 0x8c, 0x46, 0xa3, 0xae,
+  0x47, 0xa6, 0xfe, 0x4f, 0x06, 0xea, 0xeb, 0xd7, 0x3b, 0x5a, 0x4e, 0xd1, 0x86, 0x12, 0xa9, 0x0e,
+  0x8d, 0x85, 0x5c, 0x06, 0x49, 0xc6, 0x14, 0x61, 0x4b, 0xdc, 0xf5, 0x5c, 0x99, 0x9a, 0xf1, 0xb8,
+  0x97, 0x71, 0xa3, 0x86, 0x15, 0xa2, 0x4b, 0x1c, 0x9f, 0x6e, 0x2b, 0x46, 0x79, 0xff, 0x74, 0xcb,
+  0xf2, 0xde, 0x85, 0x9d, 0xef, 0x8f, 0xbd, 0xdc, 0x13, 0x58, 0x2d, 0x05, 0xab, 0x69, 0xa5, 0xeb,
+  0xe5, 0x3b, 0x55, 0x0a, 0x3c, 0x15, 0x58, 0xce, 0xaf, 0xe9, 0x95, 0xcf, 0x2b, 0x0d, 0x5e, 0x7d,
+  0x20, 0xab, 0x38, 0x0d, 0x67, 0x58, 0x5d, 0x51, 0xbc, 0xc0, 0x4c, 0xfd, 0xb6, 0x19, 0xa4, 0xfe,
+  0x98, 0x53, 0x7c, 0xba, 0xe5, 0xf9, 0x38, 0xb0, 0x02, 0x59, 0xba, 0xc0, 0x72, 0xb0, 0x4a, 0x4d,
+  0x1c, 0xbd, 0xd7, 0xb5, 0x68, 0xcd, 0xe2, 0x96, 0x8f, 0x42, 0x2e, 0xeb, 0xea, 0x4c, 0x4a, 0xb9,
+  0xec, 0xa9, 0x5e, 0x31, 0x25, 0x36, 0x3e, 0x3f, 0x23, 0x81, 0xc6, 0x69, 0x79, 0x84, 0x84, 0x31,
+  0x2c, 0xfe, 0xf5, 0xe5, 0xcf, 0x3f, 0xe2, 0xa4, 0x94, 0x41, 0x6f, 0x9d, 0x62, 0x2a, 0xe3, 0x82,
+  0x64, 0x07, 0x56, 0xfe, 0xb6, 0x79, 0x4f, 0x91, 0x94, 0x43, 0xb4, 0xc0, 0x3e, 0x9c, 0x28, 0x76,
+  0xce, 0xe9, 0x79, 0x8a, 0x29, 0xb4, 0xb8, 0xf5, 0xa2, 0x02, 0x41, 0xaf, 0x1d, 0xe8, 0x5f, 0xb7,
+  0xd1, 0x28, 0x94, 0x6a, 0x43, 0x71, 0x98, 0x12, 0xa9, 0x4f, 0x20, 0x86, 0x2c, 0x63, 0x18, 0x5a,
+  0x26, 0x52, 0x33, 0x79, 0xac, 0x0c, 0x89, 0x67, 0xa7, 0x5b, 0xde, 0x6c, 0x45, 0x51, 0x3e, 0x0e,
+  0x8e, 0x72, 0x97, 0x96, 0x6d, 0xa5, 0x0b, 0x90, 0x4d, 0xcd, 0x86, 0xc1, 0x56, 0x43, 0x21, 0x61,
+  0x8a, 0x14, 0x92, 0x58, 0x85, 0x2b, 0x44, 0xed, 0x10, 0x47, 0x42, 0xe2, 0x01, 0x53, 0x7b, 0x73,
+  0xfd, 0x28, 0x20, 0xa1, 0x3d, 0xef, 0xda, 0x44, 0xd7, 0xc3, 0x54, 0x62, 0xe0, 0x6a, 0xf7, 0x76,
+  0x47, 0x40, 0x58, 0x8a, 0x1f, 0x46, 0xb1, 0xb3, 0xa7, 0xd9, 0xc2, 0x68, 0x36, 0x77, 0xad, 0x00,
+  0xa5, 0xe9, 0x35, 0x35, 0x4a, 0xdf, 0x7a, 0xb5, 0x93, 0x92, 0x9c, 0x92, 0x04, 0xfb, 0xa4, 0xd9,
+  0x3a, 0x8b, 0xce, 0xa2, 0xa0, 0xeb, 0xcc, 0xa6, 0x4b, 0x51, 0x9f, 0xae, 0x4d, 0xdd, 0x92, 0x51,
+  0x8d, 0x7a, 0xe7, 0xf0, 0xc7, 0x16, 0xed, 0x28, 0xec, 0xda, 0x9a, 0x65, 0xd6, 0x6c, 0x36, 0xc5,
+  0xb4, 0x42, 0xab, 0x55, 0xf6, 0xd8, 0xb4, 0x7a, 0xed, 0xca, 0x2c, 0x0f, 0x8a, 0x73, 0xd6, 0x3a,
+  0x2a, 0xca, 0xde, 0xd4, 0x01, 0xdc, 0x86, 0xe2, 0x38, 0x3a, 0x4e, 0xf1, 0xb5, 0xd4, 0xe8, 0xce,
+  0xa6, 0x04, 0xd3, 0x74, 0x4f, 0xa3, 0xb7, 0xc4, 0x39, 0x0f, 0x43, 0xe0, 0x9c, 0x89, 0xbb, 0xc7,
+  0x87, 0xa5, 0xa8, 0x6d, 0x42, 0xa6, 0x3b, 0x72, 0x92, 0x12, 0xb5, 0xb1, 0x5f, 0x02, 0x6f, 0x5f,
+  0xed, 0xf1, 0x9f, 0x48, 0xcd, 0xc3, 0x29, 0xcd, 0x32, 0xe1, 0x32, 0xf8, 0x47, 0x2b, 0x7a, 0xc4,
+  0xe3, 0xcb, 0x8b, 0x59, 0xd4, 0x0e, 0xe9, 0xf9, 0x9c, 0x3e, 0x3b, 0xc1, 0x25, 0xae, 0x76, 0xd3,
+  0x7a, 0x0e, 0xc5, 0xc1, 0x40, 0xa3, 0xe3, 0x8c, 0x50, 0x33, 0x3a, 0x0e, 0xc2, 0x64, 0x8e, 0x93,
+  0x3b, 0x9c, 0x5a, 0xdf, 0x3d, 0x46, 0xca, 0x6b, 0xb4, 0x46, 0xe7, 0xa1, 0x4d, 0x28, 0x71, 0xb4,
+  0x4b, 0x01, 0x34, 0xc4, 0x2c, 0xed, 0x7a, 0xc7, 0x76, 0xc9, 0x5a, 0xe3, 0xe0, 0x48, 0x20, 0xc8,
+  0xb5, 0x9b, 0xb9, 0xbb, 0x56, 0x67, 0x78, 0x1c, 0xd2, 0x38, 0xa8, 0x8e, 0xd6, 0x72, 0x7e, 0x7a,
+  0x91, 0xc4, 0xf4, 0x8a, 0xa5, 0xce, 0xc2, 0x97, 0x40, 0x9d, 0xd0, 0x2c, 0xb9, 0x83, 0xdd, 0xba,
+  0x67, 0x9b, 0xa0, 0xea, 0x93, 0x33, 0x4e, 0x8b, 0x03, 0x70, 0x43, 0xb4, 0x71, 0x9e, 0x62, 0x5c,
+  0x60, 0x5e, 0x9e, 0x0c, 0x19, 0x15, 0x52, 0x5e, 0xee, 0x0f, 0x74, 0xa2, 0x6e, 0x19, 0xaf, 0xe3,
+  0xb1, 0x07, 0x40, 0x2f, 0x25, 0x2b, 0x90, 0xe8, 0x70, 0x17, 0xc3, 0x29, 0x11, 0x52, 0x81, 0x04,
+  0xf6, 0xaf, 0x8b, 0x1c, 0x06, 0xae, 0x6c, 0x5e, 0xed, 0x5d, 0xa4, 0x64, 0xd5, 0xf7, 0x0c, 0x2d,
+  0x49, 0x63, 0x68, 0xd2, 0x08, 0xc9, 0x61, 0xdf, 0x4e, 0xf4, 0x28, 0x9a, 0x60, 0x5a, 0xee, 0x62,
+  0x4e, 0x10, 0x08, 0xbc, 0x4a, 0xe6, 0x77, 0x14, 0xf6, 0x3d, 0x00, 0x00, 0xb8, 0x99, 0x2f, 0xa7,
+  0x53, 0x8a, 0xbd, 0x1e, 0x61, 0x7c, 0xa9, 0x80, 0xda, 0x70, 0x5c, 0x10, 0x4e, 0xb2, 0x07, 0x58,
+  0xec, 0xa9, 0xb7, 0xd4, 0x16, 0x03, 0x41, 0xc6, 0x92, 0x39, 0x62, 0x33, 0xac, 0x47, 0x3f, 0xfb,
+  0x7a, 0x3c, 0x80, 0xe0, 0x74, 0xeb, 0xc8, 0x72, 0x09, 0x0b, 0x43, 0x81, 0x1d, 0x08, 0x73, 0xcb,
+  0xa4, 0x27, 0x39, 0x62, 0x35, 0x14, 0x0b, 0x24, 0xee, 0x80, 0x4c, 0xe6, 0x77, 0x1a, 0xa9, 0x9e,
+  0xd5, 0x84, 0xbd, 0x0b, 0x03, 0xd7, 0x7c, 0x7d, 0x12, 0xf8, 0x67, 0xa3, 0x34, 0xa0, 0xc3, 0xf0,
+  0x94, 0x30, 0xa2, 0x30, 0xdd, 0x3c, 0x43, 0x08, 0xfe, 0x23, 0x29, 0x04, 0xe6, 0x97, 0x10, 0x76,
+  0x2a, 0x01, 0xfe, 0x22, 0x7a, 0xe7, 0x30, 0xf4, 0xd6, 0x59, 0x0b, 0x02, 0x63, 0x4d, 0x31, 0x2c,
+  0xcc, 0xa9, 0x53, 0xb0, 0xb2, 0x46, 0xd5, 0xb1, 0x7e, 0x90, 0xc3, 0x62, 0x65, 0xc9, 0x08, 0xf6,
+  0x0b, 0x11, 0x0b, 0xa9, 0x8a, 0x71, 0x96, 0x49, 0x4a, 0x52, 0x0c, 0x0b, 0x29, 0xd9, 0x72, 0x31,
+  0xc1, 0xa2, 0x2e, 0xa3, 0x16, 0xd0, 0xac, 0xa9, 0xc9, 0xb7, 0x40, 0x0f, 0x71, 0xab, 0xfd, 0x33,
+  0x58, 0x10, 0x16, 0x47, 0x55, 0x7d, 0x23, 0x30, 0xef, 0x47, 0x97, 0x02, 0xf3, 0x4e, 0x2b, 0xef,
+  0x03, 0x45, 0x16, 0x95, 0x4d, 0x01, 0x70, 0xc5, 0x52, 0xc0, 0x4d, 0xc5, 0xd5, 0xe9, 0x4d, 0x44,
+  0xdf, 0xeb, 0x49, 0x4c, 0x71, 0x52, 0x21, 0x99, 0x28, 0xa6, 0xf3, 0xad, 0xfe, 0x77, 0xce, 0x29,
+  0x76, 0x31, 0x58, 0x5f, 0x3b, 0xa2, 0x68, 0x9d, 0x41, 0xcf, 0x57, 0x88, 0xc6, 0xae, 0xdd, 0x60,
+  0x96, 0x5e, 0xd6, 0x7e, 0x75, 0xa2, 0xbc, 0xef, 0x9d, 0x9c, 0xd4, 0xeb, 0xb1, 0xa8, 0x3f, 0xcc,
+  0x18, 0xae, 0x8a, 0x30, 0xef, 0x74, 0xbb, 0x2b, 0x57, 0x95, 0x58, 0xe2, 0x20, 0x37, 0x07, 0x61,
+  0x71, 0xf6, 0xbd, 0x93, 0xd2, 0x3d, 0x26, 0x4b, 0xa5, 0x32, 0xe6, 0x02, 0xd7, 0xa5, 0x0b, 0x31,
+  0x9f, 0x46, 0x5d, 0x09, 0x25, 0xc9, 0x5d, 0x0c, 0x15, 0x96, 0xea, 0x9a, 0x1a, 0xa0, 0x67, 0x40,
+  0xcd, 0x89, 0x0c, 0x60, 0xbf, 0x47, 0x8a, 0x75, 0x0d, 0x92, 0x64, 0x4c, 0xda, 0x95, 0x49, 0xc6,
+  0x1a, 0xfd, 0xd7, 0xaf, 0x1e, 0x70, 0xeb, 0xcd, 0x2f, 0xdd, 0xde, 0x05, 0xe9, 0x7f, 0xc1, 0x52,
+  0xf5, 0x2e, 0x2c, 0x9f, 0xfe, 0x58, 0x07, 0x0a, 0x53, 0x3c, 0x54, 0x0e, 0xfd, 0x63, 0x83, 0x3e,
+  0x39, 0x19, 0xb0, 0x84, 0x2e, 0x53, 0x0c, 0x26, 0x82, 0xcc, 0xe6, 0x8a, 0x61, 0x29, 0x7f, 0x68,
+  0xcd, 0x1a, 0x21, 0x99, 0x18, 0x63, 0x2e, 0xac, 0xd5, 0x28, 0xeb, 0x39, 0x96, 0x7a, 0x52, 0x19,
+  0xea, 0xc9, 0x53, 0xa0, 0x6e, 0xd0, 0x0a, 0x03, 0x89, 0x67, 0x3a, 0x42, 0x82, 0x49, 0xb6, 0x64,
+  0xe9, 0xd3, 0xa8, 0xe4, 0x5f, 0x43, 0x55, 0x82, 0x1a, 0x77, 0x8b, 0xb2, 0x7a, 0x5c, 0xe7, 0xa4,
+  0xf0, 0x83, 0x82, 0xe5, 0x26, 0x5c, 0x3d, 0x28, 0x50, 0x39, 0x42, 0xc5, 0x5a, 0x69, 0x12, 0xb4,
+  0x54, 0x59, 0x92, 0x2d, 0xb8, 0xce, 0x4a, 0x31, 0xcc, 0xa6, 0x53, 0x63, 0xf9, 0xb6, 0x74, 0x89,
+  0xdf, 0xb4, 0x0b, 0x43, 0x82, 0xa7, 0x5b, 0x9f, 0xf4, 0xa3, 0xe0, 0x92, 0x9b, 0x5a, 0x92, 0x04,
+  0x3a, 0x58, 0x41, 0xc0, 0x29, 0x4a, 0xf0, 0x3c, 0xa3, 0x29, 0x16, 0x31, 0xbc, 0x62, 0x0a, 0x0b,
+  0xc0, 0xd0, 0x02, 0x87, 0x61, 0x08, 0x2f, 0xfa, 0xd6, 0x07, 0xea, 0x2e, 0xfa, 0x69, 0x49, 0x92,
+  0x3b, 0x40, 0x33, 0x94, 0x02, 0x83, 0xbf, 0x03, 0x8e, 0xa3, 0xbe, 0xa7, 0x35, 0xd8, 0x3b, 0x54,
+  0x0e, 0xa8, 0x7b, 0x5a, 0xe0, 0xc9, 0x1d, 0xb9, 0xee, 0xe9, 0x21, 0xb1, 0x2e, 0x8a, 0x18, 0xef,
+  0x9d, 0xb8, 0x98, 0xe6, 0xb0, 0xef, 0x53, 0xac, 0xcf, 0x0d, 0x2f, 0xb8, 0xda, 0x80, 0x69, 0x26,
+  0x00, 0xcb, 0x80, 0x83, 0xd3, 0xda, 0x68, 0xe0, 0x66, 0x0e, 0xed, 0x88, 0xaf, 0x5f, 0x93, 0x38,
+  0x8e, 0x2e, 0xa1, 0x0d, 0x55, 0x8d, 0x32, 0x54, 0xe9, 0xd8, 0xd4, 0x28, 0x42, 0xf9, 0x13, 0xf6,
+  0xa2, 0x77, 0xb9, 0x84, 0x37, 0xf3, 0x6c, 0x0d, 0xca, 0xab, 0x16, 0xc0, 0x29, 0x51, 0x99, 0x80,
+  0x1d, 0xab, 0x6c, 0xf8, 0x71, 0x85, 0xc5, 0x5a, 0x10, 0x85, 0xc1, 0x9a, 0xa8, 0x39, 0x90, 0x0a,
+  0x29, 0x0c, 0x3b, 0xf0, 0xab, 0xf6, 0x94, 0xa5, 0x10, 0xda, 0xcc, 0xec, 0x58, 0xfe, 0xa4, 0x9d,
+  0x25, 0x72, 0x2f, 0x94, 0xab, 0x19, 0x7d, 0x2f, 0x77, 0xc1, 0xdc, 0xd7, 0xe2, 0x7c, 0xff, 0xce,
+  0x69, 0xf0, 0x7f, 0xc8, 0x48, 0xe6, 0xe8, 0x4f, 0x5c, 0x95, 0x95, 0x96, 0x98, 0xb5, 0x1d, 0x4c,
+  0x59, 0xbb, 0x48, 0x4e, 0xbf, 0x5e, 0x0f, 0x40, 0x92, 0x2d, 0x16, 0x88, 0xa5, 0xd6, 0x6a, 0xb4,
+  0x21, 0x20, 0x81, 0xd1, 0xa3, 0x28, 0x5e, 0xad, 0x45, 0x9c, 0x68, 0xce, 0x25, 0xa1, 0xe5, 0x7e,
+  0x80, 0x5f, 0xcb, 0xe5, 0xd7, 0x32, 0x6a, 0x2f, 0x82, 0x4c, 0x7e, 0x78, 0x49, 0x02, 0xfb, 0xc6,
+  0x8f, 0x55, 0x06, 0x06, 0x1f, 0x8e, 0x25, 0x93, 0x5d, 0x50, 0x49, 0xf7, 0x33, 0x4b, 0x95, 0x4b,
+  0x8c, 0x9a, 0xbe, 0x4a, 0x9c, 0xba, 0x19, 0xa5, 0xfd, 0x36, 0x32, 0x19, 0xa5, 0x55, 0x65, 0x14,
+  0x7b, 0xd4, 0xa4, 0x33, 0xc3, 0xea, 0x8f, 0x6c, 0x8d, 0xa5, 0xfa, 0xca, 0x96, 0x12, 0xa7, 0xd7,
+  0x7e, 0x90, 0x1f, 0xb4, 0xd8, 0x04, 0xbe, 0x20, 0x40, 0x4b, 0xb4, 0xc2, 0xd7, 0x36, 0x3e, 0x6b,
+  0x73, 0xcb, 0xdd, 0xf8, 0x0c, 0xeb, 0xf1, 0x19, 0x9a, 0xf8, 0xfc, 0xe6, 0x97, 0xc8, 0xc4, 0x67,
+  0xa3, 0x82, 0xd3, 0xad, 0x6f, 0xec, 0xa1, 0x34, 0xcf, 0xca, 0x2e, 0xad, 0x0d, 0x49, 0xd8, 0x81,
+  0x36, 0xdf, 0xc1, 0xbc, 0x8a, 0xe5, 0x5e, 0x29, 0x51, 0xe3, 0x29, 0x90, 0x46, 0x87, 0x8d, 0x26,
+  0x69, 0x36, 0xf4, 0x85, 0x78, 0x87, 0x59, 0x5f, 0xa9, 0x7c, 0x33, 0xfe, 0x24, 0xda, 0xe8, 0xcd,
+  0xcf, 0x06, 0xed, 0x07, 0x5b, 0x54, 0x37, 0x9a, 0xbe, 0x76, 0xa9, 0x1d, 0xdc, 0x12, 0x5e, 0xd0,
+  0xf1, 0x8e, 0xc1, 0x71, 0xb5, 0x65, 0x88, 0xaf, 0xbf, 0x2a, 0x42, 0xfd, 0x00, 0xf6, 0xdf, 0x23,
+  0x96, 0x60, 0xda, 0x70, 0x44, 0x3b, 0x68, 0xd1, 0x6b, 0x24, 0x18, 0x28, 0x85, 0x86, 0x13, 0x6e,
+  0xbc, 0x06, 0x24, 0x8e, 0x8d, 0x68, 0x0a, 0xd8, 0xf7, 0xaa, 0xe5, 0x25, 0xb1, 0xdf, 0xd8, 0x8b,
+  0x44, 0x83, 0x0f, 0xc0, 0xc8, 0x6d, 0xe9, 0x1a, 0x26, 0xc8, 0x8e, 0xbb, 0x8f, 0x4a, 0x68, 0x0b,
+  0x70, 0xfb, 0xb8, 0x20, 0x6f, 0xf0, 0xa5, 0x22, 0xb4, 0x11, 0x38, 0x3d, 0x8a, 0xb1, 0xcb, 0x42,
+  0xe2, 0x99, 0x29, 0x50, 0x4c, 0xb2, 0xda, 0x9b, 0xd0, 0x71, 0x1b, 0x30, 0xbc, 0x96, 0x78, 0x66,
+  0xa6, 0x4f, 0x86, 0x78, 0x5d, 0x54, 0x33, 0xa5, 0x15, 0xee, 0x2f, 0x21, 0x0c, 0xe0, 0x07, 0x8e,
+  0x58, 0x8a, 0x53, 0x58, 0xd5, 0x16, 0x7e, 0x14, 0xe4, 0x45, 0x31, 0x6d, 0x3e, 0x0f, 0xe0, 0x77,
+  0xfa, 0x2a, 0xdb, 0x2a, 0x7b, 0xd5, 0x0b, 0x78, 0x4e, 0x75, 0x23, 0x6c, 0x03, 0x9f, 0x28, 0xa2,
+  0xea, 0x15, 0x93, 0xbe, 0xeb, 0xea, 0x0b, 0xc9, 0x99, 0xb1, 0x77, 0x5b, 0x8e, 0x1c, 0xa8, 0x9e,
+  0xca, 0xbb, 0x6f, 0x6e, 0xe7, 0x4c, 0x63, 0x22, 0xd6, 0x4b, 0xea, 0xf5, 0x91, 0xa9, 0x8d, 0xdc,
+  0xea, 0xe8, 0x87, 0xf6, 0xfc, 0x60, 0x4d, 0xb3, 0xe8, 0xee, 0xd4, 0x8d, 0x99, 0xee, 0x50, 0x3d,
+  0xdb, 0xa2, 0x77, 0x46, 0x57, 0xb3, 0x11, 0xc0, 0x29, 0xa3, 0xb0, 0xff, 0x61, 0x29, 0x90, 0xd6,
+  0x67, 0xa1, 0xe8, 0x03, 0x14, 0x5f, 0xaa, 0xcb, 0xf1, 0x61, 0x1a, 0x02, 0xfb, 0xaf, 0x4e, 0xb7,
+  0xa4, 0xd9, 0x2a, 0x0f, 0xcb, 0x84, 0xdd, 0x43, 0xc1, 0x4e, 0x6f, 0xb8, 0x1f, 0xe3, 0x74, 0x24,
+  0xfb, 0xe7, 0xdb, 0xb7, 0x6f, 0x42, 0x1b, 0xcc, 0xa2, 0xb0, 0x0d, 0xa4, 0xc2, 0x3c, 0x8e, 0xc2,
+  0x96, 0x5b, 0x4b, 0x9b, 0xc6, 0xc1, 0xa3, 0x13, 0x29, 0x03, 0xdf, 0x7e, 0xb3, 0xe0, 0xa2, 0x15,
+  0x85, 0xba, 0x88, 0x7d, 0x21, 0x8a, 0x0a, 0x43, 0x74, 0x18, 0xc3, 0x97, 0x67, 0x41, 0xa8, 0x35,
+  0x13, 0x0a, 0x24, 0x40, 0x3e, 0xf7, 0xcc, 0x51, 0x9a, 0x3a, 0x67, 0x6e, 0x3b, 0x58, 0xcf, 0x3f,
+  0xf3, 0xd6, 0x3b, 0xb4, 0x77, 0xe6, 0xc6, 0xf0, 0xdc, 0x13, 0x13, 0xff, 0x2d, 0xaf, 0xa8, 0xde,
+  0x71, 0xb7, 0x2a, 0xe3, 0x82, 0xbe, 0x4a, 0x0f, 0x97, 0x8b, 0x5e, 0x3b, 0xd8, 0x7a, 0x72, 0x9e,
+  0xad, 0xbf, 0x64, 0x48, 0x2a, 0x1f, 0xfe, 0x27, 0x5b, 0x02, 0x86, 0x71, 0x0a, 0x90, 0x02, 0x14,
+  0x23, 0xa9, 0x40, 0xbb, 0x70, 0x70, 0xa9, 0x93, 0x9d, 0xde, 0x03, 0xa0, 0xaa, 0x14, 0xf9, 0x09,
+  0x06, 0xdd, 0xb2, 0x6f, 0x95, 0x3b, 0xad, 0xad, 0xa8, 0xa6, 0xab, 0x68, 0xd4, 0x8b, 0x82, 0x23,
+  0x33, 0xb1, 0x12, 0xdd, 0xbf, 0x15, 0xa3, 0xea, 0x3a, 0x78, 0x14, 0xa3, 0xb4, 0x92, 0x4c, 0x90,
+  0x2a, 0x10, 0x57, 0xf7, 0xb0, 0x1f, 0x84, 0x29, 0x13, 0x94, 0x25, 0x9e, 0xb5, 0xa2, 0xc8, 0x0d,
+  0x59, 0x67, 0xf6, 0x32, 0xb4, 0x17, 0xb7, 0x9c, 0xbe, 0xda, 0x5e, 0x17, 0xc9, 0xd6, 0x4e, 0xa4,
+  0xec, 0x23, 0xc9, 0x43, 0x4d, 0xd9, 0x5d, 0xd5, 0xe5, 0x36, 0x8e, 0x8e, 0xd0, 0x1d, 0xe8, 0xa1,
+  0x70, 0x29, 0xf7, 0xae, 0xbc, 0xc7, 0x57, 0xb7, 0x1f, 0xad, 0xfe, 0xe9, 0xd0, 0x72, 0x47, 0x02,
+  0x5b, 0x18, 0x14, 0xbd, 0x18, 0x3e, 0xf8, 0x61, 0x3b, 0xc8, 0xd6, 0x39, 0x4e, 0x27, 0xc8, 0x74,
+  0xdc, 0x07, 0xdf, 0xbf, 0xf3, 0x41, 0xaf, 0x15, 0xf0, 0x41, 0x7c, 0xbc, 0x84, 0xe9, 0x7a, 0x7c,
+  0x78, 0x4c, 0x37, 0xea, 0x41, 0x95, 0x7b, 0xda, 0xf6, 0xcf, 0x30, 0x8e, 0x21, 0x0c, 0xf8, 0x30,
+  0x36, 0x59, 0xbc, 0x6a, 0xdd, 0xc0, 0xdd, 0x3b, 0x46, 0xd0, 0xe4, 0x03, 0xdb, 0x09, 0xcf, 0x26,
+  0xdf, 0xe2, 0x6d, 0x6e, 0xa1, 0x3c, 0x4f, 0xf7, 0x65, 0x6f, 0x09, 0xad, 0x8f, 0x01, 0x42, 0x9c,
+  0xec, 0x00, 0x29, 0xb1, 0xd9, 0x7a, 0x9a, 0xcb, 0xef, 0x37, 0x1f, 0x87, 0xa1, 0x51, 0x8f, 0x2f,
+  0xd0, 0x5a, 0xdb, 0x41, 0x82, 0x54, 0x32, 0xf7, 0xf5, 0x23, 0x4f, 0x36, 0xf9, 0x16, 0xae, 0x09,
+  0x8b, 0x05, 0x5a, 0x1b, 0x28, 0x02, 0xad, 0x77, 0x5d, 0xdf, 0xed, 0xb1, 0xe3, 0xd2, 0xf5, 0xc0,
+  0xd8, 0x75, 0x00, 0xf8, 0xfa, 0xd5, 0x2f, 0xef, 0xde, 0xbd, 0xeb, 0x82, 0x6b, 0xed, 0x97, 0x18,
+  0x60, 0x73, 0x93, 0xda, 0x64, 0x4b, 0xe1, 0x56, 0xc6, 0xc0, 0x74, 0xb5, 0x60, 0x79, 0xe1, 0x2b,
+  0x1a, 0x81, 0xa0, 0x60, 0x6b, 0xd2, 0xd8, 0xc7, 0xa9, 0xdf, 0xd8, 0x36, 0x82, 0xfe, 0x79, 0xeb,
+  0xaf, 0x70, 0xbf, 0xd9, 0x30, 0x85, 0x1e, 0x00, 0x16, 0x22, 0x13, 0x80, 0x30, 0x90, 0x2c, 0xa5,
+  0xca, 0x16, 0x40, 0x2b, 0xc0, 0xc5, 0xf1, 0x14, 0x02, 0x68, 0xa5, 0x80, 0x41, 0x1c, 0x47, 0x7f,
+  0x43, 0x09, 0x85, 0xf7, 0x01, 0x35, 0xc7, 0x80, 0xa3, 0x19, 0x06, 0x13, 0x3c, 0xcd, 0x04, 0x06,
+  0x8b, 0x2c, 0x25, 0xd3, 0x0d, 0x61, 0x33, 0xd3, 0x70, 0x28, 0x22, 0x98, 0x8b, 0xc9, 0xcb, 0xcd,
+  0xb9, 0x64, 0xb1, 0x76, 0xea, 0xaa, 0x5d, 0x5a, 0xf6, 0x17, 0xf5, 0x54, 0x19, 0x31, 0x76, 0x4d,
+  0xc6, 0xae, 0x5d, 0xc2, 0x8a, 0x35, 0x07, 0xd6, 0xeb, 0x21, 0x32, 0x39, 0x66, 0x3a, 0xa6, 0xb7,
+  0xe0, 0xfa, 0xb9, 0x26, 0x97, 0x47, 0xc9, 0xe5, 0x3e, 0x79, 0x09, 0x9a, 0x6b, 0xbf, 0x8c, 0xf9,
+  0xa0, 0xab, 0x7f, 0xb0, 0x98, 0x0f, 0xad, 0xb5, 0xf3, 0x4f, 0x47, 0xbd, 0xe8, 0x9e, 0xd6, 0x9d,
+  0xe8, 0xd3, 0xb0, 0xb0, 0xc0, 0x7e, 0x14, 0xe8, 0x4d, 0xee, 0x69, 0xcc, 0x3f, 0x0d, 0xbb, 0x6e,
+  0x22, 0xb8, 0x41, 0x2b, 0xad, 0x3e, 0xd8, 0xe4, 0xc3, 0x26, 0x04, 0x3e, 0x6c, 0xf2, 0x41, 0x13,
+  0x06, 0xd0, 0xbc, 0x24, 0xdc, 0x2f, 0xb1, 0x54, 0x5a, 0x29, 0x7e, 0x36, 0xf9, 0x66, 0x5d, 0xdd,
+  0x28, 0x43, 0x47, 0x09, 0x9b, 0x2b, 0x07, 0xa3, 0x38, 0x9b, 0x7c, 0xdb, 0x7b, 0xcb, 0xe4, 0x83,
+  0x91, 0xc5, 0x7e, 0x60, 0x3c, 0x3b, 0x30, 0xb6, 0x3a, 0x30, 0xa6, 0x9b, 0x69, 0xbb, 0xee, 0x76,
+  0xc5, 0x6c, 0x0b, 0x19, 0xec, 0xf0, 0xe1, 0x19, 0x5c, 0x13, 0xa6, 0x43, 0xc1, 0x11, 0xeb, 0x50,
+  0x19, 0x90, 0x18, 0x5b, 0x9b, 0x60, 0x78, 0x4d, 0x37, 0x26, 0xc4, 0xa5, 0xa5, 0xd1, 0x86, 0x30,
+  0xaf, 0x84, 0x59, 0x13, 0x16, 0xec, 0xd8, 0x6a, 0xff, 0x2d, 0x46, 0x2b, 0x8a, 0x7b, 0xea, 0x10,
+  0xdc, 0xd3, 0xd8, 0x8e, 0x99, 0x47, 0xc0, 0x8c, 0x2f, 0x29, 0x52, 0xd8, 0x46, 0x24, 0xe9, 0x1b,
+  0xa5, 0xed, 0x6e, 0x0d, 0xf5, 0x2c, 0x61, 0xbb, 0x63, 0xe4, 0x6c, 0xa2, 0x6c, 0x56, 0x9e, 0xa8,
+  0xea, 0x39, 0x4c, 0xcf, 0xc5, 0xb1, 0x76, 0xd3, 0xfd, 0xc1, 0xa8, 0xab, 0x87, 0x1c, 0xbf, 0x78,
+  0x7e, 0x43, 0x0d, 0x76, 0x3d, 0xa9, 0x32, 0x7e, 0x4d, 0x2d, 0xac, 0xd2, 0x1f, 0xf6, 0x39, 0xb4,
+  0x5e, 0xc6, 0xe1, 0xcd, 0xbb, 0xa9, 0xbd, 0x12, 0xaa, 0x8c, 0xc3, 0x7a, 0xf4, 0x7d, 0x96, 0x33,
+  0x3d, 0x36, 0x2a, 0x37, 0x0f, 0x15, 0x78, 0xb7, 0x35, 0xb2, 0x6d, 0xb9, 0x69, 0x67, 0x9b, 0xe7,
+  0xc1, 0xfe, 0x7b, 0x5b, 0x95, 0x78, 0x27, 0xea, 0x98, 0x57, 0xa4, 0x98, 0x16, 0x4f, 0xc3, 0x8e,
+  0xf0, 0x09, 0x9b, 0x5a, 0x95, 0x57, 0x22, 0x40, 0xae, 0xab, 0xf5, 0x0e, 0xc9, 0x0f, 0xa1, 0xac,
+  0x19, 0xa8, 0x96, 0xea, 0xc0, 0xd9, 0x17, 0xd6, 0x3a, 0x51, 0x45, 0xfa, 0x4d, 0x32, 0x9a, 0x89,
+  0x18, 0xbe, 0x9a, 0x46, 0x11, 0x7c, 0x99, 0x96, 0xcb, 0xc2, 0xff, 0x7d, 0xc6, 0xa6, 0x44, 0x2c,
+  0x80, 0xe5, 0x6e, 0x37, 0x71, 0x05, 0x68, 0xed, 0x3d, 0xaa, 0x4c, 0x33, 0xb1, 0x40, 0xea, 0x57,
+  0x21, 0x76, 0xcf, 0x27, 0xfa, 0x59, 0xcb, 0x79, 0xda, 0x36, 0x39, 0xf2, 0x57, 0x21, 0xd0, 0x26,
+  0x24, 0xd2, 0xfc, 0xef, 0x73, 0xaa, 0x6b, 0xee, 0xa0, 0xa0, 0x5f, 0xc5, 0xf6, 0xb7, 0xa1, 0x24,
+  0x72, 0x88, 0x86, 0xfe, 0x2a, 0x08, 0x56, 0x71, 0x2b, 0x8a, 0xcc, 0x73, 0x51, 0xba, 0x14, 0xf1,
+  0xed, 0x6a, 0xa4, 0x19, 0x9b, 0xed, 0xdb, 0x05, 0xbd, 0xcb, 0x80, 0xb6, 0x7b, 0x34, 0xf0, 0xb6,
+  0x7b, 0x2f, 0xed, 0xf4, 0x9c, 0xb6, 0xcd, 0xd3, 0x7a, 0xb1, 0x4d, 0xc8, 0x97, 0x72, 0x5e, 0x70,
+  0xbf, 0xa5, 0xed, 0xf3, 0xd6, 0x28, 0x28, 0xaa, 0xcb, 0xc7, 0x00, 0x77, 0xb5, 0x64, 0x0d, 0xe7,
+  0x6e, 0x78, 0x1f, 0xae, 0x2e, 0x37, 0x6b, 0x04, 0x8f, 0x41, 0x3b, 0x2f, 0xa8, 0x2f, 0xc3, 0xee,
+  0x2c, 0x2c, 0x45, 0x70, 0x6a, 0xdd, 0x9d, 0x24, 0xce, 0xc1, 0xe8, 0x56, 0x9e, 0xa9, 0xb0, 0xf4,
+  0xd6, 0x06, 0x69, 0x59, 0xd1, 0xf8, 0x3c, 0x70, 0x5f, 0x62, 0x63, 0x5e, 0x5d, 0x4b, 0x0b, 0x02,
+  0xf3, 0x48, 0x5f, 0x9d, 0x6a, 0x31, 0x1b, 0x38, 0xf2, 0xee, 0xee, 0x2d, 0xf6, 0x2d, 0x2c, 0x08,
+  0xf6, 0x47, 0x74, 0x18, 0xb1, 0x7f, 0x18, 0x51, 0x8d, 0xbb, 0x34, 0xf6, 0xcf, 0x54, 0x0e, 0xee,
+  0x88, 0x59, 0xea, 0x6e, 0xa7, 0xdf, 0x0a, 0xa3, 0x43, 0x75, 0xbc, 0xc4, 0xb3, 0x46, 0x93, 0xb8,
+  0x19, 0xdc, 0x16, 0xd3, 0xdc, 0x16, 0xd3, 0x8f, 0x9f, 0xa5, 0xad, 0xab, 0xbc, 0x60, 0xa3, 0xa0,
+  0x3c, 0x3c, 0x8e, 0x38, 0x89, 0xf5, 0xc7, 0xbf, 0x11, 0x35, 0xc3, 0x07, 0xbd, 0x9e, 0xbb, 0x05,
+  0x9c, 0x21, 0xb7, 0x19, 0x11, 0x71, 0x72, 0xb8, 0x36, 0x39, 0xb2, 0xcb, 0x5e, 0xdd, 0x58, 0x44,
+  0x31, 0x5b, 0xf2, 0x5b, 0x4c, 0xff, 0x03, 0xf8, 0x8e, 0xd8, 0xb9, 0x5c, 0x24, 0x00, 0x00
+};
+
+// Autogenerated from wled00/data/index_pp.js, do not edit!!
+const uint16_t PAGE_index_pp_L = 1080;
+#define PAGE_index_pp_ETAG "aac5261f"
+const uint8_t PAGE_index_pp[] PROGMEM = {
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xad, 0x55, 0xc1, 0x6e, 0xe3, 0x36,
+  0x10, 0xbd, 0xf3, 0x2b, 0x54, 0xd7, 0x8d, 0xa4, 0x8d, 0xa2, 0xd8, 0x29, 0x02, 0x74, 0xad, 0xb0,
+  0xc1, 0x22, 0xdb, 0x02, 0xbb, 0x45, 0xbb, 0x01, 0x92, 0x9e, 0x0c, 0x03, 0xa6, 0xa5, 0xb1, 0x4c,
+  0x87, 0x26, 0x55, 0x72, 0x94, 0xc4, 0x10, 0xf4, 0xef, 0x05, 0x29, 0x4b, 0x91, 0x62, 0xb7, 0xa7,
+  0x85, 0x61, 0xd3, 0x1c, 0xce, 0x3c, 0x0e, 0xdf, 0x9b, 0x21, 0xd7, 0xa5, 0x4c, 0x91, 0x2b, 0xe9,
+  0x69, 0xc8, 0x34, 0x7b, 0xb9, 0x67, 0xe2, 0x5e, 0xc3, 0x73, 0x10, 0x92, 0x8a, 0x08, 0x40, 0xaf,
+  0x60, 0x02, 0x10, 0xc1, 0xd0, 0x2c, 0xfe, 0xa7, 0x04, 0xbd, 0x7f, 0x00, 0x01, 0x29, 0x2a, 0xfd,
+  0x49, 0x88, 0xc0, 0xff, 0xb1, 0x60, 0x42, 0x70, 0x83, 0x5e, 0x2c, 0x0c, 0x7e, 0xf1, 0xc3, 0x84,
+  0xac, 0x95, 0x0e, 0x6c, 0x18, 0xa7, 0x93, 0x84, 0xdf, 0xb4, 0xc1, 0xb1, 0x00, 0x99, 0xe3, 0x26,
+  0xe1, 0xe7, 0xe7, 0x61, 0x03, 0xcb, 0x33, 0xda, 0x2e, 0xce, 0xf9, 0x22, 0xce, 0x18, 0x32, 0x03,
+  0x18, 0xf3, 0x2c, 0x71, 0xcb, 0xc2, 0xa0, 0xcd, 0x62, 0xe0, 0x33, 0xd8, 0x3e, 0xf0, 0xdd, 0x96,
+  0x85, 0x86, 0x67, 0xbb, 0x2d, 0x5f, 0x07, 0x87, 0x10, 0x8b, 0xdf, 0xfc, 0x8b, 0x0d, 0xee, 0x05,
+  0xd0, 0x1c, 0xe4, 0xe1, 0x4c, 0x77, 0xc6, 0x04, 0x3c, 0x0b, 0x13, 0x52, 0xbb, 0xcf, 0xba, 0x3d,
+  0xf8, 0x91, 0x07, 0xa9, 0x2c, 0xe0, 0x0f, 0xed, 0xe6, 0x9f, 0x19, 0xb2, 0xb0, 0x22, 0x1a, 0xb0,
+  0xd4, 0xd2, 0x46, 0x3f, 0x33, 0xdd, 0xf2, 0x62, 0xd7, 0x68, 0xdf, 0x71, 0xce, 0xb3, 0x45, 0xd2,
+  0x0f, 0x1f, 0x44, 0xfb, 0x19, 0x37, 0x85, 0x60, 0xfb, 0x99, 0x27, 0x95, 0x04, 0xdf, 0x82, 0xf1,
+  0x75, 0xd0, 0xf3, 0x3c, 0x30, 0x45, 0xe9, 0x34, 0xac, 0x48, 0xcf, 0x3e, 0x9f, 0x2e, 0x68, 0x7f,
+  0x3a, 0x69, 0x36, 0xf9, 0xa4, 0x35, 0xdb, 0xc7, 0xdc, 0xb8, 0x31, 0x18, 0xfa, 0x87, 0x47, 0x08,
+  0xf3, 0xc9, 0x82, 0x5e, 0x5d, 0x5f, 0x37, 0x04, 0xd8, 0x43, 0xe4, 0x9a, 0x65, 0x1c, 0x24, 0xd2,
+  0xf9, 0xe2, 0x4d, 0xba, 0x2d, 0x9d, 0x24, 0xdb, 0x9b, 0xe3, 0x9c, 0x92, 0xad, 0x53, 0x2f, 0x55,
+  0xd2, 0xa0, 0x07, 0x02, 0x76, 0x36, 0xb0, 0xbf, 0xc1, 0x76, 0xd1, 0x88, 0xa7, 0x9b, 0x21, 0x6f,
+  0x86, 0x55, 0x33, 0x70, 0x99, 0xc1, 0x2b, 0x5d, 0x33, 0x61, 0xe0, 0x44, 0xe6, 0x07, 0x38, 0x9b,
+  0x72, 0xe3, 0x78, 0x30, 0xcc, 0x27, 0x8b, 0xcb, 0xab, 0xeb, 0xeb, 0x0f, 0xd3, 0xc9, 0x24, 0x21,
+  0xba, 0xb3, 0x4e, 0x17, 0x09, 0xc9, 0xbb, 0xd9, 0xd5, 0x22, 0x21, 0xab, 0x6e, 0xf6, 0xf3, 0x22,
+  0x21, 0x35, 0x08, 0x03, 0x1e, 0x5f, 0xb7, 0xb8, 0x94, 0xfa, 0xda, 0xb7, 0x22, 0xd0, 0x3f, 0x19,
+  0x6e, 0x62, 0xcd, 0x64, 0xa6, 0x76, 0x41, 0xf8, 0xc1, 0x91, 0x91, 0x9f, 0x32, 0xae, 0x4e, 0x19,
+  0x1d, 0xac, 0xab, 0x0d, 0x03, 0xe2, 0x4e, 0x09, 0xa5, 0xcd, 0xa1, 0x9c, 0x0b, 0x65, 0x7a, 0xc9,
+  0x5d, 0x4c, 0x6d, 0xb2, 0x9d, 0xcf, 0xbc, 0x50, 0x66, 0xe1, 0x14, 0xcb, 0xdf, 0x1b, 0xa7, 0x2e,
+  0xf5, 0x77, 0x46, 0x7b, 0x9e, 0xba, 0xa9, 0x8c, 0x86, 0x0c, 0xda, 0xf0, 0xd6, 0x91, 0xb3, 0xbd,
+  0x3c, 0x56, 0xa7, 0xa1, 0xa8, 0x26, 0xad, 0xa4, 0x71, 0x51, 0x9a, 0x4d, 0xb0, 0xd4, 0xf9, 0x2a,
+  0x18, 0x57, 0xba, 0x8e, 0xc6, 0x55, 0x6e, 0x7f, 0x56, 0x75, 0xe8, 0x8d, 0x2b, 0x07, 0x53, 0xff,
+  0xb4, 0x74, 0xbd, 0xd0, 0x54, 0xe6, 0x72, 0xc5, 0xd2, 0xa7, 0x5c, 0xab, 0x52, 0x66, 0x33, 0x4f,
+  0x70, 0x09, 0x4c, 0x5f, 0xb4, 0x58, 0x01, 0x2a, 0x4f, 0xf3, 0x7c, 0x83, 0x16, 0xa5, 0xc5, 0xdf,
+  0x2a, 0x2e, 0x83, 0xb0, 0x0e, 0x93, 0x65, 0xd2, 0x6f, 0x26, 0xa1, 0x58, 0x76, 0xdf, 0xeb, 0x87,
+  0x20, 0x65, 0x42, 0x58, 0x6c, 0x2a, 0x4b, 0x21, 0x0e, 0xad, 0x35, 0xe8, 0xac, 0xb6, 0xaf, 0x9a,
+  0xc2, 0x12, 0xe6, 0x0f, 0xd8, 0xd3, 0xd1, 0x8b, 0x00, 0x0b, 0xf3, 0x3a, 0x4a, 0xfa, 0xdd, 0xe6,
+  0x02, 0xbe, 0x1a, 0x25, 0xa9, 0x50, 0x29, 0x13, 0x0f, 0xa8, 0x34, 0xcb, 0x21, 0xce, 0x01, 0xbf,
+  0x20, 0xec, 0x02, 0x17, 0xdb, 0xdc, 0x06, 0xef, 0x03, 0xc2, 0x8a, 0xa0, 0xde, 0x77, 0x0d, 0xf1,
+  0x06, 0xf4, 0xf5, 0xe1, 0xdb, 0x5f, 0x71, 0xc1, 0xb4, 0x81, 0xe3, 0x98, 0x66, 0xef, 0x8c, 0x4a,
+  0x78, 0xf1, 0x3e, 0x33, 0x84, 0xe0, 0x34, 0xf6, 0xd9, 0xd9, 0x7b, 0x4b, 0xfc, 0xcc, 0x33, 0x4a,
+  0x05, 0x33, 0xc8, 0xe5, 0x5a, 0xd9, 0xd9, 0x09, 0x9f, 0xb4, 0x60, 0xa2, 0xe7, 0x64, 0xa7, 0xa9,
+  0x2a, 0x25, 0x86, 0xc3, 0x2c, 0xe9, 0x51, 0x60, 0xe1, 0xb2, 0x68, 0x79, 0x0d, 0xdb, 0x3f, 0x36,
+  0xbb, 0xb7, 0x3b, 0xaa, 0x4e, 0x19, 0xa6, 0x9b, 0x00, 0xc2, 0xca, 0x96, 0xd2, 0x00, 0xb0, 0xaa,
+  0x13, 0x92, 0x03, 0x3e, 0x20, 0x43, 0x9e, 0x0e, 0xb4, 0x6a, 0x55, 0x0c, 0xd4, 0x53, 0x58, 0x59,
+  0x9f, 0xc1, 0xea, 0x24, 0x52, 0x4f, 0x51, 0xe7, 0x62, 0x2b, 0xbf, 0x2f, 0x82, 0xe9, 0x8b, 0x10,
+  0x39, 0x5a, 0x0d, 0x6a, 0x2e, 0x73, 0xbe, 0xde, 0x07, 0x15, 0x29, 0x66, 0xfd, 0x1c, 0x22, 0xf2,
+  0xcc, 0xb3, 0x59, 0x9f, 0xa0, 0x88, 0x58, 0x02, 0x66, 0xc7, 0x74, 0x90, 0x3a, 0x74, 0x07, 0x1b,
+  0x3c, 0x4e, 0x43, 0x06, 0x0c, 0xe0, 0x23, 0xdf, 0x81, 0x2a, 0xb1, 0xb3, 0x45, 0x1f, 0x3f, 0xda,
+  0xe2, 0x6e, 0xbf, 0xfd, 0xcb, 0xfe, 0xd4, 0xc1, 0x3b, 0x28, 0x52, 0x39, 0xcd, 0x4b, 0x2d, 0xe8,
+  0xf2, 0xb2, 0x7b, 0xbe, 0xb6, 0x46, 0xc9, 0xdb, 0x67, 0x3a, 0xae, 0xfa, 0x19, 0xd7, 0xcb, 0xe6,
+  0xdd, 0x51, 0x69, 0x58, 0x11, 0x17, 0xb0, 0x41, 0x2c, 0x66, 0x97, 0x97, 0xe3, 0x4a, 0xa8, 0x94,
+  0x17, 0xf5, 0xb8, 0x2a, 0xb5, 0xa8, 0x9b, 0xf6, 0x00, 0x2b, 0x46, 0xa9, 0x45, 0x54, 0x91, 0x1d,
+  0xe0, 0x46, 0x65, 0x33, 0x3f, 0x07, 0xf4, 0x49, 0x1d, 0x92, 0x18, 0x37, 0x20, 0x03, 0x0d, 0x86,
+  0xfe, 0xda, 0xbc, 0x3b, 0x1a, 0x4c, 0xac, 0x9e, 0x42, 0xdc, 0x68, 0xf5, 0xe2, 0xd9, 0xda, 0xfb,
+  0x4d, 0x6b, 0xa5, 0xad, 0x47, 0x6c, 0x90, 0x61, 0x69, 0x3a, 0xa1, 0x3d, 0x7d, 0x48, 0x2e, 0x70,
+  0x07, 0x3d, 0x40, 0x59, 0x83, 0xc5, 0x1a, 0x88, 0xfe, 0x6d, 0xb5, 0x85, 0x14, 0x63, 0x66, 0x0c,
+  0xcf, 0x65, 0x50, 0xd5, 0xd1, 0x40, 0x8e, 0xad, 0xab, 0xab, 0x30, 0x21, 0x5d, 0x31, 0xa1, 0x2e,
+  0xe1, 0x00, 0xda, 0x54, 0x52, 0x27, 0x3c, 0xd8, 0x6c, 0xec, 0x43, 0xd0, 0xba, 0x36, 0x97, 0xd3,
+  0x29, 0xa6, 0x07, 0x1c, 0x17, 0x2c, 0x87, 0x48, 0x63, 0x74, 0x9a, 0x6b, 0x9b, 0x81, 0x25, 0xfc,
+  0xf5, 0xd6, 0xfa, 0xd1, 0x71, 0x65, 0x87, 0x7a, 0x5c, 0x69, 0xbc, 0xf5, 0xcf, 0x34, 0xfa, 0x33,
+  0xdf, 0xff, 0x1e, 0x84, 0x47, 0x64, 0x03, 0x2c, 0x03, 0x6d, 0x66, 0x15, 0x19, 0xdd, 0x29, 0x89,
+  0x20, 0xf1, 0x02, 0xf7, 0x05, 0x8c, 0x66, 0x23, 0x56, 0x14, 0x82, 0xa7, 0xcc, 0x26, 0xef, 0xd2,
+  0x49, 0xbc, 0x74, 0x63, 0x2f, 0x06, 0xa4, 0x7f, 0x3f, 0xfe, 0x7e, 0xf1, 0xcb, 0xc8, 0x76, 0xd5,
+  0x7f, 0xcb, 0x55, 0x11, 0xb3, 0x51, 0x2f, 0x4e, 0xaa, 0x47, 0xc5, 0x0c, 0x06, 0xbd, 0xcb, 0xf5,
+  0xfb, 0xeb, 0xe4, 0xae, 0xa1, 0x1c, 0x6e, 0x9c, 0x61, 0x77, 0xa2, 0x59, 0xed, 0xea, 0xf9, 0x74,
+  0xc0, 0x77, 0xf7, 0x80, 0xf5, 0x6f, 0x8c, 0xfa, 0xff, 0x24, 0xb6, 0x27, 0x6a, 0x0e, 0xe3, 0x2c,
+  0xd1, 0xa1, 0x28, 0xec, 0x4d, 0xad, 0x04, 0xc4, 0x42, 0xe5, 0x07, 0xd7, 0x56, 0xfc, 0x7f, 0x01,
+  0xff, 0x2a, 0xa6, 0xbe, 0x4d, 0x0a, 0x00, 0x00
+};
+
+// Autogenerated from wled00/data/index_se.js, do not edit!!
+const uint16_t PAGE_index_se_L = 602;
+#define PAGE_index_se_ETAG "cc6d2615"
+const uint8_t PAGE_index_se[] PROGMEM = {
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x95, 0x54, 0x4d, 0x6f, 0xda, 0x40,
+  0x10, 0x3d, 0xe3, 0x5f, 0xb1, 0x9a, 0xa2, 0x06, 0xab, 0xc5, 0x40, 0x22, 0x55, 0x2a, 0x78, 0x1d,
+  0xa9, 0x6d, 0xa4, 0x46, 0xa2, 0xbd, 0xd0, 0xdc, 0x71, 0xbc, 0x63, 0xb3, 0xca, 0x32, 0xb6, 0xbc,
+  0x63, 0x42, 0x84, 0xfc, 0xdf, 0xab, 0xb5, 0x21, 0x72, 0x4c, 0xa2, 0x36, 0x07, 0xcc, 0x6a, 0x76,
+  0x3e, 0xde, 0xbc, 0x79, 0xb3, 0x69, 0x45, 0x09, 0xeb, 0x9c, 0xc4, 0x36, 0x7e, 0xc0, 0x15, 0x66,
+  0x23, 0xff, 0xe0, 0xed, 0xe2, 0x52, 0x90, 0x95, 0xd3, 0x85, 0xa7, 0xd3, 0x91, 0xc9, 0x1f, 0xd1,
+  0xf2, 0x1d, 0x55, 0x16, 0x55, 0x34, 0x3d, 0xde, 0x16, 0x48, 0x4a, 0x16, 0x71, 0x69, 0xf1, 0x96,
+  0x78, 0xa4, 0x82, 0x0c, 0xf9, 0xc6, 0xe0, 0x16, 0x89, 0xbf, 0x3d, 0xdd, 0xaa, 0xd1, 0xda, 0x62,
+  0x36, 0x3c, 0x74, 0x23, 0xc7, 0xb3, 0x1a, 0xd7, 0x7e, 0xb0, 0x8b, 0x4d, 0x85, 0x9f, 0x67, 0x53,
+  0xff, 0xd3, 0x28, 0x49, 0xb3, 0x20, 0xc9, 0xb7, 0x45, 0x60, 0x31, 0x33, 0x48, 0xd7, 0xef, 0xcc,
+  0x66, 0xbb, 0xd9, 0xe6, 0x53, 0xbf, 0xc1, 0xea, 0x60, 0x85, 0x06, 0xd5, 0xf7, 0xbc, 0x22, 0xf6,
+  0xc9, 0x4a, 0x67, 0x58, 0x78, 0x75, 0x83, 0x39, 0x21, 0xb9, 0x0e, 0x95, 0xde, 0x89, 0xc4, 0xc4,
+  0xd6, 0x4a, 0xb0, 0x98, 0x41, 0xe4, 0x0d, 0x06, 0x83, 0x9e, 0x91, 0xe2, 0x2d, 0x0a, 0xc2, 0xc7,
+  0xf6, 0xfe, 0x37, 0x3e, 0x0a, 0x8b, 0x99, 0x03, 0x23, 0x5e, 0x82, 0xa8, 0xbd, 0x50, 0x9f, 0xc2,
+  0x74, 0x92, 0x93, 0x15, 0xa8, 0x34, 0x8f, 0xdd, 0x51, 0xe0, 0xbe, 0x88, 0x49, 0xa1, 0x02, 0x91,
+  0x53, 0x62, 0x74, 0xf2, 0x20, 0x81, 0x33, 0xb3, 0xc2, 0x8c, 0x46, 0xbd, 0x24, 0x3e, 0x44, 0x1f,
+  0x3f, 0xec, 0xf1, 0x32, 0xf9, 0xb2, 0x08, 0x27, 0xba, 0xc5, 0x33, 0x51, 0x7a, 0xd7, 0x9e, 0xee,
+  0xcb, 0xd7, 0x10, 0xea, 0x4e, 0x81, 0xc8, 0x0b, 0x35, 0x15, 0x15, 0x0b, 0x7e, 0x2a, 0x50, 0x02,
+  0xe3, 0x9e, 0xe1, 0xe4, 0x5a, 0xf0, 0x9e, 0x85, 0x75, 0x1f, 0xca, 0xad, 0xd1, 0x0a, 0x41, 0x68,
+  0xd5, 0x64, 0xe8, 0x81, 0x60, 0x10, 0x71, 0xc5, 0xb9, 0x1b, 0x87, 0x41, 0x46, 0x09, 0x79, 0x9a,
+  0x82, 0xd8, 0xc6, 0x7b, 0x83, 0x94, 0xf1, 0x46, 0x5e, 0x5d, 0x8a, 0x86, 0x6b, 0x09, 0x20, 0x0a,
+  0x13, 0x27, 0xb8, 0xc9, 0x8d, 0xc2, 0x52, 0xc2, 0x0d, 0x31, 0x96, 0xc2, 0x31, 0x16, 0x04, 0x01,
+  0x4c, 0x1a, 0xb0, 0x83, 0x90, 0xe3, 0x7b, 0x83, 0x1d, 0xbc, 0xdc, 0xf2, 0xec, 0x6e, 0xca, 0xe3,
+  0x69, 0x10, 0xb2, 0xea, 0x7a, 0x28, 0x88, 0x56, 0x1c, 0x97, 0x2c, 0x96, 0x37, 0x3f, 0xc2, 0x09,
+  0xab, 0xc8, 0x3b, 0x77, 0x18, 0x1e, 0xfa, 0x9a, 0x81, 0x65, 0x83, 0x0f, 0xe6, 0xb0, 0xe2, 0xbc,
+  0x70, 0xb1, 0x50, 0xb7, 0xd1, 0x6d, 0x8d, 0xc9, 0x73, 0xbd, 0xa6, 0xf2, 0x79, 0xca, 0x23, 0x77,
+  0x47, 0xe3, 0x91, 0x25, 0x37, 0x6f, 0x7a, 0x8b, 0x2a, 0x0b, 0x47, 0xa6, 0xa9, 0xda, 0xde, 0x63,
+  0x09, 0x62, 0xab, 0x49, 0xc2, 0xb4, 0x61, 0x4b, 0xc2, 0xf0, 0x70, 0x52, 0xdf, 0x78, 0x56, 0xc3,
+  0x89, 0xb4, 0xe1, 0x81, 0x6c, 0xed, 0xa4, 0xd0, 0x54, 0x93, 0x50, 0x15, 0x2a, 0x66, 0x5c, 0xe2,
+  0x6b, 0x62, 0x78, 0xab, 0xf9, 0xf7, 0x23, 0xc5, 0xff, 0x45, 0x7a, 0xb6, 0x8a, 0x64, 0xe7, 0x53,
+  0xbf, 0x0b, 0xff, 0xdf, 0xae, 0xef, 0xe8, 0xad, 0x37, 0x9a, 0x70, 0xd2, 0xc8, 0x25, 0xf2, 0xba,
+  0x22, 0xdf, 0xbc, 0xd5, 0x94, 0x41, 0x72, 0x42, 0x78, 0x06, 0x44, 0xb6, 0x76, 0x63, 0x7f, 0x61,
+  0x89, 0x66, 0xd7, 0x60, 0x61, 0x0e, 0x4e, 0x0b, 0xcd, 0x26, 0x9d, 0xed, 0x69, 0xbb, 0xa4, 0x09,
+  0xa5, 0xee, 0x37, 0xb6, 0x62, 0x13, 0x9b, 0xf4, 0xb9, 0x62, 0xd2, 0x2b, 0xd9, 0xd9, 0x61, 0x8b,
+  0xec, 0x9e, 0xc8, 0x7e, 0x67, 0x0b, 0x51, 0xa2, 0x45, 0xbe, 0x63, 0x6d, 0x46, 0xfe, 0xa2, 0x5d,
+  0xe8, 0xab, 0xaf, 0xd3, 0xfe, 0x42, 0xb7, 0x7f, 0xeb, 0x85, 0x77, 0xf6, 0xc2, 0x5d, 0x58, 0xcc,
+  0x2a, 0xd6, 0xe6, 0xc2, 0x0f, 0x34, 0x11, 0x96, 0x3f, 0xff, 0xfc, 0x5a, 0xca, 0x84, 0xdc, 0xcb,
+  0xf5, 0x17, 0x47, 0x21, 0xcc, 0x6c, 0xa0, 0x05, 0x00, 0x00
+};
@@ -6,8 +6,284 @@
 
 #ifndef WLED_DISABLE_HUESYNC
 
+static void applyHueResponse();
+
+//extracts the few values we use from bridge responses as they arrive, split across any number of TCP segments.
+//Responses end with the JSON nesting or with the last chunk of a chunked body, so one kept-alive connection can carry any number of them
+class HueParser {
+  public:
+    //light state
+    bool hasState, on, hasBri;
+    uint8_t bri, sat;
+    uint16_t hue, ct;
+    float xy[2];
+    char colormode[4];
+    //auth and errors
+    int errorCode;
+    char username[sizeof(hueApiKey) +1];
+    bool topArray;
+    bool malformed; //the body was not the JSON expected
+
+    HueParser() { reset(); }
+
+    void reset() {
+      startMessage();
+      hasState = false; on = false; hasBri = false; bri = 0; sat = 0; hue = 0; ct = 0;
+      xy[0] = 0; xy[1] = 0; colormode[0] = 0; errorCode = 0; username[0] = 0; topArray = false; malformed = false;
+    }
+
+    //returns true when a complete response was parsed
+    bool feed(char c) {
+      if (!_inBody) { header(c); return false; }
+      if (!_chunked) return body(c);
+      switch (_chunkState) {
+        case HUE_CHUNK_SIZE: {
+          int8_t v = (c >= '0' && c <= '9') ? c - '0' : ((c | 0x20) >= 'a' && (c | 0x20) <= 'f') ? (c | 0x20) - 'a' + 10 : -1;
+          if (v >= 0) {_chunkLeft = (_chunkLeft << 4) | v; return false;}
+        } //fall through - extensions or the end of the size line
+        case HUE_CHUNK_EXT:
+          if (c != '\n') {_chunkState = HUE_CHUNK_EXT; return false;}
+          _chunkState = _chunkLeft ? HUE_CHUNK_DATA : HUE_CHUNK_TRAILER;
+          _lineLen = 0;
+          return false;
+        case HUE_CHUNK_DATA:
+          if (!--_chunkLeft) _chunkState = HUE_CHUNK_END;
+          return body(c);
+        case HUE_CHUNK_END: //CRLF after the data
+          if (c == '\n') {_chunkState = HUE_CHUNK_SIZE; _chunkLeft = 0;}
+          return false;
+        default: { //trailers up to the empty line, then the next response
+          if (c == '\r') return false;
+          if (c != '\n') {_lineLen = 1; return false;}
+          if (_lineLen) {_lineLen = 0; return false;}
+          bool unfinished = _depth && !_skip;
+          startMessage();
+          if (unfinished) malformed = true;
+          return unfinished;
+        }
+      }
+    }
+
+  private:
+    enum { HUE_CHUNK_SIZE, HUE_CHUNK_EXT, HUE_CHUNK_DATA, HUE_CHUNK_END, HUE_CHUNK_TRAILER };
+    bool _inBody, _chunked, _sawLine;
+    uint8_t _chunkState;
+    uint32_t _chunkLeft;
+    char _line[28]; //start of the current header line, lower case
+    uint8_t _lineLen;
+    uint8_t _depth, _ctx, _ctxDepth, _xyIdx; //_ctx: 1 state, 2 error, 3 success
+    uint32_t _arrays; //bit set for each nesting level that is an array
+    bool _inString, _esc, _afterColon, _skip;
+    char _buf[48];
+    uint8_t _len;
+    char _key[12];
+
+    void startMessage() {
+      _inBody = false; _chunked = false; _sawLine = false; _lineLen = 0;
+      _chunkState = HUE_CHUNK_SIZE; _chunkLeft = 0;
+      _depth = 0; _arrays = 0; _ctx = 0; _ctxDepth = 0; _xyIdx = 255;
+      _inString = false; _esc = false; _afterColon = false; _skip = false; _len = 0; _key[0] = 0;
+    }
+
+    //headers up to the empty line, only Transfer-Encoding is of interest
+    void header(char c) {
+      if (c == '\r') return;
+      if (c != '\n') {
+        if (_lineLen < sizeof(_line) -1) _line[_lineLen++] = (c >= 'A' && c <= 'Z') ? c | 0x20 : c;
+        return;
+      }
+      if (!_lineLen) { //blank lines before the status line are left over from the previous response
+        if (_sawLine) _inBody = true;
+        return;
+      }
+      _line[_lineLen] = 0;
+      if (!strncmp_P(_line, PSTR("transfer-encoding:"), 18) && strstr(_line, "chunked")) _chunked = true;
+      _sawLine = true;
+      _lineLen = 0;
+    }
+
+    //the body is not what we expect (an error page, broken JSON): reported once, the rest of it is ignored
+    bool fail() {
+      _skip = true;
+      malformed = true;
+      return true;
+    }
+
+    bool body(char c) {
+      if (_skip) return false;
+      if (_inString) {
+        if (_esc) _esc = false;
+        else if (c == '\\') {_esc = true; return false;}
+        else if (c == '"') {
+          _inString = false;
+          _buf[_len] = 0;
+          if (_afterColon || inArray()) value(true);
+          else strlcpy(_key, _buf, sizeof(_key));
+          _len = 0;
+          return false;
+        }
+        if (_len < sizeof(_buf) -1) _buf[_len++] = c;
+        return false;
+      }
+      switch (c) {
+        case '"': if (!_depth) return fail(); _len = 0; _inString = true; break;
+        case ':': _afterColon = true; break;
+        case ',': flush(); _afterColon = false; if (_xyIdx < 2) _xyIdx++; break;
+        case '{': case '[':
+          if (!_depth) topArray = (c == '[');
+          if (_afterColon && c == '{') { //{"state":{..}} or [{"error":{..}}] / [{"success":{..}}]
+            if      (_depth == 1 && !strcmp_P(_key, PSTR("state")))   {_ctx = 1; _ctxDepth = 2; hasState = true;}
+            else if (_depth == 2 && !strcmp_P(_key, PSTR("error")))   {_ctx = 2; _ctxDepth = 3;}
+            else if (_depth == 2 && !strcmp_P(_key, PSTR("success"))) {_ctx = 3; _ctxDepth = 3;}
+          }
+          if (c == '[' && _ctx == 1 && _depth == _ctxDepth && !strcmp_P(_key, PSTR("xy"))) _xyIdx = 0;
+          if (_depth == 31) return fail(); //nested deeper than any bridge response
+          _depth++;
+          if (c == '[') _arrays |= (1UL << _depth); else _arrays &= ~(1UL << _depth);
+          _afterColon = false;
+          break;
+        case '}': case ']':
+          if (!_depth || inArray() != (c == ']')) return fail();
+          flush();
+          if (c == ']' && _xyIdx < 255 && _depth == _ctxDepth +1) _xyIdx = 255;
+          _depth--;
+          if (_depth < _ctxDepth) _ctx = 0;
+          _afterColon = false;
+          if (!_depth) { //response complete
+            if (!_chunked) startMessage(); //a chunked one still has its last chunk to come
+            return true;
+          }
+          break;
+        case ' ': case '\t': case '\r': case '\n': flush(); break;
+        default:
+          if (!_depth) return fail(); //not JSON
+          if (_len < sizeof(_buf) -1) _buf[_len++] = c; //number or literal
+      }
+      return false;
+    }
+
+    bool inArray() { return _arrays & (1UL << _depth); }
+
+    void flush() {
+      if (!_len) return;
+      _buf[_len] = 0;
+      value(false);
+      _len = 0;
+    }
+
+    void value(bool isString) {
+      if (_ctx == 1 && _depth == _ctxDepth) {
+        if      (!strcmp_P(_key, PSTR("on")))  on = (_buf[0] == 't');
+        else if (!strcmp_P(_key, PSTR("bri"))) {bri = atoi(_buf); hasBri = true;}
+        else if (!strcmp_P(_key, PSTR("hue"))) hue = atoi(_buf);
+        else if (!strcmp_P(_key, PSTR("sat"))) sat = atoi(_buf);
+        else if (!strcmp_P(_key, PSTR("ct")))  ct = atoi(_buf);
+        else if (!strcmp_P(_key, PSTR("colormode"))) strlcpy(colormode, _buf, sizeof(colormode));
+      } else if (_ctx == 1 && _xyIdx < 2 && _depth == _ctxDepth +1) {
+        xy[_xyIdx] = atof(_buf);
+      } else if (_ctx == 2 && !strcmp_P(_key, PSTR("type"))) {
+        errorCode = atoi(_buf);
+      } else if (_ctx == 3 && isString && !strcmp_P(_key, PSTR("username"))) {
+        strlcpy(username, _buf, sizeof(username));
+      }
+    }
+};
+
+static HueParser hueParser;
+
+/*
+ * Hue Entertainment input: HueStream packets, as a sync app sends them to the bridge, received unencrypted on HUE_STREAM_PORT
+ * from a sender or a relay that terminates the DTLS session of the bridge. Up to 25 Hz, no JSON involved.
+ * Header: "HueStream", version, sequence, 2 reserved, color space (0 RGB, 1 XY + brightness), 1 reserved.
+ * v1: 9 bytes per light: type, light id (16 bit), 3 values (16 bit). The entry of huePollLightId is used.
+ * v2: 36 character entertainment configuration id, then 7 bytes per channel: channel id, 3 values. Channel huePollLightId -1 is used.
+ */
+#define HUE_STREAM_MAX_LEN 200
+
+static WiFiUDP hueStreamUdp;
+static bool hueStreamOpen = false;
+static bool hueStreamReceived = false;
+static unsigned long hueStreamLast = 0;
+static uint16_t hueStreamVal[3];
+
+//the 3 values of our light in a HueStream packet
+static bool decodeHueStream(const uint8_t* p, uint16_t len, uint16_t* val, bool& xy)
+{
+  if (len < 16 || memcmp_P(p, PSTR("HueStream"), 9)) return false;
+  uint8_t version = p[9];
+  if (version < 1 || version > 2) return false;
+  xy = (p[14] == 1);
+  uint16_t pos = (version == 1) ? 16 : 52;
+  uint8_t entryLen = (version == 1) ? 9 : 7;
+  for (; pos + entryLen <= len; pos += entryLen) {
+    if (version == 1 && ((p[pos+1] << 8) | p[pos+2]) != huePollLightId) continue;
+    if (version == 2 && p[pos] != huePollLightId -1) continue;
+    const uint8_t* v = p + pos + entryLen - 6;
+    for (uint8_t i = 0; i < 3; i++) val[i] = (v[2*i] << 8) | v[2*i+1];
+    return true;
+  }
+  return false;
+}
+
+static void applyHueStream(const uint16_t* val, bool xy)
+{
+  byte hueBri;
+  byte rgb[3] = {0, 0, 0};
+  if (xy) {
+    hueBri = val[2] >> 8;
+    colorXYtoRGB(val[0] / 65535.0f, val[1] / 65535.0f, rgb);
+  } else { //the brightness is in the color
+    for (uint8_t i = 0; i < 3; i++) rgb[i] = val[i] >> 8;
+    hueBri = MAX(rgb[0], MAX(rgb[1], rgb[2]));
+    if (hueBri) for (uint8_t i = 0; i < 3; i++) rgb[i] = (uint16_t)rgb[i] * 255 / hueBri;
+  }
+  if (hueApplyOnOff) {
+    if (hueBri == 0) bri = 0;
+    else if (bri == 0) bri = briLast;
+  }
+  if (hueApplyBri && hueBri > 0) bri = hueBri;
+  if (hueApplyColor && hueBri > 0) {col[0] = rgb[0]; col[1] = rgb[1]; col[2] = rgb[2];}
+  hueBriLast = hueBri;
+  hueError = HUE_ERROR_ACTIVE;
+  hueStreamReceived = true;
+}
+
+static void handleHueStream()
+{
+  if (!hueStreamEnabled || !WLED_CONNECTED) {
+    if (hueStreamOpen) hueStreamUdp.stop();
+    hueStreamOpen = false;
+    return;
+  }
+  if (!hueStreamOpen) hueStreamOpen = hueStreamUdp.begin(HUE_STREAM_PORT);
+  if (!hueStreamOpen) return;
+
+  //only the newest of the packets waiting is applied
+  uint8_t buf[HUE_STREAM_MAX_LEN];
+  uint16_t val[3];
+  bool xy = false, got = false;
+  int packetSize;
+  while ((packetSize = hueStreamUdp.parsePacket()) > 0) {
+    uint16_t len = hueStreamUdp.read(buf, HUE_STREAM_MAX_LEN);
+    if (decodeHueStream(buf, len, val, xy)) got = true;
+  }
+  if (!got) return;
+  hueStreamLast = millis();
+  if (!memcmp(val, hueStreamVal, sizeof(hueStreamVal))) return;
+  memcpy(hueStreamVal, val, sizeof(hueStreamVal));
+  applyHueStream(val, xy);
+}
+
 void handleHue()
 {
+  handleHueStream();
+  if (hueStreamReceived)
+  {
+    //follow the stream frame by frame instead of the configured transition
+    transitionDelayTemp = HUE_STREAM_TRANSITION;
+    jsonTransitionOnce = true;
+    colorUpdated(CALL_MODE_HUE); hueStreamReceived = false;
+  }
   if (hueReceived)
   {
     colorUpdated(CALL_MODE_HUE); hueReceived = false;
@@ -20,11 +296,14 @@ void handleHue()
   }
   
   if (!WLED_CONNECTED || hueClient == nullptr || millis() - hueLastRequestSent < huePollIntervalMs) return;
+  if (hueStreamLast && millis() - hueStreamLast < HUE_STREAM_TIMEOUT) return; //the stream is newer than a poll
 
   hueLastRequestSent = millis();
   if (huePollingEnabled)
   {
-    reconnectHue();
+    //the connection is kept alive between polls, only reconnect if the bridge closed it
+    if (hueClient->connected()) sendHuePoll();
+    else reconnectHue();
   } else {
     hueClient->close();
     if (hueError == HUE_ERROR_ACTIVE) hueError = HUE_ERROR_INACTIVE;
@@ -60,48 +339,43 @@ void onHueConnect(void* arg, AsyncClient* client)
 void sendHuePoll()
 {
   if (hueClient == nullptr || !hueClient->connected()) return;
-  String req = "";
+  char req[160];
+  int len;
   if (hueAuthRequired)
   {
-    req += F("POST /api HTTP/1.1\r\nHost: ");
-    req += hueIP.toString();
-    req += F("\r\nContent-Length: 25\r\n\r\n{\"devicetype\":\"wled#esp\"}");
+    len = snprintf_P(req, sizeof(req), PSTR("POST /api HTTP/1.1\r\nHost: %d.%d.%d.%d\r\nContent-Length: 25\r\n\r\n{\"devicetype\":\"wled#esp\"}"),
+      hueIP[0], hueIP[1], hueIP[2], hueIP[3]);
   } else
   {
-    req += F("GET /api/");
-    req += hueApiKey;
-    req += F("/lights/");
-    req += String(huePollLightId);
-    req += F(" HTTP/1.1\r\nHost: ");
-    req += hueIP.toString();
-    req += "\r\n\r\n";
-  }
-  hueClient->add(req.c_str(), req.length());
+    len = snprintf_P(req, sizeof(req), PSTR("GET /api/%s/lights/%u HTTP/1.1\r\nHost: %d.%d.%d.%d\r\n\r\n"),
+      hueApiKey, huePollLightId, hueIP[0], hueIP[1], hueIP[2], hueIP[3]);
+  }
+  if (len <= 0 || len >= (int)sizeof(req)) return;
+  hueParser.reset(); //a response that did not complete is dropped
+  hueClient->add(req, len);
   hueClient->send();
   hueLastRequestSent = millis();
 }
 
+
 void onHueData(void* arg, AsyncClient* client, void *data, size_t len)
 {
-  if (!len) return;
-  char* str = (char*)data;
-  DEBUG_PRINTLN(hueApiKey);
-  DEBUG_PRINTLN(str);
-  //only get response body
-  str = strstr(str,"\r\n\r\n");
-  if (str == nullptr) return;
-  str += 4;
-
-  StaticJsonDocument<1024> root;
-  if (str[0] == '[') //is JSON array
+  const char* str = (const char*)data;
+  for (size_t i = 0; i < len; i++) {
+    if (hueParser.feed(str[i])) applyHueResponse();
+  }
+}
+
+static void applyHueResponse()
+{
+  HueParser& root = hueParser;
+  if (root.malformed) {
+    hueError = HUE_ERROR_JSON_PARSING;
+    return;
+  }
+  if (root.topArray) //is JSON array
   {
-    auto error = deserializeJson(root, str);
-    if (error)
-    {
-      hueError = HUE_ERROR_JSON_PARSING; return;
-    }
-    
-    int hueErrorCode = root[0][F("error")][F("type")];
+    int hueErrorCode = root.errorCode;
     if (hueErrorCode)//hue bridge returned error
     {
       hueError = hueErrorCode;
@@ -116,10 +390,9 @@ void onHueData(void* arg, AsyncClient* client, void *data, size_t len)
     
     if (hueAuthRequired)
     {
-      const char* apikey = root[0][F("success")][F("username")];
-      if (apikey != nullptr && strlen(apikey) < sizeof(hueApiKey))
+      if (root.username[0] && strlen(root.username) < sizeof(hueApiKey))
       {
-        strlcpy(hueApiKey, apikey, sizeof(hueApiKey));
+        strlcpy(hueApiKey, root.username, sizeof(hueApiKey));
         hueAuthRequired = false;
         hueNewKey = true;
       }
@@ -127,42 +400,34 @@ void onHueData(void* arg, AsyncClient* client, void *data, size_t len)
     return;
   }
 
-  //else, assume it is JSON object, look for state and only parse that
-  str = strstr(str,"state");
-  if (str == nullptr) return;
-  str = strstr(str,"{");
-  
-  auto error = deserializeJson(root, str);
-  if (error)
-  {
-    hueError = HUE_ERROR_JSON_PARSING; return;
-  }
+  //else, it is a JSON object, only its state is used
+  if (!root.hasState) return;
 
   float hueX=0, hueY=0;
   uint16_t hueHue=0, hueCt=0;
   byte hueBri=0, hueSat=0, hueColormode=0;
 
-  if (root["on"]) {
-    if (root.containsKey("bri")) //Dimmable device
+  if (root.on) {
+    if (root.hasBri) //Dimmable device
     {
-      hueBri = root["bri"];
+      hueBri = root.bri;
       hueBri++;
-      const char* cm =root[F("colormode")];
-      if (cm != nullptr) //Color device
+      const char* cm = root.colormode;
+      if (cm[0]) //Color device
       {
         if (strstr(cm,("ct")) != nullptr) //ct mode
         {
-          hueCt = root["ct"];
+          hueCt = root.ct;
           hueColormode = 3;
         } else if (strstr(cm,"xy") != nullptr) //xy mode
         {
-          hueX = root["xy"][0]; // 0.5051
-          hueY = root["xy"][1]; // 0.4151
+          hueX = root.xy[0]; // 0.5051
+          hueY = root.xy[1]; // 0.4151
           hueColormode = 1;
         } else //hs mode
         {
-          hueHue = root["hue"];
-          hueSat = root[F("sat")];
+          hueHue = root.hue;
+          hueSat = root.sat;
           hueColormode = 2;
         }
       }
@@ -6,14 +6,19 @@
 
 #if defined(WLED_DISABLE_INFRARED)
 void handleIR(){}
+void invalidateIrJson(){}
 #else
 
+#if defined(ARDUINO_ARCH_ESP32) && defined(WLED_USE_IR_RMT)
+#include <driver/rmt.h>
+#else
 IRrecv* irrecv;
 //change pin in NpbWrapper.h
 
 decode_results results;
 
 unsigned long irCheckedTime = 0;
+#endif
 uint32_t lastValidCode = 0;
 byte lastRepeatableAction = ACTION_NONE;
 uint8_t lastRepeatableValue = 0;
@@ -563,72 +568,258 @@ Sample:
                "label": "Preset 1, fallback to Saw - Party if not found"},
 }
 */
+#define IR_JSON_NOP     0
+#define IR_JSON_INCBRI  1
+#define IR_JSON_DECBRI  2
+#define IR_JSON_PRESETF 3
+#define IR_JSON_HTTP    4
+#define IR_JSON_JSON    5
+
+//one ir.json entry, parsed once. HTTP and JSON commands are kept as text in a shared pool
+typedef struct IrJsonEntry {
+  uint32_t code;
+  uint16_t cmd;        // offset of the command in irCmdPool
+  uint8_t  type;       // IR_JSON_*
+  uint8_t  pl, fx, fp; // !presetFallback arguments, fx 0 picks a random effect
+  bool     rpt;
+  bool     used;
+} IrJsonEntry;
+
+static IrJsonEntry* irTable = nullptr; // open addressed, irTableMask +1 slots
+static uint16_t irTableMask = 0;
+static char* irCmdPool = nullptr;
+static int8_t irTableState = 0;        // 0: not loaded, 1: loaded, -1: no usable /ir.json
+
+static inline uint16_t irTableSlot(uint32_t code) { return (code * 2654435761UL) >> 16; }
+
+//called when /ir.json was replaced
+void invalidateIrJson()
+{
+  free(irTable);   irTable = nullptr;   irTableMask = 0;
+  free(irCmdPool); irCmdPool = nullptr;
+  irTableState = 0;
+}
+
+static IrJsonEntry* findIrJson(uint32_t code)
+{
+  if (!irTable) return nullptr;
+  for (uint16_t i = irTableSlot(code) & irTableMask; irTable[i].used; i = (i + 1) & irTableMask) {
+    if (irTable[i].code == code) return &irTable[i];
+  }
+  return nullptr;
+}
+
+//reads /ir.json once into the table, only the keys used by decodeIRJson() are kept while parsing
+static void loadIrJson()
+{
+  invalidateIrJson();
+  irTableState = -1;
+  File f = WLED_FS.open("/ir.json", "r");
+  if (!f) return;
+  JsonArenaDoc irDoc(JSON_LOCK_IR);
+  if (!irDoc) {f.close(); irTableState = 0; return;} //try again with the next code
+
+  StaticJsonDocument<128> filter;
+  JsonObject keep = filter.createNestedObject("*");
+  keep["cmd"] = true; keep["rpt"] = true; keep["PL"] = true; keep["FX"] = true; keep["FP"] = true;
+  DeserializationError error = deserializeJson(*irDoc, f, DeserializationOption::Filter(filter));
+  f.close();
+  if (error) return;
+  JsonObject root = irDoc->as<JsonObject>();
+
+  uint16_t count = 0;
+  size_t poolLen = 0;
+  for (JsonPair kv : root) {
+    JsonVariant cmd = kv.value()["cmd"];
+    if      (cmd.is<const char*>()) poolLen += strlen(cmd.as<const char*>()) +5; //"win&" and terminator
+    else if (cmd.is<JsonObject>())  poolLen += measureJson(cmd) +1;
+    else continue;
+    count++;
+  }
+  if (!count || poolLen > UINT16_MAX) return;
+
+  uint16_t slots = 8;
+  while (slots < count*2) slots <<= 1; //load factor at most 1/2
+  irTable = (IrJsonEntry*) calloc(slots, sizeof(IrJsonEntry));
+  irCmdPool = (char*) malloc(poolLen);
+  if (!irTable || !irCmdPool) {invalidateIrJson(); return;}
+  irTableMask = slots -1;
+
+  uint16_t pos = 0;
+  for (JsonPair kv : root) {
+    JsonObject fdo = kv.value();
+    JsonVariant cmd = fdo["cmd"];
+    if (!cmd.is<const char*>() && !cmd.is<JsonObject>()) continue;
+    uint32_t code = strtoul(kv.key().c_str(), nullptr, 16);
+    uint16_t i = irTableSlot(code) & irTableMask;
+    while (irTable[i].used && irTable[i].code != code) i = (i + 1) & irTableMask;
+    IrJsonEntry& e = irTable[i];
+    e.used = true;
+    e.code = code;
+    e.cmd = pos;
+    e.rpt = fdo["rpt"];
+
+    if (cmd.is<JsonObject>()) {
+      e.type = IR_JSON_JSON;
+      pos += serializeJson(cmd, irCmdPool + pos, poolLen - pos) +1;
+      continue;
+    }
+    const char* cmdStr = cmd;
+    if (cmdStr[0] == '!') {
+      // limited set of C functions
+      if      (!strncmp_P(cmdStr, PSTR("!incBri"), 7))  {e.type = IR_JSON_INCBRI; e.rpt = true;}
+      else if (!strncmp_P(cmdStr, PSTR("!decBri"), 7))  {e.type = IR_JSON_DECBRI; e.rpt = true;}
+      else if (!strncmp_P(cmdStr, PSTR("!presetF"), 8)) { //!presetFallback
+        e.type = IR_JSON_PRESETF;
+        e.pl = fdo["PL"] ? fdo["PL"] : 1;
+        e.fx = fdo["FX"] | 0;
+        e.fp = fdo["FP"] | 0;
+      } else e.type = IR_JSON_NOP;
+      continue;
+    }
+    // HTTP API command, relative changes (~) repeat while the key is held
+    e.type = IR_JSON_HTTP;
+    if (strchr(cmdStr, '~')) e.rpt = true;
+    if (strncmp_P(cmdStr, PSTR("win&"), 4)) {
+      strcpy_P(irCmdPool + pos, PSTR("win&"));
+      pos += 4;
+    }
+    strcpy(irCmdPool + pos, cmdStr);
+    pos += strlen(cmdStr) +1;
+  }
+  irTableState = 1;
+}
+
 void decodeIRJson(uint32_t code) 
 {
-  char objKey[10];
-  const char* cmd;
-  String cmdStr;
-  DynamicJsonDocument irDoc(JSON_BUFFER_SIZE);
-  JsonObject fdo;
-  JsonObject jsonCmdObj;
-
-  sprintf(objKey, "\"0x%X\":", code);
-
-  readObjectFromFile("/ir.json", objKey, &irDoc);
-  fdo = irDoc.as<JsonObject>();
-  lastValidCode = 0;
-  if (fdo.isNull()) {
+  if (!irTableState) loadIrJson();
+  IrJsonEntry* e = findIrJson(code);
+  if (!e) {
     //the received code does not exist
-    if (!WLED_FS.exists("/ir.json")) errorFlag = ERR_FS_IRLOAD; //warn if IR file itself doesn't exist
+    if (irTableState < 0 && !WLED_FS.exists("/ir.json")) errorFlag = ERR_FS_IRLOAD; //warn if IR file itself doesn't exist
     return;
   }
-
-  cmd = fdo["cmd"]; //string
-  cmdStr = String(cmd);
-  jsonCmdObj = fdo["cmd"]; //object
-
-  if (!cmdStr.isEmpty()) 
-  {
-    if (cmdStr.startsWith("!")) {
-      // call limited set of C functions
-      if (cmdStr.startsWith(F("!incBri"))) {
-        lastValidCode = code;
-        incBrightness();
-      } else if (cmdStr.startsWith(F("!decBri"))) {
-        lastValidCode = code;
-        decBrightness();
-      } else if (cmdStr.startsWith(F("!presetF"))) { //!presetFallback
-        uint8_t p1 = fdo["PL"] ? fdo["PL"] : 1;
-        uint8_t p2 = fdo["FX"] ? fdo["FX"] : random8(MODE_COUNT);
-        uint8_t p3 = fdo["FP"] ? fdo["FP"] : 0;
-        presetFallback(p1, p2, p3);
-      }
-    } else {
-      // HTTP API command
-      if (cmdStr.indexOf("~") || fdo["rpt"]) 
-      {
-        // repeatable action
-        lastValidCode = code;
-      }
-      if (effectCurrent == 0 && cmdStr.indexOf("FP=") > -1) {
+  if (e->rpt) lastValidCode = code;
+  const char* cmd = irCmdPool + e->cmd;
+
+  switch (e->type) {
+    case IR_JSON_INCBRI:  incBrightness(); break;
+    case IR_JSON_DECBRI:  decBrightness(); break;
+    case IR_JSON_PRESETF: presetFallback(e->pl, e->fx ? e->fx : random8(MODE_COUNT), e->fp); break;
+    case IR_JSON_HTTP: {
+      if (effectCurrent == 0 && strstr_P(cmd, PSTR("FP="))) {
         // setting palette but it wont show because effect is solid
         effectCurrent = FX_MODE_GRADIENT;
       }
-      if (!cmdStr.startsWith("win&")) {
-        cmdStr = "win&" + cmdStr;
-      }
-      handleSet(nullptr, cmdStr, false); 
+      String cmdStr(cmd);
+      handleSet(nullptr, cmdStr, false);
+      break; }
+    case IR_JSON_JSON: {
+      // command is JSON object
+      JsonArenaDoc irDoc(JSON_LOCK_IR);
+      if (!irDoc) return;
+      if (deserializeJson(*irDoc, (const char*)cmd)) return;
+      //allow applyPreset() to reuse JSON buffer, or it would alloc. a second buffer and run out of mem.
+      fileDoc = irDoc.get();
+      deserializeState(irDoc->as<JsonObject>(), CALL_MODE_BUTTON);
+      fileDoc = nullptr;
+      return; }
+  }
+  colorUpdated(CALL_MODE_BUTTON);
+}
+
+#if defined(ARDUINO_ARCH_ESP32) && defined(WLED_USE_IR_RMT)
+/*
+ * The RMT peripheral captures a whole frame of edges without an interrupt per edge and puts it into
+ * the ring buffer of the driver once the line is idle, so handleIR() decodes it on the next loop pass.
+ * Only the NEC protocol used by the supported remotes is decoded, codes are the same as from IRremoteESP8266.
+ */
+#define IR_RMT_IDLE_US   12000 //longer than any gap within a frame, ends it
+#define IR_RMT_FILTER    100   //ignore glitches shorter than this (APB cycles)
+#define IR_NEC_HDR_MARK  9000
+#define IR_NEC_HDR_SPACE 4500
+#define IR_NEC_RPT_SPACE 2250
+#define IR_NEC_BIT_MARK  560
+#define IR_NEC_ONE_SPACE 1690
+#define IR_NEC_ZERO_SPACE 560
+
+static RingbufHandle_t irRing = nullptr;
+
+//duration d in us within 25% (+50us) of t
+static inline bool irMatch(uint16_t d, uint16_t t)
+{
+  uint16_t tol = (t >> 2) + 50;
+  return d + tol >= t && d <= t + tol;
+}
+
+//32 bit NEC code MSB first, 0xFFFFFFFF for a repeat frame or 0 if not NEC. Receivers are active low, so each item is mark then space
+static uint32_t irDecodeNec(const rmt_item32_t* it, size_t n)
+{
+  if (n < 2 || !irMatch(it[0].duration0, IR_NEC_HDR_MARK)) return 0;
+  if (irMatch(it[0].duration1, IR_NEC_RPT_SPACE)) return 0xFFFFFFFF;
+  if (!irMatch(it[0].duration1, IR_NEC_HDR_SPACE) || n < 33) return 0;
+  uint32_t code = 0;
+  for (uint8_t i = 1; i <= 32; i++) {
+    if (!irMatch(it[i].duration0, IR_NEC_BIT_MARK)) return 0;
+    if      (irMatch(it[i].duration1, IR_NEC_ONE_SPACE))  code = (code << 1) | 1;
+    else if (irMatch(it[i].duration1, IR_NEC_ZERO_SPACE)) code <<= 1;
+    else return 0;
+  }
+  return code;
+}
+
+void initIR()
+{
+  if (irEnabled == 0 || irPin < 0) return;
+  //filled field by field, RMT_DEFAULT_CONFIG_RX() only exists since IDF 4.1
+  rmt_config_t cfg;
+  memset(&cfg, 0, sizeof(cfg));
+  cfg.rmt_mode = RMT_MODE_RX;
+  cfg.channel = (rmt_channel_t)WLED_IR_RMT_CHANNEL;
+  cfg.gpio_num = (gpio_num_t)irPin;
+  cfg.clk_div = 80; //1us per tick
+  cfg.mem_block_num = 1;
+  cfg.rx_config.filter_en = true;
+  cfg.rx_config.filter_ticks_thresh = IR_RMT_FILTER;
+  cfg.rx_config.idle_threshold = IR_RMT_IDLE_US;
+  if (rmt_config(&cfg) != ESP_OK) return;
+  if (rmt_driver_install(cfg.channel, 1024, 0) != ESP_OK) return;
+  rmt_get_ringbuf_handle(cfg.channel, &irRing);
+  if (irRing) rmt_rx_start(cfg.channel, true);
+  else rmt_driver_uninstall(cfg.channel);
+}
+
+void handleIR()
+{
+  if (irEnabled == 0) {
+    if (irRing) {
+      rmt_rx_stop((rmt_channel_t)WLED_IR_RMT_CHANNEL);
+      rmt_driver_uninstall((rmt_channel_t)WLED_IR_RMT_CHANNEL);
+      irRing = nullptr;
     }
-    colorUpdated(CALL_MODE_BUTTON);
-  } else if (!jsonCmdObj.isNull()) {
-    // command is JSON object
-    //allow applyPreset() to reuse JSON buffer, or it would alloc. a second buffer and run out of mem.
-    fileDoc = &irDoc;
-    deserializeState(jsonCmdObj, CALL_MODE_BUTTON);
-    fileDoc = nullptr;
+    return;
+  }
+  if (!irRing) {
+    static unsigned long irInitTime = 0;
+    if (millis() - irInitTime < 1000) return; //pin or channel not available, try again later
+    irInitTime = millis();
+    initIR();
+    return;
+  }
+  size_t len = 0;
+  rmt_item32_t* items;
+  while ((items = (rmt_item32_t*) xRingbufferReceive(irRing, &len, 0))) {
+    uint32_t code = irDecodeNec(items, len / sizeof(rmt_item32_t));
+    vRingbufferReturnItem(irRing, items);
+    if (!code) continue;
+    Serial.print("IR recv\r\n0x");
+    Serial.println(code, HEX);
+    Serial.println();
+    decodeIR(code);
   }
 }
 
+#else
 void initIR()
 {
   if (irEnabled > 0)
@@ -668,5 +859,6 @@ void handleIR()
     }
   }
 }
+#endif
 
 #endif
@@ -1,6 +1,11 @@
 #include "wled.h"
 
 #include "palettes.h"
+#include <memory>
+#include <new>
+#ifdef ARDUINO_ARCH_ESP32
+#include <esp_heap_caps.h>
+#endif
 
 /*
  * JSON API (De)serialization
@@ -20,14 +25,16 @@ bool getVal(JsonVariant elem, byte* val, byte vmin=0, byte vmax=255) {
   return false; //key does not exist
 }
 
-void deserializeSegment(JsonObject elem, byte it, byte presetId)
+//returns true if the segment changed
+bool deserializeSegment(JsonObject elem, byte it, byte presetId)
 {
   byte id = elem["id"] | it;
-  if (id >= strip.getMaxSegments()) return;
+  if (id >= strip.getMaxSegments()) return false;
+  if (id >= strip.getSegmentCount() && (elem["stop"] | 1) == 0) return false; //deleting a segment that was never used
 
-  WS2812FX::Segment& seg = strip.getSegment(id);
-  //WS2812FX::Segment prev;
-  //prev = seg; //make a backup so we can tell if something changed
+  WS2812FX::Segment& seg = strip.getSegment(id); //allocates it if needed
+  WS2812FX::Segment prev = seg; //make a backup so we can tell if something changed
+  bool nameChanged = false;
 
   uint16_t start = elem["start"] | seg.start;
   int stop = elem["stop"] | -1;
@@ -37,34 +44,44 @@ void deserializeSegment(JsonObject elem, byte it, byte presetId)
   }
 
   if (elem["n"]) {
-    // name field exists
-    if (seg.name) { //clear old name
-      delete[] seg.name;
-      seg.name = nullptr;
-    }
-
+    // name field exists, an empty or too long one clears the name
     const char * name = elem["n"].as<const char*>();
-    size_t len = 0;
-    if (name != nullptr) len = strlen(name);
-    if (len > 0 && len < 33) {
-      seg.name = new char[len+1];
-      if (seg.name) strlcpy(seg.name, name, 33);
-    } else {
-      // but is empty (already deleted above)
-      elem.remove("n");
+    const char * prevName = strip.getSegmentName(id);
+    nameChanged = !prevName || !name || strcmp(prevName, name);
+    if (!strip.setSegmentName(id, name)) {
+      if (name && strlen(name) <= MAX_SEGMENT_NAME_LEN) errorFlag = ERR_NOMEM; //too long names are cleared on purpose
+      strip.setSegmentName(id, nullptr);
     }
+    if (!strip.getSegmentName(id)) elem.remove("n");
   } else if (start != seg.start || stop != seg.stop) {
     // clearing or setting segment without name field
-    if (seg.name) {
-      delete[] seg.name;
-      seg.name = nullptr;
-    }
+    nameChanged = strip.getSegmentName(id);
+    strip.setSegmentName(id, nullptr);
   }
 
   uint16_t grp = elem["grp"] | seg.grouping;
   uint16_t spc = elem[F("spc")] | seg.spacing;
   strip.setSegment(id, start, stop, grp, spc);
 
+  //2D matrix geometry
+  uint16_t mw = elem["w"] | seg.width;
+  uint16_t mh = elem["h"] | seg.height;
+  uint8_t layout = seg.layout;
+  if (elem.containsKey(F("serp"))) layout = (layout & ~SEG_2D_SERPENTINE) | (elem[F("serp")] ? SEG_2D_SERPENTINE : 0);
+  if (elem.containsKey("tp"))      layout = (layout & ~SEG_2D_TRANSPOSE)  | (elem["tp"] ? SEG_2D_TRANSPOSE : 0);
+  if (elem.containsKey(F("rot")))  layout = (layout & ~SEG_2D_ROTATION)   | (((elem[F("rot")] | 0) & 0x03) << 2);
+  strip.setSegmentGeometry(id, mw, mh, layout);
+
+  byte bm = elem["bm"] | seg.blendMode;
+  if (bm < SEG_BLEND_COUNT) seg.blendMode = bm;
+  int fps = elem[F("fps")] | (int)seg.fps;
+  seg.fps = constrain(fps, 0, 255); //above the strip frame rate anyway
+  seg.noiseShift = MIN(elem["nq"] | seg.noiseShift, SEG_NOISE_MAX_SHIFT);
+  strip.setSegmentScale(id, elem[F("rs")] | seg.scale);
+  int cln = elem[F("cln")] | -2; //-1 stops cloning
+  if (cln >= -1) seg.cloneSrc = (cln >= 0 && cln < strip.getMaxSegments() && cln != id) ? cln + 1 : 0;
+  seg.live = elem["rt"] | seg.live;
+
   uint16_t len = 1;
   if (stop > start) len = stop - start;
   int offset = elem[F("of")] | INT32_MAX;
@@ -145,6 +162,7 @@ void deserializeSegment(JsonObject elem, byte it, byte presetId)
   seg.setOption(SEG_OPTION_SELECTED, elem[F("sel")] | seg.getOption(SEG_OPTION_SELECTED));
   seg.setOption(SEG_OPTION_REVERSED, elem["rev"] | seg.getOption(SEG_OPTION_REVERSED));
   seg.setOption(SEG_OPTION_MIRROR  , elem[F("mi")]  | seg.getOption(SEG_OPTION_MIRROR  ));
+  seg.setOption(SEG_OPTION_TWEEN   , elem[F("tw")]  | seg.getOption(SEG_OPTION_TWEEN   ));
 
   //temporary, strip object gets updated via colorUpdated()
   if (id == strip.getMainSegmentId()) {
@@ -211,16 +229,112 @@ void deserializeSegment(JsonObject elem, byte it, byte presetId)
     }
     strip.setPixelSegment(255);
     strip.trigger();
+    return true;
   } else { //return to regular effect
     seg.setOption(SEG_OPTION_FREEZE, false);
   }
-  return; // seg.differs(prev);
+  return nameChanged || seg.differs(prev);
+}
+
+/*
+ * Binary pixel upload, the counterpart of the segment "i" array for large images (POST /json/px or binary WS message)
+ * Header: 'P', segment id, start offset (2 bytes, big endian), bytes per pixel (3 = RGB, 4 = RGBW), then packed pixel data.
+ * A message may arrive in chunks, pixels are written as they come in. Only one upload is handled at a time.
+ */
+#define PIXEL_UPLOAD_HEADER 5
+#define PIXEL_UPLOAD_TIMEOUT 2000 //ms after which an unfinished upload may be taken over
+
+static struct {
+  uint32_t owner;       //client id of the upload in progress, 0 if none
+  unsigned long start;
+  uint16_t pos;         //next pixel of the segment
+  uint8_t seg;
+  uint8_t bpp;
+  uint8_t carry[4];     //pixel split between two chunks
+  uint8_t carryLen;
+  uint32_t done;        //owner of the last completed upload
+} pixelUpload = {0};
+
+static void writeUploadPixel(const uint8_t* px)
+{
+  if (pixelUpload.pos >= strip.getSegment(pixelUpload.seg).length()) return; //excess data is ignored
+  strip.setPixelColor(pixelUpload.pos++, px[0], px[1], px[2], pixelUpload.bpp == 4 ? px[3] : 0);
+}
+
+//returns false if the upload was rejected
+bool handlePixelUpload(uint32_t owner, const uint8_t* data, size_t len, bool first, bool last)
+{
+  if (first) {
+    if (pixelUpload.done == owner) pixelUpload.done = 0;
+    if (pixelUpload.owner && pixelUpload.owner != owner && millis() - pixelUpload.start < PIXEL_UPLOAD_TIMEOUT) return false;
+    pixelUpload.owner = 0;
+    if (len < PIXEL_UPLOAD_HEADER || data[0] != 'P' || data[1] >= strip.getMaxSegments() || (data[4] != 3 && data[4] != 4)) return false;
+    if (!strip.getSegment(data[1]).isActive()) return false;
+    pixelUpload.owner = owner;
+    pixelUpload.start = millis();
+    pixelUpload.seg = data[1];
+    pixelUpload.pos = (data[2] << 8) | data[3];
+    pixelUpload.bpp = data[4];
+    pixelUpload.carryLen = 0;
+    data += PIXEL_UPLOAD_HEADER; len -= PIXEL_UPLOAD_HEADER;
+  } else if (pixelUpload.owner != owner) return false;
+
+  RENDER_LOCK();
+  WS2812FX::Segment& seg = strip.getSegment(pixelUpload.seg);
+  if (!seg.getOption(SEG_OPTION_FREEZE)) seg.setOption(SEG_OPTION_FREEZE, true); //the image replaces the effect, no need to clear it
+  strip.setPixelSegment(pixelUpload.seg);
+  const uint8_t bpp = pixelUpload.bpp;
+  if (pixelUpload.carryLen) {
+    while (pixelUpload.carryLen < bpp && len) { pixelUpload.carry[pixelUpload.carryLen++] = *data++; len--; }
+    if (pixelUpload.carryLen == bpp) { writeUploadPixel(pixelUpload.carry); pixelUpload.carryLen = 0; }
+  }
+  for (; len >= bpp; data += bpp, len -= bpp) writeUploadPixel(data);
+  memcpy(pixelUpload.carry + pixelUpload.carryLen, data, len);
+  pixelUpload.carryLen += len;
+  strip.setPixelSegment(255);
+
+  if (last) {
+    pixelUpload.owner = 0;
+    pixelUpload.done = owner;
+    strip.trigger();
+  }
+  return true;
+}
+
+//true if the last upload of this owner was received completely
+bool pixelUploadSucceeded(uint32_t owner) { return owner && pixelUpload.done == owner; }
+
+//top level state that colorUpdated() does not compare
+static uint32_t stateKey()
+{
+  return nightlightActive | (nightlightMode << 1) | (notifyDirect << 6) | (receiveNotifications << 7)
+    | (nightlightTargetBri << 8) | (nightlightDelayMins << 16) | (strip.getMainSegmentId() << 24);
+}
+
+//true if the request has keys whose effect is not checked for changes, e.g. presets, playlists or usermod state
+static bool hasActionKeys(JsonObject root)
+{
+  const char* diffKeys = " on bri transition tt nl udpn mainseg seg v ";
+  char key[12];
+  for (JsonPair kv : root) {
+    const char* k = kv.key().c_str();
+    if (strlen(k) > sizeof(key) - 3) return true;
+    snprintf_P(key, sizeof(key), PSTR(" %s "), k);
+    if (!strstr(diffKeys, key)) return true;
+  }
+  return false;
 }
 
 bool deserializeState(JsonObject root, byte callMode, byte presetId)
 {
+  RENDER_LOCK();
+  STATE_UPDATE(); //declared after the lock, so the update ends while it is held
   strip.applyToAllSelected = false;
   bool stateResponse = root[F("v")] | false;
+  //repeated identical requests (e.g. from home automation polling) must not cause WS/MQTT updates
+  //main segment colors, brightness and effect are compared by colorUpdated()
+  bool stateChanged = hasActionKeys(root);
+  uint32_t prevStateKey = stateKey();
 
   getVal(root["bri"], &bri);
 
@@ -234,6 +348,7 @@ bool deserializeState(JsonObject root, byte callMode, byte presetId)
     tr = root[F("transition")] | -1;
     if (tr >= 0)
     {
+      if (transitionDelay != tr * 100) stateChanged = true;
       transitionDelay = tr;
       transitionDelay *= 100;
       transitionDelayTemp = transitionDelay;
@@ -271,6 +386,13 @@ bool deserializeState(JsonObject root, byte callMode, byte presetId)
 
   doReboot = root[F("rb")] | doReboot;
 
+  if (root.containsKey(F("seed"))) strip.setRandomSeed(root[F("seed")] | 0); //reproducible effects, 0 for random ones
+  if (root.containsKey(F("bench"))) strip.startBenchmark(root[F("bench")] | 0); //frames per effect, 0 stops
+  if (root[F("lat")]) resetRealtimeLatency(); //starts a new realtime latency measurement
+  if (root.containsKey(F("busbench"))) startBusBenchmark(root[F("busbench")] | 0); //frames per bus, 0 stops
+  if (root.containsKey(F("fsbench"))) startFsBenchmark(root[F("fsbench")] | 0); //synthetic presets, 0 stops
+  if (root.containsKey(F("jsonbench"))) startJsonBenchmark(root[F("jsonbench")] | 0); //calls per payload, 0 stops
+
   realtimeOverride = root[F("lor")] | realtimeOverride;
   if (realtimeOverride > 2) realtimeOverride = REALTIME_OVERRIDE_ALWAYS;
 
@@ -280,12 +402,24 @@ bool deserializeState(JsonObject root, byte callMode, byte presetId)
     else    realtimeTimeout = 0; //cancel realtime mode immediately
   }
 
+  JsonObject fseq = root[F("fseq")];
+  if (!fseq.isNull()) {
+    const char* file = fseq[F("file")];
+    queueFseq(file, fseq[F("loop")] | false); //no file stops
+  } else if (presetId && fseqPlaying()) queueFseq(nullptr); //a preset or playlist entry without a show ends the running one
+
+  JsonObject rec = root[F("rec")];
+  if (!rec.isNull()) queueRecording(rec[F("file")]); //no file stops
+
+  if (root.containsKey(F("ledmap"))) strip.setLedmap(root[F("ledmap")]); //cached maps switch without reading the file
+
   byte prevMain = strip.getMainSegmentId();
   strip.mainSegment = root[F("mainseg")] | prevMain;
   if (strip.getMainSegmentId() != prevMain) setValuesFromMainSeg();
 
   int it = 0;
   JsonVariant segVar = root["seg"];
+  if (!segVar.isNull() && strip.isMorphing()) strip.stopMorph(); //segment changes end a running morph on its targets
   if (segVar.is<JsonObject>())
   {
     int id = segVar["id"] | -1;
@@ -293,27 +427,27 @@ bool deserializeState(JsonObject root, byte callMode, byte presetId)
     if (id < 0) { //set all selected segments
       bool didSet = false;
       byte lowestActive = 99;
-      for (byte s = 0; s < strip.getMaxSegments(); s++)
+      for (byte s = 0; s < strip.getSegmentCount(); s++)
       {
         WS2812FX::Segment sg = strip.getSegment(s);
         if (sg.isActive())
         {
           if (lowestActive == 99) lowestActive = s;
           if (sg.isSelected()) {
-            deserializeSegment(segVar, s, presetId);
+            if (deserializeSegment(segVar, s, presetId)) stateChanged = true;
             didSet = true;
           }
         }
       }
-      if (!didSet && lowestActive < strip.getMaxSegments()) deserializeSegment(segVar, lowestActive, presetId);
+      if (!didSet && lowestActive < strip.getMaxSegments() && deserializeSegment(segVar, lowestActive, presetId)) stateChanged = true;
     } else { //set only the segment with the specified ID
-      deserializeSegment(segVar, it, presetId);
+      if (deserializeSegment(segVar, it, presetId)) stateChanged = true;
     }
   } else {
     JsonArray segs = segVar.as<JsonArray>();
     for (JsonObject elem : segs)
     {
-      deserializeSegment(elem, it, presetId);
+      if (deserializeSegment(elem, it, presetId)) stateChanged = true;
       it++;
     }
   }
@@ -335,6 +469,15 @@ bool deserializeState(JsonObject root, byte callMode, byte presetId)
       deletePreset(ps);
     }
 
+    //"morph":{"ps":id,"dur":tenths of seconds} interpolates the segments to the preset (clears state request!)
+    JsonObject morph = root[F("morph")];
+    byte morphPs = morph["ps"] | 0;
+    if (morphPs) {
+      if (!presetId) unloadPlaylist();
+      morphToPreset(morphPs, (uint32_t)(morph[F("dur")] | 0) * 100, callMode);
+      return stateResponse;
+    }
+
     if (getVal(root["ps"], &presetCycCurr, 1, 5)) { //load preset (clears state request!)
       if (!presetId) unloadPlaylist(); //stop playlist if preset changed manually
       applyPreset(presetCycCurr, callMode);
@@ -354,11 +497,11 @@ bool deserializeState(JsonObject root, byte callMode, byte presetId)
   if (!playlist.isNull() && loadPlaylist(playlist, presetId)) {
     //do not notify here, because the first playlist entry will do
     noNotification = true;
-  } else {
+  } else if (stateChanged || stateKey() != prevStateKey) {
     interfaceUpdateCallMode = CALL_MODE_WS_SEND;
   }
 
-  colorUpdated(noNotification ? CALL_MODE_NO_NOTIFY : callMode);
+  colorUpdated(noNotification ? CALL_MODE_NO_NOTIFY : callMode); //no-op if main segment and brightness are unchanged
 
   return stateResponse;
 }
@@ -374,11 +517,25 @@ void serializeSegment(JsonObject& root, WS2812FX::Segment& seg, byte id, bool fo
   root["grp"] = seg.grouping;
   root[F("spc")] = seg.spacing;
   root[F("of")] = seg.offset;
+  if (seg.width) {
+    root["w"] = seg.width;
+    root["h"] = seg.height;
+    root[F("serp")] = (bool)(seg.layout & SEG_2D_SERPENTINE);
+    root["tp"] = (bool)(seg.layout & SEG_2D_TRANSPOSE);
+    root[F("rot")] = (seg.layout & SEG_2D_ROTATION) >> 2;
+  }
+  if (seg.blendMode) root["bm"] = seg.blendMode;
+  if (seg.fps) root[F("fps")] = seg.fps;
+  if (seg.noiseShift) root["nq"] = seg.noiseShift;
+  if (seg.cloneSrc) root[F("cln")] = seg.cloneSrc - 1;
+  if (seg.live) root["rt"] = true;
+  if (seg.scale > 1) root[F("rs")] = seg.scale;
   root["on"] = seg.getOption(SEG_OPTION_ON);
   byte segbri = seg.opacity;
   root["bri"] = (segbri) ? segbri : 255;
 
-  if (segmentBounds && seg.name != nullptr) root["n"] = reinterpret_cast<const char *>(seg.name); //not good practice, but decreases required JSON buffer
+  const char* name = strip.getSegmentName(id);
+  if (segmentBounds && name != nullptr) root["n"] = name; //stored as pointer into the name pool, not good practice, but decreases required JSON buffer
 
   char colstr[70]; colstr[0] = '['; colstr[1] = '\0'; //max len 68 (5 chan, all 255)
 
@@ -410,9 +567,10 @@ void serializeSegment(JsonObject& root, WS2812FX::Segment& seg, byte id, bool fo
 	root[F("sel")] = seg.isSelected();
 	root["rev"] = seg.getOption(SEG_OPTION_REVERSED);
   root[F("mi")]  = seg.getOption(SEG_OPTION_MIRROR);
+  if (seg.getOption(SEG_OPTION_TWEEN)) root[F("tw")] = true;
 }
 
-void serializeState(JsonObject root, bool forPreset, bool includeBri, bool segmentBounds)
+void serializeState(JsonObject root, bool forPreset, bool includeBri, bool segmentBounds, bool includeSegments)
 {
   if (includeBri) {
     root["on"] = (bri > 0);
@@ -447,9 +605,11 @@ void serializeState(JsonObject root, bool forPreset, bool includeBri, bool segme
   }
 
   root[F("mainseg")] = strip.getMainSegmentId();
+  root[F("ledmap")] = strip.getLedmap();
+  if (!includeSegments) return;
 
   JsonArray seg = root.createNestedArray("seg");
-  for (byte s = 0; s < strip.getMaxSegments(); s++)
+  for (byte s = 0; s < strip.getSegmentCount(); s++)
   {
     WS2812FX::Segment sg = strip.getSegment(s);
     if (sg.isActive())
@@ -483,6 +643,83 @@ int getSignalQuality(int rssi)
     return quality;
 }
 
+void serializePerfStat(JsonObject obj, const WS2812FX::PerfStat& perf)
+{
+  obj[F("min")] = perf.min;
+  obj[F("avg")] = perf.avg;
+  obj[F("max")] = perf.max;
+  obj["n"]      = perf.count;
+}
+
+//render and show timing in microseconds, also served as /json/perf
+void serializePerf(JsonObject root, bool includeBench)
+{
+  serializePerfStat(root.createNestedObject(F("show")), strip.getShowPerf());
+  serializePerfStat(root.createNestedObject(F("bus")), strip.getBusPerf());
+  JsonArray segs = root.createNestedArray("seg");
+  for (uint8_t s = 0; s < strip.getSegmentCount(); s++) {
+    if (!strip.getSegment(s).isActive()) continue;
+    const WS2812FX::SegmentPerf& perf = strip.getSegmentPerf(s);
+    if (!perf.fx.count) continue;
+    JsonObject seg = segs.createNestedObject();
+    seg["id"]     = s;
+    seg["fx"]     = perf.mode;
+    seg[F("fps")] = perf.fps;
+    serializePerfStat(seg, perf.fx);
+  }
+
+  //main loop: iteration time, time histogram (bin n: below 2^n ms), longest stretch without yield() and the subsystems per call
+  JsonObject loop = root.createNestedObject(F("loop"));
+  serializePerfStat(loop, loopPerf);
+  loop[F("ygap")] = loopYieldGapMax;
+  JsonArray hist = loop.createNestedArray(F("hist"));
+  for (uint8_t i = 0; i < LOOP_HIST_BINS; i++) hist.add(loopHist[i]);
+  const char* parts[LOOP_PERF_COUNT] = {"udp", "ir", "hue", "um", "fx", "ws"};
+  for (uint8_t i = 0; i < LOOP_PERF_COUNT; i++) {
+    if (loopPartPerf[i].count) serializePerfStat(loop.createNestedObject(parts[i]), loopPartPerf[i]);
+  }
+
+  //parse time per packet of each realtime protocol seen since boot (Adalight: per frame)
+  JsonArray rt = root.createNestedArray("rt");
+  for (uint8_t m = REALTIME_MODE_UDP; m <= REALTIME_MODE_DDP; m++) {
+    if (!realtimePerf[m].count) continue;
+    JsonObject proto = rt.createNestedObject();
+    proto["m"] = m;
+    serializePerfStat(proto, realtimePerf[m]);
+    unsigned long elapsed = millis() - realtimePerfSince[m];
+    proto["pps"] = elapsed ? (uint32_t)((uint64_t)realtimePerf[m].count * 1000 / elapsed) : 0;
+  }
+
+  //realtime frame latency from the first packet received to the busses done sending, per stage
+  if (realtimeLatency[LATENCY_TOTAL].count) {
+    JsonObject lat = root.createNestedObject(F("lat"));
+    const char* stages[LATENCY_STAGES] = {"queue", "show", "latch", "total"};
+    for (uint8_t i = 0; i < LATENCY_STAGES; i++) serializePerfStat(lat.createNestedObject(stages[i]), realtimeLatency[i]);
+    JsonArray hist = lat.createNestedArray(F("hist"));
+    for (uint8_t i = 0; i < LOOP_HIST_BINS; i++) hist.add(realtimeLatencyHist[i]);
+  }
+
+  serializeFsBenchmark(root);
+  serializeJsonBenchmark(root);
+  serializeBusBenchmark(root);
+
+  //effect benchmark, [us per frame, ns per pixel, data bytes] per mode
+  const WS2812FX::BenchResult* bench = strip.getBenchmark();
+  if (!bench || !includeBench) return;
+  JsonObject jbench = root.createNestedObject(F("bench"));
+  jbench[F("run")] = strip.isBenchmarkRunning();
+  jbench["fx"]     = strip.getBenchmarkMode();
+  uint16_t len = strip.getBenchmarkLength();
+  jbench[F("len")] = len;
+  JsonArray res = jbench.createNestedArray(F("res"));
+  for (uint8_t m = 0; m < strip.getModeCount(); m++) {
+    JsonArray r = res.createNestedArray();
+    r.add(bench[m].us);
+    r.add(len ? bench[m].us * 1000 / len : 0);
+    r.add(bench[m].data);
+  }
+}
+
 void serializeInfo(JsonObject root)
 {
   root[F("ver")] = versionString;
@@ -496,9 +733,26 @@ void serializeInfo(JsonObject root)
   leds[F("pwr")] = strip.currentMilliamps;
   leds[F("fps")] = strip.getFps();
   leds[F("maxpwr")] = (strip.currentMilliamps)? strip.ablMilliampsMax : 0;
+  JsonArray leds_buspwr = leds.createNestedArray(F("buspwr")); //current estimate per bus
+  for (uint8_t b = 0; b < busses.getNumBusses(); b++) leds_buspwr.add(strip.currentMilliamps ? busses.getBus(b)->milliamps : 0);
+  JsonArray leds_busus = leds.createNestedArray(F("busus")); //time each bus blocked the loop in show(), us
+  for (uint8_t b = 0; b < busses.getNumBusses(); b++) leds_busus.add(busses.getBus(b)->showMicros);
   leds[F("maxseg")] = strip.getMaxSegments();
   leds[F("seglock")] = false; //will be used in the future to prevent modifications to segment config
 
+  JsonObject leds_net = leds.createNestedObject("net");
+  leds_net["pps"] = udpOutPacketsPerSec; //realtime packets sent by network busses per second
+  leds_net["tx"] = udpOutPackets;
+  leds_net[F("err")] = udpOutErrors;
+  leds_net[F("rxlost")] = udpInLost;     //realtime packets lost on the way in (sequence gaps)
+  leds_net[F("rxskip")] = udpInSkipped;  //queued frames skipped in favour of a newer one
+
+  JsonObject e131info = root.createNestedObject(F("e131"));
+  e131info[F("partial")] = e131PartialFrames; //multi-universe frames shown incomplete
+  e131info[F("drop")] = e131DroppedFrames;    //frames overwritten before they were shown
+  e131info["us"] = e131IngestMicros;          //average microseconds to ingest one universe
+  e131info[F("sync")] = e131LastSync && millis() - e131LastSync < E131_SYNC_TIMEOUT; //output latched by sync packets
+
   root[F("str")] = syncToggleReceive;
 
   root[F("name")] = serverDescription;
@@ -515,6 +769,7 @@ void serializeInfo(JsonObject root)
     case REALTIME_MODE_ARTNET:   root["lm"] = F("Art-Net"); break;
     case REALTIME_MODE_TPM2NET:  root["lm"] = F("tpm2.net"); break;
     case REALTIME_MODE_DDP:      root["lm"] = F("DDP"); break;
+    case REALTIME_MODE_FSEQ:     root["lm"] = F("FSEQ"); break;
   }
 
   if (realtimeIP[0] == 0)
@@ -523,6 +778,7 @@ void serializeInfo(JsonObject root)
   } else {
     root[F("lip")] = realtimeIP.toString();
   }
+  serializeRecorderInfo(root);
 
   #ifdef WLED_ENABLE_WEBSOCKETS
   root[F("ws")] = ws.count();
@@ -532,6 +788,7 @@ void serializeInfo(JsonObject root)
 
   root[F("fxcount")] = strip.getModeCount();
   root[F("palcount")] = strip.getPaletteCount();
+  root[F("cpalcount")] = strip.getCustomPaletteCount(); //the last palette ids, from /paletteN.bin
 
   JsonObject wifi_info = root.createNestedObject("wifi");
   wifi_info[F("bssid")] = WiFi.BSSIDstr();
@@ -546,6 +803,7 @@ void serializeInfo(JsonObject root)
   fs_info[F("pmt")] = presetsModifiedTime;
 
   root[F("ndc")] = nodeListEnabled ? (int)Nodes.size() : -1;
+  serializeVStrip(root);
   
   #ifdef ARDUINO_ARCH_ESP32
   #ifdef WLED_DEBUG
@@ -571,8 +829,48 @@ void serializeInfo(JsonObject root)
   #endif
 
   root[F("freeheap")] = ESP.getFreeHeap();
+  JsonObject heap = root.createNestedObject(F("heap")); //free bytes and largest free block of each heap
+  #ifdef ARDUINO_ARCH_ESP32
+  heap[F("int")]    = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+  heap[F("intlfb")] = heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+  heap[F("dma")]    = heap_caps_get_free_size(MALLOC_CAP_DMA);
+  #ifdef WLED_USE_PSRAM
+  if (psramFound()) {
+    heap[F("ps")]     = ESP.getFreePsram();
+    heap[F("pslfb")]  = heap_caps_get_largest_free_block(MALLOC_CAP_SPIRAM);
+    heap[F("pssize")] = ESP.getPsramSize();
+  }
+  #endif
+  #else
+  heap[F("int")]    = ESP.getFreeHeap();
+  heap[F("intlfb")] = ESP.getMaxFreeBlockSize();
+  #endif
+  heap[F("frag")]   = heapFragmentation(); //% of the free internal RAM outside the largest block
+  heap[F("rej")]    = heapRejects;         //JSON requests answered with 503 below the watermark
+  heap[F("wsfail")] = wsBufferFails;
+  heap[F("rspfail")] = responseFails;
+  SegmentArena& arena = strip.getSegmentArena();
+  JsonObject segmem = root.createNestedObject(F("segmem")); //segment data arena, bytes
+  segmem[F("size")] = arena.size();
+  segmem[F("used")] = arena.used();
+  segmem[F("peak")] = arena.peak();
+  segmem[F("lfb")]  = arena.largestFree();
+  segmem[F("fail")] = arena.fails();
+
+  serializeWatchdog(root);
+
+  JsonObject jbuf = root.createNestedObject(F("jbuf"));
+  jbuf[F("wait")] = jsonArenaWaits;
+  jbuf[F("fail")] = jsonArenaFails;
   root[F("uptime")] = millis()/1000 + rolloverMillis*4294967;
 
+  JsonObject boot = root.createNestedObject(F("boot"));
+  boot[F("frame")] = bootFirstFrame;                       //ms after power-up until the first frame
+  JsonArray phases = boot.createNestedArray(F("phase"));   //duration of each boot phase in ms
+  for (uint8_t i = 0; i < BOOT_PHASE_DONE; i++) phases.add(bootPhaseMillis[i]);
+
+  serializePerf(root.createNestedObject(F("perf")), false);
+
 
   usermods.addToJsonInfo(root);
 
@@ -669,6 +967,11 @@ void serializePalettes(JsonObject root, AsyncWebServerRequest* request)
   }
 
   int palettesCount = strip.getPaletteCount();
+  int fixedCount = palettesCount - strip.getCustomPaletteCount(); //custom palettes follow
+  if (request->hasParam("rt")) { //the gradient palettes are also in /palettes.json
+    palettesCount -= fixedCount - 13;
+    fixedCount = 13;
+  }
 
   int maxPage = (palettesCount -1) / itemPerPage;
   if (page > maxPage) page = maxPage;
@@ -680,7 +983,8 @@ void serializePalettes(JsonObject root, AsyncWebServerRequest* request)
   root[F("m")] = maxPage;
   JsonObject palettes  = root.createNestedObject("p");
 
-  for (int i = start; i < end; i++) {
+  for (int k = start; k < end; k++) {
+    int i = (k < fixedCount) ? k : k - fixedCount + 13 + GRADIENT_PALETTE_COUNT;
     JsonArray curPalette = palettes.createNestedArray(String(i));
     CRGB prim;
     CRGB sec;
@@ -754,6 +1058,10 @@ void serializePalettes(JsonObject root, AsyncWebServerRequest* request)
         if (i < 13) {
           break;
         }
+        if (i >= 13 + GRADIENT_PALETTE_COUNT) {
+          setPaletteColors(curPalette, strip.getCustomPalette(i - 13 - GRADIENT_PALETTE_COUNT));
+          break;
+        }
         byte tcp[72];
         memcpy_P(tcp, (byte*)pgm_read_dword(&(gGradientPalettes[i - 13])), 72);
         setPaletteColors(curPalette, tcp);
@@ -766,22 +1074,224 @@ void serializeNodes(JsonObject root)
 {
   JsonArray nodes = root.createNestedArray("nodes");
 
-  for (NodesMap::iterator it = Nodes.begin(); it != Nodes.end(); ++it)
+  for (uint16_t i = 0; i < Nodes.capacity(); i++)
   {
-    if (it->second.ip[0] != 0)
+    NodeStruct& n = Nodes[i];
+    if (n.used && n.ip[0] != 0)
     {
       JsonObject node = nodes.createNestedObject();
-      node[F("name")] = it->second.nodeName;
-      node["type"]    = it->second.nodeType;
-      node["ip"]      = it->second.ip.toString();
-      node[F("age")]  = it->second.age;
-      node[F("vid")]  = it->second.build;
+      node[F("name")] = n.nodeName;
+      node["type"]    = n.nodeType;
+      node["ip"]      = n.ip.toString();
+      node[F("age")]  = n.age;
+      node[F("vid")]  = n.build;
     }
   }
 }
 
+//serialized state, shared by /json/state, WebSocket and serial replies until stateVersion changes
+#ifndef STATE_CACHE_MAX_AGE
+  #define STATE_CACHE_MAX_AGE 1000 //ms, for values that change on their own (nightlight time left)
+#endif
+static std::shared_ptr<String> stateCache;
+static uint32_t stateCacheVersion = 0;
+static uint32_t stateCacheHash = 0;
+static unsigned long stateCacheTime = 0;
+#ifdef ARDUINO_ARCH_ESP32
+static portMUX_TYPE stateCacheMux = portMUX_INITIALIZER_UNLOCKED; //loop and async_tcp read it
+#endif
+
+//returns the serialized state, nullptr if out of memory. hash receives its content hash (the ETag)
+std::shared_ptr<String> getStateText(uint32_t* hash)
+{
+  std::shared_ptr<String> text;
+  #ifdef ARDUINO_ARCH_ESP32
+  portENTER_CRITICAL(&stateCacheMux);
+  #endif
+  bool valid = stateCache && stateCacheVersion == stateVersion && millis() - stateCacheTime < STATE_CACHE_MAX_AGE;
+  if (valid) text = stateCache; //only the reference count changes
+  uint32_t ver = stateCacheVersion;
+  uint32_t textHash = stateCacheHash;
+  #ifdef ARDUINO_ARCH_ESP32
+  portEXIT_CRITICAL(&stateCacheMux);
+  #endif
+  if (valid) {
+    if (hash) *hash = textHash;
+    return text;
+  }
+
+  ver = stateVersion;
+  {
+    JsonArenaDoc doc(JSON_LOCK_STATE);
+    if (!doc) return nullptr;
+    serializeState(doc->to<JsonObject>());
+    text = std::make_shared<String>();
+    if (!text || !text->reserve(measureJson(*doc) +1)) return nullptr;
+    serializeJson(*doc, *text);
+  }
+  textHash = 2166136261UL; //FNV-1a
+  for (const char* c = text->c_str(); *c; c++) textHash = (textHash ^ (uint8_t)*c) * 16777619UL;
+  //expired without a known change but the text differs: cached WebSocket copies are outdated as well
+  if (ver == stateCacheVersion && textHash != stateCacheHash && ver == stateVersion) ver = ++stateVersion;
+
+  std::shared_ptr<String> old = text;
+  #ifdef ARDUINO_ARCH_ESP32
+  portENTER_CRITICAL(&stateCacheMux);
+  #endif
+  stateCache.swap(old);
+  stateCacheVersion = ver;
+  stateCacheHash = textHash;
+  stateCacheTime = millis();
+  #ifdef ARDUINO_ARCH_ESP32
+  portEXIT_CRITICAL(&stateCacheMux);
+  #endif
+  //the previous text is released here, outside of the critical section
+  if (hash) *hash = textHash;
+  return text;
+}
+
+//GET /json/state, answered with 304 if the client has the current version
+static void serveStateText(AsyncWebServerRequest* request, std::shared_ptr<String> text, uint32_t hash)
+{
+  char etag[12];
+  snprintf_P(etag, sizeof(etag), PSTR("\"%08x\""), (unsigned)hash); //quoted as per RFC 7232, stays valid across reboots
+  if (handleIfNoneMatchCacheHeader(request, etag)) return;
+  AsyncWebServerResponse *response = request->beginResponse("application/json", text->length(),
+    [text](uint8_t *buffer, size_t maxLen, size_t index) -> size_t {
+      size_t len = MIN(maxLen, text->length() - index);
+      memcpy(buffer, text->c_str() + index, len);
+      return len;
+    });
+  response->addHeader(F("Cache-Control"), "no-cache");
+  response->addHeader(F("ETag"), etag);
+  request->send(response);
+}
+
+#define JSON_SECTION_SIZE 3072 //document size for a single streamed /json section
+
+//writes /json as a sequence of small sections (state without segments, one segment at a time, info,
+//effect and palette names from flash) so only one section is held in RAM while the response is sent
+class JsonStreamer {
+  private:
+    uint8_t _subJson;  // 0: all, 1: state, 2: info, 3: state and info
+    uint8_t _step = 0;
+    uint8_t _seg = 0;
+    bool _firstSeg = true;
+    String _chunk;              // serialized text of the current section
+    size_t _pos = 0;
+    const char* _pgm = nullptr; // section streamed straight from flash
+    size_t _pgmLen = 0;
+
+    void serializeSection(JsonDocument& doc, bool stripClose) {
+      serializeJson(doc, _chunk);
+      if (stripClose) _chunk.remove(_chunk.length() -1); // object continues with the segments
+    }
+
+    //prepares the next section, returns false when the response is complete
+    bool nextSection() {
+      _chunk = "";
+      _pos = 0;
+      _pgm = nullptr;
+      bool all = (_subJson == 0 || _subJson == 3);
+      switch (_step) {
+        case 0: //state without segments
+          _step++;
+          if (_subJson == 2) return nextSection();
+          {
+            PSRAMDynamicJsonDocument doc(JSON_SECTION_SIZE);
+            serializeState(doc.to<JsonObject>(), false, true, true, false);
+            if (all) _chunk = F("{\"state\":");
+            serializeSection(doc, true);
+            _chunk += F(",\"seg\":[");
+          }
+          return true;
+        case 1: //one active segment per call
+          if (_subJson == 2) { _step++; return nextSection(); }
+          while (_seg < strip.getSegmentCount() && !strip.getSegment(_seg).isActive()) _seg++;
+          if (_seg >= strip.getSegmentCount()) {
+            _step++;
+            _chunk = F("]}");
+            return true;
+          }
+          {
+            PSRAMDynamicJsonDocument doc(JSON_SECTION_SIZE);
+            JsonObject seg0 = doc.to<JsonObject>();
+            serializeSegment(seg0, strip.getSegment(_seg), _seg);
+            if (!_firstSeg) _chunk = ",";
+            serializeSection(doc, false);
+          }
+          _firstSeg = false;
+          _seg++;
+          return true;
+        case 2: //info
+          _step++;
+          if (_subJson == 1) return nextSection();
+          {
+            PSRAMDynamicJsonDocument doc(JSON_SECTION_SIZE);
+            serializeInfo(doc.to<JsonObject>());
+            if (all) _chunk = F(",\"info\":");
+            serializeSection(doc, false);
+          }
+          return true;
+        case 3:
+          _step++;
+          if (_subJson != 0) return nextSection();
+          _chunk = F(",\"effects\":");
+          _pgm = JSON_mode_names;
+          _pgmLen = strlen_P(JSON_mode_names);
+          return true;
+        case 4:
+          _step++;
+          if (_subJson != 0) return nextSection();
+          _chunk = F(",\"palettes\":");
+          _pgm = JSON_palette_names;
+          _pgmLen = strlen_P(JSON_palette_names);
+          return true;
+        case 5:
+          _step++;
+          if (!all) return nextSection();
+          _chunk = "}";
+          return true;
+      }
+      return false;
+    }
+
+  public:
+    JsonStreamer(uint8_t subJson) : _subJson(subJson) {}
+
+    //fills the chunked response buffer, 0 ends the response
+    size_t fill(uint8_t* buffer, size_t maxLen) {
+      size_t len = 0;
+      while (len < maxLen) {
+        size_t chunkLen = _chunk.length();
+        if (_pos < chunkLen) {
+          size_t n = chunkLen - _pos;
+          if (n > maxLen - len) n = maxLen - len;
+          memcpy(buffer + len, _chunk.c_str() + _pos, n);
+          _pos += n; len += n;
+        } else if (_pgm && _pos < chunkLen + _pgmLen) {
+          size_t n = chunkLen + _pgmLen - _pos;
+          if (n > maxLen - len) n = maxLen - len;
+          memcpy_P(buffer + len, _pgm + (_pos - chunkLen), n);
+          _pos += n; len += n;
+        } else if (!nextSection()) break;
+      }
+      return len;
+    }
+};
+
+//keeps the borrowed JSON arena until the response has been sent
+class ArenaJsonResponse : public AsyncJsonResponse {
+  private:
+    JsonArenaDoc* _arena;
+  public:
+    ArenaJsonResponse(JsonArenaDoc* arena) : AsyncJsonResponse(arena->get()), _arena(arena) {}
+    ~ArenaJsonResponse() { delete _arena; }
+};
+
 void serveJson(AsyncWebServerRequest* request)
 {
+  TRACE_SCOPE(TRACE_HTTP, 0);
   byte subJson = 0;
   const String& url = request->url();
   if      (url.indexOf("state") > 0) subJson = 1;
@@ -789,6 +1299,8 @@ void serveJson(AsyncWebServerRequest* request)
   else if (url.indexOf("si")    > 0) subJson = 3;
   else if (url.indexOf("nodes") > 0) subJson = 4;
   else if (url.indexOf("palx")  > 0) subJson = 5;
+  else if (url.indexOf(F("perf")) > 0) subJson = 6;
+  else if (url.indexOf(F("plan")) > 0) subJson = 7;
   else if (url.indexOf("live")  > 0) {
     serveLiveLeds(request);
     return;
@@ -809,29 +1321,50 @@ void serveJson(AsyncWebServerRequest* request)
     return;
   }
 
-  AsyncJsonResponse* response = new AsyncJsonResponse(JSON_BUFFER_SIZE);
+  if (subJson == 1) {
+    uint32_t hash;
+    std::shared_ptr<String> text = getStateText(&hash);
+    if (text) {
+      serveStateText(request, text, hash);
+      return;
+    }
+  }
+
+  if (subJson < 4) { //state, info and effect/palette names are streamed section by section
+    std::shared_ptr<JsonStreamer> streamer = std::make_shared<JsonStreamer>(subJson);
+    AsyncWebServerResponse *response = request->beginChunkedResponse("application/json",
+      [streamer](uint8_t *buffer, size_t maxLen, size_t index) -> size_t {
+        return streamer->fill(buffer, maxLen);
+      });
+    request->send(response);
+    return;
+  }
+
+  JsonArenaDoc* arena = new (std::nothrow) JsonArenaDoc(JSON_LOCK_SERVE);
+  if (!arena || !*arena) {
+    delete arena;
+    request->send(503, "application/json", F("{\"error\":3}"));
+    return;
+  }
+  AsyncJsonResponse* response = new (std::nothrow) ArenaJsonResponse(arena);
+  if (!response) {
+    delete arena;
+    responseFails++;
+    request->send(503, "application/json", F("{\"error\":3}"));
+    return;
+  }
   JsonObject doc = response->getRoot();
 
   switch (subJson)
   {
-    case 1: //state
-      serializeState(doc); break;
-    case 2: //info
-      serializeInfo(doc); break;
     case 4: //node list
       serializeNodes(doc); break;
     case 5: //palettes
       serializePalettes(doc, request); break;
-    default: //all
-      JsonObject state = doc.createNestedObject("state");
-      serializeState(state);
-      JsonObject info = doc.createNestedObject("info");
-      serializeInfo(info);
-      if (subJson != 3)
-      {
-        doc[F("effects")]  = serialized((const __FlashStringHelper*)JSON_mode_names);
-        doc[F("palettes")] = serialized((const __FlashStringHelper*)JSON_palette_names);
-      }
+    case 6: //render timing
+      serializePerf(doc); break;
+    case 7: //LED memory planner
+      serializeLedPlan(doc); break;
   }
 
   DEBUG_PRINT("JSON buffer size: ");
@@ -843,19 +1376,11 @@ void serveJson(AsyncWebServerRequest* request)
 
 #define MAX_LIVE_LEDS 180
 
-bool serveLiveLeds(AsyncWebServerRequest* request, uint32_t wsClient)
+//writes the live LED JSON into buffer (LIVE_LEDS_JSON_SIZE bytes), returns its length
+uint16_t serializeLiveLeds(char* buffer)
 {
-  AsyncWebSocketClient * wsc = nullptr;
-  if (!request) { //not HTTP, use Websockets
-    #ifdef WLED_ENABLE_WEBSOCKETS
-    wsc = ws.client(wsClient);
-    if (!wsc || wsc->queueLength() > 0) return false; //only send if queue free
-    #endif
-  }
-
   uint16_t used = strip.getLengthTotal();
   uint16_t n = (used -1) /MAX_LIVE_LEDS +1; //only serve every n'th LED if count over MAX_LIVE_LEDS
-  char buffer[2000];
   strcpy_P(buffer, PSTR("{\"leds\":["));
   obuf = buffer;
   olen = 9;
@@ -868,12 +1393,27 @@ bool serveLiveLeds(AsyncWebServerRequest* request, uint32_t wsClient)
   oappend((const char*)F("],\"n\":"));
   oappendi(n);
   oappend("}");
+  return olen;
+}
+
+bool serveLiveLeds(AsyncWebServerRequest* request, uint32_t wsClient)
+{
+  AsyncWebSocketClient * wsc = nullptr;
+  if (!request) { //not HTTP, use Websockets
+    #ifdef WLED_ENABLE_WEBSOCKETS
+    wsc = ws.client(wsClient);
+    if (!wsc || wsc->queueLength() > 0) return false; //only send if queue free
+    #endif
+  }
+
+  char buffer[LIVE_LEDS_JSON_SIZE];
+  uint16_t len = serializeLiveLeds(buffer);
   if (request) {
     request->send(200, "application/json", buffer);
   }
   #ifdef WLED_ENABLE_WEBSOCKETS
   else {
-    wsc->text(obuf, olen);
+    wsc->text(buffer, len);
   }
   #endif
   return true;
@@ -0,0 +1,144 @@
+#include "wled.h"
+
+/*
+ * JSON state API benchmark: times deserializeState() and serializeState() with representative payloads
+ * on the device itself, {"jsonbench":n} runs each case n times (up to 100), results are part of /json/perf.
+ *   bri    brightness change
+ *   noop   the same brightness again, caught by the no-op detection
+ *   preset 32 segments (as many as the strip allows) with colors and effect settings
+ *   pixels "i" array of up to 256 hex colors for segment 0
+ *   ser    full state serialized
+ * One case runs per loop pass, without notifications. The state before the benchmark is restored afterwards.
+ * The heap column is the free heap lost over all calls of a case, so it shows leaks rather than peak use.
+ */
+#ifdef WLED_ENABLE_JSONBENCH
+
+#define JSONBENCH_MAX      100
+#define JSONBENCH_SEGMENTS 32
+#define JSONBENCH_PIXELS   256
+
+enum { JB_BRI, JB_NOOP, JB_PRESET, JB_PIXELS, JB_SER, JB_CASES };
+
+static volatile int16_t jbRequest = -1;  //set by the JSON API, started by loop()
+static uint8_t jbRuns = 0;
+static uint8_t jbCase = JB_CASES;        //next case to run, JB_CASES when idle
+static bool jbFailed = false;            //no memory for the documents
+static WS2812FX::PerfStat jbPerf[JB_CASES];
+static int32_t jbHeap[JB_CASES];
+static uint16_t jbDocSize[JB_CASES];     //bytes of the payload document
+static PSRAMDynamicJsonDocument* jbSaved = nullptr;
+
+void startJsonBenchmark(uint8_t runs)
+{
+  jbRequest = MIN(runs, JSONBENCH_MAX);
+}
+
+static void jbPayload(uint8_t c, JsonObject root)
+{
+  switch (c) {
+    case JB_BRI:
+    case JB_NOOP:
+      root["bri"] = bri == 128 ? 129 : 128;
+      break;
+    case JB_PRESET: {
+      root["on"] = true;
+      root["bri"] = 200;
+      JsonArray segs = root.createNestedArray("seg");
+      uint16_t len = strip.getLengthTotal();
+      uint8_t n = MIN(MIN((uint16_t)JSONBENCH_SEGMENTS, (uint16_t)strip.getMaxSegments()), len);
+      for (uint8_t i = 0; i < n; i++) {
+        JsonObject seg = segs.createNestedObject();
+        seg["id"] = i;
+        seg[F("start")] = (uint32_t)len * i / n;
+        seg[F("stop")]  = (uint32_t)len * (i + 1) / n;
+        JsonArray col = seg.createNestedArray("col");
+        for (uint8_t s = 0; s < 3; s++) {
+          JsonArray rgb = col.createNestedArray();
+          rgb.add((i * 40 + s * 80) & 0xFF); rgb.add((i * 17) & 0xFF); rgb.add(255 - i);
+        }
+        seg["fx"] = i % 40; seg["sx"] = 128; seg["ix"] = 100; seg["pal"] = i % 20;
+      }
+      break;
+    }
+    case JB_PIXELS: {
+      JsonObject seg = root.createNestedObject("seg");
+      JsonArray px = seg.createNestedArray("i");
+      uint16_t n = MIN(strip.getSegment(0).length(), (uint16_t)JSONBENCH_PIXELS);
+      for (uint16_t i = 0; i < n; i++) px.add(i & 1 ? "FF8000" : "0040FF");
+      break;
+    }
+  }
+}
+
+static void jbFinish()
+{
+  if (jbSaved) {
+    deserializeState(jbSaved->as<JsonObject>(), CALL_MODE_NO_NOTIFY);
+    delete jbSaved;
+    jbSaved = nullptr;
+  }
+  jbCase = JB_CASES;
+}
+
+void handleJsonBenchmark()
+{
+  if (jbRequest >= 0) {
+    jbRuns = jbRequest;
+    jbRequest = -1;
+    jbFinish();
+    for (uint8_t c = 0; c < JB_CASES; c++) { jbPerf[c].reset(); jbHeap[c] = 0; jbDocSize[c] = 0; }
+    jbFailed = false;
+    if (!jbRuns) return;
+    jbSaved = new PSRAMDynamicJsonDocument(JSON_BUFFER_SIZE);
+    if (!jbSaved || !jbSaved->capacity()) { delete jbSaved; jbSaved = nullptr; jbFailed = true; return; }
+    serializeState(jbSaved->to<JsonObject>(), true, true, true); //like a preset, so segments the cases add are removed again
+    jbCase = 0;
+  }
+  if (jbCase >= JB_CASES) return;
+
+  PSRAMDynamicJsonDocument doc(JSON_BUFFER_SIZE);
+  if (!doc.capacity()) { jbFailed = true; jbFinish(); return; }
+  JsonObject root = doc.to<JsonObject>();
+  if (jbCase != JB_SER) jbPayload(jbCase, root);
+  if (jbCase == JB_NOOP) deserializeState(root, CALL_MODE_NO_NOTIFY); //from then on nothing changes
+  jbDocSize[jbCase] = doc.memoryUsage();
+
+  uint32_t heapStart = ESP.getFreeHeap();
+  for (uint8_t r = 0; r < jbRuns; r++) {
+    if (jbCase == JB_BRI) root["bri"] = (r & 1) ? 128 : 129;
+    uint32_t start = micros();
+    if (jbCase == JB_SER) {
+      doc.clear();
+      serializeState(doc.to<JsonObject>());
+    } else {
+      deserializeState(root, CALL_MODE_NO_NOTIFY);
+    }
+    jbPerf[jbCase].add(micros() - start);
+    yield();
+  }
+  if (jbCase == JB_SER) jbDocSize[jbCase] = doc.memoryUsage();
+  jbHeap[jbCase] = (int32_t)heapStart - (int32_t)ESP.getFreeHeap();
+  if (++jbCase == JB_CASES) jbFinish();
+}
+
+void serializeJsonBenchmark(JsonObject root)
+{
+  if (!jbRuns && !jbFailed) return;
+  JsonObject bench = root.createNestedObject(F("jsonbench"));
+  bench[F("run")] = jbCase < JB_CASES;
+  bench["n"] = jbRuns;
+  if (jbFailed) bench[F("err")] = true;
+  const char* cases[JB_CASES] = {"bri", "noop", "preset", "pixels", "ser"};
+  for (uint8_t c = 0; c < JB_CASES; c++) {
+    if (!jbPerf[c].count) continue;
+    JsonObject res = bench.createNestedObject(cases[c]);
+    serializePerfStat(res, jbPerf[c]);
+    res[F("doc")]  = jbDocSize[c];
+    res[F("heap")] = jbHeap[c];
+  }
+}
+#else
+void startJsonBenchmark(uint8_t runs) {}
+void handleJsonBenchmark() {}
+void serializeJsonBenchmark(JsonObject root) {}
+#endif
@@ -57,7 +57,7 @@ void setAllLeds() {
   {
     col[3] = 0; colSec[3] = 0;
   }
-  if (!realtimeMode || !arlsForceMaxBri)
+  if (!realtimeMode || !arlsForceMaxBri || strip.hasLiveSegments())
   {
     strip.setBrightness(scaledBri(briT));
   }
@@ -84,17 +84,72 @@ bool colorChanged()
 }
 
 
-void colorUpdated(int callMode)
+#if defined(ARDUINO_ARCH_ESP32) && !defined(WLED_DISABLE_PWM_HW_FADE)
+//arms the fade on all busses if every one of them can do it and no segment is animated
+static bool canHardwareFade()
 {
+  if (realtimeMode) return false;
+  for (uint8_t i = 0; i < strip.getSegmentCount(); i++) {
+    WS2812FX::Segment& seg = strip.getSegment(i);
+    if (seg.isActive() && seg.mode != FX_MODE_STATIC) return false;
+  }
+  if (busses.setFadeTime(transitionDelayTemp)) return true;
+  busses.setFadeTime(0);
+  return false;
+}
+
+//state changes of one request are applied as a whole: rendered in one frame, with one colorUpdated() at the end
+static int  stateUpdateMode = -1;   //call mode of the colorUpdated() deferred to endStateUpdate(), -1 for none
+static bool stateUpdateSegs = false;
+
+//a deferred call that notifies is not replaced by a later one that does not
+static uint8_t callModeRank(int callMode)
+{
+  switch (callMode) {
+    case CALL_MODE_INIT:      return 0;
+    case CALL_MODE_WS_SEND:   return 1;
+    case CALL_MODE_NO_NOTIFY: return 2;
+    default:                  return 3;
+  }
+}
+
+void beginStateUpdate()
+{
+  strip.beginUpdate();
+}
+
+void endStateUpdate()
+{
+  strip.endUpdate();
+  if (strip.inStateUpdate() || stateUpdateMode < 0) return;
+  int callMode = stateUpdateMode;
+  stateUpdateMode = -1;
+  colorUpdated(callMode, stateUpdateSegs);
+}
+
+//segmentsSet: segments were already set one by one (segment sync), only the main segment follows the globals
+void colorUpdated(int callMode, bool segmentsSet)
+{
+  stateVersion++; //serialized state is outdated
+  powerWake();
+  RENDER_LOCK();
+  if (strip.inStateUpdate()) { //the last call of the strongest call mode counts
+    if (stateUpdateMode < 0 || callModeRank(callMode) >= callModeRank(stateUpdateMode)) {
+      stateUpdateMode = callMode;
+      stateUpdateSegs = segmentsSet;
+    }
+    return;
+  }
   //call for notifier -> 0: init 1: direct change 2: button 3: notification 4: nightlight 5: other (No notification)
   //                     6: fx changed 7: hue 8: preset cycle 9: blynk 10: alexa
-  if (callMode != CALL_MODE_INIT && 
+  if (segmentsSet) strip.applyToAllSelected = false;
+  else if (callMode != CALL_MODE_INIT && 
       callMode != CALL_MODE_DIRECT_CHANGE && 
       callMode != CALL_MODE_NO_NOTIFY) strip.applyToAllSelected = true; //if not from JSON api, which directly sets segments
 
   bool someSel = false;
 
-  if (callMode == CALL_MODE_NOTIFICATION) {
+  if (callMode == CALL_MODE_NOTIFICATION && !segmentsSet) {
     someSel = (receiveNotificationBrightness || receiveNotificationColor || receiveNotificationEffects);
   }
   
@@ -114,6 +169,7 @@ void colorUpdated(int callMode)
     currentPreset = 0; //something changed, so we are no longer in the preset
         
     notify(callMode);
+    usermods.publish(UM_EVENT_STATE, callMode);
     
     //set flag to update blynk, ws and mqtt
     interfaceUpdateCallMode = callMode;
@@ -158,15 +214,25 @@ void colorUpdated(int callMode)
     jsonTransitionOnce = false;
     strip.setTransition(transitionDelayTemp);
     if (transitionDelayTemp == 0) {setLedsStandard(); strip.trigger(); return;}
-    
-    if (transitionActive)
-    {
-      briOld = briT;
-      tperLast = 0;
+
+    #if defined(ARDUINO_ARCH_ESP32) && !defined(WLED_DISABLE_PWM_HW_FADE)
+    //static colors on PWM only: the LEDC hardware ramps to the new duty, the loop does not need to step the transition
+    if (canHardwareFade()) {
+      strip.setTransition(0);
+      strip.setTransitionMode(false);
+      transitionActive = false;
+      setLedsStandard();
+      strip.trigger();
+      return;
     }
+    #endif
+    
+    if (transitionActive) briOld = briT;
     strip.setTransitionMode(true);
     transitionActive = true;
     transitionStartTime = millis();
+    transitionLastStep = transitionStartTime;
+    setAllLeds(); //colors fade in the segments, handleTransitions() only steps the brightness
   } else
   {
     strip.setTransition(0);
@@ -199,6 +265,7 @@ void updateInterfaces(uint8_t callMode)
 
 void handleTransitions()
 {
+  RENDER_LOCK();
   //handle still pending interface update
   if (interfaceUpdateCallMode && millis() - lastInterfaceUpdate > 2000)
   {
@@ -209,26 +276,30 @@ void handleTransitions()
   
   if (transitionActive && transitionDelayTemp > 0)
   {
-    float tper = (millis() - transitionStartTime)/(float)transitionDelayTemp;
-    if (tper >= 1.0)
+    uint32_t elapsed = millis() - transitionStartTime;
+    if (elapsed >= transitionDelayTemp)
     {
       strip.setTransitionMode(false);
       transitionActive = false;
-      tperLast = 0;
       setLedsStandard();
       return;
     }
-    if (tper - tperLast < 0.004) return;
-    tperLast = tper;
-    briT    = briOld   +((bri    - briOld   )*tper);
-    
-    setAllLeds();
+    //once per frame is enough, the brightness is not applied before the next one is shown
+    if (millis() - transitionLastStep < strip.getFrameTime()) return;
+    transitionLastStep = millis();
+
+    uint32_t prog = (elapsed * 0xFFFF) / transitionDelayTemp +1; //same 16 bit progress as the segment color transitions
+    byte briNew = ((bri * prog) + (briOld * (0x10000 - prog))) >> 16;
+    if (briNew == briT) return;
+    briT = briNew;
+    if (!realtimeMode || !arlsForceMaxBri || strip.hasLiveSegments()) strip.setBrightness(scaledBri(briT));
   }
 }
 
 
 void handleNightlight()
 {
+  RENDER_LOCK();
   if (nightlightActive)
   {
     if (!nightlightActiveOld) //init
@@ -256,17 +327,29 @@ void handleNightlight()
         colorUpdated(CALL_MODE_NO_NOTIFY);
       }
     }
-    float nper = (millis() - nightlightStartTime)/((float)nightlightDelayMs);
+    uint32_t elapsed = millis() - nightlightStartTime;
+    bool nlDone = (elapsed >= nightlightDelayMs);
+    //the ramp is stepped once per frame, a step between frames would not be shown
+    if (!nlDone && millis() - nightlightLastStep < strip.getFrameTime()) return;
+    nightlightLastStep = millis();
     if (nightlightMode == NL_MODE_FADE || nightlightMode == NL_MODE_COLORFADE)
     {
-      bri = briNlT + ((nightlightTargetBri - briNlT)*nper);
+      //same 16 bit progress as the transitions, only applied if the brightness or color actually changes
+      uint32_t prog = nlDone ? 0x10000 : ((uint64_t)elapsed << 16) / nightlightDelayMs;
+      byte briNew = (briNlT * (0x10000 - prog) + nightlightTargetBri * prog) >> 16;
+      bool nlChanged = (briNew != bri);
+      bri = briNew;
       if (nightlightMode == NL_MODE_COLORFADE)                                         // color fading only is enabled with "NF=2"
       {
-        for (byte i=0; i<4; i++) col[i] = colNlT[i]+ ((colSec[i] - colNlT[i])*nper);   // fading from actual color to secondary color
+        for (byte i=0; i<4; i++) {                                                     // fading from actual color to secondary color
+          byte c = (colNlT[i] * (0x10000 - prog) + colSec[i] * prog) >> 16;
+          if (c != col[i]) nlChanged = true;
+          col[i] = c;
+        }
       }
-      colorUpdated(CALL_MODE_NO_NOTIFY);
+      if (nlChanged) colorUpdated(CALL_MODE_NO_NOTIFY);
     }
-    if (nper >= 1) //nightlight duration over
+    if (nlDone) //nightlight duration over
     {
       nightlightActive = false;
       if (nightlightMode == NL_MODE_SET)
@@ -7,6 +7,17 @@
 #ifdef WLED_ENABLE_MQTT
 #define MQTT_KEEP_ALIVE_TIME 60    // contact the MQTT broker every 60 seconds
 
+static char* mqttPayload = nullptr;     // WLED_MQTT_PAYLOAD_MAX +1 bytes, allocated with the first message
+static char* mqttBigPayload = nullptr;  // message that does not fit, freed once handled
+
+//what was published last, only topics whose values changed are sent again
+typedef struct MqttPublished {
+  uint8_t bri, col[4], fx, sx, ix, pal, ps;
+} MqttPublished;
+static MqttPublished mqttLast;
+static bool mqttPublishAll = true;      // after (re)connecting, as the broker may have lost retained values
+static unsigned long mqttLastPublish = 0;
+
 void parseMQTTBriPayload(char* payload)
 {
   if      (strstr(payload, "ON") || strstr(payload, "on") || strstr(payload, "true")) {bri = briLast; colorUpdated(1);}
@@ -47,11 +58,19 @@ void onMqttConnect(bool sessionPresent)
 
   usermods.onMqttConnect(sessionPresent);
 
+  mqttPublishAll = true;
   doPublishMqtt = true;
   DEBUG_PRINTLN(F("MQTT ready"));
 }
 
 
+//the shared buffer is kept for the next message
+static void freeMqttPayload()
+{
+  delete[] mqttBigPayload;
+  mqttBigPayload = nullptr;
+}
+
 void onMqttMessage(char* topic, char* payload, AsyncMqttClientMessageProperties properties, size_t len, size_t index, size_t total) {
 
   DEBUG_PRINT(F("MQTT msg: "));
@@ -62,11 +81,20 @@ void onMqttMessage(char* topic, char* payload, AsyncMqttClientMessageProperties
     DEBUG_PRINTLN(F("no payload -> leave"));
     return;
   }
-  //make a copy of the payload to 0-terminate it
-  char* payloadStr = new char[len+1];
-  if (payloadStr == nullptr) return; //no mem
-  strncpy(payloadStr, payload, len);
-  payloadStr[len] = '\0';
+  //copy the payload to 0-terminate it and to put together messages that arrive in parts
+  if (!mqttPayload) {
+    mqttPayload = (char*) malloc(WLED_MQTT_PAYLOAD_MAX +1);
+    if (!mqttPayload) return; //no mem
+  }
+  if (index == 0) {
+    delete[] mqttBigPayload; //previous message was incomplete
+    mqttBigPayload = (total > WLED_MQTT_PAYLOAD_MAX) ? new char[total+1] : nullptr;
+  }
+  char* payloadStr = (total > WLED_MQTT_PAYLOAD_MAX) ? mqttBigPayload : mqttPayload;
+  if (payloadStr == nullptr || index + len > total) return; //no mem or inconsistent parts
+  memcpy(payloadStr + index, payload, len);
+  if (index + len < total) return; //wait for the rest
+  payloadStr[total] = '\0';
   DEBUG_PRINTLN(payloadStr);
 
   size_t topicPrefixLen = strlen(mqttDeviceTopic);
@@ -79,7 +107,7 @@ void onMqttMessage(char* topic, char* payload, AsyncMqttClientMessageProperties
     } else {
       // Non-Wled Topic used here. Probably a usermod subscribed to this topic.
       usermods.onMqttMessage(topic, payloadStr);
-      delete[] payloadStr;
+      freeMqttPayload();
       return;
     }
   }
@@ -90,11 +118,12 @@ void onMqttMessage(char* topic, char* payload, AsyncMqttClientMessageProperties
     colorFromDecOrHexString(col, (char*)payloadStr);
     colorUpdated(CALL_MODE_DIRECT_CHANGE);
   } else if (strcmp_P(topic, PSTR("/api")) == 0) {
-    if (payload[0] == '{') { //JSON API
-      DynamicJsonDocument doc(JSON_BUFFER_SIZE);
-      deserializeJson(doc, payloadStr);
-      fileDoc = &doc;
-      deserializeState(doc.as<JsonObject>());
+    if (payloadStr[0] == '{') { //JSON API
+      JsonArenaDoc doc(JSON_LOCK_MQTT);
+      if (!doc) {freeMqttPayload(); return;}
+      deserializeJson(*doc, payloadStr);
+      fileDoc = doc.get();
+      deserializeState(doc->as<JsonObject>());
       fileDoc = nullptr;
     } else { //HTTP API
       String apireq = "win&";
@@ -108,32 +137,60 @@ void onMqttMessage(char* topic, char* payload, AsyncMqttClientMessageProperties
     // topmost topic (just wled/MAC)
     parseMQTTBriPayload(payloadStr);
   }
-  delete[] payloadStr;
+  freeMqttPayload();
 }
 
 
+//publishes what changed since the last call, at most every mqttPublishInterval ms.
+//doPublishMqtt stays set until then, so the latest state always goes out
 void publishMqtt()
 {
+  if (!WLED_MQTT_CONNECTED) {doPublishMqtt = false; return;}
+  if (!mqttPublishAll && millis() - mqttLastPublish < mqttPublishInterval) return;
   doPublishMqtt = false;
-  if (!WLED_MQTT_CONNECTED) return;
+  mqttLastPublish = millis();
+
+  MqttPublished now;
+  now.bri = bri;
+  memcpy(now.col, col, 4);
+  now.fx = effectCurrent; now.sx = effectSpeed; now.ix = effectIntensity; now.pal = effectPalette;
+  now.ps = currentPreset;
+  if (!mqttPublishAll && !memcmp(&now, &mqttLast, sizeof(now))) return; //nothing changed
   DEBUG_PRINTLN(F("Publish MQTT"));
 
-  char s[10];
+  char s[112];
   char subuf[38];
 
-  sprintf_P(s, PSTR("%u"), bri);
-  strlcpy(subuf, mqttDeviceTopic, 33);
-  strcat_P(subuf, PSTR("/g"));
-  mqtt->publish(subuf, 0, true, s);
+  if (mqttPublishAll || now.bri != mqttLast.bri) {
+    sprintf_P(s, PSTR("%u"), bri);
+    strlcpy(subuf, mqttDeviceTopic, 33);
+    strcat_P(subuf, PSTR("/g"));
+    mqtt->publish(subuf, 0, true, s);
+  }
 
-  sprintf_P(s, PSTR("#%06X"), (col[3] << 24) | (col[0] << 16) | (col[1] << 8) | (col[2]));
+  if (mqttPublishAll || memcmp(now.col, mqttLast.col, 4)) {
+    sprintf_P(s, PSTR("#%06X"), (col[3] << 24) | (col[0] << 16) | (col[1] << 8) | (col[2]));
+    strlcpy(subuf, mqttDeviceTopic, 33);
+    strcat_P(subuf, PSTR("/c"));
+    mqtt->publish(subuf, 0, true, s);
+  }
+
+  if (mqttPublishAll) {
+    strlcpy(subuf, mqttDeviceTopic, 33);
+    strcat_P(subuf, PSTR("/status"));
+    mqtt->publish(subuf, 0, true, "online");
+  }
+
+  //compact JSON state in one retained message
+  snprintf_P(s, sizeof(s), PSTR("{\"on\":%s,\"bri\":%u,\"col\":[%u,%u,%u,%u],\"fx\":%u,\"sx\":%u,\"ix\":%u,\"pal\":%u,\"ps\":%d}"),
+    bri ? "true" : "false", bri, col[0], col[1], col[2], col[3], effectCurrent, effectSpeed, effectIntensity, effectPalette,
+    currentPreset ? currentPreset : -1);
   strlcpy(subuf, mqttDeviceTopic, 33);
-  strcat_P(subuf, PSTR("/c"));
+  strcat_P(subuf, PSTR("/state"));
   mqtt->publish(subuf, 0, true, s);
 
-  strlcpy(subuf, mqttDeviceTopic, 33);
-  strcat_P(subuf, PSTR("/status"));
-  mqtt->publish(subuf, 0, true, "online");
+  mqttLast = now;
+  mqttPublishAll = false;
 
   char apires[1024];
   XML_response(nullptr, apires);
@@ -143,6 +200,24 @@ void publishMqtt()
 }
 
 
+//loop profile as JSON to <topic>/perf, sent every 30s if built with WLED_MQTT_PERF
+void publishMqttPerf()
+{
+  #ifdef WLED_MQTT_PERF
+  if (!WLED_MQTT_CONNECTED) return;
+  char s[160];
+  char subuf[38];
+  int len = snprintf_P(s, sizeof(s), PSTR("{\"avg\":%u,\"max\":%u,\"ygap\":%u,\"hist\":["), loopPerf.avg, loopPerf.max, loopYieldGapMax);
+  for (uint8_t i = 0; i < LOOP_HIST_BINS && len < (int)sizeof(s); i++)
+    len += snprintf_P(s + len, sizeof(s) - len, PSTR("%s%u"), i ? "," : "", loopHist[i]);
+  if (len < (int)sizeof(s) -2) strcat(s, "]}");
+  strlcpy(subuf, mqttDeviceTopic, 33);
+  strcat_P(subuf, PSTR("/perf"));
+  mqtt->publish(subuf, 0, false, s);
+  #endif
+}
+
+
 //HA autodiscovery was removed in favor of the native integration in HA v0.102.0
 
 bool initMqtt()
@@ -178,4 +253,5 @@ bool initMqtt()
 #else
 bool initMqtt(){return false;}
 void publishMqtt(){}
+void publishMqttPerf(){}
 #endif
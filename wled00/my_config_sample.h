@@ -22,4 +22,5 @@
 #define CLIENT_PASS "Your_Password"
 */
 
-//#define MAX_LEDS 1500       //Maximum total LEDs. More than 1500 might create a low memory situation on ESP8266.
\ No newline at end of file
+//#define MAX_LEDS 1500       //Maximum total LEDs. More than 1500 might create a low memory situation on ESP8266.
+//#define WLED_ENABLE_LARGE_STRIP //ESP32 with PSRAM (WLED_USE_PSRAM): up to 32768 LEDs by default, mostly for network busses
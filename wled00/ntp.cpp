@@ -312,55 +312,184 @@ byte weekdayMondayFirst()
   return wd;
 }
 
-void checkTimers()
+/*
+ * Timer scheduler. The 10 timers of the time settings page and any number of extra timers from /timers.json
+ * are compiled into a list, and the next time each one fires is kept in a min-heap.
+ * checkTimers() only compares the earliest one with the current time.
+ * /timers.json holds an array of timers, with the cfg.json keys ("en","hour","min","macro","dow") and an optional
+ * date range "start"/"end" as [month,day]. Hour 24 fires every hour, 255 is sunrise and 254 sunset (min is the offset then).
+ */
+typedef struct TimerEntry {
+  uint8_t  hour;   // 0-23, TIMER_HOUR_*
+  int8_t   min;
+  uint8_t  preset;
+  uint8_t  dow;    // bit 0 Monday ... bit 6 Sunday
+  uint16_t start;  // month*32+day of the first day, 0 for every day
+  uint16_t end;    // month*32+day of the last day
+} TimerEntry;
+
+typedef struct TimerEvent {
+  time_t   next;   // local time the timer fires next
+  uint16_t timer;
+} TimerEvent;
+
+static TimerEntry* timerList = nullptr;
+static TimerEvent* timerHeap = nullptr;
+static uint16_t timerCount = 0, timerHeapLen = 0;
+static bool timersLoaded = false, timersScheduled = false;
+
+//timer settings or /timers.json changed
+void invalidateTimers()
 {
-  if (lastTimerMinute != minute(localTime)) //only check once a new minute begins
-  {
-    lastTimerMinute = minute(localTime);
+  timersLoaded = false;
+}
 
-    // re-calculate sunrise and sunset just after midnight
-    if (!hour(localTime) && minute(localTime)==1) calculateSunriseAndSunset();
+static void addTimer(uint8_t hour, int8_t min, uint8_t preset, uint8_t dow, uint16_t start = 0, uint16_t end = 0)
+{
+  if (!preset || !(dow & 0x7F) || timerCount >= WLED_MAX_TIMERS) return;
+  TimerEntry& t = timerList[timerCount++];
+  t.hour = hour; t.min = min; t.preset = preset; t.dow = dow;
+  t.start = start; t.end = end;
+}
 
-    DEBUG_PRINTF("Local time: %02d:%02d\n", hour(localTime), minute(localTime));
-    for (uint8_t i = 0; i < 8; i++)
-    {
-      if (timerMacro[i] != 0
-          && (timerHours[i] == hour(localTime) || timerHours[i] == 24) //if hour is set to 24, activate every hour 
-          && timerMinutes[i] == minute(localTime)
-          && (timerWeekday[i] & 0x01) //timer is enabled
-          && ((timerWeekday[i] >> weekdayMondayFirst()) & 0x01)) //timer should activate at current day of week
-      {
-        applyPreset(timerMacro[i]);
-      }
-    }
-    // sunrise macro
-    if (sunrise) {
-      time_t tmp = sunrise + timerMinutes[8]*60;  // NOTE: may not be ok
-      DEBUG_PRINTF("Trigger time: %02d:%02d\n", hour(tmp), minute(tmp));
-      if (timerMacro[8] != 0
-          && hour(tmp) == hour(localTime)
-          && minute(tmp) == minute(localTime)
-          && (timerWeekday[8] & 0x01) //timer is enabled
-          && ((timerWeekday[8] >> weekdayMondayFirst()) & 0x01)) //timer should activate at current day of week
-      {
-        applyPreset(timerMacro[8]);
-        DEBUG_PRINTF("Sunrise macro %d triggered.",timerMacro[8]);
-      }
+static void loadTimers()
+{
+  File f = WLED_FS.open("/timers.json", "r");
+  JsonArenaDoc doc(JSON_LOCK_TIMERS);
+  if (f && !doc) {f.close(); return;} //try again with the next tick
+  JsonArray extra;
+  if (f) {
+    //only the keys of a timer are kept, names and notes of the entries are skipped while parsing
+    StaticJsonDocument<192> filter;
+    JsonObject keep = filter.createNestedObject();
+    keep["en"] = true; keep[F("hour")] = true; keep["min"] = true; keep["macro"] = true; keep[F("dow")] = true;
+    keep[F("start")] = true; keep["end"] = true;
+    DeserializationError error = deserializeJson(*doc, f, DeserializationOption::Filter(filter));
+    if (!error) extra = doc->as<JsonArray>();
+    f.close();
+  }
+
+  free(timerList); timerList = nullptr;
+  free(timerHeap); timerHeap = nullptr;
+  timerCount = timerHeapLen = 0;
+  timersLoaded = true;
+  timersScheduled = false;
+
+  uint16_t n = 10 + extra.size();
+  if (n > WLED_MAX_TIMERS) n = WLED_MAX_TIMERS;
+  timerList = (TimerEntry*) malloc(n * sizeof(TimerEntry));
+  timerHeap = (TimerEvent*) malloc(n * sizeof(TimerEvent));
+  if (!timerList || !timerHeap) {
+    free(timerList); timerList = nullptr;
+    free(timerHeap); timerHeap = nullptr;
+    return;
+  }
+
+  for (uint8_t i = 0; i < 10; i++) {
+    if (!(timerWeekday[i] & 0x01)) continue; //timer is disabled
+    uint8_t hr = (i < 8) ? timerHours[i] : (i == 8 ? TIMER_HOUR_SUNRISE : TIMER_HOUR_SUNSET);
+    addTimer(hr, timerMinutes[i], timerMacro[i], timerWeekday[i] >> 1);
+  }
+  for (JsonObject timer : extra) {
+    if (!timer["en"].isNull() && !timer["en"].as<bool>()) continue;
+    JsonArray st = timer[F("start")], en = timer["end"];
+    uint16_t start = st.isNull() ? 0 : (st[0].as<uint8_t>() << 5) + st[1].as<uint8_t>();
+    uint16_t end   = en.isNull() ? 0 : (en[0].as<uint8_t>() << 5) + en[1].as<uint8_t>();
+    addTimer(timer[F("hour")] | 0, timer["min"] | 0, timer["macro"] | 0, timer[F("dow")] | 0x7F, start, end);
+  }
+  DEBUG_PRINTF("Timers: %u\n", timerCount);
+}
+
+static bool timerDayMatches(const TimerEntry& t, time_t midnight)
+{
+  uint8_t wd = weekday(midnight) -1; //0 Sunday
+  wd = wd ? wd -1 : 6;               //0 Monday
+  if (!((t.dow >> wd) & 0x01)) return false;
+  if (!t.start) return true;
+  uint16_t md = (month(midnight) << 5) + day(midnight);
+  if (t.start <= t.end) return md >= t.start && md <= t.end;
+  return md >= t.start || md <= t.end; //range over new year
+}
+
+// first time after "after" the timer fires, 0 if it never does
+static time_t nextTimerTime(const TimerEntry& t, time_t after)
+{
+  if (t.hour == TIMER_HOUR_SUNRISE && !sunrise) return 0;
+  if (t.hour == TIMER_HOUR_SUNSET  && !sunset)  return 0;
+  if (t.hour > 24 && t.hour < TIMER_HOUR_SUNSET) return 0;
+  time_t midnight = previousMidnight(after);
+  for (uint16_t d = 0; d < 367; d++, midnight += SECS_PER_DAY) { //a date range may only match once a year
+    if (!timerDayMatches(t, midnight)) continue;
+    time_t next;
+    if (t.hour == TIMER_HOUR_EVERY) {
+      next = midnight + (t.min * 60);
+      while (next <= after && next < midnight + SECS_PER_DAY) next += SECS_PER_HOUR;
+      if (next >= midnight + SECS_PER_DAY) continue;
+      return next;
     }
-    // sunset macro
-    if (sunset) {
-      time_t tmp = sunset + timerMinutes[9]*60;  // NOTE: may not be ok
-      DEBUG_PRINTF("Trigger time: %02d:%02d\n", hour(tmp), minute(tmp));
-      if (timerMacro[9] != 0
-          && hour(tmp) == hour(localTime)
-          && minute(tmp) == minute(localTime)
-          && (timerWeekday[9] & 0x01) //timer is enabled
-          && ((timerWeekday[9] >> weekdayMondayFirst()) & 0x01)) //timer should activate at current day of week
-      {
-        applyPreset(timerMacro[9]);
-        DEBUG_PRINTF("Sunset macro %d triggered.",timerMacro[9]);
-      }
+    if (t.hour >= TIMER_HOUR_SUNSET) { //sun times change by a few minutes per day, they are rescheduled daily
+      next = midnight + elapsedSecsToday(t.hour == TIMER_HOUR_SUNRISE ? sunrise : sunset) + t.min * 60;
+      next -= next % 60; //timers fire as the minute begins
+    } else {
+      next = midnight + t.hour * SECS_PER_HOUR + t.min * 60;
     }
+    if (next > after) return next;
+  }
+  return 0;
+}
+
+static void timerSiftDown(uint16_t i)
+{
+  while (true) {
+    uint16_t c = 2*i +1;
+    if (c >= timerHeapLen) return;
+    if (c +1 < timerHeapLen && timerHeap[c +1].next < timerHeap[c].next) c++;
+    if (timerHeap[i].next <= timerHeap[c].next) return;
+    TimerEvent tmp = timerHeap[i]; timerHeap[i] = timerHeap[c]; timerHeap[c] = tmp;
+    i = c;
+  }
+}
+
+static void scheduleTimers()
+{
+  timersScheduled = true;
+  timerHeapLen = 0;
+  if (!timerHeap) return;
+  for (uint16_t i = 0; i < timerCount; i++) {
+    time_t next = nextTimerTime(timerList[i], localTime -1); //a timer of the current second still fires
+    if (!next) continue;
+    timerHeap[timerHeapLen].next = next;
+    timerHeap[timerHeapLen].timer = i;
+    timerHeapLen++;
+  }
+  for (int16_t i = timerHeapLen/2 -1; i >= 0; i--) timerSiftDown(i);
+}
+
+void checkTimers()
+{
+  static time_t lastCheck = 0;
+  static uint8_t lastDay = 0;
+
+  // a jump of the clock (NTP sync, DST) must not fire everything that is now in the past
+  if (localTime < lastCheck || localTime - lastCheck > 120) timersScheduled = false;
+  lastCheck = localTime;
+
+  // re-calculate sunrise and sunset once the date changes, calculateSunriseAndSunset() reschedules
+  if (lastDay != day(localTime)) {
+    lastDay = day(localTime);
+    calculateSunriseAndSunset();
+  }
+
+  if (!timersLoaded) loadTimers();
+  if (!timersScheduled) scheduleTimers();
+
+  while (timerHeapLen && timerHeap[0].next <= localTime) {
+    const TimerEntry& t = timerList[timerHeap[0].timer];
+    DEBUG_PRINTF("Timer %u: preset %d\n", timerHeap[0].timer, t.preset);
+    applyPreset(t.preset);
+    timerHeap[0].next = nextTimerTime(t, timerHeap[0].next);
+    if (!timerHeap[0].next) timerHeap[0] = timerHeap[--timerHeapLen];
+    timerSiftDown(0);
   }
 }
 
@@ -449,6 +578,7 @@ void calculateSunriseAndSunset() {
       sunset = 0;
     }
   }
+  timersScheduled = false;
 }
 
 //time from JSON and HTTP API
@@ -4,28 +4,43 @@
  * Used to draw clock overlays over the strip
  */
  
-void initCronixie()
+/*
+ * Overlays are computed once per second into a list of pixel ranges, which handleOverlayDraw()
+ * draws over the output on every show(). The effects are only triggered again if the list changed,
+ * so the pixels the overlay no longer covers show the effect again.
+ */
+#define OVERLAY_MAX_SPANS 24
+
+struct OverlaySpan {
+  uint16_t start;
+  uint16_t stop; //inclusive
+  uint32_t color;
+};
+
+static OverlaySpan overlaySpans[OVERLAY_MAX_SPANS];
+static byte numOverlaySpans = 0;
+
+static void addOverlaySpan(int start, int stop, uint32_t color)
 {
-  if (overlayCurrent == 3 && dP[0] == 255) //if dP[0] is 255, cronixie is not yet init'ed
-  {
-    setCronixie();
-    strip.getSegment(0).grouping = 10; //10 LEDs per digit
-  } else if (dP[0] < 255 && overlayCurrent != 3)
-  {
-    strip.getSegment(0).grouping = 1;
-    dP[0] = 255; 
-  }
+  if (numOverlaySpans >= OVERLAY_MAX_SPANS || start < 0 || stop < 0) return;
+  overlaySpans[numOverlaySpans++] = {(uint16_t)start, (uint16_t)stop, color};
 }
 
-
-//handleOverlays is essentially the equivalent of usermods.loop
+//handleOverlays is essentially the equivalent of usermods.loop, called once per second
 void handleOverlays()
 {
   initCronixie();
-  if (overlayCurrent == 3) {
-    _overlayCronixie();//Diamex cronixie clock kit
-    strip.trigger();
+  OverlaySpan prev[OVERLAY_MAX_SPANS];
+  byte numPrev = numOverlaySpans;
+  memcpy(prev, overlaySpans, sizeof(OverlaySpan) * numPrev);
+
+  numOverlaySpans = 0;
+  switch (overlayCurrent)
+  {
+    case 1: _overlayAnalogClock(); break;
+    case 3: _overlayCronixie(); _drawOverlayCronixie(); break; //Diamex cronixie clock kit
   }
+  if (numOverlaySpans != numPrev || memcmp(prev, overlaySpans, sizeof(OverlaySpan) * numPrev)) strip.trigger();
 }
 
 
@@ -36,39 +51,36 @@ void _overlayAnalogClock()
   {
     _overlayAnalogCountdown(); return;
   }
-  double hourP = ((double)(hour(localTime)%12))/12;
-  double minuteP = ((double)minute(localTime))/60;
-  hourP = hourP + minuteP/12;
-  double secondP = ((double)second(localTime))/60;
-  int hourPixel = floor(analogClock12pixel + overlaySize*hourP);
+  int minute60 = minute(localTime);
+  int hourPixel = analogClock12pixel + (overlaySize * ((hour(localTime)%12)*60 + minute60)) / 720;
   if (hourPixel > overlayMax) hourPixel = overlayMin -1 + hourPixel - overlayMax;
-  int minutePixel = floor(analogClock12pixel + overlaySize*minuteP);
+  int minutePixel = analogClock12pixel + (overlaySize * minute60) / 60;
   if (minutePixel > overlayMax) minutePixel = overlayMin -1 + minutePixel - overlayMax; 
-  int secondPixel = floor(analogClock12pixel + overlaySize*secondP);
+  int secondPixel = analogClock12pixel + (overlaySize * second(localTime)) / 60;
   if (secondPixel > overlayMax) secondPixel = overlayMin -1 + secondPixel - overlayMax;
   if (analogClockSecondsTrail)
   {
     if (secondPixel < analogClock12pixel)
     {
-      strip.setRange(analogClock12pixel, overlayMax, 0xFF0000);
-      strip.setRange(overlayMin, secondPixel, 0xFF0000);
+      addOverlaySpan(analogClock12pixel, overlayMax, 0xFF0000);
+      addOverlaySpan(overlayMin, secondPixel, 0xFF0000);
     } else
     {
-      strip.setRange(analogClock12pixel, secondPixel, 0xFF0000);
+      addOverlaySpan(analogClock12pixel, secondPixel, 0xFF0000);
     }
   }
   if (analogClock5MinuteMarks)
   {
     for (byte i = 0; i <= 12; i++)
     {
-      int pix = analogClock12pixel + round((overlaySize / 12.0) *i);
+      int pix = analogClock12pixel + (overlaySize * i + 6) / 12;
       if (pix > overlayMax) pix -= overlaySize;
-      strip.setPixelColor(pix, 0x00FFAA);
+      addOverlaySpan(pix, pix, 0x00FFAA);
     }
   }
-  if (!analogClockSecondsTrail) strip.setPixelColor(secondPixel, 0xFF0000);
-  strip.setPixelColor(minutePixel, 0x00FF00);
-  strip.setPixelColor(hourPixel, 0x0000FF);
+  if (!analogClockSecondsTrail) addOverlaySpan(secondPixel, secondPixel, 0xFF0000);
+  addOverlaySpan(minutePixel, minutePixel, 0x00FF00);
+  addOverlaySpan(hourPixel, hourPixel, 0x0000FF);
 }
 
 
@@ -77,7 +89,7 @@ void _overlayAnalogCountdown()
   if ((unsigned long)toki.second() < countdownTime)
   {
     long diff = countdownTime - toki.second();
-    double pval = 60;
+    long pval = 60;
     if (diff > 31557600L) //display in years if more than 365 days
     {
       pval = 315576000L; //10 years
@@ -98,16 +110,16 @@ void _overlayAnalogCountdown()
       pval = 3600; //1 hour
     }
     int overlaySize = overlayMax - overlayMin +1;
-    double perc = (pval-(double)diff)/pval;
-    if (perc > 1.0) perc = 1.0;
-    byte pixelCnt = perc*overlaySize;
+    if (diff > pval) diff = pval;
+    int pixelCnt = ((int64_t)(pval - diff) * overlaySize) / pval;
+    uint32_t col = ((uint32_t)colSec[3] << 24)| ((uint32_t)colSec[0] << 16) | ((uint32_t)colSec[1] << 8) | colSec[2];
     if (analogClock12pixel + pixelCnt > overlayMax)
     {
-      strip.setRange(analogClock12pixel, overlayMax, ((uint32_t)colSec[3] << 24)| ((uint32_t)colSec[0] << 16) | ((uint32_t)colSec[1] << 8) | colSec[2]);
-      strip.setRange(overlayMin, overlayMin +pixelCnt -(1+ overlayMax -analogClock12pixel), ((uint32_t)colSec[3] << 24)| ((uint32_t)colSec[0] << 16) | ((uint32_t)colSec[1] << 8) | colSec[2]);
+      addOverlaySpan(analogClock12pixel, overlayMax, col);
+      addOverlaySpan(overlayMin, overlayMin +pixelCnt -(1+ overlayMax -analogClock12pixel), col);
     } else
     {
-      strip.setRange(analogClock12pixel, analogClock12pixel + pixelCnt, ((uint32_t)colSec[3] << 24)| ((uint32_t)colSec[0] << 16) | ((uint32_t)colSec[1] << 8) | colSec[2]);
+      addOverlaySpan(analogClock12pixel, analogClock12pixel + pixelCnt, col);
     }
   }
 }
@@ -115,11 +127,7 @@ void _overlayAnalogCountdown()
 void handleOverlayDraw() {
   usermods.handleOverlayDraw();
   if (!overlayCurrent) return;
-  switch (overlayCurrent)
-  {
-    case 1: _overlayAnalogClock(); break;
-    case 3: _drawOverlayCronixie(); break;
-  }
+  for (byte i = 0; i < numOverlaySpans; i++) strip.drawOverlayRange(overlaySpans[i].start, overlaySpans[i].stop, overlaySpans[i].color);
 }
 
 /*
@@ -128,7 +136,58 @@ void handleOverlayDraw() {
  
 #ifndef WLED_DISABLE_CRONIXIE
 byte _digitOut[6] = {10,10,10,10,10,10};
- 
+
+/*
+ * setCronixie() compiles cronixieDisplay into a program of digit groups, each shown from one value,
+ * so the codes are parsed once and _overlayCronixie() only does a few divisions per second.
+ *
+ * _ blank | - blank, backlight off | 0-9 fixed digit | R random 0-9 | r random 1-6 (both picked when compiled)
+ * H hour lower digit | HH hour (12h with useAMPM) | AH hour 12h
+ * M minute upper digit | MM minute
+ * S second upper digit | SS second
+ * B AM/PM as 0/1
+ * Y year lower digit | YY year | YYYY year 4 digits
+ * I month lower digit | II month
+ * D day of week, 1 Monday | DD day of month
+ * Lower case codes do not light a leading zero (b does not light 0)
+ */
+#define CRONIXIE_SRC_CONST   0
+#define CRONIXIE_SRC_HOUR    1
+#define CRONIXIE_SRC_HOUR12  2
+#define CRONIXIE_SRC_MINUTE  3
+#define CRONIXIE_SRC_SECOND  4
+#define CRONIXIE_SRC_WEEKDAY 5
+#define CRONIXIE_SRC_DAY     6
+#define CRONIXIE_SRC_MONTH   7
+#define CRONIXIE_SRC_YEAR    8
+#define CRONIXIE_SRC_PM      9
+
+typedef struct CronixieOp {
+  uint8_t src;
+  uint8_t pos;      //first digit
+  uint8_t len;      //digits shown
+  uint8_t digit;    //CRONIXIE_SRC_CONST: digit, 10 blank, 11 blank with the backlight off
+  bool upper;       //the tens digit of the value instead of the units
+  bool blankZero;   //a leading zero is not lit
+} CronixieOp;
+
+static CronixieOp cronixieProgram[6];
+static byte cronixieOps = 0;
+static char cronixieCompiled[7] = ""; //cronixieDisplay the program was compiled from
+
+void initCronixie()
+{
+  if (overlayCurrent == 3 && (!cronixieOps || strncmp(cronixieDisplay, cronixieCompiled, 6)))
+  {
+    setCronixie();
+    strip.getSegment(0).grouping = 10; //10 LEDs per digit
+  } else if (cronixieOps && overlayCurrent != 3)
+  {
+    strip.getSegment(0).grouping = 1;
+    cronixieOps = 0;
+  }
+}
+
 byte getSameCodeLength(char code, int index, char const cronixieDisplay[])
 {
   byte counter = 0;
@@ -147,122 +206,35 @@ byte getSameCodeLength(char code, int index, char const cronixieDisplay[])
 
 void setCronixie()
 {
-  /*
-   * digit purpose index
-   * 0-9 | 0-9 (incl. random)
-   * 10 | blank
-   * 11 | blank, bg off
-   * 12 | test upw.
-   * 13 | test dnw.
-   * 14 | binary AM/PM
-   * 15 | BB upper +50 for no trailing 0
-   * 16 | BBB
-   * 17 | BBBB
-   * 18 | BBBBB
-   * 19 | BBBBBB
-   * 20 | H
-   * 21 | HH
-   * 22 | HHH
-   * 23 | HHHH
-   * 24 | M
-   * 25 | MM
-   * 26 | MMM
-   * 27 | MMMM
-   * 28 | MMMMM
-   * 29 | MMMMMM
-   * 30 | S
-   * 31 | SS
-   * 32 | SSS
-   * 33 | SSSS
-   * 34 | SSSSS
-   * 35 | SSSSSS
-   * 36 | Y
-   * 37 | YY
-   * 38 | YYYY
-   * 39 | I
-   * 40 | II
-   * 41 | W
-   * 42 | WW
-   * 43 | D
-   * 44 | DD
-   * 45 | DDD
-   * 46 | V
-   * 47 | VV
-   * 48 | VVV
-   * 49 | VVVV
-   * 50 | VVVVV
-   * 51 | VVVVVV
-   * 52 | v
-   * 53 | vv
-   * 54 | vvv
-   * 55 | vvvv
-   * 56 | vvvvv
-   * 57 | vvvvvv
-   */
-
-  //H HourLower | HH - Hour 24. | AH - Hour 12. | HHH Hour of Month | HHHH Hour of Year
-  //M MinuteUpper | MM Minute of Hour | MMM Minute of 12h | MMMM Minute of Day | MMMMM Minute of Month | MMMMMM Minute of Year
-  //S SecondUpper | SS Second of Minute | SSS Second of 10 Minute | SSSS Second of Hour | SSSSS Second of Day | SSSSSS Second of Week
-  //B AM/PM | BB 0-6/6-12/12-18/18-24 | BBB 0-3... | BBBB 0-1.5... | BBBBB 0-1 | BBBBBB 0-0.5
-  
-  //Y YearLower | YY - Year LU | YYYY - Std.
-  //I MonthLower | II - Month of Year 
-  //W Week of Month | WW Week of Year
-  //D Day of Week | DD Day Of Month | DDD Day Of Year
-
   DEBUG_PRINT("cset ");
   DEBUG_PRINTLN(cronixieDisplay);
-  
-  for (int i = 0; i < 6; i++)
+
+  cronixieOps = 0;
+  byte i = 0;
+  while (i < 6)
   {
-    dP[i] = 10;
-    switch (cronixieDisplay[i])
+    char c = cronixieDisplay[i];
+    byte n = 1 + getSameCodeLength(c, i, cronixieDisplay);
+    CronixieOp& op = cronixieProgram[cronixieOps++];
+    op = {CRONIXIE_SRC_CONST, i, 1, 10, false, (c >= 'a' && c <= 'z')};
+    switch (c)
     {
-      case '_': dP[i] = 10; break; 
-      case '-': dP[i] = 11; break; 
-      case 'r': dP[i] = random(1,7); break; //random btw. 1-6
-      case 'R': dP[i] = random(0,10); break; //random btw. 0-9
-      //case 't': break; //Test upw.
-      //case 'T': break; //Test dnw.
-      case 'b': dP[i] = 14 + getSameCodeLength('b',i,cronixieDisplay); i = i+dP[i]-14; break; 
-      case 'B': dP[i] = 14 + getSameCodeLength('B',i,cronixieDisplay); i = i+dP[i]-14; break;
-      case 'h': dP[i] = 70 + getSameCodeLength('h',i,cronixieDisplay); i = i+dP[i]-70; break;
-      case 'H': dP[i] = 20 + getSameCodeLength('H',i,cronixieDisplay); i = i+dP[i]-20; break;
-      case 'A': dP[i] = 108; i++; break;
-      case 'a': dP[i] = 58; i++; break;
-      case 'm': dP[i] = 74 + getSameCodeLength('m',i,cronixieDisplay); i = i+dP[i]-74; break;
-      case 'M': dP[i] = 24 + getSameCodeLength('M',i,cronixieDisplay); i = i+dP[i]-24; break;
-      case 's': dP[i] = 80 + getSameCodeLength('s',i,cronixieDisplay); i = i+dP[i]-80; break; //refresh more often bc. of secs
-      case 'S': dP[i] = 30 + getSameCodeLength('S',i,cronixieDisplay); i = i+dP[i]-30; break;
-      case 'Y': dP[i] = 36 + getSameCodeLength('Y',i,cronixieDisplay); i = i+dP[i]-36; break; 
-      case 'y': dP[i] = 86 + getSameCodeLength('y',i,cronixieDisplay); i = i+dP[i]-86; break; 
-      case 'I': dP[i] = 39 + getSameCodeLength('I',i,cronixieDisplay); i = i+dP[i]-39; break;  //Month. Don't ask me why month and minute both start with M.
-      case 'i': dP[i] = 89 + getSameCodeLength('i',i,cronixieDisplay); i = i+dP[i]-89; break; 
-      //case 'W': break;
-      //case 'w': break;
-      case 'D': dP[i] = 43 + getSameCodeLength('D',i,cronixieDisplay); i = i+dP[i]-43; break;
-      case 'd': dP[i] = 93 + getSameCodeLength('d',i,cronixieDisplay); i = i+dP[i]-93; break;
-      case '0': dP[i] = 0; break;
-      case '1': dP[i] = 1; break;
-      case '2': dP[i] = 2; break;
-      case '3': dP[i] = 3; break;
-      case '4': dP[i] = 4; break;
-      case '5': dP[i] = 5; break;
-      case '6': dP[i] = 6; break;
-      case '7': dP[i] = 7; break;
-      case '8': dP[i] = 8; break;
-      case '9': dP[i] = 9; break;
-      //case 'V': break; //user var0
-      //case 'v': break; //user var1
+      case '-': op.digit = 11; break;
+      case 'r': op.digit = random(1,7); break; //random btw. 1-6
+      case 'R': op.digit = random(0,10); break; //random btw. 0-9
+      case 'A': case 'a': op.src = CRONIXIE_SRC_HOUR12; op.len = (i < 5) ? 2 : 1; break;
+      case 'H': case 'h': op.src = CRONIXIE_SRC_HOUR;    op.len = MIN(n, 2); break;
+      case 'M': case 'm': op.src = CRONIXIE_SRC_MINUTE;  op.len = MIN(n, 2); op.upper = (n == 1); break;
+      case 'S': case 's': op.src = CRONIXIE_SRC_SECOND;  op.len = MIN(n, 2); op.upper = (n == 1); break;
+      case 'B': case 'b': op.src = CRONIXIE_SRC_PM; break;
+      case 'Y': case 'y': op.src = CRONIXIE_SRC_YEAR;    op.len = (n > 3) ? 4 : MIN(n, 2); op.blankZero = false; break;
+      case 'I': case 'i': op.src = CRONIXIE_SRC_MONTH;   op.len = MIN(n, 2); break;
+      case 'D': case 'd': op.src = (n == 1) ? CRONIXIE_SRC_WEEKDAY : CRONIXIE_SRC_DAY; op.len = MIN(n, 2); break;
+      default: if (c >= '0' && c <= '9') op.digit = c - '0'; //else blank
     }
+    i += op.len;
   }
-  DEBUG_PRINT("result ");
-  for (int i = 0; i < 5; i++)
-  {
-    DEBUG_PRINT((int)dP[i]);
-    DEBUG_PRINT(" ");
-  }
-  DEBUG_PRINTLN((int)dP[5]);
+  strlcpy(cronixieCompiled, cronixieDisplay, sizeof(cronixieCompiled));
 
   _overlayCronixie(); //refresh
 }
@@ -271,67 +243,39 @@ void _overlayCronixie()
 {
   byte h = hour(localTime);
   byte h0 = h;
-  byte m = minute(localTime);
-  byte s = second(localTime);
-  byte d = day(localTime);
-  byte mi = month(localTime);
+  byte h12 = (h > 12) ? h - 12 : (h == 0 ? 12 : h);
+  if (useAMPM && !countdownMode) h = h12;
   int y = year(localTime);
   //this has to be changed in time for 22nd century
   y -= 2000; if (y<0) y += 30; //makes countdown work
 
-  if (useAMPM && !countdownMode)
+  for (byte k = 0; k < cronixieOps; k++)
   {
-    if (h>12) h-=12;
-    else if (h==0) h+=12;
-  }
-  for (int i = 0; i < 6; i++)
-  {
-    if (dP[i] < 12) _digitOut[i] = dP[i];
-    else {
-      if (dP[i] < 65)
-      {
-        switch(dP[i])
-        {
-          case 21: _digitOut[i] = h/10; _digitOut[i+1] = h- _digitOut[i]*10; i++; break; //HH
-          case 25: _digitOut[i] = m/10; _digitOut[i+1] = m- _digitOut[i]*10; i++; break; //MM
-          case 31: _digitOut[i] = s/10; _digitOut[i+1] = s- _digitOut[i]*10; i++; break; //SS
-
-          case 20: _digitOut[i] = h- (h/10)*10; break; //H
-          case 24: _digitOut[i] = m/10; break; //M
-          case 30: _digitOut[i] = s/10; break; //S
-          
-          case 43: _digitOut[i] = weekday(localTime); _digitOut[i]--; if (_digitOut[i]<1) _digitOut[i]= 7; break; //D
-          case 44: _digitOut[i] = d/10; _digitOut[i+1] = d- _digitOut[i]*10; i++; break; //DD
-          case 40: _digitOut[i] = mi/10; _digitOut[i+1] = mi- _digitOut[i]*10; i++; break; //II
-          case 37: _digitOut[i] = y/10; _digitOut[i+1] = y- _digitOut[i]*10; i++; break; //YY
-          case 39: _digitOut[i] = 2; _digitOut[i+1] = 0; _digitOut[i+2] = y/10; _digitOut[i+3] = y- _digitOut[i+2]*10; i+=3; break; //YYYY
-          
-          //case 16: _digitOut[i+2] = ((h0/3)&1)?1:0; i++; //BBB (BBBB NI)
-          //case 15: _digitOut[i+1] = (h0>17 || (h0>5 && h0<12))?1:0; i++; //BB
-          case 14: _digitOut[i] = (h0>11)?1:0; break; //B
-        }
-      } else
-      {
-        switch(dP[i])
-        {
-          case 71: _digitOut[i] = h/10; _digitOut[i+1] = h- _digitOut[i]*10; if(_digitOut[i] == 0) _digitOut[i]=10; i++; break; //hh
-          case 75: _digitOut[i] = m/10; _digitOut[i+1] = m- _digitOut[i]*10; if(_digitOut[i] == 0) _digitOut[i]=10; i++; break; //mm
-          case 81: _digitOut[i] = s/10; _digitOut[i+1] = s- _digitOut[i]*10; if(_digitOut[i] == 0) _digitOut[i]=10; i++; break; //ss
-          //case 66: _digitOut[i+2] = ((h0/3)&1)?1:10; i++; //bbb (bbbb NI)
-          //case 65: _digitOut[i+1] = (h0>17 || (h0>5 && h0<12))?1:10; i++; //bb
-          case 64: _digitOut[i] = (h0>11)?1:10; break; //b
-
-          case 93: _digitOut[i] = weekday(localTime); _digitOut[i]--; if (_digitOut[i]<1) _digitOut[i]= 7; break; //d
-          case 94: _digitOut[i] = d/10; _digitOut[i+1] = d- _digitOut[i]*10; if(_digitOut[i] == 0) _digitOut[i]=10; i++; break; //dd
-          case 90: _digitOut[i] = mi/10; _digitOut[i+1] = mi- _digitOut[i]*10; if(_digitOut[i] == 0) _digitOut[i]=10; i++; break; //ii
-          case 87: _digitOut[i] = y/10; _digitOut[i+1] = y- _digitOut[i]*10; i++; break; //yy
-          case 89: _digitOut[i] = 2; _digitOut[i+1] = 0; _digitOut[i+2] = y/10; _digitOut[i+3] = y- _digitOut[i+2]*10; i+=3; break; //yyyy
-        }
-      }
+    const CronixieOp& op = cronixieProgram[k];
+    uint16_t v = 0;
+    switch (op.src)
+    {
+      case CRONIXIE_SRC_CONST:   _digitOut[op.pos] = op.digit; continue;
+      case CRONIXIE_SRC_HOUR:    v = h; break;
+      case CRONIXIE_SRC_HOUR12:  v = h12; break;
+      case CRONIXIE_SRC_MINUTE:  v = minute(localTime); break;
+      case CRONIXIE_SRC_SECOND:  v = second(localTime); break;
+      case CRONIXIE_SRC_WEEKDAY: v = weekday(localTime) -1; if (v < 1) v = 7; break;
+      case CRONIXIE_SRC_DAY:     v = day(localTime); break;
+      case CRONIXIE_SRC_MONTH:   v = month(localTime); break;
+      case CRONIXIE_SRC_YEAR:    v = (op.len == 4) ? 2000 + y : y; break;
+      case CRONIXIE_SRC_PM:      v = (h0 > 11) ? 1 : 0; break;
+    }
+    if (op.upper) v /= 10;
+    for (int8_t d = op.len -1; d >= 0; d--) {
+      _digitOut[op.pos + d] = v % 10;
+      v /= 10;
     }
+    if (op.blankZero && _digitOut[op.pos] == 0 && (op.len > 1 || op.src == CRONIXIE_SRC_PM)) _digitOut[op.pos] = 10;
   }
 }
 
+//the overlay spans are compared in handleOverlays(), so the effects only run again if a digit changed
 void _drawOverlayCronixie()
 {
   byte offsets[] = {5, 0, 6, 1, 7, 2, 8, 3, 9, 4};
@@ -343,22 +287,15 @@ void _drawOverlayCronixie()
     if(_digitOut[i] < 10) excl = offsets[_digitOut[i]];
     excl += o;
     
-    if (cronixieBacklight && _digitOut[i] <11)
-    {
-      uint32_t col = strip.gamma32(strip.getSegment(0).colors[1]);
-      for (uint16_t j=o; j< o+10; j++) {
-        if (j != excl) strip.setPixelColor(j, col);
-      }
-    } else
-    {
-      for (uint16_t j=o; j< o+10; j++) {
-        if (j != excl) strip.setPixelColor(j, 0);
-      }
-    }
+    uint32_t col = 0;
+    if (cronixieBacklight && _digitOut[i] <11) col = strip.gamma32(strip.getSegment(0).colors[1]);
+    if (excl > o) addOverlaySpan(o, excl -1, col);
+    if (excl < o+9) addOverlaySpan(excl +1, o+9, col);
   }
 }
 
 #else // WLED_DISABLE_CRONIXIE
+void initCronixie() {}
 byte getSameCodeLength(char code, int index, char const cronixieDisplay[]) { return 0; }
 void setCronixie() {}
 void _overlayCronixie() {}
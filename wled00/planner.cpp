@@ -0,0 +1,213 @@
+#include "wled.h"
+
+/*
+ * LED memory planner, GET /json/plan for the current busses or POST /json/plan {"ins":[...]} for a planned
+ * bus list (same format as hw.led.ins in cfg.json) before it is applied.
+ * For each bus it returns the driver it would get, the memory BusManager::memUsage() counts against
+ * MAX_LED_MEMORY (busses beyond it are dropped when the settings are applied), a heap estimate including
+ * DMA buffers and the time to send a frame. Segment data, LED map and composite buffer are added as they are now.
+ * The driver follows from the bus number (ESP32) or the pin (ESP8266), so the suggestion is a bus order or a pin
+ * that gives the highest refresh rate within the memory limit.
+ */
+
+//planned busses of the next /json/plan response, count -1 plans the current ones
+static BusConfig* planConfigs[WLED_MAX_BUSSES] = {nullptr};
+static int8_t planCount = -1;
+
+enum { PLAN_NONE, PLAN_RMT, PLAN_I2S, PLAN_PI2S, PLAN_UART, PLAN_DMA, PLAN_BITBANG, PLAN_SPI, PLAN_PWM, PLAN_NET, PLAN_SDMA };
+static const char* const planDrivers[] = {"none", "rmt", "i2s", "pi2s", "uart", "dma", "bb", "spi", "pwm", "net", "sdma"};
+
+//driver bus num would get, see PolyBus::getI()
+static uint8_t planDriver(const BusConfig& bc, uint8_t num)
+{
+  if (bc.type >= TYPE_NET_DDP_RGB && bc.type < 96) return PLAN_NET;
+  if (IS_PWM(bc.type) || bc.type == TYPE_ONOFF) return PLAN_PWM;
+  if (!IS_DIGITAL(bc.type)) return PLAN_NONE;
+  if (IS_2PIN(bc.type)) return PLAN_SPI;
+  #ifdef ESP8266
+  switch (bc.pins[0]) {
+    case 1: case 2: return PLAN_UART;
+    case 3:         return PLAN_DMA;
+  }
+  return PLAN_BITBANG;
+  #else
+    #if defined(WLED_USE_PARALLEL_I2S)
+    if (num < WLED_PARALLEL_I2S_LANES) return PLAN_PI2S;
+    return (num < WLED_PARALLEL_I2S_LANES + WLED_RMT_CHANNELS) ? PLAN_RMT : PLAN_NONE;
+    #else
+    if (num < WLED_RMT_CHANNELS) return PLAN_RMT;
+    if (num >= WLED_RMT_CHANNELS + WLED_DMA_CHANNELS) return PLAN_NONE;
+      #ifdef CONFIG_IDF_TARGET_ESP32C3
+      return bc.type == TYPE_TM1814 ? PLAN_NONE : PLAN_SDMA;
+      #else
+      return PLAN_I2S;
+      #endif
+    #endif
+  #endif
+}
+
+static uint8_t planChannels(uint8_t type)
+{
+  if (type == TYPE_SK6812_RGBW || type == TYPE_TM1814) return 4;
+  if (type == TYPE_WS2812_1CH) return 1;
+  return 3;
+}
+
+//heap the bus takes, memUsage() leaves out the DMA buffer of I2S and SPI (4 bytes per channel)
+static uint32_t planHeap(const BusConfig& bc, uint8_t drv)
+{
+  BusConfig c = bc;
+  uint32_t mem = BusManager::memUsage(c);
+  if (drv == PLAN_I2S || drv == PLAN_PI2S || drv == PLAN_SDMA) mem = (uint32_t)bc.count * planChannels(bc.type) * 5;
+  return mem;
+}
+
+//microseconds to clock out one frame, 0 if not limiting (PWM, network)
+static uint32_t planFrameTime(const BusConfig& bc, uint8_t drv)
+{
+  if (drv == PLAN_NONE || drv == PLAN_PWM || drv == PLAN_NET) return 0;
+  uint32_t bits = (uint32_t)bc.count * planChannels(bc.type) * 8;
+  if (drv == PLAN_SPI) return bits + 50; //~1MHz software SPI, hardware SPI is faster
+  return (bc.type == TYPE_WS2811_400KHZ ? bits * 5 / 2 : bits * 5 / 4) + 300; //1.25us per bit, 300us reset
+}
+
+static bool planBlocking(uint8_t drv)
+{
+  #ifdef ESP8266
+  return drv == PLAN_UART || drv == PLAN_BITBANG;
+  #else
+  return false;
+  #endif
+}
+
+typedef struct PlanResult {
+  uint32_t mem;  //counted against MAX_LED_MEMORY, of the busses that fit
+  uint32_t heap;
+  uint32_t us;   //frame time of all busses together
+  uint8_t fit;   //busses that are kept
+} PlanResult;
+
+//evaluates the busses in the given order, drivers as they would get them. busOut receives the details per bus if not null
+//dmaBus (ESP8266): bus moved to the DMA pin, the other one-wire busses to the UARTs
+static PlanResult planEvaluate(BusConfig** cfgs, uint8_t count, const uint8_t* order, JsonArray* busOut = nullptr, int8_t dmaBus = -1)
+{
+  PlanResult r = {0, 0, 0, 0};
+  uint32_t longest = 0, blocking = 0;
+  uint32_t mem = 0;
+  for (uint8_t i = 0; i < count; i++) {
+    BusConfig& bc = *cfgs[order ? order[i] : i];
+    uint8_t drv = planDriver(bc, i);
+    if (dmaBus >= 0 && IS_DIGITAL(bc.type) && !IS_2PIN(bc.type)) drv = (dmaBus == i) ? PLAN_DMA : PLAN_UART;
+    BusConfig c = bc;
+    if (drv == PLAN_DMA) c.pins[0] = 3; //memUsage() of the ESP8266 DMA driver
+    else if (dmaBus >= 0 && drv == PLAN_UART) c.pins[0] = 2;
+    uint32_t busMem = BusManager::memUsage(c);
+    mem += busMem;
+    bool ok = mem <= MAX_LED_MEMORY && drv != PLAN_NONE; //as WLED::loop() applies it
+    uint32_t us = planFrameTime(c, drv);
+    if (ok) {
+      r.fit++;
+      r.mem = mem;
+      r.heap += planHeap(c, drv);
+      if (planBlocking(drv)) blocking += us;
+      else if (us > longest) longest = us;
+    }
+    if (!busOut) continue;
+    JsonObject b = busOut->createNestedObject();
+    b["type"] = bc.type;
+    b[F("len")] = bc.count;
+    b[F("drv")] = planDrivers[drv];
+    b[F("mem")] = busMem;
+    b[F("heap")] = planHeap(c, drv);
+    b["us"] = us;
+    b[F("blk")] = planBlocking(drv);
+    b["ok"] = ok;
+  }
+  r.us = longest + blocking; //blocking busses are sent one after the other, while the others run in the background
+  return r;
+}
+
+static uint16_t planFps(uint32_t us)
+{
+  return us ? MIN(1000000UL / us, 250UL) : 250;
+}
+
+void stageLedPlan(JsonArray ins)
+{
+  for (uint8_t i = 0; i < WLED_MAX_BUSSES; i++) { delete planConfigs[i]; planConfigs[i] = nullptr; }
+  planCount = -1;
+  if (ins.isNull()) return;
+  planCount = 0;
+  for (JsonObject elm : ins) {
+    if (planCount >= WLED_MAX_BUSSES) break;
+    uint8_t pins[5] = {255, 255, 255, 255, 255};
+    uint8_t p = 0;
+    for (int pin : elm["pin"].as<JsonArray>()) { pins[p++] = pin; if (p > 4) break; }
+    uint16_t len = elm[F("len")] | 1;
+    uint8_t type = elm["type"] | TYPE_WS2812_RGB;
+    planConfigs[planCount++] = new BusConfig(type, pins, elm["start"] | 0, len);
+  }
+}
+
+void serializeLedPlan(JsonObject root)
+{
+  BusConfig* cfgs[WLED_MAX_BUSSES];
+  BusConfig* owned[WLED_MAX_BUSSES] = {nullptr};
+  uint8_t count = 0;
+  if (planCount >= 0) {
+    for (uint8_t i = 0; i < planCount; i++) cfgs[count++] = planConfigs[i];
+  } else {
+    for (uint8_t i = 0; i < busses.getNumBusses(); i++) {
+      Bus* bus = busses.getBus(i);
+      uint8_t pins[5] = {255, 255, 255, 255, 255};
+      bus->getPins(pins);
+      owned[count] = new BusConfig(bus->getType(), pins, bus->getStart(), bus->getLength());
+      cfgs[count] = owned[count];
+      count++;
+    }
+  }
+
+  root[F("max")] = MAX_LED_MEMORY;
+  JsonArray busOut = root.createNestedArray(F("ins"));
+  PlanResult r = planEvaluate(cfgs, count, nullptr, &busOut);
+  root[F("mem")] = r.mem;
+  root[F("heap")] = r.heap;
+  root["ok"] = r.fit == count;
+  root[F("fps")] = planFps(r.us);
+  //those are there regardless of the bus config
+  root[F("seg")] = strip.getSegmentArena().size();
+  root[F("map")] = strip.getMappingMemory();
+  root[F("fb")]  = strip.getCompositeMemory();
+
+  JsonObject sug = root.createNestedObject(F("sug"));
+  #ifdef ESP8266
+  //only the DMA driver (GPIO3) does not hold the CPU, give it to the bus where that helps most and memory allows
+  int8_t best = -1;
+  PlanResult bestR = planEvaluate(cfgs, count, nullptr, nullptr, 127); //all on UARTs
+  for (uint8_t i = 0; i < count; i++) {
+    if (!IS_DIGITAL(cfgs[i]->type) || IS_2PIN(cfgs[i]->type)) continue;
+    PlanResult t = planEvaluate(cfgs, count, nullptr, nullptr, i);
+    if (t.fit > bestR.fit || (t.fit == bestR.fit && t.us < bestR.us)) { bestR = t; best = i; }
+  }
+  sug[F("dma")] = best;
+  #else
+  //RMT channels come first: longest busses there, the shorter ones get the I2S slots that need more memory
+  uint8_t order[WLED_MAX_BUSSES];
+  for (uint8_t i = 0; i < count; i++) order[i] = i;
+  for (uint8_t i = 1; i < count; i++) {
+    for (uint8_t j = i; j > 0 && cfgs[order[j]]->count > cfgs[order[j-1]]->count; j--) {
+      uint8_t t = order[j]; order[j] = order[j-1]; order[j-1] = t;
+    }
+  }
+  PlanResult bestR = planEvaluate(cfgs, count, order);
+  JsonArray ord = sug.createNestedArray(F("order"));
+  for (uint8_t i = 0; i < count; i++) ord.add(order[i]);
+  #endif
+  sug[F("mem")] = bestR.mem;
+  sug[F("heap")] = bestR.heap;
+  sug["ok"] = bestR.fit == count;
+  sug[F("fps")] = planFps(bestR.us);
+
+  for (uint8_t i = 0; i < count; i++) delete owned[i];
+  stageLedPlan(JsonArray()); //a posted plan is answered once
+}
@@ -8,8 +8,17 @@ typedef struct PlaylistEntry {
   uint8_t preset; //ID of the preset to apply
   uint16_t dur;   //Duration of the entry (in tenths of seconds)
   uint16_t tr;    //Duration of the transition TO this entry (in tenths of seconds)
+  PSRAMDynamicJsonDocument* doc; //preloaded preset, applied without touching the filesystem (nullptr = read when due)
 } ple;
 
+#ifndef PLAYLIST_PRELOAD_BUDGET
+  #ifdef ESP8266
+  #define PLAYLIST_PRELOAD_BUDGET 4096  //max. bytes of parsed presets kept in RAM
+  #else
+  #define PLAYLIST_PRELOAD_BUDGET 16384
+  #endif
+#endif
+
 byte           playlistRepeat = 1;        //how many times to repeat the playlist (0 = infinitely)
 byte           playlistEndPreset = 0;     //what preset to apply after playlist end (0 = stay on last preset)
 byte           playlistOptions = 0;       //bit 0: shuffle playlist after each iteration. bits 1-7 TBD
@@ -18,6 +27,17 @@ PlaylistEntry *playlistEntries = nullptr;
 byte           playlistLen;               //number of playlist entries
 int8_t         playlistIndex = -1;
 uint16_t       playlistEntryDur = 0;      //duration of the current entry in tenths of seconds
+size_t         playlistPreloadUsed = 0;   //bytes held by preloaded entries
+byte           playlistPreloadCursor = 0; //next entry to preload in PL_OPTION_PRELOAD_ALL mode
+bool           playlistPreloadPending = false;
+
+//synced playlists: the entry all nodes apply at syncAt (timebase time, millis() + strip.timebase)
+static PlaylistEntry  syncEntry = {0, 0, 0, nullptr}; //received from the conductor
+static bool           syncPending = false;
+static bool           syncOwn = false;           //conductor, applies playlistEntries[playlistIndex]
+static bool           syncMorph = false;
+static bool           syncResent = false;        //the announcement goes out twice
+static uint32_t       syncAt = 0;
 
 //values we need to keep about the parent playlist while inside sub-playlist
 //int8_t         parentPlaylistIndex = -1;
@@ -42,13 +62,69 @@ void shufflePlaylist() {
 }
 
 
+//reads and parses a preset ahead of time so applying it needs neither the filesystem nor the JSON parser
+bool preloadPlaylistEntry(PlaylistEntry& entry) {
+  if (entry.doc) return true;
+  if (playlistPreloadUsed >= PLAYLIST_PRELOAD_BUDGET) return false;
+  PSRAMDynamicJsonDocument* doc = new PSRAMDynamicJsonDocument(JSON_BUFFER_SIZE);
+  if (doc == nullptr) return false;
+  if (!doc->capacity() || !readPreset(entry.preset, doc)) {
+    delete doc;
+    return false;
+  }
+  JsonObject fdo = doc->as<JsonObject>();
+  if (fdo.containsKey("ps") || fdo.containsKey(F("playlist"))) { //chains presets or replaces this playlist, read when due
+    delete doc;
+    return false;
+  }
+  doc->shrinkToFit();
+  if (playlistPreloadUsed + doc->capacity() > PLAYLIST_PRELOAD_BUDGET) {
+    delete doc;
+    return false;
+  }
+  playlistPreloadUsed += doc->capacity();
+  entry.doc = doc;
+  DEBUG_PRINT(F("Playlist preloaded preset ")); DEBUG_PRINTLN(entry.preset);
+  return true;
+}
+
+
+void releasePlaylistEntry(PlaylistEntry& entry) {
+  if (entry.doc == nullptr) return;
+  playlistPreloadUsed -= entry.doc->capacity();
+  delete entry.doc;
+  entry.doc = nullptr;
+}
+
+
+//preloads one entry per call, so the work is spread over several loop() passes
+void handlePlaylistPreload() {
+  if (!playlistPreloadPending) return;
+  if (playlistOptions & PL_OPTION_PRELOAD_ALL) {
+    if (playlistPreloadCursor >= playlistLen) {
+      playlistPreloadPending = false;
+      return;
+    }
+    preloadPlaylistEntry(playlistEntries[playlistPreloadCursor++]);
+    return;
+  }
+  playlistPreloadPending = false;
+  preloadPlaylistEntry(playlistEntries[(playlistIndex +1) % playlistLen]);
+}
+
+
 void unloadPlaylist() {
+  releasePlaylistEntry(syncEntry);
+  syncPending = false;
   if (playlistEntries != nullptr) {
+    for (byte i = 0; i < playlistLen; i++) releasePlaylistEntry(playlistEntries[i]);
     delete[] playlistEntries;
     playlistEntries = nullptr;
   }
   currentPlaylist = playlistIndex = -1;
   playlistLen = playlistEntryDur = playlistOptions = 0;
+  playlistPreloadUsed = playlistPreloadCursor = 0;
+  playlistPreloadPending = false;
   DEBUG_PRINTLN(F("Playlist unloaded."));
 }
 
@@ -68,6 +144,7 @@ int16_t loadPlaylist(JsonObject playlistObj, byte presetId) {
   for (int ps : presets) {
     if (it >= playlistLen) break;
     playlistEntries[it].preset = ps;
+    playlistEntries[it].doc = nullptr;
     it++;
   }
 
@@ -111,13 +188,83 @@ int16_t loadPlaylist(JsonObject playlistObj, byte presetId) {
   shuffle = shuffle || playlistObj["r"];
   if (shuffle) playlistOptions += PL_OPTION_SHUFFLE;
 
+  //"pre": 1 preloads the next entry, 2 all entries within PLAYLIST_PRELOAD_BUDGET
+  byte preload = playlistObj[F("pre")] | 0;
+  if (preload == 1) playlistOptions += PL_OPTION_PRELOAD;
+  if (preload >= 2) playlistOptions += PL_OPTION_PRELOAD_ALL;
+  playlistPreloadPending = preload;
+  if (playlistObj[F("morph")]) playlistOptions += PL_OPTION_MORPH;
+  if (playlistObj[F("sync")]) playlistOptions += PL_OPTION_SYNC;
+
   currentPlaylist = presetId;
   DEBUG_PRINTLN(F("Playlist loaded."));
   return currentPlaylist;
 }
 
 
+//keep: the preloaded preset stays for the next round
+static void applyPlaylistEntry(PlaylistEntry& entry, bool keep, bool morph) {
+  jsonTransitionOnce = true;
+  transitionDelayTemp = entry.tr * 100;
+  morph = morph && entry.tr;
+  if (morph) strip.prepareMorph();
+  if (entry.doc == nullptr) {
+    applyPreset(entry.preset);
+  } else { //preloaded, no file access and no parsing
+    PSRAMDynamicJsonDocument* doc = entry.doc;
+    if (!keep) {
+      entry.doc = nullptr;
+      playlistPreloadUsed -= doc->capacity();
+    }
+    errorFlag = ERR_NONE;
+    byte prevSyncId = presetSyncId;
+    presetSyncId = entry.preset; //synced by preset id, as applyPreset() does
+    deserializeState(doc->as<JsonObject>(), CALL_MODE_DIRECT_CHANGE, entry.preset);
+    presetSyncId = prevSyncId;
+    currentPreset = entry.preset;
+    if (!keep) delete doc;
+  }
+  if (morph) strip.startMorph(transitionDelayTemp);
+}
+
+
+//follower: a conductor announced the entry all nodes apply at timebase time at, it is read and parsed now
+void schedulePlaylistSync(byte preset, uint16_t tr, bool morph, uint32_t at) {
+  int32_t ahead = at - (millis() + strip.timebase);
+  if (ahead > 10 * WLED_PLAYLIST_SYNC_LEAD) return; //timebase not synced to the conductor yet
+  unloadPlaylist(); //the conductor's playlist runs this node, also releases an entry still pending
+  syncEntry.preset = preset;
+  syncEntry.tr = tr;
+  preloadPlaylistEntry(syncEntry); //otherwise read when due
+  syncMorph = morph;
+  syncOwn = false;
+  syncAt = at;
+  syncPending = true;
+}
+
+
+//applies the synced entry on the first loop() pass at or after its time, before the frame is rendered
+static void handlePlaylistSync() {
+  if (!syncPending) return;
+  int32_t left = syncAt - (millis() + strip.timebase);
+  if (syncOwn && !syncResent && left < WLED_PLAYLIST_SYNC_LEAD / 2) {
+    PlaylistEntry& entry = playlistEntries[playlistIndex];
+    sendPlaylistSync(entry.preset, entry.tr, playlistOptions & PL_OPTION_MORPH, syncAt, true);
+    syncResent = true;
+  }
+  if (left > 0) return;
+  syncPending = false;
+  if (syncOwn) {
+    applyPlaylistEntry(playlistEntries[playlistIndex], playlistOptions & PL_OPTION_PRELOAD_ALL, playlistOptions & PL_OPTION_MORPH);
+    if (playlistOptions & PL_OPTION_PRELOAD) playlistPreloadPending = true;
+  } else {
+    applyPlaylistEntry(syncEntry, false, syncMorph);
+  }
+}
+
+
 void handlePlaylist() {
+  handlePlaylistSync();
   if (currentPlaylist < 0 || playlistEntries == nullptr) return;
 
   if (millis() - presetCycledTime > (100*playlistEntryDur)) {
@@ -138,9 +285,18 @@ void handlePlaylist() {
       if (playlistOptions & PL_OPTION_SHUFFLE) shufflePlaylist(); // shuffle playlist and start over
     }
 
-    jsonTransitionOnce = true;
-    transitionDelayTemp = playlistEntries[playlistIndex].tr * 100;
     playlistEntryDur = playlistEntries[playlistIndex].dur;
-    applyPreset(playlistEntries[playlistIndex].preset);
+    PlaylistEntry& entry = playlistEntries[playlistIndex];
+    if (playlistOptions & PL_OPTION_SYNC) { //announced to the followers now, applied by all of them when due
+      syncAt = millis() + strip.timebase + WLED_PLAYLIST_SYNC_LEAD;
+      syncOwn = syncPending = true;
+      syncResent = false;
+      sendPlaylistSync(entry.preset, entry.tr, playlistOptions & PL_OPTION_MORPH, syncAt, false);
+      return;
+    }
+    applyPlaylistEntry(entry, playlistOptions & PL_OPTION_PRELOAD_ALL, playlistOptions & PL_OPTION_MORPH);
+    if (playlistOptions & PL_OPTION_PRELOAD) playlistPreloadPending = true; //next entry, on a later loop() pass
+    return;
   }
+  handlePlaylistPreload();
 }
@@ -0,0 +1,77 @@
+#include "wled.h"
+
+/*
+ * Power saving while no frames need to be rendered: the lights are off, or the effect
+ * has not produced a changed frame for POWERSAVE_IDLE_MS.
+ * ESP32 drops the CPU clock to POWERSAVE_CPU_MHZ (80MHz keeps the APB clock, so RMT/LEDC timing is unaffected),
+ * ESP8266 lets the WiFi modem enter light sleep while the lights are off (not while PWM outputs are driven).
+ * Both sleep POWERSAVE_LOOP_MS per loop instead of spinning.
+ * Any state change, realtime data or button press ends idling at once and holds it off for POWERSAVE_WAKE_MS.
+ */
+#ifdef WLED_ENABLE_POWERSAVE
+
+#ifndef POWERSAVE_IDLE_MS
+  #define POWERSAVE_IDLE_MS 1000  //no new frame for this long counts as idle
+#endif
+#ifndef POWERSAVE_WAKE_MS
+  #define POWERSAVE_WAKE_MS 2000  //full speed after a wake up event
+#endif
+#ifndef POWERSAVE_LOOP_MS
+  #define POWERSAVE_LOOP_MS 10    //sleep per loop while idle, bounds the button latency
+#endif
+#ifndef POWERSAVE_CPU_MHZ
+  #define POWERSAVE_CPU_MHZ 80    //lower clocks also slow down the APB bus
+#endif
+
+static volatile unsigned long powerWakeTime = 0; //set from the web server task too, loop() does the switching
+static bool powerIdle = false;
+#ifdef ARDUINO_ARCH_ESP32
+static uint32_t powerCpuMhz = 0;                 //clock before idling
+#else
+static bool powerLightSleep = false;
+#endif
+
+void powerWake()
+{
+  powerWakeTime = millis();
+}
+
+static void powerSetIdle(bool idle)
+{
+  if (idle == powerIdle) return;
+  powerIdle = idle;
+#ifdef ARDUINO_ARCH_ESP32
+  if (idle) {
+    powerCpuMhz = getCpuFrequencyMhz();
+    if (powerCpuMhz > POWERSAVE_CPU_MHZ) setCpuFrequencyMhz(POWERSAVE_CPU_MHZ);
+  } else if (powerCpuMhz > POWERSAVE_CPU_MHZ) {
+    setCpuFrequencyMhz(powerCpuMhz);
+  }
+#else
+  bool lightSleep = idle && offMode && !noWifiSleep;
+  if (lightSleep != powerLightSleep) {
+    WiFi.setSleepMode(lightSleep ? WIFI_LIGHT_SLEEP : WIFI_MODEM_SLEEP);
+    powerLightSleep = lightSleep;
+  }
+#endif
+  DEBUG_PRINTLN(idle ? F("Power save on") : F("Power save off"));
+}
+
+//called at the end of loop()
+void handlePowerSave()
+{
+  unsigned long now = millis();
+  bool idle = now - powerWakeTime > POWERSAVE_WAKE_MS
+           && !realtimeMode
+#ifndef WLED_DISABLE_OTA
+           && !Update.isRunning()
+#endif
+           && ((offMode && !strip.isOffRefreshRequred) || now - strip.getLastShow() > POWERSAVE_IDLE_MS);
+  powerSetIdle(idle);
+  if (powerIdle) delay(POWERSAVE_LOOP_MS);
+}
+
+#else
+void powerWake() {}
+void handlePowerSave() {}
+#endif
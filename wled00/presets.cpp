@@ -4,11 +4,197 @@
  * Methods to handle saving and loading presets to/from the filesystem
  */
 
+/*
+ * Write-behind queue: savePreset() and deletePreset() only take a snapshot of the preset in RAM.
+ * handlePresetQueue() commits one per loop pass and the deferred close happens in the next pass,
+ * so saving from the UI during a show does not stall strip.service() for the whole file operation.
+ */
+#ifndef PRESET_QUEUE_SIZE
+  #define PRESET_QUEUE_SIZE 4
+#endif
+#define PRESET_QUEUE_DELAY 250 //ms before a snapshot is committed, repeated saves of a preset are merged
+
+typedef struct PendingPreset {
+  byte index;      //0 = unused
+  char* json;      //serialized preset, nullptr = delete
+  uint32_t queued;
+} PendingPreset;
+
+static PendingPreset presetQueue[PRESET_QUEUE_SIZE];
+
+static PendingPreset* findPending(byte index)
+{
+  for (uint8_t i = 0; i < PRESET_QUEUE_SIZE; i++) if (presetQueue[i].index == index) return &presetQueue[i];
+  return nullptr;
+}
+
+static PendingPreset* oldestPending()
+{
+  PendingPreset* oldest = nullptr;
+  for (uint8_t i = 0; i < PRESET_QUEUE_SIZE; i++) {
+    if (presetQueue[i].index && (!oldest || presetQueue[i].queued - oldest->queued > UINT32_MAX/2)) oldest = &presetQueue[i];
+  }
+  return oldest;
+}
+
+static void erasePreset(byte index);
+
+static void commitPending(PendingPreset* p)
+{
+  DEBUGFS_PRINTF("Commit preset %d\n", p->index);
+  if (p->json) {
+    JsonArenaDoc doc(JSON_LOCK_PRESET_SAVE);
+    if (!doc)                                             errorFlag = ERR_NOBUF;
+    else if (deserializeJson(*doc, (const char*)p->json)) errorFlag = ERR_JSON;
+    else                                                  writePreset(p->index, doc.get());
+  } else {
+    erasePreset(p->index);
+  }
+  free(p->json);
+  p->json = nullptr;
+  p->index = 0;
+  presetsModifiedTime = toki.second(); //unix time
+  updateFSInfo();
+}
+
+//takes a snapshot of the preset (a null object deletes it), false if there is no RAM for it
+static bool queuePreset(byte index, JsonObject obj)
+{
+  char* json = nullptr;
+  if (!obj.isNull()) {
+    size_t len = measureJson(obj);
+    json = (char*) malloc(len +1);
+    if (!json) return false;
+    serializeJson(obj, json, len +1);
+  }
+  PendingPreset* p = findPending(index);
+  if (!p) p = findPending(0);
+  if (!p) { //queue full, make room
+    p = oldestPending();
+    commitPending(p);
+  }
+  free(p->json);
+  p->index = index;
+  p->json = json;
+  p->queued = millis();
+  return true;
+}
+
+void handlePresetQueue()
+{
+  if (doCloseFile) return; //let the previous commit close first
+  PendingPreset* p = oldestPending();
+  if (p && millis() - p->queued > PRESET_QUEUE_DELAY) commitPending(p);
+}
+
+//drops all snapshots, presets.json is being replaced as a whole
+void clearPresetQueue()
+{
+  for (uint8_t i = 0; i < PRESET_QUEUE_SIZE; i++) {
+    free(presetQueue[i].json);
+    presetQueue[i].json = nullptr;
+    presetQueue[i].index = 0;
+  }
+}
+
+//commits all snapshots right away, before a reboot or OTA update
+void flushPresetQueue()
+{
+  PendingPreset* p;
+  while ((p = oldestPending())) commitPending(p);
+  if (doCloseFile) closeFile();
+}
+
+//snapshots not yet committed first, then binary records, which are removed from presets.json when stored
+bool readPreset(byte index, JsonDocument* dest)
+{
+  PendingPreset* p = findPending(index);
+  if (p) {
+    if (p->json && !deserializeJson(*dest, (const char*)p->json)) return true;
+    dest->clear();
+    return false;
+  }
+  #ifdef WLED_ENABLE_BINARY_PRESETS
+  if (binPresetLoad(index, dest)) return true;
+  #endif
+  return readObjectFromFileUsingId("/presets.json", index, dest);
+}
+
+//stores in presets.json unless the preset fits a binary record, right away
+void writePreset(byte index, JsonDocument* content)
+{
+  #ifdef WLED_ENABLE_BINARY_PRESETS
+  if (binPresetSave(index, content->as<JsonObject>())) {
+    if (presetInFile(index)) {
+      StaticJsonDocument<24> empty;
+      writeObjectToFileUsingId("/presets.json", index, &empty);
+    }
+    return;
+  }
+  #endif
+  writeObjectToFileUsingId("/presets.json", index, content);
+}
+
+static void erasePreset(byte index)
+{
+  StaticJsonDocument<24> empty;
+  writeObjectToFileUsingId("/presets.json", index, &empty);
+  #ifdef WLED_ENABLE_BINARY_PRESETS
+  binPresetDelete(index);
+  #endif
+}
+
+//queued unless there is no RAM for the snapshot
+static void storePreset(byte index, JsonDocument* content)
+{
+  if (queuePreset(index, content->as<JsonObject>())) return;
+  writePreset(index, content);
+  presetsModifiedTime = toki.second(); //unix time
+  updateFSInfo();
+}
+
+//checksum of the stored presets, the same on nodes with the same preset files. Computed again after they changed
+static uint32_t presetsCrc = 0;
+static unsigned long presetsCrcTime = 0;
+
+void invalidatePresetsChecksum()
+{
+  presetsCrc = 0;
+}
+
+static uint32_t hashPresetFile(const char* path, uint32_t h)
+{
+  File pf = WLED_FS.open(path, "r");
+  if (!pf) return h;
+  uint8_t buf[128];
+  size_t len;
+  while ((len = pf.read(buf, sizeof(buf))) > 0) {
+    for (size_t i = 0; i < len; i++) h = (h ^ buf[i]) * 16777619UL; //FNV-1a
+  }
+  pf.close();
+  return h;
+}
+
+uint32_t presetsChecksum()
+{
+  if (presetsCrc && presetsCrcTime == presetsModifiedTime) return presetsCrc;
+  if (doCloseFile) closeFile(); //a write may still be open
+  uint32_t h = hashPresetFile("/presets.json", 2166136261UL);
+  #ifdef WLED_ENABLE_BINARY_PRESETS
+  h = hashPresetFile("/presets.bin", h);
+  #endif
+  presetsCrc = h ? h : 1;
+  presetsCrcTime = presetsModifiedTime;
+  return presetsCrc;
+}
+
 bool applyPreset(byte index, byte callMode)
 {
   if (index == 0) return false;
+  byte prevSyncId = presetSyncId;
   if (fileDoc) {
-    errorFlag = readObjectFromFileUsingId("/presets.json", index, fileDoc) ? ERR_NONE : ERR_FS_PLOAD;
+    presetSyncId = index; //the notification of this change can be the preset id
+    errorFlag = readPreset(index, fileDoc) ? ERR_NONE : ERR_FS_PLOAD;
     JsonObject fdo = fileDoc->as<JsonObject>();
     if (fdo["ps"] == index) fdo.remove("ps"); //remove load request for same presets to prevent recursive crash
     #ifdef WLED_DEBUG_FS
@@ -17,23 +203,39 @@ bool applyPreset(byte index, byte callMode)
     deserializeState(fdo, callMode, index);
   } else {
     DEBUGFS_PRINTLN(F("Make read buf"));
-    DynamicJsonDocument fDoc(JSON_BUFFER_SIZE);
-    errorFlag = readObjectFromFileUsingId("/presets.json", index, &fDoc) ? ERR_NONE : ERR_FS_PLOAD;
-    JsonObject fdo = fDoc.as<JsonObject>();
+    JsonArenaDoc fDoc(JSON_LOCK_PRESET_LOAD);
+    if (!fDoc) { errorFlag = ERR_NOBUF; return false; }
+    presetSyncId = index;
+    errorFlag = readPreset(index, fDoc.get()) ? ERR_NONE : ERR_FS_PLOAD;
+    JsonObject fdo = fDoc->as<JsonObject>();
     if (fdo["ps"] == index) fdo.remove("ps");
     #ifdef WLED_DEBUG_FS
-      serializeJson(fDoc, Serial);
+      serializeJson(*fDoc, Serial);
     #endif
+    fileDoc = fDoc.get(); //presets loaded by this one reuse the buffer
     deserializeState(fdo, callMode, index);
+    fileDoc = nullptr;
   }
+  presetSyncId = prevSyncId;
 
   if (!errorFlag) {
     currentPreset = index;
+    usermods.publish(UM_EVENT_PRESET, index);
     return true;
   }
   return false;
 }
 
+//applies the preset with colors, speed, intensity, opacity and palette interpolated from the current state over dur ms
+bool morphToPreset(byte index, uint32_t dur, byte callMode)
+{
+  strip.prepareMorph();
+  bool applied = applyPreset(index, callMode);
+  if (applied) strip.startMorph(dur);
+  else strip.stopMorph(); //frees the prepared morph, the segments are unchanged
+  return applied;
+}
+
 //persist=false is not currently honored
 void savePreset(byte index, bool persist, const char* pname, JsonObject saveobj)
 {
@@ -43,14 +245,15 @@ void savePreset(byte index, bool persist, const char* pname, JsonObject saveobj)
 
   if (!docAlloc) {
     DEBUGFS_PRINTLN(F("Allocating saving buffer"));
-    DynamicJsonDocument lDoc(JSON_BUFFER_SIZE);
-    sObj = lDoc.to<JsonObject>();
+    JsonArenaDoc lDoc(JSON_LOCK_PRESET_SAVE);
+    if (!lDoc) { errorFlag = ERR_NOBUF; return; }
+    sObj = lDoc->to<JsonObject>();
     if (pname) sObj["n"] = pname;
     DEBUGFS_PRINTLN(F("Save current state"));
     serializeState(sObj, true);
     currentPreset = index;
 
-    writeObjectToFileUsingId("/presets.json", index, &lDoc);
+    storePreset(index, lDoc.get());
   } else { //from JSON API
     DEBUGFS_PRINTLN(F("Reuse recv buffer"));
     sObj.remove(F("psave"));
@@ -67,15 +270,13 @@ void savePreset(byte index, bool persist, const char* pname, JsonObject saveobj)
     sObj.remove(F("error"));
     sObj.remove(F("time"));
 
-    writeObjectToFileUsingId("/presets.json", index, fileDoc);
+    storePreset(index, fileDoc);
   }
-  presetsModifiedTime = toki.second(); //unix time
-  updateFSInfo();
 }
 
 void deletePreset(byte index) {
-  StaticJsonDocument<24> empty;
-  writeObjectToFileUsingId("/presets.json", index, &empty);
+  if (queuePreset(index, JsonObject())) return;
+  erasePreset(index);
   presetsModifiedTime = toki.second(); //unix time
   updateFSInfo();
 }
\ No newline at end of file
@@ -0,0 +1,486 @@
+#include "wled.h"
+
+#include <memory>
+
+/*
+ * Compact binary preset store (/presets.bin), kept alongside /presets.json.
+ * Plain state presets (name, brightness and segments) are stored as fixed size records,
+ * so saving or recalling one only reads or writes that record. Everything the records
+ * cannot represent (API commands, playlists, segment names, ...) stays in presets.json.
+ * File layout: header with a slot table indexed by preset id, followed by the records.
+ */
+
+#ifdef WLED_ENABLE_BINARY_PRESETS
+
+#ifndef BIN_PRESET_MAX_SEGS
+  #define BIN_PRESET_MAX_SEGS 8 //presets with more segments are kept in presets.json
+#endif
+
+#define BIN_PRESET_FILE     "/presets.bin"
+#define BIN_PRESET_MAGIC    0x31425057 //"WPB1"
+#define BIN_PRESET_IDS      251        //preset ids 0-250
+#define BIN_PRESET_NAME_LEN 32
+#define BIN_PRESET_QL_LEN   8
+#define BIN_PRESET_JSON_SIZE (1024 + BIN_PRESET_MAX_SEGS * 512) //one record as JSON, gaps included
+
+//keys of a preset object present in a record
+#define BPR_N        0x01
+#define BPR_QL       0x02
+#define BPR_ON       0x04
+#define BPR_BRI      0x08
+#define BPR_TT       0x10
+#define BPR_MAINSEG  0x20
+#define BPR_SEG      0x40
+#define BPR_GAPS     0x80 //segments not in the record are disabled with {"stop":0}
+
+//segment keys, the position is the bit in BinPresetSegment.keys
+static const char bpsKeys[][6] PROGMEM = {"id","start","stop","grp","spc","of","on","bri","col","fx","sx","ix","pal","sel","rev","mi"};
+enum { BPS_ID, BPS_START, BPS_STOP, BPS_GRP, BPS_SPC, BPS_OF, BPS_ON, BPS_BRI, BPS_COL, BPS_FX, BPS_SX, BPS_IX, BPS_PAL, BPS_SEL, BPS_REV, BPS_MI, BPS_KEYS };
+
+typedef struct BinPresetSegment {
+  uint16_t keys;
+  uint8_t  id;
+  uint16_t start, stop, offset;
+  uint8_t  grouping, spacing, opacity;
+  uint8_t  mode, speed, intensity, palette;
+  uint8_t  options; //SEG_OPTION_* bits
+  uint8_t  colFmt;  //number of colors | channels per color << 4
+  uint8_t  colors[NUM_COLORS][4];
+} __attribute__((packed)) BinPresetSegment;
+
+typedef struct BinPresetRecord {
+  uint8_t  id;      //0 = free slot
+  uint8_t  keys;    //BPR_* bits
+  uint8_t  on;
+  uint8_t  bri;
+  uint16_t transition;
+  uint8_t  mainseg;
+  uint8_t  segTotal; //length of the seg array
+  uint8_t  segCount; //segments stored below
+  char     name[BIN_PRESET_NAME_LEN +1];
+  char     ql[BIN_PRESET_QL_LEN +1];
+  BinPresetSegment seg[BIN_PRESET_MAX_SEGS];
+} __attribute__((packed)) BinPresetRecord;
+
+typedef struct BinPresetHeader {
+  uint32_t magic;
+  uint16_t recordSize;
+  uint8_t  slots[BIN_PRESET_IDS]; //slot + 1 of each preset id, 0 = not stored
+} __attribute__((packed)) BinPresetHeader;
+
+static BinPresetHeader* binHeader = nullptr;
+static int8_t binState = 0; //0: not loaded, 1: usable, -1: file of a different build, leave it alone
+
+//loads the slot table once, all later lookups are in RAM
+static bool binPresetsReady()
+{
+  if (binState) return binState > 0;
+  if (!binHeader) binHeader = (BinPresetHeader*) malloc(sizeof(BinPresetHeader));
+  if (!binHeader) return false;
+  memset(binHeader, 0, sizeof(BinPresetHeader));
+  binHeader->magic = BIN_PRESET_MAGIC;
+  binHeader->recordSize = sizeof(BinPresetRecord);
+  binState = 1;
+
+  File bf = WLED_FS.open(BIN_PRESET_FILE, "r");
+  if (!bf) return true; //created on first save
+  BinPresetHeader h;
+  if (bf.read((uint8_t*)&h, sizeof(h)) == sizeof(h) && h.magic == BIN_PRESET_MAGIC && h.recordSize == sizeof(BinPresetRecord)) {
+    memcpy(binHeader, &h, sizeof(h));
+  } else {
+    DEBUGFS_PRINTLN(F("presets.bin has a different layout, not used"));
+    binState = -1;
+  }
+  bf.close();
+  return binState > 0;
+}
+
+static uint32_t binRecordPos(uint8_t slot)
+{
+  return sizeof(BinPresetHeader) + (uint32_t)slot * sizeof(BinPresetRecord);
+}
+
+static bool getUint8(JsonVariant v, uint8_t& out)
+{
+  if (!v.is<int>() || v.as<int>() < 0 || v.as<int>() > 255) return false;
+  out = v.as<int>();
+  return true;
+}
+
+static bool getUint16(JsonVariant v, uint16_t& out)
+{
+  if (!v.is<long>() || v.as<long>() < 0 || v.as<long>() > 65535) return false;
+  out = v.as<long>();
+  return true;
+}
+
+static bool getString(JsonVariant v, char* out, uint8_t maxLen)
+{
+  const char* s = v.as<const char*>();
+  if (!v.is<const char*>() || strlen(s) > maxLen) return false;
+  strcpy(out, s);
+  return true;
+}
+
+static bool segmentFromJson(JsonObject elem, BinPresetSegment& s)
+{
+  for (JsonPair kv : elem) {
+    uint8_t k = 0;
+    while (k < BPS_KEYS && strcmp_P(kv.key().c_str(), bpsKeys[k])) k++;
+    if (k == BPS_KEYS) return false; //segment name or unknown key
+    JsonVariant v = kv.value();
+    bool ok = true;
+    switch (k) {
+      case BPS_ID:    ok = getUint8(v, s.id);          break;
+      case BPS_START: ok = getUint16(v, s.start);      break;
+      case BPS_STOP:  ok = getUint16(v, s.stop);       break;
+      case BPS_GRP:   ok = getUint8(v, s.grouping);    break;
+      case BPS_SPC:   ok = getUint8(v, s.spacing);     break;
+      case BPS_OF:    ok = getUint16(v, s.offset);     break;
+      case BPS_BRI:   ok = getUint8(v, s.opacity);     break;
+      case BPS_FX:    ok = getUint8(v, s.mode);        break;
+      case BPS_SX:    ok = getUint8(v, s.speed);       break;
+      case BPS_IX:    ok = getUint8(v, s.intensity);   break;
+      case BPS_PAL:   ok = getUint8(v, s.palette);     break;
+      case BPS_COL: {
+        StaticJsonDocument<JSON_ARRAY_SIZE(NUM_COLORS) + NUM_COLORS*JSON_ARRAY_SIZE(4)> colDoc;
+        if (!v.is<JsonArray>()) { //serializeSegment() writes the colors as raw JSON
+          char colstr[72];
+          if (measureJson(v) >= sizeof(colstr)) return false;
+          serializeJson(v, colstr, sizeof(colstr));
+          if (deserializeJson(colDoc, colstr) || !colDoc.is<JsonArray>()) return false;
+          v = colDoc.as<JsonVariant>();
+        }
+        JsonArray colarr = v;
+        uint8_t n = 0, ch = 0;
+        for (JsonVariant c : colarr) {
+          if (n >= NUM_COLORS || !c.is<JsonArray>()) return false;
+          JsonArray rgbw = c;
+          if (!ch) ch = rgbw.size();
+          if (rgbw.size() != ch || ch < 3 || ch > 4) return false; //hex strings and mixed formats stay JSON
+          for (uint8_t i = 0; i < ch; i++) if (!getUint8(rgbw[i], s.colors[n][i])) return false;
+          n++;
+        }
+        s.colFmt = n | (ch << 4);
+      } break;
+      default: { //boolean options
+        if (!v.is<bool>()) return false; //"t" (toggle) must be evaluated when applied
+        uint8_t opt = (k == BPS_ON) ? SEG_OPTION_ON : (k == BPS_SEL) ? SEG_OPTION_SELECTED : (k == BPS_REV) ? SEG_OPTION_REVERSED : SEG_OPTION_MIRROR;
+        if (v.as<bool>()) s.options |= (1 << opt);
+      }
+    }
+    if (!ok) return false;
+    s.keys |= (1 << k);
+  }
+  return true;
+}
+
+//converts a preset object, false if it holds anything a record cannot represent
+static bool recordFromJson(JsonObject obj, BinPresetRecord& rec)
+{
+  memset(&rec, 0, sizeof(rec));
+  for (JsonPair kv : obj) {
+    const char* k = kv.key().c_str();
+    JsonVariant v = kv.value();
+    bool ok = false;
+    if      (!strcmp_P(k, PSTR("n")))          { ok = getString(v, rec.name, BIN_PRESET_NAME_LEN); rec.keys |= BPR_N; }
+    else if (!strcmp_P(k, PSTR("ql")))         { ok = getString(v, rec.ql, BIN_PRESET_QL_LEN);     rec.keys |= BPR_QL; }
+    else if (!strcmp_P(k, PSTR("on")))         { ok = v.is<bool>(); rec.on = v.as<bool>();         rec.keys |= BPR_ON; }
+    else if (!strcmp_P(k, PSTR("bri")))        { ok = getUint8(v, rec.bri);                        rec.keys |= BPR_BRI; }
+    else if (!strcmp_P(k, PSTR("transition"))) { ok = getUint16(v, rec.transition);                rec.keys |= BPR_TT; }
+    else if (!strcmp_P(k, PSTR("mainseg")))    { ok = getUint8(v, rec.mainseg);                    rec.keys |= BPR_MAINSEG; }
+    else if (!strcmp_P(k, PSTR("seg"))) {
+      if (!v.is<JsonArray>()) return false;
+      JsonArray segs = v;
+      if (segs.size() > MAX_NUM_SEGMENTS) return false;
+      rec.keys |= BPR_SEG;
+      rec.segTotal = segs.size();
+      uint8_t it = 0;
+      for (JsonVariant v : segs) {
+        if (!v.is<JsonObject>()) return false;
+        JsonObject elem = v;
+        if (elem.size() == 1 && elem["stop"] == 0) { rec.keys |= BPR_GAPS; it++; continue; }
+        if (rec.segCount >= BIN_PRESET_MAX_SEGS) return false;
+        BinPresetSegment& s = rec.seg[rec.segCount];
+        if (!segmentFromJson(elem, s)) return false;
+        if (!(s.keys & (1 << BPS_ID))) { s.id = it; s.keys |= (1 << BPS_ID); }
+        rec.segCount++; it++;
+      }
+      ok = true;
+    }
+    if (!ok) return false;
+  }
+  if (rec.keys & BPR_GAPS) { //gaps are only restored by position, so ids must match theirs
+    uint8_t pos = 0;
+    for (uint8_t i = 0; i < rec.segCount; i++) {
+      while (pos < rec.segTotal && pos != rec.seg[i].id) pos++;
+      if (pos >= rec.segTotal) return false;
+      pos++;
+    }
+  }
+  return true;
+}
+
+static void recordToJson(const BinPresetRecord& rec, JsonObject root)
+{
+  if (rec.keys & BPR_N)       root["n"] = (char*)rec.name; //copied into the document
+  if (rec.keys & BPR_QL)      root["ql"] = (char*)rec.ql;
+  if (rec.keys & BPR_ON)      root["on"] = (bool)rec.on;
+  if (rec.keys & BPR_BRI)     root["bri"] = rec.bri;
+  if (rec.keys & BPR_TT)      root[F("transition")] = rec.transition;
+  if (rec.keys & BPR_MAINSEG) root[F("mainseg")] = rec.mainseg;
+  if (!(rec.keys & BPR_SEG)) return;
+
+  JsonArray segs = root.createNestedArray("seg");
+  uint8_t next = 0;
+  for (uint8_t pos = 0; pos < rec.segTotal; pos++) {
+    if (next >= rec.segCount || ((rec.keys & BPR_GAPS) && rec.seg[next].id != pos)) {
+      JsonObject gap = segs.createNestedObject();
+      gap["stop"] = 0;
+      continue;
+    }
+    const BinPresetSegment& s = rec.seg[next++];
+    JsonObject elem = segs.createNestedObject();
+    for (uint8_t k = 0; k < BPS_KEYS; k++) {
+      if (!(s.keys & (1 << k))) continue;
+      char key[6]; strcpy_P(key, bpsKeys[k]);
+      switch (k) {
+        case BPS_ID:    elem[key] = s.id;        break;
+        case BPS_START: elem[key] = s.start;     break;
+        case BPS_STOP:  elem[key] = s.stop;      break;
+        case BPS_GRP:   elem[key] = s.grouping;  break;
+        case BPS_SPC:   elem[key] = s.spacing;   break;
+        case BPS_OF:    elem[key] = s.offset;    break;
+        case BPS_BRI:   elem[key] = s.opacity;   break;
+        case BPS_FX:    elem[key] = s.mode;      break;
+        case BPS_SX:    elem[key] = s.speed;     break;
+        case BPS_IX:    elem[key] = s.intensity; break;
+        case BPS_PAL:   elem[key] = s.palette;   break;
+        case BPS_COL: {
+          JsonArray colarr = elem.createNestedArray(key);
+          for (uint8_t n = 0; n < (s.colFmt & 0x0F); n++) {
+            JsonArray rgbw = colarr.createNestedArray();
+            for (uint8_t i = 0; i < (s.colFmt >> 4); i++) rgbw.add(s.colors[n][i]);
+          }
+        } break;
+        default: {
+          uint8_t opt = (k == BPS_ON) ? SEG_OPTION_ON : (k == BPS_SEL) ? SEG_OPTION_SELECTED : (k == BPS_REV) ? SEG_OPTION_REVERSED : SEG_OPTION_MIRROR;
+          elem[key] = (bool)((s.options >> opt) & 0x01);
+        }
+      }
+    }
+  }
+}
+
+static bool readRecord(uint8_t id, BinPresetRecord& rec)
+{
+  if (id == 0 || id >= BIN_PRESET_IDS || !binPresetsReady() || !binHeader->slots[id]) return false;
+  File bf = WLED_FS.open(BIN_PRESET_FILE, "r");
+  if (!bf) return false;
+  bool ok = bf.seek(binRecordPos(binHeader->slots[id] -1), SeekSet)
+         && bf.read((uint8_t*)&rec, sizeof(rec)) == sizeof(rec)
+         && rec.id == id;
+  bf.close();
+  return ok;
+}
+
+//writes the slot table entry of one id in place
+static bool writeSlot(File& bf, uint8_t id)
+{
+  return bf.seek(offsetof(BinPresetHeader, slots) + id, SeekSet) && bf.write(binHeader->slots[id]) == 1;
+}
+
+bool binPresetLoad(byte id, JsonDocument* dest)
+{
+  BinPresetRecord rec;
+  if (!readRecord(id, rec)) return false;
+  dest->clear();
+  recordToJson(rec, dest->to<JsonObject>());
+  return true;
+}
+
+bool binPresetExists(byte id)
+{
+  return id && id < BIN_PRESET_IDS && binPresetsReady() && binHeader->slots[id];
+}
+
+void binPresetDelete(byte id)
+{
+  if (!binPresetExists(id)) return;
+  File bf = WLED_FS.open(BIN_PRESET_FILE, "r+");
+  binHeader->slots[id] = 0; //the slot is reused by the next save
+  if (!bf) return;
+  writeSlot(bf, id);
+  bf.close();
+}
+
+//stores the preset as a record if it can be represented as one, otherwise it belongs in presets.json
+bool binPresetSave(byte id, JsonObject obj)
+{
+  if (id == 0 || id >= BIN_PRESET_IDS || !binPresetsReady()) return false;
+  BinPresetRecord* rec = new BinPresetRecord;
+  if (!rec) return false;
+  if (!recordFromJson(obj, *rec)) {
+    delete rec;
+    binPresetDelete(id); //the JSON version replaces it
+    return false;
+  }
+  rec->id = id;
+
+  uint8_t slot = binHeader->slots[id];
+  if (!slot) { //first slot not used by another id
+    bool used[BIN_PRESET_IDS] = {false};
+    for (uint8_t i = 1; i < BIN_PRESET_IDS; i++) if (binHeader->slots[i]) used[binHeader->slots[i] -1] = true;
+    while (used[slot]) slot++;
+    slot++;
+  }
+
+  bool created = !WLED_FS.exists(BIN_PRESET_FILE);
+  File bf = WLED_FS.open(BIN_PRESET_FILE, created ? "w" : "r+");
+  bool ok = bf;
+  if (ok && created) ok = bf.write((uint8_t*)binHeader, sizeof(BinPresetHeader)) == sizeof(BinPresetHeader);
+  if (ok) ok = bf.seek(binRecordPos(slot -1), SeekSet) && bf.write((uint8_t*)rec, sizeof(BinPresetRecord)) == sizeof(BinPresetRecord);
+  if (ok && binHeader->slots[id] != slot) {
+    binHeader->slots[id] = slot;
+    ok = writeSlot(bf, id);
+  }
+  if (bf) bf.close();
+  delete rec;
+  DEBUGFS_PRINTF("Binary preset %d in slot %d %s\n", id, slot, ok ? "saved" : "failed");
+  return ok;
+}
+
+//one time migration: moves every preset that fits into a record out of presets.json
+void convertPresetsToBinary()
+{
+  if (WLED_FS.exists(BIN_PRESET_FILE) || !binPresetsReady()) return;
+  PSRAMDynamicJsonDocument* doc = new PSRAMDynamicJsonDocument(JSON_BUFFER_SIZE);
+  if (!doc) return;
+  DEBUGFS_PRINTLN(F("Converting presets to binary"));
+  StaticJsonDocument<24> empty;
+  for (uint8_t id = 1; id < BIN_PRESET_IDS; id++) {
+    if (!presetInFile(id) || !readObjectFromFileUsingId("/presets.json", id, doc)) continue;
+    if (doc->isNull() || !binPresetSave(id, doc->as<JsonObject>())) continue;
+    writeObjectToFileUsingId("/presets.json", id, &empty);
+  }
+  delete doc;
+  if (!WLED_FS.exists(BIN_PRESET_FILE)) { //nothing converted, remember that the migration ran
+    File bf = WLED_FS.open(BIN_PRESET_FILE, "w");
+    if (bf) {
+      bf.write((uint8_t*)binHeader, sizeof(BinPresetHeader));
+      bf.close();
+    }
+  }
+  presetsModifiedTime = toki.second();
+  updateFSInfo();
+}
+
+/*
+ * /presets.json as seen by the UI: the contents of the file with the binary records appended
+ */
+class PresetsStreamer {
+  private:
+    File _file;
+    size_t _jsonEnd = 0; //position of the closing brace of the file
+    uint8_t _id = 0;
+    bool _needComma = false;
+    String _chunk;
+    size_t _pos = 0;
+
+    //prepares the next record, returns false when the response is complete
+    bool nextRecord() {
+      _chunk = "";
+      _pos = 0;
+      if (_id >= BIN_PRESET_IDS) return false;
+      BinPresetRecord* rec = new BinPresetRecord;
+      while (rec && ++_id < BIN_PRESET_IDS) {
+        if (!binHeader->slots[_id] || !readRecord(_id, *rec)) continue;
+        PSRAMDynamicJsonDocument doc(BIN_PRESET_JSON_SIZE);
+        recordToJson(*rec, doc.to<JsonObject>());
+        if (_needComma) _chunk = ",";
+        _chunk += '"'; _chunk += _id; _chunk += F("\":");
+        serializeJson(doc, _chunk);
+        _needComma = true;
+        break;
+      }
+      delete rec;
+      if (_id >= BIN_PRESET_IDS) _chunk += "}";
+      return true;
+    }
+
+  public:
+    PresetsStreamer() {
+      _file = WLED_FS.open("/presets.json", "r");
+      bool found = false;
+      if (_file) { //find the closing brace so the records can be inserted before it
+        size_t pos = _file.size();
+        while (pos && !found) {
+          _file.seek(--pos, SeekSet);
+          found = (_file.read() == '}');
+        }
+        _jsonEnd = pos;
+        _file.seek(0, SeekSet);
+      }
+      if (!found) {
+        if (_file) _file.close();
+        _chunk = "{";
+      }
+    }
+
+    ~PresetsStreamer() {
+      if (_file) _file.close();
+    }
+
+    //fills the chunked response buffer, 0 ends the response
+    size_t fill(uint8_t* buffer, size_t maxLen) {
+      if (_file) {
+        if (_file.position() < _jsonEnd) {
+          size_t len = _file.read(buffer, min(maxLen, _jsonEnd - _file.position()));
+          for (size_t i = 0; i < len; i++) { //a comma is needed unless the object is still empty
+            char c = buffer[i];
+            if (c != ' ' && c != '\n' && c != '\r' && c != '\t') _needComma = (c != '{');
+          }
+          return len;
+        }
+        _file.close();
+      }
+      size_t len = 0;
+      while (len < maxLen) {
+        if (_pos >= _chunk.length() && !nextRecord()) break;
+        size_t n = min(maxLen - len, _chunk.length() - _pos);
+        memcpy(buffer + len, _chunk.c_str() + _pos, n);
+        _pos += n; len += n;
+      }
+      return len;
+    }
+};
+
+//presets.bin was replaced or removed, the slot table is read again on next use
+void reloadBinPresets()
+{
+  if (binHeader) memset(binHeader->slots, 0, sizeof(binHeader->slots));
+  binState = 0;
+}
+
+//presets.json was replaced as a whole (backup restore), its presets take over on the next boot
+void clearBinPresets()
+{
+  if (WLED_FS.exists(BIN_PRESET_FILE)) WLED_FS.remove(BIN_PRESET_FILE);
+  reloadBinPresets();
+}
+
+bool serveBinPresets(AsyncWebServerRequest* request)
+{
+  if (!binPresetsReady()) return false;
+  bool any = false;
+  for (uint8_t id = 1; id < BIN_PRESET_IDS && !any; id++) any = binHeader->slots[id];
+  if (!any) return false; //plain file
+  std::shared_ptr<PresetsStreamer> streamer = std::make_shared<PresetsStreamer>();
+  AsyncWebServerResponse* response = request->beginChunkedResponse("application/json", [streamer](uint8_t* buffer, size_t maxLen, size_t index) -> size_t {
+    return streamer->fill(buffer, maxLen);
+  });
+  request->send(response);
+  return true;
+}
+
+#endif
@@ -0,0 +1,223 @@
+#include "wled.h"
+
+/*
+ * Realtime recorder: captures the frames received from a realtime source as they are shown,
+ * with the colors as received (before gamma correction), for replay with the sequence player.
+ * Started with {"rec":{"file":"/capture.wrec"}} in the JSON API, {"rec":{}} stops.
+ *
+ * File format, little endian:
+ *   header  "WREC", version (1), channels per pixel (3 or 4), pixel count (uint16), reserved (uint32)
+ *   frame   ms since the previous frame (uint16), number of runs (uint16),
+ *           then per run its first pixel (uint16), length in pixels (uint16) and the channel data.
+ * Runs hold the pixels that changed since the previous recorded frame, the first frame holds all pixels.
+ * A frame is taken when the source shows it, so pixels of the next frame cannot be mixed into it.
+ * Frames are encoded into a write-behind buffer that loop() writes out in small chunks,
+ * a frame that does not fit is dropped (and counted) rather than slowing down the ingest.
+ * Only a frame larger than the whole buffer is written directly.
+ */
+#ifdef WLED_ENABLE_RECORDER
+
+#ifndef REC_BUFFER_SIZE
+  #ifdef ESP8266
+  #define REC_BUFFER_SIZE 4096  //bytes of encoded frames waiting to be written
+  #else
+  #define REC_BUFFER_SIZE 16384
+  #endif
+#endif
+#define REC_WRITE_CHUNK 1024    //bytes written per loop() pass
+#define REC_RUN_GAP     2       //unchanged pixels that end a run, shorter gaps cost less than a new run header
+
+static File recFile;
+static uint8_t* recFrame = nullptr;    //frame being received
+static uint8_t* recShown = nullptr;    //copy of the frame shown last, until it is encoded
+static uint8_t* recPrev = nullptr;     //last recorded frame, base of the deltas
+static uint8_t* recBuf = nullptr;      //write-behind ring buffer
+static uint16_t recHead = 0, recTail = 0, recUsed = 0;
+static uint16_t recPixels = 0;
+static uint8_t  recChannels = 3;
+static bool recDirty = false;          //pixels received since the last shown frame
+static bool recPending = false;        //recShown holds a frame not encoded yet
+static bool recFirst = true;           //next frame holds all pixels
+static bool recDirect = false;         //frame larger than the buffer, written straight to the file
+static unsigned long recShownTime = 0;
+static unsigned long recLastFrame = 0;
+static uint32_t recFrames = 0;
+static uint32_t recDropped = 0;
+static char recRequestFile[33];
+static int8_t recRequest = 0;          //1: start recRequestFile, -1: stop
+
+//fileName nullptr stops the recording
+void queueRecording(const char* fileName)
+{
+  if (fileName) strlcpy(recRequestFile, fileName, sizeof(recRequestFile));
+  recRequest = fileName ? 1 : -1;
+}
+
+static void recPut(const void* data, uint16_t len)
+{
+  const uint8_t* p = (const uint8_t*)data;
+  if (recDirect) {recFile.write(p, len); return;}
+  recUsed += len;
+  while (len) {
+    uint16_t n = MIN(len, REC_BUFFER_SIZE - recHead);
+    memcpy(recBuf + recHead, p, n);
+    recHead = (recHead + n) % REC_BUFFER_SIZE;
+    p += n; len -= n;
+  }
+}
+
+//writes at most maxLen bytes of the buffer, contiguous part first
+static void recFlush(uint16_t maxLen)
+{
+  while (recUsed && maxLen) {
+    uint16_t n = MIN(MIN(recUsed, maxLen), REC_BUFFER_SIZE - recTail);
+    recFile.write(recBuf + recTail, n);
+    recTail = (recTail + n) % REC_BUFFER_SIZE;
+    recUsed -= n; maxLen -= n;
+  }
+}
+
+static void freeRecording()
+{
+  free(recFrame); free(recShown); free(recPrev); free(recBuf);
+  recFrame = recShown = recPrev = recBuf = nullptr;
+}
+
+static void stopRecording()
+{
+  if (!recBuf) return;
+  recFlush(REC_BUFFER_SIZE);
+  recFile.close();
+  freeRecording();
+  DEBUG_PRINTF("Recording stopped: %u frames, %u dropped\n", recFrames, recDropped);
+}
+
+static bool startRecording(const char* fileName)
+{
+  stopRecording();
+  recPixels = strip.getLengthTotal();
+  recChannels = strip.isRgbw ? 4 : 3;
+  size_t frameSize = recPixels * recChannels;
+  recFrame = (uint8_t*) allocLarge(frameSize);
+  recShown = (uint8_t*) allocLarge(frameSize);
+  recPrev  = (uint8_t*) allocLarge(frameSize);
+  recBuf   = (uint8_t*) allocLarge(REC_BUFFER_SIZE);
+  if (!recFrame || !recShown || !recPrev || !recBuf) {freeRecording(); return false;}
+  recFile = openMediaFile(fileName, "w");
+  if (!recFile) {freeRecording(); return false;}
+
+  memset(recFrame, 0, frameSize);
+  uint8_t h[12] = {'W','R','E','C', 1, recChannels, (uint8_t)recPixels, (uint8_t)(recPixels >> 8), 0, 0, 0, 0};
+  recFile.write(h, sizeof(h));
+  recHead = recTail = recUsed = 0;
+  recDirty = false;
+  recPending = false;
+  recFirst = true;
+  recFrames = recDropped = 0;
+  DEBUG_PRINTF("Recording %u pixels to %s\n", recPixels, fileName);
+  return true;
+}
+
+//received colors, pix is the strip index after the realtime offset
+void recordPixel(uint16_t pix, byte r, byte g, byte b, byte w)
+{
+  if (!recFrame || pix >= recPixels || realtimeMode == REALTIME_MODE_FSEQ) return;
+  uint8_t* p = recFrame + pix * recChannels;
+  p[0] = r; p[1] = g; p[2] = b;
+  if (recChannels > 3) p[3] = w;
+  recDirty = true;
+}
+
+void recordPixels(uint16_t pix, const byte* data, uint16_t len, bool rgbw)
+{
+  if (!recFrame || pix >= recPixels || realtimeMode == REALTIME_MODE_FSEQ) return;
+  if (pix + len > recPixels) len = recPixels - pix;
+  uint8_t stride = rgbw ? 4 : 3;
+  if (stride == recChannels) memcpy(recFrame + pix * recChannels, data, len * stride);
+  else for (uint16_t i = 0; i < len; i++) recordPixel(pix + i, data[i*stride], data[i*stride +1], data[i*stride +2], rgbw ? data[i*stride +3] : 0);
+  recDirty = true;
+}
+
+//the realtime source shows the frame received so far, called right before strip.show()
+void recordShow()
+{
+  if (!recFrame || !recDirty) return;
+  if (recPending) recDropped++; //not encoded yet, its changes are part of this one
+  memcpy(recShown, recFrame, recPixels * recChannels);
+  recShownTime = millis();
+  recPending = true;
+  recDirty = false;
+}
+
+//finds the next run of changed pixels at or after from, false if there is none
+static bool nextRun(uint16_t from, uint16_t& start, uint16_t& len)
+{
+  uint16_t i = from;
+  while (i < recPixels && !recFirst && !memcmp(recShown + i * recChannels, recPrev + i * recChannels, recChannels)) i++;
+  if (i >= recPixels) return false;
+  start = i;
+  uint16_t end = i +1, gap = 0;
+  for (i = end; i < recPixels && gap < REC_RUN_GAP; i++) {
+    if (recFirst || memcmp(recShown + i * recChannels, recPrev + i * recChannels, recChannels)) {end = i +1; gap = 0;}
+    else gap++;
+  }
+  len = end - start;
+  return true;
+}
+
+//encodes the received frame as the delta to the previous one
+static void recordFrame()
+{
+  uint16_t runs = 0, start, len;
+  uint32_t size = 4;
+  for (uint16_t i = 0; nextRun(i, start, len); i = start + len) { runs++; size += 4 + len * recChannels; }
+  recPending = false;
+  if (!runs && !recFirst) return; //nothing changed
+  recDirect = size > REC_BUFFER_SIZE; //can never fit, this stalls the ingest once (e.g. the first frame of a long strip)
+  if (recDirect) recFlush(REC_BUFFER_SIZE);
+  else if (size > REC_BUFFER_SIZE - recUsed) {recDropped++; return;} //recPrev stays the base of the next delta
+
+  unsigned long now = recShownTime;
+  uint16_t hdr[2] = {(uint16_t)(recFirst ? 0 : MIN(now - recLastFrame, 65535UL)), runs};
+  recPut(hdr, 4);
+  for (uint16_t i = 0; nextRun(i, start, len); i = start + len) {
+    uint16_t run[2] = {start, len};
+    recPut(run, 4);
+    recPut(recShown + start * recChannels, len * recChannels);
+    memcpy(recPrev + start * recChannels, recShown + start * recChannels, len * recChannels);
+  }
+  recLastFrame = now;
+  recFirst = false;
+  recFrames++;
+}
+
+void handleRecorder()
+{
+  if (recRequest) {
+    if (recRequest > 0) startRecording(recRequestFile);
+    else                stopRecording();
+    recRequest = 0;
+  }
+  if (!recBuf) return;
+  if (recPending) recordFrame();
+  if (recUsed >= REC_WRITE_CHUNK || (recUsed && !realtimeMode)) recFlush(REC_WRITE_CHUNK);
+}
+
+bool recording() { return recBuf; }
+
+void serializeRecorderInfo(JsonObject root)
+{
+  if (!recBuf) return;
+  JsonObject rec = root.createNestedObject(F("rec"));
+  rec[F("frames")]  = recFrames;
+  rec[F("dropped")] = recDropped;
+}
+#else
+void queueRecording(const char* fileName) {}
+void recordPixel(uint16_t pix, byte r, byte g, byte b, byte w) {}
+void recordPixels(uint16_t pix, const byte* data, uint16_t len, bool rgbw) {}
+void recordShow() {}
+void handleRecorder() {}
+bool recording() { return false; }
+void serializeRecorderInfo(JsonObject root) {}
+#endif
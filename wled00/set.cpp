@@ -54,6 +54,7 @@ void handleSettingsSet(AsyncWebServerRequest *request, byte subPage)
 
     #ifdef WLED_USE_ETHERNET
     ethernetType = request->arg(F("ETH")).toInt();
+    ethernetOnly = request->hasArg(F("EO"));
     WLED::instance().initEthernet();
     #endif
 
@@ -128,6 +129,17 @@ void handleSettingsSet(AsyncWebServerRequest *request, byte subPage)
       // actual finalization is done in WLED::loop() (removing old busses and adding new)
       if (busConfigs[s] != nullptr) delete busConfigs[s];
       busConfigs[s] = new BusConfig(type, pins, start, length, colorOrder, request->hasArg(cv), skip);
+      Bus* oldBus = busses.getBus(s); //current budgets, rates and color correction are not in the form, keep the ones from cfg.json
+      if (oldBus) {
+        busConfigs[s]->milliAmpsMax = oldBus->milliAmpsMax;
+        busConfigs[s]->milliAmpsPerLed = oldBus->milliAmpsPerLed;
+        busConfigs[s]->maxFps = oldBus->getMaxFps();
+        busConfigs[s]->priority = oldBus->priority;
+        if (oldBus->getType() == busConfigs[s]->type) { //network targets keep their channels
+          busConfigs[s]->rgbw = oldBus->isRgbw();
+        }
+        oldBus->getColorMatrix(busConfigs[s]->matrix);
+      }
       doInitBusses = true;
     }
 
@@ -162,6 +174,7 @@ void handleSettingsSet(AsyncWebServerRequest *request, byte subPage)
       }
     }
     touchThreshold = request->arg(F("TT")).toInt();
+    attachButtonInterrupts();
 
     strip.ablMilliampsMax = request->arg(F("MA")).toInt();
     strip.milliampsPerLed = request->arg(F("LA")).toInt();
@@ -175,6 +188,7 @@ void handleSettingsSet(AsyncWebServerRequest *request, byte subPage)
     if (t <= 250) bootPreset = t;
     strip.gammaCorrectBri = request->hasArg(F("GB"));
     strip.gammaCorrectCol = request->hasArg(F("GC"));
+    strip.gammaCorrectOut = request->hasArg(F("GO"));
 
     fadeTransition = request->hasArg(F("TF"));
     t = request->arg(F("TD")).toInt();
@@ -223,10 +237,17 @@ void handleSettingsSet(AsyncWebServerRequest *request, byte subPage)
     notifyHue = request->hasArg(F("SH"));
     notifyMacro = request->hasArg(F("SM"));
     notifyTwice = request->hasArg(F("S2"));
+    syncPresetIds = request->hasArg(F("SI"));
+    sendAudioSync = request->hasArg(F("SN"));
+    receiveAudioSync = request->hasArg(F("RN"));
+    t = request->arg(F("SY")).toInt();
+    if (t >= 0 && t <= 1000) notifyMinInterval = t;
+    syncMulticast = request->hasArg(F("SU"));
 
     nodeListEnabled = request->hasArg(F("NL"));
     if (!nodeListEnabled) Nodes.clear();
     nodeBroadcastEnabled = request->hasArg(F("NB"));
+    vstripFollow = request->hasArg(F("VF"));
 
     receiveDirect = request->hasArg(F("RD"));
     e131SkipOutOfSequence = request->hasArg(F("ES"));
@@ -238,13 +259,18 @@ void handleSettingsSet(AsyncWebServerRequest *request, byte subPage)
     t = request->arg(F("DA")).toInt();
     if (t >= 0  && t <= 510) DMXAddress = t;
     t = request->arg(F("DM")).toInt();
-    if (t >= DMX_MODE_DISABLED && t <= DMX_MODE_MULTIPLE_RGBW) DMXMode = t;
+    if (t >= DMX_MODE_DISABLED && t <= DMX_MODE_ROUTED) DMXMode = t;
+    e131RoutesDirty = true;
+    t = request->arg(F("MM")).toInt();
+    if (t >= E131_MERGE_OFF && t <= E131_MERGE_LTP) e131MergeMode = t;
     t = request->arg(F("ET")).toInt();
     if (t > 99  && t <= 65000) realtimeTimeoutMs = t;
     arlsForceMaxBri = request->hasArg(F("FB"));
     arlsDisableGammaCorrection = request->hasArg(F("RG"));
     t = request->arg(F("WO")).toInt();
     if (t >= -255  && t <= 255) arlsOffset = t;
+    t = request->arg(F("BD")).toInt();
+    if (t >= 96 && t <= 15000 && t != serialBaud) updateBaudRate(t);
 
     alexaEnabled = request->hasArg(F("AL"));
     strlcpy(alexaInvocationName, request->arg(F("AI")).c_str(), 33);
@@ -288,6 +314,7 @@ void handleSettingsSet(AsyncWebServerRequest *request, byte subPage)
     hueApplyBri = request->hasArg(F("HB"));
     hueApplyColor = request->hasArg(F("HC"));
     huePollingEnabled = request->hasArg(F("HP"));
+    hueStreamEnabled = request->hasArg(F("HS"));
     hueStoreAllowed = true;
     reconnectHue();
     #endif
@@ -365,6 +392,7 @@ void handleSettingsSet(AsyncWebServerRequest *request, byte subPage)
       k[0] = 'W'; //weekdays
       timerWeekday[i] = request->arg(k).toInt();
     }
+    invalidateTimers();
   }
 
   //SECURITY
@@ -425,13 +453,14 @@ void handleSettingsSet(AsyncWebServerRequest *request, byte subPage)
       t = request->arg(argname).toInt();
       DMXFixtureMap[i] = t;
     }
+    doBuildDMXMap = true;
   }
   #endif
 
   //USERMODS
   if (subPage == 8)
   {
-    DynamicJsonDocument doc(JSON_BUFFER_SIZE);
+    PSRAMDynamicJsonDocument doc(JSON_BUFFER_SIZE);
     JsonObject um = doc.createNestedObject("um");
 
     size_t args = request->args();
@@ -566,11 +595,68 @@ bool updateVal(const String* req, const char* key, byte* val, byte minv, byte ma
 }
 
 
+//keys of an API request, collected in a single pass so that looking one up does not scan the whole request again
+#define API_MAX_KEYS 32
+class ApiKeys {
+  public:
+    ApiKeys(const String& req) : _req(req) {
+      const char* s = req.c_str();
+      for (uint16_t i = 0; s[i]; i++) {
+        if (s[i] != '&' && s[i] != '?') continue;
+        if (_count >= API_MAX_KEYS) { _overflow = true; return; }
+        uint16_t end = i +1;
+        while (s[end] && s[end] != '=' && s[end] != '&') end++;
+        _start[_count] = i +1;
+        _len[_count] = (end - i -1 > 255) ? 255 : end - i -1;
+        _count++;
+      }
+    }
+
+    //same position String::indexOf() found for the key pattern ("XX=", "&X=" or a bare key like "RB"), pattern in PROGMEM
+    int indexOf(const char* pattern) const {
+      if (_overflow) return _req.indexOf((const __FlashStringHelper*)pattern);
+      bool amp = (pgm_read_byte(pattern) == '&');
+      const char* key = pattern + amp;
+      uint8_t len = strlen_P(key);
+      bool eq = (len && pgm_read_byte(key + len -1) == '=');
+      if (eq) len--;
+      const char* s = _req.c_str();
+      for (uint8_t k = 0; k < _count; k++) {
+        if (_len[k] != len || strncmp_P(s + _start[k], key, len)) continue;
+        if (eq && s[_start[k] + len] != '=') continue;
+        return _start[k] - amp;
+      }
+      return -1;
+    }
+
+    inline const String& request() const { return _req; }
+
+  private:
+    const String& _req;
+    uint16_t _start[API_MAX_KEYS];
+    uint8_t _len[API_MAX_KEYS];
+    uint8_t _count = 0;
+    bool _overflow = false;
+};
+
+//updateVal() for a key looked up in the request index
+static bool updateKey(const ApiKeys& keys, const char* key, byte* val, byte minv=0, byte maxv=255)
+{
+  int pos = keys.indexOf(key);
+  if (pos < 1) return false;
+  if (keys.request().length() < (unsigned int)(pos + 4)) return false;
+  parseNumber(keys.request().c_str() + pos +3, val, minv, maxv);
+  return true;
+}
+
+
 //HTTP API request parser
 bool handleSet(AsyncWebServerRequest *request, const String& req, bool apply)
 {
+  RENDER_LOCK();
   if (!(req.indexOf("win") >= 0)) return false;
 
+  ApiKeys keys(req);
   int pos = 0;
   DEBUG_PRINT(F("API req: "));
   DEBUG_PRINTLN(req);
@@ -579,25 +665,25 @@ bool handleSet(AsyncWebServerRequest *request, const String& req, bool apply)
 
   //segment select (sets main segment)
   byte prevMain = strip.getMainSegmentId();
-  pos = req.indexOf(F("SM="));
+  pos = keys.indexOf(PSTR("SM="));
   if (pos > 0) {
     strip.mainSegment = getNumVal(&req, pos);
   }
   byte selectedSeg = strip.getMainSegmentId();
   if (selectedSeg != prevMain) setValuesFromMainSeg();
 
-  pos = req.indexOf(F("SS="));
+  pos = keys.indexOf(PSTR("SS="));
   if (pos > 0) {
     byte t = getNumVal(&req, pos);
     if (t < strip.getMaxSegments()) selectedSeg = t;
   }
 
   WS2812FX::Segment& selseg = strip.getSegment(selectedSeg);
-  pos = req.indexOf(F("SV=")); //segment selected
+  pos = keys.indexOf(PSTR("SV=")); //segment selected
   if (pos > 0) {
     byte t = getNumVal(&req, pos);
     if (t == 2) {
-      for (uint8_t i = 0; i < strip.getMaxSegments(); i++)
+      for (uint8_t i = 0; i < strip.getSegmentCount(); i++)
       {
         strip.getSegment(i).setOption(SEG_OPTION_SELECTED, 0);
       }
@@ -609,32 +695,32 @@ bool handleSet(AsyncWebServerRequest *request, const String& req, bool apply)
   uint16_t stopI  = selseg.stop;
   uint8_t  grpI   = selseg.grouping;
   uint16_t spcI   = selseg.spacing;
-  pos = req.indexOf(F("&S=")); //segment start
+  pos = keys.indexOf(PSTR("&S=")); //segment start
   if (pos > 0) {
     startI = getNumVal(&req, pos);
   }
-  pos = req.indexOf(F("S2=")); //segment stop
+  pos = keys.indexOf(PSTR("S2=")); //segment stop
   if (pos > 0) {
     stopI = getNumVal(&req, pos);
   }
-  pos = req.indexOf(F("GP=")); //segment grouping
+  pos = keys.indexOf(PSTR("GP=")); //segment grouping
   if (pos > 0) {
     grpI = getNumVal(&req, pos);
     if (grpI == 0) grpI = 1;
   }
-  pos = req.indexOf(F("SP=")); //segment spacing
+  pos = keys.indexOf(PSTR("SP=")); //segment spacing
   if (pos > 0) {
     spcI = getNumVal(&req, pos);
   }
   strip.setSegment(selectedSeg, startI, stopI, grpI, spcI);
 
-  pos = req.indexOf(F("RV=")); //Segment reverse
+  pos = keys.indexOf(PSTR("RV=")); //Segment reverse
   if (pos > 0) selseg.setOption(SEG_OPTION_REVERSED, req.charAt(pos+3) != '0');
 
-  pos = req.indexOf(F("MI=")); //Segment mirror
+  pos = keys.indexOf(PSTR("MI=")); //Segment mirror
   if (pos > 0) selseg.setOption(SEG_OPTION_MIRROR, req.charAt(pos+3) != '0');
 
-  pos = req.indexOf(F("SB=")); //Segment brightness/opacity
+  pos = keys.indexOf(PSTR("SB=")); //Segment brightness/opacity
   if (pos > 0) {
     byte segbri = getNumVal(&req, pos);
     selseg.setOption(SEG_OPTION_ON, segbri, selectedSeg);
@@ -643,7 +729,7 @@ bool handleSet(AsyncWebServerRequest *request, const String& req, bool apply)
     }
   }
 
-  pos = req.indexOf(F("SW=")); //segment power
+  pos = keys.indexOf(PSTR("SW=")); //segment power
   if (pos > 0) {
     switch (getNumVal(&req, pos)) {
       case 0: selseg.setOption(SEG_OPTION_ON, false); break;
@@ -652,20 +738,20 @@ bool handleSet(AsyncWebServerRequest *request, const String& req, bool apply)
     }
   }
 
-  pos = req.indexOf(F("PS=")); //saves current in preset
+  pos = keys.indexOf(PSTR("PS=")); //saves current in preset
   if (pos > 0) savePreset(getNumVal(&req, pos));
 
   byte presetCycleMin = 1;
   byte presetCycleMax = 5;
 
-  pos = req.indexOf(F("P1=")); //sets first preset for cycle
+  pos = keys.indexOf(PSTR("P1=")); //sets first preset for cycle
   if (pos > 0) presetCycleMin = getNumVal(&req, pos);
 
-  pos = req.indexOf(F("P2=")); //sets last preset for cycle
+  pos = keys.indexOf(PSTR("P2=")); //sets last preset for cycle
   if (pos > 0) presetCycleMax = getNumVal(&req, pos);
 
   //apply preset
-  if (updateVal(&req, "PL=", &presetCycCurr, presetCycleMin, presetCycleMax)) {
+  if (updateKey(keys, PSTR("PL="), &presetCycCurr, presetCycleMin, presetCycleMax)) {
     applyPreset(presetCycCurr);
   }
 
@@ -678,21 +764,21 @@ bool handleSet(AsyncWebServerRequest *request, const String& req, bool apply)
   byte prevPalette = effectPalette;
 
   //set brightness
-  updateVal(&req, "&A=", &bri);
+  updateKey(keys, PSTR("&A="), &bri);
 
   //set colors
-  updateVal(&req, "&R=", &col[0]);
-  updateVal(&req, "&G=", &col[1]);
-  updateVal(&req, "&B=", &col[2]);
-  updateVal(&req, "&W=", &col[3]);
-  updateVal(&req, "R2=", &colSec[0]);
-  updateVal(&req, "G2=", &colSec[1]);
-  updateVal(&req, "B2=", &colSec[2]);
-  updateVal(&req, "W2=", &colSec[3]);
+  updateKey(keys, PSTR("&R="), &col[0]);
+  updateKey(keys, PSTR("&G="), &col[1]);
+  updateKey(keys, PSTR("&B="), &col[2]);
+  updateKey(keys, PSTR("&W="), &col[3]);
+  updateKey(keys, PSTR("R2="), &colSec[0]);
+  updateKey(keys, PSTR("G2="), &colSec[1]);
+  updateKey(keys, PSTR("B2="), &colSec[2]);
+  updateKey(keys, PSTR("W2="), &colSec[3]);
 
   #ifdef WLED_ENABLE_LOXONE
   //lox parser
-  pos = req.indexOf(F("LX=")); // Lox primary color
+  pos = keys.indexOf(PSTR("LX=")); // Lox primary color
   if (pos > 0) {
     int lxValue = getNumVal(&req, pos);
     if (parseLx(lxValue, col)) {
@@ -700,7 +786,7 @@ bool handleSet(AsyncWebServerRequest *request, const String& req, bool apply)
       nightlightActive = false; //always disable nightlight when toggling
     }
   }
-  pos = req.indexOf(F("LY=")); // Lox secondary color
+  pos = keys.indexOf(PSTR("LY=")); // Lox secondary color
   if (pos > 0) {
     int lxValue = getNumVal(&req, pos);
     if(parseLx(lxValue, colSec)) {
@@ -711,33 +797,33 @@ bool handleSet(AsyncWebServerRequest *request, const String& req, bool apply)
   #endif
 
   //set hue
-  pos = req.indexOf(F("HU="));
+  pos = keys.indexOf(PSTR("HU="));
   if (pos > 0) {
     uint16_t temphue = getNumVal(&req, pos);
     byte tempsat = 255;
-    pos = req.indexOf(F("SA="));
+    pos = keys.indexOf(PSTR("SA="));
     if (pos > 0) {
       tempsat = getNumVal(&req, pos);
     }
-    colorHStoRGB(temphue,tempsat,(req.indexOf(F("H2"))>0)? colSec:col);
+    colorHStoRGB(temphue,tempsat,(keys.indexOf(PSTR("H2"))>0)? colSec:col);
   }
 
   //set white spectrum (kelvin)
-  pos = req.indexOf(F("&K="));
+  pos = keys.indexOf(PSTR("&K="));
   if (pos > 0) {
-    colorKtoRGB(getNumVal(&req, pos),(req.indexOf(F("K2"))>0)? colSec:col);
+    colorKtoRGB(getNumVal(&req, pos),(keys.indexOf(PSTR("K2"))>0)? colSec:col);
   }
 
   //set color from HEX or 32bit DEC
-  pos = req.indexOf(F("CL="));
+  pos = keys.indexOf(PSTR("CL="));
   if (pos > 0) {
     colorFromDecOrHexString(col, (char*)req.substring(pos + 3).c_str());
   }
-  pos = req.indexOf(F("C2="));
+  pos = keys.indexOf(PSTR("C2="));
   if (pos > 0) {
     colorFromDecOrHexString(colSec, (char*)req.substring(pos + 3).c_str());
   }
-  pos = req.indexOf(F("C3="));
+  pos = keys.indexOf(PSTR("C3="));
   if (pos > 0) {
     byte t[4];
     colorFromDecOrHexString(t, (char*)req.substring(pos + 3).c_str());
@@ -750,13 +836,13 @@ bool handleSet(AsyncWebServerRequest *request, const String& req, bool apply)
   }
 
   //set to random hue SR=0->1st SR=1->2nd
-  pos = req.indexOf(F("SR"));
+  pos = keys.indexOf(PSTR("SR"));
   if (pos > 0) {
     _setRandomColor(getNumVal(&req, pos));
   }
 
   //swap 2nd & 1st
-  pos = req.indexOf(F("SC"));
+  pos = keys.indexOf(PSTR("SC"));
   if (pos > 0) {
     byte temp;
     for (uint8_t i=0; i<4; i++)
@@ -768,37 +854,37 @@ bool handleSet(AsyncWebServerRequest *request, const String& req, bool apply)
   }
 
   //set effect parameters
-  if (updateVal(&req, "FX=", &effectCurrent, 0, strip.getModeCount()-1) && request != nullptr) unloadPlaylist();  //unload playlist if changing FX using web request
-  updateVal(&req, "SX=", &effectSpeed);
-  updateVal(&req, "IX=", &effectIntensity);
-  updateVal(&req, "FP=", &effectPalette, 0, strip.getPaletteCount()-1);
+  if (updateKey(keys, PSTR("FX="), &effectCurrent, 0, strip.getModeCount()-1) && request != nullptr) unloadPlaylist();  //unload playlist if changing FX using web request
+  updateKey(keys, PSTR("SX="), &effectSpeed);
+  updateKey(keys, PSTR("IX="), &effectIntensity);
+  updateKey(keys, PSTR("FP="), &effectPalette, 0, strip.getPaletteCount()-1);
 
   //set advanced overlay
-  pos = req.indexOf(F("OL="));
+  pos = keys.indexOf(PSTR("OL="));
   if (pos > 0) {
     overlayCurrent = getNumVal(&req, pos);
   }
 
   //apply macro (deprecated, added for compatibility with pre-0.11 automations)
-  pos = req.indexOf(F("&M="));
+  pos = keys.indexOf(PSTR("&M="));
   if (pos > 0) {
     applyPreset(getNumVal(&req, pos) + 16);
   }
 
   //toggle send UDP direct notifications
-  pos = req.indexOf(F("SN="));
+  pos = keys.indexOf(PSTR("SN="));
   if (pos > 0) notifyDirect = (req.charAt(pos+3) != '0');
 
   //toggle receive UDP direct notifications
-  pos = req.indexOf(F("RN="));
+  pos = keys.indexOf(PSTR("RN="));
   if (pos > 0) receiveNotifications = (req.charAt(pos+3) != '0');
 
   //receive live data via UDP/Hyperion
-  pos = req.indexOf(F("RD="));
+  pos = keys.indexOf(PSTR("RD="));
   if (pos > 0) receiveDirect = (req.charAt(pos+3) != '0');
 
   //main toggle on/off (parse before nightlight, #1214)
-  pos = req.indexOf(F("&T="));
+  pos = keys.indexOf(PSTR("&T="));
   if (pos > 0) {
     nightlightActive = false; //always disable nightlight when toggling
     switch (getNumVal(&req, pos))
@@ -811,8 +897,8 @@ bool handleSet(AsyncWebServerRequest *request, const String& req, bool apply)
 
   //toggle nightlight mode
   bool aNlDef = false;
-  if (req.indexOf(F("&ND")) > 0) aNlDef = true;
-  pos = req.indexOf(F("NL="));
+  if (keys.indexOf(PSTR("&ND")) > 0) aNlDef = true;
+  pos = keys.indexOf(PSTR("NL="));
   if (pos > 0)
   {
     if (req.charAt(pos+3) == '0')
@@ -830,14 +916,14 @@ bool handleSet(AsyncWebServerRequest *request, const String& req, bool apply)
   }
 
   //set nightlight target brightness
-  pos = req.indexOf(F("NT="));
+  pos = keys.indexOf(PSTR("NT="));
   if (pos > 0) {
     nightlightTargetBri = getNumVal(&req, pos);
     nightlightActiveOld = false; //re-init
   }
 
   //toggle nightlight fade
-  pos = req.indexOf(F("NF="));
+  pos = keys.indexOf(PSTR("NF="));
   if (pos > 0)
   {
     nightlightMode = getNumVal(&req, pos);
@@ -846,56 +932,56 @@ bool handleSet(AsyncWebServerRequest *request, const String& req, bool apply)
   }
   if (nightlightMode > NL_MODE_SUN) nightlightMode = NL_MODE_SUN;
 
-  pos = req.indexOf(F("TT="));
+  pos = keys.indexOf(PSTR("TT="));
   if (pos > 0) transitionDelay = getNumVal(&req, pos);
 
   //set time (unix timestamp)
-  pos = req.indexOf(F("ST="));
+  pos = keys.indexOf(PSTR("ST="));
   if (pos > 0) {
     setTimeFromAPI(getNumVal(&req, pos));
   }
 
   //set countdown goal (unix timestamp)
-  pos = req.indexOf(F("CT="));
+  pos = keys.indexOf(PSTR("CT="));
   if (pos > 0) {
     countdownTime = getNumVal(&req, pos);
     if (countdownTime - toki.second() > 0) countdownOverTriggered = false;
   }
 
-  pos = req.indexOf(F("LO="));
+  pos = keys.indexOf(PSTR("LO="));
   if (pos > 0) {
     realtimeOverride = getNumVal(&req, pos);
     if (realtimeOverride > 2) realtimeOverride = REALTIME_OVERRIDE_ALWAYS;
   }
 
-  pos = req.indexOf(F("RB"));
+  pos = keys.indexOf(PSTR("RB"));
   if (pos > 0) doReboot = true;
 
   //cronixie
   #ifndef WLED_DISABLE_CRONIXIE
   //mode, 1 countdown
-  pos = req.indexOf(F("NM="));
+  pos = keys.indexOf(PSTR("NM="));
   if (pos > 0) countdownMode = (req.charAt(pos+3) != '0');
   
-  pos = req.indexOf(F("NX=")); //sets digits to code
+  pos = keys.indexOf(PSTR("NX=")); //sets digits to code
   if (pos > 0) {
     strlcpy(cronixieDisplay, req.substring(pos + 3, pos + 9).c_str(), 7);
     setCronixie();
   }
 
-  pos = req.indexOf(F("NB="));
+  pos = keys.indexOf(PSTR("NB="));
   if (pos > 0) //sets backlight
   {
     cronixieBacklight = (req.charAt(pos+3) != '0');
   }
   #endif
 
-  pos = req.indexOf(F("U0=")); //user var 0
+  pos = keys.indexOf(PSTR("U0=")); //user var 0
   if (pos > 0) {
     userVar0 = getNumVal(&req, pos);
   }
 
-  pos = req.indexOf(F("U1=")); //user var 1
+  pos = keys.indexOf(PSTR("U1=")); //user var 1
   if (pos > 0) {
     userVar1 = getNumVal(&req, pos);
   }
@@ -907,7 +993,7 @@ bool handleSet(AsyncWebServerRequest *request, const String& req, bool apply)
     if (col[i] != prevCol[i]) col0Changed = true;
     if (colSec[i] != prevColSec[i]) col1Changed = true;
   }
-  for (uint8_t i = 0; i < strip.getMaxSegments(); i++)
+  for (uint8_t i = 0; i < strip.getSegmentCount(); i++)
   {
     WS2812FX::Segment& seg = strip.getSegment(i);
     if (!seg.isSelected()) continue;
@@ -946,12 +1032,12 @@ bool handleSet(AsyncWebServerRequest *request, const String& req, bool apply)
   if (!apply) return true; //when called by JSON API, do not call colorUpdated() here
   
   //internal call, does not send XML response
-  pos = req.indexOf(F("IN"));
+  pos = keys.indexOf(PSTR("IN"));
   if (pos < 1) XML_response(request);
 
   strip.applyToAllSelected = false;
 
-  pos = req.indexOf(F("&NN")); //do not send UDP notifications this time
+  pos = keys.indexOf(PSTR("&NN")); //do not send UDP notifications this time
   colorUpdated((pos > 0) ? CALL_MODE_NO_NOTIFY : CALL_MODE_DIRECT_CHANGE);
 
   return true;
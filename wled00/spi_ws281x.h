@@ -0,0 +1,134 @@
+#ifndef SPI_WS281X_H
+#define SPI_WS281X_H
+
+/*
+ * NeoPixelBus method sending WS281x by SPI DMA, for chips without I2S output in NeoPixelBus (ESP32-C3).
+ * Every data bit is 4 SPI bits on MOSI (the data pin, no clock pin), the bit value sets the high time.
+ * Reset bytes at the end of the DMA buffer latch the LEDs. One transaction per frame,
+ * so at most about 2700 RGB LEDs (32kB, the DMA limit of one SPI transfer).
+ * The SPI host is not shared: a hardware SPI APA102 bus can't be used at the same time.
+ */
+#include <driver/spi_master.h>
+
+#ifndef WLED_SPI_WS281X_HOST
+  #define WLED_SPI_WS281X_HOST SPI2_HOST
+#endif
+
+//SPI clock and the 4 bit patterns of a 0 and a 1
+class NeoEsp32SpiSpeedWs2812x {
+public:
+  static const uint32_t Clock = 3200000; //312.5ns per SPI bit: 0 = 312/937ns, 1 = 937/312ns high/low
+  static const uint8_t Bit0 = 0b1000;
+  static const uint8_t Bit1 = 0b1110;
+  static const uint16_t ResetUs = 300;
+};
+
+class NeoEsp32SpiSpeed400Kbps {
+public:
+  static const uint32_t Clock = 1600000; //625ns per SPI bit: 0 = 625/1875ns, 1 = 1250/1250ns high/low
+  static const uint8_t Bit0 = 0b1000;
+  static const uint8_t Bit1 = 0b1100;
+  static const uint16_t ResetUs = 50;
+};
+
+template<typename T_SPEED> class NeoEsp32SpiMethodBase
+{
+public:
+  typedef NeoNoSettings SettingsObject;
+
+  NeoEsp32SpiMethodBase(uint8_t pin, uint16_t pixelCount, size_t elementSize, size_t settingsSize) :
+    _sizeData(pixelCount * elementSize + settingsSize),
+    _pin(pin)
+  {
+    _sizeDma = _sizeData * 4 + T_SPEED::Clock / 8 * T_SPEED::ResetUs / 1000000 + 1;
+    _data = static_cast<uint8_t*>(malloc(_sizeData));
+    _dma = static_cast<uint8_t*>(heap_caps_malloc(_sizeDma, MALLOC_CAP_DMA));
+  }
+
+  ~NeoEsp32SpiMethodBase()
+  {
+    if (_spi) {
+      if (_pending) {
+        spi_transaction_t* t;
+        spi_device_get_trans_result(_spi, &t, portMAX_DELAY);
+      }
+      spi_bus_remove_device(_spi);
+      spi_bus_free(WLED_SPI_WS281X_HOST);
+    }
+    free(_data);
+    heap_caps_free(_dma);
+  }
+
+  bool IsReadyToUpdate() const
+  {
+    if (!_pending) return true;
+    spi_transaction_t* t;
+    if (spi_device_get_trans_result(_spi, &t, 0) != ESP_OK) return false;
+    _pending = false;
+    return true;
+  }
+
+  void Initialize()
+  {
+    if (!_data || !_dma) return;
+    memset(_data, 0, _sizeData);
+    memset(_dma, 0, _sizeDma); //the reset bytes stay 0
+    spi_bus_config_t bus = {};
+    bus.mosi_io_num = _pin;
+    bus.miso_io_num = -1;
+    bus.sclk_io_num = -1;
+    bus.quadwp_io_num = -1;
+    bus.quadhd_io_num = -1;
+    bus.max_transfer_sz = _sizeDma;
+    if (spi_bus_initialize(WLED_SPI_WS281X_HOST, &bus, SPI_DMA_CH_AUTO) != ESP_OK) return;
+    spi_device_interface_config_t dev = {};
+    dev.clock_speed_hz = T_SPEED::Clock;
+    dev.mode = 0;
+    dev.spics_io_num = -1;
+    dev.queue_size = 1;
+    if (spi_bus_add_device(WLED_SPI_WS281X_HOST, &dev, &_spi) != ESP_OK) {
+      spi_bus_free(WLED_SPI_WS281X_HOST);
+      _spi = nullptr;
+    }
+  }
+
+  void Update(bool)
+  {
+    if (!_spi) return;
+    while (!IsReadyToUpdate()) yield();
+    uint8_t* out = _dma;
+    for (size_t i = 0; i < _sizeData; i++) {
+      uint8_t b = _data[i];
+      for (uint8_t n = 0; n < 4; n++, b <<= 2) { //2 data bits per SPI byte, MSB first
+        *out++ = ((b & 0x80) ? T_SPEED::Bit1 : T_SPEED::Bit0) << 4 | ((b & 0x40) ? T_SPEED::Bit1 : T_SPEED::Bit0);
+      }
+    }
+    memset(&_trans, 0, sizeof(_trans));
+    _trans.length = _sizeDma * 8; //bits
+    _trans.tx_buffer = _dma;
+    if (spi_device_queue_trans(_spi, &_trans, 0) == ESP_OK) _pending = true;
+  }
+
+  bool AlwaysUpdate() { return false; }
+
+  uint8_t* getData() const { return _data; }
+
+  size_t getDataSize() const { return _sizeData; }
+
+  void applySettings(const SettingsObject& settings) {}
+
+private:
+  const size_t _sizeData;
+  size_t _sizeDma;
+  const uint8_t _pin;
+  uint8_t* _data = nullptr;
+  uint8_t* _dma = nullptr;      //encoded frame, DMA capable memory
+  spi_device_handle_t _spi = nullptr;
+  spi_transaction_t _trans;
+  mutable bool _pending = false; //transaction queued, result not yet taken
+};
+
+typedef NeoEsp32SpiMethodBase<NeoEsp32SpiSpeedWs2812x> NeoEsp32SpiWs2812xMethod;
+typedef NeoEsp32SpiMethodBase<NeoEsp32SpiSpeed400Kbps> NeoEsp32Spi400KbpsMethod;
+
+#endif
@@ -24,19 +24,27 @@
 #define DMXFORMAT      SERIAL_8N2
 #define BREAKSPEED     83333
 #define BREAKFORMAT    SERIAL_8N1
+#define DRAIN_US       50     //last byte in the shift register after the FIFO ran empty
+#define BREAK_US       1120   //break byte and mark after break, as update() sends them
 
 bool dmxStarted = false;
 int sendPin = 2;		//dafault on ESP8266
 
 //DMX value array and size. Entry 0 will hold startbyte
-uint8_t dmxData[dmxMaxChannel] = {};
+uint8_t dmxData[dmxMaxChannel+1] = {};
 int chanSize;
+int sendPos = -1;   //next byte of a frame sent with continueUpdate(), -1 if idle
+enum { PHASE_IDLE, PHASE_DRAIN, PHASE_BREAK, PHASE_DATA };
+uint8_t sendPhase = PHASE_IDLE;
+unsigned long phaseStart = 0;
+int fifoEmpty = 0;  //availableForWrite() with nothing left to send
 
 
 void DMXESPSerial::init() {
   chanSize = defaultMax;
 
   Serial1.begin(DMXSPEED);
+  fifoEmpty = Serial1.availableForWrite();
   pinMode(sendPin, OUTPUT);
   dmxStarted = true;
 }
@@ -44,13 +52,14 @@ void DMXESPSerial::init() {
 // Set up the DMX-Protocol
 void DMXESPSerial::init(int chanQuant) {
 
-  if (chanQuant > dmxMaxChannel || chanQuant <= 0) {
+  if (chanQuant > dmxMaxChannel+1 || chanQuant <= 0) {
     chanQuant = defaultMax;
   }
 
   chanSize = chanQuant;
 
   Serial1.begin(DMXSPEED);
+  fifoEmpty = Serial1.availableForWrite();
   pinMode(sendPin, OUTPUT);
   dmxStarted = true;
 }
@@ -76,10 +85,23 @@ void DMXESPSerial::write(int Channel, uint8_t value) {
   dmxData[Channel] = value;
 }
 
+// Copies consecutive channels starting at channel, values beyond the bus length are dropped
+void DMXESPSerial::write(int Channel, const uint8_t* values, int len) {
+  if (dmxStarted == false) init();
+
+  if (Channel < 1) Channel = 1;
+  if (Channel + len > chanSize) len = chanSize - Channel;
+  if (len <= 0) return;
+
+  memcpy(dmxData + Channel, values, len);
+}
+
 void DMXESPSerial::end() {
   chanSize = 0;
   Serial1.end();
   dmxStarted = false;
+  sendPos = -1;
+  sendPhase = PHASE_IDLE;
 }
 
 void DMXESPSerial::update() {
@@ -102,4 +124,54 @@ void DMXESPSerial::update() {
   Serial1.end();
 }
 
-// Function to update the DMX bus
+// Non-blocking variant of update(): beginUpdate() starts a frame, continueUpdate() then waits for the previous
+// frame to leave the UART, sends the break and refills the UART FIFO on every call.
+// It returns true while the frame is still being sent
+void DMXESPSerial::beginUpdate() {
+  if (dmxStarted == false) init();
+
+  sendPos = -1;
+  sendPhase = PHASE_DRAIN;
+  phaseStart = micros();
+  continueUpdate();
+}
+
+bool DMXESPSerial::continueUpdate() {
+  switch (sendPhase) {
+    case PHASE_IDLE:
+      return false;
+
+    case PHASE_DRAIN: //last frame must have left the UART before the line is used for the break
+      if (Serial1.availableForWrite() < fifoEmpty) phaseStart = micros();
+      if (micros() - phaseStart < DRAIN_US) return true;
+      Serial1.end();
+
+      //Send break
+      digitalWrite(sendPin, HIGH);
+      Serial1.begin(BREAKSPEED, BREAKFORMAT);
+      Serial1.write(0);
+      sendPhase = PHASE_BREAK;
+      phaseStart = micros();
+      return true;
+
+    case PHASE_BREAK:
+      if (micros() - phaseStart < BREAK_US) return true;
+      Serial1.end();
+
+      Serial1.begin(DMXSPEED, DMXFORMAT);
+      digitalWrite(sendPin, LOW);
+      sendPos = 0;
+      sendPhase = PHASE_DATA;
+      //fall through
+
+    default: {
+      int len = Serial1.availableForWrite();
+      if (len > chanSize - sendPos) len = chanSize - sendPos;
+      if (len > 0) sendPos += Serial1.write(dmxData + sendPos, len);
+      if (sendPos < chanSize) return true;
+      sendPos = -1;
+      sendPhase = PHASE_IDLE;
+      return false;
+    }
+  }
+}
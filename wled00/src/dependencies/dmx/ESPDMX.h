@@ -24,7 +24,10 @@ public:
   void init(int MaxChan);
   uint8_t read(int Channel);
   void write(int channel, uint8_t value);
+  void write(int channel, const uint8_t* values, int len);
   void update();
+  void beginUpdate();
+  bool continueUpdate();
   void end();
 };
 
@@ -53,7 +53,18 @@ typedef struct ip_addr ip4_addr_t;
 #define DDP_PUSH_FLAG 0x01
 #define DDP_TIMECODE_FLAG 0x10
 
+// DDP data type: bits 3-5 pixel format, bits 0-2 bits per element
+#define DDP_TYPE_FORMAT(t) (((t) >> 3) & 0x07)
+#define DDP_TYPE_SIZE(t)   ((t) & 0x07)
+#define DDP_FORMAT_UNDEFINED 0
+#define DDP_FORMAT_RGB       1
+#define DDP_FORMAT_RGBW      3
+#define DDP_SIZE_UNDEFINED   0
+#define DDP_SIZE_8BIT        3
+#define DDP_SIZE_16BIT       4
+
 #define ARTNET_OPCODE_OPDMX 0x5000
+#define ARTNET_OPCODE_OPSYNC 0x5200
 
 #define P_E131   0
 #define P_ARTNET 1
@@ -84,6 +95,12 @@ typedef struct ip_addr ip4_addr_t;
 #define E131_DMP_COUNT 123
 #define E131_DMP_DATA 125
 
+// E1.31 synchronization packet
+#define E131_VECTOR_ROOT_EXTENDED 0x00000008
+#define E131_VECTOR_FRAME_SYNC 0x00000001
+#define E131_SYNC_SEQ 44
+#define E131_SYNC_ADDR 45
+
 // E1.31 Packet Structure
 typedef union {
     struct { //E1.31 packet
@@ -100,7 +117,7 @@ typedef union {
       uint32_t frame_vector;
       uint8_t  source_name[64];
       uint8_t  priority;
-      uint16_t reserved;
+      uint16_t sync_address;  // universe to wait for a sync packet on (0 = none)
       uint8_t  sequence_number;
       uint8_t  options;
       uint16_t universe;
@@ -152,7 +169,7 @@ typedef union {
 } e131_packet_t;
 
 // new packet callback
-typedef void (*e131_packet_callback_function) (e131_packet_t* p, IPAddress clientIP, byte protocol);
+typedef void (*e131_packet_callback_function) (e131_packet_t* p, IPAddress clientIP, byte protocol, uint16_t len);
 
 class ESPAsyncE131 {
  private:
@@ -28,6 +28,11 @@
  #define ESPALEXA_MAXDEVICES 10 //this limit only has memory reasons, set it higher should you need to, max 128
 #endif
 
+//an Echo sends its M-SEARCH in bursts, only the first one of each device within this time is answered
+#ifndef ESPALEXA_SSDP_MIN_INTERVAL
+ #define ESPALEXA_SSDP_MIN_INTERVAL 1000
+#endif
+
 //#define ESPALEXA_DEBUG
 
 #ifdef ESPALEXA_ASYNC
@@ -85,6 +90,15 @@ private:
   IPAddress ipMulti;
   uint32_t mac24; //bottom 24 bits of mac
   String escapedMac=""; //lowercase mac address
+
+  //pre-rendered responses, Echo devices poll them often
+  String deviceJsonCache[ESPALEXA_MAXDEVICES];
+  uint16_t deviceJsonVersion[ESPALEXA_MAXDEVICES] = {}; //EspalexaDevice::getVersion() of the cached JSON, 0 = none
+  String descriptionCache = "";
+  String searchResponseCache = "";
+  uint32_t cachedIP = 0; //address the description and search response were rendered for
+  uint32_t lastSearchIP = 0;
+  unsigned long lastSearchTime = 0;
   
   //private member functions
   const char* modeString(EspalexaColorMode m)
@@ -141,6 +155,61 @@ private:
     return (((uint32_t)key>>7) == mac24) ? (key & 127U) : 255U;
   }
 
+  //cached device JSON, rendered again only if a property of the device changed
+  const String& deviceJson(uint8_t idx)
+  {
+    EspalexaDevice* dev = devices[idx];
+    if (deviceJsonVersion[idx] != dev->getVersion() || !deviceJsonCache[idx].length()) {
+      char buf[512];
+      deviceJsonString(dev, buf);
+      deviceJsonCache[idx] = buf;
+      deviceJsonVersion[idx] = dev->getVersion();
+    }
+    return deviceJsonCache[idx];
+  }
+
+  //description and search response only depend on the IP and MAC
+  void renderDiscovery()
+  {
+    IPAddress localIP = Network.localIP();
+    if (cachedIP == (uint32_t)localIP && descriptionCache.length()) return;
+    cachedIP = localIP;
+    char s[16];
+    sprintf(s, "%d.%d.%d.%d", localIP[0], localIP[1], localIP[2], localIP[3]);
+    char buf[1024];
+
+    sprintf_P(buf,PSTR("<?xml version=\"1.0\" ?>"
+        "<root xmlns=\"urn:schemas-upnp-org:device-1-0\">"
+        "<specVersion><major>1</major><minor>0</minor></specVersion>"
+        "<URLBase>http://%s:80/</URLBase>"
+        "<device>"
+          "<deviceType>urn:schemas-upnp-org:device:Basic:1</deviceType>"
+          "<friendlyName>Espalexa (%s:80)</friendlyName>"
+          "<manufacturer>Royal Philips Electronics</manufacturer>"
+          "<manufacturerURL>http://www.philips.com</manufacturerURL>"
+          "<modelDescription>Philips hue Personal Wireless Lighting</modelDescription>"
+          "<modelName>Philips hue bridge 2012</modelName>"
+          "<modelNumber>929000226503</modelNumber>"
+          "<modelURL>http://www.meethue.com</modelURL>"
+          "<serialNumber>%s</serialNumber>"
+          "<UDN>uuid:2f402f80-da50-11e1-9b23-%s</UDN>"
+          "<presentationURL>index.html</presentationURL>"
+        "</device>"
+        "</root>"),s,s,escapedMac.c_str(),escapedMac.c_str());
+    descriptionCache = buf;
+
+    sprintf_P(buf,PSTR("HTTP/1.1 200 OK\r\n"
+      "EXT:\r\n"
+      "CACHE-CONTROL: max-age=100\r\n" // SSDP_INTERVAL
+      "LOCATION: http://%s:80/description.xml\r\n"
+      "SERVER: FreeRTOS/6.0.5, UPnP/1.0, IpBridge/1.17.0\r\n" // _modelName, _modelNumber
+      "hue-bridgeid: %s\r\n"
+      "ST: urn:schemas-upnp-org:device:basic:1\r\n"  // _deviceType
+      "USN: uuid:2f402f80-da50-11e1-9b23-%s::upnp:rootdevice\r\n" // _uuid::_deviceType
+      "\r\n"),s,escapedMac.c_str(),escapedMac.c_str());
+    searchResponseCache = buf;
+  }
+
   //device JSON string: color+temperature device emulates LCT015, dimmable device LWB010, (TODO: on/off Plug 01, color temperature device LWT010, color device LST001)
   void deviceJsonString(EspalexaDevice* dev, char* buf)
   {
@@ -217,34 +286,11 @@ private:
   void serveDescription()
   {
     EA_DEBUGLN("# Responding to description.xml ... #\n");
-    IPAddress localIP = Network.localIP();
-    char s[16];
-    sprintf(s, "%d.%d.%d.%d", localIP[0], localIP[1], localIP[2], localIP[3]);
-    char buf[1024];
-    
-    sprintf_P(buf,PSTR("<?xml version=\"1.0\" ?>"
-        "<root xmlns=\"urn:schemas-upnp-org:device-1-0\">"
-        "<specVersion><major>1</major><minor>0</minor></specVersion>"
-        "<URLBase>http://%s:80/</URLBase>"
-        "<device>"
-          "<deviceType>urn:schemas-upnp-org:device:Basic:1</deviceType>"
-          "<friendlyName>Espalexa (%s:80)</friendlyName>"
-          "<manufacturer>Royal Philips Electronics</manufacturer>"
-          "<manufacturerURL>http://www.philips.com</manufacturerURL>"
-          "<modelDescription>Philips hue Personal Wireless Lighting</modelDescription>"
-          "<modelName>Philips hue bridge 2012</modelName>"
-          "<modelNumber>929000226503</modelNumber>"
-          "<modelURL>http://www.meethue.com</modelURL>"
-          "<serialNumber>%s</serialNumber>"
-          "<UDN>uuid:2f402f80-da50-11e1-9b23-%s</UDN>"
-          "<presentationURL>index.html</presentationURL>"
-        "</device>"
-        "</root>"),s,s,escapedMac.c_str(),escapedMac.c_str());
-          
-    server->send(200, "text/xml", buf);
-    
+    renderDiscovery();
+    server->send(200, "text/xml", descriptionCache);
+
     EA_DEBUGLN("Send setup.xml");
-    EA_DEBUGLN(buf);
+    EA_DEBUGLN(descriptionCache);
   }
   
   //init the server
@@ -291,28 +337,14 @@ private:
   //respond to UDP SSDP M-SEARCH
   void respondToSearch()
   {
-    IPAddress localIP = Network.localIP();
-    char s[16];
-    sprintf(s, "%d.%d.%d.%d", localIP[0], localIP[1], localIP[2], localIP[3]);
-
-    char buf[1024];
-
-    sprintf_P(buf,PSTR("HTTP/1.1 200 OK\r\n"
-      "EXT:\r\n"
-      "CACHE-CONTROL: max-age=100\r\n" // SSDP_INTERVAL
-      "LOCATION: http://%s:80/description.xml\r\n"
-      "SERVER: FreeRTOS/6.0.5, UPnP/1.0, IpBridge/1.17.0\r\n" // _modelName, _modelNumber
-      "hue-bridgeid: %s\r\n"
-      "ST: urn:schemas-upnp-org:device:basic:1\r\n"  // _deviceType
-      "USN: uuid:2f402f80-da50-11e1-9b23-%s::upnp:rootdevice\r\n" // _uuid::_deviceType
-      "\r\n"),s,escapedMac.c_str(),escapedMac.c_str());
+    uint32_t remote = espalexaUdp.remoteIP();
+    if (remote == lastSearchIP && millis() - lastSearchTime < ESPALEXA_SSDP_MIN_INTERVAL) return;
+    lastSearchIP = remote;
+    lastSearchTime = millis();
+    renderDiscovery();
 
     espalexaUdp.beginPacket(espalexaUdp.remoteIP(), espalexaUdp.remotePort());
-    #ifdef ARDUINO_ARCH_ESP32
-    espalexaUdp.write((uint8_t*)buf, strlen(buf));
-    #else
-    espalexaUdp.write(buf);
-    #endif
+    espalexaUdp.write((const uint8_t*)searchResponseCache.c_str(), searchResponseCache.length());
     espalexaUdp.endPacket();                    
   }
 
@@ -557,10 +589,7 @@ public:
           jsonTemp += encodeLightKey(i);
           jsonTemp += '"';
           jsonTemp += ':';
-
-          char buf[512];
-          deviceJsonString(devices[i], buf);
-          jsonTemp += buf;
+          jsonTemp += deviceJson(i);
           if (i < currentDeviceCount-1) jsonTemp += ',';
         }
         jsonTemp += '}';
@@ -575,9 +604,7 @@ public:
           server->send(200, "application/json", "{}");
           return true;
         }
-        char buf[512];
-        deviceJsonString(devices[idx], buf);
-        server->send(200, "application/json", buf);
+        server->send(200, "application/json", deviceJson(idx));
       }
       
       return true;
@@ -28,6 +28,7 @@ private:
   EspalexaDeviceType _type;
   EspalexaDeviceProperty _changed = EspalexaDeviceProperty::none;
   EspalexaColorMode _mode = EspalexaColorMode::xy;
+  uint16_t _version = 1; //changes with every property reported to Alexa, see Espalexa::deviceJson()
   
 public:
   EspalexaDevice();
@@ -57,6 +58,7 @@ public:
   uint8_t getW();
   EspalexaColorMode getColorMode();
   EspalexaDeviceType getType();
+  uint16_t getVersion();
   
   void setId(uint8_t id);
   void setPropertyChanged(EspalexaDeviceProperty p);
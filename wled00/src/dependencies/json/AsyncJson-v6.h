@@ -57,23 +57,35 @@ class ChunkPrint : public Print {
 class AsyncJsonResponse: public AsyncAbstractResponse {
   private:
 
-    DynamicJsonDocument _jsonBuffer;
+    DynamicJsonDocument* _ownBuffer;
+    JsonDocument* _jsonBuffer;
 
     JsonVariant _root;
     bool _isValid;
 
   public:    
 
-    AsyncJsonResponse(size_t maxJsonBufferSize = DYNAMIC_JSON_DOCUMENT_SIZE, bool isArray=false) : _jsonBuffer(maxJsonBufferSize), _isValid{false} {
+    AsyncJsonResponse(size_t maxJsonBufferSize = DYNAMIC_JSON_DOCUMENT_SIZE, bool isArray=false) : _ownBuffer(new DynamicJsonDocument(maxJsonBufferSize)), _isValid{false} {
+      _jsonBuffer = _ownBuffer;
       _code = 200;
       _contentType = JSON_MIMETYPE;
       if(isArray)
-        _root = _jsonBuffer.createNestedArray();
+        _root = _jsonBuffer->createNestedArray();
       else
-        _root = _jsonBuffer.createNestedObject();
+        _root = _jsonBuffer->createNestedObject();
     }
 
-    ~AsyncJsonResponse() {}
+    //serializes a document owned by the caller, which must outlive the response
+    AsyncJsonResponse(JsonDocument* ref, bool isArray=false) : _ownBuffer(nullptr), _jsonBuffer(ref), _isValid{false} {
+      _code = 200;
+      _contentType = JSON_MIMETYPE;
+      if(isArray)
+        _root = _jsonBuffer->to<JsonArray>();
+      else
+        _root = _jsonBuffer->to<JsonObject>();
+    }
+
+    ~AsyncJsonResponse() { delete _ownBuffer; }
     JsonVariant & getRoot() { return _root; }
     bool _sourceValid() const { return _isValid; }
     size_t setLength() {
@@ -84,7 +96,7 @@ class AsyncJsonResponse: public AsyncAbstractResponse {
       return _contentLength;
     }
 
-   size_t getSize() { return _jsonBuffer.size(); }
+   size_t getSize() { return _jsonBuffer->size(); }
 
     size_t _fillBuffer(uint8_t *data, size_t len){
       ChunkPrint dest(data, _sentLength, len);
@@ -0,0 +1,151 @@
+#include "wled.h"
+
+/*
+ * Frame pipeline trace: a ring buffer of the last TRACE_BUFFER_EVENTS timestamped events
+ * (packet arrival, effect render, current limiter, bus output, WS/HTTP handlers), see TRACE_* in const.h.
+ * GET /trace returns them in the Chrome trace event format, for chrome://tracing or ui.perfetto.dev.
+ * Recording pauses while the trace is downloaded, each task the events came from is a thread of its own.
+ */
+#ifdef WLED_ENABLE_TRACE
+
+#ifndef TRACE_BUFFER_EVENTS
+  #ifdef ESP8266
+  #define TRACE_BUFFER_EVENTS 256   //8 bytes each, power of 2
+  #else
+  #define TRACE_BUFFER_EVENTS 2048
+  #endif
+#endif
+#if TRACE_BUFFER_EVENTS & (TRACE_BUFFER_EVENTS -1)
+  #error "TRACE_BUFFER_EVENTS must be a power of 2"
+#endif
+#define TRACE_MAX_TASKS 4          //further tasks share the last thread
+
+typedef struct TraceRecord {
+  uint32_t us;
+  uint16_t arg;
+  uint8_t ev;    //event in the low, task in the high nibble
+  char phase;    //'B' begin, 'E' end, 'i' instant
+} TraceRecord;
+
+static TraceRecord traceBuf[TRACE_BUFFER_EVENTS];
+static uint32_t traceHead = 0;           //events recorded since boot
+static volatile bool tracePaused = false;
+#ifdef ARDUINO_ARCH_ESP32
+static portMUX_TYPE traceMux = portMUX_INITIALIZER_UNLOCKED;
+static TaskHandle_t traceTasks[TRACE_MAX_TASKS];
+#endif
+
+static const char* const traceNames[TRACE_EVENT_COUNT] = {
+  "e131 rx", "e131", "render", "abl", "bus show", "bus ready", "ws", "http"
+};
+static const char* const traceArgs[TRACE_EVENT_COUNT] = { //name of the argument, nullptr if none
+  "protocol", "universe", "segment", nullptr, nullptr, nullptr, "type", "post"
+};
+
+void traceEvent(uint8_t ev, char phase, uint16_t arg)
+{
+  if (tracePaused) return;
+  uint32_t us = micros();
+  uint8_t tid = 0;
+  #ifdef ARDUINO_ARCH_ESP32
+  TaskHandle_t task = xTaskGetCurrentTaskHandle();
+  portENTER_CRITICAL(&traceMux);
+  for (; tid < TRACE_MAX_TASKS -1 && traceTasks[tid] != task; tid++) {
+    if (!traceTasks[tid]) { traceTasks[tid] = task; break; }
+  }
+  #endif
+  TraceRecord& r = traceBuf[traceHead & (TRACE_BUFFER_EVENTS -1)];
+  r.us = us; r.arg = arg; r.ev = ev | tid << 4; r.phase = phase;
+  traceHead++;
+  #ifdef ARDUINO_ARCH_ESP32
+  portEXIT_CRITICAL(&traceMux);
+  #endif
+}
+
+//writes the recorded events one line at a time into the chunks of the response
+class TraceWriter {
+  uint32_t next, end;
+  uint8_t part = 0;        //0: header, 1: events, 2: footer, 3: done
+  bool first = true;
+  char line[112];
+  uint8_t pos = 0, len = 0;
+
+  bool nextLine() {
+    pos = 0;
+    switch (part) {
+      case 0:
+        len = strlcpy_P(line, PSTR("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n"), sizeof(line));
+        part = 1;
+        return true;
+      case 1:
+        if (next != end) {
+          const TraceRecord& r = traceBuf[next & (TRACE_BUFFER_EVENTS -1)];
+          uint8_t ev = r.ev & 0x0F;
+          if (ev >= TRACE_EVENT_COUNT) ev = 0;
+          char args[32] = "";
+          if (traceArgs[ev]) snprintf_P(args, sizeof(args), PSTR(",\"args\":{\"%s\":%u}"), traceArgs[ev], r.arg);
+          len = snprintf_P(line, sizeof(line), PSTR("%s{\"name\":\"%s\",\"ph\":\"%c\",%s\"ts\":%u,\"pid\":1,\"tid\":%u%s}\n"),
+            first ? "" : ",", traceNames[ev], r.phase, r.phase == 'i' ? "\"s\":\"t\"," : "",
+            (unsigned)r.us, r.ev >> 4, args);
+          first = false;
+          next++;
+          return true;
+        }
+        part = 2;
+        //fall through
+      case 2:
+        len = strlcpy_P(line, PSTR("]}\n"), sizeof(line));
+        part = 3;
+        return true;
+    }
+    return false;
+  }
+
+public:
+  TraceWriter() {
+    end = traceHead;
+    next = end - min(traceHead, (uint32_t)TRACE_BUFFER_EVENTS);
+  }
+
+  size_t fill(uint8_t* buffer, size_t maxLen) {
+    size_t n = 0;
+    while (n < maxLen) {
+      if (pos == len && !nextLine()) break;
+      size_t chunk = MIN((size_t)(len - pos), maxLen - n);
+      memcpy(buffer + n, line + pos, chunk);
+      pos += chunk; n += chunk;
+    }
+    return n;
+  }
+};
+
+//event back places before the newest, false if not recorded (any more)
+bool traceRecent(uint8_t back, uint32_t& us, uint8_t& ev, char& phase, uint16_t& arg)
+{
+  uint32_t head = traceHead;
+  if (back >= head || back >= TRACE_BUFFER_EVENTS) return false;
+  const TraceRecord& r = traceBuf[(head - back -1) & (TRACE_BUFFER_EVENTS -1)];
+  us = r.us; ev = r.ev; phase = r.phase; arg = r.arg;
+  return true;
+}
+
+void serveTrace(AsyncWebServerRequest* request)
+{
+  if (!traceHead || tracePaused) { //nothing recorded yet, or a download is in progress
+    request->send(503, "application/json", F("{\"error\":3}"));
+    return;
+  }
+  tracePaused = true;
+  TraceWriter writer;
+  AsyncWebServerResponse *response = request->beginChunkedResponse("application/json", [writer](uint8_t* buffer, size_t maxLen, size_t index) mutable -> size_t {
+    return writer.fill(buffer, maxLen);
+  });
+  response->addHeader(F("Content-Disposition"), F("attachment; filename=\"wled.trace.json\""));
+  request->onDisconnect([]() { tracePaused = false; });
+  request->send(response);
+}
+#else
+void traceEvent(uint8_t ev, char phase, uint16_t arg) {}
+void serveTrace(AsyncWebServerRequest* request) {}
+bool traceRecent(uint8_t back, uint32_t& us, uint8_t& ev, char& phase, uint16_t& arg) { return false; }
+#endif
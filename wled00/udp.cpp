@@ -5,12 +5,90 @@
  */
 
 #define WLEDPACKETSIZE 37
+#define UDP_SEG_OFFSET 40  //version 10: total LED count (2), segment count (1), then one record per active segment
+#define UDP_SEG_SIZE 25    //id, options, start (2), stop (2), grouping, spacing, opacity, fx, speed, intensity, palette, 3 colors RGBW
 #define UDP_IN_MAXSIZE 1472
+#define UDP_SEQ_SIZE 6     //version 11: sender id (4), sequence number (2) after the segment records
+#define UDP_MAX_SEGS   MIN(MAX_NUM_SEGMENTS, (UDP_IN_MAXSIZE - UDP_SEG_OFFSET - UDP_SEQ_SIZE) / UDP_SEG_SIZE) //segments beyond do not fit a receive buffer
+#define UDP_SEQ_SENDERS 4     //senders whose last sequence number is remembered
+#define UDP_SEQ_TIMEOUT 10000 //ms after which a sender's sequence number is forgotten, e.g. because it rebooted
 #define PRESUMED_NETWORK_DELAY 3 //how many ms could it take on avg to reach the receiver? This will be added to transmitted times
+#define UDP_DRAIN_BUDGET_US 4000 //time handleNotifications() may spend reading queued packets per loop() pass
+#define UDP_TIMESYNC_TOKEN 0xC5  //timebase sync: token, 0 request / 1 answer, requester millis() (4), answerer timebase time (4)
+#define UDP_TIMESYNC_SIZE 10
+#define UDP_AUDIO_TOKEN 0xC6     //sound analysis: token, version, sync groups, bands (AUDIO_BANDS), volume, peak band,
+                                 //ms since the analysis (1), ms since the last beat (2, 0xFFFF none)
+#define UDP_AUDIO_SIZE (3 + AUDIO_BANDS + 5)
+#define UDP_PLAYLIST_TOKEN 0xC7  //synced playlist entry: token, sync groups, sequence, preset, flags (1: morph), transition (2),
+                                 //timebase time to apply it at (4)
+#define UDP_PLAYLIST_SIZE 11
+#define UDP_PRESET_TOKEN 0xC9    //preset applied, instead of the state for nodes with the same presets: token, sync groups, preset,
+                                 //flags (0x80: full state requested), presets checksum (4), sender id (4), sequence (2)
+#define UDP_PRESET_SIZE 14
+#define UDP_AUDIO_INTERVAL 20    //ms, at most 50 packets per second
+
+static uint8_t* udpInPacket = nullptr; // receive buffer for notifier packets, allocated on first use
+static uint8_t* udpOutPacket = nullptr; // notification being sent, allocated on first use and kept
+static byte notifyPendingMode = CALL_MODE_INIT; // call mode of a change held back by notifyMinInterval, CALL_MODE_INIT if none
+static uint32_t notifySenderId = 0; // random per boot, so a rebooted sender is not mistaken for a stale one
+static uint16_t notifySeq = 0;      // incremented per state sent, repeats of the same state share it
+
+typedef struct SyncSender {
+  uint32_t id;
+  uint16_t seq;
+  unsigned long last; //millis() of its last new packet
+} SyncSender;
+static SyncSender syncSenders[UDP_SEQ_SENDERS];
+static IPAddress timeSyncPeer;           // sender of the last notification that set our timebase
+static unsigned long timeSyncLast = 0;
+static uint32_t audioSentTime = 0;       // analysis time of the last sound packet sent
+static uint8_t playlistSyncSeq = 0;      // synced playlist entries sent, repeats share it
+static byte notifyPendingPreset = 0;     // presetSyncId of the change held back by notifyMinInterval
+static byte notifySentPreset = 0;        // preset id sent with the last notification, 0 if the state was sent
+static bool notifyFullState = false;     // a receiver has other presets, send the state
+
+static bool handleHyperionPacket(uint16_t packetSize);
+static bool handleDeltaPacket(const byte* udpIn, uint16_t len);
+static void handleNotifierPacket(uint16_t packetSize, bool isSupp);
+static bool applySegmentRecords(const byte* udpIn, uint16_t len, bool someSel);
+static void sendTimeSync(IPAddress ip, uint16_t port, bool answer, uint32_t t1);
+static void handleTimeSyncPacket(const byte* udpIn);
+static bool isNewSyncPacket(uint32_t id, uint16_t seq);
+static void sendAudioPacket();
+static void handleAudioPacket(const byte* udpIn);
+static void handlePlaylistSyncPacket(const byte* udpIn);
+static void sendPresetSync(IPAddress ip, uint16_t port, byte preset, bool request, uint32_t id, uint16_t seq);
+static void handlePresetSyncPacket(const byte* udpIn);
+
+//opens a sync socket, joining the multicast group if enabled. Unicast and broadcast packets are still received
+bool beginSyncUdp(WiFiUDP& udp, uint16_t port)
+{
+  if (!syncMulticast) return udp.begin(port);
+  #ifdef ESP8266
+  return udp.beginMulticast(Network.localIP(), IPAddress(WLED_SYNC_MULTICAST_IP), port);
+  #else
+  return udp.beginMulticast(IPAddress(WLED_SYNC_MULTICAST_IP), port);
+  #endif
+}
+
+//multicast lets access points convert sync packets to unicast instead of sending them at the lowest basic rate
+static void beginSyncPacket(WiFiUDP& udp, IPAddress broadcastIp, uint16_t port)
+{
+  if (!syncMulticast) {
+    udp.beginPacket(broadcastIp, port);
+    return;
+  }
+  #ifdef ESP8266
+  udp.beginPacketMulticast(IPAddress(WLED_SYNC_MULTICAST_IP), port, Network.localIP());
+  #else
+  udp.beginPacket(IPAddress(WLED_SYNC_MULTICAST_IP), port);
+  #endif
+}
 
 void notify(byte callMode, bool followUp)
 {
-  if (!udpConnected) return;
+  if (!followUp) notifyPendingMode = CALL_MODE_INIT; //superseded by this call
+  if (!udpConnected && !espNowActive()) return;
   if (!syncGroups) return;
   switch (callMode)
   {
@@ -24,7 +102,32 @@ void notify(byte callMode, bool followUp)
     case CALL_MODE_ALEXA:         if (!notifyAlexa)  return; break;
     default: return;
   }
-  byte udpOut[WLEDPACKETSIZE];
+  byte preset = followUp ? notifySentPreset : presetSyncId; //repeats are sent the same way
+  //changes in quick succession (e.g. dragging a slider) are coalesced, handleNotifications() sends the latest state
+  if (!followUp && millis() - notificationSentTime < notifyMinInterval) {
+    notifyPendingMode = callMode;
+    notifyPendingPreset = preset;
+    return;
+  }
+  if (!notifySenderId) notifySenderId = random(1, 0x7FFFFFFF);
+  //nodes with the same presets apply the preset from their own files, a node with other presets asks for the state.
+  //ESP-NOW peers cannot ask, they get the state
+  notifySentPreset = (syncPresetIds && !notifyFullState && !espNowActive()) ? preset : 0;
+  if (notifySentPreset && udpConnected) {
+    if (!followUp) notifySeq++;
+    IPAddress broadcastIp = ~uint32_t(Network.subnetMask()) | uint32_t(Network.gatewayIP());
+    sendPresetSync(broadcastIp, udpPort, preset, false, notifySenderId, notifySeq);
+    notificationSentCallMode = callMode;
+    notificationSentTime = millis();
+    notificationTwoRequired = (followUp)? false:notifyTwice;
+    return;
+  }
+  notifySentPreset = 0;
+  if (!udpOutPacket) {
+    udpOutPacket = (byte*) malloc(UDP_SEG_OFFSET + UDP_MAX_SEGS*UDP_SEG_SIZE + UDP_SEQ_SIZE);
+    if (!udpOutPacket) return;
+  }
+  byte* udpOut = udpOutPacket;
   udpOut[0] = 0; //0: wled notifier protocol 1: WARLS protocol
   udpOut[1] = callMode;
   udpOut[2] = bri;
@@ -40,8 +143,9 @@ void notify(byte callMode, bool followUp)
   //0: old 1: supports white 2: supports secondary color
   //3: supports FX intensity, 24 byte packet 4: supports transitionDelay 5: sup palette
   //6: supports timebase syncing, 29 byte packet 7: supports tertiary color 8: supports sys time sync, 36 byte packet
-  //9: supports sync groups, 37 byte packet
-  udpOut[11] = 9; 
+  //9: supports sync groups, 37 byte packet 10: all active segments appended, 40 + 25 bytes per segment
+  //11: sender id and sequence number after the segments
+  udpOut[11] = 11;
   udpOut[12] = colSec[0];
   udpOut[13] = colSec[1];
   udpOut[14] = colSec[2];
@@ -77,25 +181,118 @@ void notify(byte callMode, bool followUp)
 
   //sync groups
   udpOut[36] = syncGroups;
+
+  //segments, older receivers only read the first 37 bytes
+  uint16_t totalLen = strip.getLengthTotal();
+  udpOut[37] = (totalLen >> 8) & 0xFF;
+  udpOut[38] = (totalLen >> 0) & 0xFF;
+  uint16_t packetLen = UDP_SEG_OFFSET;
+  uint8_t segCount = 0;
+  for (uint8_t i = 0; i < strip.getSegmentCount() && segCount < UDP_MAX_SEGS; i++) {
+    WS2812FX::Segment& seg = strip.getSegment(i);
+    if (!seg.isActive()) continue;
+    byte* rec = udpOut + packetLen;
+    rec[0] = i;
+    rec[1] = seg.options & 0x0F; //selected, reversed, on, mirror
+    rec[2] = (seg.start >> 8) & 0xFF;
+    rec[3] = (seg.start >> 0) & 0xFF;
+    rec[4] = (seg.stop  >> 8) & 0xFF;
+    rec[5] = (seg.stop  >> 0) & 0xFF;
+    rec[6] = seg.grouping;
+    rec[7] = seg.spacing;
+    rec[8] = seg.opacity;
+    rec[9] = seg.mode;
+    rec[10] = seg.speed;
+    rec[11] = seg.intensity;
+    rec[12] = seg.palette;
+    for (uint8_t c = 0; c < NUM_COLORS; c++) {
+      uint32_t color = seg.colors[c];
+      rec[13 + c*4] = (color >> 16) & 0xFF;
+      rec[14 + c*4] = (color >>  8) & 0xFF;
+      rec[15 + c*4] = (color >>  0) & 0xFF;
+      rec[16 + c*4] = (color >> 24) & 0xFF;
+    }
+    packetLen += UDP_SEG_SIZE;
+    segCount++;
+  }
+  udpOut[39] = segCount;
+
+  //receivers drop repeats and late packets by sequence number
+  if (!followUp) notifySeq++;
+  byte* seq = udpOut + packetLen;
+  seq[0] = (notifySenderId >> 24) & 0xFF;
+  seq[1] = (notifySenderId >> 16) & 0xFF;
+  seq[2] = (notifySenderId >>  8) & 0xFF;
+  seq[3] = (notifySenderId >>  0) & 0xFF;
+  seq[4] = (notifySeq >> 8) & 0xFF;
+  seq[5] = (notifySeq >> 0) & 0xFF;
+  packetLen += UDP_SEQ_SIZE;
   
-  IPAddress broadcastIp;
-  broadcastIp = ~uint32_t(Network.subnetMask()) | uint32_t(Network.gatewayIP());
+  if (udpConnected) {
+    IPAddress broadcastIp;
+    broadcastIp = ~uint32_t(Network.subnetMask()) | uint32_t(Network.gatewayIP());
 
-  notifierUdp.beginPacket(broadcastIp, udpPort);
-  notifierUdp.write(udpOut, WLEDPACKETSIZE);
-  notifierUdp.endPacket();
+    beginSyncPacket(notifierUdp, broadcastIp, udpPort);
+    notifierUdp.write(udpOut, packetLen);
+    notifierUdp.endPacket();
+  }
+  espNowSendNotification(udpOut, packetLen, UDP_SEG_OFFSET, UDP_SEG_SIZE, UDP_SEQ_SIZE);
   notificationSentCallMode = callMode;
   notificationSentTime = millis();
   notificationTwoRequired = (followUp)? false:notifyTwice;
 }
 
+//end-to-end latency of realtime frames: first packet received -> show() -> busses done sending
+static uint32_t latencyRx = 0;     //receive time of the first packet of the frame being assembled, 0 if none
+static uint32_t latencyFrame = 0;  //receive time of the frame shown last, 0 once its output is complete
+static uint32_t latencyShown = 0;  //micros show() returned
+
+//shows a frame assembled from network packets
+void realtimeShow()
+{
+  recordShow();
+  uint32_t showStart = micros();
+  strip.show();
+  if (!latencyRx) return;
+  uint32_t showEnd = micros();
+  realtimeLatency[LATENCY_QUEUE].add(showStart - latencyRx);
+  realtimeLatency[LATENCY_SHOW].add(showEnd - showStart);
+  latencyFrame = latencyRx;
+  latencyShown = showEnd;
+  latencyRx = 0;
+}
+
+//the frame is output once the busses can take the next one, called from loop()
+void handleRealtimeLatency()
+{
+  if (!latencyFrame || !busses.canAllShow()) return;
+  uint32_t now = micros();
+  uint32_t total = now - latencyFrame;
+  realtimeLatency[LATENCY_LATCH].add(now - latencyShown);
+  realtimeLatency[LATENCY_TOTAL].add(total);
+  uint8_t bin = 0;
+  for (uint32_t ms = total >> 10; ms && bin < LOOP_HIST_BINS -1; ms >>= 1) bin++;
+  realtimeLatencyHist[bin]++;
+  latencyFrame = 0;
+}
+
+void resetRealtimeLatency()
+{
+  for (uint8_t i = 0; i < LATENCY_STAGES; i++) realtimeLatency[i].reset();
+  memset(realtimeLatencyHist, 0, sizeof(realtimeLatencyHist));
+}
+
 void realtimeLock(uint32_t timeoutMs, byte md)
 {
+  powerWake();
+  if (realtimePacketRx && !latencyRx) latencyRx = realtimePacketRx;
+  realtimePacketRx = 0;
+  bool partial = strip.hasLiveSegments(); //the other segments keep their effect
   if (!realtimeMode && !realtimeOverride){
     uint16_t totalLen = strip.getLengthTotal();
     for (uint16_t i = 0; i < totalLen; i++)
     {
-      strip.setPixelColor(i,0,0,0,0);
+      if (strip.isRealtimePixel(i)) strip.setPixelColor(i,0,0,0,0);
     }
   }
 
@@ -105,12 +302,28 @@ void realtimeLock(uint32_t timeoutMs, byte md)
   if (bri == 0 && !realtimeMode) {
     strip.setBrightness(scaledBri(briLast));
   }
+  bool changed = (realtimeMode != md);
   realtimeMode = md;
+  if (changed) usermods.publish(UM_EVENT_REALTIME, md);
 
-  if (arlsForceMaxBri && !realtimeOverride) strip.setBrightness(scaledBri(255));
+  if (arlsForceMaxBri && !realtimeOverride && !partial) strip.setBrightness(scaledBri(255));
   if (md == REALTIME_MODE_GENERIC) strip.show();
 }
 
+//realtime data takes over the whole strip, effects and the rest of the normal loop pause
+bool realtimeExclusive()
+{
+  return realtimeMode && !realtimeOverride && !strip.hasLiveSegments();
+}
+
+//time spent parsing one packet of a realtime protocol, excluding strip.show()
+void realtimePerfAdd(byte md, unsigned long startMicros)
+{
+  if (md > REALTIME_MODE_DDP) return;
+  if (!realtimePerf[md].count) realtimePerfSince[md] = millis();
+  realtimePerf[md].add(micros() - startMicros);
+}
+
 
 #define TMP2NET_OUT_PORT 65442
 
@@ -124,17 +337,39 @@ void sendTPM2Ack() {
 
 void handleNotifications()
 {
-  IPAddress localIP;
+  RENDER_LOCK();
+  handleRealtimeLatency();
+
+  //send the latest of the changes held back by the rate limit
+  if (notifyPendingMode != CALL_MODE_INIT && millis() - notificationSentTime >= notifyMinInterval) {
+    byte applying = presetSyncId;
+    presetSyncId = notifyPendingPreset; //the held back change came from this preset
+    notify(notifyPendingMode);
+    presetSyncId = applying;
+  }
 
-  //send second notification if enabled
-  if(udpConnected && notificationTwoRequired && millis()-notificationSentTime > 250){
+  //send second notification if enabled, only for the final state
+  if(udpConnected && notificationTwoRequired && notifyPendingMode == CALL_MODE_INIT && millis()-notificationSentTime > 250){
     notify(notificationSentCallMode,true);
   }
   
-  if (e131NewData && millis() - strip.getLastShow() > 15)
+  //parse realtime packets received by the network task since the last pass
+  handleE131Queue();
+
+  //show an incomplete multi-universe frame if the remaining universes did not arrive in time
+  if (e131UniversesReceived && millis() - e131FrameStart > E131_FRAME_TIMEOUT) e131FinishFrame(true);
+  //sender stopped sending sync packets, show the frame that was waiting for one
+  if (e131SyncPending && millis() - e131LastSync >= E131_SYNC_TIMEOUT) {
+    e131SyncPending = false;
+    e131NewData = true;
+  }
+
+  if (e131NewData && (!e131ShowAt || (long)(millis() - e131ShowAt) >= 0) && (e131FrameComplete || millis() - strip.getLastShow() > 15))
   {
     e131NewData = false;
-    strip.show();
+    e131FrameComplete = false;
+    e131ShowAt = 0;
+    realtimeShow();
   }
 
   //unlock strip when realtime UDP times out
@@ -144,177 +379,573 @@ void handleNotifications()
     strip.setBrightness(scaledBri(bri));
     realtimeMode = REALTIME_MODE_INACTIVE;
     realtimeIP[0] = 0;
+    if (strip.hasLiveSegments()) strip.trigger(); //the live segments render their effects again
+    usermods.publish(UM_EVENT_REALTIME, REALTIME_MODE_INACTIVE);
   }
 
   //receive UDP notifications
   if (!udpConnected) return;
-    
-  bool isSupp = false;
-  uint16_t packetSize = notifierUdp.parsePacket();
-  if (!packetSize && udp2Connected) {
-    packetSize = notifier2Udp.parsePacket();
-    isSupp = true;
-  }
-
-  //hyperion / raw RGB
-  if (!packetSize && udpRgbConnected) {
-    packetSize = rgbUdp.parsePacket();
-    if (packetSize) {
-      if (!receiveDirect) return;
-      if (packetSize > UDP_IN_MAXSIZE || packetSize < 3) return;
-      realtimeIP = rgbUdp.remoteIP();
-      DEBUG_PRINTLN(rgbUdp.remoteIP());
-      uint8_t lbuf[packetSize];
-      rgbUdp.read(lbuf, packetSize);
-      realtimeLock(realtimeTimeoutMs, REALTIME_MODE_HYPERION);
-      if (realtimeOverride) return;
-      uint16_t id = 0;
-      uint16_t totalLen = strip.getLengthTotal();
-      for (uint16_t i = 0; i < packetSize -2; i += 3)
-      {
-        setRealtimePixel(id, lbuf[i], lbuf[i+1], lbuf[i+2], 0);
-        id++; if (id >= totalLen) break;
+
+  //keep the effect timebase aligned with the sync sender between notifications
+  if (uint32_t(timeSyncPeer) && millis() - timeSyncLast > WLED_TIMESYNC_INTERVAL) {
+    timeSyncLast = millis();
+    sendTimeSync(timeSyncPeer, udpPort, false, millis());
+  }
+
+  if (sendAudioSync) sendAudioPacket();
+
+  //drain all queued packets, bounded by a time budget so the rest of the loop is not starved
+  unsigned long drainStart = micros();
+
+  //hyperion / raw RGB, show only the latest frame
+  if (udpRgbConnected) {
+    uint8_t rgbFrames = 0;
+    while (micros() - drainStart < UDP_DRAIN_BUDGET_US) {
+      uint16_t packetSize = rgbUdp.parsePacket();
+      if (!packetSize) break;
+      unsigned long packetStart = micros();
+      realtimePacketRx = packetStart;
+      if (handleHyperionPacket(packetSize)) {
+        realtimePerfAdd(REALTIME_MODE_HYPERION, packetStart);
+        rgbFrames++;
       }
-      strip.show();
-      return;
-    } 
+    }
+    realtimePacketRx = 0;
+    if (rgbFrames) {
+      udpInSkipped += rgbFrames -1; //frames overwritten by a newer one before they were shown
+      realtimeShow();
+    }
   }
 
-  if (!(receiveNotifications || receiveDirect)) return;
-  
-  localIP = Network.localIP();
-  //notifier and UDP realtime
-  if (!packetSize || packetSize > UDP_IN_MAXSIZE) return;
-  if (!isSupp && notifierUdp.remoteIP() == localIP) return; //don't process broadcasts we send ourselves
+  if (!(receiveNotifications || receiveDirect || receiveAudioSync)) return;
 
-  uint8_t udpIn[packetSize +1];
-  uint16_t len;
-  if (isSupp) len = notifier2Udp.read(udpIn, packetSize);
-  else        len =  notifierUdp.read(udpIn, packetSize);
+  while (micros() - drainStart < UDP_DRAIN_BUDGET_US) {
+    bool isSupp = false;
+    uint16_t packetSize = notifierUdp.parsePacket();
+    if (!packetSize && udp2Connected) {
+      packetSize = notifier2Udp.parsePacket();
+      isSupp = true;
+    }
+    if (!packetSize) break;
+    handleNotifierPacket(packetSize, isSupp);
+  }
+  realtimePacketRx = 0; //not taken by a realtime packet
+}
 
-  // WLED nodes info notifications
-  if (isSupp && udpIn[0] == 255 && udpIn[1] == 1 && len >= 40) {
-    if (!nodeListEnabled || notifier2Udp.remoteIP() == localIP) return;
+//remembers the latest sequence number per sender, false for a repeat or a packet older than one already applied
+static bool isNewSyncPacket(uint32_t id, uint16_t seq)
+{
+  unsigned long now = millis();
+  SyncSender* s = &syncSenders[0];
+  for (uint8_t i = 0; i < UDP_SEQ_SENDERS; i++) {
+    if (syncSenders[i].id == id) {s = &syncSenders[i]; break;}
+    if (now - syncSenders[i].last > now - s->last) s = &syncSenders[i]; //replace the least recent sender
+  }
+  if (s->id == id && now - s->last < UDP_SEQ_TIMEOUT && (int16_t)(seq - s->seq) <= 0) return false;
+  s->id = id;
+  s->seq = seq;
+  s->last = now;
+  return true;
+}
 
-    uint8_t unit = udpIn[39];
-    NodesMap::iterator it = Nodes.find(unit);
-    if (it == Nodes.end() && Nodes.size() < WLED_MAX_NODES) { // Create a new element when not present
-      Nodes[unit].age = 0;
-      it = Nodes.find(unit);
+//applies the segment records of a version 10 notification, returns false if there are none.
+//Bounds are only taken over if the sender drives as many LEDs, otherwise the local segments are kept
+static bool applySegmentRecords(const byte* udpIn, uint16_t len, bool someSel)
+{
+  if (len < UDP_SEG_OFFSET) return false;
+  uint8_t segCount = udpIn[39];
+  if (len < UDP_SEG_OFFSET + segCount*UDP_SEG_SIZE) segCount = (len - UDP_SEG_OFFSET) / UDP_SEG_SIZE; //truncated
+  if (!segCount) return false;
+
+  bool sameLayout = (((udpIn[37] << 8) | udpIn[38]) == strip.getLengthTotal());
+  bool applyBri = (receiveNotificationBrightness || !someSel);
+  bool applyCol = (receiveNotificationColor || !someSel);
+  bool applyFx  = (receiveNotificationEffects || !someSel);
+  uint32_t received[(MAX_NUM_SEGMENTS +31) /32] = {0};
+
+  for (uint8_t r = 0; r < segCount; r++) {
+    const byte* rec = udpIn + UDP_SEG_OFFSET + r*UDP_SEG_SIZE;
+    uint8_t id = rec[0];
+    if (id >= strip.getMaxSegments()) continue;
+    received[id >> 5] |= 1UL << (id & 31);
+    WS2812FX::Segment& seg = strip.getSegment(id);
+    if (sameLayout) {
+      strip.setSegment(id, (rec[2] << 8) | rec[3], (rec[4] << 8) | rec[5], rec[6], rec[7]);
+      seg.setOption(SEG_OPTION_SELECTED, rec[1] & (0x01 << SEG_OPTION_SELECTED));
     }
+    if (!seg.isActive()) continue;
 
-    if (it != Nodes.end()) {
-      for (byte x = 0; x < 4; x++) {
-        it->second.ip[x] = udpIn[x + 2];
+    if (applyBri) {
+      seg.setOpacity(rec[8], id);
+      seg.setOption(SEG_OPTION_ON, rec[1] & (0x01 << SEG_OPTION_ON), id);
+    }
+    if (applyFx) {
+      if (rec[9] != seg.mode && rec[9] < strip.getModeCount()) strip.setMode(id, rec[9]);
+      seg.speed     = rec[10];
+      seg.intensity = rec[11];
+      if (rec[12] < strip.getPaletteCount()) seg.palette = rec[12];
+      seg.setOption(SEG_OPTION_REVERSED, rec[1] & (0x01 << SEG_OPTION_REVERSED));
+      seg.setOption(SEG_OPTION_MIRROR,   rec[1] & (0x01 << SEG_OPTION_MIRROR));
+    }
+    if (applyCol) {
+      for (uint8_t c = 0; c < NUM_COLORS; c++) {
+        const byte* rgbw = rec + 13 + c*4;
+        seg.setColor(c, ((uint32_t)rgbw[3] << 24) | ((uint32_t)rgbw[0] << 16) | ((uint32_t)rgbw[1] << 8) | rgbw[2], id);
       }
-      it->second.age = 0; // reset 'age counter'
-      char tmpNodeName[33] = { 0 };
-      memcpy(&tmpNodeName[0], reinterpret_cast<byte *>(&udpIn[6]), 32);
-      tmpNodeName[32]     = 0;
-      it->second.nodeName = tmpNodeName;
-      it->second.nodeName.trim();
-      it->second.nodeType = udpIn[38];
-      uint32_t build = 0;
-      if (len >= 44)
-        for (byte i=0; i<sizeof(uint32_t); i++)
-          build |= udpIn[40+i]<<(8*i);
-      it->second.build = build;
     }
+  }
+
+  //same layout as the sender, so its inactive segments are removed here as well
+  if (sameLayout) {
+    for (uint8_t i = 0; i < strip.getSegmentCount(); i++) {
+      if (!(received[i >> 5] & (1UL << (i & 31))) && strip.getSegment(i).isActive()) strip.setSegment(i, 0, 0);
+    }
+  }
+  return true;
+}
+
+//broadcasts each new local sound analysis, times are sent as ages so the receivers need no common clock
+static void sendAudioPacket()
+{
+  AudioData audio;
+  if (!syncGroups || !getAudio(audio) || audio.remote || audio.time == audioSentTime) return;
+  if (millis() - audioSentTime < UDP_AUDIO_INTERVAL) return;
+  audioSentTime = audio.time;
+  byte out[UDP_AUDIO_SIZE];
+  out[0] = UDP_AUDIO_TOKEN;
+  out[1] = 1; //version
+  out[2] = syncGroups;
+  memcpy(out +3, audio.bands, AUDIO_BANDS);
+  byte* p = out + 3 + AUDIO_BANDS;
+  p[0] = audio.volume;
+  p[1] = audio.peakBand;
+  p[2] = MIN(millis() - audio.time, 255UL);
+  uint32_t beatAge = audio.beatTime ? MIN(millis() - audio.beatTime, 65535UL) : 65535;
+  p[3] = beatAge >> 8;
+  p[4] = beatAge & 0xFF;
+  IPAddress broadcastIp = ~uint32_t(Network.subnetMask()) | uint32_t(Network.gatewayIP());
+  beginSyncPacket(notifierUdp, broadcastIp, udpPort);
+  notifierUdp.write(out, UDP_AUDIO_SIZE);
+  notifierUdp.endPacket();
+}
+
+//feeds the effects with the analysis of another node, unless there is a local one
+static void handleAudioPacket(const byte* udpIn)
+{
+  if (!(receiveGroups & udpIn[2])) return;
+  AudioData audio;
+  if (getAudio(audio) && !audio.remote) return;
+  const byte* p = udpIn + 3 + AUDIO_BANDS;
+  unsigned long now = millis();
+  memcpy(audio.bands, udpIn +3, AUDIO_BANDS);
+  audio.volume = p[0];
+  audio.peakBand = MIN(p[1], AUDIO_BANDS -1);
+  audio.time = now - p[2] - PRESUMED_NETWORK_DELAY;
+  uint16_t beatAge = (p[3] << 8) | p[4];
+  audio.beatTime = (beatAge == 65535) ? 0 : now - beatAge - PRESUMED_NETWORK_DELAY;
+  audio.remote = true;
+  publishAudio(audio);
+}
+
+static void sendPresetSync(IPAddress ip, uint16_t port, byte preset, bool request, uint32_t id, uint16_t seq)
+{
+  byte out[UDP_PRESET_SIZE];
+  uint32_t crc = presetsChecksum();
+  out[0] = UDP_PRESET_TOKEN;
+  out[1] = syncGroups;
+  out[2] = preset;
+  out[3] = request ? 0x80 : 0;
+  for (uint8_t i = 0; i < 4; i++) {
+    out[4+i] = (crc >> (24 - 8*i)) & 0xFF;
+    out[8+i] = (id >> (24 - 8*i)) & 0xFF;
+  }
+  out[12] = seq >> 8; out[13] = seq & 0xFF;
+  if (request) notifierUdp.beginPacket(ip, port);
+  else beginSyncPacket(notifierUdp, ip, port);
+  notifierUdp.write(out, UDP_PRESET_SIZE);
+  notifierUdp.endPacket();
+}
+
+//preset id sync. The sequence is the one of the state, so a state sent on request is only applied by the nodes that asked
+static void handlePresetSyncPacket(const byte* udpIn)
+{
+  uint32_t id = (udpIn[8] << 24) | (udpIn[9] << 16) | (udpIn[10] << 8) | udpIn[11];
+  uint16_t seq = (udpIn[12] << 8) | udpIn[13];
+  if (udpIn[3] & 0x80) { //request for the state of the preset we sent, answered once
+    static uint16_t answeredSeq = 0;
+    if (id != notifySenderId || seq != notifySeq || seq == answeredSeq) return;
+    answeredSeq = seq;
+    notifyFullState = true;
+    notify(notificationSentCallMode, true);
+    notifyFullState = false;
     return;
   }
+  if (realtimeMode || !receiveNotifications || !(receiveGroups & udpIn[1])) return;
+  if (millis() - notificationSentTime < 1000) return; //as for notifications
+  uint32_t crc = (udpIn[4] << 24) | (udpIn[5] << 16) | (udpIn[6] << 8) | udpIn[7];
+  if (crc != presetsChecksum()) { //other presets here, the sequence is not taken so the state will be
+    sendPresetSync(notifierUdp.remoteIP(), notifierUdp.remotePort(), udpIn[2], true, id, seq);
+    return;
+  }
+  if (!isNewSyncPacket(id, seq)) return;
+  applyPreset(udpIn[2], CALL_MODE_NOTIFICATION);
+}
 
-  //wled notifier, ignore if realtime packets active
-  if (udpIn[0] == 0 && !realtimeMode && receiveNotifications)
+//conductor of a synced playlist: the entry all nodes apply at timebase time at
+void sendPlaylistSync(byte preset, uint16_t tr, bool morph, uint32_t at, bool repeat)
+{
+  if (!udpConnected || !syncGroups) return;
+  if (!repeat) playlistSyncSeq++;
+  byte out[UDP_PLAYLIST_SIZE];
+  out[0] = UDP_PLAYLIST_TOKEN;
+  out[1] = syncGroups;
+  out[2] = playlistSyncSeq;
+  out[3] = preset;
+  out[4] = morph;
+  out[5] = tr >> 8; out[6] = tr & 0xFF;
+  for (uint8_t i = 0; i < 4; i++) out[7+i] = (at >> (24 - 8*i)) & 0xFF;
+  IPAddress broadcastIp = ~uint32_t(Network.subnetMask()) | uint32_t(Network.gatewayIP());
+  beginSyncPacket(notifierUdp, broadcastIp, udpPort);
+  notifierUdp.write(out, UDP_PLAYLIST_SIZE);
+  notifierUdp.endPacket();
+}
+
+//follower: the conductor also becomes the timebase sync peer, so the time it sent is the same moment here
+static void handlePlaylistSyncPacket(const byte* udpIn)
+{
+  static IPAddress lastSender;
+  static uint8_t lastSeq = 0;
+  if (!receiveNotifications || !(receiveGroups & udpIn[1])) return;
+  IPAddress sender = notifierUdp.remoteIP();
+  if (sender == lastSender && udpIn[2] == lastSeq) return; //repeat of the announcement
+  lastSender = sender;
+  lastSeq = udpIn[2];
+  if (sender != timeSyncPeer) {
+    timeSyncPeer = sender;
+    timeSyncLast = millis() - WLED_TIMESYNC_INTERVAL; //measure the real delay right away
+  }
+  uint16_t tr = (udpIn[5] << 8) | udpIn[6];
+  uint32_t at = (udpIn[7] << 24) | (udpIn[8] << 16) | (udpIn[9] << 8) | (udpIn[10]);
+  schedulePlaylistSync(udpIn[3], tr, udpIn[4] & 0x01, at);
+}
+
+static void sendTimeSync(IPAddress ip, uint16_t port, bool answer, uint32_t t1)
+{
+  byte out[UDP_TIMESYNC_SIZE];
+  uint32_t t2 = millis() + strip.timebase;
+  out[0] = UDP_TIMESYNC_TOKEN;
+  out[1] = answer;
+  for (uint8_t i = 0; i < 4; i++) {
+    out[2+i] = (t1 >> (24 - 8*i)) & 0xFF;
+    out[6+i] = (t2 >> (24 - 8*i)) & 0xFF;
+  }
+  notifierUdp.beginPacket(ip, port);
+  notifierUdp.write(out, UDP_TIMESYNC_SIZE);
+  notifierUdp.endPacket();
+}
+
+//NTP-like exchange: half the round trip is added to the peer's time, the error is slewed out in small steps
+//so running effects do not visibly jump
+static void handleTimeSyncPacket(const byte* udpIn)
+{
+  uint32_t t1 = (udpIn[2] << 24) | (udpIn[3] << 16) | (udpIn[4] << 8) | (udpIn[5]);
+  if (!udpIn[1]) { //request, answer with our time
+    sendTimeSync(notifierUdp.remoteIP(), notifierUdp.remotePort(), true, t1);
+    return;
+  }
+  if (notifierUdp.remoteIP() != timeSyncPeer) return;
+
+  uint32_t rtt = millis() - t1;
+  if (rtt > WLED_TIMESYNC_MAX_RTT) { //try again soon instead of using a skewed sample
+    timeSyncLast = millis() - WLED_TIMESYNC_INTERVAL + 1000;
+    return;
+  }
+  uint32_t t2 = (udpIn[6] << 24) | (udpIn[7] << 16) | (udpIn[8] << 8) | (udpIn[9]);
+  int32_t err = (int32_t)(t2 + rtt/2 - millis() - strip.timebase);
+  if (abs(err) < WLED_TIMESYNC_JUMP) {
+    int32_t step = constrain(err/2, -WLED_TIMESYNC_MAX_STEP, WLED_TIMESYNC_MAX_STEP);
+    if (abs(err - step) > WLED_TIMESYNC_MAX_STEP) timeSyncLast = millis() - WLED_TIMESYNC_INTERVAL + 1000; //not there yet
+    err = step;
+  }
+  strip.timebase += err;
+}
+
+//raw RGB pixels streamed from the socket in small chunks, no packet sized buffer needed
+static bool handleHyperionPacket(uint16_t packetSize)
+{
+  if (!receiveDirect) return false;
+  if (packetSize > UDP_IN_MAXSIZE || packetSize < 3) return false;
+  realtimeIP = rgbUdp.remoteIP();
+  DEBUG_PRINTLN(rgbUdp.remoteIP());
+  realtimeLock(realtimeTimeoutMs, REALTIME_MODE_HYPERION);
+  if (realtimeOverride) return false;
+
+  uint8_t chunk[96];
+  uint16_t pix = 0;
+  int len;
+  while ((len = rgbUdp.read(chunk, sizeof(chunk))) >= 3) {
+    setRealtimePixels(pix, chunk, len /3, false);
+    pix += len /3;
+  }
+  return true;
+}
+
+/*
+ * UDP realtime 6 (delta): spans changed since the previous frame instead of the whole frame.
+ * [1] timeout s, [2] flags, [3] frame sequence number, [4] packet number within the frame, then spans of
+ * start (2 bytes), count (2 bytes, bit 15 set: run of one color) and count colors, or one color for a run.
+ * A keyframe (flag 0x01) turns all realtime pixels not in its spans off, the sender should send one every
+ * second or so. Deltas (no 0x01) apply to the frame before and are dropped from a lost packet on until the
+ * next keyframe, so an incomplete frame is never built on. Frames may span packets, the last one has flag 0x04.
+ * Colors are RGB, RGBW with flag 0x02. False if the packet was dropped.
+ */
+#define DELTA_KEYFRAME 0x01
+#define DELTA_RGBW     0x02
+#define DELTA_LAST     0x04
+#define DELTA_RUN      0x8000
+
+static bool deltaInSync = false; //all packets of the frames so far arrived, deltas can be applied
+static uint8_t deltaSeq = 0;     //frame being received
+static uint8_t deltaNext = 0;    //packet number expected next, 0 if the frame is complete
+
+static bool handleDeltaPacket(const byte* udpIn, uint16_t len)
+{
+  if (len < 5) return false;
+  uint8_t flags = udpIn[2], seq = udpIn[3], packet = udpIn[4];
+  if (flags & DELTA_KEYFRAME) {
+    if (packet == 0) deltaInSync = true;
+    else if (seq != deltaSeq || packet != deltaNext) deltaInSync = false;
+  } else if (deltaNext ? (seq != deltaSeq || packet != deltaNext) : (packet != 0 || seq != (uint8_t)(deltaSeq +1))) {
+    deltaInSync = false;
+  }
+  if (!deltaInSync) return false;
+  deltaSeq = seq;
+  deltaNext = (flags & DELTA_LAST) ? 0 : packet +1;
+
+  uint16_t totalLen = strip.getLengthTotal();
+  bool rgbw = flags & DELTA_RGBW;
+  uint8_t ch = rgbw ? 4 : 3;
+  byte run[32 * 4]; //a color repeated, written 32 pixels at a time
+  if ((flags & DELTA_KEYFRAME) && packet == 0) { //the spans of this frame overwrite it
+    memset(run, 0, sizeof(run));
+    for (uint16_t p = 0; p < totalLen; p += 32) setRealtimePixels(p, run, MIN(totalLen - p, 32), rgbw);
+  }
+  for (uint16_t i = 5; i + 4 <= len; ) {
+    uint16_t start = (udpIn[i] << 8) | udpIn[i+1];
+    uint16_t count = (udpIn[i+2] << 8) | udpIn[i+3];
+    i += 4;
+    if (count & DELTA_RUN) {
+      count &= ~DELTA_RUN;
+      if (i + ch > len) break;
+      for (uint8_t p = 0; p < 32; p++) memcpy(run + p * ch, udpIn + i, ch);
+      for (uint16_t p = 0; p < count; p += 32) setRealtimePixels(start + p, run, MIN(count - p, 32), rgbw);
+      i += ch;
+    } else {
+      if (i + (uint32_t)count * ch > len) count = (len - i) / ch;
+      setRealtimePixels(start, udpIn + i, count, rgbw);
+      i += count * ch;
+    }
+  }
+  return true;
+}
+
+//applies a WLED notifier packet, sender is 0 if it did not come by UDP (ESP-NOW)
+static void applyNotification(const byte* udpIn, uint16_t len, IPAddress sender)
+{
+  //ignore notification if received within a second after sending a notification ourselves
+  if (millis() - notificationSentTime < 1000) return;
+  if (udpIn[1] > 199) return; //do not receive custom versions
+
+  //compatibilityVersionByte: 
+  byte version = udpIn[11];
+
+  // if we are not part of any sync group ignore message
+  if (version < 9 || version > 199) {
+    // legacy senders are treated as if sending in sync group 1 only
+    if (!(receiveGroups & 0x01)) return;
+  } else if (!(receiveGroups & udpIn[36])) return;
+
+  //the same state sent twice or overtaken by a newer one is not applied again
+  uint16_t seqPos = UDP_SEG_OFFSET + udpIn[39]*UDP_SEG_SIZE;
+  if (version > 10 && version < 200 && len >= seqPos + UDP_SEQ_SIZE) {
+    const byte* seq = udpIn + seqPos;
+    uint32_t id = (seq[0] << 24) | (seq[1] << 16) | (seq[2] << 8) | seq[3];
+    if (!isNewSyncPacket(id, (seq[4] << 8) | seq[5])) return;
+  }
+  
+  bool someSel = (receiveNotificationBrightness || receiveNotificationColor || receiveNotificationEffects);
+  //segment records replace the main segment colors and effect of older versions
+  bool segmentsSet = (version > 9 && version < 200 && applySegmentRecords(udpIn, len, someSel));
+
+  //apply colors from notification
+  if (segmentsSet) {
+    //only the main segment follows the globals, the others were set from their records
+    WS2812FX::Segment& mainSeg = strip.getSegment(strip.getMainSegmentId());
+    for (uint8_t i = 0; i < 4; i++) {
+      uint8_t shift = (i < 3) ? 16 - 8*i : 24; //R G B W
+      col[i]    = (mainSeg.colors[0] >> shift) & 0xFF;
+      colSec[i] = (mainSeg.colors[1] >> shift) & 0xFF;
+    }
+  } else if (receiveNotificationColor || !someSel)
   {
-    //ignore notification if received within a second after sending a notification ourselves
-    if (millis() - notificationSentTime < 1000) return;
-    if (udpIn[1] > 199) return; //do not receive custom versions
-
-    //compatibilityVersionByte: 
-    byte version = udpIn[11];
-
-    // if we are not part of any sync group ignore message
-    if (version < 9 || version > 199) {
-      // legacy senders are treated as if sending in sync group 1 only
-      if (!(receiveGroups & 0x01)) return;
-    } else if (!(receiveGroups & udpIn[36])) return;
-    
-    bool someSel = (receiveNotificationBrightness || receiveNotificationColor || receiveNotificationEffects);
-    //apply colors from notification
-    if (receiveNotificationColor || !someSel)
+    col[0] = udpIn[3];
+    col[1] = udpIn[4];
+    col[2] = udpIn[5];
+    if (version > 0) //sending module's white val is intended
     {
-      col[0] = udpIn[3];
-      col[1] = udpIn[4];
-      col[2] = udpIn[5];
-      if (version > 0) //sending module's white val is intended
+      col[3] = udpIn[10];
+      if (version > 1)
+      {
+        colSec[0] = udpIn[12];
+        colSec[1] = udpIn[13];
+        colSec[2] = udpIn[14];
+        colSec[3] = udpIn[15];
+      }
+      if (version > 6)
       {
-        col[3] = udpIn[10];
-        if (version > 1)
-        {
-          colSec[0] = udpIn[12];
-          colSec[1] = udpIn[13];
-          colSec[2] = udpIn[14];
-          colSec[3] = udpIn[15];
-        }
-        if (version > 6)
-        {
-          strip.setColor(2, udpIn[20], udpIn[21], udpIn[22], udpIn[23]); //tertiary color
-        }
+        strip.setColor(2, udpIn[20], udpIn[21], udpIn[22], udpIn[23]); //tertiary color
       }
     }
+  }
 
-    bool timebaseUpdated = false;
-    //apply effects from notification
-    if (version < 200 && (receiveNotificationEffects || !someSel))
-    {
+  bool timebaseUpdated = false;
+  //apply effects from notification
+  if (segmentsSet) {
+    WS2812FX::Segment& mainSeg = strip.getSegment(strip.getMainSegmentId());
+    effectCurrent   = mainSeg.mode;
+    effectSpeed     = mainSeg.speed;
+    effectIntensity = mainSeg.intensity;
+    effectPalette   = mainSeg.palette;
+  }
+  if (version < 200 && (receiveNotificationEffects || !someSel))
+  {
+    if (!segmentsSet) {
       if (udpIn[8] < strip.getModeCount()) effectCurrent = udpIn[8];
       effectSpeed   = udpIn[9];
       if (version > 2) effectIntensity = udpIn[16];
       if (version > 4 && udpIn[19] < strip.getPaletteCount()) effectPalette = udpIn[19];
-      if (version > 5)
-      {
-        uint32_t t = (udpIn[25] << 24) | (udpIn[26] << 16) | (udpIn[27] << 8) | (udpIn[28]);
-        t += PRESUMED_NETWORK_DELAY; //adjust trivially for network delay
-        t -= millis();
-        strip.timebase = t;
-        timebaseUpdated = true;
+    }
+    if (version > 5)
+    {
+      uint32_t t = (udpIn[25] << 24) | (udpIn[26] << 16) | (udpIn[27] << 8) | (udpIn[28]);
+      t += PRESUMED_NETWORK_DELAY; //adjust trivially for network delay
+      t -= millis();
+      strip.timebase = t;
+      timebaseUpdated = true;
+      if (uint32_t(sender) && sender != timeSyncPeer) {
+        timeSyncPeer = sender;
+        timeSyncLast = millis() - WLED_TIMESYNC_INTERVAL; //measure the real delay right away
       }
     }
+  }
 
-    //adjust system time, but only if sender is more accurate than self
-    if (version > 7 && version < 200)
-    {
-      Toki::Time tm;
-      tm.sec = (udpIn[30] << 24) | (udpIn[31] << 16) | (udpIn[32] << 8) | (udpIn[33]);
-      tm.ms = (udpIn[34] << 8) | (udpIn[35]);
-      if (udpIn[29] > toki.getTimeSource()) { //if sender's time source is more accurate
-        toki.adjust(tm, PRESUMED_NETWORK_DELAY); //adjust trivially for network delay
-        uint8_t ts = TOKI_TS_UDP;
-        if (udpIn[29] > 99) ts = TOKI_TS_UDP_NTP;
-        else if (udpIn[29] >= TOKI_TS_SEC) ts = TOKI_TS_UDP_SEC;
-        toki.setTime(tm, ts);
-      } else if (timebaseUpdated && toki.getTimeSource() > 99) { //if we both have good times, get a more accurate timebase
-        Toki::Time myTime = toki.getTime();
-        uint32_t diff = toki.msDifference(tm, myTime);
-        strip.timebase -= PRESUMED_NETWORK_DELAY; //no need to presume, use difference between NTP times at send and receive points
-        if (toki.isLater(tm, myTime)) {
-          strip.timebase += diff;
-        } else {
-          strip.timebase -= diff;
-        }
+  //adjust system time, but only if sender is more accurate than self
+  if (version > 7 && version < 200)
+  {
+    Toki::Time tm;
+    tm.sec = (udpIn[30] << 24) | (udpIn[31] << 16) | (udpIn[32] << 8) | (udpIn[33]);
+    tm.ms = (udpIn[34] << 8) | (udpIn[35]);
+    if (udpIn[29] > toki.getTimeSource()) { //if sender's time source is more accurate
+      toki.adjust(tm, PRESUMED_NETWORK_DELAY); //adjust trivially for network delay
+      uint8_t ts = TOKI_TS_UDP;
+      if (udpIn[29] > 99) ts = TOKI_TS_UDP_NTP;
+      else if (udpIn[29] >= TOKI_TS_SEC) ts = TOKI_TS_UDP_SEC;
+      toki.setTime(tm, ts);
+    } else if (timebaseUpdated && toki.getTimeSource() > 99) { //if we both have good times, get a more accurate timebase
+      Toki::Time myTime = toki.getTime();
+      uint32_t diff = toki.msDifference(tm, myTime);
+      strip.timebase -= PRESUMED_NETWORK_DELAY; //no need to presume, use difference between NTP times at send and receive points
+      if (toki.isLater(tm, myTime)) {
+        strip.timebase += diff;
+      } else {
+        strip.timebase -= diff;
       }
     }
-    
-    if (version > 3)
-    {
-      transitionDelayTemp = ((udpIn[17] << 0) & 0xFF) + ((udpIn[18] << 8) & 0xFF00);
+  }
+  
+  if (version > 3)
+  {
+    transitionDelayTemp = ((udpIn[17] << 0) & 0xFF) + ((udpIn[18] << 8) & 0xFF00);
+  }
+
+  nightlightActive = udpIn[6];
+  if (nightlightActive) nightlightDelayMins = udpIn[7];
+  
+  if (receiveNotificationBrightness || !someSel) bri = udpIn[2];
+  colorUpdated(CALL_MODE_NOTIFICATION, segmentsSet);
+}
+
+//notifier packet received by ESP-NOW
+void handleEspNowNotification(const byte* data, uint16_t len)
+{
+  if (realtimeMode || !receiveNotifications || len < 12) return;
+  applyNotification(data, len, IPAddress());
+}
+
+//WLED notifier, node list, TPM2.NET, UDP realtime and UDP API packets
+static void handleNotifierPacket(uint16_t packetSize, bool isSupp)
+{
+  unsigned long packetStart = micros();
+  realtimePacketRx = packetStart;
+  IPAddress localIP = Network.localIP();
+  if (packetSize > UDP_IN_MAXSIZE) return;
+  if (!isSupp && notifierUdp.remoteIP() == localIP) return; //don't process broadcasts we send ourselves
+
+  if (!udpInPacket) {
+    udpInPacket = (uint8_t*) malloc(UDP_IN_MAXSIZE +1);
+    if (!udpInPacket) return;
+  }
+  uint8_t* udpIn = udpInPacket;
+  uint16_t len;
+  if (isSupp) len = notifier2Udp.read(udpIn, packetSize);
+  else        len =  notifierUdp.read(udpIn, packetSize);
+
+  // WLED nodes info notifications
+  if (isSupp && udpIn[0] == 255 && udpIn[1] == 1 && len >= 40) {
+    if (!nodeListEnabled || notifier2Udp.remoteIP() == localIP) return;
+
+    uint8_t unit = udpIn[39];
+    NodeStruct* node = Nodes.insert(unit); // replaces the stalest node if the table is full
+    for (byte x = 0; x < 4; x++) {
+      node->ip[x] = udpIn[x + 2];
     }
+    node->age = 0; // reset 'age counter'
+    node->setName(reinterpret_cast<char *>(&udpIn[6]));
+    node->nodeType = udpIn[38];
+    uint32_t build = 0;
+    if (len >= 44)
+      for (byte i=0; i<sizeof(uint32_t); i++)
+        build |= udpIn[40+i]<<(8*i);
+    node->build = build;
+    node->leds  = (len >= 47) ? udpIn[44] | (udpIn[45] << 8) : 0;
+    node->flags = (len >= 47) ? udpIn[46] : 0;
+    return;
+  }
+
+  if (!isSupp && udpIn[0] == UDP_TIMESYNC_TOKEN && len >= UDP_TIMESYNC_SIZE) {
+    handleTimeSyncPacket(udpIn);
+    return;
+  }
 
-    nightlightActive = udpIn[6];
-    if (nightlightActive) nightlightDelayMins = udpIn[7];
-    
-    if (receiveNotificationBrightness || !someSel) bri = udpIn[2];
-    colorUpdated(CALL_MODE_NOTIFICATION);
+  if (!isSupp && udpIn[0] == UDP_PRESET_TOKEN && len >= UDP_PRESET_SIZE) {
+    handlePresetSyncPacket(udpIn);
+    return;
+  }
+
+  if (!isSupp && udpIn[0] == UDP_PLAYLIST_TOKEN && len >= UDP_PLAYLIST_SIZE) {
+    handlePlaylistSyncPacket(udpIn);
+    return;
+  }
+
+  if (!isSupp && udpIn[0] == UDP_AUDIO_TOKEN && len >= UDP_AUDIO_SIZE) {
+    if (receiveAudioSync) handleAudioPacket(udpIn);
+    return;
+  }
+
+  //wled notifier, ignore if realtime packets active
+  if (udpIn[0] == 0 && !realtimeMode && receiveNotifications)
+  {
+    applyNotification(udpIn, len, (isSupp) ? notifier2Udp.remoteIP() : notifierUdp.remoteIP());
     return;
   }
 
@@ -351,16 +982,17 @@ void handleNotifications()
       }
       else break;
     }
+    realtimePerfAdd(REALTIME_MODE_TPM2NET, packetStart);
     if (tpmPacketCount == numPackets) //reset packet count and show if all packets were received
     {
       tpmPacketCount = 0;
-      strip.show();
+      realtimeShow();
     }
     return;
   }
 
-  //UDP realtime: 1 warls 2 drgb 3 drgbw
-  if (udpIn[0] > 0 && udpIn[0] < 5)
+  //UDP realtime: 1 warls 2 drgb 3 drgbw 4 dnrgb 5 dnrgbw 6 delta
+  if (udpIn[0] > 0 && udpIn[0] < 7)
   {
     realtimeIP = (isSupp) ? notifier2Udp.remoteIP() : notifierUdp.remoteIP();
     DEBUG_PRINTLN(realtimeIP);
@@ -375,7 +1007,6 @@ void handleNotifications()
     }
     if (realtimeOverride) return;
 
-    uint16_t totalLen = strip.getLengthTotal();
     if (udpIn[0] == 1) //warls
     {
       for (uint16_t i = 2; i < packetSize -3; i += 4)
@@ -384,42 +1015,25 @@ void handleNotifications()
       }
     } else if (udpIn[0] == 2) //drgb
     {
-      uint16_t id = 0;
-      for (uint16_t i = 2; i < packetSize -2; i += 3)
-      {
-        setRealtimePixel(id, udpIn[i], udpIn[i+1], udpIn[i+2], 0);
-
-        id++; if (id >= totalLen) break;
-      }
+      setRealtimePixels(0, udpIn + 2, (packetSize -2) /3, false);
     } else if (udpIn[0] == 3) //drgbw
     {
-      uint16_t id = 0;
-      for (uint16_t i = 2; i < packetSize -3; i += 4)
-      {
-        setRealtimePixel(id, udpIn[i], udpIn[i+1], udpIn[i+2], udpIn[i+3]);
-        
-        id++; if (id >= totalLen) break;
-      }
+      setRealtimePixels(0, udpIn + 2, (packetSize -2) /4, true);
     } else if (udpIn[0] == 4) //dnrgb
     {
       uint16_t id = ((udpIn[3] << 0) & 0xFF) + ((udpIn[2] << 8) & 0xFF00);
-      for (uint16_t i = 4; i < packetSize -2; i += 3)
-      {
-        if (id >= totalLen) break;
-        setRealtimePixel(id, udpIn[i], udpIn[i+1], udpIn[i+2], 0);
-        id++;
-      }
+      if (packetSize > 4) setRealtimePixels(id, udpIn + 4, (packetSize -4) /3, false);
     } else if (udpIn[0] == 5) //dnrgbw
     {
       uint16_t id = ((udpIn[3] << 0) & 0xFF) + ((udpIn[2] << 8) & 0xFF00);
-      for (uint16_t i = 4; i < packetSize -2; i += 4)
-      {
-        if (id >= totalLen) break;
-        setRealtimePixel(id, udpIn[i], udpIn[i+1], udpIn[i+2], udpIn[i+3]);
-        id++;
-      }
+      if (packetSize > 4) setRealtimePixels(id, udpIn + 4, (packetSize -4) /4, true);
+    } else if (udpIn[0] == 6) //delta
+    {
+      if (!handleDeltaPacket(udpIn, packetSize)) return;
     }
-    strip.show();
+    realtimePerfAdd(REALTIME_MODE_UDP, packetStart);
+    if (udpIn[0] == 6 && deltaNext) return; //shown with the last packet of the frame
+    realtimeShow();
     return;
   }
 
@@ -431,7 +1045,7 @@ void handleNotifications()
     apireq += (char*)udpIn;
     handleSet(nullptr, apireq);
   } else if (udpIn[0] == '{') { //JSON API
-    DynamicJsonDocument jsonBuffer(2048);
+    PSRAMDynamicJsonDocument jsonBuffer(2048);
     DeserializationError error = deserializeJson(jsonBuffer, udpIn);
     JsonObject root = jsonBuffer.as<JsonObject>();
     if (!error && !root.isNull()) deserializeState(root);
@@ -442,9 +1056,10 @@ void handleNotifications()
 void setRealtimePixel(uint16_t i, byte r, byte g, byte b, byte w)
 {
   uint16_t pix = i + arlsOffset;
-  if (pix < strip.getLengthTotal())
+  if (pix < strip.getLengthTotal() && strip.isRealtimePixel(pix))
   {
-    if (!arlsDisableGammaCorrection && strip.gammaCorrectCol)
+    recordPixel(pix, r, g, b, w);
+    if (!arlsDisableGammaCorrection && strip.gammaCorrectCol && !strip.updateOutputGamma())
     {
       strip.setPixelColor(pix, strip.gamma8(r), strip.gamma8(g), strip.gamma8(b), strip.gamma8(w));
     } else {
@@ -453,26 +1068,23 @@ void setRealtimePixel(uint16_t i, byte r, byte g, byte b, byte w)
   }
 }
 
+//sets len consecutive realtime pixels from packed RGB(W) channel data, written to the busses in spans
+void setRealtimePixels(uint16_t i, const byte* data, uint16_t len, bool rgbw)
+{
+  uint32_t pix = i + arlsOffset;
+  uint16_t totalLen = strip.getLengthTotal();
+  if (pix >= totalLen) return;
+  if (pix + len > totalLen) len = totalLen - pix;
+  recordPixels(pix, data, len, rgbw);
+  strip.setRealtimeSpan(pix, data, len, rgbw, !arlsDisableGammaCorrection && strip.gammaCorrectCol);
+}
+
 /*********************************************************************************************\
    Refresh aging for remote units, drop if too old...
 \*********************************************************************************************/
 void refreshNodeList()
 {
-  for (NodesMap::iterator it = Nodes.begin(); it != Nodes.end();) {
-    bool mustRemove = true;
-
-    if (it->second.ip[0] != 0) {
-      if (it->second.age < 10) {
-        it->second.age++;
-        mustRemove = false;
-        ++it;
-      }
-    }
-
-    if (mustRemove) {
-      it = Nodes.erase(it);
-    }
-  }
+  Nodes.age(10);
 }
 
 /*********************************************************************************************\
@@ -493,10 +1105,12 @@ void sendSysInfoUDP()
   // 38: 1 byte node type id
   // 39: 1 byte node id
   // 40: 4 byte version ID
-  // 44 bytes total
+  // 44: 2 byte LED count
+  // 46: 1 byte flags (NODE_FLAG_*)
+  // 48 bytes total
 
   // send my info to the world...
-  uint8_t data[44] = {0};
+  uint8_t data[48] = {0};
   data[0] = 255;
   data[1] = 1;
   
@@ -516,9 +1130,13 @@ void sendSysInfoUDP()
   uint32_t build = VERSION;
   for (byte i=0; i<sizeof(uint32_t); i++)
     data[40+i] = (build>>(8*i)) & 0xFF;
+  uint16_t leds = strip.getLengthTotal();
+  data[44] = leds & 0xFF;
+  data[45] = leds >> 8;
+  data[46] = vstripFollow ? NODE_FLAG_VSTRIP_FOLLOWER : 0;
 
   IPAddress broadcastIP(255, 255, 255, 255);
-  notifier2Udp.beginPacket(broadcastIP, udpPort2);
+  beginSyncPacket(notifier2Udp, broadcastIP, udpPort2);
   notifier2Udp.write(data, sizeof(data));
   notifier2Udp.endPacket();
 }
@@ -550,93 +1168,228 @@ void sendSysInfoUDP()
 // Send real time UDP updates to the specified client
 //
 // type   - protocol type (0=DDP, 1=E1.31, 2=ArtNet)
+//          E1.31 and ArtNet start at e131OutUniverse/e131OutAddress and continue in the following universes
 // client - the IP address to send to
 // length - the number of pixels
 // buffer - a buffer of at least length*4 bytes long
-// isRGBW - true if the buffer contains 4 components per pixel
+// isRGBW - true if the buffer contains 4 components per pixel, sent as RGBW
+// udp    - persistent socket of the sending bus (a temporary one is used if null)
+//
+// Every packet is assembled in udpOutPacket and sent with a single write()
 
-uint8_t sequenceNumber = 0; // this needs to be shared across all outputs
+uint8_t sequenceNumber = 0; // of realtimeBroadcast() without a target of its own
 
-uint8_t realtimeBroadcast(uint8_t type, IPAddress client, uint16_t length, uint8_t *buffer, uint8_t bri, bool isRGBW)  {
-  if (!interfacesInited) return 1;  // network not initialised
+#define UDP_OUT_PACKET_SIZE (10 + DDP_CHANNELS_PER_PACKET) // largest packet, DDP header + data
+#define E131_OUT_HEADER_SIZE (E131_DMP_DATA +1)             // includes DMX start code
+#define ARTNET_OUT_HEADER_SIZE 18
 
-  WiFiUDP ddpUdp;
+static uint8_t* udpOutPacket = nullptr; // allocated on first use, most setups never send
+static unsigned long udpOutStatsTime = 0;
+static uint16_t udpOutStatsPackets = 0;
 
-  switch (type) {
-    case 0: // DDP
-    {
-      // calclate the number of UDP packets we need to send
-      uint16_t channelCount = length * 3; // 1 channel for every R,G,B value
-      uint16_t packetCount = channelCount / DDP_CHANNELS_PER_PACKET;
-      if (channelCount % DDP_CHANNELS_PER_PACKET) {
-        packetCount++;
+// copies leds RGB(W) pixels into dst, scaled by bri. Returns the number of bytes written
+static uint16_t assemblePixels(uint8_t* dst, const uint8_t* src, uint16_t leds, uint8_t bri, bool isRGBW, bool sendW)
+{
+  uint8_t* d = dst;
+  if (bri == 255) {
+    if (isRGBW == sendW) {
+      uint16_t len = leds * (isRGBW ? 4 : 3);
+      memcpy(d, src, len);
+      return len;
+    }
+    for (uint16_t i = 0; i < leds; i++) {
+      *d++ = *src++; *d++ = *src++; *d++ = *src++;
+      src++; //isRGBW, W dropped
+    }
+  } else {
+    for (uint16_t i = 0; i < leds; i++) {
+      *d++ = scale8(*src++, bri); // R
+      *d++ = scale8(*src++, bri); // G
+      *d++ = scale8(*src++, bri); // B
+      if (isRGBW) {
+        if (sendW) *d++ = scale8(*src, bri);
+        src++;
       }
+    }
+  }
+  return d - dst;
+}
 
-      // there are 3 channels per RGB pixel
-      uint32_t channel = 0; // TODO: allow specifying the start channel
-      // the current position in the buffer 
-      uint16_t bufferOffset = 0;
-
-      for (uint16_t currentPacket = 0; currentPacket < packetCount; currentPacket++) {
-        if (sequenceNumber > 15) sequenceNumber = 0;
-
-        if (!ddpUdp.beginPacket(client, DDP_DEFAULT_PORT)) {  // port defined in ESPAsyncE131.h
-          DEBUG_PRINTLN(F("WiFiUDP.beginPacket returned an error"));
-          return 1; // problem
-        }
-
-        // the amount of data is AFTER the header in the current packet
-        uint16_t packetSize = DDP_CHANNELS_PER_PACKET;
-
-        uint8_t flags = DDP_FLAGS1_VER1;
-        if (currentPacket == (packetCount - 1)) {
-          // last packet, set the push flag
-          // TODO: determine if we want to send an empty push packet to each destination after sending the pixel data
-          flags = DDP_FLAGS1_VER1 | DDP_FLAGS1_PUSH;
-          if (channelCount % DDP_CHANNELS_PER_PACKET) {
-            packetSize = channelCount % DDP_CHANNELS_PER_PACKET;
-          }
-        }
-
-        // write the header
-        /*0*/ddpUdp.write(flags);
-        /*1*/ddpUdp.write(sequenceNumber++ & 0x0F); // sequence may be unnecessary unless we are sending twice (as requested in Sync settings)
-        /*2*/ddpUdp.write(0);
-        /*3*/ddpUdp.write(DDP_ID_DISPLAY);
-        // data offset in bytes, 32-bit number, MSB first
-        /*4*/ddpUdp.write(0xFF & (channel >> 24));
-        /*5*/ddpUdp.write(0xFF & (channel >> 16));
-        /*6*/ddpUdp.write(0xFF & (channel >>  8));
-        /*7*/ddpUdp.write(0xFF & (channel      ));
-        // data length in bytes, 16-bit number, MSB first
-        /*8*/ddpUdp.write(0xFF & (packetSize >> 8));
-        /*9*/ddpUdp.write(0xFF & (packetSize     ));
-
-        // write the colors, the write write(const uint8_t *buffer, size_t size) 
-        // function is just a loop internally too
-        for (uint16_t i = 0; i < packetSize; i += 3) {
-          ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // R
-          ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // G
-          ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // B
-          if (isRGBW) bufferOffset++;
-        }
-
-        if (!ddpUdp.endPacket()) {            
-          DEBUG_PRINTLN(F("WiFiUDP.endPacket returned an error"));
-          return 1; // problem
-        }
-
-        channel += packetSize;
-      }
-    } break;
+static bool sendPacket(WiFiUDP& udp, IPAddress client, uint16_t port, uint16_t len)
+{
+  if (!udp.beginPacket(client, port) || udp.write(udpOutPacket, len) != len || !udp.endPacket()) {
+    DEBUG_PRINTLN(F("Realtime UDP send failed"));
+    udpOutErrors++;
+    return false;
+  }
+  udpOutPackets++;
+  udpOutStatsPackets++;
+  if (millis() - udpOutStatsTime >= 1000) {
+    udpOutPacketsPerSec = udpOutStatsPackets;
+    udpOutStatsPackets = 0;
+    udpOutStatsTime = millis();
+  }
+  return true;
+}
 
-    case 1: //E1.31
-    {
-    } break;
+// E1.31/Art-Net: pixels are never split across universes, the first one starts at e131OutAddress
+static uint16_t e131OutFirstLeds(uint8_t channelsPerLed, uint16_t& address)
+{
+  address = (e131OutAddress > 0 && e131OutAddress <= 512) ? e131OutAddress -1 : 0; //0-based, first universe only
+  return (512 - address) / channelsPerLed;
+}
 
-    case 2: //ArtNet
-    {
-    } break;
+// packets a frame of length pixels takes, including the ArtSync packet
+uint16_t realtimePacketCount(uint8_t type, uint16_t length, bool isRGBW)
+{
+  uint8_t channelsPerLed = isRGBW ? 4 : 3;
+  if (type == 0) return ((uint32_t)length * channelsPerLed + DDP_CHANNELS_PER_PACKET -1) / DDP_CHANNELS_PER_PACKET;
+  uint16_t address;
+  uint16_t first = e131OutFirstLeds(channelsPerLed, address);
+  uint16_t perUniverse = 512 / channelsPerLed;
+  uint16_t packets = (length <= first) ? 1 : (first ? 1 : 0) + (length - first + perUniverse -1) / perUniverse;
+  if (type == 2 && artnetOutSync) packets++;
+  return packets;
+}
+
+//
+// Sends packet n (0 to realtimePacketCount() -1) of a frame, so the packets of several targets can be interleaved.
+// seq is the sequence counter of the target: DDP counts packets (1-15), E1.31 and Art-Net count frames (seq advances with packet 0)
+// Returns false if the packet could not be sent
+//
+bool realtimeSendPacket(uint8_t type, IPAddress client, uint16_t length, const uint8_t* buffer, uint8_t bri, bool isRGBW, WiFiUDP* udp, uint16_t n, uint8_t& seq)
+{
+  if (!interfacesInited) return false;  // network not initialised
+
+  if (!udpOutPacket) {
+    udpOutPacket = (uint8_t*) malloc(UDP_OUT_PACKET_SIZE);
+    if (!udpOutPacket) return false;
+  }
+  WiFiUDP tmpUdp;
+  WiFiUDP& ddpUdp = udp ? *udp : tmpUdp;
+  uint8_t channelsPerLed = isRGBW ? 4 : 3;
+
+  if (type == 0) { // DDP
+    uint32_t channelCount = (uint32_t)length * channelsPerLed;
+    uint32_t channel = (uint32_t)n * DDP_CHANNELS_PER_PACKET; // data offset in bytes
+    if (channel >= channelCount) return true;
+    // the amount of data is AFTER the header in the current packet
+    uint16_t packetSize = MIN((uint32_t)DDP_CHANNELS_PER_PACKET, channelCount - channel);
+    uint8_t flags = DDP_FLAGS1_VER1;
+    if (channel + packetSize >= channelCount) flags |= DDP_FLAGS1_PUSH; // last packet
+    seq = seq % 15 + 1;
+
+    // write the header
+    /*0*/udpOutPacket[0] = flags;
+    /*1*/udpOutPacket[1] = seq;
+    /*2*/udpOutPacket[2] = ((isRGBW ? DDP_FORMAT_RGBW : DDP_FORMAT_RGB) << 3) | DDP_SIZE_8BIT;
+    /*3*/udpOutPacket[3] = DDP_ID_DISPLAY;
+    // data offset in bytes, 32-bit number, MSB first
+    /*4*/udpOutPacket[4] = 0xFF & (channel >> 24);
+    /*5*/udpOutPacket[5] = 0xFF & (channel >> 16);
+    /*6*/udpOutPacket[6] = 0xFF & (channel >>  8);
+    /*7*/udpOutPacket[7] = 0xFF & (channel      );
+    // data length in bytes, 16-bit number, MSB first
+    /*8*/udpOutPacket[8] = 0xFF & (packetSize >> 8);
+    /*9*/udpOutPacket[9] = 0xFF & (packetSize     );
+
+    assemblePixels(udpOutPacket + 10, buffer + channel, packetSize / channelsPerLed, bri, isRGBW, isRGBW);
+    return sendPacket(ddpUdp, client, DDP_DEFAULT_PORT, 10 + packetSize);
+  }
+
+  //E1.31, ArtNet
+  bool isArtnet = (type == 2);
+  // one sequence number per frame, shared by all universes of the frame
+  if (n == 0) {
+    if (isArtnet) { if (++seq == 0) seq = 1; } //0 disables sequencing
+    else seq++;
+  }
+  uint16_t address;
+  uint16_t first = e131OutFirstLeds(channelsPerLed, address);
+  uint16_t perUniverse = 512 / channelsPerLed;
+  uint16_t u = first ? n : n +1; // a start address too high for a single pixel skips the first universe
+  uint16_t pixel = u ? first + (u -1) * perUniverse : 0;
+  if (u) address = 0;
+
+  if (pixel >= length) {
+    if (!isArtnet || !artnetOutSync) return true;
+    // ArtSync makes all receivers output the universes of this frame at the same time
+    memset(udpOutPacket, 0, 14);
+    memcpy_P(udpOutPacket, PSTR("Art-Net"), 8);
+    udpOutPacket[8]  = ARTNET_OPCODE_OPSYNC & 0xFF;
+    udpOutPacket[9]  = ARTNET_OPCODE_OPSYNC >> 8;
+    udpOutPacket[11] = 14;
+    return sendPacket(ddpUdp, client, ARTNET_DEFAULT_PORT, 14);
+  }
+
+  uint16_t universe = e131OutUniverse + u;
+  uint16_t ledsInUniverse = MIN((uint16_t)((512 - address) / channelsPerLed), (uint16_t)(length - pixel));
+  uint16_t channels = address + ledsInUniverse * channelsPerLed;
+  if (isArtnet && (channels & 1)) channels++; //Art-Net data length must be even
+
+  uint8_t* hdr = udpOutPacket;
+  uint16_t hdrSize = isArtnet ? ARTNET_OUT_HEADER_SIZE : E131_OUT_HEADER_SIZE;
+  uint16_t packetSize = hdrSize + channels;
+  memset(hdr, 0, packetSize);
+  if (isArtnet) {
+    memcpy_P(hdr, PSTR("Art-Net"), 8);
+    hdr[8]  = ARTNET_OPCODE_OPDMX & 0xFF; // opcode, LSB first
+    hdr[9]  = ARTNET_OPCODE_OPDMX >> 8;
+    hdr[11] = 14;                         // protocol version
+    hdr[12] = seq;
+    hdr[14] = universe & 0xFF;            // SubUni
+    hdr[15] = (universe >> 8) & 0x7F;     // Net
+    hdr[16] = channels >> 8;              // length, MSB first
+    hdr[17] = channels & 0xFF;
+  } else {
+    // root layer
+    hdr[E131_ROOT_PREAMBLE_SIZE +1] = 0x10;
+    memcpy_P(hdr + E131_ROOT_ID, PSTR("ASC-E1.17"), 9);
+    hdr[E131_ROOT_FLENGTH]    = 0x70 | ((packetSize - E131_ROOT_FLENGTH) >> 8);
+    hdr[E131_ROOT_FLENGTH +1] = (packetSize - E131_ROOT_FLENGTH) & 0xFF;
+    hdr[E131_ROOT_VECTOR +3]  = 0x04; // VECTOR_ROOT_E131_DATA
+    e131OutCid(hdr + E131_ROOT_CID);
+    // framing layer
+    hdr[E131_FRAME_FLENGTH]    = 0x70 | ((packetSize - E131_FRAME_FLENGTH) >> 8);
+    hdr[E131_FRAME_FLENGTH +1] = (packetSize - E131_FRAME_FLENGTH) & 0xFF;
+    hdr[E131_FRAME_VECTOR +3]  = 0x02; // VECTOR_E131_DATA_PACKET
+    strncpy((char*)hdr + E131_FRAME_SOURCE, serverDescription, 63);
+    hdr[E131_FRAME_PRIORITY]   = 100;
+    hdr[E131_FRAME_SEQ]        = seq;
+    hdr[E131_FRAME_UNIVERSE]    = universe >> 8;
+    hdr[E131_FRAME_UNIVERSE +1] = universe & 0xFF;
+    // DMP layer
+    hdr[E131_DMP_FLENGTH]    = 0x70 | ((packetSize - E131_DMP_FLENGTH) >> 8);
+    hdr[E131_DMP_FLENGTH +1] = (packetSize - E131_DMP_FLENGTH) & 0xFF;
+    hdr[E131_DMP_VECTOR]     = 0x02;
+    hdr[E131_DMP_TYPE]       = 0xA1;
+    hdr[E131_DMP_ADDR_INC +1] = 0x01;
+    hdr[E131_DMP_COUNT]      = (channels +1) >> 8;
+    hdr[E131_DMP_COUNT +1]   = (channels +1) & 0xFF;
+    // hdr[E131_DMP_DATA] is the DMX start code (0)
+  }
+
+  // channels before the start address and Art-Net padding stay 0
+  assemblePixels(hdr + hdrSize + address, buffer + pixel * channelsPerLed, ledsInUniverse, bri, isRGBW, isRGBW);
+  return sendPacket(ddpUdp, client, isArtnet ? ARTNET_DEFAULT_PORT : E131_DEFAULT_PORT, packetSize);
+}
+
+// sends a whole frame at once, returns 1 on error. seq is the sequence number of the target, the shared one if nullptr
+uint8_t realtimeBroadcast(uint8_t type, IPAddress client, uint16_t length, uint8_t *buffer, uint8_t bri, bool isRGBW, WiFiUDP* udp, uint8_t* seq)  {
+  uint16_t packets = realtimePacketCount(type, length, isRGBW);
+  if (!seq) seq = &sequenceNumber;
+  for (uint16_t n = 0; n < packets; n++) {
+    if (!realtimeSendPacket(type, client, length, buffer, bri, isRGBW, udp, n, *seq)) return 1; // problem
   }
   return 0;
 }
+
+// E1.31 component identifier, a 16 byte UUID derived from the MAC address so it is stable across reboots
+void e131OutCid(uint8_t* cid)
+{
+  static const uint8_t cidBase[10] PROGMEM = {0x57, 0x4c, 0x45, 0x44, 0x2d, 0x45, 0x31, 0x33, 0x31, 0x2d}; // "WLED-E131-"
+  memcpy_P(cid, cidBase, sizeof(cidBase));
+  uint8_t mac[6];
+  WiFi.macAddress(mac);
+  memcpy(cid + sizeof(cidBase), mac, 6);
+}
@@ -4,7 +4,35 @@
  */
 
 //Usermod Manager internals
-void UsermodManager::loop()              { for (byte i = 0; i < numMods; i++) ums[i]->loop();  }
+
+/*
+ * Usermods without a loop interval run on every iteration.
+ * The others only run when their interval is due and while USERMOD_LOOP_BUDGET lasts.
+ * A usermod that was skipped for lack of budget always gets its turn in the next iteration.
+ */
+void UsermodManager::loop()
+{
+  unsigned long now = millis();
+  uint32_t start = micros();
+  for (byte i = 0; i < numMods; i++) {
+    uint32_t modStart = micros();
+    if (ums[i]->getLoopInterval()) {
+      if (now - lastLoop[i] < ums[i]->getLoopInterval()) continue;
+      if (modStart - start > USERMOD_LOOP_BUDGET && !(deferred & (1UL << i))) {
+        deferred |= (1UL << i);
+        continue;
+      }
+      deferred &= ~(1UL << i);
+      lastLoop[i] = now;
+    }
+    ums[i]->loop();
+    uint32_t took = micros() - modStart;
+    loopAvg[i] = (loopAvg[i] * 7 + took) >> 3;
+    if (took > loopMax[i]) loopMax[i] = took;
+    if (took > ums[i]->getLoopBudget() && overruns[i] < UINT16_MAX) overruns[i]++;
+  }
+}
+
 void UsermodManager::handleOverlayDraw() { for (byte i = 0; i < numMods; i++) ums[i]->handleOverlayDraw(); }
 bool UsermodManager::handleButton(uint8_t b) { 
   bool overrideIO = false;
@@ -18,7 +46,20 @@ void UsermodManager::setup()     { for (byte i = 0; i < numMods; i++) ums[i]->se
 void UsermodManager::connected() { for (byte i = 0; i < numMods; i++) ums[i]->connected(); }
 
 void UsermodManager::addToJsonState(JsonObject& obj)    { for (byte i = 0; i < numMods; i++) ums[i]->addToJsonState(obj); }
-void UsermodManager::addToJsonInfo(JsonObject& obj)     { for (byte i = 0; i < numMods; i++) ums[i]->addToJsonInfo(obj); }
+void UsermodManager::addToJsonInfo(JsonObject& obj)
+{
+  if (numMods) {
+    JsonArray perf = obj.createNestedArray(F("umperf")); //[id, avg us, max us, overruns] per usermod loop()
+    for (byte i = 0; i < numMods; i++) {
+      JsonArray mod = perf.createNestedArray();
+      mod.add(ums[i]->getId());
+      mod.add(loopAvg[i]);
+      mod.add(loopMax[i]);
+      mod.add(overruns[i]);
+    }
+  }
+  for (byte i = 0; i < numMods; i++) ums[i]->addToJsonInfo(obj);
+}
 void UsermodManager::readFromJsonState(JsonObject& obj) { for (byte i = 0; i < numMods; i++) ums[i]->readFromJsonState(obj); }
 void UsermodManager::addToConfig(JsonObject& obj)       { for (byte i = 0; i < numMods; i++) ums[i]->addToConfig(obj); }
 bool UsermodManager::readFromConfig(JsonObject& obj)    { 
@@ -34,6 +75,14 @@ bool UsermodManager::onMqttMessage(char* topic, char* payload) {
   return false;
 }
 
+//notifies the usermods that subscribed to this event, so they need not poll for the change in loop()
+void UsermodManager::publish(uint8_t event, uint8_t arg)
+{
+  for (byte i = 0; i < numMods; i++) {
+    if (ums[i]->getEventMask() & event) ums[i]->onEvent(event, arg);
+  }
+}
+
 /*
  * Enables usermods to lookup another Usermod.
  */
@@ -108,6 +108,10 @@
 #include "../usermods/quinled-an-penta/quinled-an-penta.h"
 #endif
 
+#ifdef USERMOD_AUDIOREACTIVE
+#include "../usermods/audio_reactive/usermod_audio_reactive.h"
+#endif
+
 void registerUsermods()
 {
 /*
@@ -203,4 +207,8 @@ void registerUsermods()
   #ifdef QUINLED_AN_PENTA
   usermods.add(new QuinLEDAnPentaUsermod());
   #endif
+
+  #ifdef USERMOD_AUDIOREACTIVE
+  usermods.add(new AudioReactiveUsermod());
+  #endif
 }
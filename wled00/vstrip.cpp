@@ -0,0 +1,73 @@
+#include "wled.h"
+
+/*
+ * Virtual strip spanning several nodes: the pixels of a TYPE_NET_VSTRIP bus are split among the nodes of the
+ * instance list that announce themselves as followers (vstripFollow), in the order of their unit (last IP octet),
+ * each one as many as it has LEDs. Every follower is sent its slice by DDP, starting at its first LED,
+ * so it only needs realtime reception. The split is redone when followers come, go or change their LED count.
+ */
+
+typedef struct VStripFollower {
+  IPAddress ip;
+  uint16_t start;   // first pixel of the bus
+  uint16_t len;
+  uint8_t unit;
+  uint8_t seq;      // DDP sequence number of this follower
+} VStripFollower;
+
+static VStripFollower vstripFollowers[VSTRIP_MAX_FOLLOWERS];
+static uint8_t vstripCount = 0;
+static unsigned long vstripAssigned = 0;
+static bool vstripUsed = false;   // a bus of the virtual strip showed a frame recently
+
+static void vstripAssign(uint16_t len)
+{
+  VStripFollower old[VSTRIP_MAX_FOLLOWERS];
+  uint8_t oldCount = vstripCount;
+  memcpy(old, vstripFollowers, sizeof(old));
+  vstripCount = 0;
+  for (uint16_t i = 0; i < Nodes.capacity(); i++) {
+    NodeStruct& n = Nodes[i];
+    if (!n.used || !(n.flags & NODE_FLAG_VSTRIP_FOLLOWER) || !n.leds || n.ip[0] == 0) continue;
+    // insertion by unit, the node table is in hash order
+    uint8_t j = vstripCount;
+    if (j == VSTRIP_MAX_FOLLOWERS) {
+      if (n.unit > vstripFollowers[j -1].unit) continue;
+      j--;
+    } else vstripCount++;
+    for (; j > 0 && vstripFollowers[j -1].unit > n.unit; j--) vstripFollowers[j] = vstripFollowers[j -1];
+    vstripFollowers[j] = {n.ip, 0, n.leds, n.unit, 0};
+  }
+  uint16_t start = 0;
+  for (uint8_t i = 0; i < vstripCount; i++) {
+    for (uint8_t k = 0; k < oldCount; k++) if (old[k].ip == vstripFollowers[i].ip) vstripFollowers[i].seq = old[k].seq; //followers keep counting
+    vstripFollowers[i].start = start;
+    if (start < len) start += MIN(vstripFollowers[i].len, (uint16_t)(len - start));
+  }
+  vstripAssigned = millis();
+}
+
+//called by the bus for each frame, data is RGB
+void vstripShow(uint8_t* data, uint16_t len, uint8_t bri, WiFiUDP* udp)
+{
+  vstripUsed = true;
+  if (!vstripAssigned || millis() - vstripAssigned > VSTRIP_ASSIGN_INTERVAL) vstripAssign(len);
+  for (uint8_t i = 0; i < vstripCount; i++) {
+    VStripFollower& f = vstripFollowers[i];
+    if (f.start >= len) break;
+    uint16_t n = MIN(f.len, (uint16_t)(len - f.start));
+    realtimeBroadcast(0, f.ip, n, data + f.start * 3, bri, false, udp, &f.seq);
+  }
+}
+
+void serializeVStrip(JsonObject root)
+{
+  if (!vstripUsed) return;
+  JsonArray followers = root.createNestedArray(F("vstrip"));
+  for (uint8_t i = 0; i < vstripCount; i++) {
+    JsonObject f = followers.createNestedObject();
+    f["ip"]    = vstripFollowers[i].ip.toString();
+    f["start"] = vstripFollowers[i].start;
+    f["len"]   = vstripFollowers[i].len;
+  }
+}
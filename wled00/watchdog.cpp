@@ -0,0 +1,171 @@
+#include "wled.h"
+
+/*
+ * Loop stall watchdog: WLED::loop() marks the subsystem it enters (WDT_STAGE_* in const.h) and a timer checks
+ * that each loop pass, and the render task with WLED_RENDER_TASK, completes within WLED_WATCHDOG_STALL_MS.
+ * A stall is recorded with its stage, duration and the last trace events (with WLED_ENABLE_TRACE) in RTC memory,
+ * which survives a reset by the hardware watchdog or a crash. The record of the previous boot, including the stage
+ * the loop was in when it went down, is in /json/info "wdt" after the reset.
+ * ESP8266 timers only run while the loop yields: a stall that does not yield is not seen until the hardware
+ * watchdog resets, then only the stage is known.
+ */
+#ifdef WLED_ENABLE_WATCHDOG
+#include <Ticker.h>
+
+#ifndef WLED_WATCHDOG_STALL_MS
+  #define WLED_WATCHDOG_STALL_MS 2000
+#endif
+#define WDT_CHECK_MS  250
+#define WDT_MAGIC     0x57445431
+#define WDT_RTC_OFS   72 // ESP8266: in 4 byte blocks, after the WiFi cache of wled.cpp
+#define WDT_TRACE     8  // trace events kept of a stall
+
+typedef struct WatchdogTrace {
+  uint32_t before;    // us before the stall was detected
+  uint16_t arg;
+  uint8_t ev;         // TRACE_*
+  char phase;
+} WatchdogTrace;
+
+typedef struct WatchdogRecord {
+  uint32_t magic;
+  uint8_t stage;      // loop stage entered last
+  uint8_t stallStage;
+  uint8_t stallTask;  // 0 loop, 1 render task
+  uint8_t traceCount;
+  uint16_t stalls;    // since boot
+  uint16_t reserved;
+  uint32_t stallMs;   // so far, if it did not end before a reset
+  uint32_t stallAt;   // uptime in s when it began
+  WatchdogTrace trace[WDT_TRACE];
+} WatchdogRecord;
+
+#ifdef ARDUINO_ARCH_ESP32
+RTC_NOINIT_ATTR static WatchdogRecord wdt;
+#else
+static WatchdogRecord wdt;
+#endif
+static WatchdogRecord wdtPrev;         // of the previous boot
+static bool wdtPrevValid = false;
+static Ticker wdtTicker;
+static volatile uint32_t wdtLoopStart = 0;
+static volatile uint32_t wdtRenderBeat = 0;
+static bool wdtStalled[2] = {false, false};
+
+static const char* const wdtStageNames[WDT_STAGE_COUNT] = {
+  "udp", "ir", "hue", "usermods", "service", "ws", "loop", "wifi", "busses", "send", "ota", "mqtt", "config", "presets"
+};
+
+// ESP8266: the record is mirrored to user RTC memory, words from first
+static inline void wdtStore(uint8_t first, uint8_t words)
+{
+  #ifdef ESP8266
+  ESP.rtcUserMemoryWrite(WDT_RTC_OFS + first, (uint32_t*)&wdt + first, words * 4);
+  #endif
+}
+
+static void wdtCheckTask(uint8_t task, uint32_t elapsed, uint8_t stage)
+{
+  if (elapsed < WLED_WATCHDOG_STALL_MS) {
+    wdtStalled[task] = false;
+    return;
+  }
+  if (!wdtStalled[task]) { // new stall
+    wdtStalled[task] = true;
+    wdt.stalls++;
+    wdt.stallTask = task;
+    wdt.stallStage = stage;
+    wdt.stallAt = (millis() - elapsed) / 1000;
+    uint32_t now = micros();
+    uint8_t n = 0;
+    uint32_t us; uint8_t ev; char phase; uint16_t arg;
+    while (n < WDT_TRACE && traceRecent(n, us, ev, phase, arg)) {
+      WatchdogTrace& t = wdt.trace[n++];
+      t.before = now - us; t.ev = ev; t.phase = phase; t.arg = arg;
+    }
+    wdt.traceCount = n;
+  }
+  wdt.stallMs = elapsed;
+  wdtStore(0, sizeof(wdt) / 4);
+}
+
+static void wdtCheck()
+{
+  uint32_t now = millis();
+  wdtCheckTask(0, now - wdtLoopStart, wdt.stage);
+  #ifdef WLED_RENDER_TASK
+  wdtCheckTask(1, now - wdtRenderBeat, LOOP_PERF_SERVICE);
+  #endif
+}
+
+void initWatchdog()
+{
+  #ifdef ESP8266
+  ESP.rtcUserMemoryRead(WDT_RTC_OFS, (uint32_t*)&wdt, sizeof(wdt));
+  #endif
+  wdtPrevValid = wdt.magic == WDT_MAGIC && wdt.stage < WDT_STAGE_COUNT;
+  if (wdtPrevValid) memcpy(&wdtPrev, &wdt, sizeof(wdt));
+  memset(&wdt, 0, sizeof(wdt));
+  wdt.magic = WDT_MAGIC;
+  wdt.stage = WDT_STAGE_LOOP;
+  wdtStore(0, sizeof(wdt) / 4);
+  wdtLoopStart = wdtRenderBeat = millis();
+  wdtTicker.attach_ms(WDT_CHECK_MS, wdtCheck);
+}
+
+void watchdogLoop()
+{
+  wdtLoopStart = millis();
+}
+
+void watchdogStage(uint8_t stage)
+{
+  if (stage == wdt.stage) return;
+  wdt.stage = stage;
+  wdtStore(1, 1);
+}
+
+void watchdogRenderBeat()
+{
+  wdtRenderBeat = millis();
+}
+
+static void serializeStall(JsonObject s, const WatchdogRecord& r)
+{
+  s[F("stage")] = r.stallStage < WDT_STAGE_COUNT ? wdtStageNames[r.stallStage] : "?";
+  s[F("task")] = r.stallTask ? "render" : "loop";
+  s["ms"] = r.stallMs;
+  s[F("at")] = r.stallAt;
+  JsonArray tr = s.createNestedArray(F("trace")); // newest first: [us before, TRACE_* event, phase, arg]
+  for (uint8_t i = 0; i < r.traceCount && i < WDT_TRACE; i++) {
+    JsonArray e = tr.createNestedArray();
+    e.add(r.trace[i].before); e.add(r.trace[i].ev);
+    char phase[2] = {r.trace[i].phase, 0};
+    e.add(phase); e.add(r.trace[i].arg);
+  }
+}
+
+void serializeWatchdog(JsonObject root)
+{
+  JsonObject w = root.createNestedObject(F("wdt"));
+  w[F("max")] = WLED_WATCHDOG_STALL_MS;
+  w[F("stalls")] = wdt.stalls;
+  if (wdt.stalls) serializeStall(w.createNestedObject(F("last")), wdt);
+  if (!wdtPrevValid) return;
+  JsonObject prev = w.createNestedObject(F("prev"));
+  #ifdef ARDUINO_ARCH_ESP32
+  prev[F("reason")] = (int)esp_reset_reason();
+  #else
+  prev[F("reason")] = (int)ESP.getResetInfoPtr()->reason;
+  #endif
+  prev[F("stage")] = wdtStageNames[wdtPrev.stage];
+  prev[F("stalls")] = wdtPrev.stalls;
+  if (wdtPrev.stalls) serializeStall(prev.createNestedObject(F("last")), wdtPrev);
+}
+#else
+void initWatchdog() {}
+void watchdogLoop() {}
+void watchdogStage(uint8_t stage) {}
+void watchdogRenderBeat() {}
+void serializeWatchdog(JsonObject root) {}
+#endif
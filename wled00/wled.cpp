@@ -12,6 +12,57 @@
  * Main WLED class implementation. Mostly initialization and connection logic
  */
 
+// AP of the last connection, kept in RTC memory across reboots so (re)connects can skip the scan
+#define WIFI_CACHE_MAGIC   0x57494649
+#define WIFI_CACHE_RTC_OFS 64 // ESP8266: in 4 byte blocks, the start of user RTC memory is used by OTA
+
+typedef struct WiFiCache {
+  uint32_t check;    // WIFI_CACHE_MAGIC ^ hash of the SSID it was stored for
+  uint8_t bssid[6];
+  uint8_t channel;
+  uint8_t reserved;
+} WiFiCache;
+
+#ifdef ARDUINO_ARCH_ESP32
+RTC_NOINIT_ATTR static WiFiCache wifiCache;
+#else
+static WiFiCache wifiCache;
+static bool wifiCacheLoaded = false;
+#endif
+static bool wifiFastConnect = false; // current attempt goes straight to the cached AP
+static bool wifiScanNext = false;    // the cached AP did not answer, scan on the next attempt
+
+static uint32_t wifiCacheCheck()
+{
+  uint32_t hash = 2166136261UL; // FNV-1a
+  for (const char* c = clientSSID; *c; c++) hash = (hash ^ (uint8_t)*c) * 16777619UL;
+  return WIFI_CACHE_MAGIC ^ hash;
+}
+
+static bool wifiCacheValid()
+{
+  #ifdef ESP8266
+  if (!wifiCacheLoaded) {
+    ESP.rtcUserMemoryRead(WIFI_CACHE_RTC_OFS, (uint32_t*)&wifiCache, sizeof(wifiCache));
+    wifiCacheLoaded = true;
+  }
+  #endif
+  return wifiCache.check == wifiCacheCheck() && wifiCache.channel > 0 && wifiCache.channel < 15;
+}
+
+static void storeWiFiCache()
+{
+  const uint8_t* bssid = WiFi.BSSID();
+  if (!bssid) return;
+  memcpy(wifiCache.bssid, bssid, 6);
+  wifiCache.channel = WiFi.channel();
+  wifiCache.check = wifiCacheCheck();
+  #ifdef ESP8266
+  ESP.rtcUserMemoryWrite(WIFI_CACHE_RTC_OFS, (uint32_t*)&wifiCache, sizeof(wifiCache));
+  wifiCacheLoaded = true;
+  #endif
+}
+
 WLED::WLED()
 {
 }
@@ -23,6 +74,7 @@ void WLED::reset()
   #ifdef WLED_ENABLE_WEBSOCKETS
   ws.closeAll(1012);
   #endif
+  flushPresetQueue();
   long dly = millis();
   while (millis() - dly < 450) {
     yield();        // enough time to send response to client
@@ -39,16 +91,115 @@ bool oappendi(int i)
   return oappend(s);
 }
 
-bool oappend(const char* txt)
+static bool oappendBytes(const char* txt, size_t len)
 {
-  uint16_t len = strlen(txt);
+  if (omax) { // buffer of a streamed response, not terminated (without obuf, only the length is counted)
+    bool fits = olen + len <= omax;
+    if (!fits) len = omax - olen;
+    if (obuf) memcpy_P(obuf + olen, txt, len);
+    olen += len;
+    return fits;
+  }
   if (olen + len >= OMAX)
     return false;        // buffer full
-  strcpy(obuf + olen, txt);
+  memcpy_P(obuf + olen, txt, len);
   olen += len;
+  obuf[olen] = 0;
   return true;
 }
 
+bool oappend(const char* txt)
+{
+  return oappendBytes(txt, strlen(txt));
+}
+
+bool oappend_P(const char* txt, size_t len)
+{
+  return oappendBytes(txt, len);
+}
+
+//for big buffers that are not used for DMA or on every frame: JSON documents, LED maps, network bus data
+//and preloaded presets. They go to PSRAM if there is some, so internal RAM is left for the rest. Release with free()
+void* allocLarge(size_t size)
+{
+  #if defined(ARDUINO_ARCH_ESP32) && defined(WLED_USE_PSRAM)
+  if (size >= WLED_PSRAM_MIN_ALLOC && psramFound()) {
+    void* p = ps_malloc(size);
+    if (p) return p;
+  }
+  #endif
+  return malloc(size);
+}
+
+//largest block that can be allocated from internal RAM
+uint32_t heapLargestBlock()
+{
+  #ifdef ARDUINO_ARCH_ESP32
+  return heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+  #else
+  return ESP.getMaxFreeBlockSize();
+  #endif
+}
+
+//percentage of the free internal RAM that is not part of the largest block
+uint8_t heapFragmentation()
+{
+  #ifdef ARDUINO_ARCH_ESP32
+  uint32_t free = heap_caps_get_free_size(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+  #else
+  uint32_t free = ESP.getFreeHeap();
+  #endif
+  uint32_t largest = heapLargestBlock();
+  return (free && largest < free) ? 100 - largest * 100 / free : 0;
+}
+
+//true if a new JSON request should be turned away, so the device stays responsive instead of failing allocations under load
+bool heapLow()
+{
+  if (heapLargestBlock() >= WLED_HEAP_WATERMARK) return false;
+  heapRejects++;
+  return true;
+}
+
+#ifdef ARDUINO_ARCH_ESP32
+static portMUX_TYPE jsonArenaMux = portMUX_INITIALIZER_UNLOCKED;
+#endif
+
+JsonArenaDoc::JsonArenaDoc(uint8_t module)
+{
+  #ifdef ARDUINO_ARCH_ESP32
+  portENTER_CRITICAL(&jsonArenaMux); //loop and async_tcp may ask at the same time
+  #endif
+  if (!jsonArenaOwner && jsonArena) {
+    jsonArenaOwner = module;
+    _locked = true;
+  }
+  #ifdef ARDUINO_ARCH_ESP32
+  portEXIT_CRITICAL(&jsonArenaMux);
+  #endif
+  if (_locked) {
+    jsonArena->clear();
+    _doc = jsonArena;
+    return;
+  }
+  //never wait, on ESP8266 the owner cannot continue until we return
+  jsonArenaWaits++;
+  DEBUG_PRINTF("JSON arena in use by %d, requested by %d\n", jsonArenaOwner, module);
+  _heap = new PSRAMDynamicJsonDocument(JSON_BUFFER_SIZE);
+  if (_heap && !_heap->capacity()) { delete _heap; _heap = nullptr; }
+  if (_heap) _doc = _heap;
+  else jsonArenaFails++;
+}
+
+JsonArenaDoc::~JsonArenaDoc()
+{
+  if (_locked) {
+    jsonArena->clear();
+    jsonArenaOwner = 0;
+  }
+  delete _heap;
+}
+
 void prepareHostname(char* hostname)
 {
   const char *pC = serverDescription;
@@ -76,6 +227,10 @@ void prepareHostname(char* hostname)
     }
 }
 
+#if defined(ARDUINO_ARCH_ESP32) && defined(WLED_USE_ETHERNET)
+static bool ethernetLinkSeen = false; //the wire was connected since boot
+#endif
+
 //handle Ethernet connection event
 void WiFiEvent(WiFiEvent_t event)
 {
@@ -90,6 +245,7 @@ void WiFiEvent(WiFiEvent_t event)
       break;
     case SYSTEM_EVENT_ETH_CONNECTED:
       DEBUG_PRINT(F("ETH Connected"));
+      ethernetLinkSeen = true;
       if (!apActive) {
         WiFi.disconnect(true);
       }
@@ -118,47 +274,88 @@ void WiFiEvent(WiFiEvent_t event)
   }
 }
 
+static unsigned long lastYieldMicros = 0;
+
+//records the longest time the loop went without yielding
+static void loopYieldGap()
+{
+  uint32_t gap = micros() - lastYieldMicros;
+  if (gap > loopYieldGapMax) loopYieldGapMax = gap;
+}
+
+static void loopYield()
+{
+  loopYieldGap();
+  yield();
+  lastYieldMicros = micros();
+}
+
+#define LOOP_STAGE(stage, call) do { WATCHDOG_STAGE(stage); call; WATCHDOG_STAGE(WDT_STAGE_LOOP); } while (0)
+#define LOOP_TIMED(part, call) do { unsigned long partStart = micros(); LOOP_STAGE(part, call); loopPartPerf[part].add(micros() - partStart); } while (0)
+
 void WLED::loop()
 {
   #ifdef WLED_DEBUG
   static unsigned long maxUsermodMillis = 0;
   #endif
+  watchdogLoop();
+
+  if (bootPhase < BOOT_PHASE_DONE) { //keep the LEDs running while the rest is brought up
+    handleBootPhase();
+    handleTransitions();
+    #ifndef WLED_RENDER_TASK
+    if (!offMode || strip.isOffRefreshRequred) strip.service();
+    #endif
+    yield();
+    return;
+  }
+
+  unsigned long loopStart = micros();
+  lastYieldMicros = loopStart;
 
   handleTime();
-  handleIR();        // 2nd call to function needed for ESP32 to return valid results -- should be good for ESP8266, too
-  handleConnection();
+  LOOP_TIMED(LOOP_PERF_IR, handleIR()); // 2nd call to function needed for ESP32 to return valid results -- should be good for ESP8266, too
+  LOOP_STAGE(WDT_STAGE_WIFI, handleConnection());
   handleSerial();
-  handleNotifications();
+  LOOP_TIMED(LOOP_PERF_UDP, handleNotifications());
+  handleEspNow();
   handleTransitions();
 #ifdef WLED_ENABLE_DMX
   handleDMX();
 #endif
+  {
+  RENDER_LOCK(); //usermods may change strip state
   userLoop();
 
   #ifdef WLED_DEBUG
   unsigned long usermodMillis = millis();
   #endif
-  usermods.loop();
+  LOOP_TIMED(LOOP_PERF_USERMODS, usermods.loop());
   #ifdef WLED_DEBUG
   usermodMillis = millis() - usermodMillis;
   if (usermodMillis > maxUsermodMillis) maxUsermodMillis = usermodMillis;
   #endif
+  }
 
-  yield();
+  loopYield();
   handleIO();
-  handleIR();
+  LOOP_TIMED(LOOP_PERF_IR, handleIR());
   handleAlexa();
 
-  yield();
+  loopYield();
 
   if (doReboot)
     reset();
   if (doCloseFile) {
     closeFile();
-    yield();
+    loopYield();
   }
+  LOOP_STAGE(WDT_STAGE_PRESETS, handlePresetQueue()); //also during realtime mode
+  handleFseq();
+  handleRecorder();
+  if (realtimeMode == REALTIME_MODE_FSEQ) handlePlaylist(); //a playlist goes on while its show entry plays
 
-  if (!realtimeMode || realtimeOverride)  // block stuff if WARLS/Adalight is enabled
+  if (!realtimeExclusive())  // block stuff if WARLS/Adalight is enabled, unless it only drives live segments
   {
     if (apActive)
       dnsServer.processNextRequest();
@@ -168,23 +365,35 @@ void WLED::loop()
 #endif
     handleNightlight();
     handlePlaylist();
-    yield();
+    handlePresetCompaction();
+    handleFsBenchmark();
+    handleJsonBenchmark();
+    handleBusBenchmark();
+    loopYield();
 
-    handleHue();
+    LOOP_TIMED(LOOP_PERF_HUE, handleHue());
 #ifndef WLED_DISABLE_BLYNK
     handleBlynk();
 #endif
 
-    yield();
+    loopYield();
 
+#ifndef WLED_RENDER_TASK
     if (!offMode || strip.isOffRefreshRequred)
-      strip.service();
+      LOOP_TIMED(LOOP_PERF_SERVICE, strip.service());
+#endif
 #ifdef ESP8266
     else if (!noWifiSleep)
       delay(1); //required to make sure ESP enters modem sleep (see #1184)
 #endif
   }
-  yield();
+  {
+    RENDER_LOCK();
+    LOOP_STAGE(WDT_STAGE_SEND, busses.handleNetworkSend()); //the rest of the queued network bus frames, a few packets per pass
+  }
+  LOOP_STAGE(WDT_STAGE_OTA, handleOTAWrite()); //right after the frame, so the flash write stalls fall between frames
+  handleFleetOTA();
+  loopYield();
 #ifdef ESP8266
   MDNS.update();
 #endif
@@ -196,39 +405,53 @@ void WLED::loop()
   }
   if (millis() - lastMqttReconnectAttempt > 30000) {
     lastMqttReconnectAttempt = millis();
+    WATCHDOG_STAGE(WDT_STAGE_MQTT);
     initMqtt();
-    yield();
+    publishMqttPerf();
+    loopYield();
     // refresh WLED nodes list
     refreshNodeList();
     if (nodeBroadcastEnabled) sendSysInfoUDP();
-    yield();
+    WATCHDOG_STAGE(WDT_STAGE_LOOP);
+    loopYield();
+  }
+
+  //saved on the pass after a bus re-init, so the flash write does not add to that frame
+  if (doSerializeConfig) {
+    doSerializeConfig = false;
+    LOOP_STAGE(WDT_STAGE_CONFIG, serializeConfig());
   }
 
   //LED settings have been saved, re-init busses
-  //This code block causes severe FPS drop on ESP32 with the original "if (busConfigs[0] != nullptr)" conditional. Investigate! 
+  //only busses whose config changed are recreated, the others keep running
   if (doInitBusses) {
+    RENDER_LOCK();
+    WATCHDOG_STAGE(WDT_STAGE_BUSSES);
     doInitBusses = false;
     DEBUG_PRINTLN(F("Re-init busses."));
     bool aligned = strip.checkSegmentAlignment(); //see if old segments match old bus(ses)
-    busses.removeAll();
+    BusConfig* configs[WLED_MAX_BUSSES];
+    uint8_t count = 0;
     uint32_t mem = 0;
     for (uint8_t i = 0; i < WLED_MAX_BUSSES; i++) {
       if (busConfigs[i] == nullptr) break;
       mem += BusManager::memUsage(*busConfigs[i]);
-      if (mem <= MAX_LED_MEMORY) {
-        busses.add(*busConfigs[i]);
-      }
+      if (mem <= MAX_LED_MEMORY) configs[count++] = busConfigs[i];
+    }
+    if (busses.reconfigure(configs, count) || !busses.getNumBusses()) {
+      strip.finalizeInit(true);
+      if (aligned) strip.makeAutoSegments();
+      else strip.fixInvalidSegments();
+    }
+    for (uint8_t i = 0; i < WLED_MAX_BUSSES; i++) {
       delete busConfigs[i]; busConfigs[i] = nullptr;
     }
-    strip.finalizeInit();
-    if (aligned) strip.makeAutoSegments();
-    else strip.fixInvalidSegments();
-    yield();
-    serializeConfig();
+    doSerializeConfig = true;
+    WATCHDOG_STAGE(WDT_STAGE_LOOP);
   }
 
-  yield();
-  handleWs();
+  loopYield();
+  LOOP_TIMED(LOOP_PERF_WS, handleWs());
   handleStatusLED();
 
 // DEBUG serial logging (every 30s)
@@ -262,7 +485,15 @@ void WLED::loop()
   }
   loops++;
 #endif        // WLED_DEBUG
+
+  loopYieldGap();
+  uint32_t loopTime = micros() - loopStart;
+  loopPerf.add(loopTime);
+  uint8_t bin = 0;
+  for (uint32_t ms = loopTime >> 10; ms && bin < LOOP_HIST_BINS -1; ms >>= 1) bin++;
+  loopHist[bin]++;
   toki.resetTick();
+  handlePowerSave(); //after the timing, the idle sleep is not loop time
 }
 
 void WLED::setup()
@@ -271,6 +502,7 @@ void WLED::setup()
   WRITE_PERI_REG(RTC_CNTL_BROWN_OUT_REG, 0); //disable brownout detection
   #endif
 
+  Serial.setRxBufferSize(WLED_SERIAL_RX_BUFFER); //must precede begin() on ESP32
   Serial.begin(115200);
   Serial.setTimeout(50);
   DEBUG_PRINTLN();
@@ -295,6 +527,8 @@ void WLED::setup()
     managed_pin_type pins[2] = { {16, true}, {17, true} };
     pinManager.allocateMultiplePins(pins, 2, PinOwner::SPI_RAM);
   }
+  jsonArena = new PSRAMDynamicJsonDocument(JSON_BUFFER_SIZE);
+  if (jsonArena && !jsonArena->capacity()) { delete jsonArena; jsonArena = nullptr; } //JsonArenaDoc falls back to heap documents
   #endif
 
   //DEBUG_PRINT(F("LEDs inited. heap usage ~"));
@@ -312,18 +546,21 @@ void WLED::setup()
 
   for (uint8_t i=1; i<WLED_MAX_BUTTONS; i++) btnPin[i] = -1;
 
-  bool fsinit = false;
   DEBUGFS_PRINTLN(F("Mount FS"));
 #ifdef ARDUINO_ARCH_ESP32
-  fsinit = WLED_FS.begin(true);
+  fsMounted = WLED_FS.begin(true);
 #else
-  fsinit = WLED_FS.begin();
+  fsMounted = WLED_FS.begin();
 #endif
-  if (!fsinit) {
+  if (!fsMounted) {
     DEBUGFS_PRINTLN(F("FS failed!"));
     errorFlag = ERR_FS_BEGIN;
-  } else deEEP();
-  updateFSInfo();
+  } else {
+    restorePresetCompaction(); //the boot preset may be in an interrupted compaction
+    restoreFsBenchmark();
+    deEEP();
+  }
+  initSD();
 
   DEBUG_PRINTLN(F("Reading config"));
   deserializeConfigFromFS();
@@ -338,11 +575,51 @@ void WLED::setup()
 
   DEBUG_PRINTLN(F("Initializing strip"));
   beginStrip();
+  strip.service();
+  bootFirstFrame = millis();
+  bootPhaseMillis[BOOT_PHASE_FAST] = bootFirstFrame;
+  bootPhase = BOOT_PHASE_FS;
 
-  DEBUG_PRINTLN(F("Usermods setup"));
-  userSetup();
-  usermods.setup();
+  #if defined(ARDUINO_ARCH_ESP32) && defined(WLED_DISABLE_BROWNOUT_DET)
+  WRITE_PERI_REG(RTC_CNTL_BROWN_OUT_REG, 1); //enable brownout detector
+  #endif
+
+  initWatchdog(); //the rest of the boot runs in loop()
 
+  #ifdef WLED_RENDER_TASK
+  renderMutex = xSemaphoreCreateRecursiveMutex();
+  xTaskCreatePinnedToCore(renderTask, "render", 6144, nullptr, 1, nullptr, 1 - xPortGetCoreID());
+  #endif
+}
+
+//brings up everything not needed to show the boot preset, one phase per call from loop()
+void WLED::handleBootPhase()
+{
+  unsigned long start = millis();
+  switch (bootPhase) {
+    case BOOT_PHASE_FS:
+      #ifdef WLED_ENABLE_BINARY_PRESETS
+      if (fsMounted) convertPresetsToBinary();
+      #endif
+      updateFSInfo();
+      break;
+    case BOOT_PHASE_USERMODS: {
+      RENDER_LOCK();
+      DEBUG_PRINTLN(F("Usermods setup"));
+      userSetup();
+      usermods.setup();
+      } break;
+    case BOOT_PHASE_NETWORK:
+      initNetworkPhase();
+      break;
+  }
+  bootPhaseMillis[bootPhase] = millis() - start;
+  DEBUG_PRINT(F("Boot phase ")); DEBUG_PRINT(bootPhase); DEBUG_PRINT(F(" took ")); DEBUG_PRINTLN(bootPhaseMillis[bootPhase]);
+  bootPhase++;
+}
+
+void WLED::initNetworkPhase()
+{
   if (strcmp(clientSSID, DEFAULT_CLIENT_SSID) == 0)
     showWelcomePage = true;
   WiFi.persistent(false);
@@ -374,8 +651,6 @@ void WLED::setup()
     sprintf(mqttClientID + 5, "%*s", 6, escapedMac.c_str() + 6);
   }
 
-  strip.service();
-
 #ifndef WLED_DISABLE_OTA
   if (aOtaEnabled) {
     ArduinoOTA.onStart([]() {
@@ -383,6 +658,17 @@ void WLED::setup()
       wifi_set_sleep_type(NONE_SLEEP_T);
 #endif
       DEBUG_PRINTLN(F("Start ArduinoOTA"));
+      flushPresetQueue();
+      otaThrottleFps(true);
+    });
+    //handle() receives the whole image before it returns, keep the LEDs running between chunks
+    ArduinoOTA.onProgress([](unsigned int progress, unsigned int total) {
+      #ifndef WLED_RENDER_TASK
+      if (!offMode || strip.isOffRefreshRequred) strip.service();
+      #endif
+    });
+    ArduinoOTA.onError([](ota_error_t error) {
+      otaThrottleFps(false);
     });
     if (strlen(cmDNS) > 0)
       ArduinoOTA.setHostname(cmDNS);
@@ -393,16 +679,31 @@ void WLED::setup()
 #endif
   // HTTP server page init
   initServer();
+}
 
-  #if defined(ARDUINO_ARCH_ESP32) && defined(WLED_DISABLE_BROWNOUT_DET)
-  WRITE_PERI_REG(RTC_CNTL_BROWN_OUT_REG, 1); //enable brownout detector
-  #endif
+#ifdef WLED_RENDER_TASK
+//renders effects on the core loop() is not running on
+void WLED::renderTask(void* parameter)
+{
+  for (;;) {
+    watchdogRenderBeat();
+    if (!realtimeExclusive() && (!offMode || strip.isOffRefreshRequred)) {
+      //skip this round instead of waiting if state is just being changed
+      if (xSemaphoreTakeRecursive(renderMutex, 0) == pdTRUE) {
+        strip.service();
+        xSemaphoreGiveRecursive(renderMutex);
+      }
+    }
+    vTaskDelay(1); //lets the idle task of this core feed the watchdog
+  }
 }
+#endif
 
 void WLED::beginStrip()
 {
   // Initialize NeoPixel Strip and button
   strip.finalizeInit(); // busses created during deserializeConfig()
+  strip.loadCustomPalettes();
   strip.makeAutoSegments();
   strip.setBrightness(0);
   strip.setShowCallback(handleOverlayDraw);
@@ -423,10 +724,26 @@ void WLED::beginStrip()
     digitalWrite(rlyPin, (rlyMde ? bri : !bri));
 }
 
+#if defined(ARDUINO_ARCH_ESP32) && defined(WLED_USE_ETHERNET)
+static bool successfullyConfiguredEthernet = false;
+#endif
+
+//Ethernet only mode keeps the radio off, unless the wire was not connected since boot for WLED_ETH_ONLY_FALLBACK ms
+static bool wifiDisabled()
+{
+#if defined(ARDUINO_ARCH_ESP32) && defined(WLED_USE_ETHERNET)
+  return ethernetOnly && successfullyConfiguredEthernet && (ethernetLinkSeen || millis() < WLED_ETH_ONLY_FALLBACK);
+#else
+  return false;
+#endif
+}
+
 void WLED::initAP(bool resetAP)
 {
   if (apBehavior == AP_BEHAVIOR_BUTTON_ONLY && !resetAP)
     return;
+  if (wifiDisabled() && !resetAP)
+    return;
 
   if (!apSSID[0] || resetAP)
     strcpy_P(apSSID, PSTR("WLED-AP"));
@@ -463,8 +780,6 @@ bool WLED::initEthernet()
 {
 #if defined(ARDUINO_ARCH_ESP32) && defined(WLED_USE_ETHERNET)
 
-  static bool successfullyConfiguredEthernet = false;
-
   if (successfullyConfiguredEthernet) {
     // DEBUG_PRINTLN(F("initE: ETH already successfully configured, ignoring"));
     return false;
@@ -556,6 +871,13 @@ void WLED::initConnection()
   WiFi.setPhyMode(WIFI_PHY_MODE_11N);
 #endif
 
+  if (wifiDisabled()) {
+    lastReconnectAttempt = millis();
+    if (apActive) return;       // opened by button, keep it
+    WiFi.mode(WIFI_OFF);        // UDP and HTTP only have the wired interface now
+    return;
+  }
+
   if (staticIP[0] != 0 && staticGateway[0] != 0) {
     WiFi.config(staticIP, staticGateway, staticSubnet, IPAddress(1, 1, 1, 1));
   } else {
@@ -592,7 +914,11 @@ void WLED::initConnection()
   WiFi.hostname(hostname);
 #endif
 
-  WiFi.begin(clientSSID, clientPass);
+  //the AP of the last connection is tried first without scanning, a static IP also skips DHCP
+  wifiFastConnect = !wifiScanNext && wifiCacheValid();
+  wifiScanNext = false;
+  if (wifiFastConnect) WiFi.begin(clientSSID, clientPass, wifiCache.channel, wifiCache.bssid);
+  else                 WiFi.begin(clientSSID, clientPass);
 
 #ifdef ARDUINO_ARCH_ESP32
   WiFi.setSleep(!noWifiSleep);
@@ -624,7 +950,10 @@ void WLED::initInterfaces()
     ArduinoOTA.begin();
 #endif
 
-  strip.service();
+  {
+    RENDER_LOCK();
+    strip.service();
+  }
 
   // Set up mDNS responder:
   if (strlen(cmDNS) > 0) {
@@ -641,11 +970,11 @@ void WLED::initInterfaces()
   server.begin();
 
   if (udpPort > 0 && udpPort != ntpLocalPort) {
-    udpConnected = notifierUdp.begin(udpPort);
+    udpConnected = beginSyncUdp(notifierUdp, udpPort);
     if (udpConnected && udpRgbPort != udpPort)
       udpRgbConnected = rgbUdp.begin(udpRgbPort);
     if (udpConnected && udpPort2 != udpPort && udpPort2 != udpRgbPort)
-      udp2Connected = notifier2Udp.begin(udpPort2);
+      udp2Connected = beginSyncUdp(notifier2Udp, udpPort2);
   }
   if (ntpEnabled)
     ntpConnected = ntpUdp.begin(ntpLocalPort);
@@ -720,6 +1049,11 @@ void WLED::handleConnection()
       interfacesInited = false;
       initConnection();
     }
+    if (wifiFastConnect && now - lastReconnectAttempt > WLED_FAST_CONNECT_TIMEOUT && WLED_WIFI_CONFIGURED) {
+      DEBUG_PRINTLN(F("Cached AP not found, scanning."));
+      wifiScanNext = true; //AP moved to another channel or a different AP is closer
+      initConnection();
+    }
     if (now - lastReconnectAttempt > ((stac) ? 300000 : 20000) && WLED_WIFI_CONFIGURED)
       initConnection();
     if (!apActive && now - lastReconnectAttempt > 12000 && (!wasConnected || apBehavior == AP_BEHAVIOR_NO_CONN))
@@ -728,9 +1062,12 @@ void WLED::handleConnection()
     DEBUG_PRINTLN("");
     DEBUG_PRINT(F("Connected! IP address: "));
     DEBUG_PRINTLN(Network.localIP());
+    wifiFastConnect = false;
+    if (WiFi.isConnected()) storeWiFiCache(); //not for Ethernet
     initInterfaces();
     userConnected();
     usermods.connected();
+    usermods.publish(UM_EVENT_CONNECTED);
 
     // shut down AP
     if (apBehavior != AP_BEHAVIOR_ALWAYS && apActive) {
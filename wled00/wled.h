@@ -27,12 +27,25 @@
 //#define WLED_DISABLE_BLYNK       // saves 6kb
 //#define WLED_DISABLE_CRONIXIE    // saves 3kb
 //#define WLED_DISABLE_HUESYNC     // saves 4kb
+//#define WLED_DISABLE_BINARY_CONFIG // boot from cfg.json only, without the MessagePack copy in cfg.bin
 //#define WLED_DISABLE_INFRARED    // there is no pin left for this on ESP8266-01, saves 12kb
+//#define WLED_USE_IR_RMT          // ESP32: decode NEC remotes from RMT captures instead of an interrupt per edge, takes the last RMT channel on ESP32/S2
 #ifndef WLED_DISABLE_MQTT
   #define WLED_ENABLE_MQTT         // saves 12kb
 #endif
 #define WLED_ENABLE_ADALIGHT       // saves 500b only
 //#define WLED_ENABLE_DMX          // uses 3.5kb (use LEDPIN other than 2)
+//#define WLED_ENABLE_FLEET_OTA    // ESP32: update the nodes of the instance list from this one, see fleet_ota.cpp
+//#define WLED_ENABLE_FSBENCH      // time preset recall/save against a synthetic preset file, {"fsbench":n}, see fsbench.cpp
+//#define WLED_ENABLE_BUSBENCH     // time show() and the transfer of each bus with its driver, {"busbench":n}, see busbench.cpp
+//#define WLED_ENABLE_JSONBENCH    // time the JSON state API with representative payloads, {"jsonbench":n}, see jsonbench.cpp
+//#define WLED_ENABLE_FSEQ         // play xLights .fseq sequences from the filesystem, see fseq.cpp
+//#define WLED_ENABLE_RECORDER     // record received realtime frames for replay with the sequence player, see recorder.cpp
+//#define WLED_ENABLE_POWERSAVE    // lower the CPU clock and sleep between loops while nothing is rendered, see power.cpp
+//#define WLED_ENABLE_TRACE        // record a timeline of the frame pipeline, served as Chrome trace JSON at /trace, see trace.cpp
+//#define WLED_ENABLE_ESPNOW       // notifications and remote commands over ESP-NOW besides UDP, see espnow.cpp
+//#define WLED_ENABLE_WATCHDOG     // record loop and render task stalls with the stage they are in, kept over a reset, see watchdog.cpp
+//#define WLED_ENABLE_SD           // ESP32: SD card for large media below /sd/ (SPI, or SD_MMC with WLED_USE_SD_MMC)
 #ifndef WLED_DISABLE_LOXONE
   #define WLED_ENABLE_LOXONE       // uses 1.2kb
 #endif
@@ -41,6 +54,7 @@
 #endif
 
 #define WLED_ENABLE_FS_EDITOR      // enable /edit page for editing FS content. Will also be disabled with OTA lock
+//#define WLED_ENABLE_BINARY_PRESETS // store plain state presets as fixed size records in presets.bin, uses 4kb
 
 // to toggle usb serial debug (un)comment the following line
 //#define WLED_DEBUG
@@ -52,6 +66,9 @@
 //This is generally a terrible idea, but improves boot success on boards with a 3.3v regulator + cap setup that can't provide 400mA peaks
 //#define WLED_DISABLE_BROWNOUT_DET
 
+//ESP32 only: run the effect engine in its own task on the core not used by loop()
+//#define WLED_ENABLE_RENDER_TASK
+
 // Library inclusions.
 #include <Arduino.h>
 #ifdef ESP8266
@@ -125,8 +142,8 @@
 #if defined(ARDUINO_ARCH_ESP32) && defined(WLED_USE_PSRAM)
 struct PSRAM_Allocator {
   void* allocate(size_t size) {
-    if (psramFound()) return ps_malloc(size); // use PSRAM if it exists
-    else              return malloc(size);    // fallback
+    void* p = psramFound() ? ps_malloc(size) : nullptr; // use PSRAM if it exists
+    return p ? p : malloc(size);                         // fallback
   }
   void deallocate(void* pointer) {
     free(pointer);
@@ -141,6 +158,8 @@ using PSRAMDynamicJsonDocument = BasicJsonDocument<PSRAM_Allocator>;
 #include "html_ui.h"
 #include "html_settings.h"
 #include "html_other.h"
+#include "html_palettes.h"
+#include "html_uimod.h"
 #include "FX.h"
 #include "ir_codes.h"
 #include "const.h"
@@ -175,6 +194,20 @@ using PSRAMDynamicJsonDocument = BasicJsonDocument<PSRAM_Allocator>;
   #define WLED_FS LITTLEFS
 #endif
 
+//SD card for files too large for the flash filesystem, paths starting with /sd/ are on the card
+#if defined(WLED_ENABLE_SD) && defined(ARDUINO_ARCH_ESP32)
+  #ifdef WLED_USE_SD_MMC
+    #include <SD_MMC.h>
+    #define WLED_SD SD_MMC
+  #else
+    #include <SPI.h>
+    #include <SD.h>
+    #define WLED_SD SD
+  #endif
+#else
+  #undef WLED_ENABLE_SD
+#endif
+
 // GLOBAL VARIABLES
 // both declared and defined in header (solution from http://www.keil.com/support/docs/1868.htm)
 //
@@ -259,6 +292,11 @@ WLED_GLOBAL bool noWifiSleep _INIT(false);
   #else
     WLED_GLOBAL int ethernetType _INIT(WLED_ETH_NONE);             // use none for ethernet board type if default not defined
   #endif
+  #ifdef WLED_ETH_ONLY
+    WLED_GLOBAL bool ethernetOnly _INIT(true);
+  #else
+    WLED_GLOBAL bool ethernetOnly _INIT(false);                    // keep the WiFi radio off while Ethernet is configured
+  #endif
 #endif
 
 // LED CONFIG
@@ -290,6 +328,7 @@ WLED_GLOBAL bool syncToggleReceive     _INIT(false);   // UIs which only have a
 WLED_GLOBAL NodesMap Nodes;
 WLED_GLOBAL bool nodeListEnabled _INIT(true);
 WLED_GLOBAL bool nodeBroadcastEnabled _INIT(true);
+WLED_GLOBAL bool vstripFollow _INIT(false);                       // announce this node as taking a slice of a virtual strip leader
 
 WLED_GLOBAL byte buttonType[WLED_MAX_BUTTONS]  _INIT({BTN_TYPE_PUSH});
 WLED_GLOBAL byte irEnabled      _INIT(0);     // Infrared receiver
@@ -309,6 +348,15 @@ WLED_GLOBAL bool notifyAlexa  _INIT(false);                       // send notifi
 WLED_GLOBAL bool notifyMacro  _INIT(false);                       // send notification for macro
 WLED_GLOBAL bool notifyHue    _INIT(true);                        // send notification if Hue light changes
 WLED_GLOBAL bool notifyTwice  _INIT(false);                       // notifications use UDP: enable if devices don't sync reliably
+WLED_GLOBAL bool syncPresetIds _INIT(false);                      // send only the id of an applied preset to nodes with the same presets
+WLED_GLOBAL uint16_t notifyMinInterval _INIT(50);                  // ms between notifications, faster changes are coalesced into the latest state
+WLED_GLOBAL bool sendAudioSync _INIT(false);                      // broadcast the local sound analysis for nodes without a microphone
+WLED_GLOBAL bool receiveAudioSync _INIT(false);                   // use the sound analysis of other nodes if there is no local one
+#ifdef WLED_ENABLE_ESPNOW
+WLED_GLOBAL bool enableESPNow _INIT(false);                        // also send and receive notifications over ESP-NOW
+WLED_GLOBAL char linkedRemote[13] _INIT("");                       // MAC of the ESP-NOW remote whose commands are taken, 12 hex digits
+#endif
+WLED_GLOBAL bool syncMulticast _INIT(false);                      // send notifications and node info to WLED_SYNC_MULTICAST_IP instead of broadcasting
 
 WLED_GLOBAL bool alexaEnabled _INIT(false);                       // enable device discovery by Amazon Echo
 WLED_GLOBAL char alexaInvocationName[33] _INIT("Light");          // speech control name of device. Choose something voice-to-text can understand
@@ -321,6 +369,7 @@ WLED_GLOBAL uint16_t blynkPort _INIT(80);                         // Default Bly
 
 WLED_GLOBAL uint16_t realtimeTimeoutMs _INIT(2500);               // ms timeout of realtime mode before returning to normal mode
 WLED_GLOBAL int arlsOffset _INIT(0);                              // realtime LED offset
+WLED_GLOBAL uint16_t serialBaud _INIT(1152);                       // Adalight, TPM2 and serial JSON baud rate in units of 100 (115200)
 WLED_GLOBAL bool receiveDirect _INIT(true);                       // receive UDP realtime
 WLED_GLOBAL bool arlsDisableGammaCorrection _INIT(true);          // activate if gamma correction is handled by the source
 WLED_GLOBAL bool arlsForceMaxBri _INIT(false);                    // enable to force max brightness if source has very dark colors that would be black
@@ -334,9 +383,19 @@ WLED_GLOBAL uint16_t e131Port _INIT(5568);                        // DMX in port
 WLED_GLOBAL byte DMXMode _INIT(DMX_MODE_MULTIPLE_RGB);            // DMX mode (s.a.)
 WLED_GLOBAL uint16_t DMXAddress _INIT(1);                         // DMX start address of fixture, a.k.a. first Channel [for E1.31 (sACN) protocol]
 WLED_GLOBAL byte DMXOldDimmer _INIT(0);                           // only update brightness on change
+WLED_GLOBAL byte e131MergeMode _INIT(E131_MERGE_OFF);              // E131_MERGE_*, how several senders of a universe are combined
+WLED_GLOBAL bool e131RoutesDirty _INIT(true);                     // DMX settings changed, compile the routing table with the next packet
 WLED_GLOBAL byte e131LastSequenceNumber[E131_MAX_UNIVERSE_COUNT]; // to detect packet loss
 WLED_GLOBAL bool e131Multicast _INIT(false);                      // multicast or unicast
 WLED_GLOBAL bool e131SkipOutOfSequence _INIT(false);              // freeze instead of flickering
+WLED_GLOBAL uint16_t e131OutUniverse _INIT(1);                    // first universe sent by E1.31/ArtNet network busses
+WLED_GLOBAL uint16_t e131OutAddress _INIT(1);                     // DMX start address of the first pixel in e131OutUniverse
+WLED_GLOBAL bool artnetOutSync _INIT(false);                      // send ArtSync after each ArtNet frame
+WLED_GLOBAL uint32_t udpOutPackets _INIT(0);                      // realtime packets sent by network busses
+WLED_GLOBAL uint32_t udpOutErrors _INIT(0);                       // realtime packets that failed to send
+WLED_GLOBAL uint16_t udpOutPacketsPerSec _INIT(0);
+WLED_GLOBAL uint32_t udpInLost _INIT(0);                          // realtime packets missing from the received sequence numbers
+WLED_GLOBAL uint32_t udpInSkipped _INIT(0);                       // realtime frames drained from the queue but superseded before being shown
 
 WLED_GLOBAL bool mqttEnabled _INIT(false);
 WLED_GLOBAL char mqttDeviceTopic[33] _INIT("");            // main MQTT topic (individual per device, default is wled/mac)
@@ -346,9 +405,11 @@ WLED_GLOBAL char mqttUser[41] _INIT("");                   // optional: username
 WLED_GLOBAL char mqttPass[65] _INIT("");                   // optional: password for MQTT auth
 WLED_GLOBAL char mqttClientID[41] _INIT("");               // override the client ID
 WLED_GLOBAL uint16_t mqttPort _INIT(1883);
+WLED_GLOBAL uint16_t mqttPublishInterval _INIT(WLED_MQTT_PUBLISH_INTERVAL); // ms, state changes are published at most this often
 
 #ifndef WLED_DISABLE_HUESYNC
 WLED_GLOBAL bool huePollingEnabled _INIT(false);           // poll hue bridge for light state
+WLED_GLOBAL bool hueStreamEnabled _INIT(false);            // receive HueStream (Entertainment) packets for the light on HUE_STREAM_PORT
 WLED_GLOBAL uint16_t huePollIntervalMs _INIT(2500);        // low values (< 1sec) may cause lag but offer quicker response
 WLED_GLOBAL char hueApiKey[47] _INIT("api");               // key token will be obtained from bridge
 WLED_GLOBAL byte huePollLightId _INIT(1);                  // ID of hue lamp to sync to. Find the ID in the hue app ("about" section)
@@ -403,6 +464,8 @@ WLED_GLOBAL uint16_t userVar0 _INIT(0), userVar1 _INIT(0); //available for use i
   WLED_GLOBAL uint16_t DMXGap _INIT(10);          // gap between the fixtures. makes addressing easier because you don't have to memorize odd numbers when climbing up onto a rig.
   WLED_GLOBAL uint16_t DMXStart _INIT(10);        // start address of the first fixture
   WLED_GLOBAL uint16_t DMXStartLED _INIT(0);      // LED from which DMX fixtures start
+  WLED_GLOBAL byte DMXFps _INIT(0);                // frames per second sent at most, 0 = every strip frame
+  WLED_GLOBAL bool doBuildDMXMap _INIT(true);      // fixture settings changed, rebuild the channel map in loop()
 #endif
 
 // internal global variable declarations
@@ -424,7 +487,7 @@ WLED_GLOBAL bool transitionActive _INIT(false);
 WLED_GLOBAL uint16_t transitionDelayDefault _INIT(transitionDelay);
 WLED_GLOBAL uint16_t transitionDelayTemp _INIT(transitionDelay);
 WLED_GLOBAL unsigned long transitionStartTime;
-WLED_GLOBAL float tperLast _INIT(0);        // crossfade transition progress, 0.0f - 1.0f
+WLED_GLOBAL unsigned long transitionLastStep _INIT(0); // when the global brightness transition was last stepped
 WLED_GLOBAL bool jsonTransitionOnce _INIT(false);
 
 // nightlight
@@ -433,6 +496,7 @@ WLED_GLOBAL bool nightlightActiveOld _INIT(false);
 WLED_GLOBAL uint32_t nightlightDelayMs _INIT(10);
 WLED_GLOBAL byte nightlightDelayMinsDefault _INIT(nightlightDelayMins);
 WLED_GLOBAL unsigned long nightlightStartTime;
+WLED_GLOBAL unsigned long nightlightLastStep _INIT(0);
 WLED_GLOBAL byte briNlT _INIT(0);                     // current nightlight brightness
 WLED_GLOBAL byte colNlT[] _INIT_N(({ 0, 0, 0, 0 }));        // current nightlight color
 
@@ -488,15 +552,11 @@ WLED_GLOBAL bool hueStoreAllowed _INIT(false), hueNewKey _INIT(false);
 // overlays
 WLED_GLOBAL byte overlayCurrent _INIT(overlayDefault);
 
-// cronixie
-WLED_GLOBAL byte dP[] _INIT_N(({ 255, 255, 255, 255, 255, 255 }));
-
 // countdown
 WLED_GLOBAL unsigned long countdownTime _INIT(1514764800L);
 WLED_GLOBAL bool countdownOverTriggered _INIT(true);
 
 // timer
-WLED_GLOBAL byte lastTimerMinute _INIT(0);
 WLED_GLOBAL byte timerHours[] _INIT_N(({ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }));
 WLED_GLOBAL int8_t timerMinutes[] _INIT_N(({ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }));
 WLED_GLOBAL byte timerMacro[] _INIT_N(({ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }));
@@ -519,11 +579,23 @@ WLED_GLOBAL IPAddress realtimeIP _INIT_N(((0, 0, 0, 0)));;
 WLED_GLOBAL unsigned long realtimeTimeout _INIT(0);
 WLED_GLOBAL uint8_t tpmPacketCount _INIT(0);
 WLED_GLOBAL uint16_t tpmPayloadFrameSize _INIT(0);
+WLED_GLOBAL WS2812FX::PerfStat realtimePerf[REALTIME_MODE_DDP +1];   // parse time of each realtime protocol per packet in us, see realtimePerfAdd()
+WLED_GLOBAL unsigned long realtimePerfSince[REALTIME_MODE_DDP +1];  // millis of the first timed packet, for packets per second
+WLED_GLOBAL uint32_t realtimePacketRx _INIT(0);                       // micros the packet being parsed was received, 0 if not from the network
+WLED_GLOBAL WS2812FX::PerfStat realtimeLatency[LATENCY_STAGES];       // frame latency per stage in us, reset with {"lat":true}
+WLED_GLOBAL uint32_t realtimeLatencyHist[LOOP_HIST_BINS];             // total frame latency histogram, bin n counts frames below 2^n ms
+
+// loop profiling, see WLED::loop()
+WLED_GLOBAL WS2812FX::PerfStat loopPerf;                          // loop iteration time in us
+WLED_GLOBAL WS2812FX::PerfStat loopPartPerf[LOOP_PERF_COUNT];     // time per call of the main subsystems in us
+WLED_GLOBAL uint32_t loopHist[LOOP_HIST_BINS];                    // loop iteration time histogram
+WLED_GLOBAL uint32_t loopYieldGapMax _INIT(0);                    // longest stretch in us the loop ran without yielding
 
 // mqtt
 WLED_GLOBAL unsigned long lastMqttReconnectAttempt _INIT(0);
 WLED_GLOBAL unsigned long lastInterfaceUpdate _INIT(0);
 WLED_GLOBAL byte interfaceUpdateCallMode _INIT(CALL_MODE_INIT);
+WLED_GLOBAL uint32_t stateVersion _INIT(1);     // bumped by every state change, invalidates the serialized state
 WLED_GLOBAL char mqttStatusTopic[40] _INIT("");        // this must be global because of async handlers
 
 // alexa udp
@@ -553,19 +625,44 @@ WLED_GLOBAL Toki toki _INIT(Toki());
 // Temp buffer
 WLED_GLOBAL char* obuf;
 WLED_GLOBAL uint16_t olen _INIT(0);
+WLED_GLOBAL uint16_t omax _INIT(0);   // >0: obuf holds up to this many bytes of a streamed response, not terminated
 
 // General filesystem
 WLED_GLOBAL size_t fsBytesUsed _INIT(0);
+WLED_GLOBAL uint32_t fsBytesScanned _INIT(0); // bytes read by the buffered searches of file.cpp
 WLED_GLOBAL size_t fsBytesTotal _INIT(0);
 WLED_GLOBAL unsigned long presetsModifiedTime _INIT(0L);
+WLED_GLOBAL byte fileUploadCount _INIT(0);   // incremented by every upload, lets usermods drop cached file contents
 WLED_GLOBAL JsonDocument* fileDoc;
+
+// shared JSON arena, borrowed through JsonArenaDoc
+#if defined(ARDUINO_ARCH_ESP32) && defined(WLED_USE_PSRAM)
+WLED_GLOBAL PSRAMDynamicJsonDocument* jsonArena _INIT(nullptr); // allocated in setup(), in PSRAM if found
+#else
+WLED_GLOBAL StaticJsonDocument<JSON_BUFFER_SIZE> jsonArenaBuf;
+WLED_GLOBAL JsonDocument* jsonArena _INIT(&jsonArenaBuf);
+#endif
+WLED_GLOBAL volatile uint8_t jsonArenaOwner _INIT(0); // JSON_LOCK_* of the current user, 0 = free
+WLED_GLOBAL uint32_t jsonArenaWaits _INIT(0);         // arena was in use, a heap document was allocated instead
+WLED_GLOBAL uint32_t jsonArenaFails _INIT(0);         // no document could be provided at all
+WLED_GLOBAL uint32_t wsBufferFails _INIT(0);          // websocket message buffers that could not be allocated
+WLED_GLOBAL uint32_t responseFails _INIT(0);          // HTTP responses that could not be allocated
+WLED_GLOBAL uint32_t heapRejects _INIT(0);            // JSON requests turned away below WLED_HEAP_WATERMARK
 WLED_GLOBAL bool doCloseFile _INIT(false);
 
 // presets
 WLED_GLOBAL byte currentPreset _INIT(0);
+WLED_GLOBAL byte presetSyncId _INIT(0);                            // preset applyPreset() is applying right now, 0 if none
 
 WLED_GLOBAL byte errorFlag _INIT(0);
 
+// boot
+WLED_GLOBAL byte bootPhase _INIT(BOOT_PHASE_FAST);
+WLED_GLOBAL uint16_t bootPhaseMillis[BOOT_PHASE_DONE] _INIT_N(({ 0 })); // duration of each phase
+WLED_GLOBAL uint16_t bootFirstFrame _INIT(0);                         // millis() after power-up the first frame was shown
+WLED_GLOBAL bool fsMounted _INIT(false);
+WLED_GLOBAL bool sdMounted _INIT(false);
+
 WLED_GLOBAL String messageHead, messageSub;
 WLED_GLOBAL byte optionType;
 
@@ -586,12 +683,26 @@ WLED_GLOBAL WiFiUDP ntpUdp;
 WLED_GLOBAL ESPAsyncE131 e131 _INIT_N(((handleE131Packet)));
 WLED_GLOBAL ESPAsyncE131 ddp  _INIT_N(((handleE131Packet)));
 WLED_GLOBAL bool e131NewData _INIT(false);
+WLED_GLOBAL bool e131FrameComplete _INIT(false);                  // all universes of a frame arrived, show without delay
+WLED_GLOBAL uint32_t e131UniversesReceived _INIT(0);              // universes of the current frame received so far (bit n = e131Universe + n)
+WLED_GLOBAL unsigned long e131FrameStart _INIT(0);                // arrival of the first universe of the current frame
+WLED_GLOBAL uint32_t e131PartialFrames _INIT(0);                  // frames shown with universes missing
+WLED_GLOBAL uint32_t e131DroppedFrames _INIT(0);                  // frames overwritten before they were shown
+WLED_GLOBAL uint32_t e131IngestMicros _INIT(0);                   // average time to write one universe to the busses
+WLED_GLOBAL unsigned long e131LastSync _INIT(0);                  // last ArtSync / E1.31 sync packet, output waits for sync while recent
+WLED_GLOBAL uint16_t e131SyncUniverse _INIT(0);                   // E1.31 synchronization address requested by the sender
+WLED_GLOBAL bool e131SyncPending _INIT(false);                    // frame received, waiting for the sync packet to show it
+WLED_GLOBAL unsigned long e131ShowAt _INIT(0);                     // millis the pending frame is due according to its DDP timecode (0 = now)
 
 // led fx library object
 WLED_GLOBAL BusManager busses _INIT(BusManager());
 WLED_GLOBAL WS2812FX strip _INIT(WS2812FX());
 WLED_GLOBAL BusConfig* busConfigs[WLED_MAX_BUSSES] _INIT({nullptr}); //temporary, to remember values from network callback until after
 WLED_GLOBAL bool doInitBusses _INIT(false);
+WLED_GLOBAL bool doSerializeConfig _INIT(false); //save cfg.json on the next loop() pass
+#if defined(ARDUINO_ARCH_ESP32) && defined(WLED_ENABLE_RENDER_TASK)
+WLED_GLOBAL SemaphoreHandle_t renderMutex _INIT(nullptr);
+#endif
 
 // Usermod manager
 WLED_GLOBAL UsermodManager usermods _INIT(UsermodManager());
@@ -636,10 +747,75 @@ WLED_GLOBAL UsermodManager usermods _INIT(UsermodManager());
 #define WLED_WIFI_CONFIGURED (strlen(clientSSID) >= 1 && strcmp(clientSSID, DEFAULT_CLIENT_SSID) != 0)
 #define WLED_MQTT_CONNECTED (mqtt != nullptr && mqtt->connected())
 
+// with the render task, code changing strip state holds renderMutex for its scope.
+// The render task only tries to take it and skips the frame if busy, so it never waits on network code.
+#if defined(ARDUINO_ARCH_ESP32) && defined(WLED_ENABLE_RENDER_TASK)
+  #define WLED_RENDER_TASK
+  struct RenderLock {
+    RenderLock()  { if (renderMutex) xSemaphoreTakeRecursive(renderMutex, portMAX_DELAY); }
+    ~RenderLock() { if (renderMutex) xSemaphoreGiveRecursive(renderMutex); }
+  };
+  #define RENDER_LOCK() RenderLock renderLock
+#else
+  #define RENDER_LOCK()
+#endif
+
+// changes of one request are rendered in one frame and notified once when the scope ends
+struct StateUpdate {
+  StateUpdate()  { beginStateUpdate(); }
+  ~StateUpdate() { endStateUpdate(); }
+};
+#define STATE_UPDATE() StateUpdate stateUpdate
+
+// timeline events of the frame pipeline, downloadable from /trace. Compiled out unless WLED_ENABLE_TRACE is set
+#ifdef WLED_ENABLE_TRACE
+  struct TraceScope {
+    uint8_t ev; uint16_t arg;
+    TraceScope(uint8_t e, uint16_t a) : ev(e), arg(a) { traceEvent(ev, 'B', arg); }
+    ~TraceScope() { traceEvent(ev, 'E', arg); }
+  };
+  #define TRACE_BEGIN(ev, arg)   traceEvent(ev, 'B', arg)
+  #define TRACE_END(ev, arg)     traceEvent(ev, 'E', arg)
+  #define TRACE_INSTANT(ev, arg) traceEvent(ev, 'i', arg)
+  #define TRACE_SCOPE(ev, arg)   TraceScope traceScope(ev, arg)
+#else
+  #define TRACE_BEGIN(ev, arg)
+  #define TRACE_END(ev, arg)
+  #define TRACE_INSTANT(ev, arg)
+  #define TRACE_SCOPE(ev, arg)
+#endif
+
+// loop stage for the stall watchdog (WDT_STAGE_* in const.h)
+#ifdef WLED_ENABLE_WATCHDOG
+  #define WATCHDOG_STAGE(s) watchdogStage(s)
+#else
+  #define WATCHDOG_STAGE(s)
+#endif
+
+// borrows the shared JSON arena for its scope instead of allocating a JSON_BUFFER_SIZE document.
+// If the arena is in use (other task, or further up the call stack), a heap document is allocated.
+class JsonArenaDoc {
+  private:
+    JsonDocument* _doc = nullptr;
+    PSRAMDynamicJsonDocument* _heap = nullptr;
+    bool _locked = false;
+  public:
+    JsonArenaDoc(uint8_t module);
+    ~JsonArenaDoc();
+    JsonArenaDoc(const JsonArenaDoc&) = delete;
+    JsonArenaDoc& operator=(const JsonArenaDoc&) = delete;
+    explicit operator bool() const { return _doc != nullptr; }
+    JsonDocument* get() { return _doc; }
+    JsonDocument& operator*() { return *_doc; }
+    JsonDocument* operator->() { return _doc; }
+};
+
 // append new c string to temp buffer efficiently
 bool oappend(const char* txt);
 // append new number to temp buffer efficiently
 bool oappendi(int i);
+// append len chars from flash to temp buffer
+bool oappend_P(const char* txt, size_t len);
 
 class WLED {
 public:
@@ -657,11 +833,16 @@ public:
   void reset();
 
   void beginStrip();
+  void handleBootPhase();
+  void initNetworkPhase();
   void handleConnection();
   bool initEthernet(); // result is informational
   void initAP(bool resetAP = false);
   void initConnection();
   void initInterfaces();
   void handleStatusLED();
+  #ifdef WLED_RENDER_TASK
+  static void renderTask(void* parameter);
+  #endif
 };
 #endif        // WLED_H
@@ -382,7 +382,7 @@ void deEEP() {
   
   DEBUG_PRINTLN(F("Preset file not found, attempting to load from EEPROM"));
   DEBUGFS_PRINTLN(F("Allocating saving buffer for dEEP"));
-  DynamicJsonDocument dDoc(JSON_BUFFER_SIZE *2);
+  PSRAMDynamicJsonDocument dDoc(JSON_BUFFER_SIZE *2);
   JsonObject sObj = dDoc.to<JsonObject>();
   sObj.createNestedObject("0");
 
@@ -425,10 +425,11 @@ void deEEP() {
         segObj[F("ix")]  = EEPROM.read(i+16);
         segObj["pal"] = EEPROM.read(i+17);
       } else {
+        strip.getSegment((240 + sizeof(WS2812FX::Segment) -1) / sizeof(WS2812FX::Segment) -1); //segments are allocated on demand
         WS2812FX::Segment* seg = strip.getSegments();
-        memcpy(seg, EEPROM.getDataPtr() +i+2, 240);
+        memcpy(seg, EEPROM.getDataPtr() +i+2, MIN(240, strip.getSegmentCount() * sizeof(WS2812FX::Segment)));
         if (ver == 2) { //versions before 2004230 did not have opacity
-          for (byte j = 0; j < strip.getMaxSegments(); j++)
+          for (byte j = 0; j < strip.getSegmentCount(); j++)
           {
             strip.getSegment(j).opacity = 255;
             strip.getSegment(j).setOption(SEG_OPTION_ON, 1);
@@ -467,6 +468,7 @@ void deEEP() {
   }
   serializeJson(dDoc, f);
   f.close();
+  invalidatePresetIndex();
   DEBUG_PRINTLN(F("deEEP complete!"));
 }
 
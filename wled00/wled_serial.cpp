@@ -11,29 +11,84 @@ enum class AdaState {
   Header_CountHi,
   Header_CountLo,
   Header_CountCheck,
-  Data_Red,
-  Data_Green,
-  Data_Blue,
+  Data,
   TPM2_Header_Type,
   TPM2_Header_CountHi,
-  TPM2_Header_CountLo
+  TPM2_Header_CountLo,
+  TPM2_End
 };
 
+//applies a baud rate in units of 100, e.g. 9216 for 921600
+void updateBaudRate(uint32_t rate)
+{
+  if (rate < 96 || rate > 15000) rate = 1152;
+  serialBaud = rate;
+  Serial.flush();
+  Serial.updateBaudRate(rate * 100);
+}
+
+#ifdef WLED_ENABLE_ADALIGHT
+static byte* serialFrame = nullptr;  //pixel data of the frame being received, shown only once it is complete
+static uint16_t serialFrameSize = 0; //bytes allocated
+
+//bytes of the frame that fit the LEDs, the rest is read and dropped
+static uint16_t prepareSerialFrame(uint32_t frameBytes)
+{
+  uint32_t needed = MIN(frameBytes, strip.getLengthTotal() * 3U);
+  if (needed > serialFrameSize) {
+    free(serialFrame);
+    serialFrame = (byte*)allocLarge(needed);
+    serialFrameSize = serialFrame ? needed : 0;
+  }
+  return MIN(needed, serialFrameSize);
+}
+
+static void showSerialFrame(uint16_t frameLen, unsigned long frameStart)
+{
+  if (!realtimeMode && bri == 0) strip.setBrightness(briLast);
+  realtimeLock(realtimeTimeoutMs, REALTIME_MODE_ADALIGHT);
+  if (!realtimeOverride) {
+    setRealtimePixels(0, serialFrame, frameLen /3, false);
+    recordShow();
+    strip.show();
+  }
+  realtimePerfAdd(REALTIME_MODE_ADALIGHT, frameStart);
+}
+#endif
+
 void handleSerial()
 {
   if (pinManager.isPinAllocated(3)) return;
   
   #ifdef WLED_ENABLE_ADALIGHT
   static auto state = AdaState::Header_A;
-  static uint16_t count = 0;
-  static uint16_t pixel = 0;
+  static uint32_t count = 0;      //bytes of pixel data in the frame
+  static uint32_t received = 0;   //bytes of pixel data read so far
+  static uint16_t frameLen = 0;   //bytes kept in serialFrame
+  static bool tpm2 = false;
   static byte check = 0x00;
-  static byte red   = 0x00;
-  static byte green = 0x00;
+  static uint32_t frameBusy = 0; //time spent in earlier calls on the frame being received
+  unsigned long callStart = micros();
   
   while (Serial.available() > 0)
   {
-    yield();
+    if (state == AdaState::Data) { //bulk read of the pixel data
+      yield();
+      uint32_t n = MIN((uint32_t)Serial.available(), count - received);
+      if (received < frameLen) {
+        n = MIN(n, frameLen - received);
+        Serial.readBytes(serialFrame + received, n);
+      } else {
+        for (uint32_t i = 0; i < n; i++) Serial.read(); //more LEDs than we have
+      }
+      received += n;
+      if (received < count) continue;
+      if (tpm2) {state = AdaState::TPM2_End; continue;}
+      showSerialFrame(frameLen, callStart - frameBusy);
+      state = AdaState::Header_A;
+      continue;
+    }
+
     byte next = Serial.peek();
     switch (state) {
       case AdaState::Header_A:
@@ -44,23 +99,27 @@ void handleSerial()
         else if (next == '{') { //JSON API
           bool verboseResponse = false;
           {
-            DynamicJsonDocument doc(JSON_BUFFER_SIZE);
+            JsonArenaDoc doc(JSON_LOCK_SERIAL);
+            if (!doc) return;
             Serial.setTimeout(100);
-            DeserializationError error = deserializeJson(doc, Serial);
+            DeserializationError error = deserializeJson(*doc, Serial);
             if (error) return;
-            fileDoc = &doc;
-            verboseResponse = deserializeState(doc.as<JsonObject>());
+            fileDoc = doc.get();
+            verboseResponse = deserializeState(doc->as<JsonObject>());
             fileDoc = nullptr;
           }
           //only send response if TX pin is unused for other purposes
           if (verboseResponse && !pinManager.isPinAllocated(1)) {
-            DynamicJsonDocument doc(JSON_BUFFER_SIZE);
-            JsonObject state = doc.createNestedObject("state");
-            serializeState(state);
-            JsonObject info  = doc.createNestedObject("info");
-            serializeInfo(info);
+            std::shared_ptr<String> state = getStateText();
+            JsonArenaDoc doc(JSON_LOCK_SERIAL);
+            if (!doc || !state) return;
+            serializeInfo(doc->to<JsonObject>());
 
-            serializeJson(doc, Serial);
+            Serial.print(F("{\"state\":"));
+            Serial.print(*state);
+            Serial.print(F(",\"info\":"));
+            serializeJson(*doc, Serial);
+            Serial.write('}');
           }
         }
         break;
@@ -73,19 +132,24 @@ void handleSerial()
         else             state = AdaState::Header_A;
         break;
       case AdaState::Header_CountHi:
-        pixel = 0;
+        frameBusy = 0;
+        callStart = micros();
         count = next * 0x100;
         check = next;
         state = AdaState::Header_CountLo;
         break;
       case AdaState::Header_CountLo:
-        count += next + 1;
+        count = (count + next + 1) * 3; //LED count -1 is sent
         check = check ^ next ^ 0x55;
         state = AdaState::Header_CountCheck;
         break;
       case AdaState::Header_CountCheck:
-        if (check == next) state = AdaState::Data_Red;
-        else               state = AdaState::Header_A;
+        state = AdaState::Header_A;
+        if (check != next) break;
+        tpm2 = false;
+        received = 0;
+        frameLen = prepareSerialFrame(count);
+        state = AdaState::Data;
         break;
       case AdaState::TPM2_Header_Type:
         state = AdaState::Header_A; //(unsupported) TPM2 command or invalid type
@@ -93,36 +157,26 @@ void handleSerial()
         else if (next == 0xAA) Serial.write(0xAC); //TPM2 ping
         break;
       case AdaState::TPM2_Header_CountHi:
-        pixel = 0;
-        count = (next * 0x100) /3;
+        frameBusy = 0;
+        callStart = micros();
+        count = next * 0x100;
         state = AdaState::TPM2_Header_CountLo;
         break;
       case AdaState::TPM2_Header_CountLo:
-        count += next /3;
-        state = AdaState::Data_Red;
+        count += next;
+        tpm2 = true;
+        received = 0;
+        frameLen = prepareSerialFrame(count - count % 3);
+        state = count ? AdaState::Data : AdaState::TPM2_End;
         break;
-      case AdaState::Data_Red:
-        red   = next;
-        state = AdaState::Data_Green;
-        break;
-      case AdaState::Data_Green:
-        green = next;
-        state = AdaState::Data_Blue;
-        break;
-      case AdaState::Data_Blue:
-        byte blue  = next;
-        if (!realtimeOverride) setRealtimePixel(pixel++, red, green, blue, 0);
-        if (--count > 0) state = AdaState::Data_Red;
-        else {
-          if (!realtimeMode && bri == 0) strip.setBrightness(briLast);
-          realtimeLock(realtimeTimeoutMs, REALTIME_MODE_ADALIGHT);
-
-          if (!realtimeOverride) strip.show();
-          state = AdaState::Header_A;
-        }
+      case AdaState::TPM2_End:
+        if (next == 0x36) showSerialFrame(frameLen, callStart - frameBusy); //frames without end byte are dropped
+        state = AdaState::Header_A;
         break;
+      default: break;
     }
     Serial.read(); //discard the byte
   }
+  frameBusy += micros() - callStart;
   #endif
 }
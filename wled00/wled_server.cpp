@@ -1,5 +1,7 @@
 #include "wled.h"
 
+#include <memory>
+
 /*
  * Integrated HTTP web server page declarations
  */
@@ -15,22 +17,45 @@ bool isIp(String str) {
   return true;
 }
 
+//whether /index.htm on the filesystem replaces the built-in UI (-1: not checked yet), so it is not looked up on every load
+static int8_t fsIndexOverride = -1;
+
 void handleUpload(AsyncWebServerRequest *request, const String& filename, size_t index, uint8_t *data, size_t len, bool final){
   if (otaLock) {
     if (final) request->send(500, "text/plain", F("Please unlock OTA in security settings!"));
     return;
   }
   if(!index){
-    request->_tempFile = WLED_FS.open(filename, "w");
+    request->_tempFile = openMediaFile(filename.c_str(), "w");
     DEBUG_PRINT("Uploading ");
     DEBUG_PRINTLN(filename);
-    if (filename == "/presets.json") presetsModifiedTime = toki.second();
+    if (filename == "/presets.json") {
+      presetsModifiedTime = toki.second();
+      clearPresetQueue(); //saves still pending would be written into the uploaded file
+      invalidatePresetIndex();
+    }
   }
   if (len) {
     request->_tempFile.write(data,len);
   }
   if(final){
     request->_tempFile.close();
+    fileUploadCount++;
+    if (filename == "/index.htm") fsIndexOverride = -1;
+    if (filename == "/ir.json") invalidateIrJson();
+    if (filename == "/timers.json") invalidateTimers();
+    if (filename.indexOf(F("/ledmap")) >= 0) { RENDER_LOCK(); strip.reloadLedmaps(); }
+    if (filename.startsWith(F("/palette")) && filename.endsWith(F(".bin"))) { RENDER_LOCK(); strip.loadCustomPalettes(); }
+    #ifndef WLED_DISABLE_BINARY_CONFIG
+    if (filename == "/cfg.json") invalidateConfigSnapshot();
+    #endif
+    if (filename == "/presets.json") {
+      invalidatePresetIndex(); //may have been rebuilt from the partial upload
+      invalidatePresetsChecksum();
+      #ifdef WLED_ENABLE_BINARY_PRESETS
+      clearBinPresets(); //the uploaded file holds the complete set
+      #endif
+    }
     request->send(200, "text/plain", F("File Uploaded!"));
   }
 }
@@ -52,6 +77,86 @@ bool captivePortal(AsyncWebServerRequest *request)
   return false;
 }
 
+#ifndef WLED_DISABLE_OTA
+//lower the frame rate while an update is written, so flash writes get their share of the loop. Restored if the update fails
+void otaThrottleFps(bool ota)
+{
+  static uint8_t fpsBeforeOta = 0;
+  if (ota && !fpsBeforeOta) {
+    fpsBeforeOta = strip.getTargetFps();
+    if (fpsBeforeOta > WLED_OTA_FPS) strip.setTargetFps(WLED_OTA_FPS);
+  } else if (!ota && fpsBeforeOta) {
+    strip.setTargetFps(fpsBeforeOta);
+    fpsBeforeOta = 0;
+  }
+}
+#endif
+
+#if defined(ARDUINO_ARCH_ESP32) && !defined(WLED_DISABLE_OTA)
+/*
+ * The upload handler runs in the web server task and only copies the image into a ring buffer.
+ * loop() writes it to flash one WLED_OTA_SLICE at a time right after the frame was rendered,
+ * so the cache stalls of flash writes fall between frames and effects keep running during the update.
+ * Upload chunks wait while the buffer is full, which slows the sender down over TCP.
+ */
+#if (WLED_OTA_BUFFER & (WLED_OTA_BUFFER -1)) || (WLED_OTA_BUFFER % WLED_OTA_SLICE)
+  #error "WLED_OTA_BUFFER must be a power of 2 and a multiple of WLED_OTA_SLICE"
+#endif
+
+static uint8_t* otaBuffer = nullptr;
+static volatile uint32_t otaHead = 0;   // bytes received, written by the upload handler only
+static volatile uint32_t otaTail = 0;   // bytes written to flash, written by loop() only
+static volatile bool otaFinal = false;  // upload complete, loop() finishes the update
+static volatile bool otaDone = true;    // loop() is not busy with an update
+static unsigned long otaLastData = 0;
+static AsyncWebServerRequest* otaRequest = nullptr; // upload being written, others are ignored
+
+static void otaUploadChunk(uint8_t *data, size_t len, bool final)
+{
+  while (len && !otaDone) {
+    uint32_t head = otaHead;
+    uint32_t space = WLED_OTA_BUFFER - (head - otaTail);
+    uint32_t n = MIN(MIN(space, len), WLED_OTA_BUFFER - (head & (WLED_OTA_BUFFER -1))); // up to the end of the ring
+    if (!n) {vTaskDelay(1); continue;}
+    memcpy(otaBuffer + (head & (WLED_OTA_BUFFER -1)), data, n);
+    __sync_synchronize(); // data is visible before the new head
+    otaHead = head + n;
+    data += n; len -= n;
+  }
+  otaLastData = millis();
+  if (!final) return;
+  otaFinal = true;
+  while (!otaDone) vTaskDelay(1); // the response reports the result of Update.end()
+}
+
+//writes at most one slice of the uploaded image per call, called by loop()
+void handleOTAWrite()
+{
+  if (otaDone) return;
+  otaThrottleFps(true);
+  uint32_t avail = otaHead - otaTail;
+  __sync_synchronize();
+  if (avail >= WLED_OTA_SLICE || (otaFinal && avail)) {
+    uint32_t n = MIN(avail, WLED_OTA_SLICE);
+    if (!Update.hasError()) Update.write(otaBuffer + (otaTail & (WLED_OTA_BUFFER -1)), n);
+    otaTail += n;
+    return;
+  }
+  bool abandoned = !otaFinal && millis() - otaLastData > 10000; // client went away mid upload
+  if (!otaFinal && !abandoned) return;
+  if (abandoned) Update.abort();
+  else if (Update.end(true)) DEBUG_PRINTLN(F("Update Success"));
+  else DEBUG_PRINTLN(F("Update Failed"));
+  if (abandoned || Update.hasError()) otaThrottleFps(false);
+  free(otaBuffer);
+  otaBuffer = nullptr;
+  otaRequest = nullptr;
+  otaDone = true;
+}
+#else
+void handleOTAWrite() {}
+#endif
+
 void initServer()
 {
   //CORS compatiblity
@@ -81,6 +186,27 @@ void initServer()
     }
   });
   
+  //gradient palette previews, palettes 0-12 are in /json/palx
+  server.on("/palettes.json", HTTP_GET, [](AsyncWebServerRequest *request){
+    if (handleIfNoneMatchCacheHeader(request, PAGE_palettes_ETAG)) return;
+    AsyncWebServerResponse *response = request->beginResponse_P(200, "application/json", PAGE_palettes, PAGE_palettes_L);
+    response->addHeader(F("Content-Encoding"),"gzip");
+    response->addHeader(F("Cache-Control"), F("max-age=" TOSTRING(WLED_PALETTES_MAX_AGE) ",immutable"));
+    response->addHeader(F("ETag"), PAGE_palettes_ETAG);
+    request->send(response);
+  });
+  
+  //parts of the UI loaded on first use, see loadMod() in index.js
+  server.on("/index_pe.js", HTTP_GET, [](AsyncWebServerRequest *request){
+    serveUiModule(request, PAGE_index_pe, PAGE_index_pe_L, PAGE_index_pe_ETAG);
+  });
+  server.on("/index_pp.js", HTTP_GET, [](AsyncWebServerRequest *request){
+    serveUiModule(request, PAGE_index_pp, PAGE_index_pp_L, PAGE_index_pp_ETAG);
+  });
+  server.on("/index_se.js", HTTP_GET, [](AsyncWebServerRequest *request){
+    serveUiModule(request, PAGE_index_se, PAGE_index_se_L, PAGE_index_se_ETAG);
+  });
+
   server.on("/sliders", HTTP_GET, [](AsyncWebServerRequest *request){
     serveIndex(request);
   });
@@ -99,28 +225,46 @@ void initServer()
   });
 
   server.on("/json", HTTP_GET, [](AsyncWebServerRequest *request){
+    if (heapLow()) {
+      request->send(503, "application/json", F("{\"error\":3}")); return;
+    }
     serveJson(request);
   });
 
+  //binary pixel data, registered before the JSON handler which would claim /json/px
+  server.on("/json/px", HTTP_POST, [](AsyncWebServerRequest *request){
+    if (request->contentLength() && pixelUploadSucceeded((uint32_t)request)) request->send(200, "application/json", F("{\"success\":true}"));
+    else request->send(400, "application/json", F("{\"error\":9}"));
+  }, nullptr, [](AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total){
+    handlePixelUpload((uint32_t)request, data, len, index == 0, index + len == total);
+  });
+
   AsyncCallbackJsonWebHandler* handler = new AsyncCallbackJsonWebHandler("/json", [](AsyncWebServerRequest *request) {
+    TRACE_SCOPE(TRACE_HTTP, 1);
     bool verboseResponse = false;
     bool isConfig = false;
     { //scope JsonDocument so it releases its buffer
-      DynamicJsonDocument jsonBuffer(JSON_BUFFER_SIZE);
-      DeserializationError error = deserializeJson(jsonBuffer, (uint8_t*)(request->_tempObject));
-      JsonObject root = jsonBuffer.as<JsonObject>();
+      JsonArenaDoc jsonBuffer(JSON_LOCK_HTTP);
+      if (!jsonBuffer) {
+        request->send(503, "application/json", F("{\"error\":3}")); return;
+      }
+      DeserializationError error = deserializeJson(*jsonBuffer, (uint8_t*)(request->_tempObject));
+      JsonObject root = jsonBuffer->as<JsonObject>();
       if (error || root.isNull()) {
         request->send(400, "application/json", F("{\"error\":9}")); return;
       }
       const String& url = request->url();
       isConfig = url.indexOf("cfg") > -1;
-      if (!isConfig) {
+      if (url.indexOf(F("plan")) > -1) { //answered with the plan for the posted busses, nothing is applied
+        stageLedPlan(root["ins"]);
+        verboseResponse = true;
+      } else if (!isConfig) {
         #ifdef WLED_DEBUG
           DEBUG_PRINTLN(F("Serialized HTTP"));
           serializeJson(root,Serial);
           DEBUG_PRINTLN();
         #endif
-        fileDoc = &jsonBuffer;  // used for applying presets (presets.cpp)
+        fileDoc = jsonBuffer.get();  // used for applying presets (presets.cpp)
         verboseResponse = deserializeState(root);
         fileDoc = nullptr;
       } else {
@@ -136,6 +280,7 @@ void initServer()
     } 
     request->send(200, "application/json", F("{\"success\":true}"));
   });
+  handler->setFilter([](AsyncWebServerRequest *request) { return !heapLow(); }); //checked before the body is buffered
   server.addHandler(handler);
 
   server.on("/version", HTTP_GET, [](AsyncWebServerRequest *request){
@@ -149,6 +294,16 @@ void initServer()
   server.on("/freeheap", HTTP_GET, [](AsyncWebServerRequest *request){
     request->send(200, "text/plain", (String)ESP.getFreeHeap());
     });
+
+  server.on("/metrics", HTTP_GET, [](AsyncWebServerRequest *request){
+    serveMetrics(request);
+    });
+
+  #ifdef WLED_ENABLE_TRACE
+  server.on("/trace", HTTP_GET, [](AsyncWebServerRequest *request){
+    serveTrace(request);
+    });
+  #endif
   
   server.on("/u", HTTP_GET, [](AsyncWebServerRequest *request){
     request->send_P(200, "text/html", PAGE_usermod);
@@ -170,6 +325,15 @@ void initServer()
   //if OTA is allowed
   if (!otaLock){
     #ifdef WLED_ENABLE_FS_EDITOR
+    //the editor may change /index.htm, /ir.json and /timers.json. This handler only notices changes and never takes a request
+    server.on("/edit", HTTP_ANY, [](AsyncWebServerRequest *request){}).setFilter([](AsyncWebServerRequest *request){
+      if (request->method() != HTTP_GET && request->url().startsWith("/edit")) {
+        fsIndexOverride = -1;
+        invalidateIrJson();
+        invalidateTimers();
+      }
+      return false;
+    });
      #ifdef ARDUINO_ARCH_ESP32
       server.addHandler(new SPIFFSEditor(WLED_FS));//http_username,http_password));
      #else
@@ -198,9 +362,23 @@ void initServer()
         DEBUG_PRINTLN(F("OTA Update Start"));
         #ifdef ESP8266
         Update.runAsync(true);
+        #else
+        if (!otaDone) return; // an update is already being written
+        otaRequest = request;
+        otaBuffer = (uint8_t*) malloc(WLED_OTA_BUFFER);
         #endif
         Update.begin((ESP.getFreeSketchSpace() - 0x1000) & 0xFFFFF000);
+        #ifdef ARDUINO_ARCH_ESP32
+        if (!otaBuffer) Update.abort();
+        otaHead = otaTail = 0;
+        otaFinal = false;
+        otaLastData = millis();
+        otaDone = !otaBuffer;
+        #endif
       }
+      #ifdef ARDUINO_ARCH_ESP32
+      if (request == otaRequest) otaUploadChunk(data, len, final);
+      #else
       if(!Update.hasError()) Update.write(data, len);
       if(final){
         if(Update.end(true)){
@@ -209,8 +387,10 @@ void initServer()
           DEBUG_PRINTLN(F("Update Failed"));
         }
       }
+      #endif
     });
     
+    initFleetOTA();
     #else
     server.on("/update", HTTP_GET, [](AsyncWebServerRequest *request){
       serveMessage(request, 501, "Not implemented", F("OTA updates are disabled in this build."), 254);
@@ -260,6 +440,12 @@ void initServer()
       return;
     }
     
+    //a JSON post turned away by the filter of its handler, low on memory
+    if ((request->method() & (HTTP_POST | HTTP_PUT)) && request->url().startsWith(F("/json"))) {
+      request->send(503, "application/json", F("{\"error\":3}"));
+      return;
+    }
+
     if(handleSet(request, request->url())) return;
     #ifndef WLED_DISABLE_ALEXA
     if(espalexa.handleAlexaApiCall(request)) return;
@@ -279,38 +465,55 @@ void serveIndexOrWelcome(AsyncWebServerRequest *request)
   }
 }
 
-bool handleIfNoneMatchCacheHeader(AsyncWebServerRequest* request)
+//etag is a hash of the content, so the cached copy stays valid across firmware updates that do not change it
+bool handleIfNoneMatchCacheHeader(AsyncWebServerRequest* request, const char* etag)
 {
   AsyncWebHeader* header = request->getHeader("If-None-Match");
-  if (header && header->value() == String(VERSION)) {
+  if (header && header->value() == etag) {
     request->send(304);
     return true;
   }
   return false;
 }
 
-void setStaticContentCacheHeaders(AsyncWebServerResponse *response)
+void setStaticContentCacheHeaders(AsyncWebServerResponse *response, const char* etag)
 {
   #ifndef WLED_DEBUG
+  #if WLED_UI_MAX_AGE > 0
+  response->addHeader(F("Cache-Control"), F("max-age=" TOSTRING(WLED_UI_MAX_AGE) ",immutable"));
+  #else
   //this header name is misleading, "no-cache" will not disable cache,
   //it just revalidates on every load using the "If-None-Match" header with the last ETag value
   response->addHeader(F("Cache-Control"),"no-cache");
+  #endif
   #else
   response->addHeader(F("Cache-Control"),"no-store,max-age=0"); // prevent caching if debug build
   #endif
-  response->addHeader(F("ETag"), String(VERSION));
+  response->addHeader(F("ETag"), etag);
 }
 
 void serveIndex(AsyncWebServerRequest* request)
 {
-  if (handleFileRead(request, "/index.htm")) return;
+  if (fsIndexOverride < 0) fsIndexOverride = WLED_FS.exists("/index.htm");
+  if (fsIndexOverride && handleFileRead(request, "/index.htm")) return;
 
-  if (handleIfNoneMatchCacheHeader(request)) return;
+  if (handleIfNoneMatchCacheHeader(request, PAGE_index_ETAG)) return;
 
   AsyncWebServerResponse *response = request->beginResponse_P(200, "text/html", PAGE_index, PAGE_index_L);
 
   response->addHeader(F("Content-Encoding"),"gzip");
-  setStaticContentCacheHeaders(response);
+  setStaticContentCacheHeaders(response, PAGE_index_ETAG);
+  request->send(response);
+}
+
+
+void serveUiModule(AsyncWebServerRequest* request, const uint8_t* page, uint16_t len, const char* etag)
+{
+  if (handleIfNoneMatchCacheHeader(request, etag)) return;
+  AsyncWebServerResponse *response = request->beginResponse_P(200, "application/javascript", page, len);
+  response->addHeader(F("Content-Encoding"),"gzip");
+  response->addHeader(F("Cache-Control"), F("max-age=" TOSTRING(WLED_UI_MODULES_MAX_AGE) ",immutable"));
+  response->addHeader(F("ETag"), etag);
   request->send(response);
 }
 
@@ -359,26 +562,208 @@ void serveMessage(AsyncWebServerRequest* request, uint16_t code, const String& h
 }
 
 
-String settingsProcessor(const String& var)
+/*
+ * Prometheus text format metrics, served as /metrics.
+ * Lines are generated one at a time into the chunks of the response, so no buffer for the whole text is needed.
+ */
+enum { MET_UPTIME, MET_FPS, MET_LOOP, MET_HEAP, MET_HEAP_BLOCK, MET_HEAP_FRAG, MET_ALLOC_FAILS, MET_HEAP_REJECTS,
+       MET_CURRENT, MET_BUS_CURRENT,
+       MET_RT_PACKETS, MET_RT_LOST, MET_RT_SKIPPED, MET_E131_DROPPED, MET_RSSI, MET_COUNT };
+
+static const char* const metricFamilies[MET_COUNT] = { //name and type
+  "wled_uptime_seconds counter", "wled_fps gauge", "wled_loop_us gauge",
+  "wled_heap_free_bytes gauge", "wled_heap_max_block_bytes gauge", "wled_heap_fragmentation_percent gauge",
+  "wled_alloc_failures_total counter", "wled_heap_rejected_requests_total counter",
+  "wled_current_milliamps gauge", "wled_bus_current_milliamps gauge",
+  "wled_realtime_packets_total counter", "wled_realtime_lost_total counter", "wled_realtime_skipped_total counter",
+  "wled_e131_dropped_frames_total counter", "wled_wifi_rssi_dbm gauge"
+};
+
+//label and value of series i of a family, false once there are no more
+static bool metricSeries(uint8_t f, uint8_t& i, char* label, size_t labelLen, int32_t& value)
 {
-  if (var == "CSS") {
-    char buf[2048];
-    buf[0] = 0;
-    getSettingsJS(optionType, buf);
-    return String(buf);
+  label[0] = 0;
+  switch (f) {
+    case MET_UPTIME:     value = millis() / 1000; return !i;
+    case MET_FPS:        value = strip.getFps(); return !i;
+    case MET_LOOP:
+      if (i > 1) return false;
+      strcpy_P(label, i ? PSTR("{stat=\"max\"}") : PSTR("{stat=\"avg\"}"));
+      value = i ? loopPerf.max : loopPerf.avg;
+      return true;
+    case MET_HEAP:       value = ESP.getFreeHeap(); return !i;
+    case MET_HEAP_BLOCK: value = heapLargestBlock(); return !i;
+    case MET_HEAP_FRAG:  value = heapFragmentation(); return !i;
+    case MET_ALLOC_FAILS: {
+      static const char* const subsystems[] = {"json", "response", "ws", "segdata"};
+      if (i > 3) return false;
+      snprintf_P(label, labelLen, PSTR("{subsystem=\"%s\"}"), subsystems[i]);
+      const uint32_t fails[] = {jsonArenaFails, responseFails, wsBufferFails, strip.getSegmentArena().fails()};
+      value = fails[i];
+      return true;
+    }
+    case MET_HEAP_REJECTS: value = heapRejects; return !i;
+    case MET_CURRENT:    value = strip.currentMilliamps; return !i && strip.currentMilliamps;
+    case MET_BUS_CURRENT:
+      if (i >= busses.getNumBusses() || !strip.currentMilliamps) return false;
+      snprintf_P(label, labelLen, PSTR("{bus=\"%u\"}"), i);
+      value = busses.getBus(i)->milliamps;
+      return true;
+    case MET_RT_PACKETS: //skips the protocols not seen since boot
+      while (i <= REALTIME_MODE_DDP && !realtimePerf[i].count) i++;
+      if (i > REALTIME_MODE_DDP) return false;
+      snprintf_P(label, labelLen, PSTR("{mode=\"%u\"}"), i);
+      value = realtimePerf[i].count;
+      return true;
+    case MET_RT_LOST:      value = udpInLost; return !i;
+    case MET_RT_SKIPPED:   value = udpInSkipped; return !i;
+    case MET_E131_DROPPED: value = e131DroppedFrames; return !i;
+    case MET_RSSI:         value = WiFi.RSSI(); return !i && Network.isConnected() && !Network.isEthernet();
+  }
+  return false;
+}
+
+class MetricsWriter {
+  uint8_t family = 0, series = 0;
+  bool typeDone = false;
+  char line[96];
+  uint8_t pos = 0, len = 0; //part of line not sent yet
+
+  //generates the next line, false at the end
+  bool nextLine() {
+    while (family < MET_COUNT) {
+      char label[32];
+      int32_t value;
+      uint8_t i = series;
+      if (metricSeries(family, i, label, sizeof(label), value)) {
+        char name[48];
+        strlcpy(name, metricFamilies[family], sizeof(name));
+        if (!typeDone) { //"# TYPE name type" precedes the first series
+          len = snprintf_P(line, sizeof(line), PSTR("# TYPE %s\n"), name);
+          typeDone = true;
+        } else {
+          *strchr(name, ' ') = 0;
+          len = snprintf_P(line, sizeof(line), PSTR("%s%s %d\n"), name, label, (int)value);
+          series = i + 1;
+        }
+        pos = 0;
+        return true;
+      }
+      family++; series = 0; typeDone = false;
+    }
+    return false;
   }
-  
-  #ifdef WLED_ENABLE_DMX
 
-  if (var == "DMXMENU") {
-    return String(F("<form action=/settings/dmx><button type=submit>DMX Output</button></form>"));
+public:
+  size_t fill(uint8_t* buffer, size_t maxLen) {
+    size_t n = 0;
+    while (n < maxLen) {
+      if (pos == len && !nextLine()) break;
+      size_t part = MIN((size_t)(len - pos), maxLen - n);
+      memcpy(buffer + n, line + pos, part);
+      pos += part; n += part;
+    }
+    return n;
   }
-  
-  #endif
-  if (var == "SCSS") return String(FPSTR(PAGE_settingsCss));
-  return String();
+};
+
+void serveMetrics(AsyncWebServerRequest* request)
+{
+  MetricsWriter writer;
+  AsyncWebServerResponse *response = request->beginChunkedResponse("text/plain; version=0.0.4", [writer](uint8_t* buffer, size_t maxLen, size_t index) mutable -> size_t {
+    return writer.fill(buffer, maxLen);
+  });
+  response->addHeader(F("Cache-Control"), F("no-store"));
+  request->send(response);
 }
 
+#define SETTINGS_MAX_PIECES 32
+
+/*
+ * A settings page, streamed as a chunked response. The script with the current values (%CSS%) is rendered once
+ * when the response starts, so all chunks see the same values. The template from flash is split into pieces
+ * around its placeholders, which are copied out one after the other.
+ */
+class SettingsStreamer {
+  private:
+    struct Piece { const char* txt; size_t len; };
+    Piece _pieces[SETTINGS_MAX_PIECES];
+    uint8_t _count = 0, _cur = 0;
+    size_t _pos = 0; //in _pieces[_cur]
+    char* _script = nullptr;
+
+    void add(const char* txt, size_t len) {
+      if (!len) return;
+      if (_count < SETTINGS_MAX_PIECES) _pieces[_count++] = {txt, len};
+      else DEBUG_PRINTLN(F("Settings page has too many pieces"));
+    }
+
+    //%CSS% is the settings script, %SCSS% the shared style, %% a literal %
+    void parse(const char* page) {
+      const char* seg = page;
+      const char* p = page;
+      char c;
+      while ((c = pgm_read_byte(p))) {
+        if (c != '%') { p++; continue; }
+        p++;
+        if (pgm_read_byte(p) == '%') { add(seg, p - seg); seg = ++p; continue; } //escaped, the first % is kept
+        char var[8]; //longest is DMXMENU
+        uint8_t i = 0;
+        while (i < sizeof(var) && (c = pgm_read_byte(p + i)) && c != '%') var[i++] = c;
+        if (i == sizeof(var) || c != '%') continue; //not a placeholder
+        var[i] = 0;
+        add(seg, p - seg -1);
+        seg = p += i + 1;
+
+        if      (!strcmp_P(var, PSTR("CSS")))  add(_script, _script ? strlen(_script) : 0);
+        else if (!strcmp_P(var, PSTR("SCSS"))) parse(PAGE_settingsCss);
+        #ifdef WLED_ENABLE_DMX
+        else if (!strcmp_P(var, PSTR("DMXMENU"))) {
+          static const char dmxMenu[] PROGMEM = "<form action=/settings/dmx><button type=submit>DMX Output</button></form>";
+          add(dmxMenu, strlen_P(dmxMenu));
+        }
+        #endif
+      }
+      add(seg, p - seg);
+    }
+
+  public:
+    SettingsStreamer(const char* page, byte subPage) {
+      obuf = nullptr; //the first run only counts the length
+      olen = 0;
+      omax = UINT16_MAX;
+      getSettingsJS(subPage);
+      size_t len = olen;
+      _script = (char*)malloc(len +1);
+      if (_script) {
+        obuf = _script;
+        olen = 0;
+        omax = len;
+        getSettingsJS(subPage);
+        _script[olen] = 0;
+      }
+      omax = 0;
+      parse(page);
+    }
+
+    ~SettingsStreamer() {
+      free(_script);
+    }
+
+    //fills the chunked response buffer, 0 ends the response
+    size_t fill(uint8_t* buffer, size_t maxLen) {
+      size_t len = 0;
+      while (len < maxLen && _cur < _count) {
+        const Piece& pc = _pieces[_cur];
+        size_t n = MIN(maxLen - len, pc.len - _pos);
+        memcpy_P(buffer + len, pc.txt + _pos, n);
+        len += n; _pos += n;
+        if (_pos == pc.len) { _cur++; _pos = 0; }
+      }
+      return len;
+    }
+};
+
 String dmxProcessor(const String& var)
 {
   String mapJS;
@@ -454,18 +839,24 @@ void serveSettings(AsyncWebServerRequest* request, bool post)
   #endif
 
   optionType = subPage;
-  
+  if (subPage == 255) {request->send_P(200, "text/html", PAGE_welcome); return;}
+
+  const char* page;
   switch (subPage)
   {
-    case 1:   request->send_P(200, "text/html", PAGE_settings_wifi, settingsProcessor); break;
-    case 2:   request->send_P(200, "text/html", PAGE_settings_leds, settingsProcessor); break;
-    case 3:   request->send_P(200, "text/html", PAGE_settings_ui  , settingsProcessor); break;
-    case 4:   request->send_P(200, "text/html", PAGE_settings_sync, settingsProcessor); break;
-    case 5:   request->send_P(200, "text/html", PAGE_settings_time, settingsProcessor); break;
-    case 6:   request->send_P(200, "text/html", PAGE_settings_sec , settingsProcessor); break;
-    case 7:   request->send_P(200, "text/html", PAGE_settings_dmx , settingsProcessor); break;
-    case 8:   request->send_P(200, "text/html", PAGE_settings_um  , settingsProcessor); break;
-    case 255: request->send_P(200, "text/html", PAGE_welcome); break;
-    default:  request->send_P(200, "text/html", PAGE_settings     , settingsProcessor); 
+    case 1:   page = PAGE_settings_wifi; break;
+    case 2:   page = PAGE_settings_leds; break;
+    case 3:   page = PAGE_settings_ui  ; break;
+    case 4:   page = PAGE_settings_sync; break;
+    case 5:   page = PAGE_settings_time; break;
+    case 6:   page = PAGE_settings_sec ; break;
+    case 7:   page = PAGE_settings_dmx ; break;
+    case 8:   page = PAGE_settings_um  ; break;
+    default:  page = PAGE_settings     ;
   }
+  std::shared_ptr<SettingsStreamer> streamer = std::make_shared<SettingsStreamer>(page, subPage);
+  AsyncWebServerResponse *response = request->beginChunkedResponse("text/html", [streamer](uint8_t* buffer, size_t maxLen, size_t index) -> size_t {
+    return streamer->fill(buffer, maxLen);
+  });
+  request->send(response);
 }
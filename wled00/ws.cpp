@@ -5,76 +5,239 @@
  */
 #ifdef WLED_ENABLE_WEBSOCKETS
 
-uint16_t wsLiveClientId = 0;
+#define WS_LIVE_INTERVAL 40
+#define WS_MAX_LIVE_CLIENTS 4
+
+#ifndef WS_BROADCAST_INTERVAL
+  #define WS_BROADCAST_INTERVAL 100 //ms, at most one state broadcast per interval
+#endif
+#define WS_CACHE_MAX_AGE 1000       //ms the last state is reused for single clients
+#define WS_MAX_PENDING 8            //clients that can wait for the full state at once
+
+uint32_t wsLiveClients[WS_MAX_LIVE_CLIENTS] = {0}; //clients subscribed to live LED data
+uint8_t wsLiveBinary = 0;                          //bit per slot, client understands binary live frames
+uint8_t wsLiveNextSlot = 0;                        //slot taken over when all are in use
 unsigned long wsLastLiveTime = 0;
-//uint8_t* wsFrameBuffer = nullptr;
 
-#define WS_LIVE_INTERVAL 40
+#ifndef WS_MAX_MSG_SIZE
+  #ifdef ESP8266
+  #define WS_MAX_MSG_SIZE 4096
+  #else
+  #define WS_MAX_MSG_SIZE 8192
+  #endif
+#endif
+
+uint8_t* wsFrameBuffer = nullptr; //reassembly buffer for split text messages
+uint32_t wsFrameClientId = 0;     //client the buffer belongs to
+size_t wsFrameLen = 0;
+unsigned long wsFrameStart = 0;
+
+#define WS_MAX_DELTA_CLIENTS 8
+#define WS_DELTA_KEYS 16
+
+uint32_t wsDeltaClients[WS_MAX_DELTA_CLIENTS] = {0}; //clients that receive only changed state fields
+uint8_t wsDeltaResync = 0;                           //bit per slot, client missed a delta and needs the full state
+
+//last broadcast state, deltas are computed against it
+struct { uint32_t key; uint32_t val; } wsLastKeys[WS_DELTA_KEYS];
+struct WsLastSeg { WS2812FX::Segment seg; uint32_t name; };
+WsLastSeg* wsLastSegs = nullptr; //grows along with the segments of the strip
+uint8_t wsLastSegCount = 0;
+
+//FNV-1a hash of serialized JSON, used to find top level state keys that changed
+class JsonHash : public Print {
+  public:
+    uint32_t h = 2166136261UL;
+    size_t write(uint8_t c) { h = (h ^ c) * 16777619UL; return 1; }
+    using Print::write;
+};
+
+uint32_t hashString(const char* str)
+{
+  JsonHash hp;
+  if (str) hp.print(str);
+  return hp.h;
+}
+
+uint32_t hashJson(JsonVariantConst v)
+{
+  JsonHash hp;
+  serializeJson(v, hp);
+  return hp.h;
+}
+
+int8_t wsDeltaSlot(uint32_t id)
+{
+  for (uint8_t i = 0; i < WS_MAX_DELTA_CLIENTS; i++)
+    if (wsDeltaClients[i] == id) return i;
+  return -1;
+}
+
+void wsDeltaUnsubscribe(uint32_t id)
+{
+  int8_t slot = wsDeltaSlot(id);
+  if (slot >= 0) wsDeltaClients[slot] = 0;
+}
+
+bool wsDeltaSubscribe(uint32_t id)
+{
+  if (wsDeltaSlot(id) >= 0) return true;
+  int8_t slot = wsDeltaSlot(0);
+  if (slot < 0) return false; //all in use, client keeps getting the full state
+  wsDeltaClients[slot] = id;
+  wsDeltaResync &= ~(1 << slot);
+  return true;
+}
+
+#ifndef MAX_LIVE_LEDS_WS
+  #ifdef ESP8266
+  #define MAX_LIVE_LEDS_WS 1024
+  #else
+  #define MAX_LIVE_LEDS_WS 4096
+  #endif
+#endif
+
+void wsLiveUnsubscribe(uint32_t id)
+{
+  for (uint8_t i = 0; i < WS_MAX_LIVE_CLIENTS; i++)
+    if (wsLiveClients[i] == id) wsLiveClients[i] = 0;
+}
+
+void wsLiveSubscribe(uint32_t id, bool binary)
+{
+  wsLiveUnsubscribe(id);
+  uint8_t slot = WS_MAX_LIVE_CLIENTS;
+  for (uint8_t i = 0; i < WS_MAX_LIVE_CLIENTS; i++)
+    if (!wsLiveClients[i]) { slot = i; break; }
+  if (slot == WS_MAX_LIVE_CLIENTS) { //all in use, the oldest subscriber loses its stream
+    slot = wsLiveNextSlot;
+    wsLiveNextSlot = (wsLiveNextSlot +1) % WS_MAX_LIVE_CLIENTS;
+  }
+  wsLiveClients[slot] = id;
+  if (binary) wsLiveBinary |=  (1 << slot);
+  else        wsLiveBinary &= ~(1 << slot);
+}
+
+//handles a complete text message, either from a single frame or reassembled
+void handleWsText(AsyncWebSocketClient * client, uint8_t *data, size_t len)
+{
+  if (len > 0 && len < 10 && data[0] == 'p') {
+    //application layer ping/pong heartbeat.
+    //client-side socket layer ping packets are unresponded (investigate)
+    client->text(F("pong"));
+    return;
+  }
+  bool verboseResponse = false;
+  { //scope JsonDocument so it releases its buffer
+    JsonArenaDoc jsonBuffer(JSON_LOCK_WS);
+    if (!jsonBuffer) return;
+    DeserializationError error = deserializeJson(*jsonBuffer, data, len);
+    JsonObject root = jsonBuffer->as<JsonObject>();
+    if (error || root.isNull()) return;
+
+    if (root["v"] && root.size() == 1) {
+      //if the received value is just "{"v":true}", send only to this client
+      verboseResponse = true;
+    } else if (root.containsKey("lv"))
+    {
+      if (root["lv"]) wsLiveSubscribe(client->id(), root[F("bin")] | false);
+      else            wsLiveUnsubscribe(client->id());
+    } else if (root.containsKey(F("dlt")))
+    {
+      if (root[F("dlt")]) wsDeltaSubscribe(client->id());
+      else                wsDeltaUnsubscribe(client->id());
+      verboseResponse = true; //full resync, deltas follow
+    } else {
+      bool playlist = root.containsKey(F("playlist"));
+      fileDoc = jsonBuffer.get();
+      verboseResponse = deserializeState(root);
+      fileDoc = nullptr;
+      if (playlist && !interfaceUpdateCallMode) {
+        //special case, only on playlist load, avoid sending twice in rapid succession
+        if (millis() - lastInterfaceUpdate > 1700) verboseResponse = false;
+      }
+    }
+  }
+  //update if it takes longer than 300ms until next "broadcast"
+  if (verboseResponse && (millis() - lastInterfaceUpdate < 1700 || !interfaceUpdateCallMode)) sendDataWs(client);
+}
+
+void wsFreeFrameBuffer()
+{
+  free(wsFrameBuffer);
+  wsFrameBuffer = nullptr;
+  wsFrameClientId = 0;
+  wsFrameLen = 0;
+}
 
 void wsEvent(AsyncWebSocket * server, AsyncWebSocketClient * client, AwsEventType type, void * arg, uint8_t *data, size_t len)
 {
+  TRACE_SCOPE(TRACE_WS, type);
   if(type == WS_EVT_CONNECT){
     //client connected
     sendDataWs(client);
   } else if(type == WS_EVT_DISCONNECT){
     //client disconnected
-    if (client->id() == wsLiveClientId) wsLiveClientId = 0;
+    wsLiveUnsubscribe(client->id());
+    wsDeltaUnsubscribe(client->id());
+    if (client->id() == wsFrameClientId) wsFreeFrameBuffer();
   } else if(type == WS_EVT_DATA){
     //data packet
     AwsFrameInfo * info = (AwsFrameInfo*)arg;
-    if(info->final && info->index == 0 && info->len == len){
+    if(info->final && info->num == 0 && info->index == 0 && info->len == len){
       //the whole message is in a single frame and we got all of its data (max. 1450byte)
-      if(info->opcode == WS_TEXT)
-      {
-        if (len > 0 && len < 10 && data[0] == 'p') {
-          //application layer ping/pong heartbeat.
-          //client-side socket layer ping packets are unresponded (investigate)
-          client->text(F("pong"));
+      if(info->opcode == WS_TEXT) {
+        if (heapLow()) client->text(F("{\"error\":3}")); //low on memory, the client may retry later
+        else handleWsText(client, data, len);
+      }
+      else if (info->opcode == WS_BINARY && !handlePixelUpload(client->id(), data, len, true, true)) client->text(F("{\"error\":9}"));
+    } else {
+      //binary pixel uploads are written chunk by chunk, no reassembly needed
+      if (info->message_opcode == WS_BINARY) {
+        bool first = info->num == 0 && info->index == 0;
+        bool last  = info->final && info->index + len == info->len;
+        if (!handlePixelUpload(client->id(), data, len, first, last) && first) client->text(F("{\"error\":9}"));
+        return;
+      }
+      //message is comprised of multiple frames or the frame is split into multiple packets
+      //text messages are reassembled in a buffer of up to WS_MAX_MSG_SIZE bytes, one client at a time
+      if (info->message_opcode != WS_TEXT) return;
+      if (info->num == 0 && info->index == 0) { //start of a new message
+        if (wsFrameBuffer && wsFrameClientId != client->id() && millis() - wsFrameStart < 2000) {
+          client->text(F("{\"error\":9}")); //another client is sending a split message
+          return;
+        }
+        wsFreeFrameBuffer();
+        if (heapLow()) {
+          client->text(F("{\"error\":3}"));
           return;
         }
-        bool verboseResponse = false;
-        { //scope JsonDocument so it releases its buffer
-          DynamicJsonDocument jsonBuffer(JSON_BUFFER_SIZE);
-          DeserializationError error = deserializeJson(jsonBuffer, data, len);
-          JsonObject root = jsonBuffer.as<JsonObject>();
-          if (error || root.isNull()) return;
-
-          if (root["v"] && root.size() == 1) {
-            //if the received value is just "{"v":true}", send only to this client
-            verboseResponse = true;
-          } else if (root.containsKey("lv"))
-          {
-            wsLiveClientId = root["lv"] ? client->id() : 0;
-          } else {
-            fileDoc = &jsonBuffer;
-            verboseResponse = deserializeState(root);
-            fileDoc = nullptr;
-            if (!interfaceUpdateCallMode) {
-              //special case, only on playlist load, avoid sending twice in rapid succession
-              if (millis() - lastInterfaceUpdate > 1700) verboseResponse = false;
-            }
-          }
+        wsFrameBuffer = (uint8_t*) malloc(WS_MAX_MSG_SIZE);
+        if (!wsFrameBuffer) {
+          client->text(F("{\"error\":9}")); //out of memory
+          return;
         }
-        //update if it takes longer than 300ms until next "broadcast"
-        if (verboseResponse && (millis() - lastInterfaceUpdate < 1700 || !interfaceUpdateCallMode)) sendDataWs(client);
+        wsFrameClientId = client->id();
+        wsFrameStart = millis();
       }
-    } else {
-      //message is comprised of multiple frames or the frame is split into multiple packets
-      //if(info->index == 0){
-        //if (!wsFrameBuffer && len < 4096) wsFrameBuffer = new uint8_t[4096];
-      //}
+      if (!wsFrameBuffer || wsFrameClientId != client->id()) return;
 
-      //if (wsFrameBuffer && len < 4096 && info->index + info->)
-      //{
-
-      //}
+      if (wsFrameLen + len > WS_MAX_MSG_SIZE) {
+        wsFreeFrameBuffer();
+        client->text(F("{\"error\":9}")); //message too large
+        return;
+      }
+      memcpy(wsFrameBuffer + wsFrameLen, data, len);
+      wsFrameLen += len;
 
-      if((info->index + len) == info->len){
-        if(info->final){
-          if(info->message_opcode == WS_TEXT) {
-            client->text(F("{\"error\":9}")); //we do not handle split packets right now
-          }
-        }
+      if((info->index + len) == info->len && info->final){
+        //last packet of the last frame, the message is complete
+        size_t msgLen = wsFrameLen;
+        uint8_t* msg = wsFrameBuffer;
+        wsFrameBuffer = nullptr; //detach, so the reassembly state is reset before handling
+        wsFreeFrameBuffer();
+        handleWsText(client, msg, msgLen);
+        free(msg);
       }
     }
   } else if(type == WS_EVT_ERROR){
@@ -86,38 +249,303 @@ void wsEvent(AsyncWebSocket * server, AsyncWebSocketClient * client, AwsEventTyp
   }
 }
 
-void sendDataWs(AsyncWebSocketClient * client)
+//strips all state fields that did not change since the last broadcast and updates the snapshot
+//returns false if nothing changed
+bool reduceToDelta(JsonObject state)
 {
-  if (!ws.count()) return;
-  AsyncWebSocketMessageBuffer * buffer;
+  bool changed = false;
+  const char* unchanged[WS_DELTA_KEYS];
+  uint8_t unchangedCount = 0;
+  for (JsonPair kv : state) {
+    if (kv.key() == "seg") continue;
+    uint32_t key = hashString(kv.key().c_str());
+    uint32_t val = hashJson(kv.value());
+    uint8_t i = 0, freeSlot = WS_DELTA_KEYS;
+    for (; i < WS_DELTA_KEYS; i++) {
+      if (wsLastKeys[i].key == key) break;
+      if (!wsLastKeys[i].key && freeSlot == WS_DELTA_KEYS) freeSlot = i;
+    }
+    if (i == WS_DELTA_KEYS) i = freeSlot;
+    if (i < WS_DELTA_KEYS && wsLastKeys[i].key == key && wsLastKeys[i].val == val) {
+      if (unchangedCount < WS_DELTA_KEYS) unchanged[unchangedCount++] = kv.key().c_str();
+      continue;
+    }
+    if (i < WS_DELTA_KEYS) {
+      wsLastKeys[i].key = key;
+      wsLastKeys[i].val = val;
+    }
+    changed = true;
+  }
+  for (uint8_t i = 0; i < unchangedCount; i++) state.remove(unchanged[i]); //not while iterating
 
-  { //scope JsonDocument so it releases its buffer
-    DynamicJsonDocument doc(JSON_BUFFER_SIZE);
-    JsonObject state = doc.createNestedObject("state");
-    serializeState(state);
-    JsonObject info  = doc.createNestedObject("info");
+  //only segments that differ are kept, deleted segments are sent as {"id":n,"stop":0}
+  JsonArray seg = state["seg"];
+  uint8_t segCount = strip.getSegmentCount();
+  if (segCount > wsLastSegCount) {
+    WsLastSeg* grown = (WsLastSeg*) realloc(wsLastSegs, segCount * sizeof(WsLastSeg));
+    if (!grown) return true; //no snapshot, send all segments
+    memset(grown + wsLastSegCount, 0, (segCount - wsLastSegCount) * sizeof(WsLastSeg));
+    wsLastSegs = grown;
+    wsLastSegCount = segCount;
+  }
+  bool sent[MAX_NUM_SEGMENTS] = {false};
+  for (int i = seg.size() -1; i >= 0; i--) {
+    uint8_t id = seg[i]["id"];
+    if (id >= segCount) continue;
+    sent[id] = true;
+    WS2812FX::Segment& sg = strip.getSegment(id);
+    uint32_t nameHash = hashString(strip.getSegmentName(id));
+    WsLastSeg& last = wsLastSegs[id];
+    if (!sg.differs(last.seg) && sg.options == last.seg.options && nameHash == last.name) {
+      seg.remove(i);
+      continue;
+    }
+    last.seg = sg;
+    last.name = nameHash;
+  }
+  for (uint8_t id = 0; id < segCount; id++) {
+    if (sent[id] || !wsLastSegs[id].seg.isActive()) continue;
+    JsonObject seg0 = seg.createNestedObject();
+    seg0["id"] = id;
+    seg0["stop"] = 0;
+    wsLastSegs[id].seg.stop = 0;
+  }
+  if (seg.size()) changed = true;
+  else            state.remove("seg");
+  return changed;
+}
+
+//message buffer for all clients, failures are counted for the info page
+static AsyncWebSocketMessageBuffer * wsMakeBuffer(size_t len)
+{
+  AsyncWebSocketMessageBuffer * buffer = ws.makeBuffer(len);
+  if (!buffer) wsBufferFails++;
+  return buffer;
+}
+
+AsyncWebSocketMessageBuffer * makeJsonBuffer(JsonDocument& doc)
+{
+  size_t len = measureJson(doc);
+  AsyncWebSocketMessageBuffer * buffer = wsMakeBuffer(len);
+  if (buffer) serializeJson(doc, (char *)buffer->get(), len +1);
+  return buffer;
+}
+
+//state updates are sent by handleWs() in the loop, so several requests share one serialization
+//the full state and info stays cached (locked) for clients connecting shortly after, until the state changes
+AsyncWebSocketMessageBuffer * wsCache = nullptr;
+unsigned long wsCacheTime = 0;
+uint32_t wsCacheVersion = 0;
+volatile bool wsBroadcastPending = false;
+unsigned long wsPendingSince = 0;
+unsigned long wsLastBroadcast = 0;
+volatile uint32_t wsPendingClients[WS_MAX_PENDING] = {0}; //clients waiting for the full state
+
+void wsDropCache()
+{
+  if (!wsCache) return;
+  wsCache->unlock();
+  wsCache = nullptr;
+  ws._cleanBuffers();
+}
+
+//serializes the full state and info, the delta of the state too if delta is not null
+//the full buffer becomes the cache if cache is set, buffers are returned locked
+static AsyncWebSocketMessageBuffer * wsSerialize(AsyncWebSocketMessageBuffer ** delta, bool cache)
+{
+  //without deltas, the state text comes from the cache shared with /json/state
+  std::shared_ptr<String> stateText = delta ? nullptr : getStateText();
+  JsonArenaDoc doc(JSON_LOCK_WS_SEND);
+  if (!doc) return nullptr;
+  AsyncWebSocketMessageBuffer * buffer;
+  if (stateText) {
+    JsonObject info = doc->to<JsonObject>();
     serializeInfo(info);
-    size_t len = measureJson(doc);
-    buffer = ws.makeBuffer(len);
-    if (!buffer) return; //out of memory
-
-    serializeJson(doc, (char *)buffer->get(), len +1);
-  } 
-  if (client) {
-    client->text(buffer);
+    size_t len = 9 + stateText->length() + 8 + measureJson(*doc) + 1; //{"state":...,"info":...}
+    buffer = wsMakeBuffer(len);
+    if (!buffer) return nullptr;
+    char* p = (char *)buffer->get();
+    memcpy(p, "{\"state\":", 9);
+    memcpy(p + 9, stateText->c_str(), stateText->length());
+    p += 9 + stateText->length();
+    memcpy(p, ",\"info\":", 8);
+    p += 8;
+    p += serializeJson(*doc, p, measureJson(*doc) +1);
+    *p = '}';
   } else {
-    ws.textAll(buffer);
+    JsonObject state = doc->createNestedObject("state");
+    serializeState(state);
+    JsonObject info  = doc->createNestedObject("info");
+    serializeInfo(info);
+    buffer = makeJsonBuffer(*doc);
+    if (!buffer) return nullptr; //out of memory
+    if (delta) {
+      doc->remove("info");
+      if (reduceToDelta(state)) {
+        (*doc)[F("dlt")] = true;
+        *delta = makeJsonBuffer(*doc);
+        if (*delta) (*delta)->lock();
+      }
+    }
+  }
+  buffer->lock();
+  if (cache) {
+    wsDropCache();
+    wsCache = buffer;
+    wsCacheTime = millis();
+    wsCacheVersion = stateVersion;
+  }
+  return buffer;
+}
+
+//sends the pending state change to all clients
+//clients that subscribed with {"dlt":true} get only the state fields changed since the last broadcast
+static void wsBroadcast()
+{
+  wsBroadcastPending = false;
+  wsLastBroadcast = millis();
+  bool hasDeltaClients = false;
+  for (uint8_t i = 0; i < WS_MAX_DELTA_CLIENTS; i++) if (wsDeltaClients[i]) hasDeltaClients = true;
+
+  AsyncWebSocketMessageBuffer * delta = nullptr;
+  AsyncWebSocketMessageBuffer * buffer = wsSerialize(hasDeltaClients ? &delta : nullptr, true);
+  if (!buffer) return;
+  for (const auto& c : ws.getClients()) {
+    if (c->status() != WS_CONNECTED) continue;
+    int8_t slot = wsDeltaSlot(c->id());
+    for (uint8_t i = 0; i < WS_MAX_PENDING; i++) if (wsPendingClients[i] == c->id()) { //no need to answer separately
+      wsPendingClients[i] = 0;
+      slot = -1;
+    }
+    if (slot < 0 || (wsDeltaResync & (1 << slot))) {
+      if (c->queueIsFull()) continue;
+      c->text(buffer);
+      if (slot >= 0) wsDeltaResync &= ~(1 << slot);
+    } else if (delta) {
+      if (c->queueIsFull()) { wsDeltaResync |= (1 << slot); continue; } //delta would be lost
+      c->text(delta);
+    }
+  }
+  if (delta) delta->unlock();
+  ws._cleanBuffers();
+}
+
+//sends the cached state to the clients that asked for it
+static void wsAnswerPending()
+{
+  bool any = false;
+  for (uint8_t i = 0; i < WS_MAX_PENDING; i++) if (wsPendingClients[i]) any = true;
+  if (!any) return;
+  //the cache is only used while no change is known to be pending
+  if (wsCacheVersion != stateVersion || wsBroadcastPending || (wsCache && millis() - wsCacheTime > WS_CACHE_MAX_AGE)) wsDropCache();
+  if (!wsCache && !wsSerialize(nullptr, true)) return;
+  for (uint8_t i = 0; i < WS_MAX_PENDING; i++) {
+    if (!wsPendingClients[i]) continue;
+    AsyncWebSocketClient * c = ws.client(wsPendingClients[i]);
+    wsPendingClients[i] = 0;
+    if (c && c->status() == WS_CONNECTED) c->text(wsCache);
+  }
+}
+
+//sends the full state and info to a single client, or schedules a broadcast to all clients
+//changes within WS_BROADCAST_INTERVAL are sent together by handleWs(), between frames
+void sendDataWs(AsyncWebSocketClient * client)
+{
+  if (!ws.count()) return;
+  if (!client) {
+    if (!wsBroadcastPending) wsPendingSince = millis();
+    wsBroadcastPending = true;
+    return;
   }
+  for (uint8_t i = 0; i < WS_MAX_PENDING; i++) if (wsPendingClients[i] == client->id()) return;
+  for (uint8_t i = 0; i < WS_MAX_PENDING; i++) if (!wsPendingClients[i]) { wsPendingClients[i] = client->id(); return; }
+  //all slots in use, serialized for this client alone
+  AsyncWebSocketMessageBuffer * buffer = wsSerialize(nullptr, false);
+  if (!buffer) return;
+  client->text(buffer);
+  buffer->unlock();
+  ws._cleanBuffers();
+}
+
+//JSON live view frame, same format as /json/live
+AsyncWebSocketMessageBuffer * makeLiveLedsJson()
+{
+  char buffer[LIVE_LEDS_JSON_SIZE];
+  uint16_t len = serializeLiveLeds(buffer);
+  AsyncWebSocketMessageBuffer * wsBuf = wsMakeBuffer(len);
+  if (wsBuf) memcpy(wsBuf->get(), buffer, len);
+  return wsBuf;
+}
+
+//binary live view frame: 'L', format version 1, sample step n (16 bit, low byte first), then 3 bytes RGB per LED
+AsyncWebSocketMessageBuffer * makeLiveLedsBinary()
+{
+  uint16_t used = strip.getLengthTotal();
+  uint16_t n = (used -1) /MAX_LIVE_LEDS_WS +1; //only serve every n'th LED if count over MAX_LIVE_LEDS_WS
+  uint16_t count = (used + n -1) /n;
+  AsyncWebSocketMessageBuffer * wsBuf = wsMakeBuffer(4 + count*3);
+  if (!wsBuf) return nullptr; //out of memory
+
+  uint8_t* buf = wsBuf->get();
+  buf[0] = 'L';
+  buf[1] = 1;
+  buf[2] = n & 0xFF;
+  buf[3] = n >> 8;  //more than 255 * MAX_LIVE_LEDS_WS LEDs
+  uint8_t* px = buf + 4;
+  for (uint16_t i = 0; i < used; i += n)
+  {
+    uint32_t c = strip.getPixelColor(i);
+    *px++ = c >> 16;
+    *px++ = c >> 8;
+    *px++ = c;
+  }
+  return wsBuf;
+}
+
+//each frame format is serialized once and shared by all subscribers (the buffer is reference counted)
+//returns false if nothing could be sent because all subscribers still had queued messages
+bool sendLiveLedsWs()
+{
+  AsyncWebSocketMessageBuffer * bufs[2] = {nullptr, nullptr}; //JSON, binary
+  bool sent = false, busy = false;
+
+  for (uint8_t i = 0; i < WS_MAX_LIVE_CLIENTS; i++)
+  {
+    if (!wsLiveClients[i]) continue;
+    AsyncWebSocketClient * wsc = ws.client(wsLiveClients[i]);
+    if (!wsc) { wsLiveClients[i] = 0; continue; }
+    if (wsc->queueLength() > 0) { busy = true; continue; } //only send if queue free
+
+    bool binary = wsLiveBinary & (1 << i);
+    if (!bufs[binary]) {
+      bufs[binary] = binary ? makeLiveLedsBinary() : makeLiveLedsJson();
+      if (!bufs[binary]) continue;
+      bufs[binary]->lock();
+    }
+    if (binary) wsc->binary(bufs[binary]);
+    else        wsc->text(bufs[binary]);
+    sent = true;
+  }
+
+  for (uint8_t b = 0; b < 2; b++) if (bufs[b]) bufs[b]->unlock();
+  ws._cleanBuffers();
+  return sent || !busy;
 }
 
 void handleWs()
 {
+  if (wsBroadcastPending && millis() - wsLastBroadcast >= WS_BROADCAST_INTERVAL) {
+    //between frames, unless the busses have been busy for long
+    if (!ws.count()) wsBroadcastPending = false;
+    else if (!strip.isUpdating() || millis() - wsPendingSince > 2*WS_BROADCAST_INTERVAL) wsBroadcast();
+  }
+  wsAnswerPending();
+  if (wsCache && millis() - wsCacheTime > WS_CACHE_MAX_AGE) wsDropCache(); //info is outdated
   if (millis() - wsLastLiveTime > WS_LIVE_INTERVAL)
   {
     ws.cleanupClients();
     bool success = true;
-    if (wsLiveClientId)
-      success = serveLiveLeds(nullptr, wsLiveClientId);
+    success = sendLiveLedsWs();
     wsLastLiveTime = millis();
     if (!success) wsLastLiveTime -= 20; //try again in 20ms if failed due to non-empty WS queue
   }
@@ -163,18 +163,7 @@ void sappends(char stype, const char* key, char* val)
       oappend("d.Sf.");
       oappend(key);
       oappend(".value=\"");
-      //convert "%" to "%%" to make EspAsyncWebServer happy
-      char buf[130];
-      uint8_t len = strlen(val) +1;
-      uint8_t s = 0;
-      for (uint8_t i = 0; i < len; i++) {
-        buf[i+s] = val[i];
-        if (val[i] == '%') {
-          s++; buf[i+s] = '%';
-        }
-      }
-
-      oappend(buf);
+      oappend(val);
       oappend("\";");
       break; }
     case 'm': //message
@@ -234,14 +223,12 @@ void fillUMPins(JsonObject &mods)
 }
 
 
-//get values for settings form in javascript
-void getSettingsJS(byte subPage, char* dest)
+//get values for settings form in javascript, appended to the current output
+void getSettingsJS(byte subPage)
 {
   //0: menu 1: wifi 2: leds 3: ui 4: sync 5: time 6: sec
   DEBUG_PRINT(F("settings resp"));
   DEBUG_PRINTLN(subPage);
-  obuf = dest;
-  olen = 0;
 
   if (subPage <1 || subPage >8) return;
 
@@ -280,6 +267,7 @@ void getSettingsJS(byte subPage, char* dest)
 
     #ifdef WLED_USE_ETHERNET
     sappend('v',SET_F("ETH"),ethernetType);
+    sappend('c',SET_F("EO"),ethernetOnly);
     #else
     //hide ethernet setting if not compiled in
     oappend(SET_F("document.getElementById('ethd').style.display='none';"));
@@ -319,7 +307,7 @@ void getSettingsJS(byte subPage, char* dest)
     // add reserved and usermod pins as d.um_p array
     oappend(SET_F("d.um_p=[6,7,8,9,10,11"));
 
-    DynamicJsonDocument doc(JSON_BUFFER_SIZE/2);
+    PSRAMDynamicJsonDocument doc(JSON_BUFFER_SIZE/2);
     JsonObject mods = doc.createNestedObject(F("um"));
     usermods.addToConfig(mods);
     if (!mods.isNull()) fillUMPins(mods);
@@ -400,8 +388,7 @@ void getSettingsJS(byte subPage, char* dest)
     sappend('v',SET_F("LA"),strip.milliampsPerLed);
     if (strip.currentMilliamps)
     {
-      sappends('m',SET_F("(\"pow\")[0]"),(char*)"");
-      olen -= 2; //delete ";
+      oappend(SET_F("d.getElementsByClassName(\"pow\")[0].innerHTML=\""));
       oappendi(strip.currentMilliamps);
       oappend(SET_F("mA\";"));
     }
@@ -414,6 +401,7 @@ void getSettingsJS(byte subPage, char* dest)
 
     sappend('c',SET_F("GB"),strip.gammaCorrectBri);
     sappend('c',SET_F("GC"),strip.gammaCorrectCol);
+    sappend('c',SET_F("GO"),strip.gammaCorrectOut);
     sappend('c',SET_F("TF"),fadeTransition);
     sappend('v',SET_F("TD"),transitionDelayDefault);
     sappend('c',SET_F("PF"),strip.paletteFade);
@@ -457,9 +445,15 @@ void getSettingsJS(byte subPage, char* dest)
     sappend('c',SET_F("SH"),notifyHue);
     sappend('c',SET_F("SM"),notifyMacro);
     sappend('c',SET_F("S2"),notifyTwice);
+    sappend('c',SET_F("SI"),syncPresetIds);
+    sappend('c',SET_F("SN"),sendAudioSync);
+    sappend('c',SET_F("RN"),receiveAudioSync);
+    sappend('v',SET_F("SY"),notifyMinInterval);
+    sappend('c',SET_F("SU"),syncMulticast);
 
     sappend('c',SET_F("NL"),nodeListEnabled);
     sappend('c',SET_F("NB"),nodeBroadcastEnabled);
+    sappend('c',SET_F("VF"),vstripFollow);
 
     sappend('c',SET_F("RD"),receiveDirect);
     sappend('v',SET_F("EP"),e131Port);
@@ -468,10 +462,12 @@ void getSettingsJS(byte subPage, char* dest)
     sappend('v',SET_F("EU"),e131Universe);
     sappend('v',SET_F("DA"),DMXAddress);
     sappend('v',SET_F("DM"),DMXMode);
+    sappend('v',SET_F("MM"),e131MergeMode);
     sappend('v',SET_F("ET"),realtimeTimeoutMs);
     sappend('c',SET_F("FB"),arlsForceMaxBri);
     sappend('c',SET_F("RG"),arlsDisableGammaCorrection);
     sappend('v',SET_F("WO"),arlsOffset);
+    sappend('v',SET_F("BD"),serialBaud);
     sappend('c',SET_F("AL"),alexaEnabled);
     sappends('s',SET_F("AI"),alexaInvocationName);
     sappend('c',SET_F("SA"),notifyAlexa);
@@ -505,6 +501,7 @@ void getSettingsJS(byte subPage, char* dest)
     sappend('v',SET_F("HL"),huePollLightId);
     sappend('v',SET_F("HI"),huePollIntervalMs);
     sappend('c',SET_F("HP"),huePollingEnabled);
+    sappend('c',SET_F("HS"),hueStreamEnabled);
     sappend('c',SET_F("HO"),hueApplyOnOff);
     sappend('c',SET_F("HB"),hueApplyBri);
     sappend('c',SET_F("HC"),hueApplyColor);
@@ -591,8 +588,7 @@ void getSettingsJS(byte subPage, char* dest)
     sappend('c',SET_F("NO"),otaLock);
     sappend('c',SET_F("OW"),wifiLock);
     sappend('c',SET_F("AO"),aOtaEnabled);
-    sappends('m',SET_F("(\"sip\")[0]"),(char*)F("WLED "));
-    olen -= 2; //delete ";
+    oappend(SET_F("d.getElementsByClassName(\"sip\")[0].innerHTML=\"WLED "));
     oappend(versionString);
     oappend(SET_F(" (build "));
     oappendi(VERSION);